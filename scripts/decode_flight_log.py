@@ -0,0 +1,223 @@
+#!/usr/bin/env python3
+"""
+Proton Pack Flight Log Decoder
+==============================
+
+Decodes the event log kept by the Proton Pack when FLIGHT_RECORDER is enabled.
+
+USAGE:
+    Decode a log downloaded from the /debug/events route (ESP32):
+        curl -o pack_events.bin http://192.168.1.4/debug/events
+        python3 decode_flight_log.py pack_events.bin
+
+    Decode a log printed with "e" over the serial (USB) console (ATMega or ESP32):
+        python3 decode_flight_log.py serial_capture.txt
+
+    Read from standard input:
+        python3 decode_flight_log.py - < serial_capture.txt
+
+DESCRIPTION:
+    The log is a 16-byte header followed by 8-byte events, oldest first, all little-endian.
+    Serial captures contain the same bytes as hex on lines beginning with "FL", and any
+    other lines in the capture are ignored.
+
+    Event times are millis() since the boot on which they were recorded. Each boot begins
+    with a reset event, so the events are grouped by boot, and each boot is given relative
+    to the current one (0), eg. -1 for the boot before the current one.
+"""
+
+import argparse
+import struct
+import sys
+
+HEADER_FORMAT = '<HBBHHIBBH'
+EVENT_FORMAT = '<IHBB'
+LOG_MAGIC = 0x4C46
+LOG_VERSION = 1
+
+PLATFORMS = {1: 'ATMega', 2: 'ESP32'}
+
+EVENT_NAMES = {
+    1: 'Reset',
+    2: 'Pack startup',
+    3: 'Pack shutdown',
+    4: 'Overheating',
+    5: 'Venting',
+    6: 'Wand connected',
+    7: 'Wand disconnected',
+    8: 'Low voltage',
+    9: 'Voltage recovered',
+}
+
+# Values of esp_reset_reason_t.
+ESP32_RESET_REASONS = {
+    0: 'unknown',
+    1: 'power on',
+    2: 'external pin',
+    3: 'software restart',
+    4: 'exception/panic',
+    5: 'interrupt watchdog',
+    6: 'task watchdog',
+    7: 'other watchdog',
+    8: 'deep sleep',
+    9: 'brownout',
+    10: 'SDIO',
+    11: 'USB peripheral',
+    12: 'JTAG',
+    13: 'efuse error',
+    14: 'power glitch',
+    15: 'CPU lockup',
+}
+
+# Bits of the ATMega MCUSR register.
+ATMEGA_RESET_FLAGS = [
+    (0x01, 'power on'),
+    (0x02, 'external reset'),
+    (0x04, 'brownout'),
+    (0x08, 'watchdog'),
+    (0x10, 'JTAG'),
+]
+
+
+def describe_reset(platform, reason):
+    """
+    Function: describe_reset
+    Purpose: Convert a reset reason from the given platform into text.
+    Inputs: platform (int), reason (int)
+    Outputs: Description of the reset (str)
+    """
+    if platform == 2:
+        return ESP32_RESET_REASONS.get(reason, f'reason {reason}')
+
+    flags = [name for bit, name in ATMEGA_RESET_FLAGS if reason & bit]
+    return ', '.join(flags) if flags else 'unknown (flags cleared by the bootloader)'
+
+
+def describe_data(platform, event_type, data):
+    """
+    Function: describe_data
+    Purpose: Convert the data recorded with an event into text.
+    Inputs: platform (int), event_type (int), data (int)
+    Outputs: Description of the data (str)
+    """
+    if event_type == 1:
+        return describe_reset(platform, data)
+    if event_type == 2:
+        return 'full sequence' if data else 'quick start'
+    if event_type in (4, 5):
+        return f'power level {data}'
+    if event_type in (8, 9):
+        return f'{data / 100:.2f} V'
+    return ''
+
+
+def read_log(path):
+    """
+    Function: read_log
+    Purpose: Read a log as binary, or from the "FL" lines of a serial capture.
+    Inputs: path (str), or "-" for standard input
+    Outputs: Raw log bytes (bytes)
+    """
+    data = sys.stdin.buffer.read() if path == '-' else open(path, 'rb').read()
+
+    lines = [line.strip() for line in data.decode('ascii', errors='ignore').splitlines()]
+    hex_lines = [line[2:] for line in lines if line.startswith('FL ')]
+
+    if hex_lines:
+        return bytes.fromhex(''.join(hex_lines))
+
+    return data
+
+
+def format_time(millis):
+    """
+    Function: format_time
+    Purpose: Format milliseconds since boot as h:mm:ss.mmm.
+    Inputs: millis (int)
+    Outputs: Formatted time (str)
+    """
+    seconds, millis = divmod(millis, 1000)
+    minutes, seconds = divmod(seconds, 60)
+    hours, minutes = divmod(minutes, 60)
+    return f'{hours}:{minutes:02}:{seconds:02}.{millis:03}'
+
+
+def decode(raw):
+    """
+    Function: decode
+    Purpose: Decode a log into the header and a list of events.
+    Inputs: raw (bytes)
+    Outputs: Header (dict) and events (list of dicts)
+    """
+    header_size = struct.calcsize(HEADER_FORMAT)
+
+    if len(raw) < header_size:
+        raise ValueError(f'Log is too short ({len(raw)} bytes) to hold a header')
+
+    magic, version, platform, capacity, count, uptime, reset_reason, record_size, _ = \
+        struct.unpack_from(HEADER_FORMAT, raw)
+
+    if magic != LOG_MAGIC:
+        raise ValueError(f'Not a flight log (magic 0x{magic:04x})')
+    if version != LOG_VERSION:
+        raise ValueError(f'Unsupported log version {version}')
+    if record_size != struct.calcsize(EVENT_FORMAT):
+        raise ValueError(f'Unexpected event size {record_size}')
+
+    available = (len(raw) - header_size) // record_size
+    if available < count:
+        print(f'Warning: log is truncated, {available} of {count} events present', file=sys.stderr)
+        count = available
+
+    header = {
+        'platform': platform,
+        'capacity': capacity,
+        'uptime': uptime,
+        'reset_reason': reset_reason,
+    }
+
+    events = []
+    for i in range(count):
+        time, data, sequence, event_type = struct.unpack_from(EVENT_FORMAT, raw, header_size + i * record_size)
+        events.append({'time': time, 'data': data, 'sequence': sequence, 'type': event_type})
+
+    return header, events
+
+
+def main():
+    parser = argparse.ArgumentParser(description='Decode a Proton Pack flight log.')
+    parser.add_argument('log', help='Binary log from /debug/events, or a serial capture ("-" for stdin)')
+    args = parser.parse_args()
+
+    try:
+        header, events = decode(read_log(args.log))
+    except (OSError, ValueError) as error:
+        print(f'Error: {error}', file=sys.stderr)
+        return 1
+
+    platform = header['platform']
+    print(f'{PLATFORMS.get(platform, "Unknown device")}: {len(events)} of {header["capacity"]} events, '
+          f'up {format_time(header["uptime"])} since {describe_reset(platform, header["reset_reason"])}')
+
+    # Number each boot relative to the current one.
+    boot = -sum(1 for event in events if event['type'] == 1)
+    previous_sequence = None
+
+    for event in events:
+        if event['type'] == 1:
+            boot += 1
+            print()
+
+        if previous_sequence is not None and event['sequence'] != (previous_sequence + 1) % 256:
+            print('  ... events missing ...')
+        previous_sequence = event['sequence']
+
+        name = EVENT_NAMES.get(event['type'], f'Event {event["type"]}')
+        detail = describe_data(platform, event['type'], event['data'])
+        print(f'boot {boot:4} {format_time(event["time"]):>14}  {name}' + (f': {detail}' if detail else ''))
+
+    return 0
+
+
+if __name__ == '__main__':
+    sys.exit(main())
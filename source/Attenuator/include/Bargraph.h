@@ -70,18 +70,14 @@ void bargraphSetElement(int8_t i_element, bool b_power) {
   if(b_bargraph_present) {
     // This simplifies the process of turning individual elements on or off.
     // Uses mapping information which accounts for installation orientation.
-    if(b_power) {
-      ht_bargraph.setLed(PROGMEM_READU8(i_bargraph[i_element]));
-    }
-    else {
-      ht_bargraph.clearLed(PROGMEM_READU8(i_bargraph[i_element]));
-    }
+    ht_bargraph.setElement(i_element, b_power);
   }
 }
 
 void bargraphCommitChanges() {
   // This commits any changes created by bargraphSetElement to the bargraph.
-  ht_bargraph.sendLed();
+  // Only the bytes which changed since the last commit are sent.
+  ht_bargraph.commit();
 }
 
 void bargraphReset() {
@@ -107,6 +103,7 @@ void bargraphClear() {
   // Clears all elements from the bargraph, marks state as empty.
   if(b_bargraph_present) {
     ht_bargraph.clearAll();
+    ht_bargraph.commit();
   }
   i_bargraph_element = 0;
   BARGRAPH_STATE = BG_EMPTY; // Mark last known state.
@@ -126,17 +123,8 @@ void setupBargraph() {
   Wire.setClock(400000UL); // Sets the i2c bus to 400kHz
 
   // Scan i2c for 28/30 segment bargraph.
-  Wire.beginTransmission(0x70);
-  if(Wire.endTransmission() == 0) {
-    b_bargraph_present = true;
-  }
-  else {
-    b_bargraph_present = false;
-  }
-
-  if(b_bargraph_present) {
-    ht_bargraph.begin(0x00);
-  }
+  b_bargraph_present = ht_bargraph.begin();
+  ht_bargraph.setLayout(BARGRAPH_LAYOUT_28, b_bargraph_invert);
 
   bargraphOff(); // Turn off the bargraph.
 }
@@ -47,6 +47,14 @@
  */
 //#define RESET_AP_SETTINGS
 
+/*
+ * Let the CPU frequency (80, 160 or 240 MHz) follow the load on the busiest core rather than
+ * staying at a fixed frequency. Goes to 240 MHz as soon as a core is busy and steps back down
+ * once the load would stay comfortable at a lower frequency for 2 seconds. The time spent at
+ * each frequency is printed along with the CPU load when DEBUG_PERFORMANCE is enabled.
+ */
+//#define CPU_GOVERNOR
+
 /*
  * Invert logic for toggle switches
  */
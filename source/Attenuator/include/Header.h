@@ -113,7 +113,8 @@ bool b_blink_blank = false; // Denotes when upper/lower LEDs are mid-blink.
  *   SDA -> GPIO 21
  *   SCL -> GPIO 22
  */
-HT16K33 ht_bargraph;
+BargraphWireBus bargraph_bus(Wire);
+BargraphDriver ht_bargraph(bargraph_bus); // Changes are held in RAM until bargraphCommitChanges().
 const uint8_t i_bargraph_delay = 12; // Base delay (ms) for bargraph refresh (this should be a value evenly divisible by 2, 3, or 4).
 const uint8_t i_bargraph_elements = 28; // Maximum elements for bargraph device; not likely to change but adjustable just in case.
 const uint8_t i_bargraph_levels = 5; // Reflects the count of POWER_LEVELS elements (the only dependency on other device behavior).
@@ -137,9 +138,9 @@ bool b_cyclotron_lid_on = true;
  */
 //#define GPSTAR_INVERT_BARGRAPH
 #ifdef GPSTAR_INVERT_BARGRAPH
-  const uint8_t i_bargraph[28] PROGMEM = {54, 38, 22, 6, 53, 37, 21, 5, 52, 36, 20, 4, 51, 35, 19, 3, 50, 34, 18, 2, 49, 33, 17, 1, 48, 32, 16, 0};
+  const bool b_bargraph_invert = true;
 #else
-  const uint8_t i_bargraph[28] PROGMEM = {0, 16, 32, 48, 1, 17, 33, 49, 2, 18, 34, 50, 3, 19, 35, 51, 4, 20, 36, 52, 5, 21, 37, 53, 6, 22, 38, 54};
+  const bool b_bargraph_invert = false;
 #endif
 
 /*
@@ -49,7 +49,6 @@
 #include <millisDelay.h>
 #include <FastLED.h>
 #include <ezButton.h>
-#include <ht16k33.h>
 #include <Wire.h>
 #include <SerialTransfer.h>
 #include <esp_system.h>
@@ -72,6 +71,8 @@ void sendDebug(const String& message) {
 // Shared Libraries
 #include <DeviceState.h>
 #include <Communication.h>
+#include <BargraphDriver.h>
+#include <CpuGovernorTask.h>
 #include <WirelessManager.h>
 #include <WebRouter.h>
 
@@ -132,9 +133,43 @@ void idleTaskCore1(void * parameter) {
 }
 #endif
 
+/*
+ * CPU frequency governor (see CpuGovernor.h), which steps the clock to suit the load on the busiest
+ * core. Each looping task marks its work with cpuLoadEnter() and cpuLoadLeave(), and the time between
+ * them (which leaves out the task delays) is the load.
+ */
+#if defined(CPU_GOVERNOR)
+CpuLoadMeter cpuLoad(cpuGovernorMicros);
+CpuGovernor cpuGovernor;
+TaskHandle_t CpuGovernorTaskHandle = NULL;
+#endif
+
+// Marks the start of work in a looping task.
+inline void cpuLoadEnter() {
+  #if defined(CPU_GOVERNOR)
+  cpuLoad.enter(xPortGetCoreID());
+  #endif
+}
+
+// Marks the end of work in a looping task, before its delay.
+inline void cpuLoadLeave() {
+  #if defined(CPU_GOVERNOR)
+  cpuLoad.leave(xPortGetCoreID());
+  #endif
+}
+
+// CPU Governor Task (Loop)
+#if defined(CPU_GOVERNOR)
+void CpuGovernorTask(void *parameter) {
+  runCpuGovernorTask(cpuGovernor, cpuLoad);
+}
+#endif
+
 // Animation Task (Loop)
 void AnimationTask(void *parameter) {
   while(true) {
+    cpuLoadEnter();
+
     #if defined(DEBUG_TASK_TO_CONSOLE)
       // Confirm the core in use for this task, and when it runs.
       debug(F("Executing AnimationTask in core"));
@@ -180,6 +215,7 @@ void AnimationTask(void *parameter) {
     // Update the device LEDs and restart the timer.
     FastLED.show();
 
+    cpuLoadLeave();
     vTaskDelay(8 / portTICK_PERIOD_MS); // 8ms delay
   }
 }
@@ -324,6 +360,8 @@ void SerialCommsTask(void *parameter) {
   #endif
 
   while(true) {
+    cpuLoadEnter();
+
     if(b_wait_for_pack) {
       if(ms_packsync.justFinished()) {
         // Tell the pack we are trying to sync.
@@ -375,6 +413,7 @@ void SerialCommsTask(void *parameter) {
       }
     }
 
+    cpuLoadLeave();
     vTaskDelay(2 / portTICK_PERIOD_MS); // 2ms delay
   }
 }
@@ -382,6 +421,8 @@ void SerialCommsTask(void *parameter) {
 // User Input Task (Loop)
 void UserInputTask(void *parameter) {
   while(true) {
+    cpuLoadEnter();
+
     #if defined(DEBUG_TASK_TO_CONSOLE)
       // Confirm the core in use for this task, and when it runs.
       debug(F("Executing UserInputTask in core"));
@@ -396,6 +437,7 @@ void UserInputTask(void *parameter) {
       checkUserInputs();
     }
 
+    cpuLoadLeave();
     vTaskDelay(14 / portTICK_PERIOD_MS); // 14ms delay
   }
 }
@@ -403,6 +445,8 @@ void UserInputTask(void *parameter) {
 // WiFi Management Task (Loop)
 void WiFiManagementTask(void *parameter) {
   while(true) {
+    cpuLoadEnter();
+
     #if defined(DEBUG_TASK_TO_CONSOLE)
       // Confirm the core in use for this task, and when it runs.
       debug(F("Executing WiFiManagementTask in core"));
@@ -415,6 +459,7 @@ void WiFiManagementTask(void *parameter) {
     // Perform periodic checks for WiFi clients and OTA updates.
     webLoops();
 
+    cpuLoadLeave();
     vTaskDelay(100 / portTICK_PERIOD_MS); // 100ms delay
   }
 }
@@ -488,6 +533,7 @@ void setup() {
   pinMode(BUILT_IN_LED, OUTPUT);
 
   // Provide an opportunity to set the CPU Frequency MHz: 80, 160, 240 [Default = 240]
+  // With CPU_GOVERNOR enabled this is only the starting point, as the governor adjusts it to the load.
   // Lower frequency means less power consumption, but slower performance (obviously).
   // Reduce CPU frequency to 160 MHz to save ~33% power compared to 240 MHz.
   // Alternatively set CPU to 80 MHz to save ~50% power compared to 240 MHz.
@@ -586,6 +632,11 @@ void setup() {
   xTaskCreatePinnedToCore(idleTaskCore0, "Idle Task Core 0", 1000, NULL, 1, NULL, 0);
   xTaskCreatePinnedToCore(idleTaskCore1, "Idle Task Core 1", 1000, NULL, 1, NULL, 1);
   #endif
+
+  // Create a task to adjust the CPU frequency, above the priority of the tasks it measures.
+  #if defined(CPU_GOVERNOR)
+  xTaskCreatePinnedToCore(CpuGovernorTask, "CpuGovernorTask", 2048, NULL, 5, &CpuGovernorTaskHandle, 1);
+  #endif
 }
 
 // Helper function to format bytes with a comma separator
@@ -672,6 +723,9 @@ void loop() {
   #if defined(DEBUG_PERFORMANCE)
   debugln(F("=================================================="));
   printCPULoad();      // Print CPU load
+  #if defined(CPU_GOVERNOR) && GPSTAR_DEBUG == 1
+  printCpuResidency(Serial, cpuGovernor, cpuLoad); // Print time at each CPU frequency
+  #endif
   printMemoryStats();  // Print memory usage
   delay(3000);         // Wait 5 seconds before printing again
   #endif
@@ -62,6 +62,7 @@ void sendDebug(const String& message) {
 
 // Shared Libraries
 #include <DeviceState.h>
+#include <CpuGovernorTask.h>
 #include <WirelessManager.h>
 #include <WebRouter.h>
 
@@ -112,9 +113,43 @@ void idleTaskCore1(void * parameter) {
 }
 #endif
 
+/*
+ * CPU frequency governor (see CpuGovernor.h), which steps the clock to suit the load on the busiest
+ * core. Each looping task marks its work with cpuLoadEnter() and cpuLoadLeave(), and the time between
+ * them (which leaves out the task delays) is the load.
+ */
+#if defined(CPU_GOVERNOR)
+CpuLoadMeter cpuLoad(cpuGovernorMicros);
+CpuGovernor cpuGovernor;
+TaskHandle_t CpuGovernorTaskHandle = NULL;
+#endif
+
+// Marks the start of work in a looping task.
+inline void cpuLoadEnter() {
+  #if defined(CPU_GOVERNOR)
+  cpuLoad.enter(xPortGetCoreID());
+  #endif
+}
+
+// Marks the end of work in a looping task, before its delay.
+inline void cpuLoadLeave() {
+  #if defined(CPU_GOVERNOR)
+  cpuLoad.leave(xPortGetCoreID());
+  #endif
+}
+
+// CPU Governor Task (Loop)
+#if defined(CPU_GOVERNOR)
+void CpuGovernorTask(void *parameter) {
+  runCpuGovernorTask(cpuGovernor, cpuLoad);
+}
+#endif
+
 // Animation Task (Loop)
 void AnimationTask(void *parameter) {
   while(true) {
+    cpuLoadEnter();
+
     #if defined(DEBUG_TASK_TO_CONSOLE)
       // Confirm the core in use for this task, and when it runs.
       debug(F("Executing AnimationTask in core"));
@@ -131,6 +166,7 @@ void AnimationTask(void *parameter) {
     // Update the device LEDs and restart the timer.
     FastLED.show();
 
+    cpuLoadLeave();
     vTaskDelay(16 / portTICK_PERIOD_MS); // 16ms delay
   }
 }
@@ -189,6 +225,8 @@ void PreferencesTask(void *parameter) {
 // WiFi Management Task (Loop)
 void WiFiManagementTask(void *parameter) {
   while(true) {
+    cpuLoadEnter();
+
     #if defined(DEBUG_TASK_TO_CONSOLE)
       // Confirm the core in use for this task, and when it runs.
       debug(F("Executing WiFiManagementTask in core"));
@@ -237,6 +275,7 @@ void WiFiManagementTask(void *parameter) {
       }
     }
 
+    cpuLoadLeave();
     vTaskDelay(1000 / portTICK_PERIOD_MS); // 1000ms delay
   }
 }
@@ -343,6 +382,7 @@ void setup() {
 #endif
 
   // Provide an opportunity to set the CPU Frequency MHz: 80, 160, 240 [Default = 240]
+  // With CPU_GOVERNOR enabled this is only the starting point, as the governor adjusts it to the load.
   // Lower frequency means less power consumption, but slower performance (obviously).
   setCpuFrequencyMhz(80);
   #if defined(DEBUG_SEND_TO_CONSOLE)
@@ -428,6 +468,11 @@ void setup() {
   xTaskCreatePinnedToCore(idleTaskCore0, "Idle Task Core 0", 1000, NULL, 1, NULL, 0);
   xTaskCreatePinnedToCore(idleTaskCore1, "Idle Task Core 1", 1000, NULL, 1, NULL, 1);
   #endif
+
+  // Create a task to adjust the CPU frequency, above the priority of the tasks it measures.
+  #if defined(CPU_GOVERNOR)
+  xTaskCreatePinnedToCore(CpuGovernorTask, "CpuGovernorTask", 2048, NULL, 5, &CpuGovernorTaskHandle, 1);
+  #endif
 }
 
 // Helper function to format bytes with a comma separator
@@ -504,6 +549,9 @@ void loop() {
   #if defined(DEBUG_PERFORMANCE)
   debugln(F("=================================================="));
   printCPULoad();      // Print CPU load
+  #if defined(CPU_GOVERNOR) && GPSTAR_DEBUG == 1
+  printCpuResidency(Serial, cpuGovernor, cpuLoad); // Print time at each CPU frequency
+  #endif
   printMemoryStats();  // Print memory usage
   delay(3000);         // Wait 3 seconds before printing again
   #endif
@@ -315,3 +315,25 @@ CRGB getHueColour(uint8_t i_colour, WAND_BARREL_LED_COUNTS NUM_LEDS_ENUM, uint8_
     break;
   }
 }
+
+/*
+ * Barrel LED colours are kept in a palette once converted, as the firing effects ask for the same
+ * few colours on every pass of the main loop. Colour cycles change on each call, so they are not kept.
+ * The palette is cleared whenever firing begins, to pick up any change of barrel or custom colour.
+ */
+BarrelColour getBarrelPaletteColour(uint8_t i_colour) {
+  CRGB rgb = getHueColour(i_colour, WAND_BARREL_LED_COUNT);
+  return {rgb.r, rgb.g, rgb.b};
+}
+
+BarrelPalette barrel_palette(getBarrelPaletteColour, (1UL << C_REDGREEN) | (1UL << C_ORANGEPURPLE) | (1UL << C_PASTEL) | (1UL << C_RAINBOW));
+
+CRGB getBarrelColour(uint8_t i_colour) {
+  const BarrelColour& c_colour = barrel_palette.get(i_colour);
+  return CRGB(c_colour.r, c_colour.g, c_colour.b);
+}
+
+// Colours shown by each zone of the barrel in turn as a pulse passes, ending with the colour left behind.
+const uint8_t i_pulse_shades_boson_dart[BARREL_PULSE_SHADES] PROGMEM = {C_RED, C_RED2, C_WHITE, C_RED2, C_RED, C_BLACK};
+const uint8_t i_pulse_shades_shock_blast[BARREL_PULSE_SHADES] PROGMEM = {C_NAVY_BLUE, C_MID_BLUE, C_LIGHT_BLUE, C_BLUE, C_WHITE, C_BLACK};
+const uint8_t i_pulse_shades_meson_collider[BARREL_PULSE_SHADES] PROGMEM = {C_YELLOW, C_ORANGE, C_RED4, C_RED2, C_RED, C_BLACK};
@@ -56,6 +56,43 @@
  */
 #define MOTION_OFFSETS
 
+/*
+ * Adapt the motion sensor sampling rate to what the wand is doing.
+ * While the wand is off and lying still the gyroscope and magnetometer are powered down and only
+ * the accelerometer's wake-up flag is polled. Firing, shaking and calibration raise the rate to
+ * 100 Hz. The time, i2c bus use and current draw at each rate (estimated from the datasheets,
+ * not measured) are available from the /debug/motion route. Uncomment to enable, otherwise the
+ * sensors are always sampled at 50 Hz.
+ * Only available on the ESP32 builds.
+ */
+//#define MOTION_GOVERNOR
+
+/*
+ * Read the gyroscope and accelerometer through the IMU's FIFO rather than one value at a time.
+ * Every sample the IMU takes is read in one burst and run through the orientation filter with
+ * the time it was taken, so the fusion sees evenly spaced samples whatever else the wand is doing.
+ * Uncomment to enable, otherwise only the latest values are read on each read interval.
+ * Only available on the ESP32 builds.
+ */
+//#define MOTION_FIFO
+
+/*
+ * Read and filter the motion sensors from a task of their own on the second core rather than the main loop.
+ * The task hands the orientation, filtered readings and shake count over to the main loop, which only takes
+ * the latest set, so slow work in the main loop no longer holds up the sensors. The time between sensor
+ * updates (and how much it varies) is available from the /debug/motion route (with MOTION_GOVERNOR) either way.
+ * Uncomment to enable. Only available on the ESP32 builds.
+ */
+//#define MOTION_TASK
+
+/*
+ * Filter the motion readings with a separate bank of filters for each use rather than one moving average:
+ * an adaptive (one-euro) filter for the values shown in the web UI, a short-lag low-pass for shake detection
+ * and a low-pass ahead of the orientation filter. The CPU cost of filtering is shown on /debug/motion.
+ * Uncomment to enable. Only available on the ESP32 builds.
+ */
+//#define MOTION_FILTER_BANK
+
 /*
  * When set to true, the IR transmitter will be active while firing.
  * Used to trigger the PSTT and Ghost Trap.
@@ -168,6 +168,8 @@ const uint8_t gpstar_neutrona_barrel[48] PROGMEM = {0, 1, 2, 3, 4, 5, 6, 7, 8, 9
 //const uint8_t gpstar_barrel_led_mini[2] PROGMEM = {0, 1};
 // This is the array of LEDs in the order by which they should be illuminated for effects. LED number 12 is the very tip which will be white (by default).
 const uint8_t frutto_barrel[48] PROGMEM = {0, 25, 24, 48, 1, 26, 23, 47, 2, 27, 22, 46, 3, 28, 21, 45, 4, 29, 20, 44, 5, 30, 19, 43, 6, 31, 18, 42, 7, 32, 17, 41, 8, 33, 16, 40, 9, 34, 15, 39, 10, 35, 14, 38, 11, 36, 13, 37};
+// Semi-automatic firing pulse, drawn by the barrel effects (see BarrelEffects).
+BarrelPulse barrel_pulse;
 
 /*
  * How many LEDs are in your Neutrona Wand Barrel.
@@ -327,8 +329,12 @@ uint8_t i_bargraph_status = 0;
 /*
  * (Optional) Barmeter 28-segment bargraph configuration and timers.
  * Part #: BL28Z-3005SA04Y
+ * Changes are drawn into a framebuffer and sent once per pass of the main loop.
  */
-HT16K33 ht_bargraph;
+BargraphWireBus bargraph_bus(Wire);
+BargraphDriver ht_bargraph(bargraph_bus);
+bool b_bargraph_layout_inverted = false; // Orientation of the element mapping in use by ht_bargraph.
+BargraphSequencePlayer bargraph_player; // Plays the Super Hero firing animation from its PROGMEM frame table.
 
 /*
  * Used to change to 28-segment bargraph features.
@@ -356,6 +362,7 @@ uint16_t i_bargraph_multiplier_current = i_bargraph_multiplier_ramp_2021;
 /*
  * (Optional) Barmeter 28-segment bargraph mapping.
  * Part #: BL28Z-3005SA04Y
+ * Elements are mapped to the HT16K33 LEDs by ht_bargraph (see BargraphDriver).
 
  * Segment Layout:
  * 5: full: 23 - 27  (5 segments)
@@ -365,8 +372,6 @@ uint16_t i_bargraph_multiplier_current = i_bargraph_multiplier_ramp_2021;
  * 1: none: 0 - 4    (5 segments)
  */
 const uint8_t i_bargraph_segments = 30;
-const uint8_t i_bargraph_invert[i_bargraph_segments - 2] PROGMEM = {54, 38, 22, 6, 53, 37, 21, 5, 52, 36, 20, 4, 51, 35, 19, 3, 50, 34, 18, 2, 49, 33, 17, 1, 48, 32, 16, 0};
-const uint8_t i_bargraph_normal[i_bargraph_segments - 2] PROGMEM = {0, 16, 32, 48, 1, 17, 33, 49, 2, 18, 34, 50, 3, 19, 35, 51, 4, 20, 36, 52, 5, 21, 37, 53, 6, 22, 38, 54};
 const uint8_t i_bargraph_power_table_28[MAX_POWER_LEVEL + 1] PROGMEM = {0, 4, 11, 16, 22, 27};
 
 /*
@@ -379,8 +384,6 @@ const uint8_t i_bargraph_power_table_28[MAX_POWER_LEVEL + 1] PROGMEM = {0, 4, 11
  * 2: 1/4: 6 - 11    (6 segments)
  * 1: none: 0 - 5    (6 segments)
  */
-const uint8_t i_bargraph_wamco_invert[i_bargraph_segments] PROGMEM = {64, 48, 32, 16, 0, 1, 17, 33, 49, 65, 66, 50, 34, 18, 2, 3, 19, 35, 51, 67, 4, 20, 36, 52, 68, 53, 37, 21, 5, 69};
-const uint8_t i_bargraph_wamco_normal[i_bargraph_segments] PROGMEM = {69, 5, 21, 37, 53, 68, 52, 36, 20, 4, 67, 51, 35, 19, 3, 2, 18, 34, 50, 66, 65, 49, 33, 17, 1, 0, 16, 32, 48, 64};
 const uint8_t i_bargraph_power_table_wamco[MAX_POWER_LEVEL + 1] PROGMEM = {0, 5, 11, 17, 23, 29};
 
 /*
@@ -430,7 +433,6 @@ const uint16_t i_shock_blast_rate = 600; // Shock Blast firing rate.
 const uint16_t i_slime_tether_rate = 750; // Slime Tether firing rate.
 const uint16_t i_meson_collider_rate = 250; // Meson Collider firing rate.
 const uint16_t i_firing_timer_length = 15000; // 15 seconds. Used by ms_firing_length_timer to determine which tail_end sound effects to play.
-const uint8_t i_firing_pulse = 18; // Used to drive semi-automatic firing stream effect timers. Default: 18ms.
 const uint8_t i_firing_stream = 100; // Used to drive all stream effects timers. Default: 100ms.
 uint8_t i_barrel_light = 0; // Used to keep track which LED in the barrel is currently lighting up.
 uint8_t i_pulse_step = 0; // Used to keep track of which pulse animation step we are on.
@@ -452,6 +454,9 @@ uint8_t i_boot_connection_count = 0;
 bool b_pack_on = false; // Denotes the pack has been powered on.
 bool b_pack_alarm = false; // Denotes the pack alarm is sounding (ribbon cable disconnected, overheating).
 bool b_pack_post_finish = true; // Checks whether the attached pack is currently in its POST sequence. Assume finished unless pack tells us otherwise.
+bool b_pack_idle_sleep = false; // The pack may be in light sleep, so it must be woken before anything is sent to it.
+uint32_t i_pack_last_send = 0; // millis() when a packet was last sent to the pack.
+const uint8_t i_pack_listen_time = 15; // Time (ms) a light sleeping pack is sure to still be awake after our last packet; its own window is 20 ms.
 bool b_pack_shutting_down = false; // Denotes the pack is in the process of shutting down but not fully shut down yet.
 bool b_pack_cyclotron_lid_on = false; // For SYSTEM_FROZEN_EMPIRE. Lets us know if the pack's cyclotron lid is on or not. Default to false to favor FE effects unless told otherwise.
 bool b_ribbon_cable_attached = true; // Denotes the ribbon cable on the pack is attached.
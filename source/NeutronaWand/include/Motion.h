@@ -79,6 +79,12 @@
 #include <Adafruit_LSM6DS3TRC.h>
 #include <Adafruit_AHRS.h>
 
+/**
+ * Processing of each sample once read (calibration, offsets, filtering, fusion and shake detection).
+ * Kept free of the sensors and the Arduino core so it can also replay recorded movement natively.
+ */
+#include "MotionPipeline.h"
+
 /**
  * Magnetometer and IMU
  * Defines all device objects and variables.
@@ -91,9 +97,8 @@ bool b_mag_found = false;
 bool b_imu_found = false;
 millisDelay ms_sensor_read_delay, ms_sensor_report_delay, ms_gyro_calibration;
 const uint8_t i_sensor_samples = 50; // Sets count of samples to take for averaging offsets.
-const uint16_t i_sensor_read_delay = 20; // Delay between sensor reads in milliseconds (20ms = 50Hz).
-const uint16_t i_sensor_report_delay = 50; // Delay between telemetry reporting (via console/web) in milliseconds.
-const float f_gravity = 9.80665f; // Constant for converting m/s^2 to Gs.
+uint16_t i_sensor_read_delay = 20; // Delay between sensor reads in milliseconds (20ms = 50Hz), set by the motion governor.
+uint16_t i_sensor_report_delay = 50; // Delay between telemetry reporting (via console/web) in milliseconds.
 uint32_t i_gyro_calibration_duration; // Time in milliseconds to run a gyroscope calibration (ms_gyro_calibration).
 Adafruit_Mahony ahrs_filter; // Create a filter object for sensor fusion (AHRS); Mahony better suited for human motion.
 
@@ -117,111 +122,12 @@ enum INSTALL_ORIENTATIONS : uint8_t {
 };
 enum INSTALL_ORIENTATIONS INSTALL_ORIENTATION = COMPONENTS_NOT_ORIENTED; // Default until preferences are restored.
 
-/**
- * Constant: FILTER_ALPHA
- * Purpose: Controls the smoothing factor for exponential moving average filtering (0 < FILTER_ALPHA <= 1).
- *          Increasing this value makes it more responsive to changes, decreasing smooths out fluctuations.
- *
- * How it works:
- *   - FILTER_ALPHA determines how much weight is given to the newest sensor reading versus the previous filtered value.
- *   - The formula for each update is:
- *       filteredValue = FILTER_ALPHA * newValue + (1 - FILTER_ALPHA) * previousFilteredValue;
- *   - If FILTER_ALPHA is close to 1.0:
- *       - The filter reacts quickly to new data (less smoothing, more responsive).
- *   - If FILTER_ALPHA is close to 0.0:
- *       - The filter reacts slowly (more smoothing, less responsive).
- *
- * Example:
- *   - FILTER_ALPHA = 0.1: Very smooth, but slow to respond to rapid changes.
- *   - FILTER_ALPHA = 0.5: Balanced between smoothness and responsiveness.
- *   - FILTER_ALPHA = 0.9: Very responsive, but less smoothing.
- *
- * Tuning:
- *   - Increase FILTER_ALPHA if you want the sensor data to react faster to changes.
- *   - Decrease FILTER_ALPHA if you want to suppress noise and jitter more.
- */
-const float FILTER_ALPHA = 0.4f;
-
 // Global object to hold magnetic calibration data.
 CalibrationData magCalData;
 
-/**
- * Struct: OrientedSensorData
- * Purpose: Holds raw sensor readings that have been oriented according to installation but not yet calibrated or filtered.
- * Attributes:
- *   - magX, magY, magZ: Oriented magnetometer readings (uTesla)
- *   - accelX, accelY, accelZ: Oriented accelerometer readings (m/s^2)
- *   - gyroX, gyroY, gyroZ: Oriented gyroscope readings (deg/s)
- */
-struct OrientedSensorData {
-  float magX = 0.0f;
-  float magY = 0.0f;
-  float magZ = 0.0f;
-  float accelX = 0.0f;
-  float accelY = 0.0f;
-  float accelZ = 0.0f;
-  float gyroX = 0.0f;
-  float gyroY = 0.0f;
-  float gyroZ = 0.0f;
-};
-
-/**
- * Struct: MotionData
- * Purpose: Holds all motion sensor readings from the magnetometer, accelerometer, and gyroscope.
- * Attributes:
- *   - magX, magY, magZ: Magnetometer readings (uTesla)
- *   - accelX, accelY, accelZ: Accelerometer readings (m/s^2)
- *   - gyroX, gyroY, gyroZ: Gyroscope readings (deg/s)
- */
-struct MotionData {
-  // Magnetometer readings (uTesla)
-  float magX = 0.0f;
-  float magY = 0.0f;
-  float magZ = 0.0f;
-  // Accelerometer readings (m/s^2)
-  float accelX = 0.0f;
-  float accelY = 0.0f;
-  float accelZ = 0.0f;
-  // Gyroscope readings (deg/s)
-  float gyroX = 0.0f;
-  float gyroY = 0.0f;
-  float gyroZ = 0.0f;
-  // Calculated g-force (unit: g)
-  float gForce = 0.0f;
-  // Calculated angular velocity (unit: deg/s)
-  float angVel = 0.0f;
-  // Indicator for sudden movement (using calculated values)
-  bool shaken = false;
-};
-
 // Global objects to hold the latest raw or filtered sensor readings.
 MotionData motionData, filteredMotionData;
 
-/**
- * Struct: MotionOffsets
- * Purpose: Holds baseline offsets for accelerometer and gyroscope to correct sensor drift.
- * This data is calculated on every reset of telemetry data and acts as a point of reference
- * for future movement. Effectively, this resets the center of the sensor's coordinate system.
- * Members:
- *   - accelX, accelY, accelZ: Accelerometer offsets (m/s^2)
- *   - gyroX, gyroY, gyroZ: Gyroscope offsets (deg/s)
- */
-struct MotionOffsets {
-  float sumAccelX = 0.0f;
-  float sumAccelY = 0.0f;
-  float sumAccelZ = 0.0f;
-  float sumGyroX = 0.0f;
-  float sumGyroY = 0.0f;
-  float sumGyroZ = 0.0f;
-  uint16_t samples = 0;
-  float accelX = 0.0f;
-  float accelY = 0.0f;
-  float accelZ = 0.0f;
-  float gyroX = 0.0f;
-  float gyroY = 0.0f;
-  float gyroZ = 0.0f;
-};
-
 // Global object to hold the calibration readings.
 MotionOffsets calibratedOffsets, quickOffsets;
 
@@ -234,32 +140,175 @@ struct Axis3F {
 Axis3F accelOffsets; // For acceleration offsets.
 Axis3F gyroOffsets; // For gyroscope offsets.
 
+// Global object to hold the fused sensor readings.
+SpatialData spatialData;
+
+#if defined(MOTION_GOVERNOR)
 /**
- * Struct: SpatialData
- * Purpose: Holds fused sensor readings from the magnetometer, accelerometer, and gyroscope.
+ * Motion Governor
+ * Chooses how often the sensors are read (and how fast they run) from what the wand is doing:
+ *   - IDLE: The wand is off and has been still for a while. The gyroscope and magnetometer are
+ *           powered down and the accelerometer runs slowly, with only its wake-up flag polled.
+ *   - NORMAL: Standard telemetry at 50 Hz.
+ *   - BOOST: Firing, shaking, gestures or calibration, at 100 Hz.
+ * The LSM6DS3TR-C interrupt pins are not wired to the ESP32, so the wake-up (any-motion) event
+ * is polled as a single register read rather than taken as an interrupt.
+ */
+enum MOTION_RATES : uint8_t { MOTION_RATE_IDLE, MOTION_RATE_NORMAL, MOTION_RATE_BOOST, MOTION_RATE_COUNT };
+enum MOTION_RATES MOTION_RATE = MOTION_RATE_NORMAL;
+
+struct MotionRateProfile {
+  uint16_t i_read_delay;          // Delay between reads (ms).
+  uint16_t i_report_delay;        // Delay between telemetry reports (ms).
+  lsm6ds_data_rate_t accelRate;   // Accelerometer output data rate.
+  lsm6ds_data_rate_t gyroRate;    // Gyroscope output data rate.
+  lis3mdl_operationmode_t magMode; // Magnetometer operation mode.
+  uint16_t i_current_ua;          // Approximate supply current of both sensors (uA), from their datasheets.
+  const char* name;
+};
+
+const MotionRateProfile motionRateProfiles[MOTION_RATE_COUNT] = {
+  {100, 250, LSM6DS_RATE_26_HZ, LSM6DS_RATE_SHUTDOWN, LIS3MDL_POWERDOWNMODE, 160, "idle"},
+  {20, 50, LSM6DS_RATE_104_HZ, LSM6DS_RATE_104_HZ, LIS3MDL_CONTINUOUSMODE, 940, "normal"},
+  {10, 50, LSM6DS_RATE_208_HZ, LSM6DS_RATE_208_HZ, LIS3MDL_CONTINUOUSMODE, 940, "boost"}
+};
+
+const uint16_t i_motion_idle_timeout = 10000; // Time the wand must be off and still before going idle (ms).
+const uint16_t i_motion_boost_hold = 1000; // Time to stay boosted after a shake or gesture (ms).
+const uint8_t i_motion_wake_threshold = 2; // Accelerometer wake-up threshold, in 1/64 of full scale (2 = ~62mg at 2g).
+const float f_motion_still_angvel = 10.0f; // Angular velocity below which the wand is still (deg/s).
+const float f_motion_still_gforce = 0.1f; // Deviation from 1g below which the wand is still (g).
+const float f_motion_gesture_angvel = 90.0f; // Angular velocity which boosts the rate for gestures (deg/s).
+
+millisDelay ms_motion_idle, ms_motion_boost;
+uint32_t i_motion_rate_since = 0; // Time the current rate was entered (ms).
+uint32_t i_motion_rate_ms[MOTION_RATE_COUNT] = {}; // Time spent at each rate (ms), excluding the current stretch.
+uint32_t i_motion_bus_us[MOTION_RATE_COUNT] = {}; // Time spent on the sensor i2c bus at each rate (us).
+uint32_t i_motion_rate_changes = 0;
+uint32_t i_motion_bus_start = 0;
+
+// Marks the start and end of sensor i2c traffic, which is counted against the current rate.
+inline void motionBusBegin() {
+  i_motion_bus_start = micros();
+}
+
+inline void motionBusEnd() {
+  i_motion_bus_us[MOTION_RATE] += micros() - i_motion_bus_start;
+}
+#else
+inline void motionBusBegin() {}
+inline void motionBusEnd() {}
+#endif
+
+#if defined(MOTION_FIFO)
+/**
+ * IMU FIFO
+ * The LSM6DS3TR-C queues every gyroscope and accelerometer sample it takes. On each read interval
+ * the queue is read in one burst and each sample is given the time it was taken (see ImuSampleClock),
+ * so the fusion filter steps through evenly spaced samples rather than whatever the read timing was.
+ * The magnetometer has no FIFO, so its latest reading is taken once per batch and used for all of it.
+ */
+ImuSampleClock imuClock;
+ImuFifoSample imuSamples[IMU_FIFO_MAX_SAMPLES];
+uint8_t imuFifoBuffer[IMU_FIFO_MAX_WORDS * 2];
+uint8_t i_imu_samples = 0; // Samples in the last batch read.
+uint16_t i_imu_fifo_overruns = 0; // Times the FIFO filled before it was read.
+uint32_t i_imu_last_sample = 0; // Time of the last sample run through the fusion filter (us).
+bool b_imu_last_sample = false; // Whether i_imu_last_sample belongs to the current run of samples.
+float f_imu_accel_scale = 0.0f; // Accelerometer m/s^2 per count at the configured range.
+float f_imu_gyro_scale = 0.0f; // Gyroscope rad/s per count at the configured range.
+const uint8_t i_imu_read_chunk = 120; // Most bytes read in one i2c transaction (the Wire buffer holds 128).
+const float f_filter_alpha_interval = 0.02f; // Sample interval (s) at which FILTER_ALPHA applies as-is.
+#endif
+
+/**
+ * Struct: MotionResults
+ * Purpose: What the rest of the wand uses from the motion sensors, taken as one set after each telemetry update.
  * Attributes:
- *   - roll, pitch, yaw: Euler angles in degrees representing the orientation of the device.
- *   - quaternion: Quaternion representation for orientation (w, x, y, z).
+ *   - filtered: Filtered sensor readings, including the shake flag of the latest update.
+ *   - spatial: Fused orientation.
+ *   - i_shakes: Count of updates which detected a shake, so none is missed between two reads.
  */
-struct SpatialData {
-  float roll = 0.0f;
-  float pitch = 0.0f;
-  float yaw = 0.0f;
-  float quaternion[4] = {1.0f, 0.0f, 0.0f, 0.0f};
+struct MotionResults {
+  MotionData filtered;
+  SpatialData spatial;
+  uint32_t i_shakes = 0;
 };
 
-// Global object to hold the fused sensor readings.
-SpatialData spatialData;
+// Latest results as seen by the main loop (see consumeMotionResults).
+MotionResults motionResults;
+uint32_t i_motion_shakes = 0; // Shakes detected by the sensor updates.
+uint32_t i_motion_shakes_seen = 0; // Shakes already taken by the main loop.
+
+// Time between telemetry updates (us), to show how steadily the fusion filter is being run.
+SectionStatsBuffer<PROFILER_BUCKETS_FOR_BITS(18)> motionUpdateStats;
+uint32_t i_motion_update_last = 0; // Time of the last telemetry update (us).
+bool b_motion_update_last = false; // Whether i_motion_update_last belongs to the current run of updates.
+
+// CPU cycles spent filtering each sample (the EMA, or the filter bank), to compare their cost on the device.
+SectionStatsBuffer<PROFILER_BUCKETS_FOR_BITS(16)> motionFilterStats;
+
+#if defined(MOTION_FILTER_BANK)
+/**
+ * Motion Filter Bank
+ * Each use of the readings has its own filters (see MotionFilter.h): an adaptive one-euro filter
+ * for display and telemetry, a 10 Hz low-pass for the shake thresholds, and a low-pass on the fusion
+ * filter's inputs which removes vibration but not movement. They are designed for the rate at which
+ * samples arrive, so are set again whenever that changes.
+ */
+MotionFilterBanks motionFilterBanks;
+#endif
+
+#if defined(MOTION_TASK)
+/**
+ * Motion Task
+ * Owns the motion sensors: reads them on the read interval, runs the fusion and filtering, and publishes
+ * each set of results through a SeqLock which the main loop reads without ever waiting. It runs on the
+ * core not used by the main loop, above the priority of the loop and the web server.
+ */
+SeqLock<MotionResults> motionExchange;
+TaskHandle_t motionTaskHandle = nullptr;
+const uint8_t i_motion_task_core = 0; // The Arduino loop runs on core 1.
+const uint8_t i_motion_task_priority = 12; // Above the async web server (10).
+const uint16_t i_motion_task_stack = 4096;
+const uint8_t i_motion_request_depth = 4; // Requests which may wait for the motion task.
+#endif
+
+/*
+ * Requests from the web server which change the motion state. With the motion task running they are
+ * queued and carried out by the task before its next update, as it owns the sensors and that state;
+ * otherwise they are carried out at once.
+ */
+enum MOTION_REQUESTS : uint8_t {
+  MOTION_REQUEST_RESET,               // Clear the motion data.
+  MOTION_REQUEST_RESET_CALIBRATE,     // Clear the motion data and collect quick offsets.
+  MOTION_REQUEST_GYRO_CALIBRATION,    // Begin gyroscope calibration, for the given number of seconds.
+  MOTION_REQUEST_MAG_CAL_BEGIN,       // Begin collecting magnetometer calibration samples.
+  MOTION_REQUEST_MAG_CAL_END,         // Store the magnetometer calibration if good enough, then collect quick offsets.
+  MOTION_REQUEST_ORIENTATION_CHANGED  // Clear the stored offsets, which no longer suit the sensors, and collect quick offsets.
+};
+
+struct MotionRequest {
+  uint8_t i_request;
+  uint8_t i_value;
+};
+
+#if defined(MOTION_TASK)
+QueueHandle_t motionRequestQueue = nullptr;
+#endif
 
 // Forward function declarations.
-float calculateAngularVelocity(const MotionData& data);
-float calculateGForce(const MotionData& data);
 void collectQuickMotionOffsets();
 void processMotionData();
 void readRawSensorData();
 void averageCalibrationData();
 void reportCalibrationData();
 void resetAllMotionData(bool b_calibrate);
+void handleMotionRequests();
+#if defined(MOTION_FIFO)
+void configureImuFifo();
+#endif
+void configureMotionFilters();
 void notifyWSClients(); // From Webhandler.h
 void sendGyroCalData(); // From Webhandler.h
 void sendMagCalData(bool b_update_points); // From Webhandler.h
@@ -327,6 +376,15 @@ void resetMotionOffsets(MotionOffsets &data) {
   data.gyroZ = 0.0f;
 }
 
+/**
+ * Function: resetMotionUpdateStats
+ * Purpose: Clears the telemetry update timings, eg. when the read interval changes.
+ */
+void resetMotionUpdateStats() {
+  motionUpdateStats.reset();
+  b_motion_update_last = false;
+}
+
 /**
  * Function: initializeSensors
  * Purpose: Initializes the Magnetometer and Gyroscope/Accelerometer sensors.
@@ -758,12 +816,31 @@ void configureSensors() {
      */
     imuSensor.configInt2(false, true, false);
 
-    // Set the sample frequency for the Madgwick filter (converting our sensor delay interval from milliseconds to Hz).
-    float f_sample_freq = (1000.0f / i_sensor_read_delay);
-    ahrs_filter.begin(f_sample_freq);
+    /**
+     * Purpose: Enables the LSM6DS3TR-C IMU's wake-up (any-motion) detection.
+     * Parameters:
+     *   - enable: Enable the embedded functions which detect the event (true/false).
+     *   - duration: Samples the motion must last (0-3).
+     *   - thresh: Threshold in 1/64 of the accelerometer full scale (0-63).
+     *
+     *   - The event is reported in WAKE_UP_SRC, which is polled by the motion governor while idle.
+     */
+  #if defined(MOTION_GOVERNOR)
+    imuSensor.enableWakeup(true, 0, i_motion_wake_threshold);
+    i_motion_rate_since = millis();
+    ms_motion_idle.start(i_motion_idle_timeout);
+  #endif
+
+  #if defined(MOTION_FIFO)
+    // Queue the gyroscope and accelerometer samples for reading in batches.
+    configureImuFifo();
+  #endif
+
+    // Design the filters for the rate samples will arrive at.
+    configureMotionFilters();
 
-    // Set Mahony gain values to adjust responsiveness and stability of the filter.
-    ahrs_filter.setKp(3.0f); // Proportional gain: higher = faster response (default: 0.5f)
+    // Set the sample frequency for the Mahony filter (converting our sensor delay interval from milliseconds to Hz).
+    beginOrientation(ahrs_filter, 1000.0f / i_sensor_read_delay);
   }
 #endif
 }
@@ -778,6 +855,10 @@ void resetAllMotionData(bool b_calibrate = false) {
   resetMotionData(filteredMotionData);
   resetSpatialData(spatialData);
 
+#if defined(MOTION_FILTER_BANK)
+  motionFilterBanks.reset();
+#endif
+
   if(b_calibrate) {
     debugln(F("Reset all motion data, performing quick offset collection..."));
     SENSOR_READ_TARGET = OFFSETS; // Set target to collect offsets after reset.
@@ -945,6 +1026,216 @@ OrientedSensorData applySensorOrientation(const sensors_event_t& mag_event,
   return oriented;
 }
 
+#if defined(MOTION_FIFO)
+/**
+ * Function: writeImuRegisters
+ * Purpose: Writes consecutive IMU registers in a single i2c transaction.
+ */
+bool writeImuRegisters(uint8_t reg, const uint8_t* values, uint8_t length) {
+  Wire1.beginTransmission(LSM6DS_I2CADDR_DEFAULT);
+  Wire1.write(reg);
+  Wire1.write(values, length);
+
+  return Wire1.endTransmission() == 0;
+}
+
+/**
+ * Function: readImuRegisters
+ * Purpose: Reads consecutive IMU registers, in as few i2c transactions as the Wire buffer allows.
+ *          The FIFO output register rolls back on itself, so a long read simply continues from it.
+ */
+bool readImuRegisters(uint8_t reg, uint8_t* buffer, uint16_t length) {
+  while(length > 0) {
+    uint8_t i_chunk = length > i_imu_read_chunk ? i_imu_read_chunk : length;
+
+    Wire1.beginTransmission(LSM6DS_I2CADDR_DEFAULT);
+    Wire1.write(reg);
+
+    if(Wire1.endTransmission(false) != 0 || Wire1.requestFrom(LSM6DS_I2CADDR_DEFAULT, i_chunk) != i_chunk) {
+      return false;
+    }
+
+    for(uint8_t i = 0; i < i_chunk; i++) {
+      *buffer++ = Wire1.read();
+    }
+
+    length -= i_chunk;
+  }
+
+  return true;
+}
+
+/**
+ * Function: getImuRateHz
+ * Purpose: Converts an LSM6DS3TR-C data rate to Hz (12 for 12.5 Hz, 0 when shut down).
+ */
+uint16_t getImuRateHz(lsm6ds_data_rate_t rate) {
+  switch(rate) {
+    case LSM6DS_RATE_12_5_HZ: return 12;
+    case LSM6DS_RATE_26_HZ: return 26;
+    case LSM6DS_RATE_52_HZ: return 52;
+    case LSM6DS_RATE_104_HZ: return 104;
+    case LSM6DS_RATE_208_HZ: return 208;
+    case LSM6DS_RATE_416_HZ: return 416;
+    case LSM6DS_RATE_833_HZ: return 833;
+    case LSM6DS_RATE_1_66K_HZ: return 1660;
+    case LSM6DS_RATE_3_33K_HZ: return 3330;
+    case LSM6DS_RATE_6_66K_HZ: return 6660;
+    case LSM6DS_RATE_SHUTDOWN:
+    default:
+      return 0;
+  }
+}
+
+/**
+ * Function: configureImuFifo
+ * Purpose: Restarts the IMU FIFO to queue gyroscope and accelerometer samples at the current data rate,
+ *          with the watermark at the samples expected per read interval. Shut down, the FIFO is bypassed.
+ *          Also sets the scale of the raw counts from the configured ranges, as used by the Adafruit library.
+ */
+void configureImuFifo() {
+  uint16_t i_rate_hz = getImuRateHz(imuSensor.getGyroDataRate());
+  uint16_t i_watermark = (uint32_t)i_rate_hz * i_sensor_read_delay / 1000;
+  uint8_t ctrl[IMU_FIFO_CTRL_BYTES];
+
+  switch(imuSensor.getAccelRange()) {
+    case LSM6DS_ACCEL_RANGE_2_G: f_imu_accel_scale = 0.061f; break;
+    case LSM6DS_ACCEL_RANGE_4_G: f_imu_accel_scale = 0.122f; break;
+    case LSM6DS_ACCEL_RANGE_8_G: f_imu_accel_scale = 0.244f; break;
+    case LSM6DS_ACCEL_RANGE_16_G:
+    default: f_imu_accel_scale = 0.488f; break;
+  }
+  f_imu_accel_scale = f_imu_accel_scale * f_gravity / 1000.0f; // mg to m/s^2
+
+  switch(imuSensor.getGyroRange()) {
+    case LSM6DS_GYRO_RANGE_125_DPS: f_imu_gyro_scale = 4.375f; break;
+    case LSM6DS_GYRO_RANGE_250_DPS: f_imu_gyro_scale = 8.75f; break;
+    case LSM6DS_GYRO_RANGE_500_DPS: f_imu_gyro_scale = 17.5f; break;
+    case LSM6DS_GYRO_RANGE_1000_DPS: f_imu_gyro_scale = 35.0f; break;
+    case LSM6DS_GYRO_RANGE_2000_DPS:
+    default: f_imu_gyro_scale = 70.0f; break;
+  }
+  f_imu_gyro_scale = f_imu_gyro_scale * SENSORS_DPS_TO_RADS / 1000.0f; // mdps to rad/s
+
+  motionBusBegin();
+
+  // Bypass empties the FIFO, so it starts again with nothing from the old rate.
+  imuFifoControl(0, 0, ctrl);
+  writeImuRegisters(IMU_FIFO_CTRL1, ctrl, IMU_FIFO_CTRL_BYTES);
+
+  if(i_rate_hz > 0) {
+    imuFifoControl(i_rate_hz, i_watermark > 0 ? i_watermark : 1, ctrl);
+    writeImuRegisters(IMU_FIFO_CTRL1, ctrl, IMU_FIFO_CTRL_BYTES);
+    imuClock.begin(1000000UL / i_rate_hz);
+  }
+
+  motionBusEnd();
+
+  i_imu_samples = 0;
+  b_imu_last_sample = false;
+}
+
+/**
+ * Function: readImuFifo
+ * Purpose: Reads the samples queued in the IMU FIFO (up to IMU_FIFO_MAX_SAMPLES) into imuSamples, oldest first,
+ *          and stamps them with the time they were taken.
+ * Outputs:
+ *   - uint8_t: Samples read.
+ */
+uint8_t readImuFifo() {
+  uint8_t status[IMU_FIFO_STATUS_BYTES];
+  uint16_t i_words = 0;
+
+  motionBusBegin();
+  bool b_read = readImuRegisters(IMU_FIFO_STATUS1, status, IMU_FIFO_STATUS_BYTES);
+  uint32_t i_read_time = micros(); // Every sample found was taken before now.
+  ImuFifoStatus fifo = imuFifoParseStatus(status);
+
+  if(b_read) {
+    i_words = imuFifoWordsToRead(fifo, IMU_FIFO_MAX_SAMPLES);
+
+    if(i_words > 0) {
+      b_read = readImuRegisters(IMU_FIFO_DATA_OUT_L, imuFifoBuffer, i_words * 2);
+    }
+  }
+  motionBusEnd();
+
+  if(!b_read) {
+    i_imu_samples = 0;
+    return 0;
+  }
+
+  if(fifo.overrun) {
+    // Samples were lost, so the timing starts over.
+    i_imu_fifo_overruns++;
+    imuClock.resync();
+    b_imu_last_sample = false;
+  }
+
+  i_imu_samples = imuFifoDecode(imuFifoBuffer, i_words, fifo.pattern, imuSamples, IMU_FIFO_MAX_SAMPLES);
+  imuClock.stamp(i_read_time, imuSamples, i_imu_samples, (fifo.unread - i_words) / IMU_FIFO_SAMPLE_WORDS);
+
+  return i_imu_samples;
+}
+
+/**
+ * Function: loadImuSample
+ * Purpose: Converts a FIFO sample into the gyroscope and accelerometer events, as getEvent() would have filled them.
+ */
+void loadImuSample(const ImuFifoSample& sample) {
+  gyro_event.gyro.x = sample.gyro[0] * f_imu_gyro_scale;
+  gyro_event.gyro.y = sample.gyro[1] * f_imu_gyro_scale;
+  gyro_event.gyro.z = sample.gyro[2] * f_imu_gyro_scale;
+  gyro_event.timestamp = sample.timestampUs / 1000;
+
+  accel_event.acceleration.x = sample.accel[0] * f_imu_accel_scale;
+  accel_event.acceleration.y = sample.accel[1] * f_imu_accel_scale;
+  accel_event.acceleration.z = sample.accel[2] * f_imu_accel_scale;
+  accel_event.timestamp = sample.timestampUs / 1000;
+}
+
+/**
+ * Function: getImuSampleInterval
+ * Purpose: Returns the time (s) from the previous sample to this one. The first sample of a run,
+ *          or one after a gap the clock started over from, is taken as one sample period.
+ */
+float getImuSampleInterval(uint32_t i_timestamp) {
+  uint32_t i_interval = i_timestamp - i_imu_last_sample;
+  uint32_t i_period = imuClock.getPeriodUs();
+
+  if(!b_imu_last_sample || i_interval == 0 || i_interval > i_period * 4) {
+    i_interval = i_period;
+  }
+
+  i_imu_last_sample = i_timestamp;
+  b_imu_last_sample = true;
+
+  return i_interval / 1000000.0f;
+}
+
+/**
+ * Function: getFilterAlpha
+ * Purpose: Scales FILTER_ALPHA to a sample interval, keeping the smoothing time constant it gives at f_filter_alpha_interval.
+ */
+float getFilterAlpha(float f_interval) {
+  return 1.0f - powf(1.0f - FILTER_ALPHA, f_interval / f_filter_alpha_interval);
+}
+#endif
+
+/**
+ * Function: applyRawSensorData
+ * Purpose: Applies orientation mapping and magnetic calibration to the latest sensor events, storing the results in motionData.
+ * Inputs: None (uses global mag_event, gyro_event and accel_event)
+ * Outputs: None (updates global motionData)
+ */
+void applyRawSensorData() {
+#ifdef MOTION_SENSORS
+  // Apply orientation mapping to all sensor data, then the magnetic calibration.
+  OrientedSensorData oriented = applySensorOrientation(mag_event, accel_event, gyro_event);
+  applyOrientedSample(oriented, magCalData, motionData);
+#endif
+}
+
 /**
  * Function: readRawSensorData
  * Purpose: Reads all sensor data directly from the magnetometer and IMU, applies calibration corrections and orientation mapping.
@@ -955,173 +1246,323 @@ OrientedSensorData applySensorOrientation(const sensors_event_t& mag_event,
 void readRawSensorData() {
 #ifdef MOTION_SENSORS
   if(b_imu_found && b_mag_found) {
+  #if defined(MOTION_FIFO)
+    // Use the newest sample the IMU has queued, or its output registers when nothing is queued yet.
+    if(readImuFifo() > 0) {
+      loadImuSample(imuSamples[i_imu_samples - 1]);
+
+      motionBusBegin();
+      magnetometer->getEvent(&mag_event);
+      motionBusEnd();
+
+      applyRawSensorData();
+      return;
+    }
+  #endif
+
     // Poll the sensors for raw data
+    motionBusBegin();
     magnetometer->getEvent(&mag_event);
     gyroscope->getEvent(&gyro_event);
     accelerometer->getEvent(&accel_event);
+    motionBusEnd();
 
-    // Apply orientation mapping to all sensor data
-    OrientedSensorData oriented = applySensorOrientation(mag_event, accel_event, gyro_event);
-
-    // Apply hard iron corrections to magnetic readings (post-orientation).
-    float mx = oriented.magX - magCalData.mag_hardiron[0];
-    float my = oriented.magY - magCalData.mag_hardiron[1];
-    float mz = oriented.magZ - magCalData.mag_hardiron[2];
-
-    // Apply soft iron corrections to magnetic readings (post-orientation).
-    motionData.magX = mx * magCalData.mag_softiron[0] + my * magCalData.mag_softiron[1] + mz * magCalData.mag_softiron[2];
-    motionData.magY = mx * magCalData.mag_softiron[3] + my * magCalData.mag_softiron[4] + mz * magCalData.mag_softiron[5];
-    motionData.magZ = mx * magCalData.mag_softiron[6] + my * magCalData.mag_softiron[7] + mz * magCalData.mag_softiron[8];
-
-    // Store the oriented values in global motionData struct for access.
-    // Converts gyroscope from rad/s to deg/s as expected by AHRS library.
-    motionData.accelX = oriented.accelX;
-    motionData.accelY = oriented.accelY;
-    motionData.accelZ = oriented.accelZ;
-    motionData.gyroX = oriented.gyroX * SENSORS_RADS_TO_DPS;
-    motionData.gyroY = oriented.gyroY * SENSORS_RADS_TO_DPS;
-    motionData.gyroZ = oriented.gyroZ * SENSORS_RADS_TO_DPS;
+    applyRawSensorData();
   }
 #endif
 }
 
 /**
- * Function: detectShakeEvent
- * Purpose: Detects a shake event using gForce and angular velocity thresholds.
- * Inputs: None (uses global filteredMotionData)
- * Outputs: Returns true if a shake is detected, false otherwise.
+ * Function: configureMotionFilters
+ * Purpose: Designs the filter bank for the rate at which samples are processed.
  */
-bool detectShakeEvent() {
-  const float GFORCE_SHAKE_THRESHOLD = 1.2f;    // In g, adjust as needed
-  const float ANGVEL_SHAKE_THRESHOLD = 180.0f;  // In deg/s, adjust as needed
-
-  // Detect shake if either threshold is exceeded
-  if(filteredMotionData.gForce > GFORCE_SHAKE_THRESHOLD &&
-      filteredMotionData.angVel > ANGVEL_SHAKE_THRESHOLD) {
-  #if defined(DEBUG_TELEMETRY_DATA)
-    debug(F("gForce="));
-    debug(filteredMotionData.gForce, 3);
-    debug(F(" (T="));
-    debug(GFORCE_SHAKE_THRESHOLD, 3);
-    debug(F("), angVel="));
-    debug(filteredMotionData.angVel, 3);
-    debug(F(" (T="));
-    debug(ANGVEL_SHAKE_THRESHOLD, 1);
-    debugln(F(") "));
+void configureMotionFilters() {
+  motionFilterStats.reset();
+
+#if defined(MOTION_FILTER_BANK)
+  #if defined(MOTION_FIFO)
+    // Every sample the IMU takes is processed, at its nominal data rate.
+    float f_sample_hz = imuClock.getNominalUs() > 0 ? 1000000.0f / imuClock.getNominalUs() : 0.0f;
+  #else
+    float f_sample_hz = 1000.0f / i_sensor_read_delay;
   #endif
-    return true;
-  }
 
-  return false;
+  if(f_sample_hz > 0.0f) {
+    motionFilterBanks.configure(f_sample_hz);
+  }
+#endif
 }
 
 /**
- * Function: calculateAngularVelocity
- * Purpose: Calculates the magnitude of the angular velocity vector (deg/s) from a MotionData struct.
+ * Function: formatSignedFloat
+ * Purpose: Formats a float with explicit sign (+/-) and pads with spaces if whole number < 3 digits.
  * Inputs:
- *   - const MotionData& data: Reference to the MotionData object.
+ *   - float value: The value to format.
  * Outputs:
- *   - float: Calculated angular velocity (unit: deg/s)
+ *   - String: Formatted string.
+ */
+String formatSignedFloat(float value) {
+  char buf[16];
+  int whole = abs((int)value);
+  // Determine padding: if whole < 10, pad 2 spaces; < 100, pad 1 space; else no pad
+  const char* pad = (whole < 10) ? "  " : (whole < 100) ? " " : "";
+  sprintf(buf, "%c%s%.2f", (value >= 0 ? '+' : '-'), pad, fabsf(value));
+  return String(buf);
+}
+
+#if defined(MOTION_GOVERNOR)
+/**
+ * Function: applyMotionRate
+ * Purpose: Sets the sensor data rates and read/report intervals for a motion rate.
+ * Inputs:
+ *   - enum MOTION_RATES rate: The rate to change to.
  */
-float calculateAngularVelocity(const MotionData& data) {
-  return sqrt(
-    data.gyroX * data.gyroX +
-    data.gyroY * data.gyroY +
-    data.gyroZ * data.gyroZ
-  );
+void applyMotionRate(enum MOTION_RATES rate) {
+  const MotionRateProfile &profile = motionRateProfiles[rate];
+  uint32_t i_now = millis();
+
+  motionBusBegin();
+  imuSensor.setAccelDataRate(profile.accelRate);
+  imuSensor.setGyroDataRate(profile.gyroRate);
+  magSensor.setOperationMode(profile.magMode);
+  motionBusEnd();
+
+  i_motion_rate_ms[MOTION_RATE] += i_now - i_motion_rate_since;
+  i_motion_rate_since = i_now;
+  i_motion_rate_changes++;
+  MOTION_RATE = rate;
+
+  i_sensor_read_delay = profile.i_read_delay;
+  i_sensor_report_delay = profile.i_report_delay;
+
+  // Keep the fusion filter's sample frequency in step with the read interval.
+  ahrs_filter.begin(1000.0f / i_sensor_read_delay);
+  resetMotionUpdateStats();
+
+  #if defined(MOTION_FIFO)
+    // Restart the FIFO at the new data rate (bypassed while idle, with the gyroscope off).
+    configureImuFifo();
+  #endif
+
+  configureMotionFilters();
+
+  #if defined(DEBUG_TELEMETRY_DATA)
+    debug(F("Motion rate: "));
+    debugln(profile.name);
+  #endif
 }
 
 /**
- * Function: calculateGForce
- * Purpose: Calculates the magnitude of the acceleration vector (g-force) from a MotionData struct.
+ * Function: selectMotionRate
+ * Purpose: Decides the motion rate from the wand state and the latest motion.
  * Inputs:
- *   - const MotionData& data: Reference to the MotionData object.
+ *   - bool b_wake: The accelerometer reported motion while idle.
  * Outputs:
- *   - float: Calculated g-force (unit: g)
+ *   - enum MOTION_RATES: The rate the sensors should run at.
  */
-float calculateGForce(const MotionData& data) {
-  // Use the Euclidean norm for the acceleration vector and convert to g.
-  return sqrt(
-    data.accelX * data.accelX +
-    data.accelY * data.accelY +
-    data.accelZ * data.accelZ
-  ) / f_gravity; // 1g = 9.80665 m/s^2
+enum MOTION_RATES selectMotionRate(bool b_wake) {
+  // Calibration and offset collection always run at the highest rate.
+  if(SENSOR_READ_TARGET == GYRO_CALIBRATION || SENSOR_READ_TARGET == MAG_CALIBRATION || SENSOR_READ_TARGET == OFFSETS) {
+    ms_motion_idle.start(i_motion_idle_timeout);
+    return MOTION_RATE_BOOST;
+  }
+
+  if(MOTION_RATE != MOTION_RATE_IDLE) {
+    // Shakes and fast gestures hold the higher rate for a moment after they end.
+    if(filteredMotionData.shaken || filteredMotionData.angVel > f_motion_gesture_angvel) {
+      ms_motion_boost.start(i_motion_boost_hold);
+    }
+
+    // Any movement, or the wand being on, keeps the sensors awake.
+    if(motionData.angVel > f_motion_still_angvel || fabsf(motionData.gForce - 1.0f) > f_motion_still_gforce) {
+      ms_motion_idle.start(i_motion_idle_timeout);
+    }
+  }
+
+  if(b_wake || WAND_STATUS != MODE_OFF) {
+    ms_motion_idle.start(i_motion_idle_timeout);
+  }
+
+  bool b_boost_held = !ms_motion_boost.justFinished() && ms_motion_boost.isRunning();
+
+  if(b_firing || b_boost_held) {
+    ms_motion_idle.start(i_motion_idle_timeout);
+    return MOTION_RATE_BOOST;
+  }
+
+  if(ms_motion_idle.justFinished() || !ms_motion_idle.isRunning()) {
+    return MOTION_RATE_IDLE;
+  }
+
+  return MOTION_RATE_NORMAL;
 }
 
 /**
- * Function: updateFilteredMotionData
- * Purpose: Applies exponential moving average filtering to raw motionData and updates filteredMotionData.
- * Inputs: None (uses global motionData and filteredMotionData)
- * Outputs: None (updates filteredMotionData)
+ * Function: updateMotionRate
+ * Purpose: Runs the motion governor on each read interval, changing rate when needed.
+ * Outputs:
+ *   - bool: True when the sensors should be read on this interval.
  */
-void updateFilteredMotionData() {
-  filteredMotionData.magX   = FILTER_ALPHA * motionData.magX   + (1.0f - FILTER_ALPHA) * filteredMotionData.magX;
-  filteredMotionData.magY   = FILTER_ALPHA * motionData.magY   + (1.0f - FILTER_ALPHA) * filteredMotionData.magY;
-  filteredMotionData.magZ   = FILTER_ALPHA * motionData.magZ   + (1.0f - FILTER_ALPHA) * filteredMotionData.magZ;
-  filteredMotionData.accelX = FILTER_ALPHA * motionData.accelX + (1.0f - FILTER_ALPHA) * filteredMotionData.accelX;
-  filteredMotionData.accelY = FILTER_ALPHA * motionData.accelY + (1.0f - FILTER_ALPHA) * filteredMotionData.accelY;
-  filteredMotionData.accelZ = FILTER_ALPHA * motionData.accelZ + (1.0f - FILTER_ALPHA) * filteredMotionData.accelZ;
-  filteredMotionData.gyroX  = FILTER_ALPHA * motionData.gyroX  + (1.0f - FILTER_ALPHA) * filteredMotionData.gyroX;
-  filteredMotionData.gyroY  = FILTER_ALPHA * motionData.gyroY  + (1.0f - FILTER_ALPHA) * filteredMotionData.gyroY;
-  filteredMotionData.gyroZ  = FILTER_ALPHA * motionData.gyroZ  + (1.0f - FILTER_ALPHA) * filteredMotionData.gyroZ;
+bool updateMotionRate() {
+  bool b_wake = false;
+
+  if(MOTION_RATE == MOTION_RATE_IDLE) {
+    // A single register read tells whether the wand has been moved.
+    motionBusBegin();
+    b_wake = imuSensor.awake();
+    motionBusEnd();
+  }
+
+  enum MOTION_RATES next = selectMotionRate(b_wake);
+
+  if(next != MOTION_RATE) {
+    applyMotionRate(next);
+  }
+
+  return MOTION_RATE != MOTION_RATE_IDLE;
 }
 
 /**
- * Function: updateOrientation
- * Purpose: Updates the orientation using sensor fusion (AHRS).
- * Inputs: None (uses filteredMotionData)
- * Outputs: None (updates global orientation variables)
+ * Function: getMotionRateTime
+ * Purpose: Returns the time spent at a motion rate, including the current stretch.
  */
-void updateOrientation() {
-#ifdef MOTION_SENSORS
-  /**
-   * Fusion expects gyroscope in deg/s, accelerometer in m/s^2, magnetometer in uT.
-   * It assumes a gravity-positive z-axis and NED aerospace framing.
-   * All 9 DoF values will calculate roll (X), pitch (Y), and yaw (Z).
-   * The sample frequency is in Hz and already calculated from the update time in ms.
-   */
-  ahrs_filter.update(
-    motionData.gyroX, motionData.gyroY, motionData.gyroZ,
-    motionData.accelX, motionData.accelY, motionData.accelZ,
-    motionData.magX, motionData.magY, motionData.magZ
-  );
-
-  // Get position in Euler angles (degrees) for orientation in NED space.
-  spatialData.roll = ahrs_filter.getRoll();
-  spatialData.pitch = ahrs_filter.getPitch();
-  spatialData.yaw = ahrs_filter.getYaw();
-
-  // Obtain the quaternion representation for visualization.
-  float qw, qx, qy, qz;
-  ahrs_filter.getQuaternion(&qw, &qx, &qy, &qz);
-  spatialData.quaternion[0] = qw;
-  spatialData.quaternion[1] = qx;
-  spatialData.quaternion[2] = qy;
-  spatialData.quaternion[3] = qz;
-
-  // Mirror along Z-axis to get the correct direction.
-  spatialData.yaw = 360.0f - spatialData.yaw;
-  if(spatialData.yaw >= 360.0f) {
-    spatialData.yaw -= 360.0f;
+uint32_t getMotionRateTime(uint8_t i_rate) {
+  uint32_t i_time = i_motion_rate_ms[i_rate];
+
+  if(i_rate == MOTION_RATE) {
+    i_time += millis() - i_motion_rate_since;
+  }
+
+  return i_time;
+}
+
+/**
+ * Function: getMotionAverageCurrent
+ * Purpose: Returns the sensors' average supply current (uA) since boot, weighted by the time at each rate.
+ */
+uint16_t getMotionAverageCurrent() {
+  uint64_t i_weighted = 0;
+  uint32_t i_total = 0;
+
+  for(uint8_t i = 0; i < MOTION_RATE_COUNT; i++) {
+    uint32_t i_time = getMotionRateTime(i);
+    i_weighted += (uint64_t)i_time * motionRateProfiles[i].i_current_ua;
+    i_total += i_time;
   }
+
+  return i_total > 0 ? (uint16_t)(i_weighted / i_total) : motionRateProfiles[MOTION_RATE].i_current_ua;
+}
+#endif
+
+/**
+ * Function: updateMotionSensors
+ * Purpose: Runs one read interval of the motion sensors, from the main loop or the motion task.
+ */
+void updateMotionSensors() {
+#if defined(MOTION_GOVERNOR)
+  // Choose the rate first, then read the latest data unless idle.
+  if(updateMotionRate()) {
+    processMotionData();
+  }
+#else
+  // Read the latest data, using it for calibration or telemetry processing.
+  processMotionData();
 #endif
 }
 
 /**
- * Function: formatSignedFloat
- * Purpose: Formats a float with explicit sign (+/-) and pads with spaces if whole number < 3 digits.
- * Inputs:
- *   - float value: The value to format.
+ * Function: isMotionTaskRunning
+ * Purpose: Whether the motion task has taken over the sensor reads from the main loop.
+ */
+bool isMotionTaskRunning() {
+#if defined(MOTION_TASK)
+  return motionTaskHandle != nullptr;
+#else
+  return false;
+#endif
+}
+
+#if defined(MOTION_TASK)
+/**
+ * Function: motionTask
+ * Purpose: Reads the motion sensors every read interval, measured from when the last interval was due
+ *          rather than when it finished, so the period stays fixed however long each update takes.
+ */
+void motionTask(void* parameter) {
+  TickType_t i_last_wake = xTaskGetTickCount();
+
+  for(;;) {
+    // The motion governor may change the interval between any two updates.
+    vTaskDelayUntil(&i_last_wake, pdMS_TO_TICKS(i_sensor_read_delay));
+    handleMotionRequests();
+    updateMotionSensors();
+  }
+}
+
+/**
+ * Function: startMotionTask
+ * Purpose: Starts the motion task, once the sensors are configured.
  * Outputs:
- *   - String: Formatted string.
+ *   - bool: Whether the task is running.
  */
-String formatSignedFloat(float value) {
-  char buf[16];
-  int whole = abs((int)value);
-  // Determine padding: if whole < 10, pad 2 spaces; < 100, pad 1 space; else no pad
-  const char* pad = (whole < 10) ? "  " : (whole < 100) ? " " : "";
-  sprintf(buf, "%c%s%.2f", (value >= 0 ? '+' : '-'), pad, fabsf(value));
-  return String(buf);
+bool startMotionTask() {
+  if(motionTaskHandle != nullptr) {
+    return true;
+  }
+
+  if(motionRequestQueue == nullptr) {
+    motionRequestQueue = xQueueCreate(i_motion_request_depth, sizeof(MotionRequest));
+
+    if(motionRequestQueue == nullptr) {
+      return false;
+    }
+  }
+
+  if(xTaskCreatePinnedToCore(motionTask, "MotionTask", i_motion_task_stack, nullptr, i_motion_task_priority, &motionTaskHandle, i_motion_task_core) != pdPASS) {
+    motionTaskHandle = nullptr;
+    return false;
+  }
+
+  return true;
+}
+#endif
+
+/**
+ * Function: publishMotionResults
+ * Purpose: Hands the latest filtered readings, orientation and shake count to the main loop.
+ *          Called by whichever of the main loop or the motion task reads the sensors.
+ */
+void publishMotionResults() {
+  MotionResults results;
+
+  results.filtered = filteredMotionData;
+  results.spatial = spatialData;
+  results.i_shakes = i_motion_shakes;
+
+#if defined(MOTION_TASK)
+  motionExchange.publish(results);
+#else
+  motionResults = results;
+#endif
+}
+
+/**
+ * Function: consumeMotionResults
+ * Purpose: Takes the latest results published by the motion task into motionResults for the main loop.
+ *          A shake in any update since the last call is kept, even when only the newest set is seen.
+ */
+void consumeMotionResults() {
+#if defined(MOTION_TASK)
+  MotionResults results;
+
+  if(motionExchange.read(results)) {
+    bool b_missed_shake = results.i_shakes != i_motion_shakes_seen;
+
+    i_motion_shakes_seen = results.i_shakes;
+    motionResults = results;
+    motionResults.filtered.shaken = results.filtered.shaken || b_missed_shake;
+  }
+#endif
 }
 
 /**
@@ -1131,16 +1572,20 @@ String formatSignedFloat(float value) {
 void checkMotionSensors() {
 #ifdef MOTION_SENSORS
   if(b_imu_found && b_mag_found) {
-    // Read the IMU/MAG values every N milliseconds.
-    if(!ms_sensor_read_delay.isRunning()) {
-      // Start the delay timer if not already running.
-      ms_sensor_read_delay.start(i_sensor_read_delay);
-    }
-    else if(ms_sensor_read_delay.justFinished()) {
-      // Read the latest data, using it for calibration or telemetry processing.
-      processMotionData();
+    if(!isMotionTaskRunning()) {
+      // Read the IMU/MAG values every N milliseconds.
+      if(!ms_sensor_read_delay.isRunning()) {
+        // Start the delay timer if not already running.
+        ms_sensor_read_delay.start(i_sensor_read_delay);
+      }
+      else if(ms_sensor_read_delay.justFinished()) {
+        updateMotionSensors();
+      }
     }
 
+    // Take the latest results, whether from the motion task or the read above.
+    consumeMotionResults();
+
     // Report the averaged IMU/MAG values every N milliseconds.
     if(!ms_sensor_report_delay.isRunning()) {
       ms_sensor_report_delay.start(i_sensor_report_delay);
@@ -1165,11 +1610,11 @@ void checkMotionSensors() {
       debugln(F(" m/s^2 "));
 
       debug(F("\t\tAvg Accel X: "));
-      debug(formatSignedFloat(filteredMotionData.accelX));
+      debug(formatSignedFloat(motionResults.filtered.accelX));
       debug(F(" \tY: "));
-      debug(formatSignedFloat(filteredMotionData.accelY));
+      debug(formatSignedFloat(motionResults.filtered.accelY));
       debug(F(" \tZ: "));
-      debug(formatSignedFloat(filteredMotionData.accelZ));
+      debug(formatSignedFloat(motionResults.filtered.accelZ));
       debugln(F(" m/s^2 "));
       debugln();
 
@@ -1177,7 +1622,7 @@ void checkMotionSensors() {
       debug(motionData.gForce);
       debugln(F("g "));
       debug(F("\t\tAvg G-Force: "));
-      debug(filteredMotionData.gForce);
+      debug(motionResults.filtered.gForce);
       debugln(F("g "));
       debugln();
 
@@ -1198,11 +1643,11 @@ void checkMotionSensors() {
       debugln(F(" deg/s "));
 
       debug(F("\t\tAvg Gyro  X: "));
-      debug(formatSignedFloat(filteredMotionData.gyroX));
+      debug(formatSignedFloat(motionResults.filtered.gyroX));
       debug(F(" \tY: "));
-      debug(formatSignedFloat(filteredMotionData.gyroY));
+      debug(formatSignedFloat(motionResults.filtered.gyroY));
       debug(F(" \tZ: "));
-      debug(formatSignedFloat(filteredMotionData.gyroZ));
+      debug(formatSignedFloat(motionResults.filtered.gyroZ));
       debugln(F(" deg/s "));
       debugln();
 
@@ -1215,20 +1660,20 @@ void checkMotionSensors() {
       debugln(F(" uTesla "));
 
       debug(F("\t\tAvg Mag   X: "));
-      debug(formatSignedFloat(filteredMotionData.magX));
+      debug(formatSignedFloat(motionResults.filtered.magX));
       debug(F(" \tY: "));
-      debug(formatSignedFloat(filteredMotionData.magY));
+      debug(formatSignedFloat(motionResults.filtered.magY));
       debug(F(" \tZ: "));
-      debug(formatSignedFloat(filteredMotionData.magZ));
+      debug(formatSignedFloat(motionResults.filtered.magZ));
       debugln(F(" uTesla "));
       debugln();
 
       debug(F("\t\tRoll (x): "));
-      debug(formatSignedFloat(spatialData.roll));
+      debug(formatSignedFloat(motionResults.spatial.roll));
       debug(F("\tPitch (Y): "));
-      debug(formatSignedFloat(spatialData.pitch));
+      debug(formatSignedFloat(motionResults.spatial.pitch));
       debug(F("\tYaw (Z): "));
-      debug(formatSignedFloat(spatialData.yaw));
+      debug(formatSignedFloat(motionResults.spatial.yaw));
       debugln();
       debugln();
     #endif
@@ -1242,12 +1687,69 @@ void checkMotionSensors() {
 #endif
 }
 
-// Helper: Returns true when a MotionOffsets instance appears to be default/empty.
-inline bool isMotionOffsetsDefault(const MotionOffsets &m) {
-  // Explicit field checks are preferred over raw byte checks to avoid issues with padding/NaN.
-  return (m.samples == 0) &&
-         (m.accelX == 0.0f) && (m.accelY == 0.0f) && (m.accelZ == 0.0f) &&
-         (m.gyroX  == 0.0f) && (m.gyroY  == 0.0f) && (m.gyroZ  == 0.0f);
+/**
+ * Function: processTelemetrySample
+ * Purpose: Applies offsets, sensor fusion and filtering to the sample in motionData, then checks for a shake.
+ * Inputs:
+ *   - float f_interval: Time since the previous sample, in seconds.
+ *   - float f_alpha: Smoothing factor for the filtered values.
+ * Outputs: None, operates on global motionData, filteredMotionData and spatialData.
+ */
+void processTelemetrySample(float f_interval, float f_alpha) {
+#ifdef MOTION_SENSORS
+  // Apply offsets to IMU readings only after we know the installation orientation.
+  const MotionOffsets *usedOffsets = nullptr;
+  if(INSTALL_ORIENTATION != COMPONENTS_FACTORY_DEFAULT) {
+    // Choose Offsets: Prefer calibratedOffsets, but use quickOffsets when calibrated offsets are default/empty.
+    usedOffsets = &calibratedOffsets;
+    if(isMotionOffsetsDefault(calibratedOffsets)) {
+      usedOffsets = &quickOffsets;
+
+      #if defined(DEBUG_TELEMETRY_DATA)
+        debugln(F("No calibrated offsets present; using quickOffsets for runtime corrections."));
+      #endif
+    }
+  }
+
+#if defined(MOTION_FILTER_BANK)
+  MotionFilterBanks *banks = &motionFilterBanks;
+#else
+  MotionFilterBanks *banks = nullptr;
+#endif
+
+  motionFilterStats.record(processMotionSample(ahrs_filter, motionData, filteredMotionData, spatialData,
+                                               usedOffsets, banks, f_interval, f_alpha));
+
+#if defined(DEBUG_TELEMETRY_DATA)
+  if(filteredMotionData.shaken) {
+    const MotionData &shakeData = banks != nullptr ? banks->shakeData : filteredMotionData;
+    debug(F("gForce="));
+    debug(shakeData.gForce, 3);
+    debug(F(" (T="));
+    debug(GFORCE_SHAKE_THRESHOLD, 3);
+    debug(F("), angVel="));
+    debug(shakeData.angVel, 3);
+    debug(F(" (T="));
+    debug(ANGVEL_SHAKE_THRESHOLD, 1);
+    debugln(F(") "));
+  }
+#endif
+#endif
+}
+
+/**
+ * Function: recordMotionUpdate
+ * Purpose: Records the time since the last telemetry update, which shows how steadily the fusion filter runs.
+ */
+void recordMotionUpdate() {
+  uint32_t i_now = micros();
+
+  if(b_motion_update_last) {
+    motionUpdateStats.record(i_now - i_motion_update_last);
+  }
+
+  i_motion_update_last = i_now;
+  b_motion_update_last = true;
 }
 
 /**
@@ -1258,6 +1760,13 @@ inline bool isMotionOffsetsDefault(const MotionOffsets &m) {
  */
 void processMotionData() {
 #ifdef MOTION_SENSORS
+  if(SENSOR_READ_TARGET == TELEMETRY) {
+    recordMotionUpdate();
+  }
+  else {
+    b_motion_update_last = false; // Don't count the time spent away from telemetry.
+  }
+
   switch(SENSOR_READ_TARGET) {
     case NOT_INITIALIZED:
       // Can't do anything until the sensors have been initialized and configured.
@@ -1277,52 +1786,40 @@ void processMotionData() {
 
     case TELEMETRY:
     default:
-      // Read the raw sensor data with orientation corrections and update the motionData object.
-      readRawSensorData();
-
-      // Calculate the magnitude of the raw angular velocity vector (deg/s).
-      motionData.angVel = calculateAngularVelocity(motionData);
-
-      // Calculate the magnitude of the raw acceleration vector (g-force).
-      motionData.gForce = calculateGForce(motionData);
-
-      // Apply offsets to IMU readings only after we know the installation orientation.
-      if(INSTALL_ORIENTATION != COMPONENTS_FACTORY_DEFAULT) {
-        // Choose Offsets: Prefer calibratedOffsets, but use quickOffsets when calibrated offsets are default/empty.
-        const MotionOffsets *usedOffsets = &calibratedOffsets;
-        if(isMotionOffsetsDefault(calibratedOffsets)) {
-          usedOffsets = &quickOffsets;
-
-          #if defined(DEBUG_TELEMETRY_DATA)
-            debugln(F("No calibrated offsets present; using quickOffsets for runtime corrections."));
-          #endif
+    #if defined(MOTION_FIFO)
+      // Run every sample queued since the last read through the telemetry, each with its own interval.
+      if(readImuFifo() > 0) {
+        bool b_shaken = false;
+
+        motionBusBegin();
+        magnetometer->getEvent(&mag_event);
+        motionBusEnd();
+
+        for(uint8_t i = 0; i < i_imu_samples; i++) {
+          loadImuSample(imuSamples[i]);
+          applyRawSensorData();
+
+          float f_interval = getImuSampleInterval(imuSamples[i].timestampUs);
+          processTelemetrySample(f_interval, getFilterAlpha(f_interval));
+          b_shaken = b_shaken || filteredMotionData.shaken;
         }
 
-        // Apply chosen offsets
-        motionData.accelX -= usedOffsets->accelX;
-        motionData.accelY -= usedOffsets->accelY;
-        motionData.accelZ -= usedOffsets->accelZ;
-        motionData.gyroX  -= usedOffsets->gyroX;
-        motionData.gyroY  -= usedOffsets->gyroY;
-        motionData.gyroZ  -= usedOffsets->gyroZ;
+        // A shake anywhere in the batch counts.
+        filteredMotionData.shaken = b_shaken;
       }
+    #else
+      // Read the raw sensor data with orientation corrections and update the motionData object.
+      readRawSensorData();
+      processTelemetrySample(i_sensor_read_delay / 1000.0f, FILTER_ALPHA);
+    #endif
 
-      // Update the orientation via sensor fusion.
-      updateOrientation();
-
-      // Apply exponential moving average (EMA) smoothing filter to sensor data.
-      updateFilteredMotionData();
-
-      // Calculate the magnitude of the raw angular velocity vector (deg/s).
-      filteredMotionData.angVel = calculateAngularVelocity(filteredMotionData);
-
-      // Calculate the magnitude of the filtered acceleration vector (g-force).
-      filteredMotionData.gForce = calculateGForce(filteredMotionData);
-
-      // Check for shake events which use our calculated values.
-      filteredMotionData.shaken = detectShakeEvent();
+      if(filteredMotionData.shaken) {
+        i_motion_shakes++;
+      }
     break;
   }
+
+  publishMotionResults();
 #endif
 }
 
@@ -1383,6 +1880,100 @@ void beginGyroCalibration(uint8_t i_duration_seconds) {
 #endif
 }
 
+/**
+ * Function: runMotionRequest
+ * Purpose: Carries out a request from the web server, from whichever context owns the sensors.
+ */
+void runMotionRequest(const MotionRequest& request) {
+#ifdef MOTION_SENSORS
+  switch(request.i_request) {
+    case MOTION_REQUEST_RESET:
+      resetAllMotionData(false); // Clear but don't re-calibrate.
+    break;
+
+    case MOTION_REQUEST_RESET_CALIBRATE:
+      resetAllMotionData(true); // Clear and re-calibrate (quick).
+    break;
+
+    case MOTION_REQUEST_GYRO_CALIBRATION:
+      beginGyroCalibration(request.i_value);
+    break;
+
+    case MOTION_REQUEST_MAG_CAL_BEGIN:
+      resetAllMotionData(false); // Clear but don't re-calibrate.
+      SENSOR_READ_TARGET = MAG_CALIBRATION; // Enables collection of magnetometer data.
+      magCal.beginCalibration(); // Start collection of samples, clears counters.
+    break;
+
+    case MOTION_REQUEST_MAG_CAL_END:
+      // Only keep the calibration if proper coverage was achieved.
+      if(magCal.getCoveragePercent() >= 60.0f) {
+        magCalData = magCal.computeCalibration();
+
+        // Create Preferences object to handle non-volatile storage (NVS).
+        Preferences preferences;
+
+        // Save the calibration data (as an object) to preferences.
+        if(preferences.begin("device", false)) {
+          preferences.putBytes("mag_cal", &magCalData, sizeof(magCalData));
+          preferences.end();
+        }
+      }
+
+      resetAllMotionData(true); // Reset and re-calibrate with fresh offsets.
+    break;
+
+    case MOTION_REQUEST_ORIENTATION_CHANGED:
+      resetMotionOffsets(calibratedOffsets); // Clear previous offsets set/collected.
+      resetAllMotionData(true); // Reset and re-calibrate with fresh, quick offsets.
+      accelOffsets = Axis3F();
+      gyroOffsets = Axis3F();
+    break;
+
+    default:
+      // No-op for anything else.
+    break;
+  }
+
+  notifyWSClients();
+#else
+  (void)(request);
+#endif
+}
+
+/**
+ * Function: postMotionRequest
+ * Purpose: Hands a request to the motion task, or carries it out now when the main loop reads the sensors.
+ * Outputs:
+ *   - bool: Whether the request was accepted.
+ */
+bool postMotionRequest(uint8_t i_request, uint8_t i_value = 0) {
+  MotionRequest request = {i_request, i_value};
+
+#if defined(MOTION_TASK)
+  if(isMotionTaskRunning()) {
+    return xQueueSend(motionRequestQueue, &request, 0) == pdTRUE;
+  }
+#endif
+
+  runMotionRequest(request);
+  return true;
+}
+
+/**
+ * Function: handleMotionRequests
+ * Purpose: Carries out any requests waiting for the motion task, before it next reads the sensors.
+ */
+void handleMotionRequests() {
+#if defined(MOTION_TASK)
+  MotionRequest request;
+
+  while(motionRequestQueue != nullptr && xQueueReceive(motionRequestQueue, &request, 0) == pdTRUE) {
+    runMotionRequest(request);
+  }
+#endif
+}
+
 /**
  * Function: averageCalibrationData
  * Purpose: Collects the current calibration data from the motion sensors with proper orientation mapping.
@@ -1495,9 +2086,11 @@ void averageCalibrationData() {
 void reportCalibrationData() {
 #ifdef MOTION_SENSORS
   // Begin by reading the raw sensor data.
+  motionBusBegin();
   magnetometer->getEvent(&mag_event);
   gyroscope->getEvent(&gyro_event);
   accelerometer->getEvent(&accel_event);
+  motionBusEnd();
 
   // Uncomment to force the device's raw orientation for calibration reporting, when necessary.
   // INSTALL_ORIENTATION = COMPONENTS_FACTORY_DEFAULT;
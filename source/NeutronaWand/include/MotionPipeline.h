@@ -0,0 +1,459 @@
+/**
+ *   GPStar Neutrona Wand - Ghostbusters Proton Pack & Neutrona Wand.
+ *   Copyright (C) 2023-2026 Michael Rajotte <michael.rajotte@gpstartechnologies.com>
+ *
+ *   This program is free software; you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation; either version 3 of the License, or
+ *   (at your option) any later version.
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License
+ *   along with this program; if not, see <https://www.gnu.org/licenses/>.
+ *
+ */
+
+#pragma once
+
+/**
+ * Motion Pipeline
+ * Everything a motion sample goes through once it has been read and oriented: calibration, offsets,
+ * filtering, sensor fusion and shake detection. Nothing here touches the sensors, the Arduino core
+ * or a global, so the same code also runs natively to replay recorded movement (see test/MotionReplay.cpp).
+ * The sensor fusion filter is a template parameter: Adafruit_Mahony on the device, or any class with
+ * the same update/getRoll/getPitch/getYaw/getQuaternion methods.
+ */
+
+#include <math.h>
+#include <stdint.h>
+#include <MagCalibration.h>
+#include <MotionFilter.h>
+
+#ifndef SENSORS_RADS_TO_DPS
+  #define SENSORS_RADS_TO_DPS (57.29577793F) // As defined by Adafruit_Sensor.h.
+#endif
+
+/**
+ * Counts CPU cycles for timing the filters. Defaults to the ESP32 cycle counter, and may be
+ * defined before this header is included to use another counter (eg. when run natively).
+ */
+#ifndef MOTION_PIPELINE_CYCLES
+  #if defined(ESP32)
+    #define MOTION_PIPELINE_CYCLES() ESP.getCycleCount()
+  #else
+    #define MOTION_PIPELINE_CYCLES() 0
+  #endif
+#endif
+
+const float f_gravity = 9.80665f; // Constant for converting m/s^2 to Gs.
+
+/**
+ * Constant: FILTER_ALPHA
+ * Purpose: Controls the smoothing factor for exponential moving average filtering (0 < FILTER_ALPHA <= 1).
+ *          Increasing this value makes it more responsive to changes, decreasing smooths out fluctuations.
+ *
+ * How it works:
+ *   - FILTER_ALPHA determines how much weight is given to the newest sensor reading versus the previous filtered value.
+ *   - The formula for each update is:
+ *       filteredValue = FILTER_ALPHA * newValue + (1 - FILTER_ALPHA) * previousFilteredValue;
+ *   - If FILTER_ALPHA is close to 1.0:
+ *       - The filter reacts quickly to new data (less smoothing, more responsive).
+ *   - If FILTER_ALPHA is close to 0.0:
+ *       - The filter reacts slowly (more smoothing, less responsive).
+ *
+ * Example:
+ *   - FILTER_ALPHA = 0.1: Very smooth, but slow to respond to rapid changes.
+ *   - FILTER_ALPHA = 0.5: Balanced between smoothness and responsiveness.
+ *   - FILTER_ALPHA = 0.9: Very responsive, but less smoothing.
+ *
+ * Tuning:
+ *   - Increase FILTER_ALPHA if you want the sensor data to react faster to changes.
+ *   - Decrease FILTER_ALPHA if you want to suppress noise and jitter more.
+ */
+const float FILTER_ALPHA = 0.4f;
+
+// Proportional gain of the Mahony filter: higher = faster response (default: 0.5f).
+const float AHRS_PROPORTIONAL_GAIN = 3.0f;
+
+// Thresholds which must both be exceeded by the filtered readings to count as a shake.
+const float GFORCE_SHAKE_THRESHOLD = 1.2f;    // In g, adjust as needed
+const float ANGVEL_SHAKE_THRESHOLD = 180.0f;  // In deg/s, adjust as needed
+
+/**
+ * Struct: OrientedSensorData
+ * Purpose: Holds raw sensor readings that have been oriented according to installation but not yet calibrated or filtered.
+ * Attributes:
+ *   - magX, magY, magZ: Oriented magnetometer readings (uTesla)
+ *   - accelX, accelY, accelZ: Oriented accelerometer readings (m/s^2)
+ *   - gyroX, gyroY, gyroZ: Oriented gyroscope readings (rad/s, as reported by the sensor)
+ */
+struct OrientedSensorData {
+  float magX = 0.0f;
+  float magY = 0.0f;
+  float magZ = 0.0f;
+  float accelX = 0.0f;
+  float accelY = 0.0f;
+  float accelZ = 0.0f;
+  float gyroX = 0.0f;
+  float gyroY = 0.0f;
+  float gyroZ = 0.0f;
+};
+
+/**
+ * Struct: MotionData
+ * Purpose: Holds all motion sensor readings from the magnetometer, accelerometer, and gyroscope.
+ * Attributes:
+ *   - magX, magY, magZ: Magnetometer readings (uTesla)
+ *   - accelX, accelY, accelZ: Accelerometer readings (m/s^2)
+ *   - gyroX, gyroY, gyroZ: Gyroscope readings (deg/s)
+ */
+struct MotionData {
+  // Magnetometer readings (uTesla)
+  float magX = 0.0f;
+  float magY = 0.0f;
+  float magZ = 0.0f;
+  // Accelerometer readings (m/s^2)
+  float accelX = 0.0f;
+  float accelY = 0.0f;
+  float accelZ = 0.0f;
+  // Gyroscope readings (deg/s)
+  float gyroX = 0.0f;
+  float gyroY = 0.0f;
+  float gyroZ = 0.0f;
+  // Calculated g-force (unit: g)
+  float gForce = 0.0f;
+  // Calculated angular velocity (unit: deg/s)
+  float angVel = 0.0f;
+  // Indicator for sudden movement (using calculated values)
+  bool shaken = false;
+};
+
+/**
+ * Struct: MotionOffsets
+ * Purpose: Holds baseline offsets for accelerometer and gyroscope to correct sensor drift.
+ * This data is calculated on every reset of telemetry data and acts as a point of reference
+ * for future movement. Effectively, this resets the center of the sensor's coordinate system.
+ * Members:
+ *   - accelX, accelY, accelZ: Accelerometer offsets (m/s^2)
+ *   - gyroX, gyroY, gyroZ: Gyroscope offsets (deg/s)
+ */
+struct MotionOffsets {
+  float sumAccelX = 0.0f;
+  float sumAccelY = 0.0f;
+  float sumAccelZ = 0.0f;
+  float sumGyroX = 0.0f;
+  float sumGyroY = 0.0f;
+  float sumGyroZ = 0.0f;
+  uint16_t samples = 0;
+  float accelX = 0.0f;
+  float accelY = 0.0f;
+  float accelZ = 0.0f;
+  float gyroX = 0.0f;
+  float gyroY = 0.0f;
+  float gyroZ = 0.0f;
+};
+
+/**
+ * Struct: SpatialData
+ * Purpose: Holds fused sensor readings from the magnetometer, accelerometer, and gyroscope.
+ * Attributes:
+ *   - roll, pitch, yaw: Euler angles in degrees representing the orientation of the device.
+ *   - quaternion: Quaternion representation for orientation (w, x, y, z).
+ */
+struct SpatialData {
+  float roll = 0.0f;
+  float pitch = 0.0f;
+  float yaw = 0.0f;
+  float quaternion[4] = {1.0f, 0.0f, 0.0f, 0.0f};
+};
+
+/**
+ * Struct: MotionFilterBanks
+ * Purpose: Filters for each use of the readings (see MotionFilter.h), with the readings filtered for
+ *          the shake thresholds and the fusion filter. The display filters write to filteredMotionData.
+ */
+struct MotionFilterBanks {
+  MotionFilterBank display;
+  MotionFilterBank shake;
+  MotionFilterBank ahrs;
+  MotionData shakeData;
+  MotionData ahrsData;
+
+  // Designs every bank for the rate at which samples are processed.
+  void configure(float f_sample_hz) {
+    display.configure(MOTION_FILTERS_DISPLAY, f_sample_hz);
+    shake.configure(MOTION_FILTERS_SHAKE, f_sample_hz);
+    ahrs.configure(MOTION_FILTERS_AHRS, f_sample_hz);
+  }
+
+  void reset() {
+    display.reset();
+    shake.reset();
+    ahrs.reset();
+    shakeData = MotionData();
+    ahrsData = MotionData();
+  }
+};
+
+/**
+ * Function: applyOrientedSample
+ * Purpose: Applies magnetic calibration to an oriented sample and converts the gyroscope to deg/s.
+ * Inputs:
+ *   - const OrientedSensorData& oriented: Readings mapped to the installation orientation.
+ *   - const CalibrationData& calibration: Hard and soft iron corrections for the magnetometer.
+ *   - MotionData& data: Where the calibrated readings go.
+ */
+inline void applyOrientedSample(const OrientedSensorData& oriented, const CalibrationData& calibration, MotionData& data) {
+  // Apply hard iron corrections to magnetic readings (post-orientation).
+  float mx = oriented.magX - calibration.mag_hardiron[0];
+  float my = oriented.magY - calibration.mag_hardiron[1];
+  float mz = oriented.magZ - calibration.mag_hardiron[2];
+
+  // Apply soft iron corrections to magnetic readings (post-orientation).
+  data.magX = mx * calibration.mag_softiron[0] + my * calibration.mag_softiron[1] + mz * calibration.mag_softiron[2];
+  data.magY = mx * calibration.mag_softiron[3] + my * calibration.mag_softiron[4] + mz * calibration.mag_softiron[5];
+  data.magZ = mx * calibration.mag_softiron[6] + my * calibration.mag_softiron[7] + mz * calibration.mag_softiron[8];
+
+  // Store the oriented values in the MotionData struct for access.
+  // Converts gyroscope from rad/s to deg/s as expected by AHRS library.
+  data.accelX = oriented.accelX;
+  data.accelY = oriented.accelY;
+  data.accelZ = oriented.accelZ;
+  data.gyroX = oriented.gyroX * SENSORS_RADS_TO_DPS;
+  data.gyroY = oriented.gyroY * SENSORS_RADS_TO_DPS;
+  data.gyroZ = oriented.gyroZ * SENSORS_RADS_TO_DPS;
+}
+
+// Helper: Returns true when a MotionOffsets instance appears to be default/empty.
+inline bool isMotionOffsetsDefault(const MotionOffsets &m) {
+  // Explicit field checks are preferred over raw byte checks to avoid issues with padding/NaN.
+  return (m.samples == 0) &&
+         (m.accelX == 0.0f) && (m.accelY == 0.0f) && (m.accelZ == 0.0f) &&
+         (m.gyroX  == 0.0f) && (m.gyroY  == 0.0f) && (m.gyroZ  == 0.0f);
+}
+
+/**
+ * Function: applyMotionOffsets
+ * Purpose: Removes the baseline offsets from the accelerometer and gyroscope readings.
+ */
+inline void applyMotionOffsets(const MotionOffsets& offsets, MotionData& data) {
+  data.accelX -= offsets.accelX;
+  data.accelY -= offsets.accelY;
+  data.accelZ -= offsets.accelZ;
+  data.gyroX  -= offsets.gyroX;
+  data.gyroY  -= offsets.gyroY;
+  data.gyroZ  -= offsets.gyroZ;
+}
+
+/**
+ * Function: detectShakeEvent
+ * Purpose: Detects a shake event using gForce and angular velocity thresholds.
+ * Inputs:
+ *   - const MotionData& data: Filtered readings, with gForce and angVel calculated.
+ * Outputs: Returns true if a shake is detected, false otherwise.
+ */
+inline bool detectShakeEvent(const MotionData& data) {
+  // Detect shake only if both thresholds are exceeded
+  return data.gForce > GFORCE_SHAKE_THRESHOLD && data.angVel > ANGVEL_SHAKE_THRESHOLD;
+}
+
+/**
+ * Function: calculateAngularVelocity
+ * Purpose: Calculates the magnitude of the angular velocity vector (deg/s) from a MotionData struct.
+ * Inputs:
+ *   - const MotionData& data: Reference to the MotionData object.
+ * Outputs:
+ *   - float: Calculated angular velocity (unit: deg/s)
+ */
+inline float calculateAngularVelocity(const MotionData& data) {
+  return sqrt(
+    data.gyroX * data.gyroX +
+    data.gyroY * data.gyroY +
+    data.gyroZ * data.gyroZ
+  );
+}
+
+/**
+ * Function: calculateGForce
+ * Purpose: Calculates the magnitude of the acceleration vector (g-force) from a MotionData struct.
+ * Inputs:
+ *   - const MotionData& data: Reference to the MotionData object.
+ * Outputs:
+ *   - float: Calculated g-force (unit: g)
+ */
+inline float calculateGForce(const MotionData& data) {
+  // Use the Euclidean norm for the acceleration vector and convert to g.
+  return sqrt(
+    data.accelX * data.accelX +
+    data.accelY * data.accelY +
+    data.accelZ * data.accelZ
+  ) / f_gravity; // 1g = 9.80665 m/s^2
+}
+
+/**
+ * Function: updateFilteredMotionData
+ * Purpose: Applies exponential moving average filtering to the raw readings.
+ * Inputs:
+ *   - const MotionData& data: Raw readings, with offsets applied.
+ *   - MotionData& filtered: Running filtered readings to update.
+ *   - float f_alpha: Smoothing factor for this sample (FILTER_ALPHA, or as scaled to the sample interval).
+ */
+inline void updateFilteredMotionData(const MotionData& data, MotionData& filtered, float f_alpha) {
+  filtered.magX   = f_alpha * data.magX   + (1.0f - f_alpha) * filtered.magX;
+  filtered.magY   = f_alpha * data.magY   + (1.0f - f_alpha) * filtered.magY;
+  filtered.magZ   = f_alpha * data.magZ   + (1.0f - f_alpha) * filtered.magZ;
+  filtered.accelX = f_alpha * data.accelX + (1.0f - f_alpha) * filtered.accelX;
+  filtered.accelY = f_alpha * data.accelY + (1.0f - f_alpha) * filtered.accelY;
+  filtered.accelZ = f_alpha * data.accelZ + (1.0f - f_alpha) * filtered.accelZ;
+  filtered.gyroX  = f_alpha * data.gyroX  + (1.0f - f_alpha) * filtered.gyroX;
+  filtered.gyroY  = f_alpha * data.gyroY  + (1.0f - f_alpha) * filtered.gyroY;
+  filtered.gyroZ  = f_alpha * data.gyroZ  + (1.0f - f_alpha) * filtered.gyroZ;
+}
+
+/**
+ * Function: applyMotionFilters
+ * Purpose: Filters every axis of the readings with one bank of filters.
+ * Inputs:
+ *   - MotionFilterBank& bank: Filters for this use of the readings.
+ *   - const MotionData& data: Readings to filter.
+ *   - MotionData& filtered: Where the filtered readings go (gForce, angVel and shaken are left alone).
+ *   - float f_interval: Time since the previous sample, in seconds.
+ */
+inline void applyMotionFilters(MotionFilterBank& bank, const MotionData& data, MotionData& filtered, float f_interval) {
+  filtered.accelX = bank.update(MOTION_AXIS_ACCEL_X, data.accelX, f_interval);
+  filtered.accelY = bank.update(MOTION_AXIS_ACCEL_Y, data.accelY, f_interval);
+  filtered.accelZ = bank.update(MOTION_AXIS_ACCEL_Z, data.accelZ, f_interval);
+  filtered.gyroX = bank.update(MOTION_AXIS_GYRO_X, data.gyroX, f_interval);
+  filtered.gyroY = bank.update(MOTION_AXIS_GYRO_Y, data.gyroY, f_interval);
+  filtered.gyroZ = bank.update(MOTION_AXIS_GYRO_Z, data.gyroZ, f_interval);
+  filtered.magX = bank.update(MOTION_AXIS_MAG_X, data.magX, f_interval);
+  filtered.magY = bank.update(MOTION_AXIS_MAG_Y, data.magY, f_interval);
+  filtered.magZ = bank.update(MOTION_AXIS_MAG_Z, data.magZ, f_interval);
+}
+
+/**
+ * Function: beginOrientation
+ * Purpose: Sets the sample frequency and gain of the sensor fusion filter.
+ * Inputs:
+ *   - Fusion& fusion: The sensor fusion filter.
+ *   - float f_sample_hz: Rate at which samples will be given to it.
+ */
+template <typename Fusion>
+void beginOrientation(Fusion& fusion, float f_sample_hz) {
+  fusion.begin(f_sample_hz);
+
+  // Set Mahony gain values to adjust responsiveness and stability of the filter.
+  fusion.setKp(AHRS_PROPORTIONAL_GAIN);
+}
+
+/**
+ * Function: updateOrientation
+ * Purpose: Updates the orientation using sensor fusion (AHRS).
+ * Inputs:
+ *   - Fusion& fusion: The sensor fusion filter.
+ *   - const MotionData& data: Readings to fuse, with offsets applied.
+ *   - float f_interval: Time since the previous sample, in seconds.
+ *   - SpatialData& spatial: Where the orientation goes.
+ */
+template <typename Fusion>
+void updateOrientation(Fusion& fusion, const MotionData& data, float f_interval, SpatialData& spatial) {
+  /**
+   * Fusion expects gyroscope in deg/s, accelerometer in m/s^2, magnetometer in uT.
+   * It assumes a gravity-positive z-axis and NED aerospace framing.
+   * All 9 DoF values will calculate roll (X), pitch (Y), and yaw (Z).
+   * The gyroscope is integrated over the interval since the previous sample.
+   */
+  fusion.update(
+    data.gyroX, data.gyroY, data.gyroZ,
+    data.accelX, data.accelY, data.accelZ,
+    data.magX, data.magY, data.magZ,
+    f_interval
+  );
+
+  // Get position in Euler angles (degrees) for orientation in NED space.
+  spatial.roll = fusion.getRoll();
+  spatial.pitch = fusion.getPitch();
+  spatial.yaw = fusion.getYaw();
+
+  // Obtain the quaternion representation for visualization.
+  float qw, qx, qy, qz;
+  fusion.getQuaternion(&qw, &qx, &qy, &qz);
+  spatial.quaternion[0] = qw;
+  spatial.quaternion[1] = qx;
+  spatial.quaternion[2] = qy;
+  spatial.quaternion[3] = qz;
+
+  // Mirror along Z-axis to get the correct direction.
+  spatial.yaw = 360.0f - spatial.yaw;
+  if(spatial.yaw >= 360.0f) {
+    spatial.yaw -= 360.0f;
+  }
+}
+
+/**
+ * Function: processMotionSample
+ * Purpose: Applies offsets, filtering and sensor fusion to one calibrated sample, then checks for a shake.
+ * Inputs:
+ *   - Fusion& fusion: The sensor fusion filter.
+ *   - MotionData& data: The sample, which has its offsets removed and gForce/angVel set.
+ *   - MotionData& filtered: Filtered readings for display, with filtered.shaken set for this sample.
+ *   - SpatialData& spatial: Where the orientation goes.
+ *   - const MotionOffsets* offsets: Offsets to remove, or nullptr while the installation orientation is unknown.
+ *   - MotionFilterBanks* banks: Filters to use, or nullptr for the moving average at f_alpha.
+ *   - float f_interval: Time since the previous sample, in seconds.
+ *   - float f_alpha: Smoothing factor for the moving average.
+ * Outputs: CPU cycles spent filtering (from MOTION_PIPELINE_CYCLES).
+ */
+template <typename Fusion>
+uint32_t processMotionSample(Fusion& fusion, MotionData& data, MotionData& filtered, SpatialData& spatial,
+                             const MotionOffsets* offsets, MotionFilterBanks* banks, float f_interval, float f_alpha) {
+  // Calculate the magnitude of the raw angular velocity vector (deg/s).
+  data.angVel = calculateAngularVelocity(data);
+
+  // Calculate the magnitude of the raw acceleration vector (g-force).
+  data.gForce = calculateGForce(data);
+
+  if(offsets != nullptr) {
+    applyMotionOffsets(*offsets, data);
+  }
+
+  uint32_t i_filter_cycles = MOTION_PIPELINE_CYCLES();
+
+  if(banks != nullptr) {
+    // Filter the readings separately for the fusion, for display and for the shake thresholds.
+    applyMotionFilters(banks->ahrs, data, banks->ahrsData, f_interval);
+    applyMotionFilters(banks->display, data, filtered, f_interval);
+    applyMotionFilters(banks->shake, data, banks->shakeData, f_interval);
+  }
+  else {
+    // Apply exponential moving average (EMA) smoothing filter to sensor data.
+    updateFilteredMotionData(data, filtered, f_alpha);
+  }
+
+  i_filter_cycles = MOTION_PIPELINE_CYCLES() - i_filter_cycles;
+
+  // Update the orientation via sensor fusion.
+  updateOrientation(fusion, banks != nullptr ? banks->ahrsData : data, f_interval, spatial);
+
+  // Calculate the magnitude of the filtered angular velocity vector (deg/s).
+  filtered.angVel = calculateAngularVelocity(filtered);
+
+  // Calculate the magnitude of the filtered acceleration vector (g-force).
+  filtered.gForce = calculateGForce(filtered);
+
+  // Check for shake events which use our calculated values.
+  if(banks != nullptr) {
+    banks->shakeData.angVel = calculateAngularVelocity(banks->shakeData);
+    banks->shakeData.gForce = calculateGForce(banks->shakeData);
+    filtered.shaken = detectShakeEvent(banks->shakeData);
+  }
+  else {
+    filtered.shaken = detectShakeEvent(filtered);
+  }
+
+  return i_filter_cycles;
+}
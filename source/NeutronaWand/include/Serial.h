@@ -216,6 +216,17 @@ bool isExcludedCommand(uint8_t i_command) {
          i_command == W_SEND_PREFERENCES_SMOKE;
 }
 
+// When the pack has told us it may light sleep, its UART RX pin is only a wake source and the first byte we send is lost.
+// Send a single throwaway byte (ignored by SerialTransfer, which waits for its start byte) and give the pack time to resume.
+// The pack stays awake for a short time after any byte it receives, so packets sent close together need no wake byte.
+void wakePackForSend() {
+  if(b_pack_idle_sleep && millis() - i_pack_last_send >= i_pack_listen_time) {
+    PackSerial.write((uint8_t) 0x00);
+    PackSerial.flush();
+    delay(3);
+  }
+}
+
 // Outgoing commands to the pack.
 void wandSerialSend(uint8_t i_command, uint16_t i_value) {
   uint16_t i_send_size = 0;
@@ -246,7 +257,9 @@ void wandSerialSend(uint8_t i_command, uint16_t i_value) {
   }
 
   i_send_size = packComs.txObj(sendCmd);
+  wakePackForSend();
   packComs.sendData(i_send_size, (uint8_t) PACKET_COMMAND);
+  i_pack_last_send = millis();
 }
 // Override function to handle calls with a single parameter.
 void wandSerialSend(uint8_t i_command) {
@@ -283,7 +296,9 @@ void wandSerialSendData(uint8_t i_message) {
     case W_SEND_PREFERENCES_WAND:
       getWandPrefsObject(); // Call common function (also used by local web UI)
       i_send_size = packComs.txObj(wandConfig);
+      wakePackForSend();
       packComs.sendData(i_send_size, (uint8_t) PACKET_WAND);
+      i_pack_last_send = millis();
     break;
 
     case W_SEND_PREFERENCES_SMOKE:
@@ -302,7 +317,9 @@ void wandSerialSendData(uint8_t i_message) {
       smokeConfig.overheatDelay1 = (uint8_t)(i_ms_overheat_initiate_level_1 / 1000);
 
       i_send_size = packComs.txObj(smokeConfig);
+      wakePackForSend();
       packComs.sendData(i_send_size, (uint8_t) PACKET_SMOKE);
+      i_pack_last_send = millis();
     break;
 
     default:
@@ -835,6 +852,9 @@ bool handlePackCommand(uint8_t i_command, uint16_t i_value) {
     case P_SYNC_START:
       sendDebug(F("Pack Sync Start"));
 
+      // A pack that is starting a sync is awake and has forgotten any idle sleep notice.
+      b_pack_idle_sleep = false;
+
       if(i_value == 1) {
         // Pack is currently performing a POST sequence, so set that variable to delay our control loop.
         b_pack_post_finish = false;
@@ -902,6 +922,12 @@ bool handlePackCommand(uint8_t i_command, uint16_t i_value) {
       }
     break;
 
+    case P_IDLE_SLEEP:
+      // The pack will light sleep between our messages (2) or has stopped doing so (1); acknowledge either way.
+      b_pack_idle_sleep = (i_value == 2);
+      wandSerialSend(W_IDLE_SLEEP, i_value);
+    break;
+
     case P_CANCEL_LOCKOUT:
       // Pack just said we need to cancel the lockout if applicable.
       if(b_wand_mash_lockout) {
@@ -402,11 +402,11 @@ void wandTipOff() {
     case LEDS_48:
       if(WAND_BARREL_LED_COUNT == LEDS_48) {
         // Set the tip of the GPStar Neutrona Barrel LED array to black.
-        barrel_leds[12] = getHueColour(C_BLACK, WAND_BARREL_LED_COUNT);
+        barrel_leds[12] = getBarrelColour(C_BLACK);
       }
       else if(WAND_BARREL_LED_COUNT == LEDS_50) {
-        barrel_leds[36] = getHueColour(C_BLACK, WAND_BARREL_LED_COUNT);
-        barrel_leds[37] = getHueColour(C_BLACK, WAND_BARREL_LED_COUNT);
+        barrel_leds[36] = getBarrelColour(C_BLACK);
+        barrel_leds[37] = getBarrelColour(C_BLACK);
       }
 
       // Turn off the wand barrel tip LED.
@@ -793,36 +793,39 @@ void vibrationSetting() {
   }
 }
 
-// This function handles returning all bargraph lookup table values.
-uint8_t bargraphLookupTable(uint8_t index) {
+// Keeps the 28/30 segment bargraph element mapping in step with the bargraph type and orientation.
+void updateBargraphLayout() {
+  BargraphLayout layout = BARGRAPH_LAYOUT_NONE;
+
   if(BARGRAPH_TYPE == SEGMENTS_28) {
-    if(b_bargraph_invert) {
-      return PROGMEM_READU8(i_bargraph_invert[index]);
-    }
-    else {
-      return PROGMEM_READU8(i_bargraph_normal[index]);
-    }
+    layout = BARGRAPH_LAYOUT_28;
   }
   else if(BARGRAPH_TYPE == SEGMENTS_30) {
-    if(b_bargraph_invert) {
-      return PROGMEM_READU8(i_bargraph_wamco_invert[index]);
-    }
-    else {
-      return PROGMEM_READU8(i_bargraph_wamco_normal[index]);
-    }
+    layout = BARGRAPH_LAYOUT_30;
+  }
+
+  if(layout != ht_bargraph.getLayout() || b_bargraph_invert != b_bargraph_layout_inverted) {
+    // Elements drawn with the previous mapping would now be in the wrong place.
+    ht_bargraph.setLayout(layout, b_bargraph_invert);
+    ht_bargraph.clearAll();
+    b_bargraph_layout_inverted = b_bargraph_invert;
+  }
+}
+
+// This function handles returning the pin for each element of the 5 LED bargraph.
+// Elements of the 28/30 segment bargraph are mapped by ht_bargraph itself.
+uint8_t bargraphLookupTable(uint8_t index) {
+#ifndef ESP32
+  if(b_bargraph_invert) {
+    return PROGMEM_READU8(i_bargraph_5_led_invert[index]);
   }
   else {
-  #ifndef ESP32
-    if(b_bargraph_invert) {
-      return PROGMEM_READU8(i_bargraph_5_led_invert[index]);
-    }
-    else {
-      return PROGMEM_READU8(i_bargraph_5_led_normal[index]);
-    }
-  #else
-    return 0; // Return 0 if in error.
-  #endif
+    return PROGMEM_READU8(i_bargraph_5_led_normal[index]);
   }
+#else
+  (void)(index);
+  return 0; // Return 0 if in error.
+#endif
 }
 
 void bargraphClearAlt() {
@@ -906,7 +909,7 @@ void bargraphRamp() {
 
     switch(i_bargraph_status_alt) {
       case 0 ... 27:
-        ht_bargraph.setLedNow(bargraphLookupTable(i_bargraph_status_alt));
+        ht_bargraph.setElement(i_bargraph_status_alt);
         i_bargraph_status_alt++;
 
         if(i_bargraph_status_alt == 28) {
@@ -928,7 +931,7 @@ void bargraphRamp() {
         i_tmp = (i_bargraph_segments - 2) - i_tmp;
 
         if(WAND_ACTION_STATUS == ACTION_OVERHEATING || b_pack_alarm) {
-          ht_bargraph.clearLedNow(bargraphLookupTable(i_tmp));
+          ht_bargraph.clearElement(i_tmp);
 
           if(i_bargraph_status_alt == 55) {
             ms_bargraph.stop();
@@ -942,7 +945,7 @@ void bargraphRamp() {
         }
         else {
           if((gpstarWand.getPowerLevel() < MAX_POWER_LEVEL && BARGRAPH_MODE == BARGRAPH_ORIGINAL) || BARGRAPH_MODE == BARGRAPH_SUPER_HERO) {
-            ht_bargraph.clearLedNow(bargraphLookupTable(i_tmp));
+            ht_bargraph.clearElement(i_tmp);
           }
 
           switch(BARGRAPH_MODE) {
@@ -1074,7 +1077,7 @@ void bargraphRamp() {
 
     switch(i_bargraph_status_alt) {
       case 0 ... 29:
-        ht_bargraph.setLedNow(bargraphLookupTable(i_bargraph_status_alt));
+        ht_bargraph.setElement(i_bargraph_status_alt);
         i_bargraph_status_alt++;
 
         if(i_bargraph_status_alt == 30) {
@@ -1096,7 +1099,7 @@ void bargraphRamp() {
         i_tmp = i_bargraph_segments - i_tmp;
 
         if(WAND_ACTION_STATUS == ACTION_OVERHEATING || b_pack_alarm) {
-            ht_bargraph.clearLedNow(bargraphLookupTable(i_tmp));
+            ht_bargraph.clearElement(i_tmp);
 
             if(i_bargraph_status_alt == 59) {
               ms_bargraph.stop();
@@ -1110,7 +1113,7 @@ void bargraphRamp() {
         }
         else {
           if((gpstarWand.getPowerLevel() < MAX_POWER_LEVEL && BARGRAPH_MODE == BARGRAPH_ORIGINAL) || BARGRAPH_MODE == BARGRAPH_SUPER_HERO) {
-            ht_bargraph.clearLedNow(bargraphLookupTable(i_tmp));
+            ht_bargraph.clearElement(i_tmp);
           }
 
           switch(BARGRAPH_MODE) {
@@ -1904,24 +1907,22 @@ void bargraphRedraw() {
       case LEVEL_1 ... LEVEL_4:
         for(uint8_t i = 0; i < i_bargraph_segments - i_segment_adjust; i++) {
           if(i <= bargraphPowerLookupTable((uint8_t)gpstarWand.getPowerLevel())) {
-            ht_bargraph.setLed(bargraphLookupTable(i));
+            ht_bargraph.setElement(i);
           }
           else {
-            ht_bargraph.clearLed(bargraphLookupTable(i));
+            ht_bargraph.clearElement(i);
           }
         }
 
-        ht_bargraph.sendLed(); // Commit the changes.
         i_bargraph_status_alt = bargraphPowerLookupTable((uint8_t)gpstarWand.getPowerLevel());
       break;
 
       case LEVEL_5:
       default:
         for(uint8_t i = 0; i < i_bargraph_segments - i_segment_adjust; i++) {
-          ht_bargraph.setLed(bargraphLookupTable(i));
+          ht_bargraph.setElement(i);
         }
 
-        ht_bargraph.sendLed(); // Commit the changes.
         i_bargraph_status_alt = i_bargraph_segments - i_segment_adjust;
       break;
     }
@@ -1974,116 +1975,8 @@ void bargraphPowerCheck() {
   */
 
   if(BARGRAPH_TYPE == SEGMENTS_28 || BARGRAPH_TYPE == SEGMENTS_30) {
-    if(ms_bargraph_alt.justFinished()) {
-      uint8_t i_segment_adjust = 2;
-
-      if(BARGRAPH_TYPE == SEGMENTS_30) {
-        i_segment_adjust = 0;
-      }
-
-      uint8_t i_bargraph_multiplier[5] = { 7, 6, 5, 4, 3 };
-
-      if(BARGRAPH_MODE == BARGRAPH_ORIGINAL) {
-        for(uint8_t i = 0; i <= 4; i++) {
-          i_bargraph_multiplier[i] = 10;
-        }
-      }
-
-      if(b_bargraph_up) {
-        if(i_bargraph_status_alt < i_bargraph_segments - i_segment_adjust) {
-          ht_bargraph.setLedNow(bargraphLookupTable(i_bargraph_status_alt));
-        }
-
-        switch(gpstarWand.getPowerLevel()) {
-          case LEVEL_1 ... LEVEL_4:
-            if(i_bargraph_status_alt > bargraphPowerLookupTable((uint8_t)gpstarWand.getPowerLevel()) - 1) {
-              b_bargraph_up = false;
-
-              if(BARGRAPH_MODE == BARGRAPH_ORIGINAL) {
-                // We stop when we reach our target.
-                ms_bargraph_alt.stop();
-              }
-              else {
-                // A little pause when we reach the top.
-                ms_bargraph_alt.start(i_bargraph_wait / 2);
-              }
-            }
-            else {
-              ms_bargraph_alt.start(i_bargraph_interval * i_bargraph_multiplier[(uint8_t)gpstarWand.getPowerLevel() - 1]);
-            }
-          break;
-
-          case LEVEL_5:
-          default:
-            if(i_bargraph_status_alt > i_bargraph_segments - i_segment_adjust) {
-              b_bargraph_up = false;
-
-              i_bargraph_status_alt = i_bargraph_segments - i_segment_adjust;
-
-              if(BARGRAPH_MODE == BARGRAPH_ORIGINAL) {
-                // We stop when we reach our target.
-                ms_bargraph_alt.stop();
-              }
-              else {
-                // A little pause when we reach the top.
-                ms_bargraph_alt.start(i_bargraph_wait / 2);
-              }
-            }
-            else {
-              ms_bargraph_alt.start(i_bargraph_interval * i_bargraph_multiplier[(uint8_t)gpstarWand.getPowerLevel() - 1]);
-            }
-          break;
-        }
-
-        if(b_bargraph_up) {
-          i_bargraph_status_alt++;
-        }
-      }
-      else {
-        if(i_bargraph_status_alt < i_bargraph_segments - i_segment_adjust) {
-          ht_bargraph.clearLedNow(bargraphLookupTable(i_bargraph_status_alt));
-        }
-
-        if(i_bargraph_status_alt == 0) {
-          b_bargraph_up = true;
-
-          // A little pause when we reach the bottom.
-          ms_bargraph_alt.start(i_bargraph_wait / 2);
-        }
-        else {
-          i_bargraph_status_alt--;
-
-          uint8_t i_bargraph_power_lookup_adjust = 1;
-
-          if(BARGRAPH_TYPE == SEGMENTS_30) {
-            i_bargraph_power_lookup_adjust = 0;
-          }
-
-          switch(gpstarWand.getPowerLevel()) {
-            case LEVEL_1 ... LEVEL_4:
-              if(BARGRAPH_MODE == BARGRAPH_ORIGINAL && i_bargraph_status_alt < bargraphPowerLookupTable((uint8_t)gpstarWand.getPowerLevel()) + i_bargraph_power_lookup_adjust) {
-                // We stop when we reach our target.
-                ms_bargraph_alt.stop();
-              }
-              else {
-                ms_bargraph_alt.start(i_bargraph_interval * i_bargraph_multiplier[(uint8_t)gpstarWand.getPowerLevel() - 1]);
-              }
-            break;
-
-            case LEVEL_5:
-            default:
-              if(BARGRAPH_MODE == BARGRAPH_ORIGINAL && i_bargraph_status_alt < i_bargraph_segments - i_segment_adjust) {
-                // We stop when we reach our target.
-                ms_bargraph_alt.stop();
-              }
-              else {
-                ms_bargraph_alt.start(i_bargraph_interval * i_bargraph_multiplier[(uint8_t)gpstarWand.getPowerLevel() - 1]);
-              }
-            break;
-          }
-        }
-      }
-    }
+    // The turn and stop positions and step times for each power level are in the PROGMEM sweep tables.
+    bargraphPowerSweepUpdate(ms_bargraph_alt, ht_bargraph, (uint8_t)gpstarWand.getPowerLevel(), BARGRAPH_MODE == BARGRAPH_ORIGINAL, i_bargraph_status_alt, b_bargraph_up, i_bargraph_interval, i_bargraph_wait);
   }
   else {
     // Stock haslab bargraph control.
@@ -2125,28 +2018,7 @@ void bargraphPowerCheck2021Alt(bool b_override) {
         b_bargraph_up = false;
       }
 
-      switch(gpstarWand.getPowerLevel()) {
-        case LEVEL_5:
-        default:
-          ms_bargraph_alt.start(i_bargraph_wait / 3);
-        break;
-
-        case LEVEL_4:
-          ms_bargraph_alt.start(i_bargraph_wait / 4);
-        break;
-
-        case LEVEL_3:
-          ms_bargraph_alt.start(i_bargraph_wait / 5);
-        break;
-
-        case LEVEL_2:
-          ms_bargraph_alt.start(i_bargraph_wait / 6);
-        break;
-
-        case LEVEL_1:
-          ms_bargraph_alt.start(i_bargraph_wait / 7);
-        break;
-      }
+      ms_bargraph_alt.start(bargraphPowerSweepStartTime((uint8_t)gpstarWand.getPowerLevel(), i_bargraph_wait));
     }
   }
 }
@@ -2161,10 +2033,8 @@ void bargraphFull() {
     }
 
     for(uint8_t i = 0; i < i_bargraph_segments - i_segment_adjust; i++) {
-      ht_bargraph.setLed(bargraphLookupTable(i));
+      ht_bargraph.setElement(i);
     }
-
-    ht_bargraph.sendLed(); // Commit the changes.
   }
   else {
     wandBargraphControl(5);
@@ -2471,6 +2341,7 @@ void modeFireStop() {
   b_firing_alt = false;
 
   ms_bargraph_firing.stop();
+  bargraph_player.stop();
 
   ms_bargraph_alt.stop(); // Stop the 1984 28 segment optional bargraph timer.
   b_bargraph_up = false;
@@ -2671,31 +2542,27 @@ void settingsBlinkingLights() {
       if(b_solid_five) {
         for(uint8_t i = 0; i < i_bargraph_segments - i_segment_adjust; i++) {
           if(i > 0 && ((b_solid_one && i < i_bottom_segment_rows) || i >= i_top_segment_rows)) {
-            ht_bargraph.setLed(bargraphLookupTable(i));
+            ht_bargraph.setElement(i);
           }
           else {
-            ht_bargraph.clearLed(bargraphLookupTable(i));
+            ht_bargraph.clearElement(i);
           }
         }
 
         if(BARGRAPH_TYPE == SEGMENTS_30) {
           // On the 30-segment bargraph the last segment is always off.
-          ht_bargraph.clearLed(bargraphLookupTable(i_bargraph_segments - 1));
+          ht_bargraph.clearElement(i_bargraph_segments - 1);
         }
-
-        ht_bargraph.sendLed(); // Commit the changes.
       }
       else if(b_solid_one) {
         for(uint8_t i = 0; i < i_bargraph_segments - i_segment_adjust; i++) {
           if(i > 0 && i < i_bottom_segment_rows) {
-            ht_bargraph.setLed(bargraphLookupTable(i));
+            ht_bargraph.setElement(i);
           }
           else {
-            ht_bargraph.clearLed(bargraphLookupTable(i));
+            ht_bargraph.clearElement(i);
           }
         }
-
-        ht_bargraph.sendLed(); // Commit the changes.
       }
       else {
         ht_bargraph.clearAll();
@@ -2723,214 +2590,19 @@ void settingsBlinkingLights() {
     }
   #endif
   }
-  else {
-    switch(i_wand_menu) {
-      case 5:
-        if(BARGRAPH_TYPE == SEGMENTS_28 || BARGRAPH_TYPE == SEGMENTS_30) {
-          if(BARGRAPH_TYPE == SEGMENTS_30) {
-            for(uint8_t i = 1; i < i_bargraph_segments - i_segment_adjust; i++) {
-              switch(i) {
-                case 5:
-                case 6:
-                case 11:
-                case 12:
-                case 17:
-                case 18:
-                case 23:
-                case 24:
-                case 29:
-                  // Nothing
-                break;
-
-                default:
-                  ht_bargraph.setLed(bargraphLookupTable(i));
-                break;
-              }
-            }
-          }
-          else {
-            for(uint8_t i = 1; i < i_bargraph_segments - i_segment_adjust; i++) {
-              switch(i) {
-                case 4:
-                case 5:
-                case 6:
-                case 10:
-                case 11:
-                case 12:
-                case 16:
-                case 17:
-                case 18:
-                case 22:
-                case 23:
-                case 24:
-                  // Nothing
-                break;
-
-                default:
-                  ht_bargraph.setLed(bargraphLookupTable(i));
-                break;
-              }
-            }
-          }
-
-          ht_bargraph.sendLed(); // Commit the changes.
-        }
-        else {
-          wandBargraphControl(5);
-        }
-      break;
-
-      case 4:
-        if(BARGRAPH_TYPE == SEGMENTS_28 || BARGRAPH_TYPE == SEGMENTS_30) {
-          if(BARGRAPH_TYPE == SEGMENTS_30) {
-            for(uint8_t i = 1; i < 23; i++) {
-              switch(i) {
-                case 5:
-                case 6:
-                case 11:
-                case 12:
-                case 17:
-                case 18:
-                  // Nothing
-                break;
-
-                default:
-                  ht_bargraph.setLed(bargraphLookupTable(i));
-                break;
-              }
-            }
-          }
-          else {
-            for(uint8_t i = 1; i < 22; i++) {
-              switch(i) {
-                case 4:
-                case 5:
-                case 6:
-                case 10:
-                case 11:
-                case 12:
-                case 16:
-                case 17:
-                case 18:
-                  // Nothing
-                break;
-
-                default:
-                  ht_bargraph.setLed(bargraphLookupTable(i));
-                break;
-              }
-            }
-          }
-
-          ht_bargraph.sendLed(); // Commit the changes.
-        }
-        else {
-          wandBargraphControl(4);
-        }
-      break;
-
-      case 3:
-        if(BARGRAPH_TYPE == SEGMENTS_28 || BARGRAPH_TYPE == SEGMENTS_30) {
-          if(BARGRAPH_TYPE == SEGMENTS_30) {
-            for(uint8_t i = 1; i < 17; i++) {
-              switch(i) {
-                case 5:
-                case 6:
-                case 11:
-                case 12:
-                  // Nothing
-                break;
-
-                default:
-                  ht_bargraph.setLed(bargraphLookupTable(i));
-                break;
-              }
-            }
-          }
-          else {
-            for(uint8_t i = 1; i < 16; i++) {
-              switch(i) {
-                case 4:
-                case 5:
-                case 6:
-                case 10:
-                case 11:
-                case 12:
-                  // Nothing
-                break;
-
-                default:
-                  ht_bargraph.setLed(bargraphLookupTable(i));
-                break;
-              }
-            }
-          }
-
-          ht_bargraph.sendLed(); // Commit the changes.
-        }
-        else {
-          wandBargraphControl(3);
-        }
-      break;
-
-      case 2:
-        if(BARGRAPH_TYPE == SEGMENTS_28 || BARGRAPH_TYPE == SEGMENTS_30) {
-          if(BARGRAPH_TYPE == SEGMENTS_30) {
-            for(uint8_t i = 1; i < 11; i++) {
-              switch(i) {
-                case 5:
-                case 6:
-                  // Nothing
-                break;
-
-                default:
-                  ht_bargraph.setLed(bargraphLookupTable(i));
-                break;
-              }
-            }
-          }
-          else {
-            for(uint8_t i = 1; i < 10; i++) {
-              switch(i) {
-                case 4:
-                case 5:
-                case 6:
-                  // Nothing
-                break;
-
-                default:
-                  ht_bargraph.setLed(bargraphLookupTable(i));
-                break;
-              }
-            }
-          }
-
-          ht_bargraph.sendLed(); // Commit the changes.
-        }
-        else {
-          wandBargraphControl(2);
-        }
-      break;
-
-      case 1:
-        if(BARGRAPH_TYPE == SEGMENTS_28 || BARGRAPH_TYPE == SEGMENTS_30) {
-          if(BARGRAPH_TYPE == SEGMENTS_30) {
-            for(uint8_t i = 1; i < 5; i++) {
-              ht_bargraph.setLed(bargraphLookupTable(i));
-            }
-          }
-          else {
-            for(uint8_t i = 1; i < 4; i++) {
-              ht_bargraph.setLed(bargraphLookupTable(i));
-            }
-          }
+  else if(i_wand_menu >= 1 && i_wand_menu <= MENU_TREE_ITEMS) {
+    // Show which menu item we are on.
+    if(BARGRAPH_TYPE == SEGMENTS_28 || BARGRAPH_TYPE == SEGMENTS_30) {
+      uint32_t i_segments = menuTreeBargraphItem(i_wand_menu, BARGRAPH_TYPE == SEGMENTS_30 ? 30 : 28);
 
-          ht_bargraph.sendLed(); // Commit the changes.
-        }
-        else {
-          wandBargraphControl(1);
+      for(uint8_t i = 1; i < i_bargraph_segments; i++) {
+        if((i_segments >> i) & 0x01) {
+          ht_bargraph.setElement(i);
         }
-      break;
+      }
+    }
+    else {
+      wandBargraphControl(i_wand_menu);
     }
   }
 }
@@ -3112,29 +2784,28 @@ void setPowerOnReminder(bool enable) {
   }
 }
 
-void wandBarrelLightsOff() {
-  for(uint8_t i = 0; i < i_num_barrel_leds; i++) {
-    switch(WAND_BARREL_LED_COUNT) {
-      case LEDS_50:
-        // Turn off the entire GPStar Neutrona Barrel array.
-        barrel_leds[PROGMEM_READU8(gpstar_neutrona_barrel[i])] = getHueColour(C_BLACK, WAND_BARREL_LED_COUNT);
-      break;
+// The barrel LEDs in firing order, for the barrel effects.
+BarrelStrip getBarrelStrip() {
+  switch(WAND_BARREL_LED_COUNT) {
+    case LEDS_50:
+      return BarrelStrip(barrel_leds[0].raw, i_num_barrel_leds, gpstar_neutrona_barrel, sizeof(gpstar_neutrona_barrel));
 
-      case LEDS_48:
-        // Turn off the entire Frutto LED array.
-        barrel_leds[PROGMEM_READU8(frutto_barrel[i])] = getHueColour(C_BLACK, WAND_BARREL_LED_COUNT);
-      break;
+    case LEDS_48:
+      return BarrelStrip(barrel_leds[0].raw, i_num_barrel_leds, frutto_barrel, sizeof(frutto_barrel));
 
-      case LEDS_5:
-      case LEDS_2:
-      default:
-        // Turn off the entire Hasbro LED and GPStar Barrel LED Mini array.
-        barrel_leds[i] = getHueColour(C_BLACK, WAND_BARREL_LED_COUNT);
-      break;
-    }
+    case LEDS_5:
+    case LEDS_2:
+    default:
+      return BarrelStrip(barrel_leds[0].raw, i_num_barrel_leds);
   }
 }
 
+void wandBarrelLightsOff() {
+  // Turn off the entire barrel array.
+  BarrelStrip strip = getBarrelStrip();
+  strip.fill(0, strip.getCount(), barrel_palette.get(C_BLACK));
+}
+
 void barrelLightsOff() {
   ms_firing_pulse.stop();
   ms_firing_lights.stop();
@@ -3144,6 +2815,7 @@ void barrelLightsOff() {
   ms_wand_heatup_fade.stop();
   i_barrel_light = 0;
   i_pulse_step = 0;
+  barrel_pulse.stop();
   i_heatup_counter = 0;
   i_heatdown_counter = 100;
 
@@ -4299,2685 +3971,381 @@ void modeFireStartSounds() {
   }
 }
 
+#ifndef ESP32
+// Lights or clears one LED of the Hasbro 5 LED bargraph, for animations drawn from a frame table.
+void bargraph5LedWrite(uint8_t i_element, bool b_on) {
+  digitalWriteFast(bargraphLookupTable(i_element), b_on ? LOW : HIGH);
+}
+#endif
+
 // This is the Super Hero bargraph firing animation. Ramping up and down from the middle to the top/bottom and back to the middle again.
 void bargraphSuperHeroRampFiringAnimation() {
-  if(BARGRAPH_TYPE == SEGMENTS_28 || BARGRAPH_TYPE == SEGMENTS_30) {
-    if(BARGRAPH_TYPE == SEGMENTS_30) {
-      switch(i_bargraph_status_alt) {
-        case 0:
-          ht_bargraph.setLed(bargraphLookupTable(14));
-          ht_bargraph.setLed(bargraphLookupTable(15));
-
-          i_bargraph_status_alt++;
-
-          if(!b_bargraph_up) {
-            ht_bargraph.clearLed(bargraphLookupTable(13));
-            ht_bargraph.clearLed(bargraphLookupTable(16));
-          }
-
-          b_bargraph_up = true;
-
-          ht_bargraph.sendLed(); // Commit the changes.
-          wandTipOn();
-        break;
+  // The frames come from PROGMEM; each call from the ms_bargraph_firing timer moves one frame, so the ramp interval sets the speed.
+  bargraph_player.advance(bargraphSuperHeroSequence(BARGRAPH_TYPE));
 
-        case 1:
-          ht_bargraph.setLed(bargraphLookupTable(13));
-          ht_bargraph.setLed(bargraphLookupTable(16));
-
-          if(b_bargraph_up) {
-            ht_bargraph.clearLed(bargraphLookupTable(14));
-            ht_bargraph.clearLed(bargraphLookupTable(15));
+  if(BARGRAPH_TYPE == SEGMENTS_28 || BARGRAPH_TYPE == SEGMENTS_30) {
+    bargraph_player.draw(ht_bargraph, ht_bargraph.getElementCount());
+  }
+#ifndef ESP32
+  else {
+    // Hasbro 5 LED Bargraph.
+    bargraph_player.draw(bargraph5LedWrite, i_bargraph_segments_5_led);
+  }
+#endif
 
-            i_bargraph_status_alt++;
-          }
-          else {
-            ht_bargraph.clearLed(bargraphLookupTable(12));
-            ht_bargraph.clearLed(bargraphLookupTable(17));
+  if(bargraph_player.getFlags() & BARGRAPH_FRAME_TIP) {
+    wandTipOn();
+  }
+  else {
+    wandTipOff();
+  }
+}
 
-            i_bargraph_status_alt--;
-          }
+// This is the Mode Original bargraph firing animation. The top portion fluctuates during firing and becomes more erratic the longer firing continues.
+void bargraphModeOriginalRampFiringAnimation() {
+  if(BARGRAPH_TYPE == SEGMENTS_28 || BARGRAPH_TYPE == SEGMENTS_30) {
+    /*
+      // For 28 Segments
+      Power Level 5: full: 23 - 27  (5 segments)
+      Power Level 4: 3/4: 17 - 22   (6 segments)
+      Power Level 3: 1/2: 12 - 16   (5 segments)
+      Power Level 2: 1/4: 5 - 11    (7 segments)
+      Power Level 1: none: 0 - 4    (5 segments)
+    */
 
-          ht_bargraph.sendLed(); // Commit the changes.
-          wandTipOn();
-        break;
+    /*
+      // 30 Segment bargraph.
+      Power Level 5: full: 24 - 29  (6 segments)
+      Power Level 4: 3/4: 18 - 23   (6 segments)
+      Power Level 3: 1/2: 12 - 17   (6 segments)
+      Power Level 2: 1/4: 6 - 11    (6 segments)
+      Power Level 1: none: 0 - 5    (6 segments)
+    */
 
-        case 2:
-          ht_bargraph.setLed(bargraphLookupTable(12));
-          ht_bargraph.setLed(bargraphLookupTable(17));
+    // The target ranges for each power level and cyclotron multiplier are in the PROGMEM walk table.
+    // When firing starts, i_bargraph_status_alt resets to 0 in modeFireStart();
+    bargraphOriginalWalkStep(ht_bargraph, (uint8_t)gpstarWand.getPowerLevel(), i_cyclotron_multiplier, i_bargraph_status_alt, random);
+  }
+  else {
+    // The target ranges for the 5 LED bargraph, which can only show a fill from the bottom, are in the PROGMEM walk table too.
+    // When firing starts, i_bargraph_status resets to 0 in modeFireStart();
+    uint32_t i_lit = 0;
 
-          if(b_bargraph_up) {
-            ht_bargraph.clearLed(bargraphLookupTable(13));
-            ht_bargraph.clearLed(bargraphLookupTable(16));
+    for(uint8_t i = 0; i < i_bargraph_segments_5_led; i++) {
+      if(digitalReadFast(bargraphLookupTable(i)) == LOW) {
+        i_lit |= (uint32_t)1 << i;
+      }
+    }
 
-            i_bargraph_status_alt++;
-          }
-          else {
-            ht_bargraph.clearLed(bargraphLookupTable(11));
-            ht_bargraph.clearLed(bargraphLookupTable(18));
+    uint8_t i_fill = bargraphOriginalFillStep(i_lit, (uint8_t)gpstarWand.getPowerLevel(), i_cyclotron_multiplier, i_bargraph_status, random);
 
-            i_bargraph_status_alt--;
-          }
+    if(i_fill != BARGRAPH_WALK_END) {
+      wandBargraphControl(i_fill);
+    }
+  }
+}
+
+void cyclotronSpeedUp(uint8_t i_switch) {
+  if(i_switch != i_cyclotron_multiplier && i_cyclotron_multiplier < 4) {
+    if(i_switch == 4) {
+      // Tell pack to start beeping before we overheat it.
+      wandSerialSend(W_BEEP_START);
 
-          ht_bargraph.sendLed(); // Commit the changes.
-          wandTipOn();
+      // Play overheat alert beeps before we overheat.
+      switch(getSystemYearMode()) {
+        case SYSTEM_AFTERLIFE:
+        case SYSTEM_FROZEN_EMPIRE:
+        default:
+          playEffect(S_PACK_BEEPS_OVERHEAT, true);
         break;
 
-        case 3:
-          ht_bargraph.setLed(bargraphLookupTable(11));
-          ht_bargraph.setLed(bargraphLookupTable(18));
+        case SYSTEM_1984:
+        case SYSTEM_1989:
+          playEffect(S_BEEP_8, true);
+        break;
+      }
 
-          if(b_bargraph_up) {
-            ht_bargraph.clearLed(bargraphLookupTable(12));
-            ht_bargraph.clearLed(bargraphLookupTable(17));
+      ms_warning_blink.start(i_warning_blink_delay);
+    }
 
-            i_bargraph_status_alt++;
-          }
-          else {
-            ht_bargraph.clearLed(bargraphLookupTable(10));
-            ht_bargraph.clearLed(bargraphLookupTable(19));
+    i_cyclotron_multiplier++;
 
-            i_bargraph_status_alt--;
-          }
+    // Tell the pack to speed up the Cyclotron.
+    wandSerialSend(W_CYCLOTRON_INCREASE_SPEED);
+  }
+}
 
-          ht_bargraph.sendLed(); // Commit the changes.
-          wandTipOff();
-        break;
+// Bargraph ramping during firing.
+// Optional barrel LED tip strobing is controlled from here to give it a ramp effect if the Proton Pack and Neutrona Wand are going to overheat.
+void bargraphRampFiring() {
+  switch(BARGRAPH_FIRING_ANIMATION) {
+    case BARGRAPH_ANIMATION_SUPER_HERO:
+      bargraphSuperHeroRampFiringAnimation();
+    break;
+    case BARGRAPH_ANIMATION_ORIGINAL:
+    default:
+      bargraphModeOriginalRampFiringAnimation();
 
-        case 4:
-          ht_bargraph.setLed(bargraphLookupTable(10));
-          ht_bargraph.setLed(bargraphLookupTable(19));
+      // Strobe the optional tip light on even barrel LED numbers.
+      if((i_barrel_light & 0x01) == 0) {
+        wandTipOn();
+      }
+      else {
+        wandTipOff();
+      }
+    break;
+  }
 
-          if(b_bargraph_up) {
-            ht_bargraph.clearLed(bargraphLookupTable(11));
-            ht_bargraph.clearLed(bargraphLookupTable(18));
+  // Step times by bargraph, animation, power level and how close an overheat is are in the PROGMEM timing tables.
+  // If in a power level on the wand that can overheat, the bargraph ramp speeds up as the time remaining before we overheat runs down.
+  uint8_t i_stage = bargraphFiringStage(ms_overheat_initiate.isRunning(), ms_overheat_initiate.remaining(), i_ms_overheat_initiate[(uint8_t)gpstarWand.getPowerLevel() - 1]);
 
-            i_bargraph_status_alt++;
-          }
-          else {
-            ht_bargraph.clearLed(bargraphLookupTable(9));
-            ht_bargraph.clearLed(bargraphLookupTable(20));
+  ms_bargraph_firing.start(bargraphFiringStepTime(bargraphFiringTiming(BARGRAPH_TYPE, BARGRAPH_FIRING_ANIMATION == BARGRAPH_ANIMATION_ORIGINAL), (uint8_t)gpstarWand.getPowerLevel(), i_stage));
 
-            i_bargraph_status_alt--;
-          }
+  if(i_stage > 1) {
+    cyclotronSpeedUp(i_stage);
+  }
+  else if(i_stage == 1) {
+    i_cyclotron_multiplier = 1;
+  }
+}
 
-          ht_bargraph.sendLed(); // Commit the changes.
-          wandTipOff();
-        break;
+void modeFireStart() {
+  i_fast_led_delay = FAST_LED_UPDATE_MS;
 
-        case 5:
-          ht_bargraph.setLed(bargraphLookupTable(9));
-          ht_bargraph.setLed(bargraphLookupTable(20));
+  // Pick up any change of barrel or custom colour.
+  barrel_palette.invalidate();
 
-          if(b_bargraph_up) {
-            ht_bargraph.clearLed(bargraphLookupTable(10));
-            ht_bargraph.clearLed(bargraphLookupTable(19));
+  modeFireStartSounds();
 
-            i_bargraph_status_alt++;
-          }
-          else {
-            ht_bargraph.clearLed(bargraphLookupTable(8));
-            ht_bargraph.clearLed(bargraphLookupTable(21));
+  // Tell the pack the wand is firing, and if in Intensify (1) or Alt (2) mode.
+  wandSerialSend(W_FIRING, b_firing_intensify ? 1 : 2);
 
-            i_bargraph_status_alt--;
-          }
+  // Just in case a semi-auto was fired before we started firing a stream, stop its timer.
+  ms_semi_automatic_firing.stop();
 
-          ht_bargraph.sendLed(); // Commit the changes.
-          wandTipOn();
-        break;
+  switch(BARGRAPH_FIRING_ANIMATION) {
+    case BARGRAPH_ANIMATION_ORIGINAL:
+      // Redraw the bargraph to the current power level before doing the MODE_ORIGINAL firing animation.
+      bargraphRedraw();
 
-        case 6:
-          ht_bargraph.setLed(bargraphLookupTable(8));
-          ht_bargraph.setLed(bargraphLookupTable(21));
+      // Reset the Hasbro bargraph.
+      i_bargraph_status = 0;
+    break;
 
-          if(b_bargraph_up) {
-            ht_bargraph.clearLed(bargraphLookupTable(9));
-            ht_bargraph.clearLed(bargraphLookupTable(20));
+    case BARGRAPH_ANIMATION_SUPER_HERO:
+    default:
+      // Clear the bargraph before we do the animation.
+      bargraphClearAlt();
 
-            i_bargraph_status_alt++;
-          }
-          else {
-            ht_bargraph.clearLed(bargraphLookupTable(7));
-            ht_bargraph.clearLed(bargraphLookupTable(22));
+      // Reset the Hasbro bargraph.
+      i_bargraph_status = 1;
+    break;
+  }
 
-            i_bargraph_status_alt--;
-          }
+  // Turn on hat light 1.
+  digitalWriteFast(BARREL_HAT_LED_PIN, HIGH);
 
-          ht_bargraph.sendLed(); // Commit the changes.
-          wandTipOn();
-        break;
+  // This will only overheat when enabled by using the alt firing when in crossing the streams mode.
+  bool b_overheat_flag = true;
 
-        case 7:
-          ht_bargraph.setLed(bargraphLookupTable(7));
-          ht_bargraph.setLed(bargraphLookupTable(22));
+  if(((gpstarWand.isFiringModeCTS() || gpstarWand.isFiringModeCTSMix()) && !b_firing_alt) || !b_overheat_enabled) {
+    b_overheat_flag = false;
+  }
 
-          if(b_bargraph_up) {
-            ht_bargraph.clearLed(bargraphLookupTable(8));
-            ht_bargraph.clearLed(bargraphLookupTable(21));
+  if(b_overheat_flag) {
+    // If in high power level on the wand, start an overheat timer.
+    if(b_overheat_level[(uint8_t)gpstarWand.getPowerLevel() - 1]) {
+      ms_overheat_initiate.start(i_ms_overheat_initiate[(uint8_t)gpstarWand.getPowerLevel() - 1]);
+    }
+  }
 
-            i_bargraph_status_alt++;
-          }
-          else {
-            ht_bargraph.clearLed(bargraphLookupTable(6));
-            ht_bargraph.clearLed(bargraphLookupTable(23));
+  barrelLightsOff();
 
-            i_bargraph_status_alt--;
-          }
+  if(gpstarWand.inStreamMode(MESON)) {
+    ms_firing_stream_effects.start(0);
+  }
+  else {
+    ms_firing_lights.start(0);
+  }
 
-          ht_bargraph.sendLed(); // Commit the changes.
-          wandTipOff();
-        break;
+  // Stop any bargraph ramps.
+  ms_bargraph.stop();
+  ms_bargraph_alt.stop();
 
-        case 8:
-          ht_bargraph.setLed(bargraphLookupTable(6));
-          ht_bargraph.setLed(bargraphLookupTable(23));
+  // Reset the 28 segment bargraph.
+  i_bargraph_status_alt = 0;
 
-          if(b_bargraph_up) {
-            ht_bargraph.clearLed(bargraphLookupTable(7));
-            ht_bargraph.clearLed(bargraphLookupTable(22));
+  b_bargraph_up = false;
 
-            i_bargraph_status_alt++;
-          }
-          else {
-            ht_bargraph.clearLed(bargraphLookupTable(5));
-            ht_bargraph.clearLed(bargraphLookupTable(24));
+  // Restart the Super Hero animation from its first frame.
+  bargraph_player.stop();
 
-            i_bargraph_status_alt--;
-          }
+  bargraphRampFiring();
 
-          ht_bargraph.sendLed(); // Commit the changes.
-          wandTipOff();
-        break;
+  if(gpstarWand.inStreamMode(PROTON) && b_stream_effects) {
+    ms_impact.start(random(10,16) * 1000);
 
-        case 9:
-          ht_bargraph.setLed(bargraphLookupTable(5));
-          ht_bargraph.setLed(bargraphLookupTable(24));
+    // Standalone wand plays additional SFX from Proton Pack.
+    if(b_wand_standalone) {
+      ms_firing_sound_mix.start(random(7,15) * 1000);
+    }
+  }
 
-          if(b_bargraph_up) {
-            ht_bargraph.clearLed(bargraphLookupTable(6));
-            ht_bargraph.clearLed(bargraphLookupTable(23));
+  ms_firing_length_timer.start(i_firing_timer_length);
 
-            i_bargraph_status_alt++;
-          }
-          else {
-            ht_bargraph.clearLed(bargraphLookupTable(4));
-            ht_bargraph.clearLed(bargraphLookupTable(25));
+  #ifdef ESP32
+  // Restart the infrared timer based on the current power level.
+  switch(gpstarWand.getPowerLevel()) {
+    case 1:
+      irManager->startTXTimer(ir_delay_power_1);
+    break;
+    case 2:
+      irManager->startTXTimer(ir_delay_power_2);
+    break;
+    case 3:
+      irManager->startTXTimer(ir_delay_power_3);
+    break;
+    case 4:
+      irManager->startTXTimer(ir_delay_power_4);
+    break;
+    case 5:
+    default:
+      irManager->startTXTimer(ir_delay_power_5);
+    break;
+  }
+  #endif
+}
 
-            i_bargraph_status_alt--;
-          }
+// The colour of the barrel behind the stream, which is the colour it has without the effect.
+colours getStreamTrailColour() {
+  switch(gpstarWand.getStreamMode()) {
+    case PROTON:
+    default:
+      if(b_firing_cross_streams) {
+        if(isBrassPack()) {
+          return C_CHARTREUSE;
+        }
+        else {
+          return C_WHITE;
+        }
+      }
+      else if(getSystemYearMode() == SYSTEM_1989) {
+        // Shift the stream from orange to red on higher power levels.
+        switch(gpstarWand.getPowerLevel()) {
+          case LEVEL_1:
+            return C_RED5;
+          case LEVEL_2:
+            return C_RED4;
+          case LEVEL_3:
+            return C_RED3;
+          case LEVEL_4:
+            return C_RED2;
+          case LEVEL_5:
+          default:
+            return C_RED;
+        }
+      }
+      else {
+        // Shift the stream from red to orange on higher power levels.
+        switch(gpstarWand.getPowerLevel()) {
+          case LEVEL_1:
+            return C_RED;
+          case LEVEL_2:
+            return C_RED2;
+          case LEVEL_3:
+            return C_RED3;
+          case LEVEL_4:
+            return C_RED4;
+          case LEVEL_5:
+          default:
+            return C_RED5;
+        }
+      }
 
-          ht_bargraph.sendLed(); // Commit the changes.
-          wandTipOn();
-        break;
+    case SLIME:
+      if(getSystemYearMode() == SYSTEM_1989) {
+        return C_PASTEL_PINK;
+      }
+      else {
+        return C_DARK_GREEN;
+      }
 
-        case 10:
-          ht_bargraph.setLed(bargraphLookupTable(4));
-          ht_bargraph.setLed(bargraphLookupTable(25));
+    case STASIS:
+      return C_BLUE;
 
-          if(b_bargraph_up) {
-            ht_bargraph.clearLed(bargraphLookupTable(5));
-            ht_bargraph.clearLed(bargraphLookupTable(24));
+    case MESON:
+    case SPECTRAL:
+    case HOLIDAY_HALLOWEEN:
+    case HOLIDAY_CHRISTMAS:
+      return C_BLACK;
 
-            i_bargraph_status_alt++;
-          }
-          else {
-            ht_bargraph.clearLed(bargraphLookupTable(3));
-            ht_bargraph.clearLed(bargraphLookupTable(26));
+    case SPECTRAL_CUSTOM:
+      return C_CUSTOM;
+  }
+}
 
-            i_bargraph_status_alt--;
-          }
+void fireStreamEffect(CRGB c_colour) {
+  if(!ms_firing_stream_effects.justFinished()) {
+    return;
+  }
 
-          ht_bargraph.sendLed(); // Commit the changes.
-          wandTipOn();
-        break;
+  // The GPStar and Frutto barrels draw a burst ahead of the stream which "wraps" around the device to appear to push the stream forward.
+  // Timings and burst sizes for each stream mode are in the parameter sets of the barrel effects.
+  const BarrelStreamParams* params = &BARREL_STREAM_DEFAULT;
+  bool b_stream_barrel = (WAND_BARREL_LED_COUNT == LEDS_48 || WAND_BARREL_LED_COUNT == LEDS_50);
 
-        case 11:
-          ht_bargraph.setLed(bargraphLookupTable(3));
-          ht_bargraph.setLed(bargraphLookupTable(26));
+  if(!b_stream_barrel) {
+    params = gpstarWand.inStreamMode(MESON) ? &BARREL_STREAM_HASBRO_MESON : &BARREL_STREAM_HASBRO;
+  }
+  else if(gpstarWand.inStreamMode(PROTON)) {
+    params = &BARREL_STREAM_PROTON;
+  }
+  else if(gpstarWand.inStreamMode(MESON)) {
+    params = &BARREL_STREAM_MESON;
+  }
+  else if(gpstarWand.inStreamMode(SLIME) && WAND_ACTION_STATUS != ACTION_FIRING) {
+    // Slime Tether response time is a fixed value.
+    params = &BARREL_STREAM_TETHER;
+  }
 
-          if(b_bargraph_up) {
-            ht_bargraph.clearLed(bargraphLookupTable(4));
-            ht_bargraph.clearLed(bargraphLookupTable(25));
+  BarrelStrip strip = getBarrelStrip();
+  BarrelColour c_head = {c_colour.r, c_colour.g, c_colour.b};
+  bool b_step = (i_barrel_light < strip.getCount());
 
-            i_bargraph_status_alt++;
-          }
-          else {
-            ht_bargraph.clearLed(bargraphLookupTable(2));
-            ht_bargraph.clearLed(bargraphLookupTable(27));
+  uint8_t i_next = barrelStreamStep(strip, params, gpstarWand.getPowerLevel(), i_barrel_light, c_head, barrel_palette.get(getStreamTrailColour()), random);
 
-            i_bargraph_status_alt--;
-          }
+  if(i_next != BARREL_STREAM_WAIT) {
+    ms_firing_stream_effects.start(i_next);
+  }
+  // Otherwise Meson waits; the animation is restarted by checkWandAction();
 
-          ht_bargraph.sendLed(); // Commit the changes.
-          wandTipOff();
-        break;
-
-        case 12:
-          ht_bargraph.setLed(bargraphLookupTable(2));
-          ht_bargraph.setLed(bargraphLookupTable(27));
-
-          if(b_bargraph_up) {
-            ht_bargraph.clearLed(bargraphLookupTable(3));
-            ht_bargraph.clearLed(bargraphLookupTable(26));
-
-            i_bargraph_status_alt++;
-          }
-          else {
-            ht_bargraph.clearLed(bargraphLookupTable(1));
-            ht_bargraph.clearLed(bargraphLookupTable(28));
-
-            i_bargraph_status_alt--;
-          }
-
-          ht_bargraph.sendLed(); // Commit the changes.
-          wandTipOff();
-        break;
-
-        case 13:
-          ht_bargraph.setLed(bargraphLookupTable(1));
-          ht_bargraph.setLed(bargraphLookupTable(28));
-
-          if(b_bargraph_up) {
-            ht_bargraph.clearLed(bargraphLookupTable(2));
-            ht_bargraph.clearLed(bargraphLookupTable(27));
-
-            i_bargraph_status_alt++;
-          }
-          else {
-            ht_bargraph.clearLed(bargraphLookupTable(0));
-            ht_bargraph.clearLed(bargraphLookupTable(29));
-
-            i_bargraph_status_alt--;
-          }
-
-          ht_bargraph.sendLed(); // Commit the changes.
-          wandTipOn();
-        break;
-
-        case 14:
-          ht_bargraph.setLed(bargraphLookupTable(0));
-          ht_bargraph.setLed(bargraphLookupTable(29));
-
-          ht_bargraph.clearLed(bargraphLookupTable(1));
-          ht_bargraph.clearLed(bargraphLookupTable(28));
-
-          i_bargraph_status_alt--;
-
-          b_bargraph_up = false;
-
-          ht_bargraph.sendLed(); // Commit the changes.
-          wandTipOn();
-        break;
-
-        default:
-          // We should not be here. Do nothing.
-        break;
-      }
-    }
-    else {
-      switch(i_bargraph_status_alt) {
-        case 0:
-          ht_bargraph.setLed(bargraphLookupTable(13));
-          ht_bargraph.setLed(bargraphLookupTable(14));
-
-          i_bargraph_status_alt++;
-
-          if(!b_bargraph_up) {
-            ht_bargraph.clearLed(bargraphLookupTable(12));
-            ht_bargraph.clearLed(bargraphLookupTable(15));
-          }
-
-          b_bargraph_up = true;
-
-          ht_bargraph.sendLed(); // Commit the changes.
-          wandTipOn();
-        break;
-
-        case 1:
-          ht_bargraph.setLed(bargraphLookupTable(12));
-          ht_bargraph.setLed(bargraphLookupTable(15));
-
-          if(b_bargraph_up) {
-            ht_bargraph.clearLed(bargraphLookupTable(13));
-            ht_bargraph.clearLed(bargraphLookupTable(14));
-
-            i_bargraph_status_alt++;
-          }
-          else {
-            ht_bargraph.clearLed(bargraphLookupTable(11));
-            ht_bargraph.clearLed(bargraphLookupTable(16));
-
-            i_bargraph_status_alt--;
-          }
-
-          ht_bargraph.sendLed(); // Commit the changes.
-          wandTipOn();
-        break;
-
-        case 2:
-          ht_bargraph.setLed(bargraphLookupTable(11));
-          ht_bargraph.setLed(bargraphLookupTable(16));
-
-          if(b_bargraph_up) {
-            ht_bargraph.clearLed(bargraphLookupTable(12));
-            ht_bargraph.clearLed(bargraphLookupTable(15));
-
-            i_bargraph_status_alt++;
-          }
-          else {
-            ht_bargraph.clearLed(bargraphLookupTable(10));
-            ht_bargraph.clearLed(bargraphLookupTable(17));
-
-            i_bargraph_status_alt--;
-          }
-
-          ht_bargraph.sendLed(); // Commit the changes.
-          wandTipOff();
-        break;
-
-        case 3:
-          ht_bargraph.setLed(bargraphLookupTable(10));
-          ht_bargraph.setLed(bargraphLookupTable(17));
-
-          if(b_bargraph_up) {
-            ht_bargraph.clearLed(bargraphLookupTable(11));
-            ht_bargraph.clearLed(bargraphLookupTable(16));
-
-            i_bargraph_status_alt++;
-          }
-          else {
-            ht_bargraph.clearLed(bargraphLookupTable(9));
-            ht_bargraph.clearLed(bargraphLookupTable(18));
-
-            i_bargraph_status_alt--;
-          }
-
-          ht_bargraph.sendLed(); // Commit the changes.
-          wandTipOff();
-        break;
-
-        case 4:
-          ht_bargraph.setLed(bargraphLookupTable(9));
-          ht_bargraph.setLed(bargraphLookupTable(18));
-
-          if(b_bargraph_up) {
-            ht_bargraph.clearLed(bargraphLookupTable(10));
-            ht_bargraph.clearLed(bargraphLookupTable(17));
-
-            i_bargraph_status_alt++;
-          }
-          else {
-            ht_bargraph.clearLed(bargraphLookupTable(8));
-            ht_bargraph.clearLed(bargraphLookupTable(19));
-
-            i_bargraph_status_alt--;
-          }
-
-          ht_bargraph.sendLed(); // Commit the changes.
-          wandTipOn();
-        break;
-
-        case 5:
-          ht_bargraph.setLed(bargraphLookupTable(8));
-          ht_bargraph.setLed(bargraphLookupTable(19));
-
-          if(b_bargraph_up) {
-            ht_bargraph.clearLed(bargraphLookupTable(9));
-            ht_bargraph.clearLed(bargraphLookupTable(18));
-
-            i_bargraph_status_alt++;
-          }
-          else {
-            ht_bargraph.clearLed(bargraphLookupTable(7));
-            ht_bargraph.clearLed(bargraphLookupTable(20));
-
-            i_bargraph_status_alt--;
-          }
-
-          ht_bargraph.sendLed(); // Commit the changes.
-          wandTipOn();
-        break;
-
-        case 6:
-          ht_bargraph.setLed(bargraphLookupTable(7));
-          ht_bargraph.setLed(bargraphLookupTable(20));
-
-          if(b_bargraph_up) {
-            ht_bargraph.clearLed(bargraphLookupTable(8));
-            ht_bargraph.clearLed(bargraphLookupTable(19));
-
-            i_bargraph_status_alt++;
-          }
-          else {
-            ht_bargraph.clearLed(bargraphLookupTable(6));
-            ht_bargraph.clearLed(bargraphLookupTable(21));
-
-            i_bargraph_status_alt--;
-          }
-
-          ht_bargraph.sendLed(); // Commit the changes.
-          wandTipOff();
-        break;
-
-        case 7:
-          ht_bargraph.setLed(bargraphLookupTable(6));
-          ht_bargraph.setLed(bargraphLookupTable(21));
-
-          if(b_bargraph_up) {
-            ht_bargraph.clearLed(bargraphLookupTable(7));
-            ht_bargraph.clearLed(bargraphLookupTable(20));
-
-            i_bargraph_status_alt++;
-          }
-          else {
-            ht_bargraph.clearLed(bargraphLookupTable(5));
-            ht_bargraph.clearLed(bargraphLookupTable(22));
-
-            i_bargraph_status_alt--;
-          }
-
-          ht_bargraph.sendLed(); // Commit the changes.
-          wandTipOff();
-        break;
-
-        case 8:
-          ht_bargraph.setLed(bargraphLookupTable(5));
-          ht_bargraph.setLed(bargraphLookupTable(22));
-
-          if(b_bargraph_up) {
-            ht_bargraph.clearLed(bargraphLookupTable(6));
-            ht_bargraph.clearLed(bargraphLookupTable(21));
-
-            i_bargraph_status_alt++;
-          }
-          else {
-            ht_bargraph.clearLed(bargraphLookupTable(4));
-            ht_bargraph.clearLed(bargraphLookupTable(23));
-
-            i_bargraph_status_alt--;
-          }
-
-          ht_bargraph.sendLed(); // Commit the changes.
-          wandTipOn();
-        break;
-
-        case 9:
-          ht_bargraph.setLed(bargraphLookupTable(4));
-          ht_bargraph.setLed(bargraphLookupTable(23));
-
-          if(b_bargraph_up) {
-            ht_bargraph.clearLed(bargraphLookupTable(5));
-            ht_bargraph.clearLed(bargraphLookupTable(22));
-
-            i_bargraph_status_alt++;
-          }
-          else {
-            ht_bargraph.clearLed(bargraphLookupTable(3));
-            ht_bargraph.clearLed(bargraphLookupTable(24));
-
-            i_bargraph_status_alt--;
-          }
-
-          ht_bargraph.sendLed(); // Commit the changes.
-          wandTipOn();
-        break;
-
-        case 10:
-          ht_bargraph.setLed(bargraphLookupTable(3));
-          ht_bargraph.setLed(bargraphLookupTable(24));
-
-          if(b_bargraph_up) {
-            ht_bargraph.clearLed(bargraphLookupTable(4));
-            ht_bargraph.clearLed(bargraphLookupTable(23));
-
-            i_bargraph_status_alt++;
-          }
-          else {
-            ht_bargraph.clearLed(bargraphLookupTable(2));
-            ht_bargraph.clearLed(bargraphLookupTable(25));
-
-            i_bargraph_status_alt--;
-          }
-
-          ht_bargraph.sendLed(); // Commit the changes.
-          wandTipOff();
-        break;
-
-        case 11:
-          ht_bargraph.setLed(bargraphLookupTable(2));
-          ht_bargraph.setLed(bargraphLookupTable(25));
-
-          if(b_bargraph_up) {
-            ht_bargraph.clearLed(bargraphLookupTable(3));
-            ht_bargraph.clearLed(bargraphLookupTable(24));
-
-            i_bargraph_status_alt++;
-          }
-          else {
-            ht_bargraph.clearLed(bargraphLookupTable(1));
-            ht_bargraph.clearLed(bargraphLookupTable(26));
-
-            i_bargraph_status_alt--;
-          }
-
-          ht_bargraph.sendLed(); // Commit the changes.
-          wandTipOff();
-        break;
-
-        case 12:
-          ht_bargraph.setLed(bargraphLookupTable(1));
-          ht_bargraph.setLed(bargraphLookupTable(26));
-
-          if(b_bargraph_up) {
-            ht_bargraph.clearLed(bargraphLookupTable(2));
-            ht_bargraph.clearLed(bargraphLookupTable(25));
-
-            i_bargraph_status_alt++;
-          }
-          else {
-            ht_bargraph.clearLed(bargraphLookupTable(0));
-            ht_bargraph.clearLed(bargraphLookupTable(27));
-
-            i_bargraph_status_alt--;
-          }
-
-          ht_bargraph.sendLed(); // Commit the changes.
-          wandTipOn();
-        break;
-
-        case 13:
-          ht_bargraph.setLed(bargraphLookupTable(0));
-          ht_bargraph.setLed(bargraphLookupTable(27));
-
-          ht_bargraph.clearLed(bargraphLookupTable(1));
-          ht_bargraph.clearLed(bargraphLookupTable(26));
-
-          i_bargraph_status_alt--;
-
-          b_bargraph_up = false;
-
-          ht_bargraph.sendLed(); // Commit the changes.
-          wandTipOn();
-        break;
-
-        default:
-          // We should not be here. Do nothing.
-        break;
-      }
-    }
-  }
-#ifndef ESP32
-  else {
-    // Hasbro 5 LED Bargraph.
-    switch(i_bargraph_status) {
-      case 1:
-        digitalWriteFast(bargraphLookupTable(1-1), LOW);
-        digitalWriteFast(bargraphLookupTable(2-1), HIGH);
-        digitalWriteFast(bargraphLookupTable(3-1), HIGH);
-        digitalWriteFast(bargraphLookupTable(4-1), HIGH);
-        digitalWriteFast(bargraphLookupTable(5-1), LOW);
-        i_bargraph_status++;
-
-        wandTipOn();
-      break;
-
-      case 2:
-        digitalWriteFast(bargraphLookupTable(1-1), HIGH);
-        digitalWriteFast(bargraphLookupTable(2-1), LOW);
-        digitalWriteFast(bargraphLookupTable(3-1), HIGH);
-        digitalWriteFast(bargraphLookupTable(4-1), LOW);
-        digitalWriteFast(bargraphLookupTable(5-1), HIGH);
-        i_bargraph_status++;
-
-        wandTipOff();
-      break;
-
-      case 3:
-        digitalWriteFast(bargraphLookupTable(1-1), HIGH);
-        digitalWriteFast(bargraphLookupTable(2-1), HIGH);
-        digitalWriteFast(bargraphLookupTable(3-1), LOW);
-        digitalWriteFast(bargraphLookupTable(4-1), HIGH);
-        digitalWriteFast(bargraphLookupTable(5-1), HIGH);
-        i_bargraph_status++;
-
-        wandTipOn();
-      break;
-
-      case 4:
-        digitalWriteFast(bargraphLookupTable(1-1), HIGH);
-        digitalWriteFast(bargraphLookupTable(2-1), LOW);
-        digitalWriteFast(bargraphLookupTable(3-1), HIGH);
-        digitalWriteFast(bargraphLookupTable(4-1), LOW);
-        digitalWriteFast(bargraphLookupTable(5-1), HIGH);
-        i_bargraph_status++;
-
-        wandTipOff();
-      break;
-
-      case 5:
-        digitalWriteFast(bargraphLookupTable(1-1), LOW);
-        digitalWriteFast(bargraphLookupTable(2-1), HIGH);
-        digitalWriteFast(bargraphLookupTable(3-1), HIGH);
-        digitalWriteFast(bargraphLookupTable(4-1), HIGH);
-        digitalWriteFast(bargraphLookupTable(5-1), LOW);
-        i_bargraph_status = 1;
-
-        wandTipOn();
-      break;
-    }
-  }
-#endif
-}
-
-// This is the Mode Original bargraph firing animation. The top portion fluctuates during firing and becomes more erratic the longer firing continues.
-void bargraphModeOriginalRampFiringAnimation() {
-  if(BARGRAPH_TYPE == SEGMENTS_28 || BARGRAPH_TYPE == SEGMENTS_30) {
-    /*
-      // For 28 Segments
-      Power Level 5: full: 23 - 27  (5 segments)
-      Power Level 4: 3/4: 17 - 22   (6 segments)
-      Power Level 3: 1/2: 12 - 16   (5 segments)
-      Power Level 2: 1/4: 5 - 11    (7 segments)
-      Power Level 1: none: 0 - 4    (5 segments)
-    */
-
-    /*
-      // 30 Segment bargraph.
-      Power Level 5: full: 24 - 29  (6 segments)
-      Power Level 4: 3/4: 18 - 23   (6 segments)
-      Power Level 3: 1/2: 12 - 17   (6 segments)
-      Power Level 2: 1/4: 6 - 11    (6 segments)
-      Power Level 1: none: 0 - 5    (6 segments)
-    */
-
-    uint8_t i_segment_adjust = 2;
-
-    if(BARGRAPH_TYPE == SEGMENTS_30) {
-      i_segment_adjust = 0;
-    }
-
-    // When firing starts, i_bargraph_status_alt resets to 0 in modeFireStart();
-    if(i_bargraph_status_alt == 0) {
-      // Set our target.
+  if(b_step && b_stream_barrel) {
+    if(gpstarWand.inStreamMode(MESON)) {
       switch(gpstarWand.getPowerLevel()) {
-        case LEVEL_5:
-        default:
-          i_bargraph_status_alt = random(18, i_bargraph_segments - i_segment_adjust);
-        break;
-
-        case LEVEL_4:
-          i_bargraph_status_alt = random(13, 25);
+        case LEVEL_1:
+        case LEVEL_2:
+          i_fast_led_delay = FAST_LED_UPDATE_MS; // 3ms
         break;
 
         case LEVEL_3:
-          i_bargraph_status_alt = random(9, 19);
+          i_fast_led_delay = FAST_LED_UPDATE_MS + 1; // 4ms
         break;
 
-        case LEVEL_2:
-          i_bargraph_status_alt = random(3, 13);
+        case LEVEL_4:
+          i_fast_led_delay = FAST_LED_UPDATE_MS + 3; // 6ms
         break;
 
-        case LEVEL_1:
-          // Not used in MODE_ORIGINAL.
-          //i_bargraph_status_alt = random(0, 6);
-        break;
-      }
-    }
-
-    bool b_tmp_down = true;
-
-    for(uint8_t i = 0; i < i_bargraph_segments - i_segment_adjust; i++) {
-      if(!ht_bargraph.getLed(bargraphLookupTable(i)) && i < i_bargraph_status_alt) {
-        b_tmp_down = false;
-        break;
-      }
-    }
-
-    switch(gpstarWand.getPowerLevel()) {
-      case LEVEL_5:
-      default:
-        if(b_tmp_down) {
-          // Moving down.
-          for(uint8_t i = i_bargraph_segments - (i_segment_adjust + 1); i >= i_bargraph_status_alt; i--) {
-            if(i_bargraph_status_alt == i) {
-              switch(i_cyclotron_multiplier) {
-                case 5:
-                  i_bargraph_status_alt = random(6, i_bargraph_segments - i_segment_adjust);
-                break;
-
-                case 4:
-                  i_bargraph_status_alt = random(9, i_bargraph_segments - i_segment_adjust);
-                break;
-
-                case 3:
-                  i_bargraph_status_alt = random(12, i_bargraph_segments - i_segment_adjust);
-                break;
-
-                case 2:
-                  i_bargraph_status_alt = random(15, i_bargraph_segments - i_segment_adjust);
-                break;
-
-                case 1:
-                default:
-                  i_bargraph_status_alt = random(18, i_bargraph_segments - i_segment_adjust);
-                break;
-              }
-            }
-
-            if(ht_bargraph.getLed(bargraphLookupTable(i))) {
-              ht_bargraph.clearLed(bargraphLookupTable(i));
-
-              break;
-            }
-          }
-
-          ht_bargraph.sendLed(); // Commit the changes.
-        }
-        else {
-          // Need to move up.
-          for(uint8_t i = 0; i <= i_bargraph_status_alt; i++) {
-            if(i_bargraph_status_alt == i) {
-              switch(i_cyclotron_multiplier) {
-                case 5:
-                  i_bargraph_status_alt = random(8, i_bargraph_segments - i_segment_adjust);
-                break;
-
-                case 4:
-                  i_bargraph_status_alt = random(12, i_bargraph_segments - i_segment_adjust);
-                break;
-
-                case 3:
-                  i_bargraph_status_alt = random(14, i_bargraph_segments - i_segment_adjust);
-                break;
-
-                case 2:
-                  i_bargraph_status_alt = random(16, i_bargraph_segments - i_segment_adjust);
-                break;
-
-                case 1:
-                  i_bargraph_status_alt = random(18, i_bargraph_segments - i_segment_adjust);
-                break;
-
-                default:
-                  i_bargraph_status_alt = random(0, i_bargraph_segments - i_segment_adjust);
-                break;
-              }
-            }
-
-            if(!ht_bargraph.getLed(bargraphLookupTable(i))) {
-              ht_bargraph.setLed(bargraphLookupTable(i));
-
-              break;
-            }
-          }
-
-          ht_bargraph.sendLed(); // Commit the changes.
-        }
-      break;
-
-      case LEVEL_4:
-        if(b_tmp_down) {
-          // Moving down.
-          for(uint8_t i = 25; i >= i_bargraph_status_alt; i--) {
-            if(i_bargraph_status_alt == i) {
-              switch(i_cyclotron_multiplier) {
-                case 5:
-                  i_bargraph_status_alt = random(1, 25);
-                break;
-
-                case 4:
-                  i_bargraph_status_alt = random(4, 25);
-                break;
-
-                case 3:
-                  i_bargraph_status_alt = random(7, 25);
-                break;
-
-                case 2:
-                  i_bargraph_status_alt = random(10, 25);
-                break;
-
-                case 1:
-                  i_bargraph_status_alt = random(13, 25);
-                break;
-
-                default:
-                  i_bargraph_status_alt = random(0, 25);
-                break;
-              }
-            }
-
-            if(ht_bargraph.getLed(bargraphLookupTable(i))) {
-              ht_bargraph.clearLed(bargraphLookupTable(i));
-
-              break;
-            }
-          }
-
-          ht_bargraph.sendLed(); // Commit the changes.
-        }
-        else {
-          // Need to move up.
-          for(uint8_t i = 0; i <= i_bargraph_status_alt; i++) {
-            if(i_bargraph_status_alt == i) {
-              switch(i_cyclotron_multiplier) {
-                case 5:
-                  i_bargraph_status_alt = random(1, 25);
-                break;
-
-                case 4:
-                  i_bargraph_status_alt = random(4, 25);
-                break;
-
-                case 3:
-                  i_bargraph_status_alt = random(7, 25);
-                break;
-
-                case 2:
-                  i_bargraph_status_alt = random(10, 25);
-                break;
-
-                case 1:
-                  i_bargraph_status_alt = random(13, 25);
-                break;
-
-                default:
-                  i_bargraph_status_alt = random(0, 25);
-                break;
-              }
-            }
-
-            if(!ht_bargraph.getLed(bargraphLookupTable(i))) {
-              ht_bargraph.setLed(bargraphLookupTable(i));
-
-              break;
-            }
-          }
-
-          ht_bargraph.sendLed(); // Commit the changes.
-        }
-      break;
-
-      case LEVEL_3:
-        if(b_tmp_down) {
-          // Moving down.
-          for(uint8_t i = 19; i >= i_bargraph_status_alt; i--) {
-            if(i_bargraph_status_alt == i) {
-              switch(i_cyclotron_multiplier) {
-                case 5:
-                  i_bargraph_status_alt = random(1, 19);
-                break;
-
-                case 4:
-                  i_bargraph_status_alt = random(3, 19);
-                break;
-
-                case 3:
-                  i_bargraph_status_alt = random(5, 19);
-                break;
-
-                case 2:
-                  i_bargraph_status_alt = random(7, 19);
-                break;
-
-                case 1:
-                  i_bargraph_status_alt = random(9, 19);
-                break;
-
-                default:
-                  i_bargraph_status_alt = random(0, 19);
-                break;
-              }
-            }
-
-            if(ht_bargraph.getLed(bargraphLookupTable(i))) {
-              ht_bargraph.clearLed(bargraphLookupTable(i));
-
-              break;
-            }
-          }
-
-          ht_bargraph.sendLed(); // Commit the changes.
-        }
-        else {
-          // Need to move up.
-          for(uint8_t i = 0; i <= i_bargraph_status_alt; i++) {
-            if(i_bargraph_status_alt == i) {
-              switch(i_cyclotron_multiplier) {
-                case 5:
-                  i_bargraph_status_alt = random(1, 19);
-                break;
-
-                case 4:
-                  i_bargraph_status_alt = random(3, 19);
-                break;
-
-                case 3:
-                  i_bargraph_status_alt = random(5, 19);
-                break;
-
-                case 2:
-                  i_bargraph_status_alt = random(7, 19);
-                break;
-
-                case 1:
-                  i_bargraph_status_alt = random(9, 19);
-                break;
-
-                default:
-                  i_bargraph_status_alt = random(0, 19);
-                break;
-              }
-            }
-
-            if(!ht_bargraph.getLed(bargraphLookupTable(i))) {
-              ht_bargraph.setLed(bargraphLookupTable(i));
-
-              break;
-            }
-          }
-
-          ht_bargraph.sendLed(); // Commit the changes.
-        }
-      break;
-
-      case LEVEL_2:
-        if(b_tmp_down) {
-          // Moving down.
-          for(uint8_t i = 13; i >= i_bargraph_status_alt; i--) {
-            if(i_bargraph_status_alt == i) {
-              switch(i_cyclotron_multiplier) {
-                case 5:
-                  i_bargraph_status_alt = random(1, 13);
-                break;
-
-                case 4:
-                  i_bargraph_status_alt = random(2, 13);
-                break;
-
-                case 3:
-                case 2:
-                case 1:
-                  i_bargraph_status_alt = random(3, 13);
-                break;
-
-                default:
-                  i_bargraph_status_alt = random(0, 13);
-                break;
-              }
-            }
-
-            if(ht_bargraph.getLed(bargraphLookupTable(i))) {
-              ht_bargraph.clearLed(bargraphLookupTable(i));
-
-              break;
-            }
-          }
-
-          ht_bargraph.sendLed(); // Commit the changes.
-        }
-        else {
-          // Need to move up.
-          for(uint8_t i = 0; i <= i_bargraph_status_alt; i++) {
-            if(i_bargraph_status_alt == i) {
-              switch(i_cyclotron_multiplier) {
-                case 5:
-                  i_bargraph_status_alt = random(1, 13);
-                break;
-
-                case 4:
-                  i_bargraph_status_alt = random(2, 13);
-                break;
-
-                case 3:
-                case 2:
-                case 1:
-                  i_bargraph_status_alt = random(3, 13);
-                break;
-
-                default:
-                  i_bargraph_status_alt = random(0, 13);
-                break;
-              }
-            }
-
-            if(!ht_bargraph.getLed(bargraphLookupTable(i))) {
-              ht_bargraph.setLed(bargraphLookupTable(i));
-
-              break;
-            }
-          }
-
-          ht_bargraph.sendLed(); // Commit the changes.
-        }
-      break;
-
-      case LEVEL_1:
-        if(b_tmp_down) {
-          // Moving down.
-          for(uint8_t i = 7; i >= i_bargraph_status_alt; i--) {
-            if(i_bargraph_status_alt == i) {
-              switch(i_cyclotron_multiplier) {
-                case 5:
-                  i_bargraph_status_alt = random(0, 10);
-                break;
-
-                case 4:
-                  i_bargraph_status_alt = random(0, 9);
-                break;
-
-                case 3:
-                case 2:
-                case 1:
-                  i_bargraph_status_alt = random(0, 8);
-                break;
-
-                default:
-                  i_bargraph_status_alt = random(0, 7);
-                break;
-              }
-            }
-
-            if(ht_bargraph.getLed(bargraphLookupTable(i))) {
-              ht_bargraph.clearLed(bargraphLookupTable(i));
-
-              break;
-            }
-          }
-
-          ht_bargraph.sendLed(); // Commit the changes.
-        }
-        else {
-          // Need to move up.
-          for(uint8_t i = 0; i <= i_bargraph_status_alt; i++) {
-            if(i_bargraph_status_alt == i) {
-              switch(i_cyclotron_multiplier) {
-                case 5:
-                  i_bargraph_status_alt = random(0, 10);
-                break;
-
-                case 4:
-                  i_bargraph_status_alt = random(0, 9);
-                break;
-
-                case 3:
-                case 2:
-                case 1:
-                  i_bargraph_status_alt = random(0, 8);
-                break;
-
-                default:
-                  i_bargraph_status_alt = random(0, 7);
-                break;
-              }
-            }
-
-            if(!ht_bargraph.getLed(bargraphLookupTable(i))) {
-              ht_bargraph.setLed(bargraphLookupTable(i));
-
-              break;
-            }
-          }
-
-          ht_bargraph.sendLed(); // Commit the changes.
-        }
-      break;
-    }
-  }
-  else {
-    // When firing starts, i_bargraph_status resets to 0 in modeFireStart();
-    if(i_bargraph_status == 0) {
-      // Set our target.
-      switch(gpstarWand.getPowerLevel()) {
         case LEVEL_5:
         default:
-          i_bargraph_status = random(2, i_bargraph_segments_5_led + 1);
-        break;
-
-        case LEVEL_4:
-          i_bargraph_status = random(2, i_bargraph_segments_5_led);
-        break;
-
-        case LEVEL_3:
-          i_bargraph_status = random(1, i_bargraph_segments_5_led - 1);
-        break;
-
-        case LEVEL_2:
-          i_bargraph_status = random(0, i_bargraph_segments_5_led - 2);
-        break;
-
-        case LEVEL_1:
-          i_bargraph_status = random(0, i_bargraph_segments_5_led - 3);
-        break;
-      }
-    }
-
-    bool b_tmp_down = true;
-
-    for(uint8_t i = 0; i < i_bargraph_segments_5_led; i++) {
-      if(digitalReadFast(bargraphLookupTable(i)) == HIGH && i <= i_bargraph_status) {
-        b_tmp_down = false;
-        break;
-      }
-    }
-
-    switch(gpstarWand.getPowerLevel()) {
-      case LEVEL_5:
-      default:
-        if(b_tmp_down) {
-          // Moving down.
-          for(uint8_t i = i_bargraph_segments_5_led; i >= i_bargraph_status; i--) {
-            if(i_bargraph_status == i) {
-              switch(i_cyclotron_multiplier) {
-                case 5:
-                  i_bargraph_status = random(1, i_bargraph_segments_5_led + 1);
-                break;
-
-                case 4:
-                  i_bargraph_status = random(1, i_bargraph_segments_5_led + 1);
-                break;
-
-                case 3:
-                  i_bargraph_status = random(1, i_bargraph_segments_5_led + 1);
-                break;
-
-                case 2:
-                  i_bargraph_status = random(2, i_bargraph_segments_5_led + 1);
-                break;
-
-                case 1:
-                default:
-                  i_bargraph_status = random(2, i_bargraph_segments_5_led + 1);
-                break;
-              }
-            }
-
-
-            if(digitalReadFast(bargraphLookupTable(i-1)) == LOW) {
-              wandBargraphControl(i-1);
-              break;
-            }
-          }
-        }
-        else {
-          // Need to move up.
-          for(uint8_t i = 0; i <= i_bargraph_status; i++) {
-            if(i_bargraph_status == i) {
-              switch(i_cyclotron_multiplier) {
-                case 5:
-                  i_bargraph_status = random(0, i_bargraph_segments_5_led + 1);
-                break;
-
-                case 4:
-                  i_bargraph_status = random(0, i_bargraph_segments_5_led + 1);
-                break;
-
-                case 3:
-                  i_bargraph_status = random(1, i_bargraph_segments_5_led + 1);
-                break;
-
-                case 2:
-                  i_bargraph_status = random(2, i_bargraph_segments_5_led + 1);
-                break;
-
-                case 1:
-                default:
-                  i_bargraph_status = random(2, i_bargraph_segments_5_led + 1);
-                break;
-              }
-            }
-
-            if(digitalReadFast(bargraphLookupTable(i)) == HIGH) {
-              wandBargraphControl(i+1);
-              break;
-            }
-          }
-        }
-      break;
-
-      case LEVEL_4:
-        if(b_tmp_down) {
-          // Moving down.
-          for(uint8_t i = i_bargraph_segments_5_led; i >= i_bargraph_status; i--) {
-            if(i_bargraph_status == i) {
-              switch(i_cyclotron_multiplier) {
-                case 5:
-                  i_bargraph_status = random(1, i_bargraph_segments_5_led + 1);
-                break;
-
-                case 4:
-                  i_bargraph_status = random(1, i_bargraph_segments_5_led + 1);
-                break;
-
-                case 3:
-                  i_bargraph_status = random(1, i_bargraph_segments_5_led + 1);
-                break;
-
-                case 2:
-                  i_bargraph_status = random(2, i_bargraph_segments_5_led + 1);
-                break;
-
-                case 1:
-                default:
-                  i_bargraph_status = random(2, i_bargraph_segments_5_led + 1);
-                break;
-              }
-            }
-
-
-            if(digitalReadFast(bargraphLookupTable(i-1)) == LOW) {
-              wandBargraphControl(i-1);
-              break;
-            }
-          }
-        }
-        else {
-          // Need to move up.
-          for(uint8_t i = 0; i <= i_bargraph_status; i++) {
-            if(i_bargraph_status == i) {
-              switch(i_cyclotron_multiplier) {
-                case 5:
-                  i_bargraph_status = random(0, i_bargraph_segments_5_led + 1);
-                break;
-
-                case 4:
-                  i_bargraph_status = random(0, i_bargraph_segments_5_led + 1);
-                break;
-
-                case 3:
-                  i_bargraph_status = random(1, i_bargraph_segments_5_led + 1);
-                break;
-
-                case 2:
-                  i_bargraph_status = random(2, i_bargraph_segments_5_led + 1);
-                break;
-
-                case 1:
-                default:
-                  i_bargraph_status = random(2, i_bargraph_segments_5_led + 1);
-                break;
-              }
-            }
-
-            if(digitalReadFast(bargraphLookupTable(i)) == HIGH) {
-              wandBargraphControl(i+1);
-              break;
-            }
-          }
-        }
-      break;
-
-      case LEVEL_3:
-        if(b_tmp_down) {
-          // Moving down.
-          for(uint8_t i = i_bargraph_segments_5_led; i >= i_bargraph_status; i--) {
-            if(i_bargraph_status == i) {
-              switch(i_cyclotron_multiplier) {
-                case 5:
-                  i_bargraph_status = random(1, i_bargraph_segments_5_led + 1);
-                break;
-
-                case 4:
-                  i_bargraph_status = random(1, i_bargraph_segments_5_led + 1);
-                break;
-
-                case 3:
-                  i_bargraph_status = random(1, i_bargraph_segments_5_led + 1);
-                break;
-
-                case 2:
-                  i_bargraph_status = random(1, i_bargraph_segments_5_led - 1);
-                break;
-
-                case 1:
-                default:
-                  i_bargraph_status = random(1, i_bargraph_segments_5_led - 1);
-                break;
-              }
-            }
-
-
-            if(digitalReadFast(bargraphLookupTable(i-1)) == LOW) {
-              wandBargraphControl(i-1);
-              break;
-            }
-          }
-        }
-        else {
-          // Need to move up.
-          for(uint8_t i = 0; i <= i_bargraph_status; i++) {
-            if(i_bargraph_status == i) {
-              switch(i_cyclotron_multiplier) {
-                case 5:
-                  i_bargraph_status = random(0, i_bargraph_segments_5_led + 1);
-                break;
-
-                case 4:
-                  i_bargraph_status = random(0, i_bargraph_segments_5_led + 1);
-                break;
-
-                case 3:
-                  i_bargraph_status = random(1, i_bargraph_segments_5_led + 1);
-                break;
-
-                case 2:
-                  i_bargraph_status = random(1, i_bargraph_segments_5_led - 1);
-                break;
-
-                case 1:
-                default:
-                  i_bargraph_status = random(1, i_bargraph_segments_5_led - 1);
-                break;
-              }
-            }
-
-            if(digitalReadFast(bargraphLookupTable(i)) == HIGH) {
-              wandBargraphControl(i+1);
-              break;
-            }
-          }
-        }
-      break;
-
-      case LEVEL_2:
-        if(b_tmp_down) {
-          // Moving down.
-          for(uint8_t i = i_bargraph_segments_5_led; i >= i_bargraph_status; i--) {
-            if(i_bargraph_status == i) {
-              switch(i_cyclotron_multiplier) {
-                case 5:
-                  i_bargraph_status = random(0, i_bargraph_segments_5_led + 1);
-                break;
-
-                case 4:
-                  i_bargraph_status = random(0, i_bargraph_segments_5_led + 1);
-                break;
-
-                case 3:
-                  i_bargraph_status = random(0, i_bargraph_segments_5_led + 1);
-                break;
-
-                case 2:
-                  i_bargraph_status = random(0, i_bargraph_segments_5_led + 1);
-                break;
-
-                case 1:
-                default:
-                  i_bargraph_status = random(0, i_bargraph_segments_5_led - 2);
-                break;
-              }
-            }
-
-
-            if(digitalReadFast(bargraphLookupTable(i-1)) == LOW) {
-              wandBargraphControl(i-1);
-              break;
-            }
-          }
-        }
-        else {
-          // Need to move up.
-          for(uint8_t i = 0; i <= i_bargraph_status; i++) {
-            if(i_bargraph_status == i) {
-              switch(i_cyclotron_multiplier) {
-                case 5:
-                  i_bargraph_status = random(0, i_bargraph_segments_5_led + 1);
-                break;
-
-                case 4:
-                  i_bargraph_status = random(0, i_bargraph_segments_5_led + 1);
-                break;
-
-                case 3:
-                  i_bargraph_status = random(1, i_bargraph_segments_5_led + 1);
-                break;
-
-                case 2:
-                  i_bargraph_status = random(0, i_bargraph_segments_5_led - 2);
-                break;
-
-                case 1:
-                default:
-                  i_bargraph_status = random(0, i_bargraph_segments_5_led - 2);
-                break;
-              }
-            }
-
-            if(digitalReadFast(bargraphLookupTable(i)) == HIGH) {
-              wandBargraphControl(i+1);
-              break;
-            }
-          }
-        }
-      break;
-
-      case LEVEL_1:
-        if(b_tmp_down) {
-          // Moving down.
-          for(uint8_t i = i_bargraph_segments_5_led; i >= i_bargraph_status; i--) {
-            if(i_bargraph_status == i) {
-              switch(i_cyclotron_multiplier) {
-                case 5:
-                  i_bargraph_status = random(0, i_bargraph_segments_5_led + 1);
-                break;
-
-                case 4:
-                  i_bargraph_status = random(0, i_bargraph_segments_5_led + 1);
-                break;
-
-                case 3:
-                  i_bargraph_status = random(0, i_bargraph_segments_5_led);
-                break;
-
-                case 2:
-                  i_bargraph_status = random(0, i_bargraph_segments_5_led - 2);
-                break;
-
-                case 1:
-                default:
-                  i_bargraph_status = random(0, i_bargraph_segments_5_led - 2);
-                break;
-              }
-            }
-
-            if(digitalReadFast(bargraphLookupTable(i-1)) == LOW) {
-              wandBargraphControl(i-1);
-              break;
-            }
-          }
-        }
-        else {
-          // Need to move up.
-          for(uint8_t i = 0; i <= i_bargraph_status; i++) {
-            if(i_bargraph_status == i) {
-              switch(i_cyclotron_multiplier) {
-                case 5:
-                  i_bargraph_status = random(0, i_bargraph_segments_5_led + 1);
-                break;
-
-                case 4:
-                  i_bargraph_status = random(0, i_bargraph_segments_5_led + 1);
-                break;
-
-                case 3:
-                  i_bargraph_status = random(0, i_bargraph_segments_5_led);
-                break;
-
-                case 2:
-                  i_bargraph_status = random(0, i_bargraph_segments_5_led - 2);
-                break;
-
-                case 1:
-                default:
-                  i_bargraph_status = random(0, i_bargraph_segments_5_led - 2);
-                break;
-              }
-            }
-
-            if(digitalReadFast(bargraphLookupTable(i)) == HIGH) {
-              wandBargraphControl(i+1);
-              break;
-            }
-          }
-        }
-      break;
-    }
-  }
-}
-
-void cyclotronSpeedUp(uint8_t i_switch) {
-  if(i_switch != i_cyclotron_multiplier && i_cyclotron_multiplier < 4) {
-    if(i_switch == 4) {
-      // Tell pack to start beeping before we overheat it.
-      wandSerialSend(W_BEEP_START);
-
-      // Play overheat alert beeps before we overheat.
-      switch(getSystemYearMode()) {
-        case SYSTEM_AFTERLIFE:
-        case SYSTEM_FROZEN_EMPIRE:
-        default:
-          playEffect(S_PACK_BEEPS_OVERHEAT, true);
-        break;
-
-        case SYSTEM_1984:
-        case SYSTEM_1989:
-          playEffect(S_BEEP_8, true);
-        break;
-      }
-
-      ms_warning_blink.start(i_warning_blink_delay);
-    }
-
-    i_cyclotron_multiplier++;
-
-    // Tell the pack to speed up the Cyclotron.
-    wandSerialSend(W_CYCLOTRON_INCREASE_SPEED);
-  }
-}
-
-// Bargraph ramping during firing.
-// Optional barrel LED tip strobing is controlled from here to give it a ramp effect if the Proton Pack and Neutrona Wand are going to overheat.
-void bargraphRampFiring() {
-  switch(BARGRAPH_FIRING_ANIMATION) {
-    case BARGRAPH_ANIMATION_SUPER_HERO:
-      bargraphSuperHeroRampFiringAnimation();
-    break;
-    case BARGRAPH_ANIMATION_ORIGINAL:
-    default:
-      bargraphModeOriginalRampFiringAnimation();
-
-      // Strobe the optional tip light on even barrel LED numbers.
-      if((i_barrel_light & 0x01) == 0) {
-        wandTipOn();
-      }
-      else {
-        wandTipOff();
-      }
-    break;
-  }
-
-  uint8_t i_ramp_interval = i_bargraph_ramp_interval;
-
-  if(BARGRAPH_TYPE == SEGMENTS_28 || BARGRAPH_TYPE == SEGMENTS_30) {
-    // Switch to a different ramp speed if using the 28 or 30 segment bargraph.
-    i_ramp_interval = i_bargraph_ramp_interval_alt;
-  }
-
-  // If in a power level on the wand that can overheat, change the speed of the bargraph ramp during firing based on time remaining before we overheat.
-  if(ms_overheat_initiate.isRunning()) {
-    if(ms_overheat_initiate.remaining() < i_ms_overheat_initiate[(uint8_t)gpstarWand.getPowerLevel() - 1] / 6) {
-      if(BARGRAPH_TYPE == SEGMENTS_28 || BARGRAPH_TYPE == SEGMENTS_30) {
-        ms_bargraph_firing.start((i_ramp_interval / 8) + 2); // 7ms per segment
-      }
-      else {
-        ms_bargraph_firing.start(i_ramp_interval / 5); // 24ms per LED
-      }
-
-      cyclotronSpeedUp(6);
-    }
-    else if(ms_overheat_initiate.remaining() < i_ms_overheat_initiate[(uint8_t)gpstarWand.getPowerLevel() - 1] / 5) {
-      if(BARGRAPH_TYPE == SEGMENTS_28 || BARGRAPH_TYPE == SEGMENTS_30) {
-        ms_bargraph_firing.start((i_ramp_interval / 8) + 4); // 9ms per segment
-      }
-      else {
-        ms_bargraph_firing.start(i_ramp_interval / 4); // 30ms per LED
-      }
-
-      cyclotronSpeedUp(5);
-    }
-    else if(ms_overheat_initiate.remaining() < i_ms_overheat_initiate[(uint8_t)gpstarWand.getPowerLevel() - 1] / 4) {
-      if(BARGRAPH_TYPE == SEGMENTS_28 || BARGRAPH_TYPE == SEGMENTS_30) {
-        ms_bargraph_firing.start((i_ramp_interval / 4) + 1); // 11ms per segment
-      }
-      else {
-        ms_bargraph_firing.start(i_ramp_interval / 3); // 40ms per LED
-      }
-
-      cyclotronSpeedUp(4);
-    }
-    else if(ms_overheat_initiate.remaining() < i_ms_overheat_initiate[(uint8_t)gpstarWand.getPowerLevel() - 1] / 3) {
-      if(BARGRAPH_TYPE == SEGMENTS_28 || BARGRAPH_TYPE == SEGMENTS_30) {
-        ms_bargraph_firing.start((i_ramp_interval / 4) + 3); // 13ms per segment
-      }
-      else {
-        ms_bargraph_firing.start((i_ramp_interval / 2) - 10); // 50ms per LED
-      }
-
-      cyclotronSpeedUp(3);
-    }
-    else if(ms_overheat_initiate.remaining() < i_ms_overheat_initiate[(uint8_t)gpstarWand.getPowerLevel() - 1] / 2) {
-      if(BARGRAPH_TYPE == SEGMENTS_28 || BARGRAPH_TYPE == SEGMENTS_30) {
-        ms_bargraph_firing.start((i_ramp_interval / 4) + 5); // 15ms per segment
-      }
-      else {
-        ms_bargraph_firing.start(i_ramp_interval / 2); // 60ms per LED
-      }
-
-      cyclotronSpeedUp(2);
-    }
-    else {
-      if(BARGRAPH_TYPE == SEGMENTS_28 || BARGRAPH_TYPE == SEGMENTS_30) {
-        switch(gpstarWand.getPowerLevel()) {
-          case LEVEL_5:
-          default:
-            ms_bargraph_firing.start((i_ramp_interval / 2) - 5); // 15ms per segment
-          break;
-
-          case LEVEL_4:
-            ms_bargraph_firing.start(i_ramp_interval / 2); // 20ms per segment
-          break;
-
-          case LEVEL_3:
-            ms_bargraph_firing.start((i_ramp_interval / 2) + 5); // 25ms per segment
-          break;
-
-          case LEVEL_2:
-            ms_bargraph_firing.start((i_ramp_interval / 2) + 10); // 30ms per segment
-          break;
-
-          case LEVEL_1:
-            ms_bargraph_firing.start((i_ramp_interval / 2) + 15); // 35ms per segment
-          break;
-        }
-      }
-      else {
-        if(BARGRAPH_FIRING_ANIMATION == BARGRAPH_ANIMATION_ORIGINAL) {
-          switch(gpstarWand.getPowerLevel()) {
-            case LEVEL_5:
-            default:
-              ms_bargraph_firing.start(i_ramp_interval / 2); // 60ms per LED
-            break;
-
-            case LEVEL_4:
-              ms_bargraph_firing.start((i_ramp_interval / 2) + 30); // 90ms per LED
-            break;
-
-            case LEVEL_3:
-              ms_bargraph_firing.start(i_ramp_interval); // 120ms per LED
-            break;
-
-            case LEVEL_2:
-              ms_bargraph_firing.start(i_ramp_interval * 2); // 240ms per LED
-            break;
-
-            case LEVEL_1:
-              ms_bargraph_firing.start(i_ramp_interval * 3); // 360ms per LED
-            break;
-          }
-        }
-        else {
-          ms_bargraph_firing.start(i_ramp_interval / 2); // 60ms per LED
-        }
-      }
-
-      i_cyclotron_multiplier = 1;
-    }
-  }
-  else {
-    if(BARGRAPH_TYPE == SEGMENTS_28 || BARGRAPH_TYPE == SEGMENTS_30) {
-      switch(gpstarWand.getPowerLevel()) {
-        case LEVEL_5:
-        default:
-          ms_bargraph_firing.start((i_ramp_interval / 2) - 7); // 13ms per segment
-        break;
-
-        case LEVEL_4:
-          ms_bargraph_firing.start((i_ramp_interval / 2) - 3); // 15ms per segment
-        break;
-
-        case LEVEL_3:
-          ms_bargraph_firing.start(i_ramp_interval / 2); // 20ms per segment
-        break;
-
-        case LEVEL_2:
-          ms_bargraph_firing.start((i_ramp_interval / 2) + 7); // 25ms per segment
-        break;
-
-        case LEVEL_1:
-          ms_bargraph_firing.start((i_ramp_interval / 2) + 12); // 30ms per segment
-        break;
-      }
-    }
-    else {
-      if(BARGRAPH_FIRING_ANIMATION == BARGRAPH_ANIMATION_ORIGINAL) {
-        switch(gpstarWand.getPowerLevel()) {
-          case LEVEL_5:
-          default:
-            ms_bargraph_firing.start(i_ramp_interval / 2); // 60ms per LED
-          break;
-
-          case LEVEL_4:
-            ms_bargraph_firing.start((i_ramp_interval / 2) + 30); // 90ms per LED
-          break;
-
-          case LEVEL_3:
-            ms_bargraph_firing.start(i_ramp_interval); // 120ms per LED
-          break;
-
-          case LEVEL_2:
-            ms_bargraph_firing.start(i_ramp_interval * 2); // 240ms per LED
-          break;
-
-          case LEVEL_1:
-            ms_bargraph_firing.start(i_ramp_interval * 3); // 360ms per LED
-          break;
-        }
-      }
-      else {
-        ms_bargraph_firing.start(i_ramp_interval / 2); // 60ms per LED
-      }
-    }
-  }
-}
-
-void modeFireStart() {
-  i_fast_led_delay = FAST_LED_UPDATE_MS;
-
-  modeFireStartSounds();
-
-  // Tell the pack the wand is firing, and if in Intensify (1) or Alt (2) mode.
-  wandSerialSend(W_FIRING, b_firing_intensify ? 1 : 2);
-
-  // Just in case a semi-auto was fired before we started firing a stream, stop its timer.
-  ms_semi_automatic_firing.stop();
-
-  switch(BARGRAPH_FIRING_ANIMATION) {
-    case BARGRAPH_ANIMATION_ORIGINAL:
-      // Redraw the bargraph to the current power level before doing the MODE_ORIGINAL firing animation.
-      bargraphRedraw();
-
-      // Reset the Hasbro bargraph.
-      i_bargraph_status = 0;
-    break;
-
-    case BARGRAPH_ANIMATION_SUPER_HERO:
-    default:
-      // Clear the bargraph before we do the animation.
-      bargraphClearAlt();
-
-      // Reset the Hasbro bargraph.
-      i_bargraph_status = 1;
-    break;
-  }
-
-  // Turn on hat light 1.
-  digitalWriteFast(BARREL_HAT_LED_PIN, HIGH);
-
-  // This will only overheat when enabled by using the alt firing when in crossing the streams mode.
-  bool b_overheat_flag = true;
-
-  if(((gpstarWand.isFiringModeCTS() || gpstarWand.isFiringModeCTSMix()) && !b_firing_alt) || !b_overheat_enabled) {
-    b_overheat_flag = false;
-  }
-
-  if(b_overheat_flag) {
-    // If in high power level on the wand, start an overheat timer.
-    if(b_overheat_level[(uint8_t)gpstarWand.getPowerLevel() - 1]) {
-      ms_overheat_initiate.start(i_ms_overheat_initiate[(uint8_t)gpstarWand.getPowerLevel() - 1]);
-    }
-  }
-
-  barrelLightsOff();
-
-  if(gpstarWand.inStreamMode(MESON)) {
-    ms_firing_stream_effects.start(0);
-  }
-  else {
-    ms_firing_lights.start(0);
-  }
-
-  // Stop any bargraph ramps.
-  ms_bargraph.stop();
-  ms_bargraph_alt.stop();
-
-  // Reset the 28 segment bargraph.
-  i_bargraph_status_alt = 0;
-
-  b_bargraph_up = false;
-
-  bargraphRampFiring();
-
-  if(gpstarWand.inStreamMode(PROTON) && b_stream_effects) {
-    ms_impact.start(random(10,16) * 1000);
-
-    // Standalone wand plays additional SFX from Proton Pack.
-    if(b_wand_standalone) {
-      ms_firing_sound_mix.start(random(7,15) * 1000);
-    }
-  }
-
-  ms_firing_length_timer.start(i_firing_timer_length);
-
-  #ifdef ESP32
-  // Restart the infrared timer based on the current power level.
-  switch(gpstarWand.getPowerLevel()) {
-    case 1:
-      irManager->startTXTimer(ir_delay_power_1);
-    break;
-    case 2:
-      irManager->startTXTimer(ir_delay_power_2);
-    break;
-    case 3:
-      irManager->startTXTimer(ir_delay_power_3);
-    break;
-    case 4:
-      irManager->startTXTimer(ir_delay_power_4);
-    break;
-    case 5:
-    default:
-      irManager->startTXTimer(ir_delay_power_5);
-    break;
-  }
-  #endif
-}
-
-void fireStreamEffect(CRGB c_colour) {
-  uint8_t i_firing_stream_tmp; // Stores a calculated value based on LED count.
-
-  switch(WAND_BARREL_LED_COUNT) {
-    case LEDS_50:
-      // GPStar Neutrona Barrel -> 48 LED + 2 Strobe Tips.
-      // This effect will "wrap" around the device to appear to push the stream forward.
-
-      i_firing_stream_tmp = i_firing_stream / 10; // 10ms
-
-      if(ms_firing_stream_effects.justFinished()) {
-        if(i_barrel_light - 1 >= 0 && i_barrel_light - 1 < i_num_barrel_leds) {
-          switch(gpstarWand.getStreamMode()) {
-            case PROTON:
-            default:
-              if(b_firing_cross_streams) {
-                if(isBrassPack()) {
-                  barrel_leds[PROGMEM_READU8(gpstar_neutrona_barrel[i_barrel_light - 1])] = getHueColour(C_CHARTREUSE, WAND_BARREL_LED_COUNT);
-                  //barrel_leds[PROGMEM_READU8(gpstar_neutrona_barrel[i_barrel_light - 2])] = c_colour;
-                }
-                else {
-                  barrel_leds[PROGMEM_READU8(gpstar_neutrona_barrel[i_barrel_light - 1])] = getHueColour(C_WHITE, WAND_BARREL_LED_COUNT);
-                  //barrel_leds[PROGMEM_READU8(gpstar_neutrona_barrel[i_barrel_light - 2])] = c_colour;
-                }
-              }
-              else if(getSystemYearMode() == SYSTEM_1989) {
-                // Shift the stream from orange to red on higher power levels.
-                switch(gpstarWand.getPowerLevel()) {
-                  case LEVEL_1:
-                    barrel_leds[PROGMEM_READU8(gpstar_neutrona_barrel[i_barrel_light - 1])] = getHueColour(C_RED5, WAND_BARREL_LED_COUNT);
-                  break;
-
-                  case LEVEL_2:
-                    barrel_leds[PROGMEM_READU8(gpstar_neutrona_barrel[i_barrel_light - 1])] = getHueColour(C_RED4, WAND_BARREL_LED_COUNT);
-                  break;
-
-                  case LEVEL_3:
-                    barrel_leds[PROGMEM_READU8(gpstar_neutrona_barrel[i_barrel_light - 1])] = getHueColour(C_RED3, WAND_BARREL_LED_COUNT);
-                  break;
-
-                  case LEVEL_4:
-                    barrel_leds[PROGMEM_READU8(gpstar_neutrona_barrel[i_barrel_light - 1])] = getHueColour(C_RED2, WAND_BARREL_LED_COUNT);
-                  break;
-
-                  case LEVEL_5:
-                  default:
-                    barrel_leds[PROGMEM_READU8(gpstar_neutrona_barrel[i_barrel_light - 1])] = getHueColour(C_RED, WAND_BARREL_LED_COUNT);
-                  break;
-                }
-              }
-              else {
-                // Shift the stream from red to orange on higher power levels.
-                switch(gpstarWand.getPowerLevel()) {
-                  case LEVEL_1:
-                    barrel_leds[PROGMEM_READU8(gpstar_neutrona_barrel[i_barrel_light - 1])] = getHueColour(C_RED, WAND_BARREL_LED_COUNT);
-                  break;
-
-                  case LEVEL_2:
-                    barrel_leds[PROGMEM_READU8(gpstar_neutrona_barrel[i_barrel_light - 1])] = getHueColour(C_RED2, WAND_BARREL_LED_COUNT);
-                  break;
-
-                  case LEVEL_3:
-                    barrel_leds[PROGMEM_READU8(gpstar_neutrona_barrel[i_barrel_light - 1])] = getHueColour(C_RED3, WAND_BARREL_LED_COUNT);
-                  break;
-
-                  case LEVEL_4:
-                    barrel_leds[PROGMEM_READU8(gpstar_neutrona_barrel[i_barrel_light - 1])] = getHueColour(C_RED4, WAND_BARREL_LED_COUNT);
-                  break;
-
-                  case LEVEL_5:
-                  default:
-                    barrel_leds[PROGMEM_READU8(gpstar_neutrona_barrel[i_barrel_light - 1])] = getHueColour(C_RED5, WAND_BARREL_LED_COUNT);
-                  break;
-                }
-              }
-            break;
-
-            case SLIME:
-              if(getSystemYearMode() == SYSTEM_1989) {
-                barrel_leds[PROGMEM_READU8(gpstar_neutrona_barrel[i_barrel_light - 1])] = getHueColour(C_PASTEL_PINK, WAND_BARREL_LED_COUNT);
-              }
-              else {
-                barrel_leds[PROGMEM_READU8(gpstar_neutrona_barrel[i_barrel_light - 1])] = getHueColour(C_DARK_GREEN, WAND_BARREL_LED_COUNT);
-              }
-            break;
-
-            case STASIS:
-              barrel_leds[PROGMEM_READU8(gpstar_neutrona_barrel[i_barrel_light - 1])] = getHueColour(C_BLUE, WAND_BARREL_LED_COUNT);
-            break;
-
-            case MESON:
-            case SPECTRAL:
-            case HOLIDAY_HALLOWEEN:
-            case HOLIDAY_CHRISTMAS:
-              barrel_leds[PROGMEM_READU8(gpstar_neutrona_barrel[i_barrel_light - 1])] = getHueColour(C_BLACK, WAND_BARREL_LED_COUNT);
-            break;
-
-            case SPECTRAL_CUSTOM:
-              barrel_leds[PROGMEM_READU8(gpstar_neutrona_barrel[i_barrel_light - 1])] = getHueColour(C_CUSTOM, WAND_BARREL_LED_COUNT);
-            break;
-          }
-        }
-
-        if(i_barrel_light == i_num_barrel_leds) {
-          i_barrel_light = 0;
-
-          uint8_t i_s_speed = 0;
-
-          switch(gpstarWand.getStreamMode()) {
-            case MESON:
-              // Do nothing; animation is restarted by checkWandAction();
-            break;
-
-            default:
-              switch(gpstarWand.getPowerLevel()) {
-                case LEVEL_1:
-                  i_s_speed = 5; // 5ms
-                break;
-
-                case LEVEL_2:
-                  i_s_speed = 6; // 4ms
-                break;
-
-                case LEVEL_3:
-                  i_s_speed = 7; // 3ms
-                break;
-
-                case LEVEL_4:
-                  i_s_speed = 8; // 2ms
-                break;
-
-                case LEVEL_5:
-                default:
-                  i_s_speed = 9; // 1ms
-                break;
-              }
-            break;
-          }
-
-          if(!gpstarWand.inStreamMode(MESON)) {
-            ms_firing_stream_effects.start(i_firing_stream_tmp - i_s_speed);
-          }
-        }
-        else if(i_barrel_light < i_num_barrel_leds) {
-          barrel_leds[PROGMEM_READU8(gpstar_neutrona_barrel[i_barrel_light])] = c_colour;
-
-          switch(gpstarWand.getStreamMode()) {
-            case MESON:
-              if(i_barrel_light + 1 < i_num_barrel_leds) {
-                barrel_leds[PROGMEM_READU8(gpstar_neutrona_barrel[i_barrel_light + 1])] = c_colour;
-              }
-
-              if(i_barrel_light + 2 < i_num_barrel_leds) {
-                barrel_leds[PROGMEM_READU8(gpstar_neutrona_barrel[i_barrel_light + 2])] = c_colour;
-              }
-
-              if(i_barrel_light + 3 < i_num_barrel_leds) {
-                barrel_leds[PROGMEM_READU8(gpstar_neutrona_barrel[i_barrel_light + 3])] = c_colour;
-              }
-            break;
-
-            case PROTON:
-            {
-              uint8_t i_t_rand = random(0, i_num_barrel_leds / 3); // from 0 to 15
-
-              switch(gpstarWand.getPowerLevel()) {
-                case LEVEL_5:
-                default:
-                  i_t_rand = i_t_rand + 10;
-                break;
-
-                case LEVEL_4:
-                  i_t_rand = i_t_rand + 8;
-                break;
-
-                case LEVEL_3:
-                  i_t_rand = i_t_rand + 6;
-                break;
-
-                case LEVEL_2:
-                  i_t_rand = i_t_rand + 3;
-                break;
-
-                case LEVEL_1:
-                i_t_rand = i_t_rand + 2;
-                  // Nothing.
-                break;
-              }
-
-              for(uint8_t i = i_barrel_light + 1; i < i_barrel_light + i_t_rand; i++) {
-                if(i < i_num_barrel_leds) {
-                  barrel_leds[PROGMEM_READU8(gpstar_neutrona_barrel[i])] = c_colour;
-                }
-              }
-            }
-            break;
-
-            default:
-            {
-              uint8_t i_t_rand_def = random(0, i_num_barrel_leds / 4); // from 0 to 11
-
-              for(uint8_t i = i_barrel_light + 1; i < i_barrel_light + i_t_rand_def; i++) {
-                if(i < i_num_barrel_leds) {
-                  barrel_leds[PROGMEM_READU8(gpstar_neutrona_barrel[i])] = c_colour;
-                }
-              }
-            }
-            break;
-          }
-
-          switch(gpstarWand.getStreamMode()) {
-            case MESON:
-              switch(gpstarWand.getPowerLevel()) {
-                case LEVEL_1:
-                  i_fast_led_delay = FAST_LED_UPDATE_MS; // 3ms
-                  ms_firing_stream_effects.start((i_firing_stream / 25)); // 4ms
-                break;
-
-                case LEVEL_2:
-                  i_fast_led_delay = FAST_LED_UPDATE_MS; // 3ms
-                  ms_firing_stream_effects.start((i_firing_stream / 25) - 1); // 3ms
-                break;
-
-                case LEVEL_3:
-                  i_fast_led_delay = FAST_LED_UPDATE_MS + 1; // 4ms
-                  ms_firing_stream_effects.start((i_firing_stream / 25) - 1); // 3ms
-                break;
-
-                case LEVEL_4:
-                  i_fast_led_delay = FAST_LED_UPDATE_MS + 3; // 6ms
-                  ms_firing_stream_effects.start((i_firing_stream / 25) - 1); // 3ms
-                break;
-
-                case LEVEL_5:
-                default:
-                  i_fast_led_delay = FAST_LED_UPDATE_MS + 4; // 7ms
-                  ms_firing_stream_effects.start((i_firing_stream / 25) - 2); // 2ms
-                break;
-              }
-            break;
-
-            case PROTON:
-              switch(gpstarWand.getPowerLevel()) {
-                case LEVEL_1:
-                  ms_firing_stream_effects.start((i_firing_stream / 25) + 4); // 8ms
-                break;
-
-                case LEVEL_2:
-                  ms_firing_stream_effects.start((i_firing_stream / 25) + 3); // 7ms
-                break;
-
-                case LEVEL_3:
-                  ms_firing_stream_effects.start((i_firing_stream / 25) + 2); // 6ms
-                break;
-
-                case LEVEL_4:
-                  ms_firing_stream_effects.start((i_firing_stream / 25) + 1); // 5ms
-                break;
-
-                case LEVEL_5:
-                default:
-                  ms_firing_stream_effects.start((i_firing_stream / 25)); // 4ms
-                break;
-              }
-            break;
-
-            case SLIME:
-              if(WAND_ACTION_STATUS == ACTION_FIRING) {
-                switch(gpstarWand.getPowerLevel()) {
-                  case LEVEL_1:
-                    ms_firing_stream_effects.start((i_firing_stream / 25) + 2); // 6ms
-                  break;
-
-                  case LEVEL_2:
-                    ms_firing_stream_effects.start((i_firing_stream / 25) + 1); // 5ms
-                  break;
-
-                  case LEVEL_3:
-                    ms_firing_stream_effects.start((i_firing_stream / 25)); // 4ms
-                  break;
-
-                  case LEVEL_4:
-                    ms_firing_stream_effects.start((i_firing_stream / 25) - 1); // 3ms
-                  break;
-
-                  case LEVEL_5:
-                  default:
-                    ms_firing_stream_effects.start((i_firing_stream / 25) - 2); // 2ms
-                  break;
-                }
-              }
-              else {
-                // Slime Tether response time is a fixed value.
-                ms_firing_stream_effects.start((i_firing_stream / 25) - 3); // 1ms
-
-                // Let Slime Tether turn on the barrel tip.
-                if(i_barrel_light + 4 == i_num_barrel_leds) {
-                  wandTipOn();
-                }
-              }
-            break;
-
-            default:
-              switch(gpstarWand.getPowerLevel()) {
-                case LEVEL_1:
-                  ms_firing_stream_effects.start((i_firing_stream / 25) + 2); // 6ms
-                break;
-
-                case LEVEL_2:
-                  ms_firing_stream_effects.start((i_firing_stream / 25) + 1); // 5ms
-                break;
-
-                case LEVEL_3:
-                  ms_firing_stream_effects.start((i_firing_stream / 25)); // 4ms
-                break;
-
-                case LEVEL_4:
-                  ms_firing_stream_effects.start((i_firing_stream / 25) - 1); // 3ms
-                break;
-
-                case LEVEL_5:
-                default:
-                  ms_firing_stream_effects.start((i_firing_stream / 25) - 2); // 2ms
-                break;
-              }
-            break;
-          }
-
-          i_barrel_light++;
-        }
-      }
-    break;
-
-    case LEDS_48:
-      // GPStar Neutrona Barrel -> 48 LED + 2 Strobe Tips.
-      // Frutto Technology -> 48 LED + Strobe Tip
-      // This effect will "wrap" around the device to appear to push the stream forward.
-
-      i_firing_stream_tmp = i_firing_stream / 10; // 10ms
-
-      if(ms_firing_stream_effects.justFinished()) {
-        if(i_barrel_light - 1 >= 0 && i_barrel_light - 1 < i_num_barrel_leds) {
-          switch(gpstarWand.getStreamMode()) {
-            case PROTON:
-            default:
-              if(b_firing_cross_streams) {
-                if(isBrassPack()) {
-                  barrel_leds[PROGMEM_READU8(frutto_barrel[i_barrel_light - 1])] = getHueColour(C_CHARTREUSE, WAND_BARREL_LED_COUNT);
-                  //barrel_leds[PROGMEM_READU8(frutto_barrel[i_barrel_light - 2])] = c_colour;
-                }
-                else {
-                  barrel_leds[PROGMEM_READU8(frutto_barrel[i_barrel_light - 1])] = getHueColour(C_WHITE, WAND_BARREL_LED_COUNT);
-                  //barrel_leds[PROGMEM_READU8(frutto_barrel[i_barrel_light - 2])] = c_colour;
-                }
-              }
-              else if(getSystemYearMode() == SYSTEM_1989) {
-                // Shift the stream from orange to red on higher power levels.
-                switch(gpstarWand.getPowerLevel()) {
-                  case LEVEL_1:
-                    barrel_leds[PROGMEM_READU8(frutto_barrel[i_barrel_light - 1])] = getHueColour(C_RED5, WAND_BARREL_LED_COUNT);
-                  break;
-
-                  case LEVEL_2:
-                    barrel_leds[PROGMEM_READU8(frutto_barrel[i_barrel_light - 1])] = getHueColour(C_RED4, WAND_BARREL_LED_COUNT);
-                  break;
-
-                  case LEVEL_3:
-                    barrel_leds[PROGMEM_READU8(frutto_barrel[i_barrel_light - 1])] = getHueColour(C_RED3, WAND_BARREL_LED_COUNT);
-                  break;
-
-                  case LEVEL_4:
-                    barrel_leds[PROGMEM_READU8(frutto_barrel[i_barrel_light - 1])] = getHueColour(C_RED2, WAND_BARREL_LED_COUNT);
-                  break;
-
-                  case LEVEL_5:
-                  default:
-                    barrel_leds[PROGMEM_READU8(frutto_barrel[i_barrel_light - 1])] = getHueColour(C_RED, WAND_BARREL_LED_COUNT);
-                  break;
-                }
-              }
-              else {
-                // Shift the stream from red to orange on higher power levels.
-                switch(gpstarWand.getPowerLevel()) {
-                  case LEVEL_1:
-                    barrel_leds[PROGMEM_READU8(frutto_barrel[i_barrel_light - 1])] = getHueColour(C_RED, WAND_BARREL_LED_COUNT);
-                  break;
-
-                  case LEVEL_2:
-                    barrel_leds[PROGMEM_READU8(frutto_barrel[i_barrel_light - 1])] = getHueColour(C_RED2, WAND_BARREL_LED_COUNT);
-                  break;
-
-                  case LEVEL_3:
-                    barrel_leds[PROGMEM_READU8(frutto_barrel[i_barrel_light - 1])] = getHueColour(C_RED3, WAND_BARREL_LED_COUNT);
-                  break;
-
-                  case LEVEL_4:
-                    barrel_leds[PROGMEM_READU8(frutto_barrel[i_barrel_light - 1])] = getHueColour(C_RED4, WAND_BARREL_LED_COUNT);
-                  break;
-
-                  case LEVEL_5:
-                  default:
-                    barrel_leds[PROGMEM_READU8(frutto_barrel[i_barrel_light - 1])] = getHueColour(C_RED5, WAND_BARREL_LED_COUNT);
-                  break;
-                }
-              }
-            break;
-
-            case SLIME:
-              if(getSystemYearMode() == SYSTEM_1989) {
-                barrel_leds[PROGMEM_READU8(frutto_barrel[i_barrel_light - 1])] = getHueColour(C_PASTEL_PINK, WAND_BARREL_LED_COUNT);
-              }
-              else {
-                barrel_leds[PROGMEM_READU8(frutto_barrel[i_barrel_light - 1])] = getHueColour(C_DARK_GREEN, WAND_BARREL_LED_COUNT);
-              }
-            break;
-
-            case STASIS:
-              barrel_leds[PROGMEM_READU8(frutto_barrel[i_barrel_light - 1])] = getHueColour(C_BLUE, WAND_BARREL_LED_COUNT);
-            break;
-
-            case MESON:
-            case SPECTRAL:
-            case HOLIDAY_HALLOWEEN:
-            case HOLIDAY_CHRISTMAS:
-              barrel_leds[PROGMEM_READU8(frutto_barrel[i_barrel_light - 1])] = getHueColour(C_BLACK, WAND_BARREL_LED_COUNT);
-            break;
-
-            case SPECTRAL_CUSTOM:
-              barrel_leds[PROGMEM_READU8(frutto_barrel[i_barrel_light - 1])] = getHueColour(C_CUSTOM, WAND_BARREL_LED_COUNT);
-            break;
-          }
-        }
-
-        if(i_barrel_light == i_num_barrel_leds) {
-          i_barrel_light = 0;
-
-          uint8_t i_s_speed = 0;
-
-          switch(gpstarWand.getStreamMode()) {
-            case MESON:
-              // Do nothing; animation is restarted by checkWandAction();
-            break;
-
-            default:
-              switch(gpstarWand.getPowerLevel()) {
-                case LEVEL_1:
-                  i_s_speed = 5; // 5ms
-                break;
-
-                case LEVEL_2:
-                  i_s_speed = 6; // 4ms
-                break;
-
-                case LEVEL_3:
-                  i_s_speed = 7; // 3ms
-                break;
-
-                case LEVEL_4:
-                  i_s_speed = 8; // 2ms
-                break;
-
-                case LEVEL_5:
-                default:
-                  i_s_speed = 9; // 1ms
-                break;
-              }
-            break;
-          }
-
-          if(!gpstarWand.inStreamMode(MESON)) {
-            ms_firing_stream_effects.start(i_firing_stream_tmp - i_s_speed);
-          }
-        }
-        else if(i_barrel_light < i_num_barrel_leds) {
-          barrel_leds[PROGMEM_READU8(frutto_barrel[i_barrel_light])] = c_colour;
-
-          switch(gpstarWand.getStreamMode()) {
-            case MESON:
-              if(i_barrel_light + 1 < i_num_barrel_leds) {
-                barrel_leds[PROGMEM_READU8(frutto_barrel[i_barrel_light + 1])] = c_colour;
-              }
-
-              if(i_barrel_light + 2 < i_num_barrel_leds) {
-                barrel_leds[PROGMEM_READU8(frutto_barrel[i_barrel_light + 2])] = c_colour;
-              }
-
-              if(i_barrel_light + 3 < i_num_barrel_leds) {
-                barrel_leds[PROGMEM_READU8(frutto_barrel[i_barrel_light + 3])] = c_colour;
-              }
-            break;
-
-            case PROTON:
-            {
-              uint8_t i_t_rand = random(0, i_num_barrel_leds / 3); // from 0 to 15
-
-              switch(gpstarWand.getPowerLevel()) {
-                case LEVEL_5:
-                default:
-                  i_t_rand = i_t_rand + 10;
-                break;
-
-                case LEVEL_4:
-                  i_t_rand = i_t_rand + 8;
-                break;
-
-                case LEVEL_3:
-                  i_t_rand = i_t_rand + 6;
-                break;
-
-                case LEVEL_2:
-                  i_t_rand = i_t_rand + 3;
-                break;
-
-                case LEVEL_1:
-                i_t_rand = i_t_rand + 2;
-                  // Nothing.
-                break;
-              }
-
-              for(uint8_t i = i_barrel_light + 1; i < i_barrel_light + i_t_rand; i++) {
-                if(i < i_num_barrel_leds) {
-                  barrel_leds[PROGMEM_READU8(frutto_barrel[i])] = c_colour;
-                }
-              }
-            }
-            break;
-
-            default:
-            {
-              uint8_t i_t_rand_def = random(0, i_num_barrel_leds / 4); // from 0 to 11
-
-              for(uint8_t i = i_barrel_light + 1; i < i_barrel_light + i_t_rand_def; i++) {
-                if(i < i_num_barrel_leds) {
-                  barrel_leds[PROGMEM_READU8(frutto_barrel[i])] = c_colour;
-                }
-              }
-            }
-            break;
-          }
-
-          switch(gpstarWand.getStreamMode()) {
-            case MESON:
-              switch(gpstarWand.getPowerLevel()) {
-                case LEVEL_1:
-                  i_fast_led_delay = FAST_LED_UPDATE_MS; // 3ms
-                  ms_firing_stream_effects.start((i_firing_stream / 25)); // 4ms
-                break;
-
-                case LEVEL_2:
-                  i_fast_led_delay = FAST_LED_UPDATE_MS; // 3ms
-                  ms_firing_stream_effects.start((i_firing_stream / 25) - 1); // 3ms
-                break;
-
-                case LEVEL_3:
-                  i_fast_led_delay = FAST_LED_UPDATE_MS + 1; // 4ms
-                  ms_firing_stream_effects.start((i_firing_stream / 25) - 1); // 3ms
-                break;
-
-                case LEVEL_4:
-                  i_fast_led_delay = FAST_LED_UPDATE_MS + 3; // 6ms
-                  ms_firing_stream_effects.start((i_firing_stream / 25) - 1); // 3ms
-                break;
-
-                case LEVEL_5:
-                default:
-                  i_fast_led_delay = FAST_LED_UPDATE_MS + 4; // 7ms
-                  ms_firing_stream_effects.start((i_firing_stream / 25) - 2); // 2ms
-                break;
-              }
-            break;
-
-            case PROTON:
-              switch(gpstarWand.getPowerLevel()) {
-                case LEVEL_1:
-                  ms_firing_stream_effects.start((i_firing_stream / 25) + 4); // 8ms
-                break;
-
-                case LEVEL_2:
-                  ms_firing_stream_effects.start((i_firing_stream / 25) + 3); // 7ms
-                break;
-
-                case LEVEL_3:
-                  ms_firing_stream_effects.start((i_firing_stream / 25) + 2); // 6ms
-                break;
-
-                case LEVEL_4:
-                  ms_firing_stream_effects.start((i_firing_stream / 25) + 1); // 5ms
-                break;
-
-                case LEVEL_5:
-                default:
-                  ms_firing_stream_effects.start((i_firing_stream / 25)); // 4ms
-                break;
-              }
-            break;
-
-            case SLIME:
-              if(WAND_ACTION_STATUS == ACTION_FIRING) {
-                switch(gpstarWand.getPowerLevel()) {
-                  case LEVEL_1:
-                    ms_firing_stream_effects.start((i_firing_stream / 25) + 2); // 6ms
-                  break;
-
-                  case LEVEL_2:
-                    ms_firing_stream_effects.start((i_firing_stream / 25) + 1); // 5ms
-                  break;
-
-                  case LEVEL_3:
-                    ms_firing_stream_effects.start((i_firing_stream / 25)); // 4ms
-                  break;
-
-                  case LEVEL_4:
-                    ms_firing_stream_effects.start((i_firing_stream / 25) - 1); // 3ms
-                  break;
-
-                  case LEVEL_5:
-                  default:
-                    ms_firing_stream_effects.start((i_firing_stream / 25) - 2); // 2ms
-                  break;
-                }
-              }
-              else {
-                // Slime Tether response time is a fixed value.
-                ms_firing_stream_effects.start((i_firing_stream / 25) - 3); // 1ms
-
-                // Let Slime Tether turn on the barrel tip.
-                if(i_barrel_light + 4 == i_num_barrel_leds) {
-                  wandTipOn();
-                }
-              }
-            break;
-
-            default:
-              switch(gpstarWand.getPowerLevel()) {
-                case LEVEL_1:
-                  ms_firing_stream_effects.start((i_firing_stream / 25) + 2); // 6ms
-                break;
-
-                case LEVEL_2:
-                  ms_firing_stream_effects.start((i_firing_stream / 25) + 1); // 5ms
-                break;
-
-                case LEVEL_3:
-                  ms_firing_stream_effects.start((i_firing_stream / 25)); // 4ms
-                break;
-
-                case LEVEL_4:
-                  ms_firing_stream_effects.start((i_firing_stream / 25) - 1); // 3ms
-                break;
-
-                case LEVEL_5:
-                default:
-                  ms_firing_stream_effects.start((i_firing_stream / 25) - 2); // 2ms
-                break;
-              }
-            break;
-          }
-
-          i_barrel_light++;
-        }
-      }
-    break;
-
-    case LEDS_5:
-    case LEDS_2:
-    default:
-      i_firing_stream_tmp = i_firing_stream;
-
-      if(ms_firing_stream_effects.justFinished()) {
-        if(i_barrel_light - 1 >= 0 && i_barrel_light - 1 < i_num_barrel_leds) {
-          switch(gpstarWand.getStreamMode()) {
-            case PROTON:
-            default:
-              if(b_firing_cross_streams) {
-                if(isBrassPack()) {
-                  barrel_leds[i_barrel_light - 1] = getHueColour(C_CHARTREUSE, WAND_BARREL_LED_COUNT);
-                }
-                else {
-                  barrel_leds[i_barrel_light - 1] = getHueColour(C_WHITE, WAND_BARREL_LED_COUNT);
-                }
-              }
-              else if(getSystemYearMode() == SYSTEM_1989) {
-                // Shift the stream from orange to red on higher power levels.
-                switch(gpstarWand.getPowerLevel()) {
-                  case LEVEL_1:
-                    barrel_leds[i_barrel_light - 1] = getHueColour(C_RED5, WAND_BARREL_LED_COUNT);
-                  break;
-
-                  case LEVEL_2:
-                    barrel_leds[i_barrel_light - 1] = getHueColour(C_RED4, WAND_BARREL_LED_COUNT);
-                  break;
-
-                  case LEVEL_3:
-                    barrel_leds[i_barrel_light - 1] = getHueColour(C_RED3, WAND_BARREL_LED_COUNT);
-                  break;
-
-                  case LEVEL_4:
-                    barrel_leds[i_barrel_light - 1] = getHueColour(C_RED2, WAND_BARREL_LED_COUNT);
-                  break;
-
-                  case LEVEL_5:
-                  default:
-                    barrel_leds[i_barrel_light - 1] = getHueColour(C_RED, WAND_BARREL_LED_COUNT);
-                  break;
-                }
-              }
-              else {
-                // Shift the stream from red to orange on higher power levels.
-                switch(gpstarWand.getPowerLevel()) {
-                  case LEVEL_1:
-                    barrel_leds[i_barrel_light - 1] = getHueColour(C_RED, WAND_BARREL_LED_COUNT);
-                  break;
-
-                  case LEVEL_2:
-                    barrel_leds[i_barrel_light - 1] = getHueColour(C_RED2, WAND_BARREL_LED_COUNT);
-                  break;
-
-                  case LEVEL_3:
-                    barrel_leds[i_barrel_light - 1] = getHueColour(C_RED3, WAND_BARREL_LED_COUNT);
-                  break;
-
-                  case LEVEL_4:
-                    barrel_leds[i_barrel_light - 1] = getHueColour(C_RED4, WAND_BARREL_LED_COUNT);
-                  break;
-
-                  case LEVEL_5:
-                  default:
-                    barrel_leds[i_barrel_light - 1] = getHueColour(C_RED5, WAND_BARREL_LED_COUNT);
-                  break;
-                }
-              }
-            break;
-
-            case SLIME:
-              if(getSystemYearMode() == SYSTEM_1989) {
-                barrel_leds[i_barrel_light - 1] = getHueColour(C_PASTEL_PINK, WAND_BARREL_LED_COUNT);
-              }
-              else {
-                barrel_leds[i_barrel_light - 1] = getHueColour(C_DARK_GREEN, WAND_BARREL_LED_COUNT);
-              }
-            break;
-
-            case STASIS:
-              barrel_leds[i_barrel_light - 1] = getHueColour(C_BLUE, WAND_BARREL_LED_COUNT);
-            break;
-
-            case MESON:
-            case SPECTRAL:
-            case HOLIDAY_HALLOWEEN:
-            case HOLIDAY_CHRISTMAS:
-              barrel_leds[i_barrel_light - 1] = getHueColour(C_BLACK, WAND_BARREL_LED_COUNT);
-            break;
-
-            case SPECTRAL_CUSTOM:
-              barrel_leds[i_barrel_light - 1] = getHueColour(C_CUSTOM, WAND_BARREL_LED_COUNT);
-            break;
-          }
-        }
-
-        if(i_barrel_light == i_num_barrel_leds) {
-          i_barrel_light = 0;
-
-          switch(gpstarWand.getStreamMode()) {
-            case MESON:
-              // Do nothing; animation is restarted by checkWandAction();
-            break;
-
-            default:
-              switch(gpstarWand.getPowerLevel()) {
-                case LEVEL_1:
-                  ms_firing_stream_effects.start(i_firing_stream_tmp); // 100ms
-                break;
-
-                case LEVEL_2:
-                  ms_firing_stream_effects.start(i_firing_stream_tmp - 15); // 85ms
-                break;
-
-                case LEVEL_3:
-                  ms_firing_stream_effects.start(i_firing_stream_tmp - 30); // 70ms
-                break;
-
-                case LEVEL_4:
-                  ms_firing_stream_effects.start(i_firing_stream_tmp - 45); // 55ms
-                break;
-
-                case LEVEL_5:
-                default:
-                  ms_firing_stream_effects.start(i_firing_stream_tmp - 60); // 40ms
-                break;
-              }
-            break;
-          }
-        }
-        else if(i_barrel_light < i_num_barrel_leds) {
-          barrel_leds[i_barrel_light] = c_colour;
-
-          switch(gpstarWand.getStreamMode()) {
-            default:
-              switch(gpstarWand.getPowerLevel()) {
-                case LEVEL_1:
-                  ms_firing_stream_effects.start((i_firing_stream / 5) + 10); // 30ms
-                break;
-
-                case LEVEL_2:
-                  ms_firing_stream_effects.start((i_firing_stream / 5) + 8); // 28ms
-                break;
-
-                case LEVEL_3:
-                  ms_firing_stream_effects.start((i_firing_stream / 5) + 6); // 26ms
-                break;
-
-                case LEVEL_4:
-                  ms_firing_stream_effects.start((i_firing_stream / 5) + 5); // 25ms
-                break;
-
-                case LEVEL_5:
-                default:
-                  ms_firing_stream_effects.start((i_firing_stream / 5) + 4); // 24ms
-                break;
-              }
-            break;
-          }
-
-          i_barrel_light++;
-        }
+          i_fast_led_delay = FAST_LED_UPDATE_MS + 4; // 7ms
+        break;
       }
-    break;
+    }
+    else if(params == &BARREL_STREAM_TETHER && i_barrel_light + 3 == strip.getCount()) {
+      // Let Slime Tether turn on the barrel tip.
+      wandTipOn();
+    }
   }
 }
 
@@ -6988,7 +4356,7 @@ void fireStreamStart(CRGB c_colour) {
         barrel_leds[PROGMEM_READU8(gpstar_neutrona_barrel[i_barrel_light])] = c_colour;
 
         if(i_barrel_light + 2 < i_num_barrel_leds) {
-          barrel_leds[PROGMEM_READU8(gpstar_neutrona_barrel[i_barrel_light + 2])] = getHueColour(C_BLACK, WAND_BARREL_LED_COUNT);
+          barrel_leds[PROGMEM_READU8(gpstar_neutrona_barrel[i_barrel_light + 2])] = getBarrelColour(C_BLACK);
         }
       break;
 
@@ -6999,7 +4367,7 @@ void fireStreamStart(CRGB c_colour) {
         barrel_leds[PROGMEM_READU8(frutto_barrel[i_barrel_light])] = c_colour;
 
         if(i_barrel_light + 2 < i_num_barrel_leds) {
-          barrel_leds[PROGMEM_READU8(frutto_barrel[i_barrel_light + 2])] = getHueColour(C_BLACK, WAND_BARREL_LED_COUNT);
+          barrel_leds[PROGMEM_READU8(frutto_barrel[i_barrel_light + 2])] = getBarrelColour(C_BLACK);
         }
       break;
 
@@ -7084,7 +4452,7 @@ uint8_t getRandomFiringEffect() {
 void mixExtraFiringEffects() {
 #ifdef ESP32
   // Mix some impact sound based on user-initiated motions while firing.
-  if(gpstarWand.inStreamMode(PROTON) && !b_firing_cross_streams && b_stream_effects && filteredMotionData.shaken) {
+  if(gpstarWand.inStreamMode(PROTON) && !b_firing_cross_streams && b_stream_effects && motionResults.filtered.shaken) {
     // Only play impact sound if firing, in Proton mode, and threshold exceeded.
     uint8_t i_random_effect = getRandomFiringEffect(); // Use last-played effect to choose another.
     switch(i_random_effect) {
@@ -7560,10 +4928,10 @@ void modeFiring() {
 
   if(!gpstarWand.inStreamMode(MESON)) {
     // Meson does not use "stream start" to make its pulse effect.
-    fireStreamStart(getHueColour(c_temp_start, WAND_BARREL_LED_COUNT));
+    fireStreamStart(getBarrelColour(c_temp_start));
   }
 
-  fireStreamEffect(getHueColour(c_temp_effect, WAND_BARREL_LED_COUNT));
+  fireStreamEffect(getBarrelColour(c_temp_effect));
 
   // Bargraph loop / scroll.
   if(ms_bargraph_firing.justFinished()) {
@@ -7861,563 +5229,164 @@ void wandBarrelHeatUp() {
         c_temp = C_REDGREEN;
       break;
 
-      case SPECTRAL_CUSTOM:
-        c_temp = C_CUSTOM;
-      break;
-    }
-
-    switch(WAND_BARREL_LED_COUNT) {
-      case LEDS_50:
-        barrel_leds[i_barrel_led] = getHueColour(c_temp, WAND_BARREL_LED_COUNT, i_heatup_counter);
-        barrel_leds[i_barrel_led - 1] = getHueColour(c_temp, WAND_BARREL_LED_COUNT, i_heatup_counter);
-        barrel_leds[i_barrel_led - 2] = getHueColour(c_temp, WAND_BARREL_LED_COUNT, i_heatup_counter);
-        barrel_leds[i_barrel_led - 3] = getHueColour(c_temp, WAND_BARREL_LED_COUNT, i_heatup_counter);
-        barrel_leds[i_barrel_led + 1] = getHueColour(c_temp, WAND_BARREL_LED_COUNT, i_heatup_counter);
-        barrel_leds[i_barrel_led + 2] = getHueColour(c_temp, WAND_BARREL_LED_COUNT, i_heatup_counter);
-      break;
-
-      case LEDS_48:
-        barrel_leds[i_barrel_led] = getHueColour(c_temp, WAND_BARREL_LED_COUNT, i_heatup_counter);
-        barrel_leds[i_barrel_led - 23] = getHueColour(c_temp, WAND_BARREL_LED_COUNT, i_heatup_counter);
-        barrel_leds[i_barrel_led - 24] = getHueColour(c_temp, WAND_BARREL_LED_COUNT, i_heatup_counter);
-        barrel_leds[i_barrel_led - 25] = getHueColour(c_temp, WAND_BARREL_LED_COUNT, i_heatup_counter);
-        barrel_leds[i_barrel_led + 1] = getHueColour(c_temp, WAND_BARREL_LED_COUNT, i_heatup_counter);
-      break;
-
-      case LEDS_2:
-        barrel_leds[i_barrel_led] = getHueColour(c_temp, WAND_BARREL_LED_COUNT, i_heatup_counter);
-        barrel_leds[i_barrel_led + 1] = getHueColour(c_temp, WAND_BARREL_LED_COUNT, i_heatup_counter);
-      break;
-
-      case LEDS_5:
-      default:
-        barrel_leds[i_barrel_led] = getHueColour(c_temp, WAND_BARREL_LED_COUNT, i_heatup_counter);
-      break;
-    }
-
-    i_heatup_counter++;
-    ms_wand_heatup_fade.start(i_delay_heatup);
-  }
-}
-
-void barrelLEDTranslation(uint8_t id, colours colour) {
-  if(WAND_BARREL_LED_COUNT == LEDS_5 || WAND_BARREL_LED_COUNT == LEDS_2) {
-    barrel_leds[id] = getHueColour(colour, WAND_BARREL_LED_COUNT);
-    return;
-  }
-  else if(WAND_BARREL_LED_COUNT == LEDS_48) {
-    switch(id) {
-      case 0:
-        // Translate to first three rows of LEDs.
-        for(uint8_t i = 0; i < 12; i++) {
-          barrel_leds[PROGMEM_READU8(frutto_barrel[i])] = getHueColour(colour, WAND_BARREL_LED_COUNT);
-        }
-      break;
-
-      case 1:
-        // Translate to rows 4 and 5 of the LED array.
-        for(uint8_t i = 12; i < 20; i++) {
-          barrel_leds[PROGMEM_READU8(frutto_barrel[i])] = getHueColour(colour, WAND_BARREL_LED_COUNT);
-        }
-      break;
-
-      case 2:
-        // Translate to rows 6 and 7 of the LED array.
-        for(uint8_t i = 20; i < 28; i++) {
-          barrel_leds[PROGMEM_READU8(frutto_barrel[i])] = getHueColour(colour, WAND_BARREL_LED_COUNT);
-        }
-      break;
-
-      case 3:
-        // Translate to rows 8 and 9 of the LED array.
-        for(uint8_t i = 28; i < 36; i++) {
-          barrel_leds[PROGMEM_READU8(frutto_barrel[i])] = getHueColour(colour, WAND_BARREL_LED_COUNT);
-        }
-      break;
-
-      case 4:
-        // Translate to the last three rows of LEDs.
-        for(uint8_t i = 36; i < 48; i++) {
-          barrel_leds[PROGMEM_READU8(frutto_barrel[i])] = getHueColour(colour, WAND_BARREL_LED_COUNT);
-        }
-      break;
-
-      default:
-        // Do nothing.
-      break;
-    }
-  }
-  else if(WAND_BARREL_LED_COUNT == LEDS_50) {
-    switch(id) {
-      case 0:
-        // Translate to first three rows of LEDs.
-        for(uint8_t i = 0; i < 12; i++) {
-          barrel_leds[PROGMEM_READU8(gpstar_neutrona_barrel[i])] = getHueColour(colour, WAND_BARREL_LED_COUNT);
-        }
-      break;
-
-      case 1:
-        // Translate to rows 4 and 5 of the LED array.
-        for(uint8_t i = 12; i < 20; i++) {
-          barrel_leds[PROGMEM_READU8(gpstar_neutrona_barrel[i])] = getHueColour(colour, WAND_BARREL_LED_COUNT);
-        }
-      break;
-
-      case 2:
-        // Translate to rows 6 and 7 of the LED array.
-        for(uint8_t i = 20; i < 28; i++) {
-          barrel_leds[PROGMEM_READU8(gpstar_neutrona_barrel[i])] = getHueColour(colour, WAND_BARREL_LED_COUNT);
-        }
-      break;
-
-      case 3:
-        // Translate to rows 8 and 9 of the LED array.
-        for(uint8_t i = 28; i < 36; i++) {
-          barrel_leds[PROGMEM_READU8(gpstar_neutrona_barrel[i])] = getHueColour(colour, WAND_BARREL_LED_COUNT);
-        }
-      break;
-
-      case 4:
-        // Translate to the last three rows of LEDs.
-        for(uint8_t i = 36; i < 48; i++) {
-          barrel_leds[PROGMEM_READU8(gpstar_neutrona_barrel[i])] = getHueColour(colour, WAND_BARREL_LED_COUNT);
-        }
-      break;
-
-      default:
-        // Do nothing.
-      break;
-    }
-  }
-}
-
-void firePulseEffect() {
-  if(i_pulse_step < 1) {
-    // Play bargraph animation when pulse sequence begins.
-    switch(BARGRAPH_MODE) {
-      case BARGRAPH_ORIGINAL:
-        // Need to restart the regular bargraph timer.
-        i_bargraph_status = gpstarWand.getPowerLevel() - 1;
-        i_bargraph_status_alt = 0;
-
-        switch(BARGRAPH_FIRING_ANIMATION) {
-          case BARGRAPH_ANIMATION_ORIGINAL:
-            // Reset and redraw all the proper segments for the bargraph.
-            bargraphRedraw();
-
-            // Restart the bargraph idling loop.
-            bargraphPowerCheck();
-          break;
-
-          case BARGRAPH_ANIMATION_SUPER_HERO:
-          default:
-            bargraphClearAlt();
-
-            i_bargraph_multiplier_current = i_bargraph_multiplier_ramp_2021 / 3;
-
-            bargraphRamp();
-          break;
-        }
-      break;
-
-      case BARGRAPH_SUPER_HERO:
-      default:
-        i_bargraph_status = gpstarWand.getPowerLevel() - 1;
-        i_bargraph_status_alt = 0;
-        bargraphClearAlt();
-
-        i_bargraph_multiplier_current = i_bargraph_multiplier_ramp_1984;
-
-        // We ramp the bargraph back up after finishing firing.
-        bargraphRamp();
-      break;
-    }
-
-    // Turn on hat light 1.
-    digitalWriteFast(BARREL_HAT_LED_PIN, HIGH);
-  }
-
-  if(gpstarWand.inStreamMode(SLIME)) {
-    ms_firing_stream_effects.start(0); // Start new barrel animation.
-
-    // Draw first pixel.
-    if(getSystemYearMode() == SYSTEM_1989) {
-      fireStreamEffect(getHueColour(C_WHITE, WAND_BARREL_LED_COUNT));
-    }
-    else {
-      fireStreamEffect(getHueColour(C_GREEN, WAND_BARREL_LED_COUNT));
-    }
-
-    ms_firing_effect_end.start(0); // Immediately end animation.
-    i_pulse_step = 14; // Immediately go to end of sequence.
-  }
-
-  uint8_t i_firing_pulse_tmp = i_firing_pulse; // Stores a calculated value based on firing mode.
-
-  switch(i_pulse_step) {
-    case 0:
-      switch(gpstarWand.getStreamMode()) {
-        case PROTON:
-          // Boson Dart.
-          barrelLEDTranslation(0, C_RED);
-        break;
-
-        case STASIS:
-          // Shock Blast.
-          barrelLEDTranslation(0, C_NAVY_BLUE);
-        break;
-
-        case MESON:
-          // Meson Collider.
-          barrelLEDTranslation(0, C_YELLOW);
-        break;
-
-        default:
-          // Do nothing.
-        break;
-      }
-    break;
-
-    case 1:
-      switch(gpstarWand.getStreamMode()) {
-        case PROTON:
-          // Boson Dart.
-          barrelLEDTranslation(0, C_RED2);
-          barrelLEDTranslation(1, C_RED);
-        break;
-
-        case STASIS:
-          // Shock Blast.
-          barrelLEDTranslation(0, C_MID_BLUE);
-        break;
-
-        case MESON:
-          // Meson Collider.
-          barrelLEDTranslation(0, C_ORANGE);
-        break;
-
-        default:
-          // Do nothing.
-        break;
-      }
-    break;
-
-    case 2:
-      switch(gpstarWand.getStreamMode()) {
-        case PROTON:
-          // Boson Dart.
-          barrelLEDTranslation(0, C_WHITE);
-          barrelLEDTranslation(1, C_RED2);
-          barrelLEDTranslation(2, C_RED);
-        break;
-
-        case STASIS:
-          // Shock Blast.
-          barrelLEDTranslation(0, C_LIGHT_BLUE);
-          barrelLEDTranslation(1, C_NAVY_BLUE);
-        break;
-
-        case MESON:
-          // Meson Collider.
-          barrelLEDTranslation(0, C_RED4);
-          barrelLEDTranslation(1, C_YELLOW);
-        break;
-
-        default:
-          // Do nothing.
-        break;
-      }
-    break;
-
-    case 3:
-      switch(gpstarWand.getStreamMode()) {
-        case PROTON:
-          // Boson Dart.
-          barrelLEDTranslation(0, C_RED2);
-          barrelLEDTranslation(1, C_WHITE);
-          barrelLEDTranslation(2, C_RED2);
-          barrelLEDTranslation(3, C_RED);
-        break;
-
-        case STASIS:
-          // Shock Blast.
-          barrelLEDTranslation(0, C_BLUE);
-          barrelLEDTranslation(1, C_MID_BLUE);
-        break;
-
-        case MESON:
-          // Meson Collider.
-          barrelLEDTranslation(0, C_RED2);
-          barrelLEDTranslation(1, C_ORANGE);
-        break;
-
-        default:
-          // Do nothing.
-        break;
-      }
-    break;
-
-    case 4:
-      switch(gpstarWand.getStreamMode()) {
-        case PROTON:
-          // Boson Dart.
-          barrelLEDTranslation(0, C_RED);
-          barrelLEDTranslation(1, C_RED2);
-          barrelLEDTranslation(2, C_WHITE);
-          barrelLEDTranslation(3, C_RED2);
-          barrelLEDTranslation(4, C_RED);
-
-          // Bolt has reached barrel tip, so turn on tip light.
-          wandTipOn();
-        break;
-
-        case STASIS:
-          // Shock Blast.
-          barrelLEDTranslation(0, C_WHITE);
-          barrelLEDTranslation(1, C_LIGHT_BLUE);
-          barrelLEDTranslation(2, C_NAVY_BLUE);
-        break;
-
-        case MESON:
-          // Meson Collider.
-          barrelLEDTranslation(0, C_RED);
-          barrelLEDTranslation(1, C_RED4);
-          barrelLEDTranslation(2, C_YELLOW);
-        break;
-
-        default:
-          // Do nothing.
-        break;
-      }
-    break;
-
-    case 5:
-      switch(gpstarWand.getStreamMode()) {
-        case PROTON:
-          // Boson Dart.
-          barrelLEDTranslation(0, C_BLACK);
-          barrelLEDTranslation(1, C_RED);
-          barrelLEDTranslation(2, C_RED2);
-          barrelLEDTranslation(3, C_WHITE);
-          barrelLEDTranslation(4, C_RED2);
-        break;
-
-        case STASIS:
-          // Shock Blast.
-          barrelLEDTranslation(0, C_BLACK);
-          barrelLEDTranslation(1, C_BLUE);
-          barrelLEDTranslation(2, C_MID_BLUE);
-        break;
-
-        case MESON:
-          // Meson Collider.
-          barrelLEDTranslation(0, C_BLACK);
-          barrelLEDTranslation(1, C_RED2);
-          barrelLEDTranslation(2, C_ORANGE);
-        break;
-
-        default:
-          // Do nothing.
-        break;
-      }
-    break;
-
-    case 6:
-      switch(gpstarWand.getStreamMode()) {
-        case PROTON:
-          // Boson Dart.
-          barrelLEDTranslation(1, C_BLACK);
-          barrelLEDTranslation(2, C_RED);
-          barrelLEDTranslation(3, C_RED2);
-          barrelLEDTranslation(4, C_WHITE);
-        break;
-
-        case STASIS:
-          // Shock Blast.
-          barrelLEDTranslation(1, C_WHITE);
-          barrelLEDTranslation(2, C_LIGHT_BLUE);
-          barrelLEDTranslation(3, C_NAVY_BLUE);
-        break;
+      case SPECTRAL_CUSTOM:
+        c_temp = C_CUSTOM;
+      break;
+    }
 
-        case MESON:
-          // Meson Collider.
-          barrelLEDTranslation(1, C_RED);
-          barrelLEDTranslation(2, C_RED4);
-          barrelLEDTranslation(3, C_YELLOW);
-        break;
+    switch(WAND_BARREL_LED_COUNT) {
+      case LEDS_50:
+        barrel_leds[i_barrel_led] = getHueColour(c_temp, WAND_BARREL_LED_COUNT, i_heatup_counter);
+        barrel_leds[i_barrel_led - 1] = getHueColour(c_temp, WAND_BARREL_LED_COUNT, i_heatup_counter);
+        barrel_leds[i_barrel_led - 2] = getHueColour(c_temp, WAND_BARREL_LED_COUNT, i_heatup_counter);
+        barrel_leds[i_barrel_led - 3] = getHueColour(c_temp, WAND_BARREL_LED_COUNT, i_heatup_counter);
+        barrel_leds[i_barrel_led + 1] = getHueColour(c_temp, WAND_BARREL_LED_COUNT, i_heatup_counter);
+        barrel_leds[i_barrel_led + 2] = getHueColour(c_temp, WAND_BARREL_LED_COUNT, i_heatup_counter);
+      break;
 
-        default:
-          // Do nothing.
-        break;
-      }
-    break;
+      case LEDS_48:
+        barrel_leds[i_barrel_led] = getHueColour(c_temp, WAND_BARREL_LED_COUNT, i_heatup_counter);
+        barrel_leds[i_barrel_led - 23] = getHueColour(c_temp, WAND_BARREL_LED_COUNT, i_heatup_counter);
+        barrel_leds[i_barrel_led - 24] = getHueColour(c_temp, WAND_BARREL_LED_COUNT, i_heatup_counter);
+        barrel_leds[i_barrel_led - 25] = getHueColour(c_temp, WAND_BARREL_LED_COUNT, i_heatup_counter);
+        barrel_leds[i_barrel_led + 1] = getHueColour(c_temp, WAND_BARREL_LED_COUNT, i_heatup_counter);
+      break;
 
-    case 7:
-      switch(gpstarWand.getStreamMode()) {
-        case PROTON:
-          // Boson Dart.
-          barrelLEDTranslation(2, C_BLACK);
-          barrelLEDTranslation(3, C_RED);
-          barrelLEDTranslation(4, C_RED2);
-        break;
+      case LEDS_2:
+        barrel_leds[i_barrel_led] = getHueColour(c_temp, WAND_BARREL_LED_COUNT, i_heatup_counter);
+        barrel_leds[i_barrel_led + 1] = getHueColour(c_temp, WAND_BARREL_LED_COUNT, i_heatup_counter);
+      break;
 
-        case STASIS:
-          // Shock Blast.
-          barrelLEDTranslation(1, C_BLACK);
-          barrelLEDTranslation(2, C_BLUE);
-          barrelLEDTranslation(3, C_MID_BLUE);
-        break;
+      case LEDS_5:
+      default:
+        barrel_leds[i_barrel_led] = getHueColour(c_temp, WAND_BARREL_LED_COUNT, i_heatup_counter);
+      break;
+    }
 
-        case MESON:
-          // Meson Collider.
-          barrelLEDTranslation(1, C_BLACK);
-          barrelLEDTranslation(2, C_RED2);
-          barrelLEDTranslation(3, C_ORANGE);
-        break;
+    i_heatup_counter++;
+    ms_wand_heatup_fade.start(i_delay_heatup);
+  }
+}
 
-        default:
-          // Do nothing.
-        break;
-      }
-    break;
+// Starts the pulse for the stream mode, taking its shades from the palette.
+void firePulseStart() {
+  const uint8_t* i_shades = nullptr;
+  const BarrelPulseParams* params = nullptr;
 
-    case 8:
-      switch(gpstarWand.getStreamMode()) {
-        case PROTON:
-          // Boson Dart.
-          barrelLEDTranslation(3, C_BLACK);
-          barrelLEDTranslation(4, C_RED);
-        break;
+  switch(gpstarWand.getStreamMode()) {
+    case PROTON:
+      // Boson Dart.
+      i_shades = i_pulse_shades_boson_dart;
+      params = &BARREL_PULSE_BOSON_DART;
+    break;
 
-        case STASIS:
-          // Shock Blast.
-          barrelLEDTranslation(2, C_WHITE);
-          barrelLEDTranslation(3, C_LIGHT_BLUE);
-          barrelLEDTranslation(4, C_NAVY_BLUE);
+    case STASIS:
+      // Shock Blast.
+      i_shades = i_pulse_shades_shock_blast;
+      params = &BARREL_PULSE_SHOCK_BLAST;
+    break;
 
-          // Pulse has reached tip, so turn tip light on.
-          wandTipOn();
-        break;
+    case MESON:
+      // Meson Collider.
+      i_shades = i_pulse_shades_meson_collider;
+      params = &BARREL_PULSE_MESON_COLLIDER;
+    break;
 
-        case MESON:
-          // Meson Collider.
-          barrelLEDTranslation(2, C_RED);
-          barrelLEDTranslation(3, C_RED4);
-          barrelLEDTranslation(4, C_YELLOW);
+    default:
+      // Do nothing.
+      barrel_pulse.stop();
+      return;
+    break;
+  }
 
-          // Pulse has reached tip, so turn tip light on.
-          wandTipOn();
-        break;
+  BarrelColour c_shades[BARREL_PULSE_SHADES];
 
-        default:
-          // Do nothing.
-        break;
-      }
-    break;
+  for(uint8_t i = 0; i < BARREL_PULSE_SHADES; i++) {
+    c_shades[i] = barrel_palette.get(PROGMEM_READU8(i_shades[i]));
+  }
 
-    case 9:
-      switch(gpstarWand.getStreamMode()) {
-        case PROTON:
-          // Boson Dart.
-          barrelLEDTranslation(4, C_BLACK);
-          i_pulse_step = 14; // Immediately end.
-        break;
+  barrel_pulse.start(params, c_shades);
+}
 
-        case STASIS:
-          // Shock Blast.
-          barrelLEDTranslation(2, C_BLACK);
-          barrelLEDTranslation(3, C_BLUE);
-          barrelLEDTranslation(4, C_MID_BLUE);
-        break;
+void firePulseEffect() {
+  if(i_pulse_step < 1) {
+    // Pick up any change of barrel or custom colour.
+    barrel_palette.invalidate();
 
-        case MESON:
-          // Meson Collider.
-          barrelLEDTranslation(2, C_BLACK);
-          barrelLEDTranslation(3, C_RED2);
-          barrelLEDTranslation(4, C_ORANGE);
-        break;
+    // Play bargraph animation when pulse sequence begins.
+    switch(BARGRAPH_MODE) {
+      case BARGRAPH_ORIGINAL:
+        // Need to restart the regular bargraph timer.
+        i_bargraph_status = gpstarWand.getPowerLevel() - 1;
+        i_bargraph_status_alt = 0;
 
-        default:
-          // Do nothing.
-        break;
-      }
-    break;
+        switch(BARGRAPH_FIRING_ANIMATION) {
+          case BARGRAPH_ANIMATION_ORIGINAL:
+            // Reset and redraw all the proper segments for the bargraph.
+            bargraphRedraw();
 
-    case 10:
-      switch(gpstarWand.getStreamMode()) {
-        case STASIS:
-          // Shock Blast.
-          barrelLEDTranslation(3, C_WHITE);
-          barrelLEDTranslation(4, C_LIGHT_BLUE);
-        break;
+            // Restart the bargraph idling loop.
+            bargraphPowerCheck();
+          break;
 
-        case MESON:
-          // Meson Collider.
-          barrelLEDTranslation(3, C_RED);
-          barrelLEDTranslation(4, C_RED4);
-        break;
+          case BARGRAPH_ANIMATION_SUPER_HERO:
+          default:
+            bargraphClearAlt();
 
-        default:
-          // Do nothing.
-        break;
-      }
-    break;
+            i_bargraph_multiplier_current = i_bargraph_multiplier_ramp_2021 / 3;
 
-    case 11:
-      switch(gpstarWand.getStreamMode()) {
-        case STASIS:
-          // Shock Blast.
-          barrelLEDTranslation(3, C_BLACK);
-          barrelLEDTranslation(4, C_BLUE);
-        break;
+            bargraphRamp();
+          break;
+        }
+      break;
 
-        case MESON:
-          // Meson Collider.
-          barrelLEDTranslation(3, C_BLACK);
-          barrelLEDTranslation(4, C_RED2);
-        break;
+      case BARGRAPH_SUPER_HERO:
+      default:
+        i_bargraph_status = gpstarWand.getPowerLevel() - 1;
+        i_bargraph_status_alt = 0;
+        bargraphClearAlt();
 
-        default:
-          // Do nothing.
-        break;
-      }
-    break;
+        i_bargraph_multiplier_current = i_bargraph_multiplier_ramp_1984;
 
-    case 12:
-      switch(gpstarWand.getStreamMode()) {
-        case STASIS:
-          // Shock Blast.
-          barrelLEDTranslation(4, C_WHITE);
-        break;
+        // We ramp the bargraph back up after finishing firing.
+        bargraphRamp();
+      break;
+    }
 
-        case MESON:
-          // Meson Collider.
-          barrelLEDTranslation(4, C_RED);
-        break;
+    // Turn on hat light 1.
+    digitalWriteFast(BARREL_HAT_LED_PIN, HIGH);
+  }
 
-        default:
-          // Do nothing.
-        break;
-      }
-    break;
+  if(gpstarWand.inStreamMode(SLIME)) {
+    ms_firing_stream_effects.start(0); // Start new barrel animation.
 
-    case 13:
-      barrelLEDTranslation(4, C_BLACK);
-    break;
+    // Draw first pixel.
+    if(getSystemYearMode() == SYSTEM_1989) {
+      fireStreamEffect(getBarrelColour(C_WHITE));
+    }
+    else {
+      fireStreamEffect(getBarrelColour(C_GREEN));
+    }
 
-    default:
-      // Do nothing if we somehow end up here.
-    break;
+    ms_firing_effect_end.start(0); // Immediately end animation.
+    barrel_pulse.stop(); // Immediately go to end of sequence.
+  }
+  else if(i_pulse_step < 1) {
+    firePulseStart();
   }
 
+  BarrelStrip strip = getBarrelStrip();
+  barrel_pulse.step(strip);
   i_pulse_step++;
 
-  if(i_pulse_step < 14) {
-    if(gpstarWand.inStreamMode(PROTON)) {
-      // Boson Dart is much slower than the others.
-      i_firing_pulse_tmp *= 2;
-    }
-    ms_firing_pulse.start(i_firing_pulse_tmp);
+  if(barrel_pulse.atTip()) {
+    // Pulse has reached the tip, so turn the tip light on.
+    wandTipOn();
+  }
+
+  if(barrel_pulse.isRunning()) {
+    // The Boson Dart is much slower than the others.
+    ms_firing_pulse.start(barrel_pulse.getStepTime());
   }
   else {
     // Animation has concluded, so reset our timer and variable.
@@ -8545,7 +5514,7 @@ void fireEffectEnd() {
       break;
     }
 
-    fireStreamEffect(getHueColour(c_temp, WAND_BARREL_LED_COUNT));
+    fireStreamEffect(getBarrelColour(c_temp));
 
     if(i_barrel_light < i_num_barrel_leds) {
       ms_firing_effect_end.repeat();
@@ -8646,116 +5615,16 @@ void fireEffectEnd() {
         break;
       }
 
-      ms_firing_effect_end.start(i_firing_stream_tmp);
-      ms_firing_stream_effects.stop();
-    }
-  }
-  else {
-    switch(gpstarWand.getStreamMode()) {
-      case PROTON:
-      default:
-        if(b_firing_cross_streams) {
-          if(isBrassPack()) {
-            c_temp = C_CHARTREUSE;
-          }
-          else {
-            c_temp = C_WHITE;
-          }
-        }
-        else if(getSystemYearMode() == SYSTEM_1989) {
-          // Shift the stream from orange to red on higher power levels.
-          switch(gpstarWand.getPowerLevel()) {
-            case LEVEL_1:
-              c_temp = C_RED5;
-            break;
-
-            case LEVEL_2:
-              c_temp = C_RED4;
-            break;
-
-            case LEVEL_3:
-              c_temp = C_RED3;
-            break;
-
-            case LEVEL_4:
-              c_temp = C_RED2;
-            break;
-
-            case LEVEL_5:
-            default:
-              c_temp = C_RED;
-            break;
-          }
-        }
-        else {
-          // Shift the stream from red to orange on higher power levels.
-          switch(gpstarWand.getPowerLevel()) {
-            case LEVEL_1:
-              c_temp = C_RED;
-            break;
-
-            case LEVEL_2:
-              c_temp = C_RED2;
-            break;
-
-            case LEVEL_3:
-              c_temp = C_RED3;
-            break;
-
-            case LEVEL_4:
-              c_temp = C_RED4;
-            break;
-
-            case LEVEL_5:
-            default:
-              c_temp = C_RED5;
-            break;
-          }
-        }
-      break;
-
-      case SLIME:
-        if(getSystemYearMode() == SYSTEM_1989) {
-          c_temp = C_PASTEL_PINK;
-        }
-        else {
-          c_temp = C_DARK_GREEN;
-        }
-      break;
-
-      case STASIS:
-        c_temp = C_BLUE;
-      break;
-
-      case MESON:
-      case SPECTRAL:
-      case HOLIDAY_HALLOWEEN:
-      case HOLIDAY_CHRISTMAS:
-        c_temp = C_BLACK;
-      break;
-
-      case SPECTRAL_CUSTOM:
-        c_temp = C_CUSTOM;
-      break;
-    }
-
-    switch(WAND_BARREL_LED_COUNT) {
-      case LEDS_50:
-        // Set the final LED back to whatever colour it is without the effect.
-        barrel_leds[PROGMEM_READU8(gpstar_neutrona_barrel[i_barrel_light - 1])] = getHueColour(c_temp, WAND_BARREL_LED_COUNT);
-      break;
-
-      case LEDS_48:
-        // Set the final LED back to whatever colour it is without the effect.
-        barrel_leds[PROGMEM_READU8(frutto_barrel[i_barrel_light - 1])] = getHueColour(c_temp, WAND_BARREL_LED_COUNT);
-      break;
-
-      case LEDS_5:
-      case LEDS_2:
-      default:
-        // Set the final LED back to whatever colour it is without the effect.
-        barrel_leds[i_barrel_light - 1] = getHueColour(c_temp, WAND_BARREL_LED_COUNT);
-      break;
+      ms_firing_effect_end.start(i_firing_stream_tmp);
+      ms_firing_stream_effects.stop();
+    }
+  }
+  else {
+    // Set the final LED back to whatever colour it is without the effect.
+    BarrelStrip strip = getBarrelStrip();
+
+    if(i_barrel_light > 0) {
+      strip.set(i_barrel_light - 1, barrel_palette.get(getStreamTrailColour()));
     }
 
     i_barrel_light = 0;
@@ -9050,747 +5919,212 @@ void overheatTimerDecrement(uint8_t i_tmp_power_level) {
   }
 }
 
-// Top rotary dial on the wand.
-void checkRotaryEncoder() {
-  if(readRotary() != 0) {
-    // Only continue if the limiter has expired.
-    if(ms_rotary_encoder.remaining() > 0) {
-      return;
+// Change colour of the wand barrel spectral custom colour.
+void spectralWandCustomDecrease() {
+  if(i_spectral_wand_custom_colour > 1 && i_spectral_wand_custom_saturation > 253) {
+    i_spectral_wand_custom_colour--;
+  }
+  else {
+    i_spectral_wand_custom_colour = 1;
+
+    if(i_spectral_wand_custom_saturation > 1) {
+      i_spectral_wand_custom_saturation--;
     }
     else {
-      ms_rotary_encoder.start(i_rotary_encoder_delay);
+      i_spectral_wand_custom_saturation = 1;
     }
+  }
 
-    switch(WAND_ACTION_STATUS) {
-      case ACTION_CONFIG_EEPROM_MENU:
-        // Counter clockwise.
-        if(prev_next_code == 0x0b) {
-          if(WAND_MENU_LEVEL == MENU_LEVEL_3 && i_wand_menu == 5 && switch_intensify.isLongPressed() && !switch_mode.on()) {
-            if(b_wand_standalone || VOLUME_ADJUST_DEVICE == VOLUME_NEUTRONA_WAND) {
-              // Adjust Neutrona Wand default startup volume.
-              decreaseVolumeEEPROM();
-            }
-            else {
-              // Adjust Proton Pack default startup volume.
-              wandSerialSend(W_VOLUME_DECREASE_EEPROM);
-            }
-          }
-          else if(WAND_MENU_LEVEL == MENU_LEVEL_4 && i_wand_menu == 5 && switch_intensify.on() && !switch_mode.on()) {
-            wandSerialSend(W_OVERHEAT_DECREASE_LEVEL_5);
-          }
-          else if(WAND_MENU_LEVEL == MENU_LEVEL_4 && i_wand_menu == 4 && switch_intensify.on() && !switch_mode.on()) {
-            wandSerialSend(W_OVERHEAT_DECREASE_LEVEL_4);
-          }
-          else if(WAND_MENU_LEVEL == MENU_LEVEL_4 && i_wand_menu == 3 && switch_intensify.on() && !switch_mode.on()) {
-            wandSerialSend(W_OVERHEAT_DECREASE_LEVEL_3);
-          }
-          else if(WAND_MENU_LEVEL == MENU_LEVEL_4 && i_wand_menu == 2 && switch_intensify.on() && !switch_mode.on()) {
-            wandSerialSend(W_OVERHEAT_DECREASE_LEVEL_2);
-          }
-          else if(WAND_MENU_LEVEL == MENU_LEVEL_4 && i_wand_menu == 1 && switch_intensify.on() && !switch_mode.on()) {
-            wandSerialSend(W_OVERHEAT_DECREASE_LEVEL_1);
-          }
-          else if(WAND_MENU_LEVEL == MENU_LEVEL_4 && i_wand_menu == 5 && !switch_intensify.on() && switch_mode.on()) {
-            overheatTimerDecrement(5);
-          }
-          else if(WAND_MENU_LEVEL == MENU_LEVEL_4 && i_wand_menu == 4 && !switch_intensify.on() && switch_mode.on()) {
-            overheatTimerDecrement(4);
-          }
-          else if(WAND_MENU_LEVEL == MENU_LEVEL_4 && i_wand_menu == 3 && !switch_intensify.on() && switch_mode.on()) {
-            overheatTimerDecrement(3);
-          }
-          else if(WAND_MENU_LEVEL == MENU_LEVEL_4 && i_wand_menu == 2 && !switch_intensify.on() && switch_mode.on()) {
-            overheatTimerDecrement(2);
-          }
-          else if(WAND_MENU_LEVEL == MENU_LEVEL_4 && i_wand_menu == 1 && !switch_intensify.on() && switch_mode.on()) {
-            overheatTimerDecrement(1);
-          }
-          else if(i_wand_menu - 1 < 1) {
-            switch(WAND_MENU_LEVEL) {
-              case MENU_LEVEL_1:
-                WAND_MENU_LEVEL = MENU_LEVEL_2;
-                i_wand_menu = 5;
-
-                // Turn on some lights to visually indicate which menu we are in.
-                digitalWriteFast(SLO_BLO_LED_PIN, HIGH); // Level 2
-
-                // Turn off the other lights.
-                ventLightControl(0); // Level 3
-                ventTopLightControl(false); // Level 4
-                digitalWriteFast(CLIPPARD_LED_PIN, LOW); // Level 5
-
-                // Play an indication beep to notify we have changed menu levels.
-                stopEffect(S_BEEPS);
-                playEffect(S_BEEPS);
-
-                stopEffect(S_LEVEL_1);
-                stopEffect(S_LEVEL_2);
-                stopEffect(S_LEVEL_3);
-                stopEffect(S_LEVEL_4);
-                stopEffect(S_LEVEL_5);
-
-                playEffect(S_LEVEL_2);
-
-                // Tell the Proton Pack to play some sounds.
-                wandSerialSend(W_MENU_LEVEL_2);
-              break;
-
-              case MENU_LEVEL_2:
-                WAND_MENU_LEVEL = MENU_LEVEL_3;
-                i_wand_menu = 5;
-
-                // Turn on some lights to visually indicate which menu we are in.
-                digitalWriteFast(SLO_BLO_LED_PIN, HIGH); // Level 2
-                ventLightControl(); // Level 3
-
-                // Turn off the other lights.
-                ventTopLightControl(false); // Level 4
-                digitalWriteFast(CLIPPARD_LED_PIN, LOW); // Level 5
-
-                // Play an indication beep to notify we have changed menu levels.
-                stopEffect(S_BEEPS);
-                playEffect(S_BEEPS);
-
-                stopEffect(S_LEVEL_1);
-                stopEffect(S_LEVEL_2);
-                stopEffect(S_LEVEL_3);
-                stopEffect(S_LEVEL_4);
-                stopEffect(S_LEVEL_5);
-
-                playEffect(S_LEVEL_3);
-
-                // Tell the Proton Pack to play some sounds.
-                wandSerialSend(W_MENU_LEVEL_3);
-              break;
-
-              case MENU_LEVEL_3:
-                WAND_MENU_LEVEL = MENU_LEVEL_4;
-                i_wand_menu = 5;
+  wandBarrelSpectralCustomConfigOn();
+}
 
-                // Turn on some lights to visually indicate which menu we are in.
-                digitalWriteFast(SLO_BLO_LED_PIN, HIGH); // Level 2
-                ventLightControl(); // Level 3
-                ventTopLightControl(true); // Level 4
+void spectralWandCustomIncrease() {
+  if(i_spectral_wand_custom_saturation < 254) {
+    i_spectral_wand_custom_saturation++;
 
-                // Turn off the other lights.
-                digitalWriteFast(CLIPPARD_LED_PIN, LOW); // Level 5
+    if(i_spectral_wand_custom_saturation > 253) {
+      i_spectral_wand_custom_saturation = 254;
+    }
+  }
+  else if(i_spectral_wand_custom_colour < 253 && i_spectral_wand_custom_saturation > 253) {
+    i_spectral_wand_custom_colour++;
+  }
+  else {
+    i_spectral_wand_custom_colour = 254;
 
-                // Play an indication beep to notify we have changed menu levels.
-                stopEffect(S_BEEPS);
-                playEffect(S_BEEPS);
+    if(i_spectral_wand_custom_saturation < 253) {
+      i_spectral_wand_custom_saturation++;
+    }
+    else {
+      i_spectral_wand_custom_saturation = 254;
+    }
+  }
 
-                stopEffect(S_LEVEL_1);
-                stopEffect(S_LEVEL_2);
-                stopEffect(S_LEVEL_3);
-                stopEffect(S_LEVEL_4);
-                stopEffect(S_LEVEL_5);
+  wandBarrelSpectralCustomConfigOn();
+}
 
-                playEffect(S_LEVEL_4);
+// Conditions which the menu tree nodes may be guarded by.
+uint16_t wandMenuState() {
+  uint16_t i_state = 0;
 
-                // Tell the Proton Pack to play some sounds.
-                wandSerialSend(W_MENU_LEVEL_4);
-              break;
+  i_state |= switch_intensify.on() ? MENU_GUARD_INTENSIFY_ON : MENU_GUARD_INTENSIFY_OFF;
+  i_state |= switch_intensify.isLongPressed() ? MENU_GUARD_INTENSIFY_LONG : 0;
+  i_state |= switch_mode.on() ? MENU_GUARD_MODE_ON : MENU_GUARD_MODE_OFF;
+  i_state |= switch_mode.isLongPressed() ? MENU_GUARD_MODE_LONG : 0;
+  i_state |= (b_playing_music && !b_music_paused) ? MENU_GUARD_MUSIC_PLAYING : 0;
+  i_state |= (b_wand_standalone || VOLUME_ADJUST_DEVICE == VOLUME_NEUTRONA_WAND) ? MENU_GUARD_WAND_VOLUME : MENU_GUARD_PACK_VOLUME;
 
-              case MENU_LEVEL_4:
-                WAND_MENU_LEVEL = MENU_LEVEL_5;
-                i_wand_menu = 5;
+  // Menu levels only change when the Proton Pack is powered down.
+  if((!b_pack_on && !b_pack_shutting_down) || (b_wand_standalone && WAND_STATUS == MODE_OFF)) {
+    i_state |= MENU_GUARD_LEVELS_UNLOCKED;
+  }
 
-                // Turn on some lights to visually indicate which menu we are in.
-                digitalWriteFast(SLO_BLO_LED_PIN, HIGH); // Level 2
-                ventLightControl(); // Level 3
-                ventTopLightControl(true); // Level 4
-                digitalWriteFast(CLIPPARD_LED_PIN, HIGH); // Level 5
+  return i_state;
+}
 
-                // Play an indication beep to notify we have changed menu levels.
-                stopEffect(S_BEEPS);
-                playEffect(S_BEEPS);
+// Turn on some lights to visually indicate which menu level we are in.
+void wandMenuLights(uint8_t i_lights, uint8_t i_mask) {
+  if(i_mask & MENU_LIGHT_SLO_BLO) {
+    digitalWriteFast(SLO_BLO_LED_PIN, (i_lights & MENU_LIGHT_SLO_BLO) ? HIGH : LOW); // Level 2
+  }
 
-                stopEffect(S_LEVEL_1);
-                stopEffect(S_LEVEL_2);
-                stopEffect(S_LEVEL_3);
-                stopEffect(S_LEVEL_4);
-                stopEffect(S_LEVEL_5);
+  if(i_mask & MENU_LIGHT_VENT) {
+    ventLightControl((i_lights & MENU_LIGHT_VENT) ? 255 : 0); // Level 3
+  }
 
-                playEffect(S_LEVEL_5);
+  if(i_mask & MENU_LIGHT_TOP) {
+    ventTopLightControl(i_lights & MENU_LIGHT_TOP); // Level 4
+  }
 
-                // Tell the Proton Pack to play some sounds.
-                wandSerialSend(W_MENU_LEVEL_5);
-              break;
+  if(i_mask & MENU_LIGHT_CLIPPARD) {
+    digitalWriteFast(CLIPPARD_LED_PIN, (i_lights & MENU_LIGHT_CLIPPARD) ? HIGH : LOW); // Level 5
+  }
+}
 
-              // Menu 5 the deepest level.
-              case MENU_LEVEL_5:
-              default:
-                i_wand_menu = 1;
-              break;
-            }
-          }
-          else {
-            i_wand_menu--;
-          }
-        }
+void wandMenuLevelChanged() {
+  // Play an indication beep to notify we have changed menu levels.
+  stopEffect(S_BEEPS);
+  playEffect(S_BEEPS);
 
-        // Clockwise.
-        if(prev_next_code == 0x07) {
-          if(WAND_MENU_LEVEL == MENU_LEVEL_3 && i_wand_menu == 5 && switch_intensify.isLongPressed() && !switch_mode.on()) {
-            if(b_wand_standalone || VOLUME_ADJUST_DEVICE == VOLUME_NEUTRONA_WAND) {
-              // Adjust Neutrona Wand default startup volume.
-              increaseVolumeEEPROM();
-            }
-            else {
-              // Adjust Proton Pack default startup volume.
-              wandSerialSend(W_VOLUME_INCREASE_EEPROM);
-            }
-          }
-          else if(WAND_MENU_LEVEL == MENU_LEVEL_4 && i_wand_menu == 5 && switch_intensify.on() && !switch_mode.on()) {
-            wandSerialSend(W_OVERHEAT_INCREASE_LEVEL_5);
-          }
-          else if(WAND_MENU_LEVEL == MENU_LEVEL_4 && i_wand_menu == 4 && switch_intensify.on() && !switch_mode.on()) {
-            wandSerialSend(W_OVERHEAT_INCREASE_LEVEL_4);
-          }
-          else if(WAND_MENU_LEVEL == MENU_LEVEL_4 && i_wand_menu == 3 && switch_intensify.on() && !switch_mode.on()) {
-            wandSerialSend(W_OVERHEAT_INCREASE_LEVEL_3);
-          }
-          else if(WAND_MENU_LEVEL == MENU_LEVEL_4 && i_wand_menu == 2 && switch_intensify.on() && !switch_mode.on()) {
-            wandSerialSend(W_OVERHEAT_INCREASE_LEVEL_2);
-          }
-          else if(WAND_MENU_LEVEL == MENU_LEVEL_4 && i_wand_menu == 1 && switch_intensify.on() && !switch_mode.on()) {
-            wandSerialSend(W_OVERHEAT_INCREASE_LEVEL_1);
-          }
-          else if(WAND_MENU_LEVEL == MENU_LEVEL_4 && i_wand_menu == 5 && !switch_intensify.on() && switch_mode.on()) {
-            overheatTimerIncrement(5);
-          }
-          else if(WAND_MENU_LEVEL == MENU_LEVEL_4 && i_wand_menu == 4 && !switch_intensify.on() && switch_mode.on()) {
-            overheatTimerIncrement(4);
-          }
-          else if(WAND_MENU_LEVEL == MENU_LEVEL_4 && i_wand_menu == 3 && !switch_intensify.on() && switch_mode.on()) {
-            overheatTimerIncrement(3);
-          }
-          else if(WAND_MENU_LEVEL == MENU_LEVEL_4 && i_wand_menu == 2 && !switch_intensify.on() && switch_mode.on()) {
-            overheatTimerIncrement(2);
-          }
-          else if(WAND_MENU_LEVEL == MENU_LEVEL_4 && i_wand_menu == 1 && !switch_intensify.on() && switch_mode.on()) {
-            overheatTimerIncrement(1);
-          }
-          else if(i_wand_menu + 1 > 5) {
-            switch(WAND_MENU_LEVEL) {
-              case MENU_LEVEL_5:
-                WAND_MENU_LEVEL = MENU_LEVEL_4;
-                i_wand_menu = 1;
-
-                // Turn on some lights to visually indicate which menu we are in.
-                digitalWriteFast(SLO_BLO_LED_PIN, HIGH); // Level 2
-                ventLightControl(); // Level 3
-                ventTopLightControl(true); // Level 4
-
-                // Turn off the other lights.
-                digitalWriteFast(CLIPPARD_LED_PIN, LOW); // Level 5
-
-                // Play an indication beep to notify we have changed menu levels.
-                stopEffect(S_BEEPS);
-                playEffect(S_BEEPS);
-
-                stopEffect(S_LEVEL_1);
-                stopEffect(S_LEVEL_2);
-                stopEffect(S_LEVEL_3);
-                stopEffect(S_LEVEL_4);
-                stopEffect(S_LEVEL_5);
-
-                playEffect(S_LEVEL_4);
-
-                // Tell the Proton Pack to play some sounds.
-                wandSerialSend(W_MENU_LEVEL_4);
-              break;
+  stopEffect(S_LEVEL_1);
+  stopEffect(S_LEVEL_2);
+  stopEffect(S_LEVEL_3);
+  stopEffect(S_LEVEL_4);
+  stopEffect(S_LEVEL_5);
 
-              case MENU_LEVEL_4:
-                WAND_MENU_LEVEL = MENU_LEVEL_3;
-                i_wand_menu = 1;
+  playEffect(S_LEVEL_1 + WAND_MENU_LEVEL);
 
-                // Turn on some lights to visually indicate which menu we are in.
-                digitalWriteFast(SLO_BLO_LED_PIN, HIGH); // Level 2
-                ventLightControl(); // Level 3
+  // Tell the Proton Pack to play some sounds.
+  wandSerialSend(W_MENU_LEVEL_1 + WAND_MENU_LEVEL);
+}
 
-                // Turn off the other lights.
-                ventTopLightControl(false); // Level 4
-                digitalWriteFast(CLIPPARD_LED_PIN, LOW); // Level 5
+// Turns the top dial through a menu, as defined by its tree (see MenuTree).
+void wandMenuDial(const MenuTreeMenu* menu) {
+  uint8_t i_input;
 
-                // Play an indication beep to notify we have changed menu levels.
-                stopEffect(S_BEEPS);
-                playEffect(S_BEEPS);
+  if(prev_next_code == 0x0b) {
+    // Counter clockwise.
+    i_input = MENU_INPUT_DIAL_CCW;
+  }
+  else if(prev_next_code == 0x07) {
+    // Clockwise.
+    i_input = MENU_INPUT_DIAL_CW;
+  }
+  else {
+    return;
+  }
 
-                stopEffect(S_LEVEL_1);
-                stopEffect(S_LEVEL_2);
-                stopEffect(S_LEVEL_3);
-                stopEffect(S_LEVEL_4);
-                stopEffect(S_LEVEL_5);
+  uint8_t i_level = WAND_MENU_LEVEL;
+  MenuTreeStep step = menuTreeDial(menu, i_input, wandMenuState(), i_level, i_wand_menu);
 
-                playEffect(S_LEVEL_3);
+  if(step.levelChanged) {
+    WAND_MENU_LEVEL = (WAND_MENU_LEVELS)i_level;
 
-                // Tell the Proton Pack to play some sounds.
-                wandSerialSend(W_MENU_LEVEL_3);
-              break;
+    wandMenuLights(step.lights, step.lightsMask);
+    wandMenuLevelChanged();
+  }
 
-              case MENU_LEVEL_3:
-                WAND_MENU_LEVEL = MENU_LEVEL_2;
-                i_wand_menu = 1;
+  switch(step.action) {
+    case MENU_ACTION_SEND:
+      wandSerialSend(step.value);
+    break;
 
-                // Turn on some lights to visually indicate which menu we are in.
-                digitalWriteFast(SLO_BLO_LED_PIN, HIGH); // Level 2
+    case MENU_ACTION_VOLUME_EFFECTS_DOWN:
+      // Lower the sound effects volume, then tell the pack to do the same.
+      decreaseVolumeEffects();
+      wandSerialSend(step.value);
+    break;
 
-                // Turn off the other lights.
-                ventLightControl(0); // Level 3
-                ventTopLightControl(false); // Level 4
-                digitalWriteFast(CLIPPARD_LED_PIN, LOW); // Level 5
+    case MENU_ACTION_VOLUME_EFFECTS_UP:
+      increaseVolumeEffects();
+      wandSerialSend(step.value);
+    break;
 
-                // Play an indication beep to notify we have changed menu levels.
-                stopEffect(S_BEEPS);
-                playEffect(S_BEEPS);
+    case MENU_ACTION_VOLUME_MUSIC_DOWN:
+      // Lower the music volume, then tell the pack to do the same.
+      decreaseVolumeMusic();
+      wandSerialSend(step.value);
+    break;
 
-                stopEffect(S_LEVEL_1);
-                stopEffect(S_LEVEL_2);
-                stopEffect(S_LEVEL_3);
-                stopEffect(S_LEVEL_4);
-                stopEffect(S_LEVEL_5);
+    case MENU_ACTION_VOLUME_MUSIC_UP:
+      increaseVolumeMusic();
+      wandSerialSend(step.value);
+    break;
 
-                playEffect(S_LEVEL_2);
+    case MENU_ACTION_VOLUME_EEPROM_DOWN:
+      // Adjust Neutrona Wand default startup volume.
+      decreaseVolumeEEPROM();
+    break;
 
-                // Tell the Proton Pack to play some sounds.
-                wandSerialSend(W_MENU_LEVEL_2);
-              break;
+    case MENU_ACTION_VOLUME_EEPROM_UP:
+      increaseVolumeEEPROM();
+    break;
 
-              case MENU_LEVEL_2:
-                WAND_MENU_LEVEL = MENU_LEVEL_1;
-                i_wand_menu = 1;
+    case MENU_ACTION_OVERHEAT_TIMER_DOWN:
+      overheatTimerDecrement(step.value);
+    break;
 
-                // Turn off the other lights.
-                digitalWriteFast(SLO_BLO_LED_PIN, LOW); // Level 2
-                ventLightControl(0); // Level 3
-                ventTopLightControl(false); // Level 4
-                digitalWriteFast(CLIPPARD_LED_PIN, LOW); // Level 5
+    case MENU_ACTION_OVERHEAT_TIMER_UP:
+      overheatTimerIncrement(step.value);
+    break;
 
-                // Play an indication beep to notify we have changed menu levels.
-                stopEffect(S_BEEPS);
-                playEffect(S_BEEPS);
+    case MENU_ACTION_SPECTRAL_WAND_DOWN:
+      spectralWandCustomDecrease();
+    break;
 
-                stopEffect(S_LEVEL_1);
-                stopEffect(S_LEVEL_2);
-                stopEffect(S_LEVEL_3);
-                stopEffect(S_LEVEL_4);
-                stopEffect(S_LEVEL_5);
+    case MENU_ACTION_SPECTRAL_WAND_UP:
+      spectralWandCustomIncrease();
+    break;
 
-                playEffect(S_LEVEL_1);
+    case MENU_ACTION_NONE:
+    default:
+      // The dial moved through the menu.
+    break;
+  }
+}
 
-                // Tell the Proton Pack to play some sounds.
-                wandSerialSend(W_MENU_LEVEL_1);
-              break;
+// Top rotary dial on the wand.
+void checkRotaryEncoder() {
+  if(readRotary() != 0) {
+    // Only continue if the limiter has expired.
+    if(ms_rotary_encoder.remaining() > 0) {
+      return;
+    }
+    else {
+      ms_rotary_encoder.start(i_rotary_encoder_delay);
+    }
 
-              case MENU_LEVEL_1:
-              default:
-                // Cannot go any further than menu level 1.
-                i_wand_menu = 5;
-              break;
-            }
-          }
-          else {
-            i_wand_menu++;
-          }
-        }
+    switch(WAND_ACTION_STATUS) {
+      case ACTION_CONFIG_EEPROM_MENU:
+        wandMenuDial(&WAND_MENU_CONFIG_EEPROM);
       break;
 
       case ACTION_LED_EEPROM_MENU:
-        // Counter clockwise.
-        if(prev_next_code == 0x0b) {
-          if(WAND_MENU_LEVEL == MENU_LEVEL_1 && i_wand_menu == 4 && !switch_intensify.on() && switch_mode.on()) {
-            // Change colour of the wand barrel spectral custom colour.
-            if(i_spectral_wand_custom_colour > 1 && i_spectral_wand_custom_saturation > 253) {
-              i_spectral_wand_custom_colour--;
-            }
-            else {
-              i_spectral_wand_custom_colour = 1;
-
-              if(i_spectral_wand_custom_saturation > 1) {
-                i_spectral_wand_custom_saturation--;
-              }
-              else {
-                i_spectral_wand_custom_saturation = 1;
-              }
-            }
-
-            wandBarrelSpectralCustomConfigOn();
-          }
-          else if(WAND_MENU_LEVEL == MENU_LEVEL_1 && i_wand_menu == 3 && !switch_intensify.on() && switch_mode.on()) {
-            // Change colour of the Power Cell Spectral custom colour.
-            wandSerialSend(W_SPECTRAL_POWERCELL_CUSTOM_DECREASE);
-          }
-          else if(WAND_MENU_LEVEL == MENU_LEVEL_1 && i_wand_menu == 2 && !switch_intensify.on() && switch_mode.on()) {
-            // Change colour of the Cyclotron Spectral custom colour.
-            wandSerialSend(W_SPECTRAL_CYCLOTRON_CUSTOM_DECREASE);
-          }
-          else if(WAND_MENU_LEVEL == MENU_LEVEL_1 && i_wand_menu == 1 && !switch_intensify.on() && switch_mode.on()) {
-            // Change colour of the Inner Cyclotron Spectral custom colour.
-            wandSerialSend(W_SPECTRAL_INNER_CYCLOTRON_CUSTOM_DECREASE);
-          }
-          else if(WAND_MENU_LEVEL == MENU_LEVEL_2 && i_wand_menu == 5 && !switch_intensify.on() && switch_mode.isLongPressed()) {
-            // Set default LED dimming level for the entire system.
-            wandSerialSend(W_DIMMING_DECREASE);
-          }
-          else if(i_wand_menu - 1 < 1) {
-            switch(WAND_MENU_LEVEL) {
-              case MENU_LEVEL_1:
-                WAND_MENU_LEVEL = MENU_LEVEL_2;
-                i_wand_menu = 5;
-
-                // Turn on some lights to visually indicate which menu we are in.
-                digitalWriteFast(SLO_BLO_LED_PIN, HIGH); // Level 2
-
-                // Turn off the other lights.
-                ventLightControl(0); // Level 3
-                ventTopLightControl(false); // Level 4
-                digitalWriteFast(CLIPPARD_LED_PIN, LOW); // Level 5
-
-                // Play an indication beep to notify we have changed menu levels.
-                stopEffect(S_BEEPS);
-                playEffect(S_BEEPS);
-
-                stopEffect(S_LEVEL_1);
-                stopEffect(S_LEVEL_2);
-                stopEffect(S_LEVEL_3);
-                stopEffect(S_LEVEL_4);
-                stopEffect(S_LEVEL_5);
-
-                playEffect(S_LEVEL_2);
-
-                // Tell the Proton Pack to play some sounds.
-                wandSerialSend(W_MENU_LEVEL_2);
-              break;
-
-              case MENU_LEVEL_2:
-                WAND_MENU_LEVEL = MENU_LEVEL_3;
-                i_wand_menu = 5;
-
-                // Turn on some lights to visually indicate which menu we are in.
-                digitalWriteFast(SLO_BLO_LED_PIN, HIGH); // Level 2
-                ventLightControl(); // Level 3
-
-                // Turn off the other lights.
-                ventTopLightControl(false); // Level 4
-                digitalWriteFast(CLIPPARD_LED_PIN, LOW); // Level 5
-
-                // Play an indication beep to notify we have changed menu levels.
-                stopEffect(S_BEEPS);
-                playEffect(S_BEEPS);
-
-                stopEffect(S_LEVEL_1);
-                stopEffect(S_LEVEL_2);
-                stopEffect(S_LEVEL_3);
-                stopEffect(S_LEVEL_4);
-                stopEffect(S_LEVEL_5);
-
-                playEffect(S_LEVEL_3);
-
-                // Tell the Proton Pack to play some sounds.
-                wandSerialSend(W_MENU_LEVEL_3);
-              break;
-
-              // Menu 3 the deepest level.
-              case MENU_LEVEL_3:
-              default:
-                i_wand_menu = 1;
-              break;
-            }
-          }
-          else {
-            i_wand_menu--;
-          }
-        }
-
-        // Clockwise.
-        if(prev_next_code == 0x07) {
-          if(WAND_MENU_LEVEL == MENU_LEVEL_1 && i_wand_menu == 4 && !switch_intensify.on() && switch_mode.on()) {
-            // Change colour of the Wand Barrel Spectral custom colour.
-            if(i_spectral_wand_custom_saturation < 254) {
-              i_spectral_wand_custom_saturation++;
-
-              if(i_spectral_wand_custom_saturation > 253) {
-                i_spectral_wand_custom_saturation = 254;
-              }
-            }
-            else if(i_spectral_wand_custom_colour < 253 && i_spectral_wand_custom_saturation > 253) {
-              i_spectral_wand_custom_colour++;
-            }
-            else {
-              i_spectral_wand_custom_colour = 254;
-
-              if(i_spectral_wand_custom_saturation < 253) {
-                i_spectral_wand_custom_saturation++;
-              }
-              else {
-                i_spectral_wand_custom_saturation = 254;
-              }
-            }
-
-            wandBarrelSpectralCustomConfigOn();
-          }
-          else if(WAND_MENU_LEVEL == MENU_LEVEL_1 && i_wand_menu == 3 && !switch_intensify.on() && switch_mode.on()) {
-            // Change colour of the Power Cell Spectral custom colour.
-            wandSerialSend(W_SPECTRAL_POWERCELL_CUSTOM_INCREASE);
-          }
-          else if(WAND_MENU_LEVEL == MENU_LEVEL_1 && i_wand_menu == 2 && !switch_intensify.on() && switch_mode.on()) {
-            // Change colour of the Cyclotron Spectral custom colour.
-            wandSerialSend(W_SPECTRAL_CYCLOTRON_CUSTOM_INCREASE);
-          }
-          else if(WAND_MENU_LEVEL == MENU_LEVEL_1 && i_wand_menu == 1 && !switch_intensify.on() && switch_mode.on()) {
-            // Change colour of the Inner Cyclotron Spectral custom colour.
-            wandSerialSend(W_SPECTRAL_INNER_CYCLOTRON_CUSTOM_INCREASE);
-          }
-          else if(WAND_MENU_LEVEL == MENU_LEVEL_2 && i_wand_menu == 5 && !switch_intensify.on() && switch_mode.isLongPressed()) {
-            // Set default LED dimming level for the entire system.
-            wandSerialSend(W_DIMMING_INCREASE);
-          }
-          else if(i_wand_menu + 1 > 5) {
-            switch(WAND_MENU_LEVEL) {
-              case MENU_LEVEL_3:
-                WAND_MENU_LEVEL = MENU_LEVEL_2;
-                i_wand_menu = 1;
-
-                // Turn on some lights to visually indicate which menu we are in.
-                digitalWriteFast(SLO_BLO_LED_PIN, HIGH); // Level 2
-
-                // Turn off the other lights.
-                ventLightControl(0); // Level 3
-                ventTopLightControl(false); // Level 4
-                digitalWriteFast(CLIPPARD_LED_PIN, LOW); // Level 5
-
-                // Play an indication beep to notify we have changed menu levels.
-                stopEffect(S_BEEPS);
-                playEffect(S_BEEPS);
-
-                stopEffect(S_LEVEL_1);
-                stopEffect(S_LEVEL_2);
-                stopEffect(S_LEVEL_3);
-                stopEffect(S_LEVEL_4);
-                stopEffect(S_LEVEL_5);
-
-                playEffect(S_LEVEL_2);
-
-                // Tell the Proton Pack to play some sounds.
-                wandSerialSend(W_MENU_LEVEL_2);
-              break;
-
-              case MENU_LEVEL_2:
-                WAND_MENU_LEVEL = MENU_LEVEL_1;
-                i_wand_menu = 1;
-
-                // Turn off the other lights.
-                digitalWriteFast(SLO_BLO_LED_PIN, LOW); // Level 2
-                ventLightControl(0); // Level 3
-                ventTopLightControl(false); // Level 4
-                digitalWriteFast(CLIPPARD_LED_PIN, LOW); // Level 5
-
-                // Play an indication beep to notify we have changed menu levels.
-                stopEffect(S_BEEPS);
-                playEffect(S_BEEPS);
-
-                stopEffect(S_LEVEL_1);
-                stopEffect(S_LEVEL_2);
-                stopEffect(S_LEVEL_3);
-                stopEffect(S_LEVEL_4);
-                stopEffect(S_LEVEL_5);
-
-                playEffect(S_LEVEL_1);
-
-                // Tell the Proton Pack to play some sounds.
-                wandSerialSend(W_MENU_LEVEL_1);
-              break;
-
-              case MENU_LEVEL_1:
-              default:
-                // Cannot go any further than menu level 1.
-                i_wand_menu = 5;
-              break;
-            }
-          }
-          else {
-            i_wand_menu++;
-          }
-        }
+        wandMenuDial(&WAND_MENU_LED_EEPROM);
       break;
 
       case ACTION_SETTINGS:
-        // Counter clockwise.
-        if(prev_next_code == 0x0b) {
-          if(i_wand_menu == 4 && WAND_MENU_LEVEL == MENU_LEVEL_1 && switch_intensify.on() && !switch_mode.on()) {
-            // Tell pack to dim the selected lighting. (Power Cell, Cyclotron or Inner Cyclotron)
-            wandSerialSend(W_DIMMING_DECREASE);
-          }
-          else if(i_wand_menu == 3 && WAND_MENU_LEVEL == MENU_LEVEL_1 && switch_intensify.on() && !switch_mode.on()) {
-            // Lower the sound effects volume.
-            decreaseVolumeEffects();
-
-            // Tell pack to lower the sound effects volume.
-            wandSerialSend(W_VOLUME_SOUND_EFFECTS_DECREASE);
-          }
-          else if(i_wand_menu == 3 && WAND_MENU_LEVEL == MENU_LEVEL_1 && !switch_intensify.on() && switch_mode.on() && b_playing_music && !b_music_paused) {
-            // Decrease the music volume.
-            decreaseVolumeMusic();
-
-            // Tell pack to lower the music volume.
-            wandSerialSend(W_VOLUME_MUSIC_DECREASE);
-          }
-          else if(i_wand_menu - 1 < 1) {
-            // We are entering a sub menu. Only accessible when the Proton Pack is powered down.
-            if((!b_pack_on && !b_pack_shutting_down) || (b_wand_standalone && WAND_STATUS == MODE_OFF)) {
-              switch(WAND_MENU_LEVEL) {
-                case MENU_LEVEL_1:
-                  WAND_MENU_LEVEL = MENU_LEVEL_2;
-                  i_wand_menu = 5;
-
-                  // Turn on the slo blow led to indicate we are in sub menu level 2.
-                  digitalWriteFast(SLO_BLO_LED_PIN, HIGH);
-
-                  // Play an indication beep to notify we have changed menu levels.
-                  stopEffect(S_BEEPS);
-                  playEffect(S_BEEPS);
-
-                  stopEffect(S_LEVEL_1);
-                  stopEffect(S_LEVEL_2);
-                  stopEffect(S_LEVEL_3);
-                  stopEffect(S_LEVEL_4);
-                  stopEffect(S_LEVEL_5);
-
-                  playEffect(S_LEVEL_2);
-
-                  // Tell the Proton Pack to play some sounds.
-                  wandSerialSend(W_MENU_LEVEL_2);
-                break;
-
-              #ifdef ESP32
-                case MENU_LEVEL_2:
-                  // Menu level 3 is only available on the GPStar II controller.
-                  WAND_MENU_LEVEL = MENU_LEVEL_3;
-                  i_wand_menu = 5;
-
-                  // Turn on some lights to visually indicate which menu we are in.
-                  ventLightControl(); // Level 3
-
-                  // Play an indication beep to notify we have changed menu levels.
-                  stopEffect(S_BEEPS);
-                  playEffect(S_BEEPS);
-
-                  stopEffect(S_LEVEL_1);
-                  stopEffect(S_LEVEL_2);
-                  stopEffect(S_LEVEL_3);
-                  stopEffect(S_LEVEL_4);
-                  stopEffect(S_LEVEL_5);
-
-                  playEffect(S_LEVEL_3);
-
-                  // Tell the Proton Pack to play some sounds.
-                  wandSerialSend(W_MENU_LEVEL_3);
-                break;
-              #endif
-
-                default:
-                  // Cannot go further than level 2 (GPStar I) or level 3 (GPStar II) for this menu.
-                  i_wand_menu = 1;
-                break;
-              }
-            }
-            else {
-              i_wand_menu = 1;
-            }
-          }
-          else {
-            i_wand_menu--;
-          }
-        }
-
-        // Clockwise.
-        if(prev_next_code == 0x07) {
-          if(i_wand_menu == 4 && WAND_MENU_LEVEL == MENU_LEVEL_1 && switch_intensify.on() && !switch_mode.on()) {
-            // Tell pack to dim the selected lighting. (Power Cell, Cyclotron or Inner Cyclotron)
-            wandSerialSend(W_DIMMING_INCREASE);
-          }
-          else if(i_wand_menu == 3 && WAND_MENU_LEVEL == MENU_LEVEL_1 && switch_intensify.on() && !switch_mode.on()) {
-            // Increase sound effects volume.
-            increaseVolumeEffects();
-
-            // Tell pack to increase the sound effects volume.
-            wandSerialSend(W_VOLUME_SOUND_EFFECTS_INCREASE);
-          }
-          else if(i_wand_menu == 3 && WAND_MENU_LEVEL == MENU_LEVEL_1 && !switch_intensify.on() && switch_mode.on() && b_playing_music && !b_music_paused) {
-            // Increase music volume.
-            increaseVolumeMusic();
-
-            // Tell pack to increase music volume.
-            wandSerialSend(W_VOLUME_MUSIC_INCREASE);
-          }
-          else if(i_wand_menu + 1 > 5) {
-            // We are leaving changing menu levels. Only accessible when the Proton Pack is powered down.
-            if((!b_pack_on && !b_pack_shutting_down) || (b_wand_standalone && WAND_STATUS == MODE_OFF)) {
-              switch(WAND_MENU_LEVEL) {
-                case MENU_LEVEL_3:
-                  WAND_MENU_LEVEL = MENU_LEVEL_2;
-
-                  i_wand_menu = 1;
-
-                  // Turn off the vent/top LED to indicate leaving this sub menu.
-                  ventLightControl(0); // Level 3
-
-                  // Play an indication beep to notify we have changed menu levels.
-                  stopEffect(S_BEEPS);
-                  playEffect(S_BEEPS);
-
-                  stopEffect(S_LEVEL_1);
-                  stopEffect(S_LEVEL_2);
-                  stopEffect(S_LEVEL_3);
-                  stopEffect(S_LEVEL_4);
-                  stopEffect(S_LEVEL_5);
-
-                  playEffect(S_LEVEL_2);
-
-                  // Tell the Proton Pack to play some sounds.
-                  wandSerialSend(W_MENU_LEVEL_2);
-                break;
-
-                case MENU_LEVEL_2:
-                  WAND_MENU_LEVEL = MENU_LEVEL_1;
-
-                  i_wand_menu = 1;
-
-                  // Turn off the slo blow led to indicate we are no longer in the Neutrona Wand sub menus.
-                  digitalWriteFast(SLO_BLO_LED_PIN, LOW);
-
-                  // Play an indication beep to notify we have changed menu levels.
-                  stopEffect(S_BEEPS);
-                  playEffect(S_BEEPS);
-
-                  stopEffect(S_LEVEL_1);
-                  stopEffect(S_LEVEL_2);
-                  stopEffect(S_LEVEL_3);
-                  stopEffect(S_LEVEL_4);
-                  stopEffect(S_LEVEL_5);
-
-                  playEffect(S_LEVEL_1);
-
-                  // Tell the Proton Pack to play some sounds.
-                  wandSerialSend(W_MENU_LEVEL_1);
-                break;
-
-                case MENU_LEVEL_1:
-                default:
-                  // Level 1 is the first menu and nothing above it.
-                  i_wand_menu = 5;
-                break;
-              }
-            }
-            else {
-              i_wand_menu = 5;
-            }
-          }
-          else {
-            i_wand_menu++;
-          }
-        }
+        wandMenuDial(&WAND_MENU_SETTINGS);
       break;
 
       default:
@@ -532,30 +532,30 @@ String getTelemetryJSON() {
   JsonDocument jsonTelemetry;
 
   // Acceleration in meters/second^2 (m/s^2).
-  jsonTelemetry["aX"] = roundFloat(filteredMotionData.accelX);
-  jsonTelemetry["aY"] = roundFloat(filteredMotionData.accelY);
-  jsonTelemetry["aZ"] = roundFloat(filteredMotionData.accelZ);
+  jsonTelemetry["aX"] = roundFloat(motionResults.filtered.accelX);
+  jsonTelemetry["aY"] = roundFloat(motionResults.filtered.accelY);
+  jsonTelemetry["aZ"] = roundFloat(motionResults.filtered.accelZ);
   // Gyroscope in degrees/second (deg/s).
-  jsonTelemetry["gX"] = roundFloat(filteredMotionData.gyroX);
-  jsonTelemetry["gY"] = roundFloat(filteredMotionData.gyroY);
-  jsonTelemetry["gZ"] = roundFloat(filteredMotionData.gyroZ);
+  jsonTelemetry["gX"] = roundFloat(motionResults.filtered.gyroX);
+  jsonTelemetry["gY"] = roundFloat(motionResults.filtered.gyroY);
+  jsonTelemetry["gZ"] = roundFloat(motionResults.filtered.gyroZ);
   // Magnetometer in microteslas (uT).
-  jsonTelemetry["mX"] = roundFloat(filteredMotionData.magX);
-  jsonTelemetry["mY"] = roundFloat(filteredMotionData.magY);
-  jsonTelemetry["mZ"] = roundFloat(filteredMotionData.magZ);
+  jsonTelemetry["mX"] = roundFloat(motionResults.filtered.magX);
+  jsonTelemetry["mY"] = roundFloat(motionResults.filtered.magY);
+  jsonTelemetry["mZ"] = roundFloat(motionResults.filtered.magZ);
   // Special calculated values (g-force and angular velocity)
-  jsonTelemetry["gForce"] = roundFloat(filteredMotionData.gForce);
-  jsonTelemetry["angVel"] = roundFloat(filteredMotionData.angVel);
-  jsonTelemetry["shaken"] = filteredMotionData.shaken;
+  jsonTelemetry["gForce"] = roundFloat(motionResults.filtered.gForce);
+  jsonTelemetry["angVel"] = roundFloat(motionResults.filtered.angVel);
+  jsonTelemetry["shaken"] = motionResults.filtered.shaken;
   // Spatial data in Euler angles (degrees).
-  jsonTelemetry["roll"] = roundFloat(spatialData.roll);
-  jsonTelemetry["pitch"] = roundFloat(spatialData.pitch);
-  jsonTelemetry["yaw"] = roundFloat(spatialData.yaw);
+  jsonTelemetry["roll"] = roundFloat(motionResults.spatial.roll);
+  jsonTelemetry["pitch"] = roundFloat(motionResults.spatial.pitch);
+  jsonTelemetry["yaw"] = roundFloat(motionResults.spatial.yaw);
   // Spatial data in quaternion (w, x, y, z).
-  jsonTelemetry["qW"] = roundFloat(spatialData.quaternion[0]);
-  jsonTelemetry["qX"] = roundFloat(spatialData.quaternion[1]);
-  jsonTelemetry["qY"] = roundFloat(spatialData.quaternion[2]);
-  jsonTelemetry["qZ"] = roundFloat(spatialData.quaternion[3]);
+  jsonTelemetry["qW"] = roundFloat(motionResults.spatial.quaternion[0]);
+  jsonTelemetry["qX"] = roundFloat(motionResults.spatial.quaternion[1]);
+  jsonTelemetry["qY"] = roundFloat(motionResults.spatial.quaternion[2]);
+  jsonTelemetry["qZ"] = roundFloat(motionResults.spatial.quaternion[3]);
 
   // Serialize JSON object to string.
   serializeJson(jsonTelemetry, telemetryData);
@@ -1013,6 +1013,72 @@ void handleRestart(AsyncWebServerRequest *request) {
   ESP.restart();
 }
 
+#if defined(MOTION_GOVERNOR)
+void handleGetMotion(AsyncWebServerRequest *request) {
+  // Return the current motion rate, and the time, i2c bus use and estimated current draw at each rate.
+  // Current is taken from the sensor datasheets for each rate's settings, and has not been measured.
+  String motionData;
+  JsonDocument jsonBody;
+
+  jsonBody["rate"] = motionRateProfiles[MOTION_RATE].name;
+  jsonBody["readMs"] = i_sensor_read_delay;
+  jsonBody["changes"] = i_motion_rate_changes;
+  jsonBody["currentSource"] = "datasheet estimate";
+  jsonBody["averageEstimatedUA"] = getMotionAverageCurrent();
+
+  JsonObject rates = jsonBody["rates"].to<JsonObject>();
+  for(uint8_t i = 0; i < MOTION_RATE_COUNT; i++) {
+    uint32_t i_time = getMotionRateTime(i);
+    JsonObject rate = rates[motionRateProfiles[i].name].to<JsonObject>();
+    rate["timeMs"] = i_time;
+    rate["busUs"] = i_motion_bus_us[i];
+    rate["busPercent"] = i_time > 0 ? roundFloat(i_motion_bus_us[i] / (i_time * 10.0f)) : 0.0f; // us / (ms * 1000) * 100
+    rate["estimatedUA"] = motionRateProfiles[i].i_current_ua;
+  }
+
+#if defined(MOTION_FIFO)
+  // Samples per batch and how the sample clock compares with the nominal data rate.
+  JsonObject fifo = jsonBody["fifo"].to<JsonObject>();
+  fifo["batch"] = i_imu_samples;
+  fifo["periodUs"] = imuClock.getPeriodUs();
+  fifo["nominalUs"] = imuClock.getNominalUs();
+  fifo["resyncs"] = imuClock.getResyncs();
+  fifo["overruns"] = i_imu_fifo_overruns;
+#endif
+
+  // Time between telemetry updates at the current rate; the spread from min to max is the jitter.
+  SectionSummary updates = motionUpdateStats.summarise(1);
+  JsonObject update = jsonBody["update"].to<JsonObject>();
+  update["task"] = isMotionTaskRunning();
+  update["count"] = updates.count;
+  update["minUs"] = updates.min;
+  update["avgUs"] = updates.avg;
+  update["maxUs"] = updates.max;
+  update["p99Us"] = updates.p99;
+  update["jitterUs"] = updates.max - updates.min;
+#if defined(MOTION_TASK)
+  update["retries"] = motionExchange.getRetries();
+#endif
+
+  // CPU cycles spent filtering each sample.
+  SectionSummary filtering = motionFilterStats.summarise(1);
+  JsonObject filter = jsonBody["filter"].to<JsonObject>();
+#if defined(MOTION_FILTER_BANK)
+  filter["bank"] = true;
+#else
+  filter["bank"] = false;
+#endif
+  filter["avgCycles"] = filtering.avg;
+  filter["p99Cycles"] = filtering.p99;
+  filter["maxCycles"] = filtering.max;
+
+  serializeJson(jsonBody, motionData);
+  AsyncWebServerResponse *response = request->beginResponse(HTTP_STATUS_200, MIME_JSON, motionData);
+  response->addHeader(HEADER_CACHE_CONTROL, CACHE_NO_CACHE);
+  request->send(response);
+}
+#endif
+
 /**
  * Action Handlers - Perform specific actions via web requests
  */
@@ -1255,50 +1321,42 @@ void handleResetWandEEPROM(AsyncWebServerRequest *request) {
 void handleResetSensors(AsyncWebServerRequest *request) {
   // Re-center by resetting all current telemetry data for motion sensors.
   // This allows all motion data to be zeroed out and begin a new average.
-  resetAllMotionData(true); // Clear and re-calibrate (quick).
-  request->send(HTTP_STATUS_200, MIME_JSON, returnJsonStatus());
-  notifyWSClients();
+  if(postMotionRequest(MOTION_REQUEST_RESET_CALIBRATE)) {
+    request->send(HTTP_STATUS_200, MIME_JSON, returnJsonStatus());
+  }
+  else {
+    request->send(HTTP_STATUS_503, MIME_JSON, returnJsonStatus("Motion sensors busy, please try again."));
+  }
 }
 
 void handleCalibrateGyroSensor(AsyncWebServerRequest *request) {
   // Turn on calibration mode for the gyroscope sensor.
-  beginGyroCalibration(30); // Run calibration for 30 seconds.
-  request->send(HTTP_STATUS_200, MIME_JSON, returnJsonStatus());
-  notifyWSClients();
+  if(postMotionRequest(MOTION_REQUEST_GYRO_CALIBRATION, 30)) {
+    request->send(HTTP_STATUS_200, MIME_JSON, returnJsonStatus()); // Run calibration for 30 seconds.
+  }
+  else {
+    request->send(HTTP_STATUS_503, MIME_JSON, returnJsonStatus("Motion sensors busy, please try again."));
+  }
 }
 
 void handleMagCalEnabled(AsyncWebServerRequest *request) {
   // Turn on calibration mode for the magnetometer.
-  resetAllMotionData(false); // Clear but don't re-calibrate.
-  SENSOR_READ_TARGET = MAG_CALIBRATION; // Enables collection of magnetometer data.
-  magCal.beginCalibration(); // Start collection of samples, clears counters.
-  request->send(HTTP_STATUS_200, MIME_JSON, returnJsonStatus());
-  notifyWSClients();
+  if(postMotionRequest(MOTION_REQUEST_MAG_CAL_BEGIN)) {
+    request->send(HTTP_STATUS_200, MIME_JSON, returnJsonStatus());
+  }
+  else {
+    request->send(HTTP_STATUS_503, MIME_JSON, returnJsonStatus("Motion sensors busy, please try again."));
+  }
 }
 
 void handleMagCalDisabled(AsyncWebServerRequest *request) {
-  // Determine if proper coverage was achieved before calculating and storing data.
-  float coverage = magCal.getCoveragePercent();
-  if(coverage >= 60.0f) {
-    // Compute calibration data for the standard calibration object.
-    magCalData = magCal.computeCalibration();
-
-    // Create Preferences object to handle non-volatile storage (NVS).
-    Preferences preferences;
-
-    // Save the calibration data (as an object) to preferences.
-    if(preferences.begin("device", false)) {
-      preferences.putBytes("mag_cal", &magCalData, sizeof(magCalData));
-      preferences.end();
-    }
+  // Store the calibration if proper coverage was achieved, then turn off calibration mode for the motion sensors.
+  if(postMotionRequest(MOTION_REQUEST_MAG_CAL_END)) {
+    request->send(HTTP_STATUS_200, MIME_JSON, returnJsonStatus());
+  }
+  else {
+    request->send(HTTP_STATUS_503, MIME_JSON, returnJsonStatus("Motion sensors busy, please try again."));
   }
-
-  // Turn off calibration mode for the motion sensors.
-  SENSOR_READ_TARGET = OFFSETS; // Switch to offsets mode for brief collection.
-  resetAllMotionData(true); // Reset and re-calibrate with fresh offsets.
-
-  request->send(HTTP_STATUS_200, MIME_JSON, returnJsonStatus());
-  notifyWSClients();
 }
 
 void handleInfraredSignal(AsyncWebServerRequest *request) {
@@ -1587,22 +1645,13 @@ AsyncCallbackJsonWebHandler *handleSaveDeviceConfig = new AsyncCallbackJsonWebHa
       preferences.putBytes("mag_cal", &magCalData, sizeof(magCalData));
 
       if(b_orientation_changed) {
-        resetMotionOffsets(calibratedOffsets); // Clear previous offsets set/collected.
-        resetAllMotionData(true); // Reset and re-calibrate with fresh, quick offsets.
-
-        // Reset the accelerometer offsets.
-        accelOffsets.x = 0;
-        accelOffsets.y = 0;
-        accelOffsets.z = 0;
-
-        // Reset the gyroscope offsets.
-        gyroOffsets.x = 0;
-        gyroOffsets.y = 0;
-        gyroOffsets.z = 0;
+        // Clear the offsets and re-calibrate with fresh, quick offsets.
+        postMotionRequest(MOTION_REQUEST_ORIENTATION_CHANGED);
 
         // Save the new empty offsets to preferences.
-        preferences.putBytes("accel_cal", &accelOffsets, sizeof(accelOffsets));
-        preferences.putBytes("gyro_cal", &gyroOffsets, sizeof(gyroOffsets));
+        Axis3F emptyOffsets;
+        preferences.putBytes("accel_cal", &emptyOffsets, sizeof(emptyOffsets));
+        preferences.putBytes("gyro_cal", &emptyOffsets, sizeof(emptyOffsets));
       }
 
       // Store the song list to preferences.
@@ -95,6 +95,9 @@ void registerWebRoutes() {
   // System Status and Control
   addSimpleRoute("/status", HTTP_GET, handleGetStatus, "Get system status as JSON", "Returns current system status including mode, theme, and connected device info", TAG_SYSTEM, RESP_SYSTEM_STATUS);
   addSimpleRoute("/restart", HTTP_DELETE, handleRestart, "Restart device", "Performs a restart of the device", TAG_SYSTEM, RESP_NO_CONTENT_RESTART);
+#if defined(MOTION_GOVERNOR)
+  addSimpleRoute("/debug/motion", HTTP_GET, handleGetMotion, "Get motion sensor rates", "Returns the current motion sensor rate, and the time in milliseconds, i2c bus time and sensor current at each rate since boot (current is a datasheet estimate, not a measurement)", TAG_SYSTEM, RESP_JSON_OBJECT);
+#endif
 
   // Device Control
   addSimpleRoute("/infrared/signal", HTTP_PUT, handleInfraredSignal, "Send an IR signal", "Send an encoded signal via the IR transmitter", TAG_DEVICE_CONTROL);
@@ -55,7 +55,6 @@
 #include <FastLED.h>
 #include <avdweb_Switch.h>
 #include <Ramp.h>
-#include <ht16k33.h>
 #include <SerialTransfer.h>
 #include <Wire.h>
 #ifdef ESP32
@@ -70,10 +69,19 @@ void sendDebug(const String& message);
 // Shared Libraries
 #include <DeviceState.h>
 #include <Communication.h>
+#include <BargraphDriver.h>
+#include <BargraphSequence.h>
+#include <BarrelEffects.h>
+#include <MenuTree.h>
 #ifdef ESP32
   #include <MagCalibration.h>
   MagCalibration magCal;
 
+  #include <ImuFifo.h>
+  #include <SeqLock.h>
+  #include <LoopProfiler.h>
+  #include <MotionFilter.h>
+
   #include <WirelessManager.h>
   #include <WebRouter.h>
 
@@ -253,6 +261,8 @@ void setup() {
   Wire.begin(I2C_SDA, I2C_SCL, 400000UL);
 
   // Attempt to start the sensors.
+  // Wire1 carries only the IMU and magnetometer and is driven directly rather than through I2CScheduler,
+  // so it must only be used by whichever context samples the sensors (the main loop, or the motion task).
   Wire1.begin(IMU_SDA, IMU_SCL, 400000UL);
   uint8_t i_retries = 0;
   while(i_retries < 250) {
@@ -271,6 +281,13 @@ void setup() {
     configureSensors(); // Set sensor ranges and defaults.
     readRawSensorData(); // Perform an initial sensor read.
     resetAllMotionData(true); // Reset and calibrate.
+
+  #if defined(MOTION_TASK)
+    // Hand the sensors over to their own task; the main loop reads them itself if it will not start.
+    if(!startMotionTask()) {
+      debugln(F("Motion task failed to start, reading sensors from the main loop"));
+    }
+  #endif
   }
   else {
     // Sensor malfunction detected, so disconnect Wire1.
@@ -282,12 +299,10 @@ void setup() {
 #endif
 
   // Scan i2c for 28/30 segment bargraph.
-  Wire.beginTransmission(0x70);
-  if(Wire.endTransmission() == 0) {
+  if(ht_bargraph.begin()) {
     // Set to 28-segment, though this will be overridden by EEPROM.
     debugln(F("28-segment bargraph found at address 0x70"));
     BARGRAPH_TYPE = SEGMENTS_28;
-    ht_bargraph.begin(0x00);
   }
 #ifndef ESP32
   else {
@@ -637,7 +652,7 @@ void mainLoop() {
 
   // Play the firing stream end animation.
   if(ms_firing_lights_end.justFinished()) {
-    fireStreamEnd(getHueColour(C_BLACK, WAND_BARREL_LED_COUNT));
+    fireStreamEnd(getBarrelColour(C_BLACK));
   }
 
   if(ms_semi_automatic_firing.justFinished()) {
@@ -647,6 +662,8 @@ void mainLoop() {
 
 // The main loop of the program which manages all system operations which must occur on every loop.
 void loop() {
+  updateBargraphLayout(); // Follow any change to the bargraph type or orientation.
+
   switch(WAND_CONN_STATE) {
     case PACK_DISCONNECTED:
       // While waiting for a proton pack, issue a request for synchronization.
@@ -691,6 +708,9 @@ void loop() {
     break;
   }
 
+  // Send any bargraph changes made during this pass as a single update.
+  ht_bargraph.commit();
+
   // Update the addressable LEDs and restart the timer.
   if(ms_fast_led.justFinished()) {
     FastLED[0].showLeds(255);
@@ -723,6 +743,11 @@ void loop() {
   // Run checks on web-related tasks.
   webLoops();
 
+  // Start sending the next queued infrared frame once the transmitter is free.
+  if(irManager != nullptr) {
+    irManager->update();
+  }
+
   // Check the motion sensors if they are available and the timer has completed.
   if(b_mag_found && b_imu_found) {
     checkMotionSensors();
@@ -0,0 +1,493 @@
+/**
+ * Motion Replay Tool
+ * Purpose: Replays recorded wand movement through the firmware's own motion pipeline (MotionPipeline.h)
+ *          natively, reporting the orientation it produces, when it detects shakes and what each sample
+ *          costs to process. Used to tune the filters and to catch performance regressions off-target.
+ *
+ * Compilation (from this directory, once a build of the esp32s3 environment has fetched Adafruit AHRS):
+ *   AHRS="../.pio/libdeps/esp32s3/Adafruit AHRS/src"
+ *   g++ -std=gnu++17 -O2 -I../include -I../../SharedLib/MagCalibration/include -I../../SharedLib/MotionFilter/include \
+ *     -I"$AHRS" MotionReplay.cpp ../../SharedLib/MotionFilter/src/MotionFilter.cpp "$AHRS/Adafruit_AHRS_Mahony.cpp" \
+ *     -lgtest -lpthread -o MotionReplay
+ *
+ * The unit test workflow builds and runs it in the same way, with Adafruit AHRS fetched by PlatformIO.
+ *
+ * Usage:
+ *   ./MotionReplay [googletest options] [log files...]
+ *
+ * Without any log files the detailed breakdowns in movement/ are replayed. Accepted formats, mixed freely:
+ *   - "Uni:" lines captured from the serial monitor while reporting calibration data (all 9 axes, with the
+ *     gyroscope in rad/s), optionally prefixed with the "HH:MM:SS.mmm > " of the monitor's time filter.
+ *   - Lines of x,y,z (magnetometer) or all 9 axes in the "Uni:" order, as made by commands.txt.
+ *   - The per-sample tables written by MagAnalysisTool (magnetometer only).
+ * Magnetometer-only samples are replayed as if the wand were held level and still.
+ *
+ * Copyright (C) 2023-2026 Michael Rajotte, Dustin Grau, Nomake Wan
+ */
+
+#include <gtest/gtest.h>
+
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+// Count CPU cycles spent filtering with the time stamp counter where there is one.
+#if defined(__x86_64__) || defined(__i386__)
+  #include <x86intrin.h>
+  #define MOTION_PIPELINE_CYCLES() ((uint32_t)__rdtsc())
+#endif
+
+#if !__has_include(<Adafruit_AHRS_Mahony.h>)
+  #error "Adafruit AHRS was not found; add its src directory to the include path (see Compilation above)."
+#endif
+#include <Adafruit_AHRS_Mahony.h>
+
+#include "MotionPipeline.h"
+
+// Rate the wand processes telemetry at by default (i_sensor_read_delay of 20 ms).
+static constexpr float REPLAY_SAMPLE_HZ = 50.0f;
+
+// Logs replayed when none are named on the command line.
+static const char* const DEFAULT_REPLAY_LOGS[] = {
+  "movement/production40_last3_analysis.txt",
+  "movement/production60_last3_analysis.txt",
+  "movement/production80_last3_analysis.txt"
+};
+
+static std::vector<std::string> replayLogFiles;
+
+// Structure: ReplaySample
+// Purpose: One oriented sample from a log, with the time it was captured where the log has one.
+struct ReplaySample {
+  OrientedSensorData oriented;
+  uint32_t timeMs = 0;
+  bool timed = false;
+  bool magnetometerOnly = false;
+};
+
+// Structure: ReplayLog
+// Purpose: Every sample read from one log file.
+struct ReplayLog {
+  std::string filename;
+  std::vector<ReplaySample> samples;
+  uint32_t skippedLines = 0;
+};
+
+// Structure: ReplayResult
+// Purpose: What the pipeline made of a replayed log.
+struct ReplayResult {
+  uint32_t samples = 0;
+  bool finite = true;              // Every output was a number.
+  float maxQuaternionError = 0.0f; // Largest distance of the quaternion's norm from 1.
+  float minYaw = 360.0f, maxYaw = 0.0f;
+  float minRoll = 180.0f, maxRoll = -180.0f;
+  float minPitch = 90.0f, maxPitch = -90.0f;
+  SpatialData last;                // Orientation after the final sample.
+  std::vector<float> shakeTimes;   // Time (s) of each sample detected as a shake.
+  uint32_t shakeEvents = 0;        // Runs of consecutive shaken samples.
+  uint64_t filterCycles = 0;       // Spent in the filters (MOTION_PIPELINE_CYCLES).
+  double elapsedNs = 0.0;          // Spent in processMotionSample.
+};
+
+// Function: parseMonitorTime
+// Purpose: Reads the "HH:MM:SS.mmm" the serial monitor's time filter puts before each line.
+static bool parseMonitorTime(const std::string& prefix, uint32_t& timeMs) {
+  unsigned int h, m, s, ms;
+  if(sscanf(prefix.c_str(), " %u:%u:%u.%u", &h, &m, &s, &ms) != 4) {
+    return false;
+  }
+
+  timeMs = ((h * 60 + m) * 60 + s) * 1000 + ms;
+  return true;
+}
+
+// Function: parseValues
+// Purpose: Splits a line on the separator into numbers, failing on anything else.
+static bool parseValues(const std::string& text, char separator, std::vector<float>& values) {
+  std::stringstream ss(text);
+  std::string token;
+
+  values.clear();
+  while(std::getline(ss, token, separator)) {
+    char* end = nullptr;
+    float value = strtof(token.c_str(), &end);
+
+    while(end != nullptr && (*end == ' ' || *end == '\r' || *end == '\t')) {
+      end++;
+    }
+
+    if(end == token.c_str() || (end != nullptr && *end != '\0')) {
+      return false;
+    }
+
+    values.push_back(value);
+  }
+
+  return !values.empty();
+}
+
+// Function: parseReplayLine
+// Purpose: Reads one line of any of the accepted formats. Returns false for lines which hold no sample.
+static bool parseReplayLine(const std::string& line, ReplaySample& sample) {
+  std::string text = line;
+  std::vector<float> values;
+
+  sample = ReplaySample();
+
+  // Monitor timestamp, as in "20:47:28.123 > Uni:..."
+  size_t marker = text.find(" > ");
+  if(marker != std::string::npos) {
+    sample.timed = parseMonitorTime(text.substr(0, marker), sample.timeMs);
+    text = text.substr(marker + 3);
+  }
+
+  if(text.compare(0, 4, "Raw:") == 0) {
+    return false; // Integer copies of the "Uni:" values for MotionCal.
+  }
+
+  if(text.compare(0, 4, "Uni:") == 0) {
+    text = text.substr(4);
+  }
+
+  if(text.find('|') != std::string::npos) {
+    // MagAnalysisTool table row: "Line | X | Y | Z | Mag | ...", of which only the first 4 columns are needed.
+    size_t columns = 0;
+    for(size_t i = 0; i < 4 && columns != std::string::npos; i++) {
+      columns = text.find('|', columns + (i > 0 ? 1 : 0));
+    }
+
+    if(columns == std::string::npos || !parseValues(text.substr(0, columns), '|', values) || values.size() != 4) {
+      return false;
+    }
+
+    sample.oriented.magX = values[1];
+    sample.oriented.magY = values[2];
+    sample.oriented.magZ = values[3];
+    sample.magnetometerOnly = true;
+  }
+  else {
+    if(!parseValues(text, ',', values)) {
+      return false;
+    }
+
+    if(values.size() == 9) {
+      sample.oriented.accelX = values[0];
+      sample.oriented.accelY = values[1];
+      sample.oriented.accelZ = values[2];
+      sample.oriented.gyroX = values[3];
+      sample.oriented.gyroY = values[4];
+      sample.oriented.gyroZ = values[5];
+      sample.oriented.magX = values[6];
+      sample.oriented.magY = values[7];
+      sample.oriented.magZ = values[8];
+    }
+    else if(values.size() == 3) {
+      sample.oriented.magX = values[0];
+      sample.oriented.magY = values[1];
+      sample.oriented.magZ = values[2];
+      sample.magnetometerOnly = true;
+    }
+    else {
+      return false;
+    }
+  }
+
+  if(sample.magnetometerOnly) {
+    // Held level and still: gravity along +Z (NED) and no rotation.
+    sample.oriented.accelZ = f_gravity;
+  }
+
+  return true;
+}
+
+// Function: loadReplayLog
+// Purpose: Reads every sample from a log file.
+static bool loadReplayLog(const std::string& filename, ReplayLog& log) {
+  std::ifstream file(filename);
+  std::string line;
+
+  log = ReplayLog();
+  log.filename = filename;
+
+  if(!file.is_open()) {
+    return false;
+  }
+
+  while(std::getline(file, line)) {
+    ReplaySample sample;
+
+    if(parseReplayLine(line, sample)) {
+      log.samples.push_back(sample);
+    }
+    else {
+      log.skippedLines++;
+    }
+  }
+
+  return !log.samples.empty();
+}
+
+// Function: replayLog
+// Purpose: Runs every sample of a log through the firmware pipeline as processTelemetrySample() does.
+static ReplayResult replayLog(const ReplayLog& log, bool b_filter_bank, float f_sample_hz = REPLAY_SAMPLE_HZ) {
+  ReplayResult result;
+  Adafruit_Mahony fusion;
+  CalibrationData calibration; // Logs hold uncalibrated readings.
+  MotionFilterBanks banks;
+  MotionData data, filtered;
+  SpatialData spatial;
+  const float f_period = 1.0f / f_sample_hz;
+  float f_time = 0.0f;
+  bool b_was_shaken = false;
+
+  beginOrientation(fusion, f_sample_hz);
+  banks.configure(f_sample_hz);
+
+  for(size_t i = 0; i < log.samples.size(); i++) {
+    const ReplaySample& sample = log.samples[i];
+    float f_interval = f_period;
+
+    // Use the capture times where they are steady enough to trust (as getImuSampleInterval() does).
+    if(i > 0 && sample.timed && log.samples[i - 1].timed) {
+      uint32_t i_delta = sample.timeMs - log.samples[i - 1].timeMs;
+      if(i_delta > 0 && i_delta <= f_period * 4000.0f) {
+        f_interval = i_delta / 1000.0f;
+      }
+    }
+
+    f_time += f_interval;
+
+    applyOrientedSample(sample.oriented, calibration, data);
+
+    auto start = std::chrono::steady_clock::now();
+    result.filterCycles += processMotionSample(fusion, data, filtered, spatial, nullptr,
+                                               b_filter_bank ? &banks : nullptr, f_interval, FILTER_ALPHA);
+    result.elapsedNs += std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count();
+
+    float f_norm = sqrtf(spatial.quaternion[0] * spatial.quaternion[0] + spatial.quaternion[1] * spatial.quaternion[1] +
+                         spatial.quaternion[2] * spatial.quaternion[2] + spatial.quaternion[3] * spatial.quaternion[3]);
+
+    if(!std::isfinite(f_norm) || !std::isfinite(spatial.roll) || !std::isfinite(spatial.pitch) ||
+       !std::isfinite(spatial.yaw) || !std::isfinite(filtered.gForce) || !std::isfinite(filtered.angVel)) {
+      result.finite = false;
+    }
+
+    result.maxQuaternionError = std::max(result.maxQuaternionError, fabsf(f_norm - 1.0f));
+    result.minYaw = std::min(result.minYaw, spatial.yaw);
+    result.maxYaw = std::max(result.maxYaw, spatial.yaw);
+    result.minRoll = std::min(result.minRoll, spatial.roll);
+    result.maxRoll = std::max(result.maxRoll, spatial.roll);
+    result.minPitch = std::min(result.minPitch, spatial.pitch);
+    result.maxPitch = std::max(result.maxPitch, spatial.pitch);
+
+    if(filtered.shaken) {
+      result.shakeTimes.push_back(f_time);
+
+      if(!b_was_shaken) {
+        result.shakeEvents++;
+      }
+    }
+
+    b_was_shaken = filtered.shaken;
+  }
+
+  result.samples = log.samples.size();
+  result.last = spatial;
+  return result;
+}
+
+// Function: makeShakeLog
+// Purpose: A still wand, shaken back and forth from still_s for shake_s seconds, then still again.
+static ReplayLog makeShakeLog(float f_still_s, float f_shake_s) {
+  ReplayLog log;
+  const float f_shake_hz = 4.0f;
+  const uint32_t i_samples = (uint32_t)((f_still_s * 2.0f + f_shake_s) * REPLAY_SAMPLE_HZ);
+
+  log.filename = "synthetic shake";
+
+  for(uint32_t i = 0; i < i_samples; i++) {
+    float f_time = i / REPLAY_SAMPLE_HZ;
+    ReplaySample sample;
+
+    sample.oriented.accelZ = f_gravity;
+    sample.oriented.magX = 20.0f;
+    sample.oriented.magZ = 40.0f;
+
+    if(f_time >= f_still_s && f_time < f_still_s + f_shake_s) {
+      float f_phase = sinf(2.0f * (float)M_PI * f_shake_hz * (f_time - f_still_s));
+      sample.oriented.accelX = 2.0f * f_gravity * f_phase; // +/-2 g along the barrel.
+      sample.oriented.gyroZ = 6.0f * f_phase;             // +/-344 deg/s (in rad/s) swinging side to side.
+    }
+
+    log.samples.push_back(sample);
+  }
+
+  return log;
+}
+
+// Function: getReplayLogs
+// Purpose: Loads the logs named on the command line, or the defaults.
+static std::vector<ReplayLog> getReplayLogs() {
+  std::vector<ReplayLog> logs;
+
+  if(replayLogFiles.empty()) {
+    for(const char* filename : DEFAULT_REPLAY_LOGS) {
+      replayLogFiles.push_back(filename);
+    }
+  }
+
+  for(const std::string& filename : replayLogFiles) {
+    ReplayLog log;
+    EXPECT_TRUE(loadReplayLog(filename, log)) << "No samples read from " << filename;
+    if(!log.samples.empty()) {
+      logs.push_back(log);
+    }
+  }
+
+  return logs;
+}
+
+static void printReplayResult(const char* label, const ReplayLog& log, const ReplayResult& result) {
+  printf("[          ] %s %s: %u samples\n", label, log.filename.c_str(), result.samples);
+  printf("[          ]   final roll %.1f pitch %.1f yaw %.1f, roll %.1f..%.1f pitch %.1f..%.1f yaw %.1f..%.1f\n",
+         result.last.roll, result.last.pitch, result.last.yaw, result.minRoll, result.maxRoll,
+         result.minPitch, result.maxPitch, result.minYaw, result.maxYaw);
+  printf("[          ]   %u shake events over %zu samples", result.shakeEvents, result.shakeTimes.size());
+  if(!result.shakeTimes.empty()) {
+    printf(", first at %.2f s, last at %.2f s", result.shakeTimes.front(), result.shakeTimes.back());
+  }
+  printf("\n");
+}
+
+TEST(MotionReplay, ParsesEachLogFormat) {
+  ReplaySample sample;
+
+  ASSERT_TRUE(parseReplayLine("20:47:28.123 > Uni:0.12,-0.34,9.81,0.0100,-0.0200,0.0300,-61.68,34.05,-12.89", sample));
+  EXPECT_TRUE(sample.timed);
+  EXPECT_EQ(sample.timeMs, ((20u * 60 + 47) * 60 + 28) * 1000 + 123);
+  EXPECT_FALSE(sample.magnetometerOnly);
+  EXPECT_FLOAT_EQ(sample.oriented.accelZ, 9.81f);
+  EXPECT_FLOAT_EQ(sample.oriented.gyroZ, 0.03f);
+  EXPECT_FLOAT_EQ(sample.oriented.magX, -61.68f);
+
+  ASSERT_TRUE(parseReplayLine("-61.68,34.05,-12.89", sample));
+  EXPECT_FALSE(sample.timed);
+  EXPECT_TRUE(sample.magnetometerOnly);
+  EXPECT_FLOAT_EQ(sample.oriented.magZ, -12.89f);
+  EXPECT_FLOAT_EQ(sample.oriented.accelZ, f_gravity);
+
+  ASSERT_TRUE(parseReplayLine("   1 |    -61.68 |     34.05 |    -12.89 |  71.6 |151.1 |-10.4 |  36 |   8 | 356 | YES", sample));
+  EXPECT_TRUE(sample.magnetometerOnly);
+  EXPECT_FLOAT_EQ(sample.oriented.magY, 34.05f);
+
+  EXPECT_FALSE(parseReplayLine("20:47:28.123 > Raw:12,-34,8192,0,0,0,-616,340,-128", sample));
+  EXPECT_FALSE(parseReplayLine("Line |     X     |     Y     |     Z     |  Mag  | Az°", sample));
+  EXPECT_FALSE(parseReplayLine("Total Samples: 3597", sample));
+}
+
+TEST(MotionReplay, RecordedLogsGiveAStableOrientation) {
+  for(const ReplayLog& log : getReplayLogs()) {
+    for(bool b_filter_bank : {false, true}) {
+      ReplayResult result = replayLog(log, b_filter_bank);
+      printReplayResult(b_filter_bank ? "bank" : "EMA ", log, result);
+
+      EXPECT_TRUE(result.finite) << log.filename;
+      EXPECT_LT(result.maxQuaternionError, 1e-3f) << log.filename;
+      EXPECT_GE(result.minYaw, 0.0f) << log.filename;
+      EXPECT_LT(result.maxYaw, 360.0f) << log.filename;
+    }
+  }
+}
+
+TEST(MotionReplay, StillSamplesNeverShake) {
+  for(const ReplayLog& log : getReplayLogs()) {
+    bool b_still = true;
+    for(const ReplaySample& sample : log.samples) {
+      b_still = b_still && sample.magnetometerOnly;
+    }
+
+    if(!b_still) {
+      continue; // Only logs without motion readings are known to hold no shake.
+    }
+
+    EXPECT_EQ(replayLog(log, false).shakeEvents, 0u) << log.filename;
+    EXPECT_EQ(replayLog(log, true).shakeEvents, 0u) << log.filename;
+  }
+}
+
+TEST(MotionReplay, ShakeIsDetectedPromptlyAndEnds) {
+  const float f_still_s = 1.0f;
+  const float f_shake_s = 1.0f;
+  ReplayLog log = makeShakeLog(f_still_s, f_shake_s);
+
+  for(bool b_filter_bank : {false, true}) {
+    ReplayResult result = replayLog(log, b_filter_bank);
+    printReplayResult(b_filter_bank ? "bank" : "EMA ", log, result);
+
+    ASSERT_FALSE(result.shakeTimes.empty());
+    float f_latency = result.shakeTimes.front() - f_still_s;
+    float f_release = result.shakeTimes.back() - (f_still_s + f_shake_s);
+    printf("[          ]   detected %.0f ms after the shake began, last %.0f ms after it ended\n",
+           f_latency * 1000.0f, f_release * 1000.0f);
+
+    // Caught within the first swing, and let go of within a few samples.
+    EXPECT_GE(f_latency, 0.0f);
+    EXPECT_LT(f_latency, 0.125f);
+    EXPECT_LT(f_release, 0.1f);
+  }
+}
+
+/*
+ * Stored baseline, on a desktop x86-64 at -O2: about 310 ns (EMA) and 490 ns (filter bank) per sample through
+ * the pipeline, of which 60 and 390 cycles are spent filtering. The limits allow for slower CI machines while
+ * still failing when a change makes a sample several times more expensive to process.
+ */
+static const double MAX_PIPELINE_NS_PER_SAMPLE[2] = {1500.0, 2500.0};    // EMA, filter bank.
+static const double MAX_FILTER_CYCLES_PER_SAMPLE[2] = {250.0, 1600.0}; // Only where there is a cycle counter.
+
+TEST(MotionReplayBenchmark, CostPerSample) {
+  std::vector<ReplayLog> logs = getReplayLogs();
+  logs.push_back(makeShakeLog(1.0f, 1.0f));
+
+  for(bool b_filter_bank : {false, true}) {
+    const int i_passes = 20;
+    uint64_t i_samples = 0;
+    uint64_t i_filter_cycles = 0;
+    double f_elapsed_ns = 0.0;
+
+    for(int pass = 0; pass < i_passes; pass++) {
+      for(const ReplayLog& log : logs) {
+        ReplayResult result = replayLog(log, b_filter_bank);
+        i_samples += result.samples;
+        i_filter_cycles += result.filterCycles;
+        f_elapsed_ns += result.elapsedNs;
+      }
+    }
+
+    ASSERT_GT(i_samples, 0u);
+    printf("[          ] %s: %.0f ns per sample (pipeline), %.1f cycles per sample filtering, %llu samples\n",
+           b_filter_bank ? "filter bank" : "EMA        ", f_elapsed_ns / i_samples,
+           (double)i_filter_cycles / i_samples, (unsigned long long)i_samples);
+
+    EXPECT_LT(f_elapsed_ns / i_samples, MAX_PIPELINE_NS_PER_SAMPLE[b_filter_bank]);
+
+    if(i_filter_cycles > 0) {
+      EXPECT_LT((double)i_filter_cycles / i_samples, MAX_FILTER_CYCLES_PER_SAMPLE[b_filter_bank]);
+    }
+  }
+}
+
+int main(int argc, char** argv) {
+  ::testing::InitGoogleTest(&argc, argv);
+
+  // Whatever googletest leaves is a log file to replay.
+  for(int i = 1; i < argc; i++) {
+    replayLogFiles.push_back(argv[i]);
+  }
+
+  return RUN_ALL_TESTS();
+}
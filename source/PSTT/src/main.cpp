@@ -212,6 +212,12 @@ void loop() {
 
   // Run checks on web-related tasks.
   webLoops();
+
+  // Start sending the next queued infrared frame once the transmitter is free.
+  if(irManager != nullptr) {
+    irManager->update();
+  }
+
   // (Re-)Start WiFi if the web server is not running.
   if(!b_httpd_started) {
     restartWireless();
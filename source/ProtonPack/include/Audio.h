@@ -1132,6 +1132,8 @@ bool musicTrackStatus() {
 }
 
 void checkMusic() {
+  PROFILE_SCOPE(PROFILE_MUSIC);
+
   if(ms_check_music.justFinished() && !ms_music_next_track.isRunning()) {
     switch(AUDIO_DEVICE) {
       case A_WAV_TRIGGER:
@@ -1384,6 +1386,8 @@ bool setupAudioDevice() {
 }
 
 void updateAudio() {
+  PROFILE_SCOPE(PROFILE_AUDIO);
+
   switch(AUDIO_DEVICE) {
     case A_WAV_TRIGGER:
     case A_GPSTAR_AUDIO:
@@ -0,0 +1,223 @@
+/**
+ *   GPStar Proton Pack - Ghostbusters Proton Pack & Neutrona Wand.
+ *   Copyright (C) 2023-2026 Michael Rajotte <michael.rajotte@gpstartechnologies.com>
+ *
+ *   This program is free software; you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation; either version 3 of the License, or
+ *   (at your option) any later version.
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License
+ *   along with this program; if not, see <https://www.gnu.org/licenses/>.
+ *
+ */
+
+#pragma once
+
+/*
+ * Boot stages and the time-to-ready report.
+ *
+ * setup() runs in dependency order: the serial links come first so the wand and Attenuator can be
+ * answered as early as possible, then the remaining hardware, then anything which needs the results
+ * of detection (preferences depend on the audio device found, the i2c scheduler on the sensors found).
+ *
+ * On the ESP32 the slowest independent stages (audio device detection and i2c sensor probing) run
+ * in their own tasks while the main task sets up the LEDs and inputs. setup() then returns without
+ * waiting for them: loop() keeps the wand serial link drained and polls for the tasks to finish,
+ * after which it runs the dependent stages. A wand sync requested meanwhile is answered as soon as
+ * those stages are done, since the sync carries the audio version and the loaded preferences.
+ * The ATMega runs the same stages one after the other within setup().
+ *
+ * Every stage records when it started and finished. The pack is counted as ready the first time the
+ * main loop services the wand serial link with every stage complete. The report is sent with
+ * sendDebug() once ready, and is also available as JSON from the /debug/boot route (ESP32).
+ * WiFi is started later by the main loop, once the POST has finished and no Attenuator has claimed
+ * the pack, so its stage is reported on its own when it completes.
+ */
+enum BOOT_STAGES : uint8_t {
+  BOOT_SERIAL,      // Console, wand and Attenuator serial links.
+  BOOT_LEDS,        // FastLED setup and the first frame.
+  BOOT_AUDIO,       // Audio device detection and the music track count.
+  BOOT_SENSORS,     // i2c bus, temperature sensor and power meter probing.
+  BOOT_INPUTS,      // Switches, rotary encoder and output pins.
+  BOOT_PREFERENCES, // Stored preferences and the master volume.
+  BOOT_SYSTEM,      // LED counts, ramps, timers and the start of the POST.
+  BOOT_WIRELESS,    // First start of WiFi and the web server (ESP32), after the pack is ready.
+  BOOT_STAGE_COUNT
+};
+
+struct BootStage {
+  uint32_t i_start = 0; // micros() when the stage began.
+  uint32_t i_end = 0;   // micros() when the stage finished.
+};
+
+BootStage boot_stages[BOOT_STAGE_COUNT];
+uint32_t i_boot_setup_start = 0; // micros() on entry to setup(), which includes the time taken by the bootloader.
+uint32_t i_boot_ready = 0; // micros() when the wand serial link was first serviced after every stage, or 0 until then.
+uint32_t i_boot_wand_heard = 0; // micros() when the wand first asked to sync while the pack was booting, or 0.
+bool b_boot_finished = false; // Set once the stages which depend on audio and sensor detection have run.
+bool b_boot_wand_sync_pending = false; // The wand asked to sync before the pack could answer it.
+const uint16_t i_boot_ready_target = 500; // Target time to ready in milliseconds, for the report.
+
+void bootStageBegin(uint8_t i_stage) {
+  boot_stages[i_stage].i_start = micros();
+}
+
+void bootStageEnd(uint8_t i_stage) {
+  boot_stages[i_stage].i_end = micros();
+}
+
+const __FlashStringHelper* getBootStageName(uint8_t i_stage) {
+  switch(i_stage) {
+    case BOOT_SERIAL:
+      return F("serial");
+    case BOOT_LEDS:
+      return F("leds");
+    case BOOT_AUDIO:
+      return F("audio");
+    case BOOT_SENSORS:
+      return F("sensors");
+    case BOOT_INPUTS:
+      return F("inputs");
+    case BOOT_PREFERENCES:
+      return F("preferences");
+    case BOOT_SYSTEM:
+      return F("system");
+    case BOOT_WIRELESS:
+      return F("wireless");
+    default:
+      return F("unknown");
+  }
+}
+
+// Sends the start and duration of a stage, in milliseconds since reset.
+void reportBootStage(uint8_t i_stage) {
+  sendDebug(String(F("Boot: ")) + getBootStageName(i_stage) + F(" at ") + String(boot_stages[i_stage].i_start / 1000.0, 1) +
+            F("ms took ") + String((boot_stages[i_stage].i_end - boot_stages[i_stage].i_start) / 1000.0, 1) + F("ms"));
+}
+
+// Sends every stage which has run so far, along with the time to ready.
+void reportBoot() {
+  sendDebug(String(F("Boot: setup() entered at ")) + String(i_boot_setup_start / 1000.0, 1) + F("ms"));
+
+  for(uint8_t i = 0; i < BOOT_STAGE_COUNT; i++) {
+    if(boot_stages[i].i_end != 0) {
+      reportBootStage(i);
+    }
+  }
+
+  if(i_boot_wand_heard != 0) {
+    sendDebug(String(F("Boot: wand asked to sync at ")) + String(i_boot_wand_heard / 1000.0, 1) + F("ms"));
+  }
+
+  sendDebug(String(F("Boot: ready after ")) + String(i_boot_ready / 1000.0, 1) + F("ms (target ") +
+            String(i_boot_ready_target) + F("ms)"));
+}
+
+// Called each time the main loop services the wand serial link, recording the first as the time the pack became ready.
+void markBootReady() {
+  if(i_boot_ready == 0) {
+    i_boot_ready = micros();
+    reportBoot();
+  }
+}
+
+// Detects the audio device, which may wait up to 1 second for a response.
+void bootAudioStage() {
+  bootStageBegin(BOOT_AUDIO);
+  setupAudioDevice();
+  bootStageEnd(BOOT_AUDIO);
+}
+
+// Probes the i2c devices, which can take several milliseconds each.
+void bootSensorStage() {
+  bootStageBegin(BOOT_SENSORS);
+  setupI2CDevices();
+  bootStageEnd(BOOT_SENSORS);
+}
+
+#ifdef ESP32
+SemaphoreHandle_t boot_stages_done = NULL; // Given once by each concurrent stage as it finishes.
+SemaphoreHandle_t debug_mutex = NULL; // Lets sendDebug() be called from the boot tasks and the main loop alike.
+const uint8_t i_boot_concurrent_stages = 2;
+uint8_t i_boot_stages_finished = 0;
+
+void BootAudioTask(void *parameter) {
+  bootAudioStage();
+  xSemaphoreGive(boot_stages_done);
+  vTaskDelete(NULL);
+}
+
+void BootSensorTask(void *parameter) {
+  bootSensorStage();
+  xSemaphoreGive(boot_stages_done);
+  vTaskDelete(NULL);
+}
+
+// Starts the independent stages on the core opposite to setup(), falling back to running them in place.
+void startConcurrentBootStages() {
+  uint8_t i_core = xPortGetCoreID() == 0 ? 1 : 0;
+
+  // Debug output from the boot tasks must not interleave with the main loop's.
+  debug_mutex = xSemaphoreCreateMutex();
+
+  boot_stages_done = xSemaphoreCreateCounting(i_boot_concurrent_stages, 0);
+
+  if(boot_stages_done == NULL) {
+    bootAudioStage();
+    bootSensorStage();
+    return;
+  }
+
+  if(xTaskCreatePinnedToCore(BootAudioTask, "BootAudioTask", 4096, NULL, 2, NULL, i_core) != pdPASS) {
+    bootAudioStage();
+    xSemaphoreGive(boot_stages_done);
+  }
+
+  if(xTaskCreatePinnedToCore(BootSensorTask, "BootSensorTask", 4096, NULL, 2, NULL, i_core) != pdPASS) {
+    bootSensorStage();
+    xSemaphoreGive(boot_stages_done);
+  }
+}
+
+// Returns true once every concurrent stage has finished, after which their results may be used. Never waits.
+bool concurrentBootStagesDone() {
+  if(boot_stages_done == NULL) {
+    return true;
+  }
+
+  while(i_boot_stages_finished < i_boot_concurrent_stages && xSemaphoreTake(boot_stages_done, 0) == pdTRUE) {
+    i_boot_stages_finished++;
+  }
+
+  if(i_boot_stages_finished < i_boot_concurrent_stages) {
+    return false;
+  }
+
+  vSemaphoreDelete(boot_stages_done);
+  boot_stages_done = NULL;
+
+  return true;
+}
+
+// Services the wand serial link while the concurrent stages finish, so nothing the wand sends is left waiting.
+// Only a sync request can be acted on before the wand is connected, and it is answered once the pack is ready.
+void checkWandDuringBoot() {
+  if(wandComs.available() > 0 && wandComs.currentPacketID() == PACKET_COMMAND) {
+    wandComs.rxObj(recvCmdW);
+
+    if(recvCmdW.s == W_COM_START && recvCmdW.e == W_COM_END && (recvCmdW.c == W_HANDSHAKE || recvCmdW.c == W_SYNC_NOW)) {
+      if(i_boot_wand_heard == 0) {
+        i_boot_wand_heard = micros();
+      }
+
+      b_boot_wand_sync_pending = true;
+    }
+  }
+}
+#endif
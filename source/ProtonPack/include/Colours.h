@@ -282,6 +282,12 @@ uint8_t getDeviceColour(uint8_t i_device, uint8_t i_firing_mode, bool b_toggle)
   }
 }
 
+#if defined(DEBUG_COLOUR_STATS)
+  uint32_t i_get_hue_calls = 0; // Full HSV resolutions via getHue().
+  uint32_t i_palette_reads = 0; // Lookups answered by the palette cache.
+  millisDelay ms_colour_stats;
+#endif
+
 CHSV getHue(uint8_t i_device, uint8_t i_colour, uint8_t i_brightness = 255, uint8_t i_saturation = 255, bool b_fade = false) {
   // Brightness here is a value from 0-255 as limited by byte (uint8_t) type.
 
@@ -291,6 +297,10 @@ CHSV getHue(uint8_t i_device, uint8_t i_colour, uint8_t i_brightness = 255, uint
   uint8_t i_cycle = 2;
   uint8_t i_output_colour = i_curr_colour[i_device];
 
+#if defined(DEBUG_COLOUR_STATS)
+  i_get_hue_calls++;
+#endif
+
   switch(i_device) {
     case CYCLOTRON_OUTER:
       if(gpstarPack.isThemeModern()) {
@@ -525,15 +535,137 @@ CHSV getHue(uint8_t i_device, uint8_t i_colour, uint8_t i_brightness = 255, uint
   }
 }
 
-CRGB getHueAsRGB(uint8_t i_device, uint8_t i_colour, uint8_t i_brightness = 255, bool b_grb = false, bool b_fade = false) {
-  // Brightness here is a value from 0-255 as limited by byte (uint8_t) type.
+/**
+ * Colour Palette Cache
+ *
+ * Each static colour's full-brightness RGB value is computed once and kept here. The
+ * hsv2rgb_rainbow() conversion applies brightness last, as scale8(channel, scale8_video(value, value)),
+ * so getPaletteColour() derives any brightness from the cached entry with nscale8() and gets the same
+ * result as a full conversion. Mode and theme never change a static colour. The custom spectral
+ * colours are keyed on the hue and saturation they were resolved from, so a change to those settings
+ * is picked up on the next read. Dynamic (cycling) colours carry per-device state and always go
+ * through getHue().
+ */
+CRGB palette_rgb[C_HASLAB + 1];
+bool b_palette_valid[C_HASLAB + 1] = {};
+uint16_t i_palette_custom_key[C_HASLAB - C_CUSTOM_POWERCELL] = {}; // Hue and saturation each custom colour was resolved from.
+
+bool isDynamicColour(uint8_t i_colour) {
+  // Colour cycles advance per-device state on each call and cannot be cached.
+  switch(i_colour) {
+    case C_REDGREEN:
+    case C_ORANGEPURPLE:
+    case C_BLUEFADE:
+    case C_PASTEL:
+    case C_RAINBOW:
+      return true;
+    break;
+
+    default:
+      return false;
+    break;
+  }
+}
+
+bool isFixedValueColour(uint8_t i_colour) {
+  // These colours override the requested brightness in getHue().
+  switch(i_colour) {
+    case C_BLACK:
+    case C_DARK_GREEN:
+    case C_NAVY_BLUE:
+      return true;
+    break;
+
+    default:
+      return false;
+    break;
+  }
+}
 
-  // Get the initial colour using the HSV scheme.
-  CHSV hsv = getHue(i_device, i_colour, i_brightness, 255, b_fade);
+// Returns the custom spectral hue and saturation behind a colour as a palette key, or 0 for any other colour.
+uint16_t getCustomColourKey(uint8_t i_colour) {
+  switch(i_colour) {
+    case C_CUSTOM_POWERCELL:
+      return (i_spectral_powercell_custom_colour << 8) | i_spectral_powercell_custom_saturation;
+    break;
 
-  // Convert from HSV to RGB.
+    case C_CUSTOM_CYCLOTRON:
+      return (i_spectral_cyclotron_custom_colour << 8) | i_spectral_cyclotron_custom_saturation;
+    break;
+
+    case C_CUSTOM_INNER_CYCLOTRON:
+      return (i_spectral_cyclotron_inner_custom_colour << 8) | i_spectral_cyclotron_inner_custom_saturation;
+    break;
+
+    default:
+      return 0;
+    break;
+  }
+}
+
+// Returns the RGB value of a static colour at the requested brightness using the palette cache.
+CRGB getPaletteColour(uint8_t i_colour, uint8_t i_brightness = 255) {
+  if(i_colour > C_HASLAB) {
+    i_colour = C_WHITE; // Matches the default case of getHue().
+  }
+
+  if(i_colour >= C_CUSTOM_POWERCELL && i_colour < C_HASLAB) {
+    // Custom colours are resolved again whenever their hue or saturation has changed.
+    uint16_t i_key = getCustomColourKey(i_colour);
+
+    if(i_key != i_palette_custom_key[i_colour - C_CUSTOM_POWERCELL]) {
+      i_palette_custom_key[i_colour - C_CUSTOM_POWERCELL] = i_key;
+      b_palette_valid[i_colour] = false;
+    }
+  }
+
+  if(!b_palette_valid[i_colour]) {
+    // Device is irrelevant for static colours, so resolve as the Power Cell.
+    hsv2rgb_rainbow(getHue(POWERCELL, i_colour), palette_rgb[i_colour]);
+    b_palette_valid[i_colour] = true;
+  }
+
+#if defined(DEBUG_COLOUR_STATS)
+  i_palette_reads++;
+#endif
+
+  CRGB rgb = palette_rgb[i_colour];
+
+  if(i_brightness != 255 && !isFixedValueColour(i_colour)) {
+    // Same brightness curve as applied by hsv2rgb_rainbow().
+    rgb.nscale8(scale8_video(i_brightness, i_brightness));
+  }
+
+  return rgb;
+}
+
+#if defined(DEBUG_COLOUR_STATS)
+// Reports the number of colour resolutions performed over the last second.
+void reportColourStats() {
+  if(!ms_colour_stats.isRunning()) {
+    ms_colour_stats.start(1000);
+  }
+  else if(ms_colour_stats.justFinished()) {
+    sendDebug("getHue/s: " + String(i_get_hue_calls) + ", palette/s: " + String(i_palette_reads));
+    i_get_hue_calls = 0;
+    i_palette_reads = 0;
+    ms_colour_stats.start(1000);
+  }
+}
+#endif
+
+CRGB getHueAsRGB(uint8_t i_device, uint8_t i_colour, uint8_t i_brightness = 255, bool b_grb = false, bool b_fade = false) {
+  // Brightness here is a value from 0-255 as limited by byte (uint8_t) type.
   CRGB rgb; // RGB Array as { r, g, b }
-  hsv2rgb_rainbow(hsv, rgb);
+
+  if(isDynamicColour(i_colour)) {
+    // Get the initial colour using the HSV scheme, then convert from HSV to RGB.
+    hsv2rgb_rainbow(getHue(i_device, i_colour, i_brightness, 255, b_fade), rgb);
+  }
+  else {
+    // Static colours are read from the palette cache.
+    rgb = getPaletteColour(i_colour, i_brightness);
+  }
 
   if(b_grb) {
     // Swap red/green values before returning.
@@ -552,12 +684,8 @@ CRGB getHueAsGRB(uint8_t i_device, uint8_t i_colour, uint8_t i_brightness = 255)
 CRGB getHueAsGBR(uint8_t i_device, uint8_t i_colour, uint8_t i_brightness = 255) {
   // Brightness here is a value from 0-255 as limited by byte (uint8_t) type.
 
-  // Get the initial colour using the HSV scheme.
-  CHSV hsv = getHue(i_device, i_colour, i_brightness);
-
-  // Convert from HSV to RGB.
-  CRGB rgb; // RGB Array as { r, g, b }
-  hsv2rgb_rainbow(hsv, rgb);
+  // Get the colour as RGB, using the palette cache where possible.
+  CRGB rgb = getHueAsRGB(i_device, i_colour, i_brightness);
 
   // Swap colour values before returning.
   return CRGB(rgb[1], rgb[2], rgb[0]);
@@ -35,6 +35,8 @@
 //#define DEBUG_SEND_TO_CONSOLE   // Send any general messages to the serial (USB) console.
 //#define DEBUG_SEND_TO_WEBSOCKET // Send any messages to connected WebSocket clients.
 //#define DEBUG_SEND_TO_EVENTS    // Send any messages to the server-side events stream.
+//#define DEBUG_COLOUR_STATS      // Report getHue() calls and palette cache reads per second.
+//#define DEBUG_LED_OUTPUT        // Report main loop time and LED output timing per second.
 
 /*
  * Force the use of default SSID and password for wireless capabilities.
@@ -44,12 +46,73 @@
  */
 //#define RESET_AP_SETTINGS
 
+/*
+ * Send LED data from a dedicated task on the second core of the ESP32.
+ * The main loop renders into a back buffer which is handed off to the
+ * output task for each frame, so the time taken to send data to the
+ * LED chains no longer adds to the main loop. Uses ~400 bytes of RAM.
+ */
+//#define LED_OUTPUT_TASK
+
+/*
+ * Put the ESP32 into light sleep while the pack is off and idle.
+ * Sleeps only once the pack has been quiet for 5 seconds with the WiFi off and no
+ * Attenuator connected, and wakes on any switch, the volume knob, or data from either
+ * serial link. A connected wand is asked to send a wake byte ahead of its messages,
+ * which needs the matching wand firmware. The serial (USB) console stops while asleep.
+ */
+//#define IDLE_LIGHT_SLEEP
+
+/*
+ * Let the ESP32 choose its CPU frequency (80, 160 or 240 MHz) from the load on the main loop,
+ * rather than running at a fixed 160 MHz. Goes to 240 MHz as soon as the loop is busy and steps
+ * back down once the load would stay comfortable at a lower frequency for 2 seconds. The time
+ * spent at each frequency is available from the /debug/cpu route.
+ */
+//#define CPU_GOVERNOR
+
 /*
  * Enable Visual Feedback Effects (UI Animations)
  */
 bool b_enable_ui_animations = true; // Enable/disable UI animation effects
 #endif
 
+/*
+ * Benchmark the Cyclotron Lid lookup tables once during startup (ATMega or ESP32).
+ * Results are printed to the serial (USB) console, so only use this during development.
+ */
+//#define BENCHMARK_CYCLOTRON_LOOKUP
+
+/*
+ * Profile the time taken by each section of the main loop (ATMega or ESP32).
+ * Send "p" over the serial (USB) console to print min/avg/max/p99 times, or "r" to reset them.
+ * The bus time used by each i2c device is reported alongside the loop sections.
+ * On the ESP32 results are also available as JSON from the /debug/perf route.
+ * Uses ~1.6KB of RAM on the ATMega, so only use this during development.
+ */
+//#define LOOP_PROFILER
+
+/*
+ * Record any pass of the main loop which takes longer than i_stall_threshold (see StallWatchdog.h).
+ * Each record names the section which was running (ESP32) or took longest (ATMega), along with the
+ * state of the pack, and on the ESP32 a backtrace which can be decoded with addr2line. Records are
+ * kept in memory which survives a reset, but not a loss of power.
+ * Send "s" over the serial (USB) console to print the records, or "c" to clear them.
+ * On the ESP32 records are also available as JSON from the /debug/stalls route.
+ */
+//#define STALL_WATCHDOG
+
+/*
+ * Keep a log of system events (resets, startup and shutdown, overheating, venting, the wand connecting
+ * and disconnecting, and low supply voltage) which can be read after a failure (see FlightRecorder.h).
+ * The ESP32 keeps the log in memory which survives a reset but not a loss of power, while the ATMega
+ * keeps it in the upper half of the EEPROM.
+ * Send "e" over the serial (USB) console to print the log, or "z" to clear it.
+ * On the ESP32 the log can also be downloaded from the /debug/events route.
+ * Use scripts/decode_flight_log.py to decode either.
+ */
+//#define FLIGHT_RECORDER
+
 /*
  * -------------****** CUSTOM USER CONFIGURABLE SETTINGS ******-------------
  * Change the variables below to alter the behaviour of your Proton Pack.
@@ -89,25 +152,21 @@ uint16_t i_1984_delay = CYCLOTRON_DELAY_TVG; // Default to TVG as b_fade_cyclotr
 #define CYCLOTRON_DELAY_2021_40_LED 7 // For 40 LEDs.
 
 /*
- * This is the middle LED aligned in each lens window. (0 is the first LED). Adjust these settings if you use different LED setups and installations.
- * Put the sequence in order from lowest to highest in both directions. (Top right lens as Cyclotron lens #1)
+ * Cyclotron Lid geometry, with one row for each supported number of LEDs.
+ * The 2021 ring simulation tables and the 1984 lamp order in both directions are generated from these rows
+ * when compiling, so a new ring size only needs a new row here (the count must be a multiple of 4, up to 40).
+ *
+ * The 1984 lamps are the middle LED aligned in each lens window. (0 is the first LED). Adjust these settings if you use different LED setups and installations.
+ * Put the sequence in clockwise order starting with the top right lens as Cyclotron lens #1. The counter-clockwise order is derived from it.
  *
- * i_1984_cyclotron_4_leds is for a DIY 4 LED setup.
- * i_1984_cyclotron_12_leds is for the stock Haslab 12 LED setup.
- * i_1984_cyclotron_20_leds is for the Frutto Technology 20 LED setup.
- * i_1984_cyclotron_36_leds is for the GPStar 36 LED setup.
- * i_1984_cyclotron_40_leds is for a 40 LED NeoPixel ring.
- */
-const uint8_t i_1984_cyclotron_4_leds_cw[4] PROGMEM  = { 0, 1, 2, 3 };
-const uint8_t i_1984_cyclotron_4_leds_ccw[4] PROGMEM  = { 0, 3, 2, 1 };
-const uint8_t i_1984_cyclotron_12_leds_cw[4] PROGMEM = { 1, 4, 7, 10 };
-const uint8_t i_1984_cyclotron_12_leds_ccw[4] PROGMEM = { 1, 10, 7, 4 };
-const uint8_t i_1984_cyclotron_20_leds_cw[4] PROGMEM = { 2, 7, 12, 17 };
-const uint8_t i_1984_cyclotron_20_leds_ccw[4] PROGMEM = { 2, 17, 12, 7 };
-const uint8_t i_1984_cyclotron_36_leds_cw[4] PROGMEM = { 4, 13, 22, 31 };
-const uint8_t i_1984_cyclotron_36_leds_ccw[4] PROGMEM = { 4, 31, 22, 13 };
-const uint8_t i_1984_cyclotron_40_leds_cw[4] PROGMEM = { 0, 10, 18, 28 };
-const uint8_t i_1984_cyclotron_40_leds_ccw[4] PROGMEM = { 0, 28, 18, 10 };
+ * Columns: LED count, 2021 delay, 1984 lamp for lens #1, #2, #3, #4.
+ */
+#define CYCLOTRON_LID_GEOMETRY(ROW) \
+  ROW(QUAD_CYCLOTRON_LED_COUNT,   CYCLOTRON_DELAY_2021_36_LED, 0, 1, 2, 3)    /* DIY 4 LED setup. */ \
+  ROW(HASLAB_CYCLOTRON_LED_COUNT, CYCLOTRON_DELAY_2021_12_LED, 1, 4, 7, 10)   /* Stock Haslab 12 LED setup. */ \
+  ROW(FRUTTO_CYCLOTRON_LED_COUNT, CYCLOTRON_DELAY_2021_20_LED, 2, 7, 12, 17)  /* Frutto Technology 20 LED setup. */ \
+  ROW(MAX_CYCLOTRON_LED_COUNT,    CYCLOTRON_DELAY_2021_36_LED, 4, 13, 22, 31) /* GPStar 36 LED setup. */ \
+  ROW(OUTER_CYCLOTRON_LED_MAX,    CYCLOTRON_DELAY_2021_40_LED, 0, 10, 18, 28) /* 40 LED NeoPixel ring. */
 
 /*
  * Cyclotron direction
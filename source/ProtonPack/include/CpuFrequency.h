@@ -0,0 +1,114 @@
+/**
+ *   GPStar Proton Pack - Ghostbusters Proton Pack & Neutrona Wand.
+ *   Copyright (C) 2023-2026 Michael Rajotte <michael.rajotte@gpstartechnologies.com>
+ *
+ *   This program is free software; you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation; either version 3 of the License, or
+ *   (at your option) any later version.
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License
+ *   along with this program; if not, see <https://www.gnu.org/licenses/>.
+ *
+ */
+
+#pragma once
+
+/*
+ * CPU frequency selection (ESP32 only).
+ *
+ * Without CPU_GOVERNOR the pack runs at a fixed 160 MHz. With it, the time the main loop spends
+ * working (everything except its task delay and any light sleep) is measured over each window,
+ * and the governor steps the clock between the shared levels and thresholds in CpuGovernor.h.
+ * The only user of the CPU clock is the loop profiler's cycle counter, which is told of each change.
+ *
+ * The LED output and i2c tasks spend most of their time waiting on their peripherals, which run
+ * at the same speed whatever the CPU clock, so they are not counted towards the load.
+ */
+const uint16_t i_cpu_default_mhz = 160; // Fixed frequency without the governor, and where it starts.
+
+#if defined(CPU_GOVERNOR)
+const uint32_t i_cpu_report_interval = 60000; // Time between residency reports (ms).
+
+CpuLoadMeter cpu_load(cpuGovernorMicros);
+CpuGovernor cpu_governor;
+millisDelay ms_cpu_governor;
+millisDelay ms_cpu_report;
+#endif
+
+// Changes the CPU clock, keeping anything which depends on it in step.
+void applyCpuFrequency(uint16_t i_mhz) {
+  setCpuFrequencyMhz(i_mhz);
+
+  #if defined(LOOP_PROFILER) && defined(CPU_GOVERNOR)
+  i_profile_cpu_mhz = i_mhz;
+  #endif
+}
+
+void setupCpuFrequency() {
+  applyCpuFrequency(i_cpu_default_mhz);
+
+  #if defined(CPU_GOVERNOR)
+  cpu_governor.useDefaults();
+  cpu_governor.begin(millis(), getCpuFrequencyMhz());
+  cpu_load.begin();
+  ms_cpu_governor.start(CPU_GOVERNOR_WINDOW_MS);
+  ms_cpu_report.start(i_cpu_report_interval);
+  #endif
+}
+
+#if defined(CPU_GOVERNOR)
+// Marks the start and end of work in the main loop.
+inline void cpuLoadEnter() {
+  cpu_load.enter(xPortGetCoreID());
+}
+
+inline void cpuLoadLeave() {
+  cpu_load.leave(xPortGetCoreID());
+}
+
+// Sends the time spent at each frequency since boot.
+void reportCpuResidency() {
+  uint32_t i_now = millis();
+  uint32_t i_total = 0;
+
+  for(uint8_t i = 0; i < cpu_governor.getLevelCount(); i++) {
+    i_total += cpu_governor.getResidency(i, i_now);
+  }
+
+  for(uint8_t i = 0; i < cpu_governor.getLevelCount(); i++) {
+    uint32_t i_residency = cpu_governor.getResidency(i, i_now);
+
+    sendDebug(String(F("CPU: ")) + String(cpu_governor.getLevelFrequency(i)) + F(" MHz for ") + String(i_residency / 1000) +
+              F("s (") + String(i_total > 0 ? 100.0 * i_residency / i_total : 0.0, 1) + F("%)"));
+  }
+
+  sendDebug(String(F("CPU: ")) + String(cpu_governor.getSwitchCount()) + F(" changes, now ") +
+            String(cpu_governor.getFrequency()) + F(" MHz at ") + String(cpu_governor.getLoad() / 10.0, 1) + F("% load"));
+}
+
+// Reviews the load at the end of each window and changes the clock if needed.
+void checkCpuGovernor() {
+  if(ms_cpu_report.justFinished()) {
+    ms_cpu_report.repeat();
+    reportCpuResidency();
+  }
+
+  if(!ms_cpu_governor.justFinished()) {
+    return;
+  }
+
+  ms_cpu_governor.repeat();
+
+  uint16_t i_mhz = cpu_governor.update(millis(), cpu_load.sample());
+
+  if(i_mhz != getCpuFrequencyMhz()) {
+    applyCpuFrequency(i_mhz);
+  }
+}
+#endif
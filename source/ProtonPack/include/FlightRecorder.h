@@ -0,0 +1,399 @@
+/**
+ *   GPStar Proton Pack - Ghostbusters Proton Pack & Neutrona Wand.
+ *   Copyright (C) 2023-2026 Michael Rajotte <michael.rajotte@gpstartechnologies.com>
+ *
+ *   This program is free software; you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation; either version 3 of the License, or
+ *   (at your option) any later version.
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License
+ *   along with this program; if not, see <https://www.gnu.org/licenses/>.
+ *
+ */
+
+#pragma once
+
+/*
+ * Optional event flight recorder, enabled by FLIGHT_RECORDER in Configuration.h.
+ *
+ * Keeps a ring of the most recent system events (resets, pack startup and shutdown, overheating,
+ * venting, the wand coming and going, and low supply voltage), each stamped with millis() and
+ * numbered in sequence. Every boot begins with a reset event giving the cause of the reset.
+ *
+ * On the ESP32 the ring is kept in RTC memory which is not cleared by a reset (though it is lost when
+ * the power is removed). On the ATMega it is kept in the EEPROM from i_flight_log_address, and so
+ * survives a loss of power. Events are first placed in a small queue in RAM and written out one byte
+ * per pass of the loop as the EEPROM becomes ready, so recording an event never waits on the EEPROM.
+ * Each record is invalidated before it is written and validated last, so a record torn by a reset is
+ * ignored, and no head pointer is stored: the newest record is found on boot from the break in the
+ * sequence numbers. Each cell is therefore only written once per trip around the ring.
+ *
+ * Send "e" over the serial (USB) console to print the log, or "z" to clear it. On the ESP32 the log
+ * can also be downloaded from the /debug/events route. Either can be decoded with:
+ *   python3 scripts/decode_flight_log.py <file>
+ */
+#if defined(FLIGHT_RECORDER)
+enum FLIGHT_EVENTS : uint8_t {
+  EVENT_RESET = 1,              // Data: reset reason, esp_reset_reason() on the ESP32 or MCUSR on the ATMega.
+  EVENT_PACK_STARTUP = 2,       // Data: 1 for the full startup sequence, else 0.
+  EVENT_PACK_SHUTDOWN = 3,
+  EVENT_OVERHEAT_START = 4,     // Data: power level.
+  EVENT_VENT_START = 5,         // Data: power level.
+  EVENT_WAND_CONNECTED = 6,
+  EVENT_WAND_DISCONNECTED = 7,
+  EVENT_LOW_VOLTAGE = 8,        // Data: supply voltage x100.
+  EVENT_VOLTAGE_RECOVERED = 9,  // Data: supply voltage x100.
+  EVENT_NONE = 0xFF             // An empty or torn record, as erased EEPROM reads 0xFF.
+};
+
+// One event, as stored and as sent to the decoder (little-endian).
+struct FlightEvent {
+  uint32_t i_time;    // millis() when the event was recorded.
+  uint16_t i_data;    // Depends on the event.
+  uint8_t i_sequence; // Increments with every event.
+  uint8_t i_type;     // FLIGHT_EVENTS, last so that it is written last.
+};
+
+// Sent ahead of the events when the log is read.
+struct FlightLogHeader {
+  uint16_t i_magic;
+  uint8_t i_version;
+  uint8_t i_platform;     // 1 for the ATMega, 2 for the ESP32.
+  uint16_t i_capacity;
+  uint16_t i_count;       // Number of events which follow, oldest first.
+  uint32_t i_uptime;      // millis() when the log was read.
+  uint8_t i_reset_reason; // Reason for the current boot, as for EVENT_RESET.
+  uint8_t i_record_size;
+  uint16_t i_reserved;
+};
+
+const uint16_t i_flight_log_magic = 0x4C46; // "FL"
+const uint8_t i_flight_log_version = 1;
+const uint16_t i_flight_low_voltage = 460; // Supply voltage (x100) below which a low voltage is recorded.
+const uint16_t i_flight_voltage_recovered = 480; // Supply voltage (x100) which ends a low voltage.
+
+uint8_t i_flight_reset_reason = 0;
+uint8_t i_flight_sequence = 0; // Sequence number for the next event.
+bool b_flight_low_voltage = false;
+
+#ifdef ESP32
+const uint8_t i_flight_log_platform = 2;
+const uint16_t i_flight_log_capacity = 128;
+
+struct FlightLog {
+  uint16_t i_magic;
+  uint16_t i_next;  // Record to be written next.
+  uint16_t i_count; // Number of valid records.
+  FlightEvent events[i_flight_log_capacity];
+};
+
+RTC_NOINIT_ATTR FlightLog flight_log;
+volatile bool b_flight_clear_requested = false; // Set by the web server, acted on by the main loop.
+#else
+const uint8_t i_flight_log_platform = 1;
+const uint16_t i_flight_log_address = 2048; // Clear of the preferences at the start and CRC at the end.
+const uint16_t i_flight_log_capacity = 240; // Must not be 256, so a wrapped sequence never lines up.
+const uint8_t i_flight_queue_size = 8;
+
+// The EEPROM region starts with a small header, followed by the records.
+struct FlightLogRegion {
+  uint16_t i_magic;
+  uint8_t i_version;
+  uint8_t i_capacity;
+};
+
+// Events waiting to be written, kept through a reset so that an event just before one is not lost.
+struct FlightQueue {
+  uint16_t i_magic;
+  uint8_t i_head;  // Next event to write.
+  uint8_t i_count;
+  FlightEvent events[i_flight_queue_size];
+};
+
+__attribute__((section(".noinit"))) FlightQueue flight_queue;
+__attribute__((section(".noinit"))) uint8_t i_flight_mcusr;
+
+uint16_t i_flight_slot = 0;      // EEPROM slot which the next event goes into.
+uint16_t i_flight_count = 0;     // Number of valid records in the EEPROM.
+uint8_t i_flight_write_step = 0; // Progress through writing the event at the head of the queue.
+uint16_t i_flight_erase_slot = i_flight_log_capacity; // Next slot to erase, or the capacity when not erasing.
+
+// Keep the reset cause before the core clears it. The bootloader may have already done so, leaving 0.
+void saveResetFlags() __attribute__((naked, used, section(".init3")));
+void saveResetFlags() {
+  i_flight_mcusr = MCUSR;
+  MCUSR = 0;
+}
+
+inline uint16_t getFlightSlotAddress(uint16_t i_slot) {
+  return i_flight_log_address + sizeof(FlightLogRegion) + i_slot * sizeof(FlightEvent);
+}
+#endif
+
+void recordEvent(uint8_t i_type, uint16_t i_data = 0) {
+  FlightEvent event;
+  event.i_time = millis();
+  event.i_data = i_data;
+  event.i_sequence = i_flight_sequence++;
+  event.i_type = i_type;
+
+#ifdef ESP32
+  flight_log.events[flight_log.i_next] = event;
+  flight_log.i_next = (flight_log.i_next + 1) % i_flight_log_capacity;
+
+  if(flight_log.i_count < i_flight_log_capacity) {
+    flight_log.i_count++;
+  }
+#else
+  if(flight_queue.i_count >= i_flight_queue_size) {
+    return; // The EEPROM cannot keep up, so drop the newest rather than tear one being written.
+  }
+
+  flight_queue.events[(flight_queue.i_head + flight_queue.i_count) % i_flight_queue_size] = event;
+  flight_queue.i_count++;
+#endif
+}
+
+void clearFlightLog() {
+#ifdef ESP32
+  flight_log.i_next = 0;
+  flight_log.i_count = 0;
+#else
+  // Erase every record in the background before anything else is written.
+  i_flight_erase_slot = 0;
+  i_flight_slot = 0;
+  i_flight_count = 0;
+  i_flight_write_step = 0;
+#endif
+}
+
+#ifndef ESP32
+// Finds the newest record from the break in the sequence numbers, and continues from there.
+void scanFlightLog() {
+  FlightEvent event;
+  FlightEvent next;
+  bool b_found = false;
+
+  i_flight_slot = 0;
+  i_flight_count = 0;
+
+  for(uint16_t i = 0; i < i_flight_log_capacity; i++) {
+    EEPROM.get(getFlightSlotAddress(i), event);
+
+    if(event.i_type == EVENT_NONE) {
+      continue;
+    }
+
+    i_flight_count++;
+
+    if(b_found) {
+      continue;
+    }
+
+    // The newest record is the only one not followed by the next in sequence.
+    uint16_t i_next = (i + 1) % i_flight_log_capacity;
+    EEPROM.get(getFlightSlotAddress(i_next), next);
+
+    if(next.i_type == EVENT_NONE || next.i_sequence != (uint8_t)(event.i_sequence + 1)) {
+      i_flight_slot = i_next;
+      i_flight_sequence = event.i_sequence + 1;
+      b_found = true;
+    }
+  }
+}
+
+// Writes at most one byte of the log to the EEPROM, and only if it would not have to wait.
+void drainFlightQueue() {
+  if(!eeprom_is_ready()) {
+    return;
+  }
+
+  if(i_flight_erase_slot < i_flight_log_capacity) {
+    EEPROM.update(getFlightSlotAddress(i_flight_erase_slot) + offsetof(FlightEvent, i_type), EVENT_NONE);
+
+    if(++i_flight_erase_slot == i_flight_log_capacity) {
+      // Only now mark the region as valid, so an erase cut short by a reset starts over.
+      FlightLogRegion region = {i_flight_log_magic, i_flight_log_version, (uint8_t)i_flight_log_capacity};
+      EEPROM.put(i_flight_log_address, region);
+    }
+
+    return;
+  }
+
+  if(flight_queue.i_count == 0) {
+    return;
+  }
+
+  const FlightEvent& event = flight_queue.events[flight_queue.i_head];
+  uint16_t i_address = getFlightSlotAddress(i_flight_slot);
+  const uint8_t i_type_offset = offsetof(FlightEvent, i_type);
+
+  if(i_flight_write_step == 0) {
+    // Invalidate the slot first, so that it cannot be read half-written.
+    EEPROM.update(i_address + i_type_offset, EVENT_NONE);
+  }
+  else if(i_flight_write_step <= i_type_offset) {
+    EEPROM.update(i_address + i_flight_write_step - 1, ((const uint8_t*)&event)[i_flight_write_step - 1]);
+  }
+  else {
+    // Finally the type, which makes the record valid.
+    EEPROM.update(i_address + i_type_offset, event.i_type);
+
+    i_flight_slot = (i_flight_slot + 1) % i_flight_log_capacity;
+    if(i_flight_count < i_flight_log_capacity) {
+      i_flight_count++;
+    }
+
+    flight_queue.i_head = (flight_queue.i_head + 1) % i_flight_queue_size;
+    flight_queue.i_count--;
+    i_flight_write_step = 0;
+    return;
+  }
+
+  i_flight_write_step++;
+}
+#endif
+
+void setupFlightRecorder() {
+#ifdef ESP32
+  i_flight_reset_reason = (uint8_t)esp_reset_reason();
+
+  // Anything else is left over from before the power was applied.
+  if(flight_log.i_magic != i_flight_log_magic || flight_log.i_next >= i_flight_log_capacity || flight_log.i_count > i_flight_log_capacity) {
+    memset(&flight_log, 0, sizeof(flight_log));
+    flight_log.i_magic = i_flight_log_magic;
+  }
+  else if(flight_log.i_count > 0) {
+    // Continue the sequence from the newest event.
+    i_flight_sequence = flight_log.events[(flight_log.i_next + i_flight_log_capacity - 1) % i_flight_log_capacity].i_sequence + 1;
+  }
+#else
+  i_flight_reset_reason = i_flight_mcusr;
+
+  if(flight_queue.i_magic != i_flight_log_magic || flight_queue.i_head >= i_flight_queue_size || flight_queue.i_count > i_flight_queue_size) {
+    memset(&flight_queue, 0, sizeof(flight_queue));
+    flight_queue.i_magic = i_flight_log_magic;
+  }
+
+  FlightLogRegion region;
+  EEPROM.get(i_flight_log_address, region);
+
+  if(region.i_magic != i_flight_log_magic || region.i_version != i_flight_log_version || region.i_capacity != (uint8_t)i_flight_log_capacity) {
+    // The region has never held a log, or held a different layout.
+    clearFlightLog();
+  }
+  else {
+    scanFlightLog();
+  }
+
+  // Any events kept in the queue through the reset are numbered after those already written.
+  for(uint8_t i = 0; i < flight_queue.i_count; i++) {
+    flight_queue.events[(flight_queue.i_head + i) % i_flight_queue_size].i_sequence = i_flight_sequence++;
+  }
+#endif
+
+  recordEvent(EVENT_RESET, i_flight_reset_reason);
+}
+
+// Called on every pass of the loop.
+void checkFlightRecorder() {
+#ifdef ESP32
+  if(b_flight_clear_requested) {
+    clearFlightLog();
+    b_flight_clear_requested = false;
+  }
+#else
+  drainFlightQueue();
+#endif
+}
+
+// Records a drop in the supply voltage (x100), and its recovery.
+void checkSupplyVoltage(uint16_t i_voltage) {
+  if(!b_flight_low_voltage && i_voltage > 0 && i_voltage < i_flight_low_voltage) {
+    b_flight_low_voltage = true;
+    recordEvent(EVENT_LOW_VOLTAGE, i_voltage);
+  }
+  else if(b_flight_low_voltage && i_voltage >= i_flight_voltage_recovered) {
+    b_flight_low_voltage = false;
+    recordEvent(EVENT_VOLTAGE_RECOVERED, i_voltage);
+  }
+}
+
+uint16_t getFlightEventCount() {
+#ifdef ESP32
+  return flight_log.i_count;
+#else
+  return i_flight_count;
+#endif
+}
+
+void getFlightLogHeader(FlightLogHeader& header) {
+  header.i_magic = i_flight_log_magic;
+  header.i_version = i_flight_log_version;
+  header.i_platform = i_flight_log_platform;
+  header.i_capacity = i_flight_log_capacity;
+  header.i_count = getFlightEventCount();
+  header.i_uptime = millis();
+  header.i_reset_reason = i_flight_reset_reason;
+  header.i_record_size = sizeof(FlightEvent);
+  header.i_reserved = 0;
+}
+
+// Returns an event by age, where 0 is the oldest. Events still queued for the EEPROM are not included.
+void getFlightEvent(uint16_t i, FlightEvent& event) {
+#ifdef ESP32
+  event = flight_log.events[(flight_log.i_next + i_flight_log_capacity - flight_log.i_count + i) % i_flight_log_capacity];
+#else
+  // The oldest record follows the newest, skipping any empty slots (or one which was torn).
+  uint16_t i_slot = i_flight_slot;
+
+  for(uint16_t j = 0; j < i_flight_log_capacity; j++) {
+    EEPROM.get(getFlightSlotAddress(i_slot), event);
+
+    if(event.i_type != EVENT_NONE && i-- == 0) {
+      return;
+    }
+
+    i_slot = (i_slot + 1) % i_flight_log_capacity;
+  }
+#endif
+}
+
+// Prints one line of the log as hex.
+void printFlightLogLine(const uint8_t* p_data, uint8_t i_length) {
+  char buffer[4];
+
+  Serial.print(F("FL"));
+  for(uint8_t i = 0; i < i_length; i++) {
+    snprintf(buffer, sizeof(buffer), " %02x", p_data[i]);
+    Serial.print(buffer);
+  }
+  Serial.println();
+}
+
+// Prints the header and events to the serial (USB) console as hex, one per line, for the decoder.
+void printFlightLog() {
+  FlightLogHeader header;
+  getFlightLogHeader(header);
+
+  Serial.println();
+  Serial.println(F("Flight log:"));
+  printFlightLogLine((const uint8_t*)&header, sizeof(header));
+
+  for(uint16_t i = 0; i < header.i_count; i++) {
+    FlightEvent event;
+    getFlightEvent(i, event);
+    printFlightLogLine((const uint8_t*)&event, sizeof(event));
+  }
+}
+
+  #define FLIGHT_EVENT(...) recordEvent(__VA_ARGS__)
+#else
+  #define FLIGHT_EVENT(...)
+#endif
@@ -187,6 +187,18 @@ uint8_t i_vent_light_start = i_powercell_num_leds + i_cyclotron_num_leds;
  */
 CRGB pack_leds[MAX_POWERCELL_LED_COUNT + OUTER_CYCLOTRON_LED_MAX + JEWEL_NFILTER_LED_COUNT];
 
+/*
+ * Pack LED compositor.
+ * The Power Cell, Cyclotron Lid and N-Filter effects render into their own layers instead of
+ * writing pack_leds directly. Each layer owns a range of pack_leds and only the pixels it changed
+ * are recomposed before the LEDs are shown. Layers are sized for the largest supported LED counts
+ * and are placed by updateProtonPackLEDCounts(); a cleared layer pixel shows as black.
+ */
+LEDCompositor pack_compositor(pack_leds[0].raw, MAX_POWERCELL_LED_COUNT + OUTER_CYCLOTRON_LED_MAX + JEWEL_NFILTER_LED_COUNT);
+LEDLayerBuffer<MAX_POWERCELL_LED_COUNT> powercell_layer; // Power Cell, which starts at the first pack LED.
+LEDLayerBuffer<OUTER_CYCLOTRON_LED_MAX> cyclotron_layer; // Cyclotron Lid, which follows the Power Cell.
+LEDLayerBuffer<JEWEL_NFILTER_LED_COUNT> vent_light_layer; // N-Filter jewel, which follows the Cyclotron lid.
+
 /*
  * Inner Cyclotron LEDs (optional).
  * Max number of LEDs supported = 64.
@@ -215,7 +227,15 @@ millisDelay ms_fast_led;
  */
 uint8_t i_powercell_delay = i_powercell_delay_2021;
 int8_t i_powercell_led = 0;
-millisDelay ms_powercell;
+millisDelay ms_powercell; // Power Cell ramp down steps while overheating.
+Keyframe powercell_frames[MAX_POWERCELL_LED_COUNT + 2]; // Power Cell sweep: one keyframe per LED, the dark step and the loop marker.
+TimelineTrack powercell_track;
+Timeline pack_timeline; // Steps the pack animations against a single clock.
+const uint16_t i_powercell_step_max = 4000; // Longest Power Cell step or hold (ms), which keeps the sweep within 16 bit keyframe times.
+uint16_t i_powercell_step_time = 0; // Step time (ms) the Power Cell sweep was built with.
+uint16_t i_powercell_hold_time = 0; // Time (ms) the sweep holds with every Power Cell LED lit.
+uint8_t i_powercell_sweep_leds = 0; // Power Cell LED count the sweep was built for.
+bool b_powercell_step_now = false; // Take the next Power Cell step on the next loop instead of waiting for the sweep.
 bool b_powercell_updating = false;
 uint8_t i_powercell_multiplier = 1;
 bool b_powercell_sound_loop = false;
@@ -272,12 +292,34 @@ uint8_t i_cyclotron_fake_ring_counter = 0; // Counter used by the ring simulatio
 bool b_cyclotron_lid_on = true; // Tracks actual state of cyclotron lid (on = covered/attached).
 bool b_brass_pack_sound_loop = false;
 
+/*
+ * Cyclotron Lid geometry, generated from the CYCLOTRON_LID_GEOMETRY rows in Configuration.h.
+ * i_cyclotron_geometry selects the row in use, and is updated whenever the LED counts change.
+ */
+struct CyclotronGeometry {
+  uint8_t num_leds;      // LEDs in the Cyclotron Lid.
+  uint8_t delay_2021;    // Delay between ring positions in Afterlife and Frozen Empire.
+  uint8_t lamps_1984[4]; // Middle LED of each lens window, in clockwise order.
+};
+
 // For the Afterlife and Frozen Empire Cyclotron matrix pattern, map a location on a circle of 40 positions to a target LED (where 0 is the top-right lens).
-const uint8_t i_cyclotron_4led_matrix[OUTER_CYCLOTRON_LED_MAX] PROGMEM  = { 1, 0, 0, 0, 0, 0, 0, 0, 0, 0, 2, 0, 0, 0, 0, 0, 0, 0, 0, 0, 3, 0, 0, 0, 0, 0, 0, 0, 0, 0, 4, 0, 0, 0, 0, 0, 0, 0, 0, 0 };
-const uint8_t i_cyclotron_12led_matrix[OUTER_CYCLOTRON_LED_MAX] PROGMEM = { 1, 2, 3, 0, 0, 0, 0, 0, 0, 0, 4, 5, 6, 0, 0, 0, 0, 0, 0, 0, 7, 8, 9, 0, 0, 0, 0, 0, 0, 0, 10, 11, 12, 0, 0, 0, 0, 0, 0, 0 };
-const uint8_t i_cyclotron_20led_matrix[OUTER_CYCLOTRON_LED_MAX] PROGMEM = { 1, 2, 3, 4, 5, 0, 0, 0, 0, 0, 6, 7, 8, 9, 10, 0, 0, 0, 0, 0, 11, 12, 13, 14, 15, 0, 0, 0, 0, 0, 16, 17, 18, 19, 20, 0, 0, 0, 0, 0 };
-const uint8_t i_cyclotron_36led_matrix[OUTER_CYCLOTRON_LED_MAX] PROGMEM = { 1, 2, 3, 4, 5, 6, 7, 8, 9, 0, 10, 11, 12, 13, 14, 15, 16, 17, 18, 0, 19, 20, 21, 22, 23, 24, 25, 26, 27, 0, 28, 29, 30, 31, 32, 33, 34, 35, 36, 0 };
-const uint8_t i_cyclotron_40led_matrix[OUTER_CYCLOTRON_LED_MAX] PROGMEM = { 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15, 16, 17, 18, 19, 20, 21, 22, 23, 24, 25, 26, 27, 28, 29, 30, 31, 32, 33, 34, 35, 36, 37, 38, 39, 40 };
+// Each lens window covers 10 positions and the LEDs of each lens fill its first positions, while the remaining positions hold 0 (no LED).
+#define CYCLOTRON_RING_LED(count, pos) ((((pos) % 10) < (count) / 4) ? ((pos) / 10) * ((count) / 4) + ((pos) % 10) + 1 : 0)
+#define CYCLOTRON_RING_LENS(count, lens) \
+  CYCLOTRON_RING_LED(count, (lens) * 10 + 0), CYCLOTRON_RING_LED(count, (lens) * 10 + 1), CYCLOTRON_RING_LED(count, (lens) * 10 + 2), \
+  CYCLOTRON_RING_LED(count, (lens) * 10 + 3), CYCLOTRON_RING_LED(count, (lens) * 10 + 4), CYCLOTRON_RING_LED(count, (lens) * 10 + 5), \
+  CYCLOTRON_RING_LED(count, (lens) * 10 + 6), CYCLOTRON_RING_LED(count, (lens) * 10 + 7), CYCLOTRON_RING_LED(count, (lens) * 10 + 8), \
+  CYCLOTRON_RING_LED(count, (lens) * 10 + 9)
+
+#define CYCLOTRON_GEOMETRY_ROW(count, delay, lamp1, lamp2, lamp3, lamp4) { count, delay, { lamp1, lamp2, lamp3, lamp4 } },
+#define CYCLOTRON_GEOMETRY_MATRIX(count, ...) { CYCLOTRON_RING_LENS(count, 0), CYCLOTRON_RING_LENS(count, 1), CYCLOTRON_RING_LENS(count, 2), CYCLOTRON_RING_LENS(count, 3) },
+#define CYCLOTRON_GEOMETRY_CHECK(count, ...) static_assert((count) % 4 == 0 && (count) <= OUTER_CYCLOTRON_LED_MAX, "Cyclotron Lid LED count must be a multiple of 4, up to 40");
+
+CYCLOTRON_LID_GEOMETRY(CYCLOTRON_GEOMETRY_CHECK)
+const CyclotronGeometry cyclotron_geometry[] PROGMEM = { CYCLOTRON_LID_GEOMETRY(CYCLOTRON_GEOMETRY_ROW) };
+const uint8_t i_cyclotron_ring_matrix[][OUTER_CYCLOTRON_LED_MAX] PROGMEM = { CYCLOTRON_LID_GEOMETRY(CYCLOTRON_GEOMETRY_MATRIX) };
+const uint8_t i_cyclotron_geometry_count = sizeof(cyclotron_geometry) / sizeof(cyclotron_geometry[0]);
+uint8_t i_cyclotron_geometry = 0; // Index of the geometry row for i_cyclotron_num_leds.
 
 /*
  * Inner Cyclotron LED Panel
@@ -331,15 +373,29 @@ millisDelay ms_alarm;
 
 /*
  * Switches
- */
-ezButton switch_power(ION_ARM_SWITCH_PIN); // Red power switch under the Ion Arm.
-ezButton switch_alarm(RIBBON_CABLE_SWITCH_PIN); // Ribbon cable removal switch
-ezButton switch_mode(YEAR_TOGGLE_PIN); // 1984 / 2021 mode toggle switch
-ezButton switch_vibration(VIBRATION_TOGGLE_PIN); // Vibration toggle switch
+ * All switches are read and debounced together by a single SwitchBank, where each switch is one bit.
+ */
+enum PACK_SWITCHES : uint8_t {
+  PACK_SWITCH_POWER,
+  PACK_SWITCH_ALARM,
+  PACK_SWITCH_MODE,
+  PACK_SWITCH_VIBRATION,
+  PACK_SWITCH_CYCLOTRON_LID,
+#ifndef ESP32
+  PACK_SWITCH_CYCLOTRON_DIRECTION,
+  PACK_SWITCH_SMOKE,
+#endif
+};
+
+SwitchBank pack_switches;
+SwitchBankButton switch_power(pack_switches, PACK_SWITCH_POWER); // Red power switch under the Ion Arm.
+SwitchBankButton switch_alarm(pack_switches, PACK_SWITCH_ALARM); // Ribbon cable removal switch
+SwitchBankButton switch_mode(pack_switches, PACK_SWITCH_MODE); // 1984 / 2021 mode toggle switch
+SwitchBankButton switch_vibration(pack_switches, PACK_SWITCH_VIBRATION); // Vibration toggle switch
 uint8_t vibrationSwitchedCount = 0;
 #ifndef ESP32
-ezButton switch_cyclotron_direction(CYCLOTRON_DIRECTION_TOGGLE_PIN); // Newly added switch for controlling the direction of the Cyclotron lights. Not required. Defaults to clockwise.
-ezButton switch_smoke(SMOKE_TOGGLE_PIN); // Switch to enable smoke effects. Not required. Defaults to off/disabled.
+SwitchBankButton switch_cyclotron_direction(pack_switches, PACK_SWITCH_CYCLOTRON_DIRECTION); // Newly added switch for controlling the direction of the Cyclotron lights. Not required. Defaults to clockwise.
+SwitchBankButton switch_smoke(pack_switches, PACK_SWITCH_SMOKE); // Switch to enable smoke effects. Not required. Defaults to off/disabled.
 #endif
 
 /*
@@ -411,6 +467,7 @@ bool b_sound_firing_intensify_trigger = false;
 bool b_sound_firing_alt_trigger = false;
 bool b_wand_connected = false;
 bool b_wand_syncing = false;
+bool b_wand_idle_sleep = false; // The wand will wake the pack before sending, so the pack may sleep while it is connected.
 bool b_wand_on = false;
 bool b_wand_mash_lockout = false;
 millisDelay ms_wand_check; // Timer used to determine whether the wand has been disconnected.
@@ -448,8 +505,11 @@ const uint16_t i_meson_blast_delay_level_1 = 275;
  */
 millisDelay ms_rotary_encoder; // Timer for slowing the rotary encoder spin.
 const uint8_t i_rotary_encoder_delay = 50; // Time to delay adjusting volume.
-static uint8_t prev_next_code = 0;
-static uint16_t store = 0;
+QuadratureDecoder volume_encoder; // Accumulates encoder steps between reads by the main loop.
+#ifdef ESP32
+pcnt_unit_handle_t volume_encoder_unit = NULL; // Hardware pulse counter, or NULL if the pins are sampled instead.
+int i_volume_encoder_count = 0; // Pulse counter value at the last read.
+#endif
 
 /*
  * Proton Pack Bootup POST Animations
@@ -522,6 +582,21 @@ bool b_temp_sensor_detected = false;
 float f_temperature_c = 0;
 float f_temperature_f = 0;
 
+/*
+ * I2C Scheduler
+ * Once setup() completes, all i2c traffic is queued through here so the main loop never waits on the bus.
+ * The ESP32 runs transactions from a background task, while the ATMega runs them from the main loop.
+ */
+uint32_t i2cMicros(); // Scheduler clock, defined in System.h.
+WireBus i2c_bus(Wire);
+#ifdef ESP32
+WireBus i2c_temp_bus(Wire1); // The HDC1080 has a bus of its own.
+#endif
+I2CSchedulerBuffer<6> i2c_scheduler(i2cMicros);
+uint8_t i_i2c_power_meter = 0; // Scheduler device IDs, left as 0 if the device was not found.
+uint8_t i_i2c_temp_sensor = 0;
+const uint16_t i_i2c_service_budget = 1000; // ATMega only: microseconds of bus time allowed per loop.
+
 // Flags for denoting when requested data was received.
 bool b_received_prefs_wand = false;
 
@@ -537,6 +612,7 @@ void attenuatorSendData(uint8_t i_message);
 void checkAttenuator();
 void checkWand();
 void powercellDraw(uint8_t i_start = 0);
+void powercellRestart();
 
 /**
  * WiFi Activation Preference (GPStar II Only).
@@ -554,7 +630,8 @@ void powercellDraw(uint8_t i_start = 0);
  * If you are compiling this for an Arduino Mega and the error message brings you here, go to the bottom of the Configuration.h file for more information.
  */
 #ifdef GPSTAR_PROTON_PACK_PCB
-  ezButton switch_cyclotron_lid(CYCLOTRON_LID_SWITCH_PIN); // Second Cyclotron ground pin (brown) that we detect if the lid is removed or not.
+  #define CYCLOTRON_LID_PIN CYCLOTRON_LID_SWITCH_PIN // Second Cyclotron ground pin (brown) that we detect if the lid is removed or not.
 #else
-  ezButton switch_cyclotron_lid(CYCLOTRON_LID_SWITCH_PIN_DIY); // Alternate pin for legacy DIY builds.
+  #define CYCLOTRON_LID_PIN CYCLOTRON_LID_SWITCH_PIN_DIY // Alternate pin for legacy DIY builds.
 #endif
+SwitchBankButton switch_cyclotron_lid(pack_switches, PACK_SWITCH_CYCLOTRON_LID);
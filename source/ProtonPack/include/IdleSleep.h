@@ -0,0 +1,274 @@
+/**
+ *   GPStar Proton Pack - Ghostbusters Proton Pack & Neutrona Wand.
+ *   Copyright (C) 2023-2026 Michael Rajotte <michael.rajotte@gpstartechnologies.com>
+ *
+ *   This program is free software; you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation; either version 3 of the License, or
+ *   (at your option) any later version.
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License
+ *   along with this program; if not, see <https://www.gnu.org/licenses/>.
+ *
+ */
+
+#pragma once
+
+/*
+ * Optional idle light sleep (ESP32 only), enabled by IDLE_LIGHT_SLEEP in Configuration.h.
+ *
+ * Once the pack has been quiet for i_idle_settle_delay, each pass of the loop puts the CPU into light
+ * sleep until the next timer which matters while idle (power meter and temperature readings), for no
+ * longer than i_idle_sleep_max. Any switch, the volume encoder, or a start bit on either serial link
+ * wakes it immediately, after which the pack stays awake until it has been quiet for the settle time
+ * again.
+ *
+ * Bytes cannot be received while asleep, so the byte which wakes the pack is lost. A connected wand
+ * is sent P_IDLE_SLEEP first, and once it acknowledges with W_IDLE_SLEEP it sends a throwaway wake
+ * byte ahead of each packet; the pack stays awake for i_idle_listen_time after any serial wake or
+ * received byte so the packet which follows is read in full, and the wand leaves out the wake byte
+ * when its previous packet went out within that time. Serial traffic alone (such as the
+ * regular handshake) does not restart the settle time. When the pack becomes busy again the wand is
+ * told to stop sending wake bytes. The Attenuator has no such handshake, so the pack does not sleep
+ * while one is connected, and WiFi must be off as light sleep would stop the access point.
+ */
+#if defined(IDLE_LIGHT_SLEEP)
+const uint16_t i_idle_settle_delay = 5000; // Quiet time (ms) before the pack may sleep.
+const uint16_t i_idle_sleep_max = 100; // Longest single sleep (ms), which bounds the delay to any other timer.
+const uint8_t i_idle_sleep_min = 3; // Shortest sleep (ms) worth the cost of waking up.
+const uint8_t i_idle_listen_time = 20; // Time (ms) to stay awake after serial data, long enough for a full packet at 9600 baud.
+
+// Pins which wake the pack when their level changes. The serial RX pins must remain last.
+const uint8_t i_idle_wake_pins[] = {
+  ION_ARM_SWITCH_PIN,
+  RIBBON_CABLE_SWITCH_PIN,
+  YEAR_TOGGLE_PIN,
+  VIBRATION_TOGGLE_PIN,
+  CYCLOTRON_LID_PIN,
+  ROTARY_ENCODER_A,
+  ROTARY_ENCODER_B,
+  WAND_RX_PIN,
+  ATTENUATOR_RX_PIN
+};
+const uint8_t i_idle_wake_serial_pins = 2; // Number of serial RX pins at the end of the list above.
+
+/*
+ * Time spent awake and asleep, since boot and for the current idle period.
+ * All times are in microseconds.
+ */
+struct IdleSleepStats {
+  uint32_t i_sleeps = 0;       // Number of light sleeps.
+  uint32_t i_wakes_timer = 0;  // Sleeps ended by the timer.
+  uint32_t i_wakes_gpio = 0;   // Sleeps ended by a switch, the encoder or a serial link.
+  uint64_t i_asleep_time = 0;  // Total time spent in light sleep.
+  uint64_t i_idle_time = 0;    // Total time spent in idle periods, asleep or awake.
+};
+
+IdleSleepStats idleSleepTotals;
+IdleSleepStats idleSleepPeriod;
+uint32_t i_idle_last_activity = 0; // millis() when the pack was last seen to be busy.
+uint32_t i_idle_period_start = 0; // micros() when the current idle period began, or 0 when busy.
+uint32_t i_idle_listen_start = 0; // millis() when serial data was last seen, which keeps the pack awake briefly.
+bool b_idle_wand_notified = false; // Whether the wand has been sent P_IDLE_SLEEP and not yet cancelled.
+
+// Whether nothing is happening which needs the loop to run continuously. Serial data is handled separately.
+bool isPackQuiescent() {
+  return PACK_STATE == MODE_OFF && PACK_ACTION_STATE == ACTION_IDLE && b_pack_post_finish && !b_pack_shutting_down &&
+         !b_wand_firing && !b_overheating && !b_playing_music &&
+         !b_wand_syncing && !b_attenuator_connected && !b_attenuator_syncing &&
+#if defined(LED_OUTPUT_TASK)
+         !b_led_frame_pending &&
+#endif
+         WiFi.getMode() == WIFI_OFF && i2c_scheduler.getQueuedCount() == 0;
+}
+
+// Whether serial data has arrived recently enough that more of the same packet may follow.
+bool isSerialListening() {
+  if(WandSerial.available() > 0 || AttenuatorSerial.available() > 0) {
+    i_idle_listen_start = millis();
+    return true;
+  }
+
+  return millis() - i_idle_listen_start < i_idle_listen_time;
+}
+
+// Tells the wand to stop sending wake bytes, if it had been told the pack may sleep.
+void cancelWandIdleSleep() {
+  if(b_idle_wand_notified) {
+    b_idle_wand_notified = false;
+
+    if(b_wand_connected) {
+      packSerialSend(P_IDLE_SLEEP, 1);
+    }
+  }
+
+  b_wand_idle_sleep = false;
+}
+
+// Reports the idle period which just ended, and adds it to the totals.
+void endIdlePeriod() {
+  if(i_idle_period_start == 0) {
+    return;
+  }
+
+  idleSleepPeriod.i_idle_time = micros() - i_idle_period_start;
+  i_idle_period_start = 0;
+
+  idleSleepTotals.i_sleeps += idleSleepPeriod.i_sleeps;
+  idleSleepTotals.i_wakes_timer += idleSleepPeriod.i_wakes_timer;
+  idleSleepTotals.i_wakes_gpio += idleSleepPeriod.i_wakes_gpio;
+  idleSleepTotals.i_asleep_time += idleSleepPeriod.i_asleep_time;
+  idleSleepTotals.i_idle_time += idleSleepPeriod.i_idle_time;
+
+  char buffer[120];
+  snprintf(buffer, sizeof(buffer), "Idle: %lu ms, %.1f%% asleep over %lu sleeps (%lu timer, %lu wake-up)",
+           (unsigned long)(idleSleepPeriod.i_idle_time / 1000),
+           idleSleepPeriod.i_idle_time > 0 ? (100.0 * idleSleepPeriod.i_asleep_time / idleSleepPeriod.i_idle_time) : 0.0,
+           (unsigned long)idleSleepPeriod.i_sleeps, (unsigned long)idleSleepPeriod.i_wakes_timer,
+           (unsigned long)idleSleepPeriod.i_wakes_gpio);
+  sendDebug(buffer);
+
+  idleSleepPeriod = IdleSleepStats();
+}
+
+// Reduces the sleep time to the given timer's deadline, if it is running.
+void limitIdleSleep(uint32_t& i_sleep_time, millisDelay& timer) {
+  if(timer.isRunning() && timer.remaining() < i_sleep_time) {
+    i_sleep_time = timer.remaining();
+  }
+}
+
+// Returns how long (ms) the pack may sleep before a timer which matters while idle is due.
+uint32_t getIdleSleepTime() {
+  uint32_t i_sleep_time = i_idle_sleep_max;
+
+  if(b_power_meter_available) {
+    limitIdleSleep(i_sleep_time, wandReading.ReadTimer);
+    limitIdleSleep(i_sleep_time, packReading.ReadTimer);
+  }
+
+  if(b_temp_sensor_detected) {
+    limitIdleSleep(i_sleep_time, ms_temp_read);
+  }
+
+  if(b_wand_connected && ms_wand_check.isRunning()) {
+    // Wake in time to send the keep-alive handshake, which goes out in the last fifth of the wand check.
+    uint32_t i_handshake_due = ms_wand_check.remaining() > (ms_wand_check.delay() / 5) ? ms_wand_check.remaining() - (ms_wand_check.delay() / 5) : 0;
+
+    if(i_handshake_due < i_sleep_time) {
+      i_sleep_time = i_handshake_due;
+    }
+  }
+
+  return i_sleep_time;
+}
+
+// Sleeps if the pack has been quiet for long enough. Called once per pass of the loop.
+void checkIdleSleep() {
+  if(!isPackQuiescent()) {
+    i_idle_last_activity = millis();
+    cancelWandIdleSleep();
+    endIdlePeriod();
+    return;
+  }
+
+  if(!b_wand_connected) {
+    // A disconnected wand has forgotten the notice, and a new one will be told once it is quiet again.
+    b_idle_wand_notified = false;
+    b_wand_idle_sleep = false;
+  }
+
+  if(isSerialListening()) {
+    return;
+  }
+
+  if(millis() - i_idle_last_activity < i_idle_settle_delay) {
+    return;
+  }
+
+  if(b_wand_connected && !b_wand_idle_sleep) {
+    // Ask the wand to wake us before it sends anything, and stay awake until it agrees.
+    if(!b_idle_wand_notified) {
+      b_idle_wand_notified = true;
+      packSerialSend(P_IDLE_SLEEP, 2);
+      i_idle_listen_start = millis();
+    }
+
+    return;
+  }
+
+  uint32_t i_sleep_time = getIdleSleepTime();
+
+  if(i_sleep_time < i_idle_sleep_min) {
+    return;
+  }
+
+  if(i_idle_period_start == 0) {
+    i_idle_period_start = micros();
+  }
+
+  // Wake on any change to a switch or the encoder, or a start bit (low) on either serial link.
+  uint8_t i_pin_levels[sizeof(i_idle_wake_pins)];
+
+  for(uint8_t i = 0; i < sizeof(i_idle_wake_pins); i++) {
+    i_pin_levels[i] = digitalRead(i_idle_wake_pins[i]);
+    gpio_wakeup_enable((gpio_num_t)i_idle_wake_pins[i], i_pin_levels[i] == HIGH ? GPIO_INTR_LOW_LEVEL : GPIO_INTR_HIGH_LEVEL);
+  }
+
+  esp_sleep_enable_gpio_wakeup();
+  esp_sleep_enable_timer_wakeup(i_sleep_time * 1000ULL);
+
+  // Let anything still being sent go out before the UART clocks stop.
+  WandSerial.flush();
+  AttenuatorSerial.flush();
+
+  #if defined(STALL_WATCHDOG)
+  // Time asleep is not a stall, so end the pass here and begin another on waking.
+  stallIterationEnd();
+  #endif
+
+  uint32_t i_sleep_start = micros();
+  esp_light_sleep_start();
+  uint32_t i_asleep = micros() - i_sleep_start;
+
+  #if defined(STALL_WATCHDOG)
+  stallIterationBegin();
+  #endif
+  idleSleepPeriod.i_asleep_time += i_asleep;
+
+  #if defined(CPU_GOVERNOR)
+  // Time asleep is not work, even though it is spent inside the loop.
+  cpu_load.excuse(xPortGetCoreID(), i_asleep);
+  #endif
+  idleSleepPeriod.i_sleeps++;
+
+  for(uint8_t i = 0; i < sizeof(i_idle_wake_pins); i++) {
+    gpio_wakeup_disable((gpio_num_t)i_idle_wake_pins[i]);
+  }
+
+  esp_sleep_disable_wakeup_source(ESP_SLEEP_WAKEUP_ALL);
+
+  if(esp_sleep_get_wakeup_cause() == ESP_SLEEP_WAKEUP_GPIO) {
+    idleSleepPeriod.i_wakes_gpio++;
+
+    // Listen for the packet which may follow a serial wake byte.
+    i_idle_listen_start = millis();
+
+    for(uint8_t i = 0; i < sizeof(i_idle_wake_pins) - i_idle_wake_serial_pins; i++) {
+      if(digitalRead(i_idle_wake_pins[i]) != i_pin_levels[i]) {
+        // A switch or the encoder moved, so stay awake until the pack has been quiet again.
+        i_idle_last_activity = millis();
+        break;
+      }
+    }
+  }
+  else {
+    idleSleepPeriod.i_wakes_timer++;
+  }
+}
+#endif
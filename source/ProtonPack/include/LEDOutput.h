@@ -0,0 +1,171 @@
+/**
+ *   GPStar Proton Pack - Ghostbusters Proton Pack & Neutrona Wand.
+ *   Copyright (C) 2023-2026 Michael Rajotte <michael.rajotte@gpstartechnologies.com>
+ *
+ *   This program is free software; you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation; either version 3 of the License, or
+ *   (at your option) any later version.
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License
+ *   along with this program; if not, see <https://www.gnu.org/licenses/>.
+ *
+ */
+
+#pragma once
+
+/*
+ * Optional LED output task, enabled by LED_OUTPUT_TASK in Configuration.h.
+ *
+ * The main loop keeps rendering into pack_leds and cyclotron_leds, which act as the back buffers.
+ * When a frame is due the back buffers are copied into the front buffers below (the arrays which
+ * are registered with FastLED) and the output task is notified, so the transfer to the LED chains
+ * happens outside of the main loop. Buffers are copied rather than swapped as many effects read
+ * back their previous frame (eg. fadeToBlackBy on the cyclotron).
+ *
+ * If the output task is still sending the previous frame when the next one is due, that frame is
+ * skipped. Nothing is lost as the back buffers persist, so the next frame will carry all changes.
+ */
+#if defined(LED_OUTPUT_TASK)
+CRGB pack_leds_out[MAX_POWERCELL_LED_COUNT + OUTER_CYCLOTRON_LED_MAX + JEWEL_NFILTER_LED_COUNT];
+CRGB cyclotron_leds_out[INNER_CYCLOTRON_LED_PANEL_MAX + INNER_CYCLOTRON_CAKE_LED_MAX + INNER_CYCLOTRON_CAVITY_LED_MAX];
+
+TaskHandle_t LEDOutputTaskHandle = NULL;
+volatile bool b_led_frame_pending = false; // Set by the main loop on hand-off, cleared by the output task once shown.
+#endif
+
+#if defined(DEBUG_LED_OUTPUT)
+/*
+ * Timing statistics, reset after each report. All times are in microseconds.
+ * Compare the loop times with and without LED_OUTPUT_TASK to see the cost of FastLED.show().
+ */
+struct LEDOutputStats {
+  uint32_t i_loop_count = 0;     // Main loop iterations.
+  uint32_t i_loop_total = 0;     // Total time spent in the main loop (up to the task delay).
+  uint32_t i_loop_max = 0;       // Longest single main loop iteration.
+  uint32_t i_frames_shown = 0;   // Frames sent to the LEDs.
+  uint32_t i_frames_skipped = 0; // Frames due while the output task was still busy.
+  uint32_t i_show_total = 0;     // Total time spent in FastLED.show().
+  uint32_t i_show_max = 0;       // Longest single FastLED.show().
+};
+
+LEDOutputStats ledOutputStats;
+portMUX_TYPE ledOutputStatsMux = portMUX_INITIALIZER_UNLOCKED;
+millisDelay ms_led_output_stats;
+const uint16_t i_led_output_stats_delay = 1000;
+
+// Records the duration of a single FastLED.show(), which may be called from either core.
+void recordLEDShowTime(uint32_t i_show_time) {
+  portENTER_CRITICAL(&ledOutputStatsMux);
+  ledOutputStats.i_frames_shown++;
+  ledOutputStats.i_show_total += i_show_time;
+
+  if(i_show_time > ledOutputStats.i_show_max) {
+    ledOutputStats.i_show_max = i_show_time;
+  }
+  portEXIT_CRITICAL(&ledOutputStatsMux);
+}
+
+// Records the duration of a single main loop iteration.
+void recordLoopTime(uint32_t i_loop_time) {
+  portENTER_CRITICAL(&ledOutputStatsMux);
+  ledOutputStats.i_loop_count++;
+  ledOutputStats.i_loop_total += i_loop_time;
+
+  if(i_loop_time > ledOutputStats.i_loop_max) {
+    ledOutputStats.i_loop_max = i_loop_time;
+  }
+  portEXIT_CRITICAL(&ledOutputStatsMux);
+}
+
+// Sends a summary of the loop and LED output timing once per reporting period.
+void reportLEDOutputStats() {
+  if(!ms_led_output_stats.isRunning()) {
+    ms_led_output_stats.start(i_led_output_stats_delay);
+    return;
+  }
+
+  if(ms_led_output_stats.justFinished()) {
+    portENTER_CRITICAL(&ledOutputStatsMux);
+    LEDOutputStats stats = ledOutputStats;
+    ledOutputStats = LEDOutputStats();
+    portEXIT_CRITICAL(&ledOutputStatsMux);
+
+    char buffer[160];
+    snprintf(buffer, sizeof(buffer), "Loop: %lu iter, avg %lu us, max %lu us | LEDs: %lu shown, %lu skipped, show avg %lu us, max %lu us",
+             (unsigned long)stats.i_loop_count,
+             (unsigned long)(stats.i_loop_count > 0 ? stats.i_loop_total / stats.i_loop_count : 0),
+             (unsigned long)stats.i_loop_max,
+             (unsigned long)stats.i_frames_shown,
+             (unsigned long)stats.i_frames_skipped,
+             (unsigned long)(stats.i_frames_shown > 0 ? stats.i_show_total / stats.i_frames_shown : 0),
+             (unsigned long)stats.i_show_max);
+    sendDebug(buffer);
+
+    ms_led_output_stats.start(i_led_output_stats_delay);
+  }
+}
+#endif
+
+#if defined(LED_OUTPUT_TASK)
+// Waits for a frame-ready notification, then sends the front buffers to all LED chains.
+void LEDOutputTask(void *parameter) {
+  for(;;) {
+    ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+
+    #if defined(DEBUG_LED_OUTPUT)
+      uint32_t i_show_start = micros();
+      FastLED.show();
+      recordLEDShowTime(micros() - i_show_start);
+    #else
+      FastLED.show();
+    #endif
+
+    b_led_frame_pending = false;
+  }
+}
+
+// Creates the output task on the core opposite to the main loop.
+void startLEDOutputTask() {
+  if(LEDOutputTaskHandle == NULL) {
+    uint8_t i_core = xPortGetCoreID() == 0 ? 1 : 0;
+    xTaskCreatePinnedToCore(LEDOutputTask, "LEDOutputTask", 4096, NULL, 2, &LEDOutputTaskHandle, i_core);
+  }
+}
+#endif
+
+// Sends the current frame to the LEDs, either directly or by handing it off to the output task.
+void showLEDs() {
+#if defined(LED_OUTPUT_TASK)
+  if(LEDOutputTaskHandle == NULL) {
+    return;
+  }
+
+  if(b_led_frame_pending) {
+    // Output task has not finished the previous frame, so try again when the next frame is due.
+    #if defined(DEBUG_LED_OUTPUT)
+      portENTER_CRITICAL(&ledOutputStatsMux);
+      ledOutputStats.i_frames_skipped++;
+      portEXIT_CRITICAL(&ledOutputStatsMux);
+    #endif
+    return;
+  }
+
+  memcpy(pack_leds_out, pack_leds, sizeof(pack_leds_out));
+  memcpy(cyclotron_leds_out, cyclotron_leds, sizeof(cyclotron_leds_out));
+
+  b_led_frame_pending = true;
+  xTaskNotifyGive(LEDOutputTaskHandle);
+#elif defined(DEBUG_LED_OUTPUT)
+  uint32_t i_show_start = micros();
+  FastLED.show();
+  recordLEDShowTime(micros() - i_show_start);
+#else
+  FastLED.show();
+#endif
+}
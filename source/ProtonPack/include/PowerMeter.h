@@ -70,12 +70,25 @@ struct PowerMeter {
 PowerMeter wandReading;
 PowerMeter packReading;
 
+// Raw values read from the monitor by a queued i2c job, consumed once the job has completed.
+struct PowerMeterSample {
+  float ShuntVoltage = 0; // mV
+  float ShuntCurrent = 0; // A
+  float BusVoltage = 0;   // V
+  float BusPower = 0;     // W
+};
+
+PowerMeterSample wandSample;
+PowerMeterSample packSample;
+
 // Forward function declarations.
 void packStartup(bool fullStartup);
 void wandFiring();
 void wandStoppedFiring();
 void cyclotronSpeedRevert();
 void packOverheatingStart();
+void wandPowerReadingDone(const I2CTransaction& transaction);
+void packVoltageReadingDone(const I2CTransaction& transaction);
 
 // Configure and calibrate the power meter device.
 void powerMeterConfig() {
@@ -127,11 +140,11 @@ void doWandPowerReading() {
   // Only uncomment this debug if absolutely needed!
   //sendDebug(F("Reading Power Meter"));
 
-  // Reads the latest values from the monitor.
-  wandReading.ShuntVoltage = monitor.shuntVoltage();
-  wandReading.ShuntCurrent = monitor.shuntCurrent();
-  wandReading.BusVoltage = monitor.busVoltage();
-  wandReading.BusPower = monitor.busPower();
+  // Takes the latest values read from the monitor by readWandPowerJob().
+  wandReading.ShuntVoltage = wandSample.ShuntVoltage;
+  wandReading.ShuntCurrent = wandSample.ShuntCurrent;
+  wandReading.BusVoltage = wandSample.BusVoltage;
+  wandReading.BusPower = wandSample.BusPower;
 
   // Update the smoothed current (A) values using the latest reading using an exponential moving average.
   wandReading.BattVoltage = wandReading.BusVoltage + wandReading.ShuntVoltage; // Total Volts
@@ -146,10 +159,29 @@ void doWandPowerReading() {
   wandReading.ReadTick = i_new_time - wandReading.LastRead;
   wandReading.AmpHours += (wandReading.ShuntCurrent * wandReading.ReadTick) / 3600000.0; // Div. by 1000 x 60 x 60
   wandReading.LastRead = i_new_time;
+}
+
+// Runs with the i2c bus to itself, reading the latest values from the monitor for the wand.
+uint8_t readWandPowerJob(void* context) {
+  PowerMeterSample* sample = static_cast<PowerMeterSample*>(context);
+
+  sample->ShuntVoltage = monitor.shuntVoltage();
+  sample->ShuntCurrent = monitor.shuntCurrent();
+  sample->BusVoltage = monitor.busVoltage();
+  sample->BusPower = monitor.busPower();
 
   // Prepare for next read -- this is security just in case the INA219 is reset by transient current.
   monitor.recalibrate();
   monitor.reconfig();
+
+  return I2C_STATUS_OK;
+}
+
+// Runs with the i2c bus to itself, reading only the bus voltage from the monitor for the pack.
+uint8_t readPackVoltageJob(void* context) {
+  static_cast<PowerMeterSample*>(context)->BusVoltage = monitor.busVoltage();
+
+  return I2C_STATUS_OK;
 }
 
 /**
@@ -157,12 +189,16 @@ void doWandPowerReading() {
  * Purpose: Reads the pack's supply voltage (Vcc) using internal bandgap reference (ATMega2560 only).
  * Inputs: None
  * Outputs: Updates packReading.BusVoltage with the measured voltage (in V).
+ *          Returns false if no new reading is available yet: either it was queued on the i2c bus, to be
+ *          completed by packVoltageReadingDone(), or the queue was full and this reading was skipped.
  */
-void doPackVoltageReading() {
+bool doPackVoltageReading() {
 #ifdef ESP32
   // For the ESP32 we cannot get the bandgap voltage so we'll use the INA219 chip to return a voltage.
   if(b_power_meter_available) {
-    packReading.BusVoltage = monitor.busVoltage();
+    // A refused submission is counted by the scheduler; the previous reading is not acted on again.
+    i2c_scheduler.submitJob(i_i2c_power_meter, readPackVoltageJob, packVoltageReadingDone, &packSample);
+    return false;
   }
 #else
   // REFS1 REFS0               --> 0 1, AVcc internal ref. -Selects AVcc reference
@@ -179,12 +215,15 @@ void doPackVoltageReading() {
   const long INTERNAL_REFERENCE_VOLTAGE = 1115L; // Adjust this value to your board's specific internal BG voltage x1000.
   packReading.BusVoltage = (((INTERNAL_REFERENCE_VOLTAGE * 1023L) / ADC) + 5L) / 10L; // Calculates for straight line value.
 #endif
+
+  return true;
 }
 
 // Perform a reading of values from the power meter for the pack.
-void doPackPowerReading() {
+// Returns false if the reading will complete later from the i2c bus.
+bool doPackPowerReading() {
   // Obtain bandgap voltage from the microcontroller.
-  doPackVoltageReading();
+  return doPackVoltageReading();
 }
 
 // Take actions based on current power state, specifically when there is no GPStar Neutrona Wand connected.
@@ -396,6 +435,15 @@ void updatePackPowerState() {
 #else
   attenuatorSerialSend(A_BATTERY_VOLTAGE_PACK, (uint16_t)(f_batt_volts));
 #endif
+
+#if defined(FLIGHT_RECORDER)
+  // Record the supply dropping too low (the ATMega reading is already x100).
+  #ifdef ESP32
+  checkSupplyVoltage((uint16_t)(f_batt_volts * 100));
+  #else
+  checkSupplyVoltage((uint16_t)(f_batt_volts));
+  #endif
+#endif
 }
 
 // Displays the latest gathered power meter values (for debugging only!).
@@ -436,14 +484,37 @@ void wandPowerDisplay() {
   }
 }
 
+// Handles a completed wand reading, called from i2c_scheduler.dispatch() in the main loop.
+void wandPowerReadingDone(const I2CTransaction& transaction) {
+  (void)transaction;
+
+  // A GPStar Neutrona Wand may have connected while the reading was queued.
+  if(!b_wand_connected && !b_wand_syncing) {
+    doWandPowerReading(); // Get latest V/A readings.
+    wandPowerDisplay(); // Show values on serial plotter.
+    updateWandPowerState(); // Take action on V/A values.
+  }
+}
+
+// Handles a completed pack voltage reading, called from i2c_scheduler.dispatch() in the main loop.
+void packVoltageReadingDone(const I2CTransaction& transaction) {
+  (void)transaction;
+
+  packReading.BusVoltage = packSample.BusVoltage;
+  updatePackPowerState(); // Take action on V/A values.
+}
+
 // Check the available timers for reading power meter data.
 void checkPowerMeter() {
+  PROFILE_SCOPE(PROFILE_POWER_METER);
+
   if(wandReading.ReadTimer.justFinished()) {
     // Only perform GPStar Lite functions if a GPStar Neutrona Wand is not connected.
     if(!b_wand_connected && !b_wand_syncing) {
-      doWandPowerReading(); // Get latest V/A readings.
-      wandPowerDisplay(); // Show values on serial plotter.
-      updateWandPowerState(); // Take action on V/A values.
+      // Queue the reading unless the last one is still waiting, with results handled by wandPowerReadingDone().
+      if(!i2c_scheduler.isPending(i_i2c_power_meter)) {
+        i2c_scheduler.submitJob(i_i2c_power_meter, readWandPowerJob, wandPowerReadingDone, &wandSample);
+      }
     }
     else {
       // If previously started via the power meter but a GPStar wand is connected,
@@ -463,8 +534,10 @@ void checkPowerMeter() {
   }
 
   if(packReading.ReadTimer.justFinished()) {
-    doPackPowerReading(); // Get latest voltage reading.
-    updatePackPowerState(); // Take action on V/A values.
+    // Get latest voltage reading, and take action now unless it was queued on the i2c bus.
+    if(doPackPowerReading()) {
+      updatePackPowerState(); // Take action on V/A values.
+    }
     packReading.ReadTimer.repeat();
   }
 }
\ No newline at end of file
@@ -0,0 +1,331 @@
+/**
+ *   GPStar Proton Pack - Ghostbusters Proton Pack & Neutrona Wand.
+ *   Copyright (C) 2023-2026 Michael Rajotte <michael.rajotte@gpstartechnologies.com>
+ *
+ *   This program is free software; you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation; either version 3 of the License, or
+ *   (at your option) any later version.
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License
+ *   along with this program; if not, see <https://www.gnu.org/licenses/>.
+ *
+ */
+
+#pragma once
+
+/*
+ * Optional main loop profiler, enabled by LOOP_PROFILER in Configuration.h.
+ *
+ * Each profiled section records its duration into a SectionStats histogram. The ESP32 counts CPU
+ * cycles, which are converted to microseconds using the current CPU frequency when reported, while
+ * the ATMega uses micros() directly (4us resolution). When CPU_GOVERNOR may change the frequency,
+ * cycle counts are instead scaled to 240 MHz as they are recorded (a section which spans a change
+ * is scaled by the new frequency). When neither the profiler nor the stall watchdog is enabled
+ * every macro below expands to nothing, so the profiled code is unchanged.
+ *
+ * Results are available from the /debug/perf route (ESP32), or by sending "p" over the serial (USB)
+ * console to print a table. Sending "r" clears all results.
+ *
+ * The same sections are tracked by the stall watchdog (STALL_WATCHDOG, see StallWatchdog.h), which
+ * needs to know which section is running and which took longest in each iteration of the loop.
+ */
+#if defined(LOOP_PROFILER) || defined(STALL_WATCHDOG)
+enum PROFILE_SECTIONS : uint8_t {
+  PROFILE_LOOP,        // One iteration of loop(), up to the task delay on the ESP32.
+  PROFILE_MUSIC,       // checkMusic()
+  PROFILE_SWITCHES,    // checkSwitches()
+  PROFILE_ROTARY,      // checkRotaryEncoder()
+  PROFILE_WAND,        // checkWand()
+  PROFILE_ATTENUATOR,  // checkAttenuator()
+  PROFILE_CYCLOTRON,   // cyclotronControl()
+  PROFILE_POWERCELL,   // powercellLoop()
+  PROFILE_LEDS,        // Composing and showing each LED frame in updateLEDs().
+  PROFILE_AUDIO,       // updateAudio()
+  PROFILE_POWER_METER, // checkPowerMeter()
+  PROFILE_PACK_ACTION, // Pack startup and shutdown from the action state in mainLoop().
+#ifdef ESP32
+  PROFILE_WEB,         // webLoops()
+#endif
+  PROFILE_SECTION_COUNT
+};
+#endif
+
+#if defined(LOOP_PROFILER)
+#ifdef ESP32
+  // Cycle counts of up to 2^25 (~140ms at 240MHz) before clamping.
+  #define PROFILE_BUCKETS PROFILER_BUCKETS_FOR_BITS(25)
+#else
+  // Microseconds of up to 2^13 (~8ms) before clamping; ~1.6KB of RAM for all sections.
+  #define PROFILE_BUCKETS PROFILER_BUCKETS_FOR_BITS(13)
+#endif
+
+#if defined(ESP32) && defined(CPU_GOVERNOR)
+const uint16_t i_profile_reference_mhz = 240; // Clock which all cycle counts are scaled to.
+uint16_t i_profile_cpu_mhz = 240; // Clock in use, kept up to date by applyCpuFrequency().
+#endif
+
+SectionStatsBuffer<PROFILE_BUCKETS> profile_stats[PROFILE_SECTION_COUNT];
+volatile bool b_profile_reset_requested = false; // Set by the web server, acted on by the main loop.
+
+// Current time in profiler ticks.
+inline uint32_t profileTicks() {
+#ifdef ESP32
+  return ESP.getCycleCount();
+#else
+  return micros();
+#endif
+}
+
+// Number of profiler ticks in one microsecond.
+uint32_t profileTicksPerMicro() {
+#if defined(ESP32) && defined(CPU_GOVERNOR)
+  return i_profile_reference_mhz;
+#elif defined(ESP32)
+  return getCpuFrequencyMhz();
+#else
+  return 1;
+#endif
+}
+
+inline void recordProfile(uint8_t i_section, uint32_t i_ticks) {
+#if defined(ESP32) && defined(CPU_GOVERNOR)
+  i_ticks = (uint64_t)i_ticks * i_profile_reference_mhz / i_profile_cpu_mhz;
+#endif
+  profile_stats[i_section].record(i_ticks);
+}
+#endif
+
+#if defined(STALL_WATCHDOG)
+/*
+ * Section tracking for the stall watchdog. All times are from micros().
+ */
+volatile uint8_t i_stall_section = PROFILE_LOOP; // Innermost section running now.
+uint32_t i_stall_iteration_start = 0;            // When the current iteration of the loop began.
+uint8_t i_stall_longest_section = PROFILE_LOOP;  // Longest section to finish in this iteration.
+uint32_t i_stall_longest_time = 0;
+
+// Declared in StallWatchdog.h, for the serial console.
+void printStalls();
+void clearStalls();
+#endif
+
+#if defined(FLIGHT_RECORDER)
+// Declared in FlightRecorder.h, for the serial console.
+void printFlightLog();
+void clearFlightLog();
+#endif
+
+#if defined(LOOP_PROFILER) || defined(STALL_WATCHDOG)
+
+const __FlashStringHelper* getProfileSectionName(uint8_t i_section) {
+  switch(i_section) {
+    case PROFILE_LOOP:
+      return F("loop");
+    case PROFILE_MUSIC:
+      return F("music");
+    case PROFILE_SWITCHES:
+      return F("switches");
+    case PROFILE_ROTARY:
+      return F("rotary");
+    case PROFILE_WAND:
+      return F("wand");
+    case PROFILE_ATTENUATOR:
+      return F("attenuator");
+    case PROFILE_CYCLOTRON:
+      return F("cyclotron");
+    case PROFILE_POWERCELL:
+      return F("powercell");
+    case PROFILE_LEDS:
+      return F("leds");
+    case PROFILE_AUDIO:
+      return F("audio");
+    case PROFILE_POWER_METER:
+      return F("powermeter");
+    case PROFILE_PACK_ACTION:
+      return F("actions");
+#ifdef ESP32
+    case PROFILE_WEB:
+      return F("web");
+#endif
+    default:
+      return F("unknown");
+  }
+}
+#endif
+
+#if defined(LOOP_PROFILER)
+void resetProfile() {
+  for(uint8_t i = 0; i < PROFILE_SECTION_COUNT; i++) {
+    profile_stats[i].reset();
+  }
+
+  i2c_scheduler.resetStats();
+}
+#endif
+
+#if defined(LOOP_PROFILER) || defined(STALL_WATCHDOG)
+// Records the time from construction until the end of the enclosing scope.
+class ProfileScope {
+public:
+  ProfileScope(uint8_t i_section) : i_section(i_section) {
+  #if defined(LOOP_PROFILER)
+    i_start = profileTicks();
+  #endif
+  #if defined(STALL_WATCHDOG)
+    i_outer_section = i_stall_section;
+    i_stall_section = i_section;
+    i_stall_start = micros();
+  #endif
+  }
+
+  ~ProfileScope() {
+  #if defined(LOOP_PROFILER)
+    recordProfile(i_section, profileTicks() - i_start);
+  #endif
+  #if defined(STALL_WATCHDOG)
+    uint32_t i_stall_time = micros() - i_stall_start;
+
+    if(i_stall_time > i_stall_longest_time) {
+      i_stall_longest_time = i_stall_time;
+      i_stall_longest_section = i_section;
+    }
+
+    i_stall_section = i_outer_section;
+  #endif
+  }
+
+private:
+  uint8_t i_section;
+#if defined(LOOP_PROFILER)
+  uint32_t i_start;
+#endif
+#if defined(STALL_WATCHDOG)
+  uint8_t i_outer_section;
+  uint32_t i_stall_start;
+#endif
+};
+#endif
+
+#if defined(LOOP_PROFILER)
+// Prints a table of all sections to the serial (USB) console, in microseconds.
+void printProfile() {
+  uint32_t i_ticks_per_micro = profileTicksPerMicro();
+
+  Serial.println();
+  Serial.print(F("Loop profile (us), CPU MHz: "));
+  Serial.println(i_ticks_per_micro);
+  Serial.println(F("section       count       min     avg     max     p99"));
+
+  for(uint8_t i = 0; i < PROFILE_SECTION_COUNT; i++) {
+    SectionSummary summary = profile_stats[i].summarise(i_ticks_per_micro);
+    char buffer[56];
+
+    snprintf(buffer, sizeof(buffer), "%10lu%10lu%8lu%8lu%8lu", (unsigned long)summary.count, (unsigned long)summary.min,
+             (unsigned long)summary.avg, (unsigned long)summary.max, (unsigned long)summary.p99);
+    Serial.print(getProfileSectionName(i));
+    for(uint8_t j = strlen_P((const char*)getProfileSectionName(i)); j < 12; j++) {
+      Serial.print(' ');
+    }
+    Serial.println(buffer);
+  }
+
+  // Bus time used by each i2c device, measured by the scheduler.
+  Serial.println(F("i2c device       count  errors  bus ms  max us wait us"));
+
+  for(uint8_t i = 1; i <= i2c_scheduler.getDeviceCount(); i++) {
+    I2CDeviceStats stats;
+    char buffer[72];
+
+    i2c_scheduler.getDeviceStats(i, stats);
+    snprintf(buffer, sizeof(buffer), "%-12s%10lu%8lu%8lu%8lu%8lu", i2c_scheduler.getDeviceName(i),
+             (unsigned long)stats.transactions, (unsigned long)stats.errors, (unsigned long)(stats.busMicros / 1000),
+             (unsigned long)stats.maxBusMicros, (unsigned long)stats.maxWaitMicros);
+    Serial.println(buffer);
+  }
+}
+#endif
+
+#if defined(LOOP_PROFILER) || defined(STALL_WATCHDOG) || defined(FLIGHT_RECORDER)
+// Handles single-character profiler, stall watchdog and flight recorder commands from the serial (USB) console.
+void checkProfileConsole() {
+#if defined(LOOP_PROFILER)
+  if(b_profile_reset_requested) {
+    resetProfile();
+    b_profile_reset_requested = false;
+  }
+#endif
+
+  while(Serial.available() > 0) {
+    switch(Serial.read()) {
+#if defined(LOOP_PROFILER)
+      case 'p':
+      case 'P':
+        printProfile();
+      break;
+
+      case 'r':
+      case 'R':
+        resetProfile();
+        Serial.println(F("Loop profile reset"));
+      break;
+#endif
+
+#if defined(STALL_WATCHDOG)
+      case 's':
+      case 'S':
+        printStalls();
+      break;
+
+      case 'c':
+      case 'C':
+        clearStalls();
+        Serial.println(F("Stall records cleared"));
+      break;
+#endif
+
+#if defined(FLIGHT_RECORDER)
+      case 'e':
+      case 'E':
+        printFlightLog();
+      break;
+
+      case 'z':
+      case 'Z':
+        clearFlightLog();
+        Serial.println(F("Flight log cleared"));
+      break;
+#endif
+
+      default:
+        // Ignore anything else, including line endings.
+      break;
+    }
+  }
+}
+
+#endif
+
+#if defined(LOOP_PROFILER) || defined(STALL_WATCHDOG)
+  #define PROFILE_CONCAT_(a, b) a##b
+  #define PROFILE_CONCAT(a, b) PROFILE_CONCAT_(a, b)
+
+  // Profiles the rest of the enclosing scope.
+  #define PROFILE_SCOPE(section) ProfileScope PROFILE_CONCAT(profile_scope_, __LINE__)(section)
+#else
+  #define PROFILE_SCOPE(section)
+#endif
+
+#if defined(LOOP_PROFILER)
+  // Profiles a span within a single scope which cannot be enclosed by its own block.
+  #define PROFILE_BEGIN(section) uint32_t PROFILE_CONCAT(i_profile_start_, section) = profileTicks()
+  #define PROFILE_END(section) recordProfile(section, profileTicks() - PROFILE_CONCAT(i_profile_start_, section))
+#else
+  #define PROFILE_BEGIN(section)
+  #define PROFILE_END(section)
+#endif
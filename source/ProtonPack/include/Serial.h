@@ -311,6 +311,8 @@ void wandDisconnectCheck() {
   if(b_wand_connected) {
     if(ms_wand_check.justFinished()) {
       // Timer just ran out, so we must assume the wand was disconnected.
+      FLIGHT_EVENT(EVENT_WAND_DISCONNECTED);
+
       if(b_diagnostic) {
         // While in diagnostic mode, play a sound to indicate the wand is disconnected.
         playEffect(S_VENT_BEEP);
@@ -850,6 +852,8 @@ void handleSmokePrefsUpdate() {
 
 // Incoming messages from the extra Attenuator port.
 void checkAttenuator() {
+  PROFILE_SCOPE(PROFILE_ATTENUATOR);
+
   if(attenuatorComs.available() > 0) {
     uint8_t i_packet_id = attenuatorComs.currentPacketID();
     // sendDebug(String(F("Serial PacketID: ")) + String(i_packet_id));
@@ -1009,6 +1013,8 @@ void doAttenuatorSync() {
 
 // Incoming messages from the wand.
 void checkWand() {
+  PROFILE_SCOPE(PROFILE_WAND);
+
   if(wandComs.available() > 0) {
     uint8_t i_packet_id = wandComs.currentPacketID();
     // sendDebug(String(F("Wand PacketID: ")) + String(i_packet_id));
@@ -1086,6 +1092,7 @@ void doWandSync() {
   // This will be cleared once the wand responds back that it has been synchronized.
   b_wand_syncing = true;
   b_wand_connected = false;
+  b_wand_idle_sleep = false; // A newly synchronized wand does not yet know the pack may sleep.
   ms_wand_check.stop();
 
   if(b_diagnostic) {
@@ -1208,10 +1215,16 @@ void handleWandCommand(uint8_t i_command, uint16_t i_value) {
       }
     break;
 
+    case W_IDLE_SLEEP:
+      // The wand acknowledged our idle sleep notice, and will wake us before sending (2) or no longer needs to (1).
+      b_wand_idle_sleep = (i_value == 2);
+    break;
+
     case W_SYNCHRONIZED:
       sendDebug(F("Wand Synchronized"));
       b_wand_syncing = false; // Stop trying to sync since we've successfully synchronized.
       b_wand_connected = true; // Wand sent sync confirmation, so it must be connected.
+      FLIGHT_EVENT(EVENT_WAND_CONNECTED);
       ms_wand_check.start(i_wand_disconnect_delay); // Wand is synchronized, so start the keep-alive timer.
       attenuatorSerialSend(A_WAND_CONNECTED); // Tell the Attenuator the wand is (re-)connected.
 
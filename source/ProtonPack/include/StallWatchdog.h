@@ -0,0 +1,325 @@
+/**
+ *   GPStar Proton Pack - Ghostbusters Proton Pack & Neutrona Wand.
+ *   Copyright (C) 2023-2026 Michael Rajotte <michael.rajotte@gpstartechnologies.com>
+ *
+ *   This program is free software; you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation; either version 3 of the License, or
+ *   (at your option) any later version.
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License
+ *   along with this program; if not, see <https://www.gnu.org/licenses/>.
+ *
+ */
+
+#pragma once
+
+/*
+ * Optional main loop stall watchdog, enabled by STALL_WATCHDOG in Configuration.h.
+ *
+ * Every pass of loop() is timed, and the profiled sections (see Profiler.h) keep track of which one
+ * is running. Any pass which takes longer than i_stall_threshold is kept in a small ring of records,
+ * along with the state of the pack, in memory which is not cleared by a reset (though it is lost when
+ * the power is removed). Records from before a crash or watchdog reset can then be read afterwards.
+ *
+ * On the ESP32 a hardware timer interrupts the loop when a pass reaches the threshold, so the record
+ * names the section which was running at that moment and includes a backtrace, even if the pass never
+ * finishes. The backtrace begins with the watchdog's own interrupt, and can be decoded with:
+ *   xtensa-esp32s3-elf-addr2line -pfiaC -e firmware.elf <addresses>
+ *
+ * The ATMega has no spare timer, so passes are only checked once they finish, and the record names the
+ * section which took longest.
+ */
+#if defined(STALL_WATCHDOG)
+const uint16_t i_stall_threshold = 100; // Longest pass of the loop (ms) before it is recorded.
+const uint16_t i_stall_log_magic = 0x5357; // Marks the log as valid. Change it when the layout changes.
+
+#ifdef ESP32
+  #define STALL_RECORD_COUNT 8
+  #define STALL_BACKTRACE_DEPTH 16
+  #define STALL_PERSISTENT RTC_NOINIT_ATTR
+#else
+  #define STALL_RECORD_COUNT 4
+  #define STALL_PERSISTENT __attribute__((section(".noinit")))
+#endif
+
+// Bits of StallSnapshot::i_flags.
+enum STALL_FLAGS : uint8_t {
+  STALL_WAND_CONNECTED = 1 << 0,
+  STALL_ATTENUATOR_CONNECTED = 1 << 1,
+  STALL_WAND_FIRING = 1 << 2,
+  STALL_OVERHEATING = 1 << 3,
+  STALL_VENTING = 1 << 4,
+  STALL_ALARM = 1 << 5,
+  STALL_MUSIC = 1 << 6
+};
+
+// State of the pack when a stall was recorded.
+struct StallSnapshot {
+  uint8_t i_pack_state;   // PACK_STATE
+  uint8_t i_action_state; // PACK_ACTION_STATE
+  uint8_t i_system_mode;
+  uint8_t i_system_theme;
+  uint8_t i_stream_mode;
+  uint8_t i_power_level;
+  uint8_t i_flags;        // STALL_FLAGS
+};
+
+struct StallRecord {
+  uint32_t i_time;           // millis() when the stall was recorded.
+  uint16_t i_boot;           // Boot on which the stall happened.
+  uint16_t i_duration;       // Length of the pass (ms), or 0 if it never finished.
+  uint16_t i_longest_time;   // Longest section to finish during the pass (ms).
+  uint8_t i_section;         // Section running at the threshold (ESP32), or which took longest (ATMega).
+  uint8_t i_longest_section; // Longest section to finish during the pass.
+  StallSnapshot snapshot;
+#ifdef ESP32
+  bool b_loop_task;          // Whether the loop task was the one interrupted, rather than another task.
+  uint32_t i_backtrace[STALL_BACKTRACE_DEPTH];
+#endif
+};
+
+struct StallLog {
+  uint16_t i_magic;
+  uint16_t i_boot;  // Incremented on every boot.
+  uint8_t i_next;   // Record to be written next.
+  uint8_t i_count;  // Number of valid records.
+  StallRecord records[STALL_RECORD_COUNT];
+};
+
+STALL_PERSISTENT StallLog stall_log;
+volatile bool b_stall_clear_requested = false; // Set by the web server, acted on by the main loop.
+
+#ifdef ESP32
+gptimer_handle_t stall_timer = nullptr;
+TaskHandle_t stall_loop_task = nullptr;
+volatile uint8_t i_stall_pending = 0; // Record begun by the timer during this pass, plus one, or 0.
+#endif
+
+void clearStalls() {
+  stall_log.i_next = 0;
+  stall_log.i_count = 0;
+}
+
+// Takes the next record from the ring, overwriting the oldest once it is full.
+StallRecord& nextStallRecord() {
+  StallRecord& record = stall_log.records[stall_log.i_next];
+
+  memset(&record, 0, sizeof(record));
+  record.i_time = millis();
+  record.i_boot = stall_log.i_boot;
+
+  stall_log.i_next = (stall_log.i_next + 1) % STALL_RECORD_COUNT;
+
+  if(stall_log.i_count < STALL_RECORD_COUNT) {
+    stall_log.i_count++;
+  }
+
+  return record;
+}
+
+void captureStallSnapshot(StallSnapshot& snapshot) {
+  snapshot.i_pack_state = PACK_STATE;
+  snapshot.i_action_state = PACK_ACTION_STATE;
+  snapshot.i_system_mode = gpstarPack.getSystemMode();
+  snapshot.i_system_theme = gpstarPack.getSystemTheme();
+  snapshot.i_stream_mode = gpstarPack.getStreamMode();
+  snapshot.i_power_level = gpstarPack.getPowerLevel();
+  snapshot.i_flags = (b_wand_connected ? STALL_WAND_CONNECTED : 0) |
+                     (b_attenuator_connected ? STALL_ATTENUATOR_CONNECTED : 0) |
+                     (b_wand_firing ? STALL_WAND_FIRING : 0) |
+                     (b_overheating ? STALL_OVERHEATING : 0) |
+                     (b_venting ? STALL_VENTING : 0) |
+                     (b_pack_alarm ? STALL_ALARM : 0) |
+                     (b_playing_music ? STALL_MUSIC : 0);
+}
+
+#ifdef ESP32
+// Runs when a pass of the loop reaches the threshold, on the same core as the loop.
+bool onStallAlarm(gptimer_handle_t timer, const gptimer_alarm_event_data_t* edata, void* user_ctx) {
+  StallRecord& record = nextStallRecord();
+
+  record.i_section = i_stall_section;
+  record.b_loop_task = xTaskGetCurrentTaskHandle() == stall_loop_task;
+  captureStallSnapshot(record.snapshot);
+
+  #if defined(__XTENSA__)
+  // The backtrace continues from this interrupt into whichever task it interrupted.
+  esp_backtrace_frame_t frame;
+  esp_backtrace_get_start(&frame.pc, &frame.sp, &frame.next_pc);
+
+  for(uint8_t i = 0; i < STALL_BACKTRACE_DEPTH; i++) {
+    record.i_backtrace[i] = esp_cpu_process_stack_pc(frame.pc);
+
+    if(frame.next_pc == 0 || !esp_backtrace_get_next_frame(&frame)) {
+      break;
+    }
+  }
+  #endif
+
+  i_stall_pending = stall_log.i_next == 0 ? STALL_RECORD_COUNT : stall_log.i_next;
+
+  return false; // No task was woken.
+}
+#endif
+
+void setupStallWatchdog() {
+  // Anything else is left over from before the power was applied.
+  if(stall_log.i_magic != i_stall_log_magic || stall_log.i_next >= STALL_RECORD_COUNT || stall_log.i_count > STALL_RECORD_COUNT) {
+    memset(&stall_log, 0, sizeof(stall_log));
+    stall_log.i_magic = i_stall_log_magic;
+  }
+
+  stall_log.i_boot++;
+
+#ifdef ESP32
+  // The timer interrupt is allocated on the core which registers the callback, which is the loop's.
+  stall_loop_task = xTaskGetCurrentTaskHandle();
+
+  gptimer_config_t timer_config = {};
+  timer_config.clk_src = GPTIMER_CLK_SRC_DEFAULT;
+  timer_config.direction = GPTIMER_COUNT_UP;
+  timer_config.resolution_hz = 1000000; // 1us per count.
+
+  gptimer_event_callbacks_t callbacks = {};
+  callbacks.on_alarm = onStallAlarm;
+
+  if(gptimer_new_timer(&timer_config, &stall_timer) != ESP_OK ||
+     gptimer_register_event_callbacks(stall_timer, &callbacks, nullptr) != ESP_OK ||
+     gptimer_enable(stall_timer) != ESP_OK || gptimer_start(stall_timer) != ESP_OK) {
+    debugln(F("Stall watchdog timer unavailable, stalls will only be recorded once they finish"));
+    stall_timer = nullptr;
+  }
+#endif
+
+  if(stall_log.i_count > 0) {
+    debugln(String(F("Stall records kept from a previous boot: ")) + String(stall_log.i_count));
+  }
+}
+
+// Called at the start of every pass of the loop.
+void stallIterationBegin() {
+  i_stall_section = PROFILE_LOOP;
+  i_stall_longest_section = PROFILE_LOOP;
+  i_stall_longest_time = 0;
+  i_stall_iteration_start = micros();
+
+#ifdef ESP32
+  if(stall_timer != nullptr) {
+    gptimer_alarm_config_t alarm_config = {};
+    alarm_config.alarm_count = (uint64_t)i_stall_threshold * 1000;
+
+    gptimer_set_raw_count(stall_timer, 0);
+    gptimer_set_alarm_action(stall_timer, &alarm_config);
+  }
+#endif
+}
+
+// Called at the end of every pass of the loop, and before anything (eg. light sleep) which may legitimately pause it.
+void stallIterationEnd() {
+#ifdef ESP32
+  if(stall_timer != nullptr) {
+    gptimer_set_alarm_action(stall_timer, nullptr);
+  }
+#endif
+
+  uint32_t i_duration = (micros() - i_stall_iteration_start) / 1000;
+
+  if(i_duration >= i_stall_threshold) {
+    StallRecord* record = nullptr;
+
+#ifdef ESP32
+    if(i_stall_pending > 0) {
+      // Complete the record begun by the timer.
+      record = &stall_log.records[i_stall_pending - 1];
+    }
+#endif
+
+    if(record == nullptr) {
+      record = &nextStallRecord();
+      record->i_section = i_stall_longest_section;
+      captureStallSnapshot(record->snapshot);
+    }
+
+    record->i_duration = i_duration > 0xFFFF ? 0xFFFF : i_duration;
+    record->i_longest_section = i_stall_longest_section;
+    record->i_longest_time = i_stall_longest_time / 1000;
+  }
+
+#ifdef ESP32
+  i_stall_pending = 0;
+#endif
+
+  if(b_stall_clear_requested) {
+    clearStalls();
+    b_stall_clear_requested = false;
+  }
+}
+
+// Returns a record by age, where 0 is the oldest.
+const StallRecord& getStallRecord(uint8_t i) {
+  return stall_log.records[(stall_log.i_next + STALL_RECORD_COUNT - stall_log.i_count + i) % STALL_RECORD_COUNT];
+}
+
+// Prints all records to the serial (USB) console, oldest first.
+void printStalls() {
+  Serial.println();
+  Serial.print(F("Stalls over "));
+  Serial.print(i_stall_threshold);
+  Serial.print(F(" ms, this is boot "));
+  Serial.print(stall_log.i_boot);
+#ifdef ESP32
+  Serial.print(F(" (reset reason "));
+  Serial.print(esp_reset_reason());
+  Serial.print(')');
+#endif
+  Serial.println();
+
+  for(uint8_t i = 0; i < stall_log.i_count; i++) {
+    const StallRecord& record = getStallRecord(i);
+    char buffer[72];
+
+    snprintf(buffer, sizeof(buffer), "Boot %u at %lu ms: ", record.i_boot, (unsigned long)record.i_time);
+    Serial.print(buffer);
+
+    if(record.i_duration > 0) {
+      Serial.print(record.i_duration);
+      Serial.print(F(" ms in "));
+    }
+    else {
+      Serial.print(F("did not finish in "));
+    }
+
+    Serial.print(getProfileSectionName(record.i_section));
+    Serial.print(F(", longest "));
+    Serial.print(getProfileSectionName(record.i_longest_section));
+    Serial.print(' ');
+    Serial.print(record.i_longest_time);
+    Serial.println(F(" ms"));
+
+    snprintf(buffer, sizeof(buffer), "  pack %u action %u mode %u theme %u stream %u level %u flags 0x%02x",
+             record.snapshot.i_pack_state, record.snapshot.i_action_state, record.snapshot.i_system_mode,
+             record.snapshot.i_system_theme, record.snapshot.i_stream_mode, record.snapshot.i_power_level,
+             record.snapshot.i_flags);
+    Serial.println(buffer);
+
+#ifdef ESP32
+    if(record.i_backtrace[0] != 0) {
+      Serial.print(record.b_loop_task ? F("  backtrace (loop):") : F("  backtrace (other task):"));
+
+      for(uint8_t j = 0; j < STALL_BACKTRACE_DEPTH && record.i_backtrace[j] != 0; j++) {
+        snprintf(buffer, sizeof(buffer), " 0x%08lx", (unsigned long)record.i_backtrace[j]);
+        Serial.print(buffer);
+      }
+
+      Serial.println();
+    }
+#endif
+  }
+}
+#endif
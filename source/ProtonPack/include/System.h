@@ -126,6 +126,31 @@ void ventLightLEDW(bool b_on) {
   }
 }
 
+// Sets a single N-Filter jewel LED through the vent light compositor layer.
+void ventLightPixel(uint8_t i_led, const CRGB& c_colour) {
+  vent_light_layer.setPixel(i_led, c_colour.r, c_colour.g, c_colour.b);
+}
+
+// Sets a single Power Cell LED through the Power Cell compositor layer.
+void powercellPixel(uint8_t i_led, const CRGB& c_colour) {
+  powercell_layer.setPixel(i_led, c_colour.r, c_colour.g, c_colour.b);
+}
+
+// Sets a single Cyclotron Lid LED, counted from the first lid LED, through the Cyclotron compositor layer.
+void cyclotronPixel(uint8_t i_led, const CRGB& c_colour) {
+  cyclotron_layer.setPixel(i_led, c_colour.r, c_colour.g, c_colour.b);
+}
+
+// Returns the colour last drawn into the Cyclotron compositor layer for a lid LED (black if cleared).
+CRGB getCyclotronPixel(uint8_t i_led) {
+  if(!cyclotron_layer.isCovered(i_led)) {
+    return CRGB::Black;
+  }
+
+  const uint8_t* px = cyclotron_layer.getPixel(i_led);
+  return CRGB(px[0], px[1], px[2]);
+}
+
 void ventLight(bool b_on) {
   uint8_t i_colour_scheme = getDeviceColour(VENT_LIGHT, gpstarPack.getStreamMode(), true);
   b_vent_light_on = b_on;
@@ -167,46 +192,37 @@ void ventLight(bool b_on) {
       i_colour_scheme = C_RED;
     }
 
-    for(uint8_t i = i_vent_light_start; i < i_pack_num_leds; i++) {
-      pack_leds[i] = getHueAsRGB(VENT_LIGHT, i_colour_scheme); // Uses full brightness.
-    }
+    CRGB c_vent = getHueAsRGB(VENT_LIGHT, i_colour_scheme); // Uses full brightness.
+    vent_light_layer.fill(0, i_nfilter_jewel_leds, c_vent.r, c_vent.g, c_vent.b);
   }
   else {
-    for(uint8_t i = i_vent_light_start; i < i_pack_num_leds; i++) {
-      pack_leds[i] = getHueAsRGB(VENT_LIGHT, C_BLACK);
-    }
+    vent_light_layer.fill(0, i_nfilter_jewel_leds, 0, 0, 0);
   }
 }
 
-// This function handles returning ring-simulated Cyclotron lookup table values.
-uint8_t cyclotronLookupTable(uint8_t index) {
-  switch(i_cyclotron_num_leds) {
-    case QUAD_CYCLOTRON_LED_COUNT:
-      // DIY 4 LED array.
-      return PROGMEM_READU8(i_cyclotron_4led_matrix[index]);
-    break;
-
-    case HASLAB_CYCLOTRON_LED_COUNT:
-      // Hasbro 12 LED array.
-      return PROGMEM_READU8(i_cyclotron_12led_matrix[index]);
-    break;
+// Selects the Cyclotron Lid geometry row for the current LED count, falling back to 36 LEDs.
+void selectCyclotronGeometry() {
+  uint8_t i_fallback = 0;
 
-    case FRUTTO_CYCLOTRON_LED_COUNT:
-      // Frutto 20 LED array.
-      return PROGMEM_READU8(i_cyclotron_20led_matrix[index]);
-    break;
+  for(uint8_t i = 0; i < i_cyclotron_geometry_count; i++) {
+    uint8_t i_num_leds = PROGMEM_READU8(cyclotron_geometry[i].num_leds);
 
-    case MAX_CYCLOTRON_LED_COUNT:
-    default:
-      // Frutto/GPStar 36 LED array.
-      return PROGMEM_READU8(i_cyclotron_36led_matrix[index]);
-    break;
+    if(i_num_leds == i_cyclotron_num_leds) {
+      i_cyclotron_geometry = i;
+      return;
+    }
 
-    case OUTER_CYCLOTRON_LED_MAX:
-      // NeoPixel Ring 40 LED array.
-      return PROGMEM_READU8(i_cyclotron_40led_matrix[index]);
-    break;
+    if(i_num_leds == MAX_CYCLOTRON_LED_COUNT) {
+      i_fallback = i;
+    }
   }
+
+  i_cyclotron_geometry = i_fallback;
+}
+
+// This function handles returning ring-simulated Cyclotron lookup table values.
+uint8_t cyclotronLookupTable(uint8_t index) {
+  return PROGMEM_READU8(i_cyclotron_ring_matrix[i_cyclotron_geometry][index]);
 }
 
 void wandStopFiringSounds() {
@@ -799,9 +815,7 @@ void innerCyclotronRingUpdate(uint16_t iRampDelay) {
 // Turns off the LEDs in the Cyclotron Lid only.
 void cyclotronLidLedsOff() {
   if(!b_fade_out) {
-    for(uint8_t i = 0; i < i_cyclotron_num_leds; i++) {
-      pack_leds[i + i_cyclotron_led_start] = getHueAsRGB(CYCLOTRON_OUTER, C_BLACK);
-    }
+    cyclotron_layer.clear();
 
     clearCyclotronFades();
   }
@@ -905,12 +919,14 @@ bool fadeOutCyclotron() {
         b_return = true;
 
         if(cyclotronLookupTable(i) > 0) {
-          pack_leds[cyclotronLookupTable(i) + i_cyclotron_led_start - 1].maximizeBrightness(i_curr_brightness);
+          CRGB c_led = getCyclotronPixel(cyclotronLookupTable(i) - 1);
+          c_led.maximizeBrightness(i_curr_brightness);
+          cyclotronPixel(cyclotronLookupTable(i) - 1, c_led);
         }
       }
       else {
         if(cyclotronLookupTable(i) > 0) {
-          pack_leds[cyclotronLookupTable(i) + i_cyclotron_led_start - 1] = getHueAsRGB(CYCLOTRON_OUTER, C_BLACK);
+          cyclotronPixel(cyclotronLookupTable(i) - 1, getHueAsRGB(CYCLOTRON_OUTER, C_BLACK));
         }
       }
     }
@@ -947,6 +963,8 @@ void playVentSounds() {
 }
 
 void packStartup(bool fullStartup) {
+  FLIGHT_EVENT(EVENT_PACK_STARTUP, fullStartup);
+
   PACK_STATE = MODE_ON;
   PACK_ACTION_STATE = ACTION_IDLE;
 
@@ -1200,6 +1218,8 @@ void fanNFilter(bool b_fan_on) {
 }
 
 void packShutdown() {
+  FLIGHT_EVENT(EVENT_PACK_SHUTDOWN);
+
   PACK_STATE = MODE_OFF;
   PACK_ACTION_STATE = ACTION_IDLE;
   ms_delay_post.stop();
@@ -1212,7 +1232,7 @@ void packShutdown() {
       innerCyclotronCakeOff();
       ms_cyclotron_slime_effect.stop();
     }
-    ms_powercell.start(0);
+    b_powercell_step_now = true;
     ms_cyclotron.start(0);
     ms_cyclotron_ring.start(0);
     stopMashErrorSounds();
@@ -1385,9 +1405,7 @@ void powercellOn() {
 }
 
 void powercellOff() {
-  for(uint8_t i = 0; i < i_powercell_num_leds; i++) {
-    pack_leds[i] = getHueAsRGB(POWERCELL, C_BLACK);
-  }
+  powercell_layer.clear();
 
   i_powercell_led = 0;
 }
@@ -1463,7 +1481,8 @@ void packOffReset() {
     break;
   }
 
-  // Reset the Power Cell timer.
+  // Reset the Power Cell sweep and ramp down timer.
+  powercellRestart();
   ms_powercell.start(i_powercell_delay);
 
   // Reset the Cyclotron LED switch timer.
@@ -1669,9 +1688,9 @@ void cyclotronSwitchPlateLEDs() {
 void spectralLightsOff() {
   b_spectral_lights_on = false;
 
-  for(uint8_t i = 0; i < i_max_pack_leds; i++) {
-    pack_leds[i] = getHueAsRGB(POWERCELL, C_BLACK);
-  }
+  powercell_layer.clear();
+  cyclotron_layer.clear();
+  vent_light_layer.clear();
 
   for(uint8_t i = i_ic_cake_start; i <= i_ic_cake_end; i++) {
     cyclotron_leds[i] = getHueAsRGB(CYCLOTRON_INNER, C_BLACK);
@@ -1683,12 +1702,12 @@ void spectralLightsOn() {
 
   uint8_t i_colour_scheme = getDeviceColour(POWERCELL, SPECTRAL_CUSTOM, true);
   for(uint8_t i = 0; i < i_powercell_num_leds; i++) {
-    pack_leds[i] = getHueAsRGB(POWERCELL, i_colour_scheme);
+    powercellPixel(i, getHueAsRGB(POWERCELL, i_colour_scheme));
   }
 
   i_colour_scheme = getDeviceColour(CYCLOTRON_OUTER, SPECTRAL_CUSTOM, true);
   for(uint8_t i = 0; i < i_cyclotron_num_leds; i++) {
-    pack_leds[i + i_cyclotron_led_start] = getHueAsRGB(CYCLOTRON_OUTER, i_colour_scheme);
+    cyclotronPixel(i, getHueAsRGB(CYCLOTRON_OUTER, i_colour_scheme));
   }
 
   i_colour_scheme = getDeviceColour(CYCLOTRON_INNER, SPECTRAL_CUSTOM, true);
@@ -1704,18 +1723,28 @@ void spectralLightsOn() {
   attenuatorSerialSend(A_SPECTRAL_COLOUR_DATA);
 }
 
-void checkSwitches() {
-  // Perform loop() needed by ezButton.
-  switch_power.loop();
-  switch_alarm.loop();
-  switch_mode.loop();
-  switch_vibration.loop();
-  switch_cyclotron_lid.loop();
+void setupSwitches() {
+  pack_switches.attachPin(PACK_SWITCH_POWER, ION_ARM_SWITCH_PIN);
+  pack_switches.attachPin(PACK_SWITCH_ALARM, RIBBON_CABLE_SWITCH_PIN);
+  pack_switches.attachPin(PACK_SWITCH_MODE, YEAR_TOGGLE_PIN);
+  pack_switches.attachPin(PACK_SWITCH_VIBRATION, VIBRATION_TOGGLE_PIN);
+  pack_switches.attachPin(PACK_SWITCH_CYCLOTRON_LID, CYCLOTRON_LID_PIN);
 #ifndef ESP32
-  switch_cyclotron_direction.loop();
-  switch_smoke.loop();
+  pack_switches.attachPin(PACK_SWITCH_CYCLOTRON_DIRECTION, CYCLOTRON_DIRECTION_TOGGLE_PIN);
+  pack_switches.attachPin(PACK_SWITCH_SMOKE, SMOKE_TOGGLE_PIN);
 #endif
 
+  // Take the current switch positions as the starting state, so no edges are reported at boot.
+  pack_switches.setDebounceTime(50);
+  pack_switches.begin();
+}
+
+void checkSwitches() {
+  PROFILE_SCOPE(PROFILE_SWITCHES);
+
+  // Sample and debounce all switches at once.
+  pack_switches.update(millis());
+
   cyclotronSwitchPlateLEDs();
 
   if(b_disable_lid_detection) {
@@ -2390,7 +2419,7 @@ void powercellRampDown() {
       // Do Nothing.
     }
     else {
-      pack_leds[i_powercell_led] = getHueAsRGB(POWERCELL, C_BLACK);
+      powercellPixel(i_powercell_led, getHueAsRGB(POWERCELL, C_BLACK));
 
       i_powercell_led--;
     }
@@ -2428,9 +2457,158 @@ void powercellRampDown() {
   }
 }
 
+// Rebuilds the Power Cell sweep when its step or hold time or the LED count has changed, then lines the
+// sweep up with the LEDs shown so that the next step comes after the time for that position.
+void powercellSweep(uint16_t i_step, uint16_t i_hold) {
+  // Keep every step between 1 ms and i_powercell_step_max, so the sweep always moves and its keyframe times fit.
+  if(i_step < 1) {
+    i_step = 1;
+  }
+  else if(i_step > i_powercell_step_max) {
+    i_step = i_powercell_step_max;
+  }
+
+  if(i_hold < 1) {
+    i_hold = 1;
+  }
+  else if(i_hold > i_powercell_step_max) {
+    i_hold = i_powercell_step_max;
+  }
+
+  bool b_rebuild = i_step != i_powercell_step_time || i_hold != i_powercell_hold_time || i_powercell_num_leds != i_powercell_sweep_leds;
+
+  if(b_rebuild) {
+    i_powercell_step_time = i_step;
+    i_powercell_hold_time = i_hold;
+    i_powercell_sweep_leds = i_powercell_num_leds;
+    powercell_track.setKeyframes(powercell_frames, buildSweep(powercell_frames, MAX_POWERCELL_LED_COUNT + 2, i_powercell_num_leds, i_step, i_hold, 0, 0, 0), true);
+    powercell_track.play();
+  }
+
+  // Anything which sets i_powercell_led directly, or a step skipped while updating, moves the sweep back into line.
+  if(b_rebuild || powercell_track.getOutput().position != (uint8_t)i_powercell_led) {
+    powercell_track.seek(sweepKeyframe(i_powercell_sweep_leds, (uint8_t)i_powercell_led));
+  }
+}
+
+// Restarts the Power Cell sweep at the step time for the current theme, waiting a full step from the LEDs shown.
+void powercellRestart() {
+  // Bring the timeline up to now first, as the Power Cell may not have been stepped for a while.
+  pack_timeline.update(millis());
+  powercellSweep(i_powercell_delay, (gpstarPack.isThemeModern() && !b_pack_alarm) ? 333 : i_powercell_delay);
+  powercell_track.seek(sweepKeyframe(i_powercell_sweep_leds, (uint8_t)i_powercell_led));
+}
+
+// Time (ms) taken off a Power Cell step when the cyclotron speeds up before overheating.
+uint16_t powercellSpeedUp(uint16_t i_delay) {
+  uint16_t i_multiplier = 0;
+
+  if(i_powercell_multiplier > 1) {
+    switch(i_powercell_multiplier) {
+      default:
+        // Do nothing.
+      break;
+      case 2:
+        if(gpstarPack.isThemeModern()) {
+          if(i_delay > 5) {
+            i_multiplier = 5;
+          }
+          else {
+            i_multiplier = i_delay;
+          }
+        }
+        else {
+          if(i_delay > 10) {
+            i_multiplier = 10;
+          }
+          else {
+            i_multiplier = i_delay;
+          }
+        }
+      break;
+
+      case 3:
+        if(gpstarPack.isThemeModern()) {
+          if(i_delay > 10) {
+            i_multiplier = 10;
+          }
+          else {
+            i_multiplier = i_delay;
+          }
+        }
+        else {
+          if(i_delay > 20) {
+            i_multiplier = 20;
+          }
+          else {
+            i_multiplier = i_delay;
+          }
+        }
+      break;
+
+      case 4:
+        if(gpstarPack.isThemeModern()) {
+          if(i_delay > 15) {
+            i_multiplier = 15;
+          }
+          else {
+            i_multiplier = i_delay;
+          }
+        }
+        else {
+          if(i_delay > 30) {
+            i_multiplier = 30;
+          }
+          else {
+            i_multiplier = i_delay;
+          }
+        }
+      break;
+
+      case 5:
+        if(gpstarPack.isThemeModern()) {
+          if(i_delay > 25) {
+            i_multiplier = 25;
+          }
+          else {
+            i_multiplier = i_delay;
+          }
+        }
+        else {
+          if(i_delay > 40) {
+            i_multiplier = 40;
+          }
+          else {
+            i_multiplier = i_delay;
+          }
+        }
+      break;
+
+      case 6:
+        if(gpstarPack.isThemeModern()) {
+          i_multiplier = 30;
+        }
+        else {
+          if(i_delay > 50) {
+            i_multiplier = 50;
+          }
+          else {
+            i_multiplier = i_delay;
+          }
+        }
+      break;
+    }
+  }
+
+  return i_multiplier;
+}
+
 void powercellLoop() {
-  if(ms_powercell.justFinished()) {
-    uint16_t i_extra_delay = 0;
+  PROFILE_SCOPE(PROFILE_POWERCELL);
+
+  // The Power Cell steps each time its sweep on the pack timeline reaches the next keyframe.
+  if((pack_timeline.update(millis()) && powercell_track.getOutput().changed) || b_powercell_step_now) {
+    b_powercell_step_now = false;
 
     // Power Cell
     if(i_powercell_led >= i_powercell_num_leds) {
@@ -2449,11 +2627,6 @@ void powercellLoop() {
       if(!b_powercell_updating) {
         powercellDraw(i_powercell_led); // Update starting at a specific LED.
         i_powercell_led++;
-
-        // Add a small delay to pause the Power Cell when all Power Cell LEDs are lit up, to match Afterlife and Frozen Empire.
-        if((gpstarPack.isThemeModern()) && !b_pack_alarm && i_powercell_led >= i_powercell_num_leds) {
-          i_extra_delay = 333 - i_powercell_delay;
-        }
       }
     }
 
@@ -2486,112 +2659,15 @@ void powercellLoop() {
       i_pc_delay *= 5;
     }
 
-    // Speed up the Power Cell when the cyclotron speeds up before overheating.
-    uint16_t i_multiplier = 0;
-
-    if(i_powercell_multiplier > 1) {
-      switch(i_powercell_multiplier) {
-        default:
-          // Do nothing.
-        break;
-        case 2:
-          if(gpstarPack.isThemeModern()) {
-            if(i_pc_delay + i_extra_delay > 5) {
-              i_multiplier = 5;
-            }
-            else {
-              i_multiplier = i_pc_delay + i_extra_delay;
-            }
-          }
-          else {
-            if(i_pc_delay + i_extra_delay > 10) {
-              i_multiplier = 10;
-            }
-            else {
-              i_multiplier = i_pc_delay + i_extra_delay;
-            }
-          }
-        break;
-
-        case 3:
-          if(gpstarPack.isThemeModern()) {
-            if(i_pc_delay + i_extra_delay > 10) {
-              i_multiplier = 10;
-            }
-            else {
-              i_multiplier = i_pc_delay + i_extra_delay;
-            }
-          }
-          else {
-            if(i_pc_delay + i_extra_delay > 20) {
-              i_multiplier = 20;
-            }
-            else {
-              i_multiplier = i_pc_delay + i_extra_delay;
-            }
-          }
-        break;
-
-        case 4:
-          if(gpstarPack.isThemeModern()) {
-            if(i_pc_delay + i_extra_delay > 15) {
-              i_multiplier = 15;
-            }
-            else {
-              i_multiplier = i_pc_delay + i_extra_delay;
-            }
-          }
-          else {
-            if(i_pc_delay + i_extra_delay > 30) {
-              i_multiplier = 30;
-            }
-            else {
-              i_multiplier = i_pc_delay + i_extra_delay;
-            }
-          }
-        break;
-
-        case 5:
-          if(gpstarPack.isThemeModern()) {
-            if(i_pc_delay + i_extra_delay > 25) {
-              i_multiplier = 25;
-            }
-            else {
-              i_multiplier = i_pc_delay + i_extra_delay;
-            }
-          }
-          else {
-            if(i_pc_delay + i_extra_delay > 40) {
-              if(i_pc_delay + i_extra_delay > 40) {
-                i_multiplier = 40;
-              }
-              else {
-                i_multiplier = i_pc_delay + i_extra_delay;
-              }
-            }
-            else {
-              i_multiplier = i_pc_delay + i_extra_delay;
-            }
-          }
-        break;
+    // Add a small delay to pause the Power Cell when all Power Cell LEDs are lit up, to match Afterlife and Frozen Empire.
+    uint16_t i_hold_delay = i_pc_delay;
 
-        case 6:
-          if(gpstarPack.isThemeModern()) {
-            i_multiplier = 30;
-          }
-          else {
-            if(i_pc_delay + i_extra_delay > 50) {
-              i_multiplier = 50;
-            }
-            else {
-              i_multiplier = i_pc_delay + i_extra_delay;
-            }
-          }
-        break;
-      }
+    if(gpstarPack.isThemeModern() && !b_pack_alarm) {
+      i_hold_delay += 333 - i_powercell_delay;
     }
 
-    ms_powercell.start((i_pc_delay + i_extra_delay) - i_multiplier);
+    // Speed up the Power Cell when the cyclotron speeds up before overheating.
+    powercellSweep(i_pc_delay - powercellSpeedUp(i_pc_delay), i_hold_delay - powercellSpeedUp(i_hold_delay));
   }
 }
 
@@ -2623,7 +2699,7 @@ void powercellDraw(uint8_t i_start) {
       }
 
       // Note: Always assumed to be RGB for built-in.
-      pack_leds[i_tmp_powercell_led] = getHueAsRGB(POWERCELL, i_colour_scheme, i_brightness);
+      powercellPixel(i_tmp_powercell_led, getHueAsRGB(POWERCELL, i_colour_scheme, i_brightness));
     }
   }
 }
@@ -2635,55 +2711,80 @@ uint8_t cyclotron84LookupTable(uint8_t index) {
     index = 0;
   }
 
-  if(b_clockwise) {
-    switch(i_cyclotron_num_leds) {
-      case HASLAB_CYCLOTRON_LED_COUNT:
-        // 1984 CW 12 LED array.
-        return PROGMEM_READU8(i_1984_cyclotron_12_leds_cw[index]);
-      break;
+  // Counter-clockwise starts from the same lens and visits the others in reverse order.
+  if(!b_clockwise) {
+    index = (4 - index) & 3;
+  }
 
-      case FRUTTO_CYCLOTRON_LED_COUNT:
-        // 1984 CW 20 LED array.
-        return PROGMEM_READU8(i_1984_cyclotron_20_leds_cw[index]);
-      break;
+  return PROGMEM_READU8(cyclotron_geometry[i_cyclotron_geometry].lamps_1984[index]);
+}
 
-      case MAX_CYCLOTRON_LED_COUNT:
-      default:
-        // 1984 CW 36 LED array.
-        return PROGMEM_READU8(i_1984_cyclotron_36_leds_cw[index]);
-      break;
+#if defined(BENCHMARK_CYCLOTRON_LOOKUP)
+// Ring lookup as previously implemented, choosing a table with a switch on every call (for comparison only).
+// The rows used here must follow the order of CYCLOTRON_LID_GEOMETRY in Configuration.h.
+uint8_t cyclotronLookupTableSwitch(uint8_t index) {
+  switch(i_cyclotron_num_leds) {
+    case QUAD_CYCLOTRON_LED_COUNT:
+      return PROGMEM_READU8(i_cyclotron_ring_matrix[0][index]);
+    break;
 
-      case OUTER_CYCLOTRON_LED_MAX:
-        // 1984 CW 40 LED array.
-        return PROGMEM_READU8(i_1984_cyclotron_40_leds_cw[index]);
-      break;
-    }
+    case HASLAB_CYCLOTRON_LED_COUNT:
+      return PROGMEM_READU8(i_cyclotron_ring_matrix[1][index]);
+    break;
+
+    case FRUTTO_CYCLOTRON_LED_COUNT:
+      return PROGMEM_READU8(i_cyclotron_ring_matrix[2][index]);
+    break;
+
+    case MAX_CYCLOTRON_LED_COUNT:
+    default:
+      return PROGMEM_READU8(i_cyclotron_ring_matrix[3][index]);
+    break;
+
+    case OUTER_CYCLOTRON_LED_MAX:
+      return PROGMEM_READU8(i_cyclotron_ring_matrix[4][index]);
+    break;
   }
-  else {
-    switch(i_cyclotron_num_leds) {
-      case HASLAB_CYCLOTRON_LED_COUNT:
-        // 1984 CCW 12 LED array.
-        return PROGMEM_READU8(i_1984_cyclotron_12_leds_ccw[index]);
-      break;
+}
 
-      case FRUTTO_CYCLOTRON_LED_COUNT:
-        // 1984 CCW 20 LED array.
-        return PROGMEM_READU8(i_1984_cyclotron_20_leds_ccw[index]);
-      break;
+// Times one frame's worth of lookups (the full ring) for every supported LED count.
+void benchmarkCyclotronLookup() {
+  const uint16_t i_frames = 500;
+  volatile uint8_t i_sink = 0;
+  uint8_t i_saved_num_leds = i_cyclotron_num_leds;
 
-      case MAX_CYCLOTRON_LED_COUNT:
-      default:
-        // 1984 CCW 36 LED array.
-        return PROGMEM_READU8(i_1984_cyclotron_36_leds_ccw[index]);
-      break;
+  for(uint8_t g = 0; g < i_cyclotron_geometry_count; g++) {
+    i_cyclotron_num_leds = PROGMEM_READU8(cyclotron_geometry[g].num_leds);
+    selectCyclotronGeometry();
 
-      case OUTER_CYCLOTRON_LED_MAX:
-        // 1984 CCW 40 LED array.
-        return PROGMEM_READU8(i_1984_cyclotron_40_leds_ccw[index]);
-      break;
+    uint32_t i_start = micros();
+    for(uint16_t f = 0; f < i_frames; f++) {
+      for(uint8_t i = 0; i < OUTER_CYCLOTRON_LED_MAX; i++) {
+        i_sink += cyclotronLookupTableSwitch(i);
+      }
     }
+    uint32_t i_switch_time = micros() - i_start;
+
+    i_start = micros();
+    for(uint16_t f = 0; f < i_frames; f++) {
+      for(uint8_t i = 0; i < OUTER_CYCLOTRON_LED_MAX; i++) {
+        i_sink += cyclotronLookupTable(i);
+      }
+    }
+    uint32_t i_table_time = micros() - i_start;
+
+    Serial.print(F("Cyclotron "));
+    Serial.print(i_cyclotron_num_leds);
+    Serial.print(F(" LEDs, ns per frame: switch "));
+    Serial.print(i_switch_time * 1000 / i_frames);
+    Serial.print(F(", table "));
+    Serial.println(i_table_time * 1000 / i_frames);
   }
+
+  i_cyclotron_num_leds = i_saved_num_leds;
+  selectCyclotronGeometry();
 }
+#endif
 
 // Reset the Cyclotron LED colours.
 void cyclotronColourReset() {
@@ -2701,7 +2802,7 @@ void cyclotronColourReset() {
     default:
       for(uint8_t i = 0; i < OUTER_CYCLOTRON_LED_MAX; i++) {
         if(cyclotronLookupTable(i) > 0) {
-          pack_leds[cyclotronLookupTable(i) + i_cyclotron_led_start - 1] = getHueAsRGB(CYCLOTRON_OUTER, i_colour_scheme, i_cyclotron_led_value[i]);
+          cyclotronPixel(cyclotronLookupTable(i) - 1, getHueAsRGB(CYCLOTRON_OUTER, i_colour_scheme, i_cyclotron_led_value[i]));
         }
       }
     break;
@@ -2709,7 +2810,7 @@ void cyclotronColourReset() {
     case SYSTEM_1984:
     case SYSTEM_1989:
       for(uint8_t i = 0; i < i_cyclotron_num_leds; i++) {
-        pack_leds[i + i_cyclotron_led_start] = getHueAsRGB(CYCLOTRON_OUTER, i_colour_scheme, i_cyclotron_led_value[i]);
+        cyclotronPixel(i, getHueAsRGB(CYCLOTRON_OUTER, i_colour_scheme, i_cyclotron_led_value[i]));
       }
     break;
   }
@@ -2721,9 +2822,11 @@ void slimeCyclotronFadeout() {
 
   if(b_cyclotron_lid_on) {
     for(uint8_t i = 0; i < i_cyclotron_num_leds; i++) {
-      pack_leds[i + i_cyclotron_led_start].fadeToBlackBy(1);
+      CRGB c_led = getCyclotronPixel(i);
+      c_led.fadeToBlackBy(1);
+      cyclotronPixel(i, c_led);
 
-      if(!b_leds_fading && pack_leds[i + i_cyclotron_led_start]) {
+      if(!b_leds_fading && c_led) {
         b_leds_fading = true;
       }
     }
@@ -2794,7 +2897,7 @@ void slimeCyclotronEffect() {
 
     if(b_cyclotron_lid_on) {
       for(uint8_t i = 0; i < i_cyclotron_num_leds; i++) {
-        pack_leds[i + i_cyclotron_led_start] = getHueAsRGB(CYCLOTRON_OUTER, i_colour_scheme, random(i_random_lower, i_random_upper));
+        cyclotronPixel(i, getHueAsRGB(CYCLOTRON_OUTER, i_colour_scheme, random(i_random_lower, i_random_upper)));
       }
     }
     else {
@@ -2845,7 +2948,7 @@ void cyclotronIceAnimation() {
 
     if(b_cyclotron_lid_on) {
       for(int8_t i = 0; i < i_cyclotron_num_leds; i++) {
-        pack_leds[i + i_cyclotron_led_start] = getHueAsRGB(CYCLOTRON_OUTER, C_LIGHT_BLUE, random(i_random_lower, i_random_upper));
+        cyclotronPixel(i, getHueAsRGB(CYCLOTRON_OUTER, C_LIGHT_BLUE, random(i_random_lower, i_random_upper)));
       }
     }
     else {
@@ -2902,7 +3005,7 @@ void cyclotronFade() {
           i_cyclotron_led_value[i] = i_curr_brightness;
 
           if(cyclotronLookupTable(i) > 0) {
-            pack_leds[cyclotronLookupTable(i) + i_cyclotron_led_start - 1] = getHueAsRGB(CYCLOTRON_OUTER, i_colour_scheme, i_curr_brightness);
+            cyclotronPixel(cyclotronLookupTable(i) - 1, getHueAsRGB(CYCLOTRON_OUTER, i_colour_scheme, i_curr_brightness));
           }
         }
 
@@ -2928,7 +3031,7 @@ void cyclotronFade() {
           }
 
           if(cyclotronLookupTable(i) > 0) {
-            pack_leds[cyclotronLookupTable(i) + i_cyclotron_led_start - 1] = getHueAsRGB(CYCLOTRON_OUTER, i_colour_scheme, i_new_brightness);
+            cyclotronPixel(cyclotronLookupTable(i) - 1, getHueAsRGB(CYCLOTRON_OUTER, i_colour_scheme, i_new_brightness));
           }
         }
 
@@ -2937,7 +3040,7 @@ void cyclotronFade() {
           i_cyclotron_led_value[i] = i_curr_brightness;
 
           if(cyclotronLookupTable(i) > 0) {
-            pack_leds[cyclotronLookupTable(i) + i_cyclotron_led_start - 1] = getHueAsRGB(CYCLOTRON_OUTER, i_colour_scheme, i_curr_brightness);
+            cyclotronPixel(cyclotronLookupTable(i) - 1, getHueAsRGB(CYCLOTRON_OUTER, i_colour_scheme, i_curr_brightness));
           }
         }
 
@@ -2946,7 +3049,7 @@ void cyclotronFade() {
           b_cyclotron_led_fading_in[i] = true;
 
           if(cyclotronLookupTable(i) > 0) {
-            pack_leds[cyclotronLookupTable(i) + i_cyclotron_led_start - 1] = getHueAsRGB(CYCLOTRON_OUTER, C_BLACK);
+            cyclotronPixel(cyclotronLookupTable(i) - 1, getHueAsRGB(CYCLOTRON_OUTER, C_BLACK));
           }
         }
       }
@@ -2967,25 +3070,25 @@ void cyclotronFade() {
             b_cyclotron_led_fading_in[i] = true;
             uint8_t i_curr_brightness = r_cyclotron_led_fade_in[i].update();
 
-            pack_leds[i + i_cyclotron_led_start] = getHueAsRGB(CYCLOTRON_OUTER, i_colour_scheme, i_curr_brightness, false, !b_overheating);
+            cyclotronPixel(i, getHueAsRGB(CYCLOTRON_OUTER, i_colour_scheme, i_curr_brightness, false, !b_overheating));
             i_cyclotron_led_value[i] = i_curr_brightness;
           }
 
           if(r_cyclotron_led_fade_in[i].isFinished() && i_cyclotron_led_value[i] == (i_new_brightness - 1) && b_cyclotron_led_fading_in[i]) {
-            pack_leds[i + i_cyclotron_led_start] = getHueAsRGB(CYCLOTRON_OUTER, i_colour_scheme, i_new_brightness, false, !b_overheating);
+            cyclotronPixel(i, getHueAsRGB(CYCLOTRON_OUTER, i_colour_scheme, i_new_brightness, false, !b_overheating));
             i_cyclotron_led_value[i] = i_new_brightness;
           }
 
           if(r_cyclotron_led_fade_out[i].isRunning()) {
             uint8_t i_curr_brightness = r_cyclotron_led_fade_out[i].update();
 
-            pack_leds[i + i_cyclotron_led_start] = getHueAsRGB(CYCLOTRON_OUTER, i_colour_scheme, i_curr_brightness, false, !b_overheating);
+            cyclotronPixel(i, getHueAsRGB(CYCLOTRON_OUTER, i_colour_scheme, i_curr_brightness, false, !b_overheating));
             i_cyclotron_led_value[i] = i_curr_brightness;
             b_cyclotron_led_fading_in[i] = false;
           }
 
           if(r_cyclotron_led_fade_out[i].isFinished() && !b_cyclotron_led_fading_in[i]) {
-            pack_leds[i + i_cyclotron_led_start] = getHueAsRGB(CYCLOTRON_OUTER, C_BLACK);
+            cyclotronPixel(i, getHueAsRGB(CYCLOTRON_OUTER, C_BLACK));
             i_cyclotron_led_value[i] = 0;
             b_cyclotron_led_fading_in[i] = true;
           }
@@ -3015,13 +3118,13 @@ void cyclotron84LightOn(uint8_t cLed) {
     i_colour_scheme = C_HASLAB;
   }
 
-  pack_leds[cLed] = getHueAsRGB(CYCLOTRON_OUTER, i_colour_scheme, i_brightness);
+  cyclotronPixel(cLed - i_cyclotron_led_start, getHueAsRGB(CYCLOTRON_OUTER, i_colour_scheme, i_brightness));
   i_cyclotron_led_value[cLed - i_cyclotron_led_start] = i_brightness;
 
   // Turn on the other 2 LEDs if we are allowing 3 to light up.
   if(!b_cyclotron_single_led) {
     for(uint8_t i = 1; i <= i_led_array_width; i++) {
-      pack_leds[cLed + i] = getHueAsRGB(CYCLOTRON_OUTER, i_colour_scheme, i_brightness);
+      cyclotronPixel(cLed + i - i_cyclotron_led_start, getHueAsRGB(CYCLOTRON_OUTER, i_colour_scheme, i_brightness));
       i_cyclotron_led_value[cLed + i - i_cyclotron_led_start] = i_brightness;
 
       uint8_t cLedTemp = cLed; // Create new temporary variable for the negative side.
@@ -3033,7 +3136,7 @@ void cyclotron84LightOn(uint8_t cLed) {
         cLedTemp = cLed - i;
       }
 
-      pack_leds[cLedTemp] = getHueAsRGB(CYCLOTRON_OUTER, i_colour_scheme, i_brightness);
+      cyclotronPixel(cLedTemp - i_cyclotron_led_start, getHueAsRGB(CYCLOTRON_OUTER, i_colour_scheme, i_brightness));
       i_cyclotron_led_value[cLedTemp - i_cyclotron_led_start] = i_brightness;
     }
   }
@@ -3056,12 +3159,12 @@ void cyclotron84LightOff(uint8_t cLed) {
   */
 
   if(!b_fade_cyclotron_led) {
-    pack_leds[cLed] = getHueAsRGB(CYCLOTRON_OUTER, C_BLACK);
+    cyclotronPixel(cLed - i_cyclotron_led_start, getHueAsRGB(CYCLOTRON_OUTER, C_BLACK));
 
     // Turn off the other 2 LEDs if we are allowing 3 to light up.
     if(!b_cyclotron_single_led) {
       for(uint8_t i = 1; i <= i_led_array_width; i++) {
-        pack_leds[cLed + i] = getHueAsRGB(CYCLOTRON_OUTER, C_BLACK);
+        cyclotronPixel(cLed + i - i_cyclotron_led_start, getHueAsRGB(CYCLOTRON_OUTER, C_BLACK));
 
         uint8_t cLedTemp = cLed; // Create new temporary variable for the negative side.
 
@@ -3072,7 +3175,7 @@ void cyclotron84LightOff(uint8_t cLed) {
           cLedTemp = cLed - i;
         }
 
-        pack_leds[cLedTemp] = getHueAsRGB(CYCLOTRON_OUTER, C_BLACK);
+        cyclotronPixel(cLedTemp - i_cyclotron_led_start, getHueAsRGB(CYCLOTRON_OUTER, C_BLACK));
       }
     }
   }
@@ -3569,15 +3672,15 @@ void cyclotron1984Alarm() {
   */
 
   if(!b_fade_cyclotron_led) {
-    pack_leds[led1] = getHueAsRGB(CYCLOTRON_OUTER, i_colour_scheme, i_brightness);
-    pack_leds[led2] = getHueAsRGB(CYCLOTRON_OUTER, i_colour_scheme, i_brightness);
-    pack_leds[led3] = getHueAsRGB(CYCLOTRON_OUTER, i_colour_scheme, i_brightness);
-    pack_leds[led4] = getHueAsRGB(CYCLOTRON_OUTER, i_colour_scheme, i_brightness);
+    cyclotronPixel(led1 - i_cyclotron_led_start, getHueAsRGB(CYCLOTRON_OUTER, i_colour_scheme, i_brightness));
+    cyclotronPixel(led2 - i_cyclotron_led_start, getHueAsRGB(CYCLOTRON_OUTER, i_colour_scheme, i_brightness));
+    cyclotronPixel(led3 - i_cyclotron_led_start, getHueAsRGB(CYCLOTRON_OUTER, i_colour_scheme, i_brightness));
+    cyclotronPixel(led4 - i_cyclotron_led_start, getHueAsRGB(CYCLOTRON_OUTER, i_colour_scheme, i_brightness));
 
     // Turn on all the other cyclotron LEDs if required.
     if(!b_cyclotron_single_led) {
       for(uint8_t i = 1; i <= i_led_array_width; i++) {
-        pack_leds[led1 + i] = getHueAsRGB(CYCLOTRON_OUTER, i_colour_scheme, i_brightness);
+        cyclotronPixel(led1 + i - i_cyclotron_led_start, getHueAsRGB(CYCLOTRON_OUTER, i_colour_scheme, i_brightness));
 
         if(led1 - i < i_cyclotron_led_start) {
           led1 = i_pack_num_leds - i_nfilter_jewel_leds - 1;
@@ -3586,8 +3689,8 @@ void cyclotron1984Alarm() {
           led1 = led1 - i;
         }
 
-        pack_leds[led1] = getHueAsRGB(CYCLOTRON_OUTER, i_colour_scheme, i_brightness);
-        pack_leds[led2 + i] = getHueAsRGB(CYCLOTRON_OUTER, i_colour_scheme, i_brightness);
+        cyclotronPixel(led1 - i_cyclotron_led_start, getHueAsRGB(CYCLOTRON_OUTER, i_colour_scheme, i_brightness));
+        cyclotronPixel(led2 + i - i_cyclotron_led_start, getHueAsRGB(CYCLOTRON_OUTER, i_colour_scheme, i_brightness));
 
         if(led2 - i < i_cyclotron_led_start) {
           led2 = i_pack_num_leds - i_nfilter_jewel_leds - 1;
@@ -3596,8 +3699,8 @@ void cyclotron1984Alarm() {
           led2 = led2 - i;
         }
 
-        pack_leds[led2] = getHueAsRGB(CYCLOTRON_OUTER, i_colour_scheme, i_brightness);
-        pack_leds[led3 + i] = getHueAsRGB(CYCLOTRON_OUTER, i_colour_scheme, i_brightness);
+        cyclotronPixel(led2 - i_cyclotron_led_start, getHueAsRGB(CYCLOTRON_OUTER, i_colour_scheme, i_brightness));
+        cyclotronPixel(led3 + i - i_cyclotron_led_start, getHueAsRGB(CYCLOTRON_OUTER, i_colour_scheme, i_brightness));
 
         if(led3 - i < i_cyclotron_led_start) {
           led3 = i_pack_num_leds - i_nfilter_jewel_leds - 1;
@@ -3606,8 +3709,8 @@ void cyclotron1984Alarm() {
           led3 = led3 - i;
         }
 
-        pack_leds[led3] = getHueAsRGB(CYCLOTRON_OUTER, i_colour_scheme, i_brightness);
-        pack_leds[led4 + i] = getHueAsRGB(CYCLOTRON_OUTER, i_colour_scheme, i_brightness);
+        cyclotronPixel(led3 - i_cyclotron_led_start, getHueAsRGB(CYCLOTRON_OUTER, i_colour_scheme, i_brightness));
+        cyclotronPixel(led4 + i - i_cyclotron_led_start, getHueAsRGB(CYCLOTRON_OUTER, i_colour_scheme, i_brightness));
 
         if(led4 - i < i_cyclotron_led_start) {
           led4 = i_pack_num_leds - i_nfilter_jewel_leds - 1;
@@ -3616,7 +3719,7 @@ void cyclotron1984Alarm() {
           led4 = led4 - i;
         }
 
-        pack_leds[led4] = getHueAsRGB(CYCLOTRON_OUTER, i_colour_scheme, i_brightness);
+        cyclotronPixel(led4 - i_cyclotron_led_start, getHueAsRGB(CYCLOTRON_OUTER, i_colour_scheme, i_brightness));
       }
     }
   }
@@ -3771,6 +3874,8 @@ void packOverheatingFinished() {
 }
 
 void packOverheatingStart() {
+  FLIGHT_EVENT(EVENT_OVERHEAT_START, gpstarPack.getPowerLevel());
+
   if(gpstarPack.inStreamMode(SLIME)) {
     playEffect(S_SLIME_EMPTY);
   }
@@ -3968,6 +4073,8 @@ void cyclotronOverheating() {
 }
 
 void cyclotronControl() {
+  PROFILE_SCOPE(PROFILE_CYCLOTRON);
+
   // Only reset the starting LED when the pack is first started up.
   if(b_reset_start_led) {
     b_reset_start_led = false;
@@ -4374,6 +4481,8 @@ void packVenting() {
 }
 
 void packVentingStart() {
+  FLIGHT_EVENT(EVENT_VENT_START, gpstarPack.getPowerLevel());
+
   stopEffect(S_SLIME_EMPTY);
   stopEffect(S_PACK_SLIME_TANK_LOOP);
   stopEffect(S_QUICK_VENT_CLOSE);
@@ -5002,57 +5111,143 @@ void cyclotronSpeedIncrease() {
   sanitizeCyclotronMultipliers();
 }
 
-int8_t readRotary() {
-  static int8_t rot_enc_table[] = {0,1,1,0,1,0,0,1,1,0,0,1,0,1,1,0};
+#ifndef ESP32
+// Called on every change of either encoder pin, so no steps are missed while the main loop is busy.
+void volumeEncoderISR() {
+  volume_encoder.update(digitalReadFast(ROTARY_ENCODER_A), digitalReadFast(ROTARY_ENCODER_B));
+}
+#endif
 
-  prev_next_code <<= 2;
+void setupRotaryEncoder() {
+  pinModeFast(ROTARY_ENCODER_A, INPUT_PULLUP);
+  pinModeFast(ROTARY_ENCODER_B, INPUT_PULLUP);
 
-  if(digitalReadFast(ROTARY_ENCODER_B)) {
-    prev_next_code |= 0x02;
-  }
+  volume_encoder.begin(digitalReadFast(ROTARY_ENCODER_A), digitalReadFast(ROTARY_ENCODER_B));
 
-  if(digitalReadFast(ROTARY_ENCODER_A)) {
-    prev_next_code |= 0x01;
-  }
+#ifdef ESP32
+  // Count every edge of both pins with the PCNT peripheral, in the same direction as the decoder.
+  // Accumulating the count with watch points at the limits keeps it from wrapping back to zero.
+  pcnt_unit_config_t unit_config = {};
+  unit_config.low_limit = -1000;
+  unit_config.high_limit = 1000;
+  unit_config.flags.accum_count = 1;
 
-  prev_next_code &= 0x0f;
+  pcnt_glitch_filter_config_t filter_config = {};
+  filter_config.max_glitch_ns = 1000; // Ignore contact bounce shorter than 1us.
 
-  // If valid then store as 16 bit data.
-  if(rot_enc_table[prev_next_code]) {
-    store <<= 4;
-    store |= prev_next_code;
+  pcnt_chan_config_t chan_a_config = {};
+  chan_a_config.edge_gpio_num = ROTARY_ENCODER_A;
+  chan_a_config.level_gpio_num = ROTARY_ENCODER_B;
 
-    if((store&0xff) == 0x2b) {
-      return -1;
+  pcnt_chan_config_t chan_b_config = {};
+  chan_b_config.edge_gpio_num = ROTARY_ENCODER_B;
+  chan_b_config.level_gpio_num = ROTARY_ENCODER_A;
+
+  pcnt_channel_handle_t chan_a = NULL;
+  pcnt_channel_handle_t chan_b = NULL;
+
+  bool b_pcnt_ready = pcnt_new_unit(&unit_config, &volume_encoder_unit) == ESP_OK &&
+    pcnt_unit_set_glitch_filter(volume_encoder_unit, &filter_config) == ESP_OK &&
+    pcnt_new_channel(volume_encoder_unit, &chan_a_config, &chan_a) == ESP_OK &&
+    pcnt_new_channel(volume_encoder_unit, &chan_b_config, &chan_b) == ESP_OK &&
+    pcnt_channel_set_edge_action(chan_a, PCNT_CHANNEL_EDGE_ACTION_INCREASE, PCNT_CHANNEL_EDGE_ACTION_DECREASE) == ESP_OK &&
+    pcnt_channel_set_level_action(chan_a, PCNT_CHANNEL_LEVEL_ACTION_KEEP, PCNT_CHANNEL_LEVEL_ACTION_INVERSE) == ESP_OK &&
+    pcnt_channel_set_edge_action(chan_b, PCNT_CHANNEL_EDGE_ACTION_DECREASE, PCNT_CHANNEL_EDGE_ACTION_INCREASE) == ESP_OK &&
+    pcnt_channel_set_level_action(chan_b, PCNT_CHANNEL_LEVEL_ACTION_KEEP, PCNT_CHANNEL_LEVEL_ACTION_INVERSE) == ESP_OK &&
+    pcnt_unit_add_watch_point(volume_encoder_unit, unit_config.low_limit) == ESP_OK &&
+    pcnt_unit_add_watch_point(volume_encoder_unit, unit_config.high_limit) == ESP_OK &&
+    pcnt_unit_enable(volume_encoder_unit) == ESP_OK &&
+    pcnt_unit_clear_count(volume_encoder_unit) == ESP_OK &&
+    pcnt_unit_start(volume_encoder_unit) == ESP_OK;
+
+  if(!b_pcnt_ready) {
+    // Release whatever was allocated and fall back to sampling the pins from the main loop.
+    if(chan_a != NULL) {
+      pcnt_del_channel(chan_a);
     }
 
-    if((store&0xff) == 0x17) {
-      return 1;
+    if(chan_b != NULL) {
+      pcnt_del_channel(chan_b);
     }
+
+    if(volume_encoder_unit != NULL) {
+      pcnt_unit_disable(volume_encoder_unit);
+      pcnt_del_unit(volume_encoder_unit);
+      volume_encoder_unit = NULL;
+    }
+
+    debugln(F("Rotary encoder: PCNT unavailable, sampling pins instead"));
   }
 
-  return 0;
+  i_volume_encoder_count = 0;
+#else
+  // Pins 2 and 3 are external interrupts (INT4/INT5) on the ATMega2560.
+  attachInterrupt(digitalPinToInterrupt(ROTARY_ENCODER_A), volumeEncoderISR, CHANGE);
+  attachInterrupt(digitalPinToInterrupt(ROTARY_ENCODER_B), volumeEncoderISR, CHANGE);
+#endif
 }
 
-void checkRotaryEncoder() {
-  if(readRotary() != 0) {
-    // Only continue if the limiter has expired.
-    if(ms_rotary_encoder.remaining() > 0) {
-      return;
-    }
-    else {
-      ms_rotary_encoder.start(i_rotary_encoder_delay);
-    }
+#ifdef ESP32
+// Collects any new counts from the pulse counter, or samples the pins if it is unavailable.
+void updateRotaryEncoder() {
+  if(volume_encoder_unit != NULL) {
+    int i_count = 0;
 
-    // Clockwise
-    if(prev_next_code == 0x0b) {
-      increaseVolume();
+    if(pcnt_unit_get_count(volume_encoder_unit, &i_count) == ESP_OK) {
+      volume_encoder.addCounts(i_count - i_volume_encoder_count);
+      i_volume_encoder_count = i_count;
     }
+  }
+  else {
+    volume_encoder.update(digitalReadFast(ROTARY_ENCODER_A), digitalReadFast(ROTARY_ENCODER_B));
+  }
+}
+#endif
 
-    // Counter Clockwise
-    if(prev_next_code == 0x07) {
-      decreaseVolume();
-    }
+// Returns the detents turned since the last call, where positive is clockwise.
+int16_t readRotary() {
+#ifdef ESP32
+  return volume_encoder.takeDetents();
+#else
+  // The encoder interrupt also writes to the decoder, so take the detents atomically.
+  noInterrupts();
+  int16_t i_detents = volume_encoder.takeDetents();
+  interrupts();
+
+  return i_detents;
+#endif
+}
+
+void checkRotaryEncoder() {
+  PROFILE_SCOPE(PROFILE_ROTARY);
+
+#ifdef ESP32
+  updateRotaryEncoder();
+#endif
+
+  // Only continue if the limiter has expired. Any detents turned meanwhile are kept for the next pass.
+  if(ms_rotary_encoder.remaining() > 0) {
+    return;
+  }
+
+  int16_t i_detents = readRotary();
+
+  if(i_detents == 0) {
+    return;
+  }
+
+  ms_rotary_encoder.start(i_rotary_encoder_delay);
+
+  // Clockwise
+  while(i_detents > 0) {
+    increaseVolume();
+    i_detents--;
+  }
+
+  // Counter Clockwise
+  while(i_detents < 0) {
+    decreaseVolume();
+    i_detents++;
   }
 }
 
@@ -5118,7 +5313,7 @@ void restartFromWandMash() {
             innerCyclotronCakeOff();
             ms_cyclotron_slime_effect.stop();
           }
-          ms_powercell.start(0);
+          b_powercell_step_now = true;
           ms_cyclotron.start(0);
           ms_cyclotron_ring.start(0);
 
@@ -5302,8 +5497,18 @@ void updateProtonPackLEDCounts() {
   // and optionally an N-filter LED jewel array at the end of that chain
   i_pack_num_leds = i_powercell_num_leds + i_cyclotron_num_leds + i_nfilter_jewel_leds;
   i_cyclotron_led_start = i_powercell_num_leds;
+  selectCyclotronGeometry();
   i_vent_light_start = i_powercell_num_leds + i_cyclotron_num_leds;
 
+  // When the Power Cell or Cyclotron Lid size changes, drop anything drawn for the previous LED counts.
+  if(cyclotron_layer.getOffset() != i_cyclotron_led_start || vent_light_layer.getOffset() != i_vent_light_start) {
+    powercell_layer.clear();
+    cyclotron_layer.clear();
+  }
+
+  cyclotron_layer.setOffset(i_cyclotron_led_start);
+  vent_light_layer.setOffset(i_vent_light_start);
+
   // Calculate the inner cyclotron which may consist of the optional components:
   // [in order...] Switch Panel + Cake Lights + Cavity Lights
   if(INNER_CYC_PANEL_MODE != PANEL_DISABLED) {
@@ -5336,28 +5541,8 @@ void resetInnerCyclotronLEDs() {
 }
 
 void resetCyclotronLEDs() {
-  switch(i_cyclotron_num_leds) {
-    // For a 40 LED Neopixel ring.
-    case OUTER_CYCLOTRON_LED_MAX:
-      i_2021_delay = CYCLOTRON_DELAY_2021_40_LED;
-    break;
-
-    // For Frutto Technology Max Cyclotron (36) LEDs.
-    case MAX_CYCLOTRON_LED_COUNT:
-    default:
-      i_2021_delay = CYCLOTRON_DELAY_2021_36_LED;
-    break;
-
-    // For Frutto Technology Cyclotron (20) LEDs.
-    case FRUTTO_CYCLOTRON_LED_COUNT:
-      i_2021_delay = CYCLOTRON_DELAY_2021_20_LED;
-    break;
-
-    // Default HasLab (12) LEDs.
-    case HASLAB_CYCLOTRON_LED_COUNT:
-      i_2021_delay = CYCLOTRON_DELAY_2021_12_LED;
-    break;
-  }
+  selectCyclotronGeometry();
+  i_2021_delay = PROGMEM_READU8(cyclotron_geometry[i_cyclotron_geometry].delay_2021);
 }
 
 void updateContinuousSmoke() {
@@ -5461,11 +5646,11 @@ uint8_t getRampPercentage(ramp &input) {
 }
 
 void systemPOST() {
-  uint8_t i_tmp_led1 = i_cyclotron_led_start + cyclotron84LookupTable(0);
-  uint8_t i_tmp_led2 = i_cyclotron_led_start + cyclotron84LookupTable(1);
-  uint8_t i_tmp_led3 = i_cyclotron_led_start + cyclotron84LookupTable(2);
-  uint8_t i_tmp_led4 = i_cyclotron_led_start + cyclotron84LookupTable(3);
-  uint8_t i_tmp_led5 = i_pack_num_leds - 1;
+  // Cyclotron Lid positions, counted from the first lid LED.
+  uint8_t i_tmp_led1 = cyclotron84LookupTable(0);
+  uint8_t i_tmp_led2 = cyclotron84LookupTable(1);
+  uint8_t i_tmp_led3 = cyclotron84LookupTable(2);
+  uint8_t i_tmp_led4 = cyclotron84LookupTable(3);
 
   uint8_t i_tmp_powercell_led = i_post_powercell_up;
 
@@ -5490,14 +5675,14 @@ void systemPOST() {
       }
     }
 
-    pack_leds[i_tmp_powercell_led] = getHueAsRGB(POWERCELL, C_MID_BLUE);
+    powercellPixel(i_tmp_powercell_led, getHueAsRGB(POWERCELL, C_MID_BLUE));
 
     if((i_post_powercell_up % 5) == 0) {
-      pack_leds[i_tmp_led1] = getHueAsRGB(CYCLOTRON_OUTER, c_outer_cyclotron_colour);
-      pack_leds[i_tmp_led2] = getHueAsRGB(CYCLOTRON_OUTER, c_outer_cyclotron_colour);
-      pack_leds[i_tmp_led3] = getHueAsRGB(CYCLOTRON_OUTER, c_outer_cyclotron_colour);
-      pack_leds[i_tmp_led4] = getHueAsRGB(CYCLOTRON_OUTER, c_outer_cyclotron_colour);
-      pack_leds[i_tmp_led5] = getHueAsRGB(CYCLOTRON_OUTER, C_WHITE);
+      cyclotronPixel(i_tmp_led1, getHueAsRGB(CYCLOTRON_OUTER, c_outer_cyclotron_colour));
+      cyclotronPixel(i_tmp_led2, getHueAsRGB(CYCLOTRON_OUTER, c_outer_cyclotron_colour));
+      cyclotronPixel(i_tmp_led3, getHueAsRGB(CYCLOTRON_OUTER, c_outer_cyclotron_colour));
+      cyclotronPixel(i_tmp_led4, getHueAsRGB(CYCLOTRON_OUTER, c_outer_cyclotron_colour));
+      ventLightPixel(i_nfilter_jewel_leds - 1, getHueAsRGB(CYCLOTRON_OUTER, C_WHITE));
 
       if(INNER_CYC_PANEL_MODE != PANEL_DISABLED) {
         cyclotron_leds[0] = getHueAsRGB(CYCLOTRON_PANEL, C_RED);
@@ -5523,11 +5708,11 @@ void systemPOST() {
 #endif
     }
     else {
-      pack_leds[i_tmp_led1] = getHueAsRGB(CYCLOTRON_OUTER, C_BLACK);
-      pack_leds[i_tmp_led2] = getHueAsRGB(CYCLOTRON_OUTER, C_BLACK);
-      pack_leds[i_tmp_led3] = getHueAsRGB(CYCLOTRON_OUTER, C_BLACK);
-      pack_leds[i_tmp_led4] = getHueAsRGB(CYCLOTRON_OUTER, C_BLACK);
-      pack_leds[i_tmp_led5] = getHueAsRGB(CYCLOTRON_OUTER, C_BLACK);
+      cyclotronPixel(i_tmp_led1, getHueAsRGB(CYCLOTRON_OUTER, C_BLACK));
+      cyclotronPixel(i_tmp_led2, getHueAsRGB(CYCLOTRON_OUTER, C_BLACK));
+      cyclotronPixel(i_tmp_led3, getHueAsRGB(CYCLOTRON_OUTER, C_BLACK));
+      cyclotronPixel(i_tmp_led4, getHueAsRGB(CYCLOTRON_OUTER, C_BLACK));
+      ventLightPixel(i_nfilter_jewel_leds - 1, getHueAsRGB(CYCLOTRON_OUTER, C_BLACK));
 
       if(INNER_CYC_PANEL_MODE != PANEL_DISABLED) {
         cyclotron_leds[0] = getHueAsRGB(CYCLOTRON_PANEL, C_BLACK);
@@ -5583,15 +5768,15 @@ void systemPOST() {
       }
     }
 
-    pack_leds[(i_powercell_num_leds - 1) - i_tmp_powercell_led] = getHueAsRGB(POWERCELL, C_BLACK); // Ramp up and ramp down.
-    //pack_leds[i_post_powercell_down] = getHueAsRGB(POWERCELL, C_BLACK); // Ramp up and ramp away.
+    powercellPixel((i_powercell_num_leds - 1) - i_tmp_powercell_led, getHueAsRGB(POWERCELL, C_BLACK)); // Ramp up and ramp down.
+    //powercellPixel(i_post_powercell_down, getHueAsRGB(POWERCELL, C_BLACK)); // Ramp up and ramp away.
 
     if((i_post_powercell_down % 5) == 0) {
-      pack_leds[i_tmp_led1] = getHueAsRGB(CYCLOTRON_OUTER, c_outer_cyclotron_colour);
-      pack_leds[i_tmp_led2] = getHueAsRGB(CYCLOTRON_OUTER, c_outer_cyclotron_colour);
-      pack_leds[i_tmp_led3] = getHueAsRGB(CYCLOTRON_OUTER, c_outer_cyclotron_colour);
-      pack_leds[i_tmp_led4] = getHueAsRGB(CYCLOTRON_OUTER, c_outer_cyclotron_colour);
-      pack_leds[i_tmp_led5] = getHueAsRGB(CYCLOTRON_OUTER, C_WHITE);
+      cyclotronPixel(i_tmp_led1, getHueAsRGB(CYCLOTRON_OUTER, c_outer_cyclotron_colour));
+      cyclotronPixel(i_tmp_led2, getHueAsRGB(CYCLOTRON_OUTER, c_outer_cyclotron_colour));
+      cyclotronPixel(i_tmp_led3, getHueAsRGB(CYCLOTRON_OUTER, c_outer_cyclotron_colour));
+      cyclotronPixel(i_tmp_led4, getHueAsRGB(CYCLOTRON_OUTER, c_outer_cyclotron_colour));
+      ventLightPixel(i_nfilter_jewel_leds - 1, getHueAsRGB(CYCLOTRON_OUTER, C_WHITE));
 
       if(INNER_CYC_PANEL_MODE != PANEL_DISABLED) {
         cyclotron_leds[0] = getHueAsRGB(CYCLOTRON_PANEL, C_RED);
@@ -5617,11 +5802,11 @@ void systemPOST() {
 #endif
     }
     else {
-      pack_leds[i_tmp_led1] = getHueAsRGB(CYCLOTRON_OUTER, C_BLACK);
-      pack_leds[i_tmp_led2] = getHueAsRGB(CYCLOTRON_OUTER, C_BLACK);
-      pack_leds[i_tmp_led3] = getHueAsRGB(CYCLOTRON_OUTER, C_BLACK);
-      pack_leds[i_tmp_led4] = getHueAsRGB(CYCLOTRON_OUTER, C_BLACK);
-      pack_leds[i_tmp_led5] = getHueAsRGB(CYCLOTRON_OUTER, C_BLACK);
+      cyclotronPixel(i_tmp_led1, getHueAsRGB(CYCLOTRON_OUTER, C_BLACK));
+      cyclotronPixel(i_tmp_led2, getHueAsRGB(CYCLOTRON_OUTER, C_BLACK));
+      cyclotronPixel(i_tmp_led3, getHueAsRGB(CYCLOTRON_OUTER, C_BLACK));
+      cyclotronPixel(i_tmp_led4, getHueAsRGB(CYCLOTRON_OUTER, C_BLACK));
+      ventLightPixel(i_nfilter_jewel_leds - 1, getHueAsRGB(CYCLOTRON_OUTER, C_BLACK));
 
       if(INNER_CYC_PANEL_MODE != PANEL_DISABLED) {
         cyclotron_leds[0] = getHueAsRGB(CYCLOTRON_PANEL, C_BLACK);
@@ -5659,11 +5844,11 @@ void systemPOST() {
   }
 
   if(i_post_fade > 0 && ms_delay_post_3.justFinished()) {
-    pack_leds[i_tmp_led1] = getHueAsRGB(CYCLOTRON_OUTER, c_outer_cyclotron_colour, i_post_fade);
-    pack_leds[i_tmp_led2] = getHueAsRGB(CYCLOTRON_OUTER, c_outer_cyclotron_colour, i_post_fade);
-    pack_leds[i_tmp_led3] = getHueAsRGB(CYCLOTRON_OUTER, c_outer_cyclotron_colour, i_post_fade);
-    pack_leds[i_tmp_led4] = getHueAsRGB(CYCLOTRON_OUTER, c_outer_cyclotron_colour, i_post_fade);
-    pack_leds[i_tmp_led5] = getHueAsRGB(CYCLOTRON_OUTER, C_WHITE, i_post_fade);
+    cyclotronPixel(i_tmp_led1, getHueAsRGB(CYCLOTRON_OUTER, c_outer_cyclotron_colour, i_post_fade));
+    cyclotronPixel(i_tmp_led2, getHueAsRGB(CYCLOTRON_OUTER, c_outer_cyclotron_colour, i_post_fade));
+    cyclotronPixel(i_tmp_led3, getHueAsRGB(CYCLOTRON_OUTER, c_outer_cyclotron_colour, i_post_fade));
+    cyclotronPixel(i_tmp_led4, getHueAsRGB(CYCLOTRON_OUTER, c_outer_cyclotron_colour, i_post_fade));
+    ventLightPixel(i_nfilter_jewel_leds - 1, getHueAsRGB(CYCLOTRON_OUTER, C_WHITE, i_post_fade));
 
     if(INNER_CYC_PANEL_MODE != PANEL_DISABLED) {
       cyclotron_leds[0] = getHueAsRGB(CYCLOTRON_PANEL, C_RED, i_post_fade);
@@ -5726,11 +5911,11 @@ void systemPOST() {
     if(i_post_fade == 0) {
       ms_delay_post_3.stop();
 
-      pack_leds[i_tmp_led1] = getHueAsRGB(CYCLOTRON_OUTER, C_BLACK);
-      pack_leds[i_tmp_led2] = getHueAsRGB(CYCLOTRON_OUTER, C_BLACK);
-      pack_leds[i_tmp_led3] = getHueAsRGB(CYCLOTRON_OUTER, C_BLACK);
-      pack_leds[i_tmp_led4] = getHueAsRGB(CYCLOTRON_OUTER, C_BLACK);
-      pack_leds[i_tmp_led5] = getHueAsRGB(CYCLOTRON_OUTER, C_BLACK);
+      cyclotronPixel(i_tmp_led1, getHueAsRGB(CYCLOTRON_OUTER, C_BLACK));
+      cyclotronPixel(i_tmp_led2, getHueAsRGB(CYCLOTRON_OUTER, C_BLACK));
+      cyclotronPixel(i_tmp_led3, getHueAsRGB(CYCLOTRON_OUTER, C_BLACK));
+      cyclotronPixel(i_tmp_led4, getHueAsRGB(CYCLOTRON_OUTER, C_BLACK));
+      ventLightPixel(i_nfilter_jewel_leds - 1, getHueAsRGB(CYCLOTRON_OUTER, C_BLACK));
 
       cyclotronSwitchLEDOff();
       innerCyclotronCakeOff();
@@ -5838,21 +6023,94 @@ bool changeStreamMode(STREAM_MODES new_mode) {
   return true;
 }
 
+// Clock for the i2c scheduler, which times each device's use of the bus in microseconds.
+uint32_t i2cMicros() {
+  return micros();
+}
+
+// Starts the i2c buses and probes for the optional temperature sensor and power meter.
+void setupI2CDevices() {
+#ifdef ESP32
+  // ESP32-S3 requires manually specifying SDA and SCL pins first.
+  Wire.begin(I2C_SDA, I2C_SCL, 400000UL);
+  Wire1.begin(TEMP_SDA, TEMP_SCL, 400000UL);
+
+  // Initialize the HDC1080 temp/humidity sensor.
+  Wire1.beginTransmission(0x40);
+  if(Wire1.endTransmission() == 0) {
+    b_temp_sensor_detected = true;
+    tempSensor.resetConfiguration();
+    tempSensor.disableHeater();
+    tempSensor.setHumidityResolution(GuL::HDC1080::HumidityMeasurementResolution::HUM_RES_14BIT);
+    tempSensor.setTemperaturResolution(GuL::HDC1080::TemperatureMeasurementResolution::TEMP_RES_14BIT);
+    tempSensor.setAcquisitionMode(GuL::HDC1080::AcquisitionModes::SINGLE_CHANNEL);
+  }
+#else
+  Wire.begin();
+  Wire.setClock(400000UL); // Sets the i2c bus to 400kHz
+#endif
+
+  // Initialize an optional power meter on the i2c bus.
+  if(b_use_power_meter) {
+    sendDebug(F("Init power meter..."));
+    powerMeterInit();
+  }
+}
+
+// Registers the i2c devices found during setup and starts running their queued transactions.
+// Nothing may use the i2c buses directly after this, as the ESP32 runs transactions from another core.
+void setupI2CScheduler() {
+  if(b_power_meter_available) {
+    i_i2c_power_meter = i2c_scheduler.addDevice(&i2c_bus, 0x40, "Power Meter");
+  }
+
 #ifdef ESP32
+  if(b_temp_sensor_detected) {
+    i_i2c_temp_sensor = i2c_scheduler.addDevice(&i2c_temp_bus, 0x40, "Temperature");
+  }
+
+  // Run transactions on the core opposite to the main loop.
+  i2c_scheduler.startTask(xPortGetCoreID() == 0 ? 1 : 0, 1);
+#endif
+}
+
+// Completes finished i2c transactions, which on the ATMega are also run here within a time budget.
+void checkI2CScheduler() {
+#ifndef ESP32
+  i2c_scheduler.service(i_i2c_service_budget);
+#endif
+  i2c_scheduler.dispatch();
+}
+
+#ifdef ESP32
+// Converts a completed HDC1080 temperature read, called from i2c_scheduler.dispatch().
+void temperatureReadDone(const I2CTransaction& transaction) {
+  if(transaction.status != I2C_STATUS_OK) {
+    return;
+  }
+
+  // The 16-bit result spans -40C to 125C.
+  uint16_t i_raw = ((uint16_t)transaction.data[0] << 8) | transaction.data[1];
+
+  f_temperature_c = (i_raw * 165.0 / 65536.0) - 40.0; // Value in Celsius
+  f_temperature_f = (f_temperature_c * 1.8) + 32; // Convert Celsius to Fahrenheit
+  debugf("\t\tTemp: %.1f C (%.1f F)\n", f_temperature_c, f_temperature_f);
+
+  // Send value to the Attenuator, multiplied by 100 to avoid float issues.
+  attenuatorSerialSend(A_TEMPERATURE_PACK, f_temperature_c * 100);
+}
+
 void readTemperature() {
   // Read the HDC1080 and store the current temperature readings in C and F.
+  // Both the trigger and the read are queued on the i2c bus, with the result handled by temperatureReadDone().
   if(b_temp_sensor_detected) {
     if(!ms_temp_read.isRunning()) {
-      tempSensor.startAcquisition(GuL::HDC1080::Channel::TEMPERATURE);
+      const uint8_t i_temperature_register = 0x00; // Pointing at the temperature register starts a conversion.
+      i2c_scheduler.write(i_i2c_temp_sensor, &i_temperature_register, 1);
       ms_temp_read.start(i_temp_read_delay); // Read every N seconds.
     }
     else if(ms_temp_read.justFinished()) {
-      f_temperature_c = tempSensor.getTemperature(); // Read value in Celsius
-      f_temperature_f = (f_temperature_c * 1.8) + 32; // Convert Celsius to Fahrenheit
-      debugf("\t\tTemp: %.1f C (%.1f F)\n", f_temperature_c, f_temperature_f);
-
-      // Send value to the Attenuator, multiplied by 100 to avoid float issues.
-      attenuatorSerialSend(A_TEMPERATURE_PACK, f_temperature_c * 100);
+      i2c_scheduler.read(i_i2c_temp_sensor, 2, temperatureReadDone);
     }
   }
 }
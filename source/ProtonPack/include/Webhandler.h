@@ -587,6 +587,8 @@ void startWebServer() {
 
 // Perform management if the AP and web server are started.
 void webLoops() {
+  PROFILE_SCOPE(PROFILE_WEB);
+
   if(b_local_ap_started && b_httpd_started) {
     if(ms_cleanup.remaining() < 1) {
       // Clean up oldest WebSocket connections.
@@ -639,6 +641,12 @@ void shutdownWireless() {
 // Restarts WiFi and web server when needed.
 void restartWireless() {
   if(!b_local_ap_started) {
+    bool b_first_start = boot_stages[BOOT_WIRELESS].i_end == 0;
+
+    if(b_first_start) {
+      bootStageBegin(BOOT_WIRELESS);
+    }
+
     if(startWiFi()) {
       // Start the local web server.
       startWebServer();
@@ -652,6 +660,12 @@ void restartWireless() {
         debugln(F("Wireless and web server restarted."));
       #endif
     }
+
+    if(b_first_start) {
+      // WiFi starts after the pack is ready, so this stage is reported on its own.
+      bootStageEnd(BOOT_WIRELESS);
+      reportBootStage(BOOT_WIRELESS);
+    }
   }
 }
 
@@ -921,6 +935,181 @@ void handleRestart(AsyncWebServerRequest *request) {
   ESP.restart();
 }
 
+void handleGetBoot(AsyncWebServerRequest *request) {
+  // Return when each boot stage started and how long it took, in microseconds since reset.
+  String bootData;
+  JsonDocument jsonBody;
+
+  jsonBody["setupStart"] = i_boot_setup_start;
+  jsonBody["ready"] = i_boot_ready;
+  jsonBody["wandHeard"] = i_boot_wand_heard;
+  jsonBody["readyTarget"] = (uint32_t)i_boot_ready_target * 1000;
+
+  JsonObject stages = jsonBody["stages"].to<JsonObject>();
+  for(uint8_t i = 0; i < BOOT_STAGE_COUNT; i++) {
+    JsonObject stage = stages[String(getBootStageName(i))].to<JsonObject>();
+    stage["start"] = boot_stages[i].i_start;
+    stage["duration"] = boot_stages[i].i_end - boot_stages[i].i_start;
+  }
+
+  serializeJson(jsonBody, bootData);
+  AsyncWebServerResponse *response = request->beginResponse(HTTP_STATUS_200, MIME_JSON, bootData);
+  response->addHeader(HEADER_CACHE_CONTROL, CACHE_NO_CACHE);
+  request->send(response);
+}
+
+#if defined(CPU_GOVERNOR)
+void handleGetCpu(AsyncWebServerRequest *request) {
+  // Return the current CPU frequency and load, and the time in milliseconds spent at each frequency.
+  String cpuData;
+  JsonDocument jsonBody;
+  uint32_t i_now = millis();
+
+  jsonBody["cpuMHz"] = getCpuFrequencyMhz();
+  jsonBody["load"] = cpu_governor.getLoad() / 10.0;
+  jsonBody["loadCore0"] = cpu_load.getCoreLoad(0) / 10.0;
+  jsonBody["loadCore1"] = cpu_load.getCoreLoad(1) / 10.0;
+  jsonBody["changes"] = cpu_governor.getSwitchCount();
+
+  JsonObject residency = jsonBody["residency"].to<JsonObject>();
+  for(uint8_t i = 0; i < cpu_governor.getLevelCount(); i++) {
+    residency[String(cpu_governor.getLevelFrequency(i))] = cpu_governor.getResidency(i, i_now);
+  }
+
+  serializeJson(jsonBody, cpuData);
+  AsyncWebServerResponse *response = request->beginResponse(HTTP_STATUS_200, MIME_JSON, cpuData);
+  response->addHeader(HEADER_CACHE_CONTROL, CACHE_NO_CACHE);
+  request->send(response);
+}
+#endif
+
+#if defined(LOOP_PROFILER)
+void handleGetPerf(AsyncWebServerRequest *request) {
+  // Return the timing of each profiled section of the main loop, in microseconds.
+  String perfData;
+  JsonDocument jsonBody;
+  uint32_t i_ticks_per_micro = profileTicksPerMicro();
+
+  jsonBody["cpuMHz"] = getCpuFrequencyMhz();
+
+  // Values are read while the main loop may still be recording, so one section may be a sample behind.
+  JsonObject sections = jsonBody["sections"].to<JsonObject>();
+  for(uint8_t i = 0; i < PROFILE_SECTION_COUNT; i++) {
+    SectionSummary summary = profile_stats[i].summarise(i_ticks_per_micro);
+    JsonObject section = sections[String(getProfileSectionName(i))].to<JsonObject>();
+    section["count"] = summary.count;
+    section["min"] = summary.min;
+    section["avg"] = summary.avg;
+    section["max"] = summary.max;
+    section["p99"] = summary.p99;
+  }
+
+  // Bus time used by each i2c device, in microseconds.
+  JsonObject devices = jsonBody["i2c"].to<JsonObject>();
+  for(uint8_t i = 1; i <= i2c_scheduler.getDeviceCount(); i++) {
+    I2CDeviceStats stats;
+    i2c_scheduler.getDeviceStats(i, stats);
+    JsonObject device = devices[i2c_scheduler.getDeviceName(i)].to<JsonObject>();
+    device["count"] = stats.transactions;
+    device["errors"] = stats.errors;
+    device["busTime"] = stats.busMicros;
+    device["max"] = stats.maxBusMicros;
+    device["maxWait"] = stats.maxWaitMicros;
+  }
+  jsonBody["i2cRejected"] = i2c_scheduler.getRejectedCount();
+
+  serializeJson(jsonBody, perfData);
+  AsyncWebServerResponse *response = request->beginResponse(HTTP_STATUS_200, MIME_JSON, perfData);
+  response->addHeader(HEADER_CACHE_CONTROL, CACHE_NO_CACHE);
+  request->send(response);
+}
+
+void handleResetPerf(AsyncWebServerRequest *request) {
+  // The main loop owns the statistics, so it performs the reset on its next pass.
+  b_profile_reset_requested = true;
+  request->send(HTTP_STATUS_200, MIME_JSON, returnJsonStatus());
+}
+#endif
+
+#if defined(STALL_WATCHDOG)
+void handleGetStalls(AsyncWebServerRequest *request) {
+  // Return every stall record kept, oldest first, including those from before the last reset.
+  String stallData;
+  JsonDocument jsonBody;
+
+  jsonBody["threshold"] = i_stall_threshold;
+  jsonBody["boot"] = stall_log.i_boot;
+  jsonBody["resetReason"] = (uint8_t)esp_reset_reason();
+
+  // Records are read while the main loop may still be writing, so the newest may be incomplete.
+  JsonArray stalls = jsonBody["stalls"].to<JsonArray>();
+  for(uint8_t i = 0; i < stall_log.i_count; i++) {
+    const StallRecord& record = getStallRecord(i);
+    JsonObject stall = stalls.add<JsonObject>();
+    stall["boot"] = record.i_boot;
+    stall["time"] = record.i_time;
+    stall["duration"] = record.i_duration; // 0 when the pass never finished.
+    stall["section"] = String(getProfileSectionName(record.i_section));
+    stall["longest"] = String(getProfileSectionName(record.i_longest_section));
+    stall["longestTime"] = record.i_longest_time;
+    stall["packState"] = record.snapshot.i_pack_state;
+    stall["actionState"] = record.snapshot.i_action_state;
+    stall["systemMode"] = record.snapshot.i_system_mode;
+    stall["systemTheme"] = record.snapshot.i_system_theme;
+    stall["streamMode"] = record.snapshot.i_stream_mode;
+    stall["powerLevel"] = record.snapshot.i_power_level;
+    stall["flags"] = record.snapshot.i_flags;
+    stall["loopTask"] = record.b_loop_task;
+
+    JsonArray backtrace = stall["backtrace"].to<JsonArray>();
+    for(uint8_t j = 0; j < STALL_BACKTRACE_DEPTH && record.i_backtrace[j] != 0; j++) {
+      char address[11];
+      snprintf(address, sizeof(address), "0x%08lx", (unsigned long)record.i_backtrace[j]);
+      backtrace.add(address);
+    }
+  }
+
+  serializeJson(jsonBody, stallData);
+  AsyncWebServerResponse *response = request->beginResponse(HTTP_STATUS_200, MIME_JSON, stallData);
+  response->addHeader(HEADER_CACHE_CONTROL, CACHE_NO_CACHE);
+  request->send(response);
+}
+
+void handleClearStalls(AsyncWebServerRequest *request) {
+  // The main loop and timer interrupt own the records, so the loop clears them at the end of its pass.
+  b_stall_clear_requested = true;
+  request->send(HTTP_STATUS_200, MIME_JSON, returnJsonStatus());
+}
+#endif
+
+#if defined(FLIGHT_RECORDER)
+void handleGetEvents(AsyncWebServerRequest *request) {
+  // Return the flight log as a header followed by each event, oldest first, for scripts/decode_flight_log.py.
+  AsyncResponseStream *response = request->beginResponseStream(MIME_BINARY);
+  FlightLogHeader header;
+
+  getFlightLogHeader(header);
+  response->write((const uint8_t*)&header, sizeof(header));
+
+  // Events are read while the main loop may still be recording, so the newest may be incomplete.
+  for(uint16_t i = 0; i < header.i_count; i++) {
+    FlightEvent event;
+    getFlightEvent(i, event);
+    response->write((const uint8_t*)&event, sizeof(event));
+  }
+
+  response->addHeader(HEADER_CACHE_CONTROL, CACHE_NO_CACHE);
+  response->addHeader(HEADER_CONTENT_DISPOSITION, "attachment; filename=\"pack_events.bin\"");
+  request->send(response);
+}
+
+void handleClearEvents(AsyncWebServerRequest *request) {
+  // The main loop owns the log, so it performs the clear on its next pass.
+  b_flight_clear_requested = true;
+  request->send(HTTP_STATUS_200, MIME_JSON, returnJsonStatus());
+}
+#endif
+
 /**
  * Action Handlers - Perform specific actions via web requests
  */
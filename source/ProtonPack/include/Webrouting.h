@@ -119,6 +119,22 @@ void registerWebRoutes() {
   // System Status and Control
   addSimpleRoute("/status", HTTP_GET, handleGetStatus, "Get system status as JSON", "Returns current system status including mode, theme, and connected device info", TAG_SYSTEM, RESP_SYSTEM_STATUS);
   addSimpleRoute("/restart", HTTP_DELETE, handleRestart, "Restart device", "Performs a restart of the device", TAG_SYSTEM, RESP_NO_CONTENT_RESTART);
+  addSimpleRoute("/debug/boot", HTTP_GET, handleGetBoot, "Get boot report", "Returns the start time and duration in microseconds of each boot stage, when the wand first asked to sync, and the time until the pack was ready for the wand", TAG_SYSTEM, RESP_JSON_OBJECT);
+#if defined(CPU_GOVERNOR)
+  addSimpleRoute("/debug/cpu", HTTP_GET, handleGetCpu, "Get CPU frequency residency", "Returns the current CPU frequency and load, and the time in milliseconds spent at each frequency since boot", TAG_SYSTEM, RESP_JSON_OBJECT);
+#endif
+#if defined(LOOP_PROFILER)
+  addSimpleRoute("/debug/perf", HTTP_GET, handleGetPerf, "Get loop profile", "Returns min/avg/max/p99 times in microseconds for each profiled section of the main loop, plus the bus time used by each i2c device", TAG_SYSTEM, RESP_JSON_OBJECT);
+  addSimpleRoute("/debug/perf", HTTP_DELETE, handleResetPerf, "Reset loop profile", "Clears all loop profiler results", TAG_SYSTEM);
+#endif
+#if defined(STALL_WATCHDOG)
+  addSimpleRoute("/debug/stalls", HTTP_GET, handleGetStalls, "Get stall records", "Returns each pass of the main loop which exceeded the stall threshold, with the section running, the pack state and a backtrace, including those from before the last reset", TAG_SYSTEM, RESP_JSON_OBJECT);
+  addSimpleRoute("/debug/stalls", HTTP_DELETE, handleClearStalls, "Clear stall records", "Clears all stall watchdog records", TAG_SYSTEM);
+#endif
+#if defined(FLIGHT_RECORDER)
+  addSimpleRoute("/debug/events", HTTP_GET, handleGetEvents, "Download event log", "Returns the flight recorder's log of system events as binary, to be decoded with scripts/decode_flight_log.py", TAG_SYSTEM, RESP_BINARY_FILE);
+  addSimpleRoute("/debug/events", HTTP_DELETE, handleClearEvents, "Clear event log", "Clears all flight recorder events", TAG_SYSTEM);
+#endif
 
   // Device Control
   addSimpleRoute("/pack/on", HTTP_PUT, handlePackOn, "Turn pack on", "Powers on the proton pack", TAG_DEVICE_CONTROL);
@@ -45,7 +45,6 @@
 #include <digitalWriteFast.h>
 #include <millisDelay.h>
 #include <FastLED.h>
-#include <ezButton.h>
 #include <Ramp.h>
 #include <SerialTransfer.h>
 #include <Wire.h>
@@ -53,6 +52,11 @@
   #include <HDC1080.h>
   GuL::HDC1080 tempSensor(Wire1);
   #include <HardwareSerial.h>
+  #include <driver/pulse_cnt.h>
+  #include <esp_sleep.h>
+  #include <driver/gptimer.h>
+  #include <esp_cpu.h>
+  #include <esp_debug_helpers.h>
 #else
   #include <EEPROM.h>
 #endif
@@ -63,7 +67,14 @@ void sendDebug(const String& message);
 // Shared Libraries
 #include <DeviceState.h>
 #include <Communication.h>
+#include <LEDCompositor.h>
+#include <I2CScheduler.h>
+#include <LoopProfiler.h>
+#include <QuadratureDecoder.h>
+#include <SwitchBank.h>
+#include <Timeline.h>
 #ifdef ESP32
+  #include <CpuGovernorTask.h>
   #include <WirelessManager.h>
   #include <WebRouter.h>
 
@@ -86,6 +97,8 @@ extern AttenuatorSyncData attenuatorSyncData;
 #include "Configuration.h"
 #include "MusicSounds.h"
 #include "Header.h"
+#include "Profiler.h"
+#include "FlightRecorder.h"
 #include "Colours.h"
 #include "Audio.h"
 #include "PowerMeter.h"
@@ -97,14 +110,24 @@ extern AttenuatorSyncData attenuatorSyncData;
 #include "System.h"
 #include "Command.h"
 #include "Serial.h"
+#include "Boot.h"
+#include "StallWatchdog.h"
 #ifdef ESP32
+  #include "CpuFrequency.h"
   #include "Wireless.h"
   #include "Webhandler.h"
   #include "Webrouting.h"
+  #include "LEDOutput.h"
+  #include "IdleSleep.h"
 #endif
 
 // Writes a debug message to the serial console or sends to the WebSocket or Events stream.
 void sendDebug(const String& message) {
+  #ifdef ESP32
+    if(debug_mutex != NULL) {
+      xSemaphoreTake(debug_mutex, portMAX_DELAY); // Boot tasks may be sending at the same time.
+    }
+  #endif
   #if defined(DEBUG_SEND_TO_CONSOLE)
     debugln(message); // Print to serial console.
   #endif
@@ -116,29 +139,104 @@ void sendDebug(const String& message) {
   #if defined(DEBUG_SEND_TO_EVENTS) and defined(ESP32)
     sendDebugEvent(message.c_str()); // Send message to the events stream.
   #endif
+  #ifdef ESP32
+    if(debug_mutex != NULL) {
+      xSemaphoreGive(debug_mutex);
+    }
+  #endif
 }
 
-void setup() {
-#ifdef ESP32
-  // Force RMT driver exclusively (requires FastLED 3.10.4 at a minimum, not yet released).
-  // This avoids issues with WiFi/networking on ESP32 when using the default bit-banging method.
-  //FastLED.setExclusiveDriver("RMT");
+// Runs the stages which need the audio device and i2c sensors to have been detected.
+void setupDependentStages() {
+  // All further i2c traffic is queued through the scheduler.
+  setupI2CScheduler();
+
+  bootStageBegin(BOOT_PREFERENCES);
+  // Load any saved settings stored in the EEPROM memory of the Proton Pack.
+  if(b_eeprom) {
+    readEEPROM();
+  }
+
+  // Reset the master volume. Important to keep this as we startup the system at the lowest volume.
+  // Then the EEPROM reads any settings if required, then we reset the volume.
+  updateMasterVolume(true);
+  bootStageEnd(BOOT_PREFERENCES);
+
+  bootStageBegin(BOOT_SYSTEM);
+  // Setup and configure the Inner Cyclotron LEDs.
+  resetInnerCyclotronLEDs();
+  updateProtonPackLEDCounts();
+
+#if defined(BENCHMARK_CYCLOTRON_LOOKUP)
+  benchmarkCyclotronLookup();
 #endif
 
-  // Power Cell, Cyclotron Lid, and N-Filter.
-  FastLED.addLeds<NEOPIXEL, PACK_LED_PIN>(pack_leds, MAX_POWERCELL_LED_COUNT + OUTER_CYCLOTRON_LED_MAX + JEWEL_NFILTER_LED_COUNT).setCorrection(TypicalLEDStrip);
-  FastLED.setMaxRefreshRate(0); // Disable FastLED's blocking 2.5ms delay.
+  // Check some LED brightness settings for various LEDs.
+  // The datatype used should avoid checks for negative values.
+  if(i_powercell_brightness > 100) {
+    i_powercell_brightness = 100;
+  }
 
-  // Inner Cyclotron LEDs (Inner Panel + Cyclotron + Cavity).
-  FastLED.addLeds<NEOPIXEL, CYCLOTRON_LED_PIN>(cyclotron_leds, INNER_CYCLOTRON_LED_PANEL_MAX + INNER_CYCLOTRON_CAKE_LED_MAX + INNER_CYCLOTRON_CAVITY_LED_MAX).setCorrection(TypicalLEDStrip);
+  if(i_cyclotron_brightness > 100) {
+    i_cyclotron_brightness = 100;
+  }
 
-  // Update all addressable LEDs to prevent stale LED states.
-  FastLED.show();
+  if(i_cyclotron_inner_brightness > 100) {
+    i_cyclotron_inner_brightness = 100;
+  }
 
+  // Reset cyclotron ramps.
+  resetRampSpeeds();
+
+  // Perform initial pack reset.
+  packOffReset();
+
+  // Start some timers
+  ms_fast_led.start(i_fast_led_delay);
+  ms_check_music.start(i_music_check_delay);
+  ms_attenuator_check.start(i_attenuator_disconnect_delay);
+  ms_cyclotron_switch_plate_leds.start(i_cyclotron_switch_plate_leds_delay);
+
+  // Perform power-on sequence if demo light mode is not enabled per user preferences.
+  if(!b_demo_light_mode) {
+    // System Power On Self Test
+    playEffect(S_POWER_ON);
+    ms_delay_post.start(0);
+  }
+  else {
+    if(gpstarPack.getSystemMode() == MODE_SUPER_HERO) {
+      // Auto start the pack if it is in startup (demo) light mode.
+      PACK_ACTION_STATE = ACTION_ACTIVATE;
+    }
+
+    ms_wand_check.start(i_wand_disconnect_delay / 2);
+    b_pack_post_finish = true;
+  }
+  bootStageEnd(BOOT_SYSTEM);
+
+  b_boot_finished = true;
+
+  if(b_boot_wand_sync_pending) {
+    // The wand asked to sync while the pack was booting, so answer it now.
+    b_boot_wand_sync_pending = false;
+    doWandSync();
+  }
+}
+
+void setup() {
+  i_boot_setup_start = micros();
+
+#if defined(FLIGHT_RECORDER)
+  // Record the reset before anything else can happen.
+  setupFlightRecorder();
+#endif
+
+  // Bring up the serial links first, so the wand and Attenuator can be answered as soon as the loop starts.
+  bootStageBegin(BOOT_SERIAL);
 #ifdef ESP32
-  // Reduce CPU frequency to 160 MHz to save ~33% power compared to 240 MHz.
+  // Reduce CPU frequency to 160 MHz to save ~33% power compared to 240 MHz, or let the governor choose.
   // Do not set below 80 MHz as it will affect WiFi and other peripherals.
-  setCpuFrequencyMhz(160);
+  setupCpuFrequency();
 
   // This is required in order to make sure the board boots successfully.
   Serial.begin(115200);
@@ -168,17 +266,6 @@ void setup() {
 
   // Assign WandSerial to pins 44/43 for the Neutrona Wand communications.
   WandSerial.begin(9600, SERIAL_8N1, WAND_RX_PIN, WAND_TX_PIN);
-
-  // Define the WirelessManager object only after NVS/Preferences are initialized.
-  if(wirelessMgr == nullptr) {
-    wirelessMgr = new WirelessManager(WirelessDeviceType::PROTON_PACK, "192.168.1.4");
-
-    #if defined(RESET_AP_SETTINGS)
-      // Reset the WiFi password to the expected default on every startup.
-      wirelessMgr->resetWifiPassword();
-      debugln(F("WARNING: Firmware forced a reset of the local WiFi password!"));
-    #endif
-  }
 #else
   Serial.begin(9600); // Standard HW serial (USB) console.
   AttenuatorSerial.begin(9600); // Add-on Attenuator communication (19/18).
@@ -188,55 +275,80 @@ void setup() {
   // Initialize the SerialTransfer objects by passing in the appropriate ports.
   attenuatorComs.begin(AttenuatorSerial, false, Serial, 100); // Attenuator/Wireless
   wandComs.begin(WandSerial, false); // Neutrona Wand
+  bootStageEnd(BOOT_SERIAL);
 
+#ifdef ESP32
+  // Detect the audio device and probe the i2c sensors in the background while the LEDs and inputs are set up.
+  startConcurrentBootStages();
+#else
   // Setup the audio device for this controller.
-  setupAudioDevice();
+  bootAudioStage();
 
-  // Setup the i2c bus using the Wire protocol.
+  // Setup the i2c bus and any devices found on it.
+  bootSensorStage();
+#endif
+
+  bootStageBegin(BOOT_LEDS);
 #ifdef ESP32
-  // ESP32-S3 requires manually specifying SDA and SCL pins first.
-  Wire.begin(I2C_SDA, I2C_SCL, 400000UL);
-  Wire1.begin(TEMP_SDA, TEMP_SCL, 400000UL);
-
-  // Initialize the HDC1080 temp/humidity sensor.
-  Wire1.beginTransmission(0x40);
-  if(Wire1.endTransmission() == 0) {
-    b_temp_sensor_detected = true;
-    tempSensor.resetConfiguration();
-    tempSensor.disableHeater();
-    tempSensor.setHumidityResolution(GuL::HDC1080::HumidityMeasurementResolution::HUM_RES_14BIT);
-    tempSensor.setTemperaturResolution(GuL::HDC1080::TemperatureMeasurementResolution::TEMP_RES_14BIT);
-    tempSensor.setAcquisitionMode(GuL::HDC1080::AcquisitionModes::SINGLE_CHANNEL);
-  }
+  // Force RMT driver exclusively (requires FastLED 3.10.4 at a minimum, not yet released).
+  // This avoids issues with WiFi/networking on ESP32 when using the default bit-banging method.
+  //FastLED.setExclusiveDriver("RMT");
+#endif
+
+#if defined(LED_OUTPUT_TASK)
+  // When using the output task, FastLED sends the front buffers which receive a copy of each completed frame.
+  FastLED.addLeds<NEOPIXEL, PACK_LED_PIN>(pack_leds_out, MAX_POWERCELL_LED_COUNT + OUTER_CYCLOTRON_LED_MAX + JEWEL_NFILTER_LED_COUNT).setCorrection(TypicalLEDStrip);
+  FastLED.setMaxRefreshRate(0); // Disable FastLED's blocking 2.5ms delay.
+  FastLED.addLeds<NEOPIXEL, CYCLOTRON_LED_PIN>(cyclotron_leds_out, INNER_CYCLOTRON_LED_PANEL_MAX + INNER_CYCLOTRON_CAKE_LED_MAX + INNER_CYCLOTRON_CAVITY_LED_MAX).setCorrection(TypicalLEDStrip);
 #else
-  Wire.begin();
-  Wire.setClock(400000UL); // Sets the i2c bus to 400kHz
+  // Power Cell, Cyclotron Lid, and N-Filter.
+  FastLED.addLeds<NEOPIXEL, PACK_LED_PIN>(pack_leds, MAX_POWERCELL_LED_COUNT + OUTER_CYCLOTRON_LED_MAX + JEWEL_NFILTER_LED_COUNT).setCorrection(TypicalLEDStrip);
+  FastLED.setMaxRefreshRate(0); // Disable FastLED's blocking 2.5ms delay.
+
+  // Inner Cyclotron LEDs (Inner Panel + Cyclotron + Cavity).
+  FastLED.addLeds<NEOPIXEL, CYCLOTRON_LED_PIN>(cyclotron_leds, INNER_CYCLOTRON_LED_PANEL_MAX + INNER_CYCLOTRON_CAKE_LED_MAX + INNER_CYCLOTRON_CAVITY_LED_MAX).setCorrection(TypicalLEDStrip);
 #endif
 
-  // Initialize an optional power meter on the i2c bus.
-  if(b_use_power_meter) {
-    sendDebug(F("Init power meter..."));
-    powerMeterInit();
+  // Attach the effect layers to the pack compositor, from bottom to top.
+  pack_compositor.addLayer(&powercell_layer);
+  pack_compositor.addLayer(&cyclotron_layer);
+  pack_compositor.addLayer(&vent_light_layer);
+
+  // The Power Cell sweep is stepped by the pack timeline.
+  pack_timeline.addTrack(&powercell_track);
+
+  // Update all addressable LEDs to prevent stale LED states.
+  FastLED.show();
+
+#if defined(LED_OUTPUT_TASK)
+  // All further frames are sent to the LEDs by the output task.
+  startLEDOutputTask();
+#endif
+  bootStageEnd(BOOT_LEDS);
+
+#ifdef ESP32
+  // Define the WirelessManager object only after NVS/Preferences are initialized.
+  if(wirelessMgr == nullptr) {
+    wirelessMgr = new WirelessManager(WirelessDeviceType::PROTON_PACK, "192.168.1.4");
+
+    #if defined(RESET_AP_SETTINGS)
+      // Reset the WiFi password to the expected default on every startup.
+      wirelessMgr->resetWifiPassword();
+      debugln(F("WARNING: Firmware forced a reset of the local WiFi password!"));
+    #endif
   }
+#endif
 
+  bootStageBegin(BOOT_INPUTS);
   // Rotary encoder for volume control.
-  pinModeFast(ROTARY_ENCODER_A, INPUT_PULLUP);
-  pinModeFast(ROTARY_ENCODER_B, INPUT_PULLUP);
+  setupRotaryEncoder();
 
   // Status indicator LED on the v1.5 GPStar Proton Pack Board.
   pinModeFast(PACK_STATUS_LED_PIN, OUTPUT);
   digitalWriteFast(PACK_STATUS_LED_PIN, LOW);
 
   // Configure the various switches on the pack.
-  switch_power.setDebounceTime(50);
-  switch_alarm.setDebounceTime(50);
-  switch_mode.setDebounceTime(50);
-  switch_vibration.setDebounceTime(50);
-  switch_cyclotron_lid.setDebounceTime(50);
-#ifndef ESP32
-  switch_cyclotron_direction.setDebounceTime(50);
-  switch_smoke.setDebounceTime(50);
-#endif
+  setupSwitches();
 
 // Change PWM frequency of pin 45 for the vibration motor, we do not want it high pitched.
 #ifdef ESP32
@@ -298,61 +410,19 @@ void setup() {
     gpstarPack.setSystemTheme(SYSTEM_AFTERLIFE);
   }
   SYSTEM_THEME_TEMP = gpstarPack.getSystemTheme();
+  bootStageEnd(BOOT_INPUTS);
 
-  // Load any saved settings stored in the EEPROM memory of the Proton Pack.
-  if(b_eeprom) {
-    readEEPROM();
-  }
-
-  // Reset the master volume. Important to keep this as we startup the system at the lowest volume.
-  // Then the EEPROM reads any settings if required, then we reset the volume.
-  updateMasterVolume(true);
-
-  // Setup and configure the Inner Cyclotron LEDs.
-  resetInnerCyclotronLEDs();
-  updateProtonPackLEDCounts();
-
-  // Check some LED brightness settings for various LEDs.
-  // The datatype used should avoid checks for negative values.
-  if(i_powercell_brightness > 100) {
-    i_powercell_brightness = 100;
-  }
-
-  if(i_cyclotron_brightness > 100) {
-    i_cyclotron_brightness = 100;
-  }
-
-  if(i_cyclotron_inner_brightness > 100) {
-    i_cyclotron_inner_brightness = 100;
-  }
-
-  // Reset cyclotron ramps.
-  resetRampSpeeds();
-
-  // Perform initial pack reset.
-  packOffReset();
-
-  // Start some timers
-  ms_fast_led.start(i_fast_led_delay);
-  ms_check_music.start(i_music_check_delay);
-  ms_attenuator_check.start(i_attenuator_disconnect_delay);
-  ms_cyclotron_switch_plate_leds.start(i_cyclotron_switch_plate_leds_delay);
-
-  // Perform power-on sequence if demo light mode is not enabled per user preferences.
-  if(!b_demo_light_mode) {
-    // System Power On Self Test
-    playEffect(S_POWER_ON);
-    ms_delay_post.start(0);
-  }
-  else {
-    if(gpstarPack.getSystemMode() == MODE_SUPER_HERO) {
-      // Auto start the pack if it is in startup (demo) light mode.
-      PACK_ACTION_STATE = ACTION_ACTIVATE;
-    }
+#ifdef ESP32
+  // Preferences depend on the audio device found, so the remaining stages are run by loop()
+  // once detection has finished. Until then loop() only services the wand serial link.
+#else
+  setupDependentStages();
+#endif
 
-    ms_wand_check.start(i_wand_disconnect_delay / 2);
-    b_pack_post_finish = true;
-  }
+#if defined(STALL_WATCHDOG)
+  // Start timing each pass of the loop, which runs in the same task as setup().
+  setupStallWatchdog();
+#endif
 
 #ifdef ESP32
   debugf("Setup complete, free heap: %u bytes\n", ESP.getFreeHeap());
@@ -362,7 +432,16 @@ void setup() {
 void updateLEDs() {
   // Update all LED's when the FastLED timer has finished.
   if(ms_fast_led.justFinished()) {
+    PROFILE_SCOPE(PROFILE_LEDS);
+
+    // Recompose any changed spans from the effect layers into the output buffer.
+    pack_compositor.compose();
+
+#ifdef ESP32
+    showLEDs(); // Sends directly or hands off to the LED output task.
+#else
     FastLED.show();
+#endif
 
     // Restart the FastLED timer.
     ms_fast_led.start(i_fast_led_delay);
@@ -371,6 +450,10 @@ void updateLEDs() {
       b_powercell_updating = false;
     }
   }
+
+#if defined(DEBUG_COLOUR_STATS)
+  reportColourStats();
+#endif
 }
 
 // Loop logic dedicated to this device which handles all of the standard operations.
@@ -580,22 +663,56 @@ void mainLoop() {
     break;
 
     case ACTION_OFF:
+    {
+      PROFILE_SCOPE(PROFILE_PACK_ACTION);
       packShutdown();
+    }
     break;
 
     case ACTION_ACTIVATE:
+    {
+      PROFILE_SCOPE(PROFILE_PACK_ACTION);
       packStartup(true); // Start the pack using the full-length startup sequence.
 
       if(b_first_boot) {
         // Used in demo light mode to determine first boot.
         b_first_boot = false;
       }
+    }
     break;
   }
 }
 
 // The main loop of the program which manages all system operations which must occur on every loop.
 void loop() {
+#ifdef ESP32
+  if(!b_boot_finished) {
+    // Audio detection and sensor probing are still running in their own tasks, so keep the wand link drained.
+    checkWandDuringBoot();
+
+    if(concurrentBootStagesDone()) {
+      setupDependentStages();
+    }
+
+    vTaskDelay(pdMS_TO_TICKS(1)); // Let the boot tasks run.
+    return;
+  }
+#endif
+
+  #if defined(DEBUG_LED_OUTPUT)
+  uint32_t i_loop_start = micros();
+  #endif
+  #if defined(CPU_GOVERNOR)
+  cpuLoadEnter();
+  #endif
+  #if defined(STALL_WATCHDOG)
+  stallIterationBegin();
+  #endif
+  PROFILE_BEGIN(PROFILE_LOOP);
+
+  // Complete any i2c transactions which have finished since the last loop.
+  checkI2CScheduler();
+
   #ifdef ESP32
   if(b_initial_wifi_setup_finished) {
   #endif
@@ -604,6 +721,7 @@ void loop() {
 
   // Check for any new serial commands were received from the Neutrona Wand.
   checkWand();
+  markBootReady();
 
   // Check if the wand is considered to have been disconnected.
   wandDisconnectCheck();
@@ -629,10 +747,36 @@ void loop() {
   }
 #ifdef ESP32
   }
+#endif
+
+  PROFILE_END(PROFILE_LOOP);
+
+#if defined(LOOP_PROFILER) || defined(STALL_WATCHDOG) || defined(FLIGHT_RECORDER)
+  // Check for profiler, stall watchdog and flight recorder commands from the serial (USB) console.
+  checkProfileConsole();
+#endif
+
+#if defined(FLIGHT_RECORDER)
+  // Write out any queued events, or clear the log if requested.
+  checkFlightRecorder();
+#endif
+
+#ifdef ESP32
+  #if defined(DEBUG_LED_OUTPUT)
+  recordLoopTime(micros() - i_loop_start);
+  reportLEDOutputStats();
+  #endif
+
   // The ESP32 uses a dual-core CPU with the loop() executing in Core0 by default.
   // Using vTaskDelay even without core-pinning will allow other tasks to run on Core1.
   // Features such as networking, WiFi, and OTA updates can benefit from this delay.
+  #if defined(CPU_GOVERNOR)
+  cpuLoadLeave();
   vTaskDelay(pdMS_TO_TICKS(1)); // Translate 1ms to ticks for a very brief delay.
+  cpuLoadEnter();
+  #else
+  vTaskDelay(pdMS_TO_TICKS(1)); // Translate 1ms to ticks for a very brief delay.
+  #endif
 
   // Run checks on web-related tasks.
   webLoops();
@@ -640,6 +784,16 @@ void loop() {
   // Get the current temperature from the HDC1080 sensor.
   readTemperature();
 
+#if defined(IDLE_LIGHT_SLEEP)
+  // Sleep until the next timer or wake-up event if the pack is idle.
+  checkIdleSleep();
+#endif
+
+#if defined(CPU_GOVERNOR)
+  // Change the CPU frequency to suit the load over the last window.
+  checkCpuGovernor();
+#endif
+
   // Take action with Wifi based on user preference and presence of the Attenuator.
   switch(WIFI_USER_MODE) {
     case WIFI_DISABLED:
@@ -671,5 +825,13 @@ void loop() {
   if(!b_initial_wifi_setup_finished) {
     b_initial_wifi_setup_finished = true;
   }
+
+  #if defined(CPU_GOVERNOR)
+  cpuLoadLeave();
+  #endif
 #endif
+
+  #if defined(STALL_WATCHDOG)
+  stallIterationEnd();
+  #endif
 }
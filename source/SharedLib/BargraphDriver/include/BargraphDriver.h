@@ -0,0 +1,173 @@
+/**
+ *   BargraphDriver - Framebuffered HT16K33 driver for the 28 and 30 segment bargraphs of GPStar devices.
+ *   Keeps the display in RAM and writes only the bytes which changed, once per frame.
+ *   Copyright (C) 2023-2026 Michael Rajotte, Dustin Grau, Nomake Wan
+ *
+ *   This program is free software; you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation; either version 3 of the License, or
+ *   (at your option) any later version.
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License
+ *   along with this program; if not, see <https://www.gnu.org/licenses/>.
+ *
+ */
+
+#pragma once
+
+// Standard library includes for integer type definitions
+#include <stdint.h>  // Provides uint8_t, uint16_t, etc.
+#include <stdbool.h> // Provides bool type definition.
+
+#if defined(ARDUINO)
+  #include <Arduino.h>
+  #include <Wire.h>
+#endif
+
+// Default i2c address of the HT16K33 (all address pins open).
+#define HT16K33_BASE_ADDRESS 0x70
+
+// Bytes of display RAM, where LED n is bit (n & 7) of byte (n >> 3).
+#define HT16K33_RAM_SIZE 16
+
+// Number of LEDs addressable through the display RAM.
+#define HT16K33_LED_COUNT (HT16K33_RAM_SIZE * 8)
+
+// Unchanged bytes between two changed ones which are still sent in the same write, as this costs
+// less than the address and register bytes of a second transaction.
+#define BARGRAPH_MERGE_GAP 2
+
+// Element to LED mapping used by setElement(), chosen to match the bargraph which is fitted.
+enum BargraphLayout : uint8_t {
+  BARGRAPH_LAYOUT_NONE = 0, // Elements map directly to LEDs.
+  BARGRAPH_LAYOUT_28 = 28,  // Barmeter BL28Z-3005SA04Y.
+  BARGRAPH_LAYOUT_30 = 30   // 30 segment (Wamco) bargraph.
+};
+
+/**
+ * Class: BargraphBus
+ * Purpose: Sends one i2c write to a device, so that the driver can be run against a mock bus.
+ */
+class BargraphBus {
+public:
+  virtual ~BargraphBus() {}
+
+  // Writes the bytes to the device in one transaction. Returns 0 on success, as endTransmission().
+  virtual uint8_t write(uint8_t address, const uint8_t* data, uint8_t length) = 0;
+};
+
+#if defined(ARDUINO)
+/**
+ * Class: BargraphWireBus
+ * Purpose: Sends writes through a TwoWire instance.
+ */
+class BargraphWireBus : public BargraphBus {
+public:
+  explicit BargraphWireBus(TwoWire& wire) : wire(wire) {}
+
+  uint8_t write(uint8_t address, const uint8_t* data, uint8_t length) override;
+
+private:
+  TwoWire& wire;
+};
+#endif
+
+// Returns the current time in microseconds, used to measure time spent on the bus.
+typedef uint32_t (*BargraphClock)();
+
+// Traffic sent to the device since the last resetStats().
+struct BargraphStats {
+  uint32_t frames;    // Calls to commit() which had changes to send.
+  uint32_t writes;    // i2c transactions.
+  uint32_t bytes;     // Bytes sent, including the register address of each write.
+  uint32_t busMicros; // Time spent in the bus writes, when a clock is set.
+  uint32_t errors;    // Writes which were not acknowledged.
+};
+
+/**
+ * Class: BargraphDriver
+ * Purpose: Drives a bargraph on an HT16K33 from a RAM framebuffer.
+ *
+ * All set and clear calls change only the framebuffer. commit() compares it with what the device
+ * is known to show and writes just the changed bytes, merging changes which are close together into
+ * a single write. A frame with no changes costs nothing on the bus, so commit() can be called once
+ * per pass of the main loop rather than after every change.
+ *
+ * Elements are mapped to LEDs by one lookup table for the selected layout and orientation, stored
+ * in PROGMEM on the ATMega.
+ *
+ * Example usage:
+ *   BargraphWireBus bus(Wire);
+ *   BargraphDriver bargraph(bus);
+ *   if(bargraph.begin()) { bargraph.setLayout(BARGRAPH_LAYOUT_28, false); }
+ *   bargraph.setElement(0);
+ *   bargraph.commit(); // Once per loop.
+ */
+class BargraphDriver {
+public:
+  explicit BargraphDriver(BargraphBus& bus, uint8_t address = HT16K33_BASE_ADDRESS);
+
+  // Checks for the device and, when found, turns it on with all LEDs off. Returns whether it was found.
+  bool begin();
+  bool isPresent() const;
+
+  // Selects the element to LED mapping, optionally reversed for a bargraph installed upside down.
+  void setLayout(BargraphLayout layout, bool inverted);
+  BargraphLayout getLayout() const;
+  uint8_t getElementCount() const;
+
+  // Returns the LED for the given element in the current layout.
+  uint8_t lookup(uint8_t element) const;
+
+  // Raw LED access, by HT16K33 LED number.
+  void setLed(uint8_t led);
+  void clearLed(uint8_t led);
+  bool getLed(uint8_t led) const;
+
+  // Element access, mapped through the current layout.
+  void setElement(uint8_t element, bool on = true);
+  void clearElement(uint8_t element);
+  bool getElement(uint8_t element) const;
+
+  // Turns off every LED in the framebuffer.
+  void clearAll();
+
+  // Sets the display brightness (0-15), sent immediately.
+  void setBrightness(uint8_t level);
+
+  // Sends all changes since the last commit. Returns false if a write failed, in which case the
+  // changes are sent again by the next commit.
+  bool commit();
+
+  // Whether the framebuffer differs from the device.
+  bool isDirty() const;
+
+  // Forgets what the device shows, so that the next commit rewrites the whole display.
+  void invalidate();
+
+  // Sets the clock used to measure bus time in the stats (micros() by default on Arduino).
+  void setClock(BargraphClock clock);
+  const BargraphStats& getStats() const;
+  void resetStats();
+
+private:
+  bool command(uint8_t value);
+  bool send(uint8_t start, uint8_t length);
+
+  BargraphBus& bus;
+  BargraphClock clock;
+  BargraphStats stats;
+  uint8_t address;
+  BargraphLayout layout;
+  bool inverted;
+  bool present;
+  bool dirty;
+  uint8_t frame[HT16K33_RAM_SIZE]; // What the display should show.
+  uint8_t shown[HT16K33_RAM_SIZE]; // What the device is known to show.
+  bool shownValid;                 // Whether shown[] can be trusted.
+};
@@ -0,0 +1,246 @@
+/**
+ *   BargraphDriver - Framebuffered HT16K33 driver for the 28 and 30 segment bargraphs of GPStar devices.
+ *   Plays bargraph animations from compact frame and parameter tables stored in PROGMEM.
+ *   Copyright (C) 2023-2026 Michael Rajotte, Dustin Grau, Nomake Wan
+ *
+ *   This program is free software; you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation; either version 3 of the License, or
+ *   (at your option) any later version.
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License
+ *   along with this program; if not, see <https://www.gnu.org/licenses/>.
+ *
+ */
+
+#pragma once
+
+#include "BargraphDriver.h"
+
+// Frame flag set in the firing animations when the optional wand tip light is on.
+#define BARGRAPH_FRAME_TIP 0x01
+
+// Stands for the element count of the bargraph in a walk table (top element or random limit).
+#define BARGRAPH_WALK_END 0xFF
+
+// One frame of an animation: one bit per element (bit 0 = element 0), shown for a number of ticks.
+struct BargraphFrame {
+  uint32_t mask;
+  uint8_t ticks;
+  uint8_t flags; // Meaning chosen by the device, eg. BARGRAPH_FRAME_TIP.
+};
+
+enum BargraphPlayMode : uint8_t {
+  BARGRAPH_PLAY_ONCE,   // Stops on the last frame.
+  BARGRAPH_PLAY_LOOP,   // Returns to the first frame after the last.
+  BARGRAPH_PLAY_BOUNCE  // Plays forwards then backwards, without repeating the end frames.
+};
+
+// An animation, with its frames in PROGMEM.
+struct BargraphSequence {
+  const BargraphFrame* frames;
+  uint8_t count;
+  BargraphPlayMode mode;
+};
+
+// Lights (on) or clears one element of a bargraph drawn by the caller.
+typedef void (*BargraphElementWrite)(uint8_t element, bool on);
+
+/**
+ * Class: BargraphSequencePlayer
+ * Purpose: Steps through a frame sequence, one tick at a time.
+ *
+ * Ticks come either from the caller, through tick(), or from update() once per tick time. Changing
+ * the tick time scales the speed of the whole animation, eg. by power level.
+ *
+ * Example usage:
+ *   player.start(&BARGRAPH_SEQ_SUPER_HERO_28, millis());
+ *   player.setTickTime(20);
+ *   if(player.update(millis())) { player.draw(bargraph, 28); } // In the main loop.
+ */
+class BargraphSequencePlayer {
+public:
+  BargraphSequencePlayer();
+
+  // Begins the sequence on its first frame.
+  void start(const BargraphSequence* sequence, uint32_t now = 0);
+  void stop();
+  bool isRunning() const;
+
+  // Counts one tick. Returns true when a new frame begins.
+  bool tick();
+
+  // Counts a tick when the tick time has passed since the last one. Returns true when a new frame begins.
+  bool update(uint32_t now);
+
+  void setTickTime(uint16_t tickTime);
+  uint16_t getTickTime() const;
+
+  uint8_t getPosition() const;
+  uint32_t getMask() const;
+  uint8_t getFlags() const;
+
+  // Starts the sequence if it is not already playing, otherwise counts one tick.
+  void advance(const BargraphSequence* sequence);
+
+  // Shows the current frame on the first elements of the bargraph, writing only the elements which changed since the last draw.
+  void draw(BargraphDriver& bargraph, uint8_t elements);
+
+  // The same for elements drawn by the caller, eg. LEDs on their own pins.
+  void draw(BargraphElementWrite write, uint8_t elements);
+
+private:
+  void load();
+  uint32_t takeChanges(uint8_t elements);
+
+  const BargraphSequence* sequence;
+  BargraphFrame frame;
+  uint32_t drawn;     // Mask as of the last draw.
+  bool redraw;        // Nothing drawn since start().
+  uint32_t lastTick;
+  uint16_t tickTime;
+  uint8_t position;
+  uint8_t ticksLeft;
+  bool reverse;
+  bool running;
+};
+
+// Random number in [low, high), the same as Arduino random(low, high).
+typedef long (*BargraphRandom)(long low, long high);
+
+// Range passed to the random function for a new walk target.
+struct BargraphWalkRange {
+  uint8_t low;
+  uint8_t high; // Exclusive, or BARGRAPH_WALK_END.
+};
+
+/*
+ * A random walk for one power level: the lit elements rise or fall by one element each step
+ * towards a target, and a new target is chosen whenever the old one is passed. The range for each
+ * new target depends on the cyclotron multiplier (index 1-5, with 0 for any other value).
+ */
+struct BargraphWalkLevel {
+  uint8_t top;               // Highest element checked when falling, or BARGRAPH_WALK_END for the last element.
+  BargraphWalkRange first;   // First target, when the target is 0. A high of 0 leaves the target at 0.
+  BargraphWalkRange down[6]; // New target when reached while falling.
+  BargraphWalkRange up[6];   // New target when reached while rising.
+};
+
+// Moves the walk one step on the first elements of the bargraph, using a walk level in PROGMEM.
+void bargraphWalkStep(BargraphDriver& bargraph, uint8_t elements, const BargraphWalkLevel* level, uint8_t multiplier,
+                      uint8_t& target, BargraphRandom random);
+
+/*
+ * The same walk for a bargraph which can only show a fill from the bottom (the 5 LED Hasbro bargraph),
+ * where the target is a number of lit elements rather than an element. Here a top of BARGRAPH_WALK_END
+ * stands for the element count, and a range high of BARGRAPH_WALK_END for one more than it.
+ * Takes the lit elements (bit 0 = element 0) and returns how many elements to light, or
+ * BARGRAPH_WALK_END to leave them as they are.
+ */
+uint8_t bargraphFillWalkStep(uint32_t lit, uint8_t elements, const BargraphWalkLevel* level, uint8_t multiplier,
+                             uint8_t& target, BargraphRandom random);
+
+/*
+ * The sweep shown on the 28 and 30 segment bargraphs when the power level changes: the position
+ * rises one element per step, lighting each, until it passes the turn for the power level, then
+ * falls, clearing each. Super Hero turns back at each end after a pause, while Mode Original stops
+ * at the power level.
+ */
+struct BargraphSweepLevel {
+  uint8_t turn;         // Position past which a rise turns, or BARGRAPH_WALK_END for the element count (where the position is then held).
+  uint8_t stop;         // Mode Original stops a fall once below this position, or BARGRAPH_WALK_END for the element count.
+  uint8_t ticks[2];     // Time per step, in sweep intervals, for Super Hero and Mode Original.
+  uint8_t startDivisor; // A change to this power level starts the sweep after the wait divided by this.
+};
+
+// Moves the sweep one step, using a sweep level in PROGMEM. Returns the time until the next step, or 0 when the sweep stops.
+uint16_t bargraphSweepStep(BargraphDriver& bargraph, uint8_t elements, const BargraphSweepLevel* level, bool original,
+                           uint8_t& position, bool& up, uint16_t interval, uint16_t wait);
+
+// Time before the first step once the power level changes to a sweep level in PROGMEM.
+uint16_t bargraphSweepStartTime(const BargraphSweepLevel* level, uint16_t wait);
+
+/*
+ * Time between firing animation steps (ms), which shortens as an overheat approaches.
+ * The stage is 0 while the overheat timer is not running, 1 while it runs with at least half of its
+ * time left, and 2 to 6 once under 1/2 to 1/6 of its time is left.
+ */
+struct BargraphFiringTiming {
+  uint16_t idle[5];    // By power level 1-5, at stage 0.
+  uint16_t cool[5];    // By power level 1-5, at stage 1.
+  uint16_t warning[5]; // Stages 2 to 6.
+};
+
+// Step time for a power level (1-5) and stage, using timing in PROGMEM.
+uint16_t bargraphFiringStepTime(const BargraphFiringTiming* timing, uint8_t level, uint8_t stage);
+
+/*
+ * The bargraph animations of the Neutrona Wand, for a bargraph of 5 (Hasbro), 28 or 30 elements and
+ * power levels 1-5, so the wand only has to supply its settings and timers.
+ */
+
+// Super Hero firing animation for the bargraph.
+const BargraphSequence* bargraphSuperHeroSequence(uint8_t elements);
+
+// Mode Original firing step on the 28 or 30 segment bargraph, picked from its layout.
+void bargraphOriginalWalkStep(BargraphDriver& bargraph, uint8_t level, uint8_t multiplier, uint8_t& target, BargraphRandom random);
+
+// Mode Original firing step on the 5 LED bargraph. Returns how many LEDs to light, or BARGRAPH_WALK_END to leave them.
+uint8_t bargraphOriginalFillStep(uint32_t lit, uint8_t level, uint8_t multiplier, uint8_t& target, BargraphRandom random);
+
+// Power level change sweep step on the 28 or 30 segment bargraph. Returns the time until the next step, or 0 when the sweep stops.
+uint16_t bargraphPowerSweepStep(BargraphDriver& bargraph, uint8_t level, bool original, uint8_t& position, bool& up,
+                                uint16_t interval, uint16_t wait);
+
+// Time before the first sweep step once the power level changes.
+uint16_t bargraphPowerSweepStartTime(uint8_t level, uint16_t wait);
+
+// Runs a sweep step whenever the timer (a millisDelay, or anything with the same calls) finishes, then restarts or stops it.
+template<typename Delay>
+void bargraphPowerSweepUpdate(Delay& timer, BargraphDriver& bargraph, uint8_t level, bool original, uint8_t& position, bool& up,
+                              uint16_t interval, uint16_t wait) {
+  if(timer.justFinished()) {
+    uint16_t i_next = bargraphPowerSweepStep(bargraph, level, original, position, up, interval, wait);
+
+    if(i_next > 0) {
+      timer.start(i_next);
+    }
+    else {
+      // Mode Original stops when it reaches the power level.
+      timer.stop();
+    }
+  }
+}
+
+// Overheat stage for BargraphFiringTiming, from the overheat timer and the full overheat time of the power level.
+uint8_t bargraphFiringStage(bool running, uint32_t remaining, uint32_t overheatTime);
+
+// Firing step times for the bargraph and firing animation.
+const BargraphFiringTiming* bargraphFiringTiming(uint8_t elements, bool original);
+
+/*
+ * Animations shared by the GPStar devices.
+ */
+
+// Super Hero firing: a pair of elements moving from the centre to the ends and back, with the tip light.
+extern const BargraphSequence BARGRAPH_SEQ_SUPER_HERO_28;
+extern const BargraphSequence BARGRAPH_SEQ_SUPER_HERO_30;
+extern const BargraphSequence BARGRAPH_SEQ_SUPER_HERO_5_LED;
+
+// Mode Original firing: a fill which fluctuates near the top of the power level, by power level 1-5.
+extern const BargraphWalkLevel BARGRAPH_WALK_ORIGINAL[5];
+extern const BargraphWalkLevel BARGRAPH_WALK_ORIGINAL_5_LED[5];
+
+// Power level change sweep, by power level 1-5.
+extern const BargraphSweepLevel BARGRAPH_SWEEP_28[5];
+extern const BargraphSweepLevel BARGRAPH_SWEEP_30[5];
+
+// Firing animation step times, for the 28 and 30 segment bargraphs and for each animation on the 5 LED bargraph.
+extern const BargraphFiringTiming BARGRAPH_FIRING_TIMING_SEGMENTS;
+extern const BargraphFiringTiming BARGRAPH_FIRING_TIMING_5_LED_SUPER_HERO;
+extern const BargraphFiringTiming BARGRAPH_FIRING_TIMING_5_LED_ORIGINAL;
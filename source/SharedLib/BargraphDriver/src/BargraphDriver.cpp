@@ -0,0 +1,277 @@
+/**
+ *   BargraphDriver - Framebuffered HT16K33 driver for the 28 and 30 segment bargraphs of GPStar devices.
+ *   Keeps the display in RAM and writes only the bytes which changed, once per frame.
+ *   Copyright (C) 2023-2026 Michael Rajotte, Dustin Grau, Nomake Wan
+ *
+ *   This program is free software; you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation; either version 3 of the License, or
+ *   (at your option) any later version.
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License
+ *   along with this program; if not, see <https://www.gnu.org/licenses/>.
+ *
+ */
+
+// Library Header
+#include "BargraphDriver.h"
+
+#include <string.h>
+
+#if !defined(ARDUINO)
+  #define PROGMEM
+  #define pgm_read_byte(address) (*(const uint8_t*)(address))
+#endif
+
+// HT16K33 commands.
+#define HT16K33_CMD_OSCILLATOR_ON 0x21
+#define HT16K33_CMD_DISPLAY_ON    0x81 // Display on, blinking off.
+#define HT16K33_CMD_BRIGHTNESS    0xE0
+
+/*
+ * Barmeter 28-segment bargraph mapping.
+ * Part #: BL28Z-3005SA04Y
+ */
+static const uint8_t LAYOUT_28_NORMAL[28] PROGMEM = {0, 16, 32, 48, 1, 17, 33, 49, 2, 18, 34, 50, 3, 19, 35, 51, 4, 20, 36, 52, 5, 21, 37, 53, 6, 22, 38, 54};
+static const uint8_t LAYOUT_28_INVERT[28] PROGMEM = {54, 38, 22, 6, 53, 37, 21, 5, 52, 36, 20, 4, 51, 35, 19, 3, 50, 34, 18, 2, 49, 33, 17, 1, 48, 32, 16, 0};
+
+/*
+ * 30 segment bargraph mapping.
+ */
+static const uint8_t LAYOUT_30_NORMAL[30] PROGMEM = {69, 5, 21, 37, 53, 68, 52, 36, 20, 4, 67, 51, 35, 19, 3, 2, 18, 34, 50, 66, 65, 49, 33, 17, 1, 0, 16, 32, 48, 64};
+static const uint8_t LAYOUT_30_INVERT[30] PROGMEM = {64, 48, 32, 16, 0, 1, 17, 33, 49, 65, 66, 50, 34, 18, 2, 3, 19, 35, 51, 67, 4, 20, 36, 52, 68, 53, 37, 21, 5, 69};
+
+#if defined(ARDUINO)
+uint8_t BargraphWireBus::write(uint8_t address, const uint8_t* data, uint8_t length) {
+  wire.beginTransmission(address);
+  wire.write(data, length);
+  return wire.endTransmission();
+}
+
+static uint32_t defaultClock() {
+  return micros();
+}
+#endif
+
+BargraphDriver::BargraphDriver(BargraphBus& bus, uint8_t address)
+  : bus(bus), address(address), layout(BARGRAPH_LAYOUT_NONE), inverted(false), present(false), dirty(false), shownValid(false) {
+#if defined(ARDUINO)
+  clock = defaultClock;
+#else
+  clock = nullptr;
+#endif
+
+  memset(frame, 0, sizeof(frame));
+  memset(shown, 0, sizeof(shown));
+  resetStats();
+}
+
+bool BargraphDriver::begin() {
+  // An empty write is acknowledged only when the device is on the bus.
+  present = (bus.write(address, nullptr, 0) == 0);
+
+  if(present) {
+    present = command(HT16K33_CMD_OSCILLATOR_ON) && command(HT16K33_CMD_DISPLAY_ON) && command(HT16K33_CMD_BRIGHTNESS | 0x0F);
+  }
+
+  // Start from a blank display, whatever was left in the device RAM.
+  memset(frame, 0, sizeof(frame));
+  invalidate();
+  commit();
+
+  return present;
+}
+
+bool BargraphDriver::isPresent() const {
+  return present;
+}
+
+void BargraphDriver::setLayout(BargraphLayout layout, bool inverted) {
+  this->layout = layout;
+  this->inverted = inverted;
+}
+
+BargraphLayout BargraphDriver::getLayout() const {
+  return layout;
+}
+
+uint8_t BargraphDriver::getElementCount() const {
+  return layout == BARGRAPH_LAYOUT_NONE ? HT16K33_LED_COUNT : (uint8_t)layout;
+}
+
+uint8_t BargraphDriver::lookup(uint8_t element) const {
+  if(element >= getElementCount()) {
+    element = getElementCount() - 1;
+  }
+
+  switch(layout) {
+    case BARGRAPH_LAYOUT_28:
+      return pgm_read_byte(inverted ? &LAYOUT_28_INVERT[element] : &LAYOUT_28_NORMAL[element]);
+
+    case BARGRAPH_LAYOUT_30:
+      return pgm_read_byte(inverted ? &LAYOUT_30_INVERT[element] : &LAYOUT_30_NORMAL[element]);
+
+    case BARGRAPH_LAYOUT_NONE:
+    default:
+      return element;
+  }
+}
+
+void BargraphDriver::setLed(uint8_t led) {
+  uint8_t i_byte = (led >> 3) & (HT16K33_RAM_SIZE - 1);
+  uint8_t i_bit = 1 << (led & 0x07);
+
+  if(!(frame[i_byte] & i_bit)) {
+    frame[i_byte] |= i_bit;
+    dirty = true;
+  }
+}
+
+void BargraphDriver::clearLed(uint8_t led) {
+  uint8_t i_byte = (led >> 3) & (HT16K33_RAM_SIZE - 1);
+  uint8_t i_bit = 1 << (led & 0x07);
+
+  if(frame[i_byte] & i_bit) {
+    frame[i_byte] &= ~i_bit;
+    dirty = true;
+  }
+}
+
+bool BargraphDriver::getLed(uint8_t led) const {
+  return frame[(led >> 3) & (HT16K33_RAM_SIZE - 1)] & (1 << (led & 0x07));
+}
+
+void BargraphDriver::setElement(uint8_t element, bool on) {
+  if(on) {
+    setLed(lookup(element));
+  }
+  else {
+    clearLed(lookup(element));
+  }
+}
+
+void BargraphDriver::clearElement(uint8_t element) {
+  clearLed(lookup(element));
+}
+
+bool BargraphDriver::getElement(uint8_t element) const {
+  return getLed(lookup(element));
+}
+
+void BargraphDriver::clearAll() {
+  for(uint8_t i = 0; i < HT16K33_RAM_SIZE; i++) {
+    if(frame[i] != 0) {
+      frame[i] = 0;
+      dirty = true;
+    }
+  }
+}
+
+void BargraphDriver::setBrightness(uint8_t level) {
+  if(present) {
+    command(HT16K33_CMD_BRIGHTNESS | (level & 0x0F));
+  }
+}
+
+bool BargraphDriver::commit() {
+  if(!present || !dirty) {
+    return true;
+  }
+
+  bool b_ok = true;
+  uint8_t i = 0;
+  uint32_t i_writes = stats.writes;
+
+  while(i < HT16K33_RAM_SIZE) {
+    if(shownValid && frame[i] == shown[i]) {
+      i++;
+      continue;
+    }
+
+    // Extend the write over any further changes, as long as the unchanged bytes between them are few enough.
+    uint8_t i_start = i;
+    uint8_t i_end = i;
+
+    for(uint8_t j = i + 1; j < HT16K33_RAM_SIZE && j - i_end <= BARGRAPH_MERGE_GAP + 1; j++) {
+      if(!shownValid || frame[j] != shown[j]) {
+        i_end = j;
+      }
+    }
+
+    uint8_t i_length = i_end - i_start + 1;
+
+    if(send(i_start, i_length)) {
+      memcpy(&shown[i_start], &frame[i_start], i_length);
+    }
+    else {
+      b_ok = false;
+    }
+
+    i = i_end + 1;
+  }
+
+  if(stats.writes != i_writes) {
+    stats.frames++;
+  }
+
+  if(b_ok) {
+    shownValid = true;
+    dirty = false;
+  }
+
+  return b_ok;
+}
+
+bool BargraphDriver::isDirty() const {
+  return dirty;
+}
+
+void BargraphDriver::invalidate() {
+  shownValid = false;
+  dirty = true;
+}
+
+void BargraphDriver::setClock(BargraphClock clock) {
+  this->clock = clock;
+}
+
+const BargraphStats& BargraphDriver::getStats() const {
+  return stats;
+}
+
+void BargraphDriver::resetStats() {
+  memset(&stats, 0, sizeof(stats));
+}
+
+bool BargraphDriver::command(uint8_t value) {
+  return bus.write(address, &value, 1) == 0;
+}
+
+bool BargraphDriver::send(uint8_t start, uint8_t length) {
+  // Each write begins with the display RAM register (byte address) to start from.
+  uint8_t buffer[HT16K33_RAM_SIZE + 1];
+  buffer[0] = start;
+  memcpy(&buffer[1], &frame[start], length);
+
+  uint32_t i_start = clock ? clock() : 0;
+  uint8_t i_result = bus.write(address, buffer, length + 1);
+
+  if(clock) {
+    stats.busMicros += clock() - i_start;
+  }
+
+  stats.writes++;
+  stats.bytes += length + 1;
+
+  if(i_result != 0) {
+    stats.errors++;
+    return false;
+  }
+
+  return true;
+}
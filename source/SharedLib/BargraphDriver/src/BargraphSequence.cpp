@@ -0,0 +1,613 @@
+/**
+ *   BargraphDriver - Framebuffered HT16K33 driver for the 28 and 30 segment bargraphs of GPStar devices.
+ *   Plays bargraph animations from compact frame and parameter tables stored in PROGMEM.
+ *   Copyright (C) 2023-2026 Michael Rajotte, Dustin Grau, Nomake Wan
+ *
+ *   This program is free software; you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation; either version 3 of the License, or
+ *   (at your option) any later version.
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License
+ *   along with this program; if not, see <https://www.gnu.org/licenses/>.
+ *
+ */
+
+// Library Header
+#include "BargraphSequence.h"
+
+#include <string.h>
+
+#if !defined(ARDUINO)
+  #define PROGMEM
+  #define memcpy_P memcpy
+#endif
+
+/*
+ * Super Hero firing animation for the 28 segment bargraph.
+ * The tip light alternates every two frames.
+ */
+static const BargraphFrame SUPER_HERO_28_FRAMES[] PROGMEM = {
+  {0x00006000, 1, BARGRAPH_FRAME_TIP},
+  {0x00009000, 1, BARGRAPH_FRAME_TIP},
+  {0x00010800, 1, 0},
+  {0x00020400, 1, 0},
+  {0x00040200, 1, BARGRAPH_FRAME_TIP},
+  {0x00080100, 1, BARGRAPH_FRAME_TIP},
+  {0x00100080, 1, 0},
+  {0x00200040, 1, 0},
+  {0x00400020, 1, BARGRAPH_FRAME_TIP},
+  {0x00800010, 1, BARGRAPH_FRAME_TIP},
+  {0x01000008, 1, 0},
+  {0x02000004, 1, 0},
+  {0x04000002, 1, BARGRAPH_FRAME_TIP},
+  {0x08000001, 1, BARGRAPH_FRAME_TIP}
+};
+
+/*
+ * Super Hero firing animation for the 30 segment bargraph.
+ * The centre pair holds the tip light on for three frames.
+ */
+static const BargraphFrame SUPER_HERO_30_FRAMES[] PROGMEM = {
+  {0x0000C000, 1, BARGRAPH_FRAME_TIP},
+  {0x00012000, 1, BARGRAPH_FRAME_TIP},
+  {0x00021000, 1, BARGRAPH_FRAME_TIP},
+  {0x00040800, 1, 0},
+  {0x00080400, 1, 0},
+  {0x00100200, 1, BARGRAPH_FRAME_TIP},
+  {0x00200100, 1, BARGRAPH_FRAME_TIP},
+  {0x00400080, 1, 0},
+  {0x00800040, 1, 0},
+  {0x01000020, 1, BARGRAPH_FRAME_TIP},
+  {0x02000010, 1, BARGRAPH_FRAME_TIP},
+  {0x04000008, 1, 0},
+  {0x08000004, 1, 0},
+  {0x10000002, 1, BARGRAPH_FRAME_TIP},
+  {0x20000001, 1, BARGRAPH_FRAME_TIP}
+};
+
+/*
+ * Super Hero firing animation for the 5 LED Hasbro bargraph.
+ * The last frame repeats the first, so the outer pair is held for two ticks on each loop.
+ */
+static const BargraphFrame SUPER_HERO_5_LED_FRAMES[] PROGMEM = {
+  {0x00000011, 1, BARGRAPH_FRAME_TIP},
+  {0x0000000A, 1, 0},
+  {0x00000004, 1, BARGRAPH_FRAME_TIP},
+  {0x0000000A, 1, 0},
+  {0x00000011, 1, BARGRAPH_FRAME_TIP}
+};
+
+const BargraphSequence BARGRAPH_SEQ_SUPER_HERO_28 = {SUPER_HERO_28_FRAMES, sizeof(SUPER_HERO_28_FRAMES) / sizeof(BargraphFrame), BARGRAPH_PLAY_BOUNCE};
+const BargraphSequence BARGRAPH_SEQ_SUPER_HERO_30 = {SUPER_HERO_30_FRAMES, sizeof(SUPER_HERO_30_FRAMES) / sizeof(BargraphFrame), BARGRAPH_PLAY_BOUNCE};
+const BargraphSequence BARGRAPH_SEQ_SUPER_HERO_5_LED = {SUPER_HERO_5_LED_FRAMES, sizeof(SUPER_HERO_5_LED_FRAMES) / sizeof(BargraphFrame), BARGRAPH_PLAY_LOOP};
+
+/*
+ * Mode Original firing animation, by power level.
+ * Ranges are listed by cyclotron multiplier: any other value, then 1 to 5.
+ */
+const BargraphWalkLevel BARGRAPH_WALK_ORIGINAL[5] PROGMEM = {
+  // Power Level 1: none: 0 - 4
+  {7, {0, 0},
+    {{0, 7}, {0, 8}, {0, 8}, {0, 8}, {0, 9}, {0, 10}},
+    {{0, 7}, {0, 8}, {0, 8}, {0, 8}, {0, 9}, {0, 10}}},
+
+  // Power Level 2: 1/4: 5 - 11
+  {13, {3, 13},
+    {{0, 13}, {3, 13}, {3, 13}, {3, 13}, {2, 13}, {1, 13}},
+    {{0, 13}, {3, 13}, {3, 13}, {3, 13}, {2, 13}, {1, 13}}},
+
+  // Power Level 3: 1/2: 12 - 16
+  {19, {9, 19},
+    {{0, 19}, {9, 19}, {7, 19}, {5, 19}, {3, 19}, {1, 19}},
+    {{0, 19}, {9, 19}, {7, 19}, {5, 19}, {3, 19}, {1, 19}}},
+
+  // Power Level 4: 3/4: 17 - 22
+  {25, {13, 25},
+    {{0, 25}, {13, 25}, {10, 25}, {7, 25}, {4, 25}, {1, 25}},
+    {{0, 25}, {13, 25}, {10, 25}, {7, 25}, {4, 25}, {1, 25}}},
+
+  // Power Level 5: full: 23 - 27 (28 segments) or 24 - 29 (30 segments)
+  {BARGRAPH_WALK_END, {18, BARGRAPH_WALK_END},
+    {{18, BARGRAPH_WALK_END}, {18, BARGRAPH_WALK_END}, {15, BARGRAPH_WALK_END}, {12, BARGRAPH_WALK_END}, {9, BARGRAPH_WALK_END}, {6, BARGRAPH_WALK_END}},
+    {{0, BARGRAPH_WALK_END}, {18, BARGRAPH_WALK_END}, {16, BARGRAPH_WALK_END}, {14, BARGRAPH_WALK_END}, {12, BARGRAPH_WALK_END}, {8, BARGRAPH_WALK_END}}}
+};
+
+/*
+ * Mode Original firing animation for the 5 LED bargraph, by power level.
+ * Ranges are listed by cyclotron multiplier: any other value, then 1 to 5.
+ */
+const BargraphWalkLevel BARGRAPH_WALK_ORIGINAL_5_LED[5] PROGMEM = {
+  // Power Level 1
+  {BARGRAPH_WALK_END, {0, 2},
+    {{0, 3}, {0, 3}, {0, 3}, {0, 5}, {0, 6}, {0, 6}},
+    {{0, 3}, {0, 3}, {0, 3}, {0, 5}, {0, 6}, {0, 6}}},
+
+  // Power Level 2
+  {BARGRAPH_WALK_END, {0, 3},
+    {{0, 3}, {0, 3}, {0, 6}, {0, 6}, {0, 6}, {0, 6}},
+    {{0, 3}, {0, 3}, {0, 3}, {1, 6}, {0, 6}, {0, 6}}},
+
+  // Power Level 3
+  {BARGRAPH_WALK_END, {1, 4},
+    {{1, 4}, {1, 4}, {1, 4}, {1, 6}, {1, 6}, {1, 6}},
+    {{1, 4}, {1, 4}, {1, 4}, {1, 6}, {0, 6}, {0, 6}}},
+
+  // Power Level 4
+  {BARGRAPH_WALK_END, {2, 5},
+    {{2, 6}, {2, 6}, {2, 6}, {1, 6}, {1, 6}, {1, 6}},
+    {{2, 6}, {2, 6}, {2, 6}, {1, 6}, {0, 6}, {0, 6}}},
+
+  // Power Level 5
+  {BARGRAPH_WALK_END, {2, 6},
+    {{2, 6}, {2, 6}, {2, 6}, {1, 6}, {1, 6}, {1, 6}},
+    {{2, 6}, {2, 6}, {2, 6}, {1, 6}, {0, 6}, {0, 6}}}
+};
+
+/*
+ * Power level change sweep, by power level. A rise turns past the element below the top of the power
+ * level (the power level tables in each device), and Mode Original stops a fall just above it.
+ */
+const BargraphSweepLevel BARGRAPH_SWEEP_28[5] PROGMEM = {
+  {3, 5, {7, 10}, 7},
+  {10, 12, {6, 10}, 6},
+  {15, 17, {5, 10}, 5},
+  {21, 23, {4, 10}, 4},
+  {BARGRAPH_WALK_END, BARGRAPH_WALK_END, {3, 10}, 3}
+};
+
+const BargraphSweepLevel BARGRAPH_SWEEP_30[5] PROGMEM = {
+  {4, 5, {7, 10}, 7},
+  {10, 11, {6, 10}, 6},
+  {16, 17, {5, 10}, 5},
+  {22, 23, {4, 10}, 4},
+  {BARGRAPH_WALK_END, BARGRAPH_WALK_END, {3, 10}, 3}
+};
+
+// Firing animation step times (ms), by power level 1-5 and then for stages 2 to 6.
+const BargraphFiringTiming BARGRAPH_FIRING_TIMING_SEGMENTS PROGMEM = {
+  {32, 27, 20, 17, 13},
+  {35, 30, 25, 20, 15},
+  {15, 13, 11, 9, 7}
+};
+
+const BargraphFiringTiming BARGRAPH_FIRING_TIMING_5_LED_SUPER_HERO PROGMEM = {
+  {60, 60, 60, 60, 60},
+  {60, 60, 60, 60, 60},
+  {60, 50, 40, 30, 24}
+};
+
+const BargraphFiringTiming BARGRAPH_FIRING_TIMING_5_LED_ORIGINAL PROGMEM = {
+  {360, 240, 120, 90, 60},
+  {360, 240, 120, 90, 60},
+  {60, 50, 40, 30, 24}
+};
+
+BargraphSequencePlayer::BargraphSequencePlayer()
+  : sequence(nullptr), drawn(0), redraw(true), lastTick(0), tickTime(0), position(0), ticksLeft(0), reverse(false), running(false) {
+  memset(&frame, 0, sizeof(frame));
+}
+
+void BargraphSequencePlayer::start(const BargraphSequence* sequence, uint32_t now) {
+  this->sequence = sequence;
+  position = 0;
+  reverse = false;
+  lastTick = now;
+  redraw = true;
+  running = (sequence != nullptr && sequence->count > 0);
+
+  if(running) {
+    load();
+  }
+}
+
+void BargraphSequencePlayer::stop() {
+  running = false;
+}
+
+bool BargraphSequencePlayer::isRunning() const {
+  return running;
+}
+
+bool BargraphSequencePlayer::tick() {
+  if(!running) {
+    return false;
+  }
+
+  if(ticksLeft > 1) {
+    ticksLeft--;
+    return false;
+  }
+
+  uint8_t i_last = sequence->count - 1;
+
+  switch(sequence->mode) {
+    case BARGRAPH_PLAY_ONCE:
+      if(position == i_last) {
+        running = false;
+        return false;
+      }
+
+      position++;
+    break;
+
+    case BARGRAPH_PLAY_LOOP:
+      position = (position == i_last) ? 0 : position + 1;
+    break;
+
+    case BARGRAPH_PLAY_BOUNCE:
+      if(i_last == 0) {
+        // A single frame has nowhere to go.
+      }
+      else if(reverse) {
+        if(--position == 0) {
+          reverse = false;
+        }
+      }
+      else {
+        if(++position == i_last) {
+          reverse = true;
+        }
+      }
+    break;
+  }
+
+  load();
+  return true;
+}
+
+bool BargraphSequencePlayer::update(uint32_t now) {
+  if(!running || tickTime == 0 || now - lastTick < tickTime) {
+    return false;
+  }
+
+  // Time the next tick from now, as a late tick should not be followed by a short one.
+  lastTick = now;
+  return tick();
+}
+
+void BargraphSequencePlayer::setTickTime(uint16_t tickTime) {
+  this->tickTime = tickTime;
+}
+
+uint16_t BargraphSequencePlayer::getTickTime() const {
+  return tickTime;
+}
+
+uint8_t BargraphSequencePlayer::getPosition() const {
+  return position;
+}
+
+uint32_t BargraphSequencePlayer::getMask() const {
+  return frame.mask;
+}
+
+uint8_t BargraphSequencePlayer::getFlags() const {
+  return frame.flags;
+}
+
+void BargraphSequencePlayer::advance(const BargraphSequence* sequence) {
+  if(!running) {
+    start(sequence);
+  }
+  else {
+    tick();
+  }
+}
+
+// Calls write(element, on) for each changed element (bit 0 = element 0).
+template<typename Write>
+static void drawChanges(uint32_t changes, uint32_t mask, Write write) {
+#if defined(__AVR__)
+  // Work a byte at a time with running copies shifted along, as a variable 32-bit shift is a loop of
+  // its own on the ATMega. Bytes and nibbles without a change are skipped whole.
+  for(uint8_t i_base = 0; changes != 0; i_base += 8) {
+    uint8_t i_byte_changes = (uint8_t)changes;
+    uint8_t i_byte_mask = (uint8_t)mask;
+    uint8_t i = i_base;
+
+    changes >>= 8;
+    mask >>= 8;
+
+    if((i_byte_changes & 0x0F) == 0) {
+      i_byte_changes >>= 4;
+      i_byte_mask >>= 4;
+      i += 4;
+    }
+
+    while(i_byte_changes != 0) {
+      if(i_byte_changes & 0x01) {
+        write(i, i_byte_mask & 0x01);
+      }
+
+      i_byte_changes >>= 1;
+      i_byte_mask >>= 1;
+      i++;
+    }
+  }
+#else
+  // 32-bit cores shift and count trailing zeros in a single instruction, so go straight to each change.
+  while(changes != 0) {
+    uint8_t i = __builtin_ctzl(changes);
+
+    write(i, (mask >> i) & 0x01);
+    changes &= changes - 1;
+  }
+#endif
+}
+
+void BargraphSequencePlayer::draw(BargraphDriver& bargraph, uint8_t elements) {
+  drawChanges(takeChanges(elements), frame.mask, [&bargraph](uint8_t i, bool on) { bargraph.setElement(i, on); });
+}
+
+void BargraphSequencePlayer::draw(BargraphElementWrite write, uint8_t elements) {
+  drawChanges(takeChanges(elements), frame.mask, write);
+}
+
+// Elements which changed since the last draw (all of them after start()), limited to the first elements.
+uint32_t BargraphSequencePlayer::takeChanges(uint8_t elements) {
+  uint32_t i_changes = redraw ? 0xFFFFFFFF : (frame.mask ^ drawn);
+
+  drawn = frame.mask;
+  redraw = false;
+
+  if(elements < 32) {
+    i_changes &= ((uint32_t)1 << elements) - 1;
+  }
+
+  return i_changes;
+}
+
+void BargraphSequencePlayer::load() {
+  memcpy_P(&frame, &sequence->frames[position], sizeof(BargraphFrame));
+  ticksLeft = frame.ticks > 0 ? frame.ticks : 1;
+}
+
+// Table index for a power level, with anything other than 1 to 4 as the highest.
+static uint8_t levelIndex(uint8_t level) {
+  return (level >= 1 && level <= 4) ? level - 1 : 4;
+}
+
+// Resolves BARGRAPH_WALK_END to the element count.
+static uint8_t walkLimit(uint8_t value, uint8_t elements) {
+  return value == BARGRAPH_WALK_END ? elements : value;
+}
+
+static uint8_t walkTarget(const BargraphWalkRange& range, uint8_t elements, BargraphRandom random) {
+  return random(range.low, walkLimit(range.high, elements));
+}
+
+void bargraphWalkStep(BargraphDriver& bargraph, uint8_t elements, const BargraphWalkLevel* level, uint8_t multiplier,
+                      uint8_t& target, BargraphRandom random) {
+  BargraphWalkLevel walk;
+  memcpy_P(&walk, level, sizeof(BargraphWalkLevel));
+
+  if(multiplier > 5) {
+    multiplier = 0;
+  }
+
+  if(target == 0 && walk.first.high > 0) {
+    target = walkTarget(walk.first, elements, random);
+  }
+
+  // Rise until every element below the target is lit, then fall.
+  bool b_down = true;
+
+  for(uint8_t i = 0; i < elements; i++) {
+    if(!bargraph.getElement(i) && i < target) {
+      b_down = false;
+      break;
+    }
+  }
+
+  if(b_down) {
+    uint8_t i_top = (walk.top == BARGRAPH_WALK_END) ? elements - 1 : walk.top;
+
+    // The loop bound follows the target as it changes, and an 8-bit index wraps below 0 in the same way as before.
+    for(uint8_t i = i_top; i >= target; i--) {
+      if(target == i) {
+        target = walkTarget(walk.down[multiplier], elements, random);
+      }
+
+      if(i < elements && bargraph.getElement(i)) {
+        bargraph.clearElement(i);
+        break;
+      }
+    }
+  }
+  else {
+    for(uint8_t i = 0; i <= target; i++) {
+      if(target == i) {
+        target = walkTarget(walk.up[multiplier], elements, random);
+      }
+
+      if(i < elements && !bargraph.getElement(i)) {
+        bargraph.setElement(i);
+        break;
+      }
+    }
+  }
+}
+
+// Whether an element is lit, with anything past the end as off.
+static bool walkLit(uint32_t lit, uint8_t i, uint8_t elements) {
+  return i < elements && i < 32 && ((lit >> i) & 0x01);
+}
+
+uint8_t bargraphFillWalkStep(uint32_t lit, uint8_t elements, const BargraphWalkLevel* level, uint8_t multiplier,
+                             uint8_t& target, BargraphRandom random) {
+  BargraphWalkLevel walk;
+  memcpy_P(&walk, level, sizeof(BargraphWalkLevel));
+
+  // Multipliers beyond the table use the same ranges as 1.
+  if(multiplier > 5) {
+    multiplier = 0;
+  }
+
+  if(target == 0 && walk.first.high > 0) {
+    target = walkTarget(walk.first, elements + 1, random);
+  }
+
+  // Rise until every element up to the target is lit, then fall.
+  bool b_down = true;
+
+  for(uint8_t i = 0; i < elements; i++) {
+    if(!walkLit(lit, i, elements) && i <= target) {
+      b_down = false;
+      break;
+    }
+  }
+
+  if(b_down) {
+    uint8_t i_top = walkLimit(walk.top, elements);
+
+    // Each index counts the elements lit below it, and wraps below 0 in the same way as before.
+    for(uint8_t i = i_top; i >= target; i--) {
+      if(target == i) {
+        target = walkTarget(walk.down[multiplier], elements + 1, random);
+      }
+
+      if(walkLit(lit, i - 1, elements)) {
+        return i - 1;
+      }
+    }
+  }
+  else {
+    for(uint8_t i = 0; i <= target; i++) {
+      if(target == i) {
+        target = walkTarget(walk.up[multiplier], elements + 1, random);
+      }
+
+      if(!walkLit(lit, i, elements)) {
+        return i + 1;
+      }
+    }
+  }
+
+  return BARGRAPH_WALK_END;
+}
+
+uint16_t bargraphSweepStep(BargraphDriver& bargraph, uint8_t elements, const BargraphSweepLevel* level, bool original,
+                           uint8_t& position, bool& up, uint16_t interval, uint16_t wait) {
+  BargraphSweepLevel sweep;
+  memcpy_P(&sweep, level, sizeof(BargraphSweepLevel));
+
+  uint8_t i_turn = walkLimit(sweep.turn, elements);
+  uint8_t i_stop = walkLimit(sweep.stop, elements);
+  uint16_t i_step = interval * sweep.ticks[original ? 1 : 0];
+
+  if(up) {
+    if(position < elements) {
+      bargraph.setElement(position);
+    }
+
+    if(position > i_turn) {
+      up = false;
+
+      if(sweep.turn == BARGRAPH_WALK_END) {
+        position = i_turn;
+      }
+
+      // Mode Original stops at the power level, while Super Hero pauses at the top.
+      return original ? 0 : wait / 2;
+    }
+
+    position++;
+    return i_step;
+  }
+
+  if(position < elements) {
+    bargraph.clearElement(position);
+  }
+
+  if(position == 0) {
+    // A little pause at the bottom.
+    up = true;
+    return wait / 2;
+  }
+
+  position--;
+
+  return (original && position < i_stop) ? 0 : i_step;
+}
+
+uint16_t bargraphSweepStartTime(const BargraphSweepLevel* level, uint16_t wait) {
+  BargraphSweepLevel sweep;
+  memcpy_P(&sweep, level, sizeof(BargraphSweepLevel));
+
+  return sweep.startDivisor > 0 ? wait / sweep.startDivisor : wait;
+}
+
+uint16_t bargraphFiringStepTime(const BargraphFiringTiming* timing, uint8_t level, uint8_t stage) {
+  BargraphFiringTiming times;
+  memcpy_P(&times, timing, sizeof(BargraphFiringTiming));
+
+  uint8_t i_level = levelIndex(level);
+
+  if(stage >= 2) {
+    return times.warning[(stage > 6 ? 6 : stage) - 2];
+  }
+
+  return stage == 1 ? times.cool[i_level] : times.idle[i_level];
+}
+
+const BargraphSequence* bargraphSuperHeroSequence(uint8_t elements) {
+  switch(elements) {
+    case 30:
+      return &BARGRAPH_SEQ_SUPER_HERO_30;
+
+    case 28:
+      return &BARGRAPH_SEQ_SUPER_HERO_28;
+
+    default:
+      return &BARGRAPH_SEQ_SUPER_HERO_5_LED;
+  }
+}
+
+void bargraphOriginalWalkStep(BargraphDriver& bargraph, uint8_t level, uint8_t multiplier, uint8_t& target, BargraphRandom random) {
+  bargraphWalkStep(bargraph, bargraph.getElementCount(), &BARGRAPH_WALK_ORIGINAL[levelIndex(level)], multiplier, target, random);
+}
+
+uint8_t bargraphOriginalFillStep(uint32_t lit, uint8_t level, uint8_t multiplier, uint8_t& target, BargraphRandom random) {
+  return bargraphFillWalkStep(lit, 5, &BARGRAPH_WALK_ORIGINAL_5_LED[levelIndex(level)], multiplier, target, random);
+}
+
+uint16_t bargraphPowerSweepStep(BargraphDriver& bargraph, uint8_t level, bool original, uint8_t& position, bool& up,
+                                uint16_t interval, uint16_t wait) {
+  uint8_t i_elements = bargraph.getElementCount();
+  const BargraphSweepLevel* sweep = (i_elements == 30) ? &BARGRAPH_SWEEP_30[levelIndex(level)] : &BARGRAPH_SWEEP_28[levelIndex(level)];
+
+  return bargraphSweepStep(bargraph, i_elements, sweep, original, position, up, interval, wait);
+}
+
+uint16_t bargraphPowerSweepStartTime(uint8_t level, uint16_t wait) {
+  // Both bargraphs start after the same wait.
+  return bargraphSweepStartTime(&BARGRAPH_SWEEP_28[levelIndex(level)], wait);
+}
+
+uint8_t bargraphFiringStage(bool running, uint32_t remaining, uint32_t overheatTime) {
+  if(!running) {
+    return 0;
+  }
+
+  for(uint8_t i = 6; i >= 2; i--) {
+    if(remaining < overheatTime / i) {
+      return i;
+    }
+  }
+
+  return 1;
+}
+
+const BargraphFiringTiming* bargraphFiringTiming(uint8_t elements, bool original) {
+  if(elements == 28 || elements == 30) {
+    return &BARGRAPH_FIRING_TIMING_SEGMENTS;
+  }
+
+  return original ? &BARGRAPH_FIRING_TIMING_5_LED_ORIGINAL : &BARGRAPH_FIRING_TIMING_5_LED_SUPER_HERO;
+}
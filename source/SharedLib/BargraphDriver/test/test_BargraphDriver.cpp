@@ -0,0 +1,444 @@
+#include <gtest/gtest.h>
+#include <stdio.h>
+#include <vector>
+#include "BargraphDriver.h"
+
+// Simulated bus time in microseconds, advanced by each write to the mock bus.
+static uint32_t g_bus_time = 0;
+
+static uint32_t mockClock() {
+  return g_bus_time;
+}
+
+// One transaction as seen on the bus.
+struct MockWrite {
+  uint8_t address;
+  std::vector<uint8_t> data;
+};
+
+// Records every write and models a 400kHz bus: 9 bits per byte (including the address and the ACK),
+// plus a start and a stop condition, at 2.5us per bit.
+class MockBus : public BargraphBus {
+public:
+  uint8_t write(uint8_t address, const uint8_t* data, uint8_t length) override {
+    MockWrite entry;
+    entry.address = address;
+    entry.data.assign(data, data + length);
+    writes.push_back(entry);
+
+    g_bus_time += ((9 * (length + 1) + 2) * 5) / 2;
+
+    if(failNext > 0) {
+      failNext--;
+      return 2; // NACK on address.
+    }
+
+    if(!present) {
+      return 2;
+    }
+
+    // Keep a copy of the display RAM the same way the HT16K33 does, with the register auto-incrementing.
+    if(length > 1 && data[0] < HT16K33_RAM_SIZE) {
+      for(uint8_t i = 1; i < length; i++) {
+        ram[(data[0] + i - 1) % HT16K33_RAM_SIZE] = data[i];
+      }
+    }
+
+    return 0;
+  }
+
+  void reset() {
+    writes.clear();
+  }
+
+  std::vector<MockWrite> writes;
+  uint8_t ram[HT16K33_RAM_SIZE] = {0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF};
+  bool present = true;
+  int failNext = 0;
+};
+
+// The HT16K33 library previously used by the devices, which sends the whole display RAM on every sendLed().
+class LegacyHT16K33 {
+public:
+  explicit LegacyHT16K33(BargraphBus& bus) : bus(bus) {}
+
+  void setLed(uint8_t led) { ram[led >> 3] |= 1 << (led & 0x07); }
+  void clearLed(uint8_t led) { ram[led >> 3] &= ~(1 << (led & 0x07)); }
+  void setLedNow(uint8_t led) { setLed(led); sendLed(); }
+  void clearLedNow(uint8_t led) { clearLed(led); sendLed(); }
+
+  void sendLed() {
+    uint8_t buffer[HT16K33_RAM_SIZE + 1] = {0};
+    memcpy(&buffer[1], ram, HT16K33_RAM_SIZE);
+    bus.write(HT16K33_BASE_ADDRESS, buffer, sizeof(buffer));
+  }
+
+private:
+  BargraphBus& bus;
+  uint8_t ram[HT16K33_RAM_SIZE] = {0};
+};
+
+class BargraphDriverTest : public ::testing::Test {
+protected:
+  void SetUp() override {
+    g_bus_time = 0;
+    driver.setClock(mockClock);
+    driver.begin();
+    driver.setLayout(BARGRAPH_LAYOUT_28, false);
+    bus.reset();
+    driver.resetStats();
+  }
+
+  MockBus bus;
+  BargraphDriver driver{bus};
+};
+
+TEST(BargraphDriverSetup, BeginProbesInitialisesAndBlanksTheDisplay) {
+  MockBus bus;
+  BargraphDriver driver(bus);
+
+  EXPECT_TRUE(driver.begin());
+  EXPECT_TRUE(driver.isPresent());
+
+  ASSERT_EQ(bus.writes.size(), 5u);
+  EXPECT_EQ(bus.writes[0].data.size(), 0u); // Probe.
+  EXPECT_EQ(bus.writes[1].data, std::vector<uint8_t>({0x21}));
+  EXPECT_EQ(bus.writes[2].data, std::vector<uint8_t>({0x81}));
+  EXPECT_EQ(bus.writes[3].data, std::vector<uint8_t>({0xEF}));
+  EXPECT_EQ(bus.writes[4].data.size(), HT16K33_RAM_SIZE + 1u);
+
+  for(uint8_t i = 0; i < HT16K33_RAM_SIZE; i++) {
+    EXPECT_EQ(bus.ram[i], 0);
+  }
+}
+
+TEST(BargraphDriverSetup, MissingDeviceIsNeverWritten) {
+  MockBus bus;
+  bus.present = false;
+  BargraphDriver driver(bus);
+
+  EXPECT_FALSE(driver.begin());
+  EXPECT_FALSE(driver.isPresent());
+
+  bus.reset();
+  driver.setElement(3);
+  EXPECT_TRUE(driver.commit());
+  EXPECT_TRUE(bus.writes.empty());
+  EXPECT_TRUE(driver.getElement(3));
+}
+
+TEST(BargraphDriverSetup, LayoutsMatchTheDeviceTables) {
+  MockBus bus;
+  BargraphDriver driver(bus);
+
+  driver.setLayout(BARGRAPH_LAYOUT_28, false);
+  EXPECT_EQ(driver.getElementCount(), 28);
+  EXPECT_EQ(driver.lookup(0), 0);
+  EXPECT_EQ(driver.lookup(1), 16);
+  EXPECT_EQ(driver.lookup(27), 54);
+
+  driver.setLayout(BARGRAPH_LAYOUT_28, true);
+  EXPECT_EQ(driver.lookup(0), 54);
+  EXPECT_EQ(driver.lookup(27), 0);
+
+  driver.setLayout(BARGRAPH_LAYOUT_30, false);
+  EXPECT_EQ(driver.getElementCount(), 30);
+  EXPECT_EQ(driver.lookup(0), 69);
+  EXPECT_EQ(driver.lookup(29), 64);
+
+  driver.setLayout(BARGRAPH_LAYOUT_30, true);
+  EXPECT_EQ(driver.lookup(0), 64);
+  EXPECT_EQ(driver.lookup(29), 69);
+
+  // Out of range elements are held at the last element.
+  EXPECT_EQ(driver.lookup(200), 69);
+}
+
+TEST_F(BargraphDriverTest, ChangesAreOnlySentOnCommit) {
+  driver.setElement(0);
+  driver.setElement(1);
+  EXPECT_TRUE(bus.writes.empty());
+  EXPECT_TRUE(driver.isDirty());
+
+  EXPECT_TRUE(driver.commit());
+  EXPECT_FALSE(driver.isDirty());
+  EXPECT_EQ(bus.ram[0], 0x01); // Element 0 is LED 0.
+  EXPECT_EQ(bus.ram[2], 0x01); // Element 1 is LED 16.
+}
+
+TEST_F(BargraphDriverTest, UnchangedFrameCostsNothing) {
+  driver.setElement(5);
+  driver.commit();
+  bus.reset();
+
+  // Setting an element which is already on is not a change.
+  driver.setElement(5);
+  EXPECT_FALSE(driver.isDirty());
+  EXPECT_TRUE(driver.commit());
+  EXPECT_TRUE(bus.writes.empty());
+
+  // Nor is turning an element on and back off within a frame.
+  driver.setElement(6);
+  driver.clearElement(6);
+  EXPECT_TRUE(driver.commit());
+  EXPECT_TRUE(bus.writes.empty());
+}
+
+TEST_F(BargraphDriverTest, SingleChangeWritesOneByte) {
+  driver.setElement(4); // LED 1, byte 0.
+  driver.commit();
+
+  ASSERT_EQ(bus.writes.size(), 1u);
+  EXPECT_EQ(bus.writes[0].address, HT16K33_BASE_ADDRESS);
+  EXPECT_EQ(bus.writes[0].data, std::vector<uint8_t>({0x00, 0x02}));
+}
+
+TEST_F(BargraphDriverTest, NearbyChangesAreMerged) {
+  driver.setLed(0);  // Byte 0.
+  driver.setLed(24); // Byte 3, two unchanged bytes between.
+  driver.commit();
+
+  ASSERT_EQ(bus.writes.size(), 1u);
+  EXPECT_EQ(bus.writes[0].data, std::vector<uint8_t>({0x00, 0x01, 0x00, 0x00, 0x01}));
+}
+
+TEST_F(BargraphDriverTest, DistantChangesAreSeparateWrites) {
+  driver.setLed(0);   // Byte 0.
+  driver.setLed(32);  // Byte 4, three unchanged bytes between.
+  driver.setLed(127); // Byte 15.
+  driver.commit();
+
+  ASSERT_EQ(bus.writes.size(), 3u);
+  EXPECT_EQ(bus.writes[0].data, std::vector<uint8_t>({0x00, 0x01}));
+  EXPECT_EQ(bus.writes[1].data, std::vector<uint8_t>({0x04, 0x01}));
+  EXPECT_EQ(bus.writes[2].data, std::vector<uint8_t>({0x0F, 0x80}));
+}
+
+TEST_F(BargraphDriverTest, FailedWriteIsRetried) {
+  driver.setElement(2); // LED 32, byte 4.
+  bus.failNext = 1;
+
+  EXPECT_FALSE(driver.commit());
+  EXPECT_TRUE(driver.isDirty());
+  EXPECT_EQ(bus.ram[4], 0x00);
+  EXPECT_EQ(driver.getStats().errors, 1u);
+
+  EXPECT_TRUE(driver.commit());
+  EXPECT_FALSE(driver.isDirty());
+  EXPECT_EQ(bus.ram[4], 0x01);
+}
+
+TEST_F(BargraphDriverTest, InvalidateRewritesTheWholeDisplay) {
+  driver.setElement(0);
+  driver.commit();
+  bus.reset();
+
+  driver.invalidate();
+  driver.commit();
+
+  ASSERT_EQ(bus.writes.size(), 1u);
+  EXPECT_EQ(bus.writes[0].data.size(), HT16K33_RAM_SIZE + 1u);
+  EXPECT_EQ(bus.writes[0].data[0], 0x00);
+}
+
+TEST_F(BargraphDriverTest, ClearAllClearsEveryElement) {
+  for(uint8_t i = 0; i < 28; i++) {
+    driver.setElement(i);
+  }
+  driver.commit();
+
+  driver.clearAll();
+  driver.commit();
+
+  for(uint8_t i = 0; i < 28; i++) {
+    EXPECT_FALSE(driver.getElement(i));
+  }
+  for(uint8_t i = 0; i < HT16K33_RAM_SIZE; i++) {
+    EXPECT_EQ(bus.ram[i], 0);
+  }
+}
+
+TEST_F(BargraphDriverTest, StatsCountWritesBytesAndBusTime) {
+  driver.setElement(0);
+  driver.commit();
+
+  const BargraphStats& stats = driver.getStats();
+  EXPECT_EQ(stats.frames, 1u);
+  EXPECT_EQ(stats.writes, 1u);
+  EXPECT_EQ(stats.bytes, 2u);
+  EXPECT_EQ(stats.busMicros, ((9 * 3 + 2) * 5) / 2u);
+
+  driver.resetStats();
+  EXPECT_EQ(driver.getStats().writes, 0u);
+}
+
+/*
+ * Before and after: the same animations drawn through the previous library, which sent all 16 bytes
+ * after each change, and through the framebuffered driver committing once per frame.
+ */
+struct BusCost {
+  uint32_t writes;
+  uint32_t bytes;
+  uint32_t micros;
+};
+
+static BusCost measure(MockBus& bus, uint32_t time_before) {
+  BusCost cost = {0, 0, g_bus_time - time_before};
+
+  for(const MockWrite& entry : bus.writes) {
+    cost.writes++;
+    cost.bytes += entry.data.size();
+  }
+
+  return cost;
+}
+
+static void report(const char* name, uint32_t frames, const BusCost& before, const BusCost& after) {
+  printf("[          ] %-22s per frame: before %5.1f bytes %6.1f us, after %5.1f bytes %6.1f us\n", name,
+         (double)before.bytes / frames, (double)before.micros / frames,
+         (double)after.bytes / frames, (double)after.micros / frames);
+}
+
+// The ramp animation, one element on each frame then one off each frame, with each change sent as it is made.
+TEST(BargraphDriverBenchmark, Ramp) {
+  const uint8_t i_elements = 28;
+  const uint32_t i_frames = i_elements * 2;
+
+  MockBus legacy_bus;
+  LegacyHT16K33 legacy(legacy_bus);
+  BargraphDriver mapping(legacy_bus);
+  mapping.setLayout(BARGRAPH_LAYOUT_28, false);
+
+  uint32_t i_start = g_bus_time;
+  for(uint8_t i = 0; i < i_elements; i++) {
+    legacy.setLedNow(mapping.lookup(i));
+  }
+  for(int8_t i = i_elements - 1; i >= 0; i--) {
+    legacy.clearLedNow(mapping.lookup(i));
+  }
+  BusCost before = measure(legacy_bus, i_start);
+
+  MockBus bus;
+  BargraphDriver driver(bus);
+  driver.begin();
+  driver.setLayout(BARGRAPH_LAYOUT_28, false);
+  bus.reset();
+
+  i_start = g_bus_time;
+  for(uint8_t i = 0; i < i_elements; i++) {
+    driver.setElement(i);
+    driver.commit();
+  }
+  for(int8_t i = i_elements - 1; i >= 0; i--) {
+    driver.clearElement(i);
+    driver.commit();
+  }
+  BusCost after = measure(bus, i_start);
+
+  report("ramp", i_frames, before, after);
+  EXPECT_EQ(before.bytes, i_frames * (HT16K33_RAM_SIZE + 1));
+  EXPECT_EQ(after.bytes, i_frames * 2);
+  EXPECT_LT(after.micros, before.micros);
+}
+
+// The firing animation, where two elements move towards each other from the ends on each frame,
+// with each element changed and then sent on its own.
+TEST(BargraphDriverBenchmark, OuterInner) {
+  const uint8_t i_elements = 28;
+  const uint32_t i_frames = 200;
+
+  MockBus legacy_bus;
+  LegacyHT16K33 legacy(legacy_bus);
+  BargraphDriver mapping(legacy_bus);
+  mapping.setLayout(BARGRAPH_LAYOUT_28, false);
+
+  MockBus bus;
+  BargraphDriver driver(bus);
+  driver.begin();
+  driver.setLayout(BARGRAPH_LAYOUT_28, false);
+  bus.reset();
+
+  uint32_t i_before_time = 0;
+  uint32_t i_after_time = 0;
+
+  for(uint32_t f = 0; f < i_frames; f++) {
+    uint8_t i_step = f % (i_elements / 2);
+    uint8_t i_last = (i_step + (i_elements / 2) - 1) % (i_elements / 2);
+
+    uint32_t i_start = g_bus_time;
+    legacy.clearLedNow(mapping.lookup(i_last));
+    legacy.clearLedNow(mapping.lookup(i_elements - 1 - i_last));
+    legacy.setLedNow(mapping.lookup(i_step));
+    legacy.setLedNow(mapping.lookup(i_elements - 1 - i_step));
+    i_before_time += g_bus_time - i_start;
+
+    i_start = g_bus_time;
+    driver.clearElement(i_last);
+    driver.clearElement(i_elements - 1 - i_last);
+    driver.setElement(i_step);
+    driver.setElement(i_elements - 1 - i_step);
+    driver.commit();
+    i_after_time += g_bus_time - i_start;
+  }
+
+  BusCost before = measure(legacy_bus, 0);
+  BusCost after = measure(bus, 0);
+  before.micros = i_before_time;
+  after.micros = i_after_time;
+
+  report("outer-inner", i_frames, before, after);
+  EXPECT_LT(after.bytes * 4, before.bytes);
+  EXPECT_LT(after.micros, before.micros);
+}
+
+// A power level change, redrawing every element in one frame and sending once at the end.
+// This is the best case for the previous library, and the worst for the driver.
+TEST(BargraphDriverBenchmark, FullRedraw) {
+  const uint8_t i_elements = 28;
+  const uint8_t i_levels[] = {4, 11, 16, 22, 27, 22, 16, 11, 4, 0};
+  const uint32_t i_frames = sizeof(i_levels);
+
+  MockBus legacy_bus;
+  LegacyHT16K33 legacy(legacy_bus);
+  BargraphDriver mapping(legacy_bus);
+  mapping.setLayout(BARGRAPH_LAYOUT_28, false);
+
+  MockBus bus;
+  BargraphDriver driver(bus);
+  driver.begin();
+  driver.setLayout(BARGRAPH_LAYOUT_28, false);
+  bus.reset();
+
+  uint32_t i_before_time = 0;
+  uint32_t i_after_time = 0;
+
+  for(uint32_t f = 0; f < i_frames; f++) {
+    uint32_t i_start = g_bus_time;
+    for(uint8_t i = 0; i < i_elements; i++) {
+      if(i <= i_levels[f]) {
+        legacy.setLed(mapping.lookup(i));
+      }
+      else {
+        legacy.clearLed(mapping.lookup(i));
+      }
+    }
+    legacy.sendLed();
+    i_before_time += g_bus_time - i_start;
+
+    i_start = g_bus_time;
+    for(uint8_t i = 0; i < i_elements; i++) {
+      driver.setElement(i, i <= i_levels[f]);
+    }
+    driver.commit();
+    i_after_time += g_bus_time - i_start;
+  }
+
+  BusCost before = measure(legacy_bus, 0);
+  BusCost after = measure(bus, 0);
+  before.micros = i_before_time;
+  after.micros = i_after_time;
+
+  report("full redraw", i_frames, before, after);
+  EXPECT_LE(after.bytes, before.bytes);
+  EXPECT_LE(after.micros, before.micros);
+}
@@ -0,0 +1,2483 @@
+#include <gtest/gtest.h>
+#include <stdio.h>
+#include <chrono>
+#include <string>
+#include <vector>
+#include "BargraphSequence.h"
+
+/*
+ * The wand's bargraph firing and power level functions from before the move to the PROGMEM tables,
+ * copied as they appeared in NeutronaWand/include/System.h, run side by side with the BargraphSequence
+ * steps the wand calls now, on stand-ins for the wand's globals. The old bodies are left exactly as
+ * written; only the names they use are provided below. The 5 LED bargraph is modelled as five pins
+ * (pin n = element n, LOW = lit), and reads of any other pin, as when an index wraps below 0, return
+ * HIGH (off).
+ */
+#define PROGMEM
+#define PROGMEM_READU8(x) (x)
+#define MAX_POWER_LEVEL 5
+
+// Accepts every write without recording it.
+class NullBus : public BargraphBus {
+public:
+  uint8_t write(uint8_t, const uint8_t*, uint8_t) override { return 0; }
+};
+
+// Repeatable stand-in for Arduino random(low, high).
+static uint32_t g_seed = 1;
+
+static long testRandom(long low, long high) {
+  g_seed = g_seed * 1103515245u + 12345u;
+
+  if(high <= low) {
+    return low;
+  }
+
+  return low + (long)((g_seed >> 16) % (uint32_t)(high - low));
+}
+
+// A millisDelay which finishes as soon as it is checked.
+struct FakeDelay {
+  bool running = false;
+  uint32_t started = 0; // Time given to the last start().
+  uint32_t left = 0;    // Returned by remaining() while running.
+
+  void start(uint32_t ms) { running = true; started = ms; left = ms; }
+  void stop() { running = false; }
+  bool isRunning() const { return running; }
+  uint32_t remaining() const { return running ? left : 0; }
+
+  bool justFinished() {
+    if(running) {
+      running = false;
+      return true;
+    }
+
+    return false;
+  }
+};
+
+namespace wand {
+  enum POWER_LEVELS : uint8_t { LEVEL_1 = 1, LEVEL_2 = 2, LEVEL_3 = 3, LEVEL_4 = 4, LEVEL_5 = 5 };
+  enum BARGRAPH_TYPES : uint8_t { SEGMENTS_UNKNOWN = 0, SEGMENTS_5 = 5, SEGMENTS_28 = 28, SEGMENTS_30 = 30 };
+  enum BARGRAPH_MODES { BARGRAPH_SUPER_HERO, BARGRAPH_ORIGINAL };
+  enum BARGRAPH_FIRING_ANIMATIONS { BARGRAPH_ANIMATION_SUPER_HERO, BARGRAPH_ANIMATION_ORIGINAL };
+  enum WAND_ACTION_STATE { ACTION_IDLE, ACTION_FIRING, ACTION_SETTINGS, ACTION_OVERHEATING };
+  enum PIN_STATES : uint8_t { LOW = 0, HIGH = 1 };
+
+  struct Wand {
+    POWER_LEVELS level = LEVEL_1;
+    POWER_LEVELS previous = LEVEL_1;
+
+    POWER_LEVELS getPowerLevel() const { return level; }
+    POWER_LEVELS getPreviousPowerLevel() const { return previous; }
+  };
+
+  BARGRAPH_TYPES BARGRAPH_TYPE = SEGMENTS_28;
+  BARGRAPH_MODES BARGRAPH_MODE = BARGRAPH_ORIGINAL;
+  BARGRAPH_FIRING_ANIMATIONS BARGRAPH_FIRING_ANIMATION = BARGRAPH_ANIMATION_SUPER_HERO;
+  WAND_ACTION_STATE WAND_ACTION_STATUS = ACTION_IDLE;
+  Wand gpstarWand;
+
+  const uint8_t i_bargraph_interval = 4;
+  const uint8_t i_bargraph_wait = 180;
+  const uint8_t i_bargraph_ramp_interval = 120;
+  const uint8_t i_bargraph_ramp_interval_alt = 40;
+  const uint8_t i_bargraph_segments = 30;
+  const uint8_t i_bargraph_segments_5_led = 5;
+  const uint8_t i_bargraph_power_table_28[MAX_POWER_LEVEL + 1] PROGMEM = {0, 4, 11, 16, 22, 27};
+  const uint8_t i_bargraph_power_table_wamco[MAX_POWER_LEVEL + 1] PROGMEM = {0, 5, 11, 17, 23, 29};
+  uint16_t i_ms_overheat_initiate[5] = {60000, 50000, 40000, 30000, 20000};
+
+  uint8_t i_bargraph_status = 0;
+  uint8_t i_bargraph_status_alt = 0;
+  bool b_bargraph_up = false;
+  uint8_t i_cyclotron_multiplier = 1;
+  uint8_t i_barrel_light = 0;
+  bool b_tip = false;
+  std::vector<uint8_t> i_speed_ups; // cyclotronSpeedUp() calls.
+
+  NullBus bus;
+  BargraphDriver ht_bargraph(bus);
+  BargraphSequencePlayer bargraph_player;
+  FakeDelay ms_bargraph_alt;
+  FakeDelay ms_bargraph_firing;
+  FakeDelay ms_overheat_initiate;
+  uint8_t i_pins[5] = {HIGH, HIGH, HIGH, HIGH, HIGH};
+
+  long random(long low, long high) { return testRandom(low, high); }
+
+  uint8_t bargraphLookupTable(uint8_t index) { return index; }
+  uint8_t digitalReadFast(uint8_t pin) { return pin < 5 ? i_pins[pin] : (uint8_t)HIGH; }
+  void digitalWriteFast(uint8_t pin, uint8_t value) { if(pin < 5) i_pins[pin] = value; }
+  void wandTipOn() { b_tip = true; }
+  void wandTipOff() { b_tip = false; }
+  void cyclotronSpeedUp(uint8_t i_switch) { i_speed_ups.push_back(i_switch); }
+
+  void wandBargraphControl(uint8_t i_t_level) {
+  #ifndef ESP32
+    if(i_t_level > 4) {
+      // On
+      digitalWriteFast(bargraphLookupTable(5-1), LOW);
+    }
+    else {
+      // Off
+      digitalWriteFast(bargraphLookupTable(5-1), HIGH);
+    }
+
+    if(i_t_level > 3) {
+      digitalWriteFast(bargraphLookupTable(4-1), LOW);
+    }
+    else {
+      digitalWriteFast(bargraphLookupTable(4-1), HIGH);
+    }
+
+    if(i_t_level > 2) {
+      digitalWriteFast(bargraphLookupTable(3-1), LOW);
+    }
+    else {
+      digitalWriteFast(bargraphLookupTable(3-1), HIGH);
+    }
+
+    if(i_t_level > 1) {
+      digitalWriteFast(bargraphLookupTable(2-1), LOW);
+    }
+    else {
+      digitalWriteFast(bargraphLookupTable(2-1), HIGH);
+    }
+
+    if(i_t_level > 0) {
+      digitalWriteFast(bargraphLookupTable(1-1), LOW);
+    }
+    else {
+      digitalWriteFast(bargraphLookupTable(1-1), HIGH);
+    }
+  #endif
+  }
+
+  uint8_t bargraphPowerLookupTable(uint8_t index) {
+    if(BARGRAPH_TYPE == SEGMENTS_28) {
+      return PROGMEM_READU8(i_bargraph_power_table_28[index]);
+    }
+    else if(BARGRAPH_TYPE == SEGMENTS_30) {
+      return PROGMEM_READU8(i_bargraph_power_table_wamco[index]);
+    }
+    else {
+      return 1;
+    }
+  }
+}
+
+// Before: as in System.h up to the move to the PROGMEM tables.
+namespace before {
+  using namespace wand;
+
+  void bargraphPowerCheck() {
+    // Control for the 28 and 30 segment bargraph.
+    /*
+      // 28 Segment bargraph.
+      Power Level 5: full: 23 - 27  (5 segments)
+      Power Level 4: 3/4: 17 - 22   (6 segments)
+      Power Level 3: 1/2: 12 - 16   (5 segments)
+      Power Level 2: 1/4: 5 - 11    (7 segments)
+      Power Level 1: none: 0 - 4    (5 segments)
+    */
+
+    /*
+      // 30 Segment bargraph.
+      Power Level 5: full: 24 - 29  (6 segments)
+      Power Level 4: 3/4: 18 - 23   (6 segments)
+      Power Level 3: 1/2: 12 - 17   (6 segments)
+      Power Level 2: 1/4: 6 - 11    (6 segments)
+      Power Level 1: none: 0 - 5    (6 segments)
+    */
+
+    if(BARGRAPH_TYPE == SEGMENTS_28 || BARGRAPH_TYPE == SEGMENTS_30) {
+      if(ms_bargraph_alt.justFinished()) {
+        uint8_t i_segment_adjust = 2;
+
+        if(BARGRAPH_TYPE == SEGMENTS_30) {
+          i_segment_adjust = 0;
+        }
+
+        uint8_t i_bargraph_multiplier[5] = { 7, 6, 5, 4, 3 };
+
+        if(BARGRAPH_MODE == BARGRAPH_ORIGINAL) {
+          for(uint8_t i = 0; i <= 4; i++) {
+            i_bargraph_multiplier[i] = 10;
+          }
+        }
+
+        if(b_bargraph_up) {
+          if(i_bargraph_status_alt < i_bargraph_segments - i_segment_adjust) {
+            ht_bargraph.setElement(i_bargraph_status_alt);
+          }
+
+          switch(gpstarWand.getPowerLevel()) {
+            case LEVEL_1 ... LEVEL_4:
+              if(i_bargraph_status_alt > bargraphPowerLookupTable((uint8_t)gpstarWand.getPowerLevel()) - 1) {
+                b_bargraph_up = false;
+
+                if(BARGRAPH_MODE == BARGRAPH_ORIGINAL) {
+                  // We stop when we reach our target.
+                  ms_bargraph_alt.stop();
+                }
+                else {
+                  // A little pause when we reach the top.
+                  ms_bargraph_alt.start(i_bargraph_wait / 2);
+                }
+              }
+              else {
+                ms_bargraph_alt.start(i_bargraph_interval * i_bargraph_multiplier[(uint8_t)gpstarWand.getPowerLevel() - 1]);
+              }
+            break;
+
+            case LEVEL_5:
+            default:
+              if(i_bargraph_status_alt > i_bargraph_segments - i_segment_adjust) {
+                b_bargraph_up = false;
+
+                i_bargraph_status_alt = i_bargraph_segments - i_segment_adjust;
+
+                if(BARGRAPH_MODE == BARGRAPH_ORIGINAL) {
+                  // We stop when we reach our target.
+                  ms_bargraph_alt.stop();
+                }
+                else {
+                  // A little pause when we reach the top.
+                  ms_bargraph_alt.start(i_bargraph_wait / 2);
+                }
+              }
+              else {
+                ms_bargraph_alt.start(i_bargraph_interval * i_bargraph_multiplier[(uint8_t)gpstarWand.getPowerLevel() - 1]);
+              }
+            break;
+          }
+
+          if(b_bargraph_up) {
+            i_bargraph_status_alt++;
+          }
+        }
+        else {
+          if(i_bargraph_status_alt < i_bargraph_segments - i_segment_adjust) {
+            ht_bargraph.clearElement(i_bargraph_status_alt);
+          }
+
+          if(i_bargraph_status_alt == 0) {
+            b_bargraph_up = true;
+
+            // A little pause when we reach the bottom.
+            ms_bargraph_alt.start(i_bargraph_wait / 2);
+          }
+          else {
+            i_bargraph_status_alt--;
+
+            uint8_t i_bargraph_power_lookup_adjust = 1;
+
+            if(BARGRAPH_TYPE == SEGMENTS_30) {
+              i_bargraph_power_lookup_adjust = 0;
+            }
+
+            switch(gpstarWand.getPowerLevel()) {
+              case LEVEL_1 ... LEVEL_4:
+                if(BARGRAPH_MODE == BARGRAPH_ORIGINAL && i_bargraph_status_alt < bargraphPowerLookupTable((uint8_t)gpstarWand.getPowerLevel()) + i_bargraph_power_lookup_adjust) {
+                  // We stop when we reach our target.
+                  ms_bargraph_alt.stop();
+                }
+                else {
+                  ms_bargraph_alt.start(i_bargraph_interval * i_bargraph_multiplier[(uint8_t)gpstarWand.getPowerLevel() - 1]);
+                }
+              break;
+
+              case LEVEL_5:
+              default:
+                if(BARGRAPH_MODE == BARGRAPH_ORIGINAL && i_bargraph_status_alt < i_bargraph_segments - i_segment_adjust) {
+                  // We stop when we reach our target.
+                  ms_bargraph_alt.stop();
+                }
+                else {
+                  ms_bargraph_alt.start(i_bargraph_interval * i_bargraph_multiplier[(uint8_t)gpstarWand.getPowerLevel() - 1]);
+                }
+              break;
+            }
+          }
+        }
+      }
+    }
+    else {
+      // Stock haslab bargraph control.
+      switch(gpstarWand.getPowerLevel()) {
+        case LEVEL_1:
+          wandBargraphControl(1);
+        break;
+
+        case LEVEL_2:
+          wandBargraphControl(2);
+        break;
+
+        case LEVEL_3:
+          wandBargraphControl(3);
+        break;
+
+        case LEVEL_4:
+          wandBargraphControl(4);
+        break;
+
+        case LEVEL_5:
+        default:
+          wandBargraphControl(5);
+        break;
+      }
+    }
+  }
+
+  void bargraphPowerCheck2021Alt(bool b_override) {
+    if((WAND_ACTION_STATUS != ACTION_FIRING && WAND_ACTION_STATUS != ACTION_SETTINGS && WAND_ACTION_STATUS != ACTION_OVERHEATING) || b_override) {
+      if(gpstarWand.getPowerLevel() != gpstarWand.getPreviousPowerLevel() || b_override) {
+        if(gpstarWand.getPowerLevel() > gpstarWand.getPreviousPowerLevel()) {
+          b_bargraph_up = true;
+        }
+        else {
+          b_bargraph_up = false;
+        }
+
+        switch(gpstarWand.getPowerLevel()) {
+          case LEVEL_5:
+          default:
+            ms_bargraph_alt.start(i_bargraph_wait / 3);
+          break;
+
+          case LEVEL_4:
+            ms_bargraph_alt.start(i_bargraph_wait / 4);
+          break;
+
+          case LEVEL_3:
+            ms_bargraph_alt.start(i_bargraph_wait / 5);
+          break;
+
+          case LEVEL_2:
+            ms_bargraph_alt.start(i_bargraph_wait / 6);
+          break;
+
+          case LEVEL_1:
+            ms_bargraph_alt.start(i_bargraph_wait / 7);
+          break;
+        }
+      }
+    }
+  }
+
+  void bargraphSuperHeroRampFiringAnimation() {
+    if(BARGRAPH_TYPE == SEGMENTS_28 || BARGRAPH_TYPE == SEGMENTS_30) {
+      if(BARGRAPH_TYPE == SEGMENTS_30) {
+        switch(i_bargraph_status_alt) {
+          case 0:
+            ht_bargraph.setElement(14);
+            ht_bargraph.setElement(15);
+
+            i_bargraph_status_alt++;
+
+            if(!b_bargraph_up) {
+              ht_bargraph.clearElement(13);
+              ht_bargraph.clearElement(16);
+            }
+
+            b_bargraph_up = true;
+
+            wandTipOn();
+          break;
+
+          case 1:
+            ht_bargraph.setElement(13);
+            ht_bargraph.setElement(16);
+
+            if(b_bargraph_up) {
+              ht_bargraph.clearElement(14);
+              ht_bargraph.clearElement(15);
+
+              i_bargraph_status_alt++;
+            }
+            else {
+              ht_bargraph.clearElement(12);
+              ht_bargraph.clearElement(17);
+
+              i_bargraph_status_alt--;
+            }
+
+            wandTipOn();
+          break;
+
+          case 2:
+            ht_bargraph.setElement(12);
+            ht_bargraph.setElement(17);
+
+            if(b_bargraph_up) {
+              ht_bargraph.clearElement(13);
+              ht_bargraph.clearElement(16);
+
+              i_bargraph_status_alt++;
+            }
+            else {
+              ht_bargraph.clearElement(11);
+              ht_bargraph.clearElement(18);
+
+              i_bargraph_status_alt--;
+            }
+
+            wandTipOn();
+          break;
+
+          case 3:
+            ht_bargraph.setElement(11);
+            ht_bargraph.setElement(18);
+
+            if(b_bargraph_up) {
+              ht_bargraph.clearElement(12);
+              ht_bargraph.clearElement(17);
+
+              i_bargraph_status_alt++;
+            }
+            else {
+              ht_bargraph.clearElement(10);
+              ht_bargraph.clearElement(19);
+
+              i_bargraph_status_alt--;
+            }
+
+            wandTipOff();
+          break;
+
+          case 4:
+            ht_bargraph.setElement(10);
+            ht_bargraph.setElement(19);
+
+            if(b_bargraph_up) {
+              ht_bargraph.clearElement(11);
+              ht_bargraph.clearElement(18);
+
+              i_bargraph_status_alt++;
+            }
+            else {
+              ht_bargraph.clearElement(9);
+              ht_bargraph.clearElement(20);
+
+              i_bargraph_status_alt--;
+            }
+
+            wandTipOff();
+          break;
+
+          case 5:
+            ht_bargraph.setElement(9);
+            ht_bargraph.setElement(20);
+
+            if(b_bargraph_up) {
+              ht_bargraph.clearElement(10);
+              ht_bargraph.clearElement(19);
+
+              i_bargraph_status_alt++;
+            }
+            else {
+              ht_bargraph.clearElement(8);
+              ht_bargraph.clearElement(21);
+
+              i_bargraph_status_alt--;
+            }
+
+            wandTipOn();
+          break;
+
+          case 6:
+            ht_bargraph.setElement(8);
+            ht_bargraph.setElement(21);
+
+            if(b_bargraph_up) {
+              ht_bargraph.clearElement(9);
+              ht_bargraph.clearElement(20);
+
+              i_bargraph_status_alt++;
+            }
+            else {
+              ht_bargraph.clearElement(7);
+              ht_bargraph.clearElement(22);
+
+              i_bargraph_status_alt--;
+            }
+
+            wandTipOn();
+          break;
+
+          case 7:
+            ht_bargraph.setElement(7);
+            ht_bargraph.setElement(22);
+
+            if(b_bargraph_up) {
+              ht_bargraph.clearElement(8);
+              ht_bargraph.clearElement(21);
+
+              i_bargraph_status_alt++;
+            }
+            else {
+              ht_bargraph.clearElement(6);
+              ht_bargraph.clearElement(23);
+
+              i_bargraph_status_alt--;
+            }
+
+            wandTipOff();
+          break;
+
+          case 8:
+            ht_bargraph.setElement(6);
+            ht_bargraph.setElement(23);
+
+            if(b_bargraph_up) {
+              ht_bargraph.clearElement(7);
+              ht_bargraph.clearElement(22);
+
+              i_bargraph_status_alt++;
+            }
+            else {
+              ht_bargraph.clearElement(5);
+              ht_bargraph.clearElement(24);
+
+              i_bargraph_status_alt--;
+            }
+
+            wandTipOff();
+          break;
+
+          case 9:
+            ht_bargraph.setElement(5);
+            ht_bargraph.setElement(24);
+
+            if(b_bargraph_up) {
+              ht_bargraph.clearElement(6);
+              ht_bargraph.clearElement(23);
+
+              i_bargraph_status_alt++;
+            }
+            else {
+              ht_bargraph.clearElement(4);
+              ht_bargraph.clearElement(25);
+
+              i_bargraph_status_alt--;
+            }
+
+            wandTipOn();
+          break;
+
+          case 10:
+            ht_bargraph.setElement(4);
+            ht_bargraph.setElement(25);
+
+            if(b_bargraph_up) {
+              ht_bargraph.clearElement(5);
+              ht_bargraph.clearElement(24);
+
+              i_bargraph_status_alt++;
+            }
+            else {
+              ht_bargraph.clearElement(3);
+              ht_bargraph.clearElement(26);
+
+              i_bargraph_status_alt--;
+            }
+
+            wandTipOn();
+          break;
+
+          case 11:
+            ht_bargraph.setElement(3);
+            ht_bargraph.setElement(26);
+
+            if(b_bargraph_up) {
+              ht_bargraph.clearElement(4);
+              ht_bargraph.clearElement(25);
+
+              i_bargraph_status_alt++;
+            }
+            else {
+              ht_bargraph.clearElement(2);
+              ht_bargraph.clearElement(27);
+
+              i_bargraph_status_alt--;
+            }
+
+            wandTipOff();
+          break;
+
+          case 12:
+            ht_bargraph.setElement(2);
+            ht_bargraph.setElement(27);
+
+            if(b_bargraph_up) {
+              ht_bargraph.clearElement(3);
+              ht_bargraph.clearElement(26);
+
+              i_bargraph_status_alt++;
+            }
+            else {
+              ht_bargraph.clearElement(1);
+              ht_bargraph.clearElement(28);
+
+              i_bargraph_status_alt--;
+            }
+
+            wandTipOff();
+          break;
+
+          case 13:
+            ht_bargraph.setElement(1);
+            ht_bargraph.setElement(28);
+
+            if(b_bargraph_up) {
+              ht_bargraph.clearElement(2);
+              ht_bargraph.clearElement(27);
+
+              i_bargraph_status_alt++;
+            }
+            else {
+              ht_bargraph.clearElement(0);
+              ht_bargraph.clearElement(29);
+
+              i_bargraph_status_alt--;
+            }
+
+            wandTipOn();
+          break;
+
+          case 14:
+            ht_bargraph.setElement(0);
+            ht_bargraph.setElement(29);
+
+            ht_bargraph.clearElement(1);
+            ht_bargraph.clearElement(28);
+
+            i_bargraph_status_alt--;
+
+            b_bargraph_up = false;
+
+            wandTipOn();
+          break;
+
+          default:
+            // We should not be here. Do nothing.
+          break;
+        }
+      }
+      else {
+        switch(i_bargraph_status_alt) {
+          case 0:
+            ht_bargraph.setElement(13);
+            ht_bargraph.setElement(14);
+
+            i_bargraph_status_alt++;
+
+            if(!b_bargraph_up) {
+              ht_bargraph.clearElement(12);
+              ht_bargraph.clearElement(15);
+            }
+
+            b_bargraph_up = true;
+
+            wandTipOn();
+          break;
+
+          case 1:
+            ht_bargraph.setElement(12);
+            ht_bargraph.setElement(15);
+
+            if(b_bargraph_up) {
+              ht_bargraph.clearElement(13);
+              ht_bargraph.clearElement(14);
+
+              i_bargraph_status_alt++;
+            }
+            else {
+              ht_bargraph.clearElement(11);
+              ht_bargraph.clearElement(16);
+
+              i_bargraph_status_alt--;
+            }
+
+            wandTipOn();
+          break;
+
+          case 2:
+            ht_bargraph.setElement(11);
+            ht_bargraph.setElement(16);
+
+            if(b_bargraph_up) {
+              ht_bargraph.clearElement(12);
+              ht_bargraph.clearElement(15);
+
+              i_bargraph_status_alt++;
+            }
+            else {
+              ht_bargraph.clearElement(10);
+              ht_bargraph.clearElement(17);
+
+              i_bargraph_status_alt--;
+            }
+
+            wandTipOff();
+          break;
+
+          case 3:
+            ht_bargraph.setElement(10);
+            ht_bargraph.setElement(17);
+
+            if(b_bargraph_up) {
+              ht_bargraph.clearElement(11);
+              ht_bargraph.clearElement(16);
+
+              i_bargraph_status_alt++;
+            }
+            else {
+              ht_bargraph.clearElement(9);
+              ht_bargraph.clearElement(18);
+
+              i_bargraph_status_alt--;
+            }
+
+            wandTipOff();
+          break;
+
+          case 4:
+            ht_bargraph.setElement(9);
+            ht_bargraph.setElement(18);
+
+            if(b_bargraph_up) {
+              ht_bargraph.clearElement(10);
+              ht_bargraph.clearElement(17);
+
+              i_bargraph_status_alt++;
+            }
+            else {
+              ht_bargraph.clearElement(8);
+              ht_bargraph.clearElement(19);
+
+              i_bargraph_status_alt--;
+            }
+
+            wandTipOn();
+          break;
+
+          case 5:
+            ht_bargraph.setElement(8);
+            ht_bargraph.setElement(19);
+
+            if(b_bargraph_up) {
+              ht_bargraph.clearElement(9);
+              ht_bargraph.clearElement(18);
+
+              i_bargraph_status_alt++;
+            }
+            else {
+              ht_bargraph.clearElement(7);
+              ht_bargraph.clearElement(20);
+
+              i_bargraph_status_alt--;
+            }
+
+            wandTipOn();
+          break;
+
+          case 6:
+            ht_bargraph.setElement(7);
+            ht_bargraph.setElement(20);
+
+            if(b_bargraph_up) {
+              ht_bargraph.clearElement(8);
+              ht_bargraph.clearElement(19);
+
+              i_bargraph_status_alt++;
+            }
+            else {
+              ht_bargraph.clearElement(6);
+              ht_bargraph.clearElement(21);
+
+              i_bargraph_status_alt--;
+            }
+
+            wandTipOff();
+          break;
+
+          case 7:
+            ht_bargraph.setElement(6);
+            ht_bargraph.setElement(21);
+
+            if(b_bargraph_up) {
+              ht_bargraph.clearElement(7);
+              ht_bargraph.clearElement(20);
+
+              i_bargraph_status_alt++;
+            }
+            else {
+              ht_bargraph.clearElement(5);
+              ht_bargraph.clearElement(22);
+
+              i_bargraph_status_alt--;
+            }
+
+            wandTipOff();
+          break;
+
+          case 8:
+            ht_bargraph.setElement(5);
+            ht_bargraph.setElement(22);
+
+            if(b_bargraph_up) {
+              ht_bargraph.clearElement(6);
+              ht_bargraph.clearElement(21);
+
+              i_bargraph_status_alt++;
+            }
+            else {
+              ht_bargraph.clearElement(4);
+              ht_bargraph.clearElement(23);
+
+              i_bargraph_status_alt--;
+            }
+
+            wandTipOn();
+          break;
+
+          case 9:
+            ht_bargraph.setElement(4);
+            ht_bargraph.setElement(23);
+
+            if(b_bargraph_up) {
+              ht_bargraph.clearElement(5);
+              ht_bargraph.clearElement(22);
+
+              i_bargraph_status_alt++;
+            }
+            else {
+              ht_bargraph.clearElement(3);
+              ht_bargraph.clearElement(24);
+
+              i_bargraph_status_alt--;
+            }
+
+            wandTipOn();
+          break;
+
+          case 10:
+            ht_bargraph.setElement(3);
+            ht_bargraph.setElement(24);
+
+            if(b_bargraph_up) {
+              ht_bargraph.clearElement(4);
+              ht_bargraph.clearElement(23);
+
+              i_bargraph_status_alt++;
+            }
+            else {
+              ht_bargraph.clearElement(2);
+              ht_bargraph.clearElement(25);
+
+              i_bargraph_status_alt--;
+            }
+
+            wandTipOff();
+          break;
+
+          case 11:
+            ht_bargraph.setElement(2);
+            ht_bargraph.setElement(25);
+
+            if(b_bargraph_up) {
+              ht_bargraph.clearElement(3);
+              ht_bargraph.clearElement(24);
+
+              i_bargraph_status_alt++;
+            }
+            else {
+              ht_bargraph.clearElement(1);
+              ht_bargraph.clearElement(26);
+
+              i_bargraph_status_alt--;
+            }
+
+            wandTipOff();
+          break;
+
+          case 12:
+            ht_bargraph.setElement(1);
+            ht_bargraph.setElement(26);
+
+            if(b_bargraph_up) {
+              ht_bargraph.clearElement(2);
+              ht_bargraph.clearElement(25);
+
+              i_bargraph_status_alt++;
+            }
+            else {
+              ht_bargraph.clearElement(0);
+              ht_bargraph.clearElement(27);
+
+              i_bargraph_status_alt--;
+            }
+
+            wandTipOn();
+          break;
+
+          case 13:
+            ht_bargraph.setElement(0);
+            ht_bargraph.setElement(27);
+
+            ht_bargraph.clearElement(1);
+            ht_bargraph.clearElement(26);
+
+            i_bargraph_status_alt--;
+
+            b_bargraph_up = false;
+
+            wandTipOn();
+          break;
+
+          default:
+            // We should not be here. Do nothing.
+          break;
+        }
+      }
+    }
+  #ifndef ESP32
+    else {
+      // Hasbro 5 LED Bargraph.
+      switch(i_bargraph_status) {
+        case 1:
+          digitalWriteFast(bargraphLookupTable(1-1), LOW);
+          digitalWriteFast(bargraphLookupTable(2-1), HIGH);
+          digitalWriteFast(bargraphLookupTable(3-1), HIGH);
+          digitalWriteFast(bargraphLookupTable(4-1), HIGH);
+          digitalWriteFast(bargraphLookupTable(5-1), LOW);
+          i_bargraph_status++;
+
+          wandTipOn();
+        break;
+
+        case 2:
+          digitalWriteFast(bargraphLookupTable(1-1), HIGH);
+          digitalWriteFast(bargraphLookupTable(2-1), LOW);
+          digitalWriteFast(bargraphLookupTable(3-1), HIGH);
+          digitalWriteFast(bargraphLookupTable(4-1), LOW);
+          digitalWriteFast(bargraphLookupTable(5-1), HIGH);
+          i_bargraph_status++;
+
+          wandTipOff();
+        break;
+
+        case 3:
+          digitalWriteFast(bargraphLookupTable(1-1), HIGH);
+          digitalWriteFast(bargraphLookupTable(2-1), HIGH);
+          digitalWriteFast(bargraphLookupTable(3-1), LOW);
+          digitalWriteFast(bargraphLookupTable(4-1), HIGH);
+          digitalWriteFast(bargraphLookupTable(5-1), HIGH);
+          i_bargraph_status++;
+
+          wandTipOn();
+        break;
+
+        case 4:
+          digitalWriteFast(bargraphLookupTable(1-1), HIGH);
+          digitalWriteFast(bargraphLookupTable(2-1), LOW);
+          digitalWriteFast(bargraphLookupTable(3-1), HIGH);
+          digitalWriteFast(bargraphLookupTable(4-1), LOW);
+          digitalWriteFast(bargraphLookupTable(5-1), HIGH);
+          i_bargraph_status++;
+
+          wandTipOff();
+        break;
+
+        case 5:
+          digitalWriteFast(bargraphLookupTable(1-1), LOW);
+          digitalWriteFast(bargraphLookupTable(2-1), HIGH);
+          digitalWriteFast(bargraphLookupTable(3-1), HIGH);
+          digitalWriteFast(bargraphLookupTable(4-1), HIGH);
+          digitalWriteFast(bargraphLookupTable(5-1), LOW);
+          i_bargraph_status = 1;
+
+          wandTipOn();
+        break;
+      }
+    }
+  #endif
+  }
+
+  void bargraphModeOriginalRampFiringAnimation() {
+    if(BARGRAPH_TYPE == SEGMENTS_28 || BARGRAPH_TYPE == SEGMENTS_30) {
+      /*
+        // For 28 Segments
+        Power Level 5: full: 23 - 27  (5 segments)
+        Power Level 4: 3/4: 17 - 22   (6 segments)
+        Power Level 3: 1/2: 12 - 16   (5 segments)
+        Power Level 2: 1/4: 5 - 11    (7 segments)
+        Power Level 1: none: 0 - 4    (5 segments)
+      */
+
+      /*
+        // 30 Segment bargraph.
+        Power Level 5: full: 24 - 29  (6 segments)
+        Power Level 4: 3/4: 18 - 23   (6 segments)
+        Power Level 3: 1/2: 12 - 17   (6 segments)
+        Power Level 2: 1/4: 6 - 11    (6 segments)
+        Power Level 1: none: 0 - 5    (6 segments)
+      */
+
+      uint8_t i_segment_adjust = 2;
+
+      if(BARGRAPH_TYPE == SEGMENTS_30) {
+        i_segment_adjust = 0;
+      }
+
+      // When firing starts, i_bargraph_status_alt resets to 0 in modeFireStart();
+      if(i_bargraph_status_alt == 0) {
+        // Set our target.
+        switch(gpstarWand.getPowerLevel()) {
+          case LEVEL_5:
+          default:
+            i_bargraph_status_alt = random(18, i_bargraph_segments - i_segment_adjust);
+          break;
+
+          case LEVEL_4:
+            i_bargraph_status_alt = random(13, 25);
+          break;
+
+          case LEVEL_3:
+            i_bargraph_status_alt = random(9, 19);
+          break;
+
+          case LEVEL_2:
+            i_bargraph_status_alt = random(3, 13);
+          break;
+
+          case LEVEL_1:
+            // Not used in MODE_ORIGINAL.
+            //i_bargraph_status_alt = random(0, 6);
+          break;
+        }
+      }
+
+      bool b_tmp_down = true;
+
+      for(uint8_t i = 0; i < i_bargraph_segments - i_segment_adjust; i++) {
+        if(!ht_bargraph.getElement(i) && i < i_bargraph_status_alt) {
+          b_tmp_down = false;
+          break;
+        }
+      }
+
+      switch(gpstarWand.getPowerLevel()) {
+        case LEVEL_5:
+        default:
+          if(b_tmp_down) {
+            // Moving down.
+            for(uint8_t i = i_bargraph_segments - (i_segment_adjust + 1); i >= i_bargraph_status_alt; i--) {
+              if(i_bargraph_status_alt == i) {
+                switch(i_cyclotron_multiplier) {
+                  case 5:
+                    i_bargraph_status_alt = random(6, i_bargraph_segments - i_segment_adjust);
+                  break;
+
+                  case 4:
+                    i_bargraph_status_alt = random(9, i_bargraph_segments - i_segment_adjust);
+                  break;
+
+                  case 3:
+                    i_bargraph_status_alt = random(12, i_bargraph_segments - i_segment_adjust);
+                  break;
+
+                  case 2:
+                    i_bargraph_status_alt = random(15, i_bargraph_segments - i_segment_adjust);
+                  break;
+
+                  case 1:
+                  default:
+                    i_bargraph_status_alt = random(18, i_bargraph_segments - i_segment_adjust);
+                  break;
+                }
+              }
+
+              if(ht_bargraph.getElement(i)) {
+                ht_bargraph.clearElement(i);
+
+                break;
+              }
+            }
+          }
+          else {
+            // Need to move up.
+            for(uint8_t i = 0; i <= i_bargraph_status_alt; i++) {
+              if(i_bargraph_status_alt == i) {
+                switch(i_cyclotron_multiplier) {
+                  case 5:
+                    i_bargraph_status_alt = random(8, i_bargraph_segments - i_segment_adjust);
+                  break;
+
+                  case 4:
+                    i_bargraph_status_alt = random(12, i_bargraph_segments - i_segment_adjust);
+                  break;
+
+                  case 3:
+                    i_bargraph_status_alt = random(14, i_bargraph_segments - i_segment_adjust);
+                  break;
+
+                  case 2:
+                    i_bargraph_status_alt = random(16, i_bargraph_segments - i_segment_adjust);
+                  break;
+
+                  case 1:
+                    i_bargraph_status_alt = random(18, i_bargraph_segments - i_segment_adjust);
+                  break;
+
+                  default:
+                    i_bargraph_status_alt = random(0, i_bargraph_segments - i_segment_adjust);
+                  break;
+                }
+              }
+
+              if(!ht_bargraph.getElement(i)) {
+                ht_bargraph.setElement(i);
+
+                break;
+              }
+            }
+          }
+        break;
+
+        case LEVEL_4:
+          if(b_tmp_down) {
+            // Moving down.
+            for(uint8_t i = 25; i >= i_bargraph_status_alt; i--) {
+              if(i_bargraph_status_alt == i) {
+                switch(i_cyclotron_multiplier) {
+                  case 5:
+                    i_bargraph_status_alt = random(1, 25);
+                  break;
+
+                  case 4:
+                    i_bargraph_status_alt = random(4, 25);
+                  break;
+
+                  case 3:
+                    i_bargraph_status_alt = random(7, 25);
+                  break;
+
+                  case 2:
+                    i_bargraph_status_alt = random(10, 25);
+                  break;
+
+                  case 1:
+                    i_bargraph_status_alt = random(13, 25);
+                  break;
+
+                  default:
+                    i_bargraph_status_alt = random(0, 25);
+                  break;
+                }
+              }
+
+              if(ht_bargraph.getElement(i)) {
+                ht_bargraph.clearElement(i);
+
+                break;
+              }
+            }
+          }
+          else {
+            // Need to move up.
+            for(uint8_t i = 0; i <= i_bargraph_status_alt; i++) {
+              if(i_bargraph_status_alt == i) {
+                switch(i_cyclotron_multiplier) {
+                  case 5:
+                    i_bargraph_status_alt = random(1, 25);
+                  break;
+
+                  case 4:
+                    i_bargraph_status_alt = random(4, 25);
+                  break;
+
+                  case 3:
+                    i_bargraph_status_alt = random(7, 25);
+                  break;
+
+                  case 2:
+                    i_bargraph_status_alt = random(10, 25);
+                  break;
+
+                  case 1:
+                    i_bargraph_status_alt = random(13, 25);
+                  break;
+
+                  default:
+                    i_bargraph_status_alt = random(0, 25);
+                  break;
+                }
+              }
+
+              if(!ht_bargraph.getElement(i)) {
+                ht_bargraph.setElement(i);
+
+                break;
+              }
+            }
+          }
+        break;
+
+        case LEVEL_3:
+          if(b_tmp_down) {
+            // Moving down.
+            for(uint8_t i = 19; i >= i_bargraph_status_alt; i--) {
+              if(i_bargraph_status_alt == i) {
+                switch(i_cyclotron_multiplier) {
+                  case 5:
+                    i_bargraph_status_alt = random(1, 19);
+                  break;
+
+                  case 4:
+                    i_bargraph_status_alt = random(3, 19);
+                  break;
+
+                  case 3:
+                    i_bargraph_status_alt = random(5, 19);
+                  break;
+
+                  case 2:
+                    i_bargraph_status_alt = random(7, 19);
+                  break;
+
+                  case 1:
+                    i_bargraph_status_alt = random(9, 19);
+                  break;
+
+                  default:
+                    i_bargraph_status_alt = random(0, 19);
+                  break;
+                }
+              }
+
+              if(ht_bargraph.getElement(i)) {
+                ht_bargraph.clearElement(i);
+
+                break;
+              }
+            }
+          }
+          else {
+            // Need to move up.
+            for(uint8_t i = 0; i <= i_bargraph_status_alt; i++) {
+              if(i_bargraph_status_alt == i) {
+                switch(i_cyclotron_multiplier) {
+                  case 5:
+                    i_bargraph_status_alt = random(1, 19);
+                  break;
+
+                  case 4:
+                    i_bargraph_status_alt = random(3, 19);
+                  break;
+
+                  case 3:
+                    i_bargraph_status_alt = random(5, 19);
+                  break;
+
+                  case 2:
+                    i_bargraph_status_alt = random(7, 19);
+                  break;
+
+                  case 1:
+                    i_bargraph_status_alt = random(9, 19);
+                  break;
+
+                  default:
+                    i_bargraph_status_alt = random(0, 19);
+                  break;
+                }
+              }
+
+              if(!ht_bargraph.getElement(i)) {
+                ht_bargraph.setElement(i);
+
+                break;
+              }
+            }
+          }
+        break;
+
+        case LEVEL_2:
+          if(b_tmp_down) {
+            // Moving down.
+            for(uint8_t i = 13; i >= i_bargraph_status_alt; i--) {
+              if(i_bargraph_status_alt == i) {
+                switch(i_cyclotron_multiplier) {
+                  case 5:
+                    i_bargraph_status_alt = random(1, 13);
+                  break;
+
+                  case 4:
+                    i_bargraph_status_alt = random(2, 13);
+                  break;
+
+                  case 3:
+                  case 2:
+                  case 1:
+                    i_bargraph_status_alt = random(3, 13);
+                  break;
+
+                  default:
+                    i_bargraph_status_alt = random(0, 13);
+                  break;
+                }
+              }
+
+              if(ht_bargraph.getElement(i)) {
+                ht_bargraph.clearElement(i);
+
+                break;
+              }
+            }
+          }
+          else {
+            // Need to move up.
+            for(uint8_t i = 0; i <= i_bargraph_status_alt; i++) {
+              if(i_bargraph_status_alt == i) {
+                switch(i_cyclotron_multiplier) {
+                  case 5:
+                    i_bargraph_status_alt = random(1, 13);
+                  break;
+
+                  case 4:
+                    i_bargraph_status_alt = random(2, 13);
+                  break;
+
+                  case 3:
+                  case 2:
+                  case 1:
+                    i_bargraph_status_alt = random(3, 13);
+                  break;
+
+                  default:
+                    i_bargraph_status_alt = random(0, 13);
+                  break;
+                }
+              }
+
+              if(!ht_bargraph.getElement(i)) {
+                ht_bargraph.setElement(i);
+
+                break;
+              }
+            }
+          }
+        break;
+
+        case LEVEL_1:
+          if(b_tmp_down) {
+            // Moving down.
+            for(uint8_t i = 7; i >= i_bargraph_status_alt; i--) {
+              if(i_bargraph_status_alt == i) {
+                switch(i_cyclotron_multiplier) {
+                  case 5:
+                    i_bargraph_status_alt = random(0, 10);
+                  break;
+
+                  case 4:
+                    i_bargraph_status_alt = random(0, 9);
+                  break;
+
+                  case 3:
+                  case 2:
+                  case 1:
+                    i_bargraph_status_alt = random(0, 8);
+                  break;
+
+                  default:
+                    i_bargraph_status_alt = random(0, 7);
+                  break;
+                }
+              }
+
+              if(ht_bargraph.getElement(i)) {
+                ht_bargraph.clearElement(i);
+
+                break;
+              }
+            }
+          }
+          else {
+            // Need to move up.
+            for(uint8_t i = 0; i <= i_bargraph_status_alt; i++) {
+              if(i_bargraph_status_alt == i) {
+                switch(i_cyclotron_multiplier) {
+                  case 5:
+                    i_bargraph_status_alt = random(0, 10);
+                  break;
+
+                  case 4:
+                    i_bargraph_status_alt = random(0, 9);
+                  break;
+
+                  case 3:
+                  case 2:
+                  case 1:
+                    i_bargraph_status_alt = random(0, 8);
+                  break;
+
+                  default:
+                    i_bargraph_status_alt = random(0, 7);
+                  break;
+                }
+              }
+
+              if(!ht_bargraph.getElement(i)) {
+                ht_bargraph.setElement(i);
+
+                break;
+              }
+            }
+          }
+        break;
+      }
+    }
+    else {
+      // When firing starts, i_bargraph_status resets to 0 in modeFireStart();
+      if(i_bargraph_status == 0) {
+        // Set our target.
+        switch(gpstarWand.getPowerLevel()) {
+          case LEVEL_5:
+          default:
+            i_bargraph_status = random(2, i_bargraph_segments_5_led + 1);
+          break;
+
+          case LEVEL_4:
+            i_bargraph_status = random(2, i_bargraph_segments_5_led);
+          break;
+
+          case LEVEL_3:
+            i_bargraph_status = random(1, i_bargraph_segments_5_led - 1);
+          break;
+
+          case LEVEL_2:
+            i_bargraph_status = random(0, i_bargraph_segments_5_led - 2);
+          break;
+
+          case LEVEL_1:
+            i_bargraph_status = random(0, i_bargraph_segments_5_led - 3);
+          break;
+        }
+      }
+
+      bool b_tmp_down = true;
+
+      for(uint8_t i = 0; i < i_bargraph_segments_5_led; i++) {
+        if(digitalReadFast(bargraphLookupTable(i)) == HIGH && i <= i_bargraph_status) {
+          b_tmp_down = false;
+          break;
+        }
+      }
+
+      switch(gpstarWand.getPowerLevel()) {
+        case LEVEL_5:
+        default:
+          if(b_tmp_down) {
+            // Moving down.
+            for(uint8_t i = i_bargraph_segments_5_led; i >= i_bargraph_status; i--) {
+              if(i_bargraph_status == i) {
+                switch(i_cyclotron_multiplier) {
+                  case 5:
+                    i_bargraph_status = random(1, i_bargraph_segments_5_led + 1);
+                  break;
+
+                  case 4:
+                    i_bargraph_status = random(1, i_bargraph_segments_5_led + 1);
+                  break;
+
+                  case 3:
+                    i_bargraph_status = random(1, i_bargraph_segments_5_led + 1);
+                  break;
+
+                  case 2:
+                    i_bargraph_status = random(2, i_bargraph_segments_5_led + 1);
+                  break;
+
+                  case 1:
+                  default:
+                    i_bargraph_status = random(2, i_bargraph_segments_5_led + 1);
+                  break;
+                }
+              }
+
+
+              if(digitalReadFast(bargraphLookupTable(i-1)) == LOW) {
+                wandBargraphControl(i-1);
+                break;
+              }
+            }
+          }
+          else {
+            // Need to move up.
+            for(uint8_t i = 0; i <= i_bargraph_status; i++) {
+              if(i_bargraph_status == i) {
+                switch(i_cyclotron_multiplier) {
+                  case 5:
+                    i_bargraph_status = random(0, i_bargraph_segments_5_led + 1);
+                  break;
+
+                  case 4:
+                    i_bargraph_status = random(0, i_bargraph_segments_5_led + 1);
+                  break;
+
+                  case 3:
+                    i_bargraph_status = random(1, i_bargraph_segments_5_led + 1);
+                  break;
+
+                  case 2:
+                    i_bargraph_status = random(2, i_bargraph_segments_5_led + 1);
+                  break;
+
+                  case 1:
+                  default:
+                    i_bargraph_status = random(2, i_bargraph_segments_5_led + 1);
+                  break;
+                }
+              }
+
+              if(digitalReadFast(bargraphLookupTable(i)) == HIGH) {
+                wandBargraphControl(i+1);
+                break;
+              }
+            }
+          }
+        break;
+
+        case LEVEL_4:
+          if(b_tmp_down) {
+            // Moving down.
+            for(uint8_t i = i_bargraph_segments_5_led; i >= i_bargraph_status; i--) {
+              if(i_bargraph_status == i) {
+                switch(i_cyclotron_multiplier) {
+                  case 5:
+                    i_bargraph_status = random(1, i_bargraph_segments_5_led + 1);
+                  break;
+
+                  case 4:
+                    i_bargraph_status = random(1, i_bargraph_segments_5_led + 1);
+                  break;
+
+                  case 3:
+                    i_bargraph_status = random(1, i_bargraph_segments_5_led + 1);
+                  break;
+
+                  case 2:
+                    i_bargraph_status = random(2, i_bargraph_segments_5_led + 1);
+                  break;
+
+                  case 1:
+                  default:
+                    i_bargraph_status = random(2, i_bargraph_segments_5_led + 1);
+                  break;
+                }
+              }
+
+
+              if(digitalReadFast(bargraphLookupTable(i-1)) == LOW) {
+                wandBargraphControl(i-1);
+                break;
+              }
+            }
+          }
+          else {
+            // Need to move up.
+            for(uint8_t i = 0; i <= i_bargraph_status; i++) {
+              if(i_bargraph_status == i) {
+                switch(i_cyclotron_multiplier) {
+                  case 5:
+                    i_bargraph_status = random(0, i_bargraph_segments_5_led + 1);
+                  break;
+
+                  case 4:
+                    i_bargraph_status = random(0, i_bargraph_segments_5_led + 1);
+                  break;
+
+                  case 3:
+                    i_bargraph_status = random(1, i_bargraph_segments_5_led + 1);
+                  break;
+
+                  case 2:
+                    i_bargraph_status = random(2, i_bargraph_segments_5_led + 1);
+                  break;
+
+                  case 1:
+                  default:
+                    i_bargraph_status = random(2, i_bargraph_segments_5_led + 1);
+                  break;
+                }
+              }
+
+              if(digitalReadFast(bargraphLookupTable(i)) == HIGH) {
+                wandBargraphControl(i+1);
+                break;
+              }
+            }
+          }
+        break;
+
+        case LEVEL_3:
+          if(b_tmp_down) {
+            // Moving down.
+            for(uint8_t i = i_bargraph_segments_5_led; i >= i_bargraph_status; i--) {
+              if(i_bargraph_status == i) {
+                switch(i_cyclotron_multiplier) {
+                  case 5:
+                    i_bargraph_status = random(1, i_bargraph_segments_5_led + 1);
+                  break;
+
+                  case 4:
+                    i_bargraph_status = random(1, i_bargraph_segments_5_led + 1);
+                  break;
+
+                  case 3:
+                    i_bargraph_status = random(1, i_bargraph_segments_5_led + 1);
+                  break;
+
+                  case 2:
+                    i_bargraph_status = random(1, i_bargraph_segments_5_led - 1);
+                  break;
+
+                  case 1:
+                  default:
+                    i_bargraph_status = random(1, i_bargraph_segments_5_led - 1);
+                  break;
+                }
+              }
+
+
+              if(digitalReadFast(bargraphLookupTable(i-1)) == LOW) {
+                wandBargraphControl(i-1);
+                break;
+              }
+            }
+          }
+          else {
+            // Need to move up.
+            for(uint8_t i = 0; i <= i_bargraph_status; i++) {
+              if(i_bargraph_status == i) {
+                switch(i_cyclotron_multiplier) {
+                  case 5:
+                    i_bargraph_status = random(0, i_bargraph_segments_5_led + 1);
+                  break;
+
+                  case 4:
+                    i_bargraph_status = random(0, i_bargraph_segments_5_led + 1);
+                  break;
+
+                  case 3:
+                    i_bargraph_status = random(1, i_bargraph_segments_5_led + 1);
+                  break;
+
+                  case 2:
+                    i_bargraph_status = random(1, i_bargraph_segments_5_led - 1);
+                  break;
+
+                  case 1:
+                  default:
+                    i_bargraph_status = random(1, i_bargraph_segments_5_led - 1);
+                  break;
+                }
+              }
+
+              if(digitalReadFast(bargraphLookupTable(i)) == HIGH) {
+                wandBargraphControl(i+1);
+                break;
+              }
+            }
+          }
+        break;
+
+        case LEVEL_2:
+          if(b_tmp_down) {
+            // Moving down.
+            for(uint8_t i = i_bargraph_segments_5_led; i >= i_bargraph_status; i--) {
+              if(i_bargraph_status == i) {
+                switch(i_cyclotron_multiplier) {
+                  case 5:
+                    i_bargraph_status = random(0, i_bargraph_segments_5_led + 1);
+                  break;
+
+                  case 4:
+                    i_bargraph_status = random(0, i_bargraph_segments_5_led + 1);
+                  break;
+
+                  case 3:
+                    i_bargraph_status = random(0, i_bargraph_segments_5_led + 1);
+                  break;
+
+                  case 2:
+                    i_bargraph_status = random(0, i_bargraph_segments_5_led + 1);
+                  break;
+
+                  case 1:
+                  default:
+                    i_bargraph_status = random(0, i_bargraph_segments_5_led - 2);
+                  break;
+                }
+              }
+
+
+              if(digitalReadFast(bargraphLookupTable(i-1)) == LOW) {
+                wandBargraphControl(i-1);
+                break;
+              }
+            }
+          }
+          else {
+            // Need to move up.
+            for(uint8_t i = 0; i <= i_bargraph_status; i++) {
+              if(i_bargraph_status == i) {
+                switch(i_cyclotron_multiplier) {
+                  case 5:
+                    i_bargraph_status = random(0, i_bargraph_segments_5_led + 1);
+                  break;
+
+                  case 4:
+                    i_bargraph_status = random(0, i_bargraph_segments_5_led + 1);
+                  break;
+
+                  case 3:
+                    i_bargraph_status = random(1, i_bargraph_segments_5_led + 1);
+                  break;
+
+                  case 2:
+                    i_bargraph_status = random(0, i_bargraph_segments_5_led - 2);
+                  break;
+
+                  case 1:
+                  default:
+                    i_bargraph_status = random(0, i_bargraph_segments_5_led - 2);
+                  break;
+                }
+              }
+
+              if(digitalReadFast(bargraphLookupTable(i)) == HIGH) {
+                wandBargraphControl(i+1);
+                break;
+              }
+            }
+          }
+        break;
+
+        case LEVEL_1:
+          if(b_tmp_down) {
+            // Moving down.
+            for(uint8_t i = i_bargraph_segments_5_led; i >= i_bargraph_status; i--) {
+              if(i_bargraph_status == i) {
+                switch(i_cyclotron_multiplier) {
+                  case 5:
+                    i_bargraph_status = random(0, i_bargraph_segments_5_led + 1);
+                  break;
+
+                  case 4:
+                    i_bargraph_status = random(0, i_bargraph_segments_5_led + 1);
+                  break;
+
+                  case 3:
+                    i_bargraph_status = random(0, i_bargraph_segments_5_led);
+                  break;
+
+                  case 2:
+                    i_bargraph_status = random(0, i_bargraph_segments_5_led - 2);
+                  break;
+
+                  case 1:
+                  default:
+                    i_bargraph_status = random(0, i_bargraph_segments_5_led - 2);
+                  break;
+                }
+              }
+
+              if(digitalReadFast(bargraphLookupTable(i-1)) == LOW) {
+                wandBargraphControl(i-1);
+                break;
+              }
+            }
+          }
+          else {
+            // Need to move up.
+            for(uint8_t i = 0; i <= i_bargraph_status; i++) {
+              if(i_bargraph_status == i) {
+                switch(i_cyclotron_multiplier) {
+                  case 5:
+                    i_bargraph_status = random(0, i_bargraph_segments_5_led + 1);
+                  break;
+
+                  case 4:
+                    i_bargraph_status = random(0, i_bargraph_segments_5_led + 1);
+                  break;
+
+                  case 3:
+                    i_bargraph_status = random(0, i_bargraph_segments_5_led);
+                  break;
+
+                  case 2:
+                    i_bargraph_status = random(0, i_bargraph_segments_5_led - 2);
+                  break;
+
+                  case 1:
+                  default:
+                    i_bargraph_status = random(0, i_bargraph_segments_5_led - 2);
+                  break;
+                }
+              }
+
+              if(digitalReadFast(bargraphLookupTable(i)) == HIGH) {
+                wandBargraphControl(i+1);
+                break;
+              }
+            }
+          }
+        break;
+      }
+    }
+  }
+
+  void bargraphRampFiring() {
+    switch(BARGRAPH_FIRING_ANIMATION) {
+      case BARGRAPH_ANIMATION_SUPER_HERO:
+        bargraphSuperHeroRampFiringAnimation();
+      break;
+      case BARGRAPH_ANIMATION_ORIGINAL:
+      default:
+        bargraphModeOriginalRampFiringAnimation();
+
+        // Strobe the optional tip light on even barrel LED numbers.
+        if((i_barrel_light & 0x01) == 0) {
+          wandTipOn();
+        }
+        else {
+          wandTipOff();
+        }
+      break;
+    }
+
+    uint8_t i_ramp_interval = i_bargraph_ramp_interval;
+
+    if(BARGRAPH_TYPE == SEGMENTS_28 || BARGRAPH_TYPE == SEGMENTS_30) {
+      // Switch to a different ramp speed if using the 28 or 30 segment bargraph.
+      i_ramp_interval = i_bargraph_ramp_interval_alt;
+    }
+
+    // If in a power level on the wand that can overheat, change the speed of the bargraph ramp during firing based on time remaining before we overheat.
+    if(ms_overheat_initiate.isRunning()) {
+      if(ms_overheat_initiate.remaining() < i_ms_overheat_initiate[(uint8_t)gpstarWand.getPowerLevel() - 1] / 6) {
+        if(BARGRAPH_TYPE == SEGMENTS_28 || BARGRAPH_TYPE == SEGMENTS_30) {
+          ms_bargraph_firing.start((i_ramp_interval / 8) + 2); // 7ms per segment
+        }
+        else {
+          ms_bargraph_firing.start(i_ramp_interval / 5); // 24ms per LED
+        }
+
+        cyclotronSpeedUp(6);
+      }
+      else if(ms_overheat_initiate.remaining() < i_ms_overheat_initiate[(uint8_t)gpstarWand.getPowerLevel() - 1] / 5) {
+        if(BARGRAPH_TYPE == SEGMENTS_28 || BARGRAPH_TYPE == SEGMENTS_30) {
+          ms_bargraph_firing.start((i_ramp_interval / 8) + 4); // 9ms per segment
+        }
+        else {
+          ms_bargraph_firing.start(i_ramp_interval / 4); // 30ms per LED
+        }
+
+        cyclotronSpeedUp(5);
+      }
+      else if(ms_overheat_initiate.remaining() < i_ms_overheat_initiate[(uint8_t)gpstarWand.getPowerLevel() - 1] / 4) {
+        if(BARGRAPH_TYPE == SEGMENTS_28 || BARGRAPH_TYPE == SEGMENTS_30) {
+          ms_bargraph_firing.start((i_ramp_interval / 4) + 1); // 11ms per segment
+        }
+        else {
+          ms_bargraph_firing.start(i_ramp_interval / 3); // 40ms per LED
+        }
+
+        cyclotronSpeedUp(4);
+      }
+      else if(ms_overheat_initiate.remaining() < i_ms_overheat_initiate[(uint8_t)gpstarWand.getPowerLevel() - 1] / 3) {
+        if(BARGRAPH_TYPE == SEGMENTS_28 || BARGRAPH_TYPE == SEGMENTS_30) {
+          ms_bargraph_firing.start((i_ramp_interval / 4) + 3); // 13ms per segment
+        }
+        else {
+          ms_bargraph_firing.start((i_ramp_interval / 2) - 10); // 50ms per LED
+        }
+
+        cyclotronSpeedUp(3);
+      }
+      else if(ms_overheat_initiate.remaining() < i_ms_overheat_initiate[(uint8_t)gpstarWand.getPowerLevel() - 1] / 2) {
+        if(BARGRAPH_TYPE == SEGMENTS_28 || BARGRAPH_TYPE == SEGMENTS_30) {
+          ms_bargraph_firing.start((i_ramp_interval / 4) + 5); // 15ms per segment
+        }
+        else {
+          ms_bargraph_firing.start(i_ramp_interval / 2); // 60ms per LED
+        }
+
+        cyclotronSpeedUp(2);
+      }
+      else {
+        if(BARGRAPH_TYPE == SEGMENTS_28 || BARGRAPH_TYPE == SEGMENTS_30) {
+          switch(gpstarWand.getPowerLevel()) {
+            case LEVEL_5:
+            default:
+              ms_bargraph_firing.start((i_ramp_interval / 2) - 5); // 15ms per segment
+            break;
+
+            case LEVEL_4:
+              ms_bargraph_firing.start(i_ramp_interval / 2); // 20ms per segment
+            break;
+
+            case LEVEL_3:
+              ms_bargraph_firing.start((i_ramp_interval / 2) + 5); // 25ms per segment
+            break;
+
+            case LEVEL_2:
+              ms_bargraph_firing.start((i_ramp_interval / 2) + 10); // 30ms per segment
+            break;
+
+            case LEVEL_1:
+              ms_bargraph_firing.start((i_ramp_interval / 2) + 15); // 35ms per segment
+            break;
+          }
+        }
+        else {
+          if(BARGRAPH_FIRING_ANIMATION == BARGRAPH_ANIMATION_ORIGINAL) {
+            switch(gpstarWand.getPowerLevel()) {
+              case LEVEL_5:
+              default:
+                ms_bargraph_firing.start(i_ramp_interval / 2); // 60ms per LED
+              break;
+
+              case LEVEL_4:
+                ms_bargraph_firing.start((i_ramp_interval / 2) + 30); // 90ms per LED
+              break;
+
+              case LEVEL_3:
+                ms_bargraph_firing.start(i_ramp_interval); // 120ms per LED
+              break;
+
+              case LEVEL_2:
+                ms_bargraph_firing.start(i_ramp_interval * 2); // 240ms per LED
+              break;
+
+              case LEVEL_1:
+                ms_bargraph_firing.start(i_ramp_interval * 3); // 360ms per LED
+              break;
+            }
+          }
+          else {
+            ms_bargraph_firing.start(i_ramp_interval / 2); // 60ms per LED
+          }
+        }
+
+        i_cyclotron_multiplier = 1;
+      }
+    }
+    else {
+      if(BARGRAPH_TYPE == SEGMENTS_28 || BARGRAPH_TYPE == SEGMENTS_30) {
+        switch(gpstarWand.getPowerLevel()) {
+          case LEVEL_5:
+          default:
+            ms_bargraph_firing.start((i_ramp_interval / 2) - 7); // 13ms per segment
+          break;
+
+          case LEVEL_4:
+            ms_bargraph_firing.start((i_ramp_interval / 2) - 3); // 15ms per segment
+          break;
+
+          case LEVEL_3:
+            ms_bargraph_firing.start(i_ramp_interval / 2); // 20ms per segment
+          break;
+
+          case LEVEL_2:
+            ms_bargraph_firing.start((i_ramp_interval / 2) + 7); // 25ms per segment
+          break;
+
+          case LEVEL_1:
+            ms_bargraph_firing.start((i_ramp_interval / 2) + 12); // 30ms per segment
+          break;
+        }
+      }
+      else {
+        if(BARGRAPH_FIRING_ANIMATION == BARGRAPH_ANIMATION_ORIGINAL) {
+          switch(gpstarWand.getPowerLevel()) {
+            case LEVEL_5:
+            default:
+              ms_bargraph_firing.start(i_ramp_interval / 2); // 60ms per LED
+            break;
+
+            case LEVEL_4:
+              ms_bargraph_firing.start((i_ramp_interval / 2) + 30); // 90ms per LED
+            break;
+
+            case LEVEL_3:
+              ms_bargraph_firing.start(i_ramp_interval); // 120ms per LED
+            break;
+
+            case LEVEL_2:
+              ms_bargraph_firing.start(i_ramp_interval * 2); // 240ms per LED
+            break;
+
+            case LEVEL_1:
+              ms_bargraph_firing.start(i_ramp_interval * 3); // 360ms per LED
+            break;
+          }
+        }
+        else {
+          ms_bargraph_firing.start(i_ramp_interval / 2); // 60ms per LED
+        }
+      }
+    }
+  }
+}
+
+/*
+ * After: the library calls System.h now makes, with the wand's globals passed in. Only the argument
+ * binding lives here; the steps themselves are the BargraphSequence code the wand links.
+ */
+namespace after {
+  using namespace wand;
+
+  void bargraph5LedWrite(uint8_t i_element, bool b_on) {
+    digitalWriteFast(bargraphLookupTable(i_element), b_on ? LOW : HIGH);
+  }
+
+  void powerSweep() {
+    bargraphPowerSweepUpdate(ms_bargraph_alt, ht_bargraph, (uint8_t)gpstarWand.getPowerLevel(), BARGRAPH_MODE == BARGRAPH_ORIGINAL, i_bargraph_status_alt, b_bargraph_up, i_bargraph_interval, i_bargraph_wait);
+  }
+
+  void superHeroStep() {
+    bargraph_player.advance(bargraphSuperHeroSequence(BARGRAPH_TYPE));
+
+    if(BARGRAPH_TYPE == SEGMENTS_28 || BARGRAPH_TYPE == SEGMENTS_30) {
+      bargraph_player.draw(ht_bargraph, ht_bargraph.getElementCount());
+    }
+    else {
+      bargraph_player.draw(bargraph5LedWrite, i_bargraph_segments_5_led);
+    }
+
+    b_tip = (bargraph_player.getFlags() & BARGRAPH_FRAME_TIP) != 0;
+  }
+
+  void modeOriginalStep() {
+    if(BARGRAPH_TYPE == SEGMENTS_28 || BARGRAPH_TYPE == SEGMENTS_30) {
+      bargraphOriginalWalkStep(ht_bargraph, (uint8_t)gpstarWand.getPowerLevel(), i_cyclotron_multiplier, i_bargraph_status_alt, random);
+      return;
+    }
+
+    uint32_t i_lit = 0;
+
+    for(uint8_t i = 0; i < i_bargraph_segments_5_led; i++) {
+      if(i_pins[i] == LOW) {
+        i_lit |= (uint32_t)1 << i;
+      }
+    }
+
+    uint8_t i_fill = bargraphOriginalFillStep(i_lit, (uint8_t)gpstarWand.getPowerLevel(), i_cyclotron_multiplier, i_bargraph_status, random);
+
+    if(i_fill != BARGRAPH_WALK_END) {
+      wandBargraphControl(i_fill);
+    }
+  }
+
+  void rampFiringStep() {
+    if(BARGRAPH_FIRING_ANIMATION == BARGRAPH_ANIMATION_SUPER_HERO) {
+      superHeroStep();
+    }
+    else {
+      modeOriginalStep();
+      b_tip = (i_barrel_light & 0x01) == 0;
+    }
+
+    uint8_t i_stage = bargraphFiringStage(ms_overheat_initiate.isRunning(), ms_overheat_initiate.remaining(), i_ms_overheat_initiate[(uint8_t)gpstarWand.getPowerLevel() - 1]);
+
+    ms_bargraph_firing.start(bargraphFiringStepTime(bargraphFiringTiming(BARGRAPH_TYPE, BARGRAPH_FIRING_ANIMATION == BARGRAPH_ANIMATION_ORIGINAL), (uint8_t)gpstarWand.getPowerLevel(), i_stage));
+
+    if(i_stage > 1) {
+      cyclotronSpeedUp(i_stage);
+    }
+    else if(i_stage == 1) {
+      i_cyclotron_multiplier = 1;
+    }
+  }
+}
+
+// Everything the functions read or change.
+struct WandState {
+  uint32_t mask = 0;
+  uint8_t pins[5] = {wand::HIGH, wand::HIGH, wand::HIGH, wand::HIGH, wand::HIGH};
+  uint8_t status = 0;
+  uint8_t status_alt = 0;
+  bool up = false;
+  uint8_t multiplier = 1;
+  bool tip = false;
+  std::vector<uint8_t> speed_ups;
+  FakeDelay alt;
+  FakeDelay firing;
+  uint32_t seed = 1;
+};
+
+static uint32_t elementMask(const BargraphDriver& bargraph) {
+  uint32_t mask = 0;
+
+  for(uint8_t i = 0; i < bargraph.getElementCount(); i++) {
+    if(bargraph.getElement(i)) {
+      mask |= (uint32_t)1 << i;
+    }
+  }
+
+  return mask;
+}
+
+static uint8_t pinMask() {
+  uint8_t mask = 0;
+
+  for(uint8_t i = 0; i < 5; i++) {
+    if(wand::i_pins[i] == wand::LOW) {
+      mask |= 1 << i;
+    }
+  }
+
+  return mask;
+}
+
+static WandState saveState() {
+  WandState s;
+  s.mask = elementMask(wand::ht_bargraph);
+  memcpy(s.pins, wand::i_pins, sizeof(s.pins));
+  s.status = wand::i_bargraph_status;
+  s.status_alt = wand::i_bargraph_status_alt;
+  s.up = wand::b_bargraph_up;
+  s.multiplier = wand::i_cyclotron_multiplier;
+  s.tip = wand::b_tip;
+  s.speed_ups = wand::i_speed_ups;
+  s.alt = wand::ms_bargraph_alt;
+  s.firing = wand::ms_bargraph_firing;
+  s.seed = g_seed;
+  return s;
+}
+
+static void loadState(const WandState& s) {
+  wand::ht_bargraph.clearAll();
+
+  for(uint8_t i = 0; i < wand::ht_bargraph.getElementCount(); i++) {
+    if((s.mask >> i) & 0x01) {
+      wand::ht_bargraph.setElement(i);
+    }
+  }
+
+  memcpy(wand::i_pins, s.pins, sizeof(s.pins));
+  wand::i_bargraph_status = s.status;
+  wand::i_bargraph_status_alt = s.status_alt;
+  wand::b_bargraph_up = s.up;
+  wand::i_cyclotron_multiplier = s.multiplier;
+  wand::b_tip = s.tip;
+  wand::i_speed_ups = s.speed_ups;
+  wand::ms_bargraph_alt = s.alt;
+  wand::ms_bargraph_firing = s.firing;
+  g_seed = s.seed;
+}
+
+static std::string describe(const WandState& s) {
+  char buffer[200];
+  snprintf(buffer, sizeof(buffer), "mask %08x pins %u%u%u%u%u status %u alt %u up %d multiplier %u tip %d alt timer %d/%u firing timer %d/%u seed %u speed ups",
+           (unsigned)s.mask, s.pins[0], s.pins[1], s.pins[2], s.pins[3], s.pins[4], s.status, s.status_alt, s.up, s.multiplier, s.tip,
+           s.alt.running, (unsigned)s.alt.started, s.firing.running, (unsigned)s.firing.started, (unsigned)s.seed);
+  std::string text = buffer;
+
+  for(uint8_t i : s.speed_ups) {
+    text += " " + std::to_string(i);
+  }
+
+  return text;
+}
+
+// What can be seen or heard: the display, tip light, timers, cyclotron speed and random numbers drawn.
+static bool sameOutput(const WandState& a, const WandState& b) {
+  return a.mask == b.mask && memcmp(a.pins, b.pins, sizeof(a.pins)) == 0 && a.tip == b.tip && a.multiplier == b.multiplier &&
+         a.speed_ups == b.speed_ups && a.alt.running == b.alt.running && a.alt.started == b.alt.started &&
+         a.firing.running == b.firing.running && a.firing.started == b.firing.started && a.seed == b.seed;
+}
+
+// The output and the position the next step starts from.
+static bool sameState(const WandState& a, const WandState& b) {
+  return sameOutput(a, b) && a.status == b.status && a.status_alt == b.status_alt && a.up == b.up;
+}
+
+/*
+ * Runs the before and after functions from their own copies of the wand state (so each keeps its own
+ * position, which the Super Hero frame player tracks differently) and checks they agree.
+ */
+struct SideBySide {
+  WandState before;
+  WandState after;
+
+  explicit SideBySide(const WandState& start) : before(start), after(start) {}
+
+  template<typename B, typename A>
+  ::testing::AssertionResult step(B run_before, A run_after, bool whole_state) {
+    loadState(before);
+    run_before();
+    before = saveState();
+
+    loadState(after);
+    run_after();
+    after = saveState();
+
+    if(whole_state ? sameState(before, after) : sameOutput(before, after)) {
+      return ::testing::AssertionSuccess();
+    }
+
+    return ::testing::AssertionFailure() << "before: " << describe(before) << "\n after: " << describe(after);
+  }
+};
+
+static void useBargraph(wand::BARGRAPH_TYPES type) {
+  wand::BARGRAPH_TYPE = type;
+
+  if(type == wand::SEGMENTS_30) {
+    wand::ht_bargraph.setLayout(BARGRAPH_LAYOUT_30, false);
+  }
+  else {
+    wand::ht_bargraph.setLayout(BARGRAPH_LAYOUT_28, false);
+  }
+}
+
+static const wand::BARGRAPH_TYPES BARGRAPH_TYPES_ALL[3] = {wand::SEGMENTS_28, wand::SEGMENTS_30, wand::SEGMENTS_5};
+
+/*
+ * A power level change on the 28 and 30 segment bargraphs, from every position in either direction,
+ * sweeps the same elements with the same timing in both bargraph modes.
+ */
+TEST(BargraphPorts, PowerCheckSweepMatchesBefore) {
+  for(wand::BARGRAPH_TYPES type : {wand::SEGMENTS_28, wand::SEGMENTS_30}) {
+    useBargraph(type);
+    uint8_t i_elements = wand::ht_bargraph.getElementCount();
+
+    for(wand::BARGRAPH_MODES mode : {wand::BARGRAPH_SUPER_HERO, wand::BARGRAPH_ORIGINAL}) {
+      wand::BARGRAPH_MODE = mode;
+
+      for(uint8_t level = 1; level <= 5; level++) {
+        wand::gpstarWand.level = (wand::POWER_LEVELS)level;
+
+        for(uint8_t position = 0; position <= i_elements; position++) {
+          for(bool up : {false, true}) {
+            SCOPED_TRACE(testing::Message() << "type " << (int)type << ", mode " << mode << ", level " << (int)level
+                                            << ", position " << (int)position << ", up " << up);
+            WandState start;
+            start.mask = position >= 32 ? 0xFFFFFFFF : ((uint32_t)1 << position) - 1;
+            start.status_alt = position;
+            start.up = up;
+            start.alt.start(1);
+            SideBySide run(start);
+
+            for(uint16_t i = 0; i < 200 && run.before.alt.running; i++) {
+              ASSERT_TRUE(run.step(before::bargraphPowerCheck, after::powerSweep, true)) << "step " << i;
+            }
+          }
+        }
+      }
+    }
+  }
+}
+
+// The 5 LED bargraph shows the power level directly, and the power level change timer is left alone.
+TEST(BargraphPorts, PowerCheck5LedShowsLevel) {
+  useBargraph(wand::SEGMENTS_5);
+
+  for(uint8_t level = 1; level <= 5; level++) {
+    wand::gpstarWand.level = (wand::POWER_LEVELS)level;
+    loadState(WandState());
+
+    before::bargraphPowerCheck();
+    EXPECT_EQ(pinMask(), (1 << level) - 1) << "level " << (int)level;
+    EXPECT_FALSE(wand::ms_bargraph_alt.isRunning());
+  }
+}
+
+// The sweep starts after the same wait, in the same direction, for every change of power level and wand state.
+TEST(BargraphPorts, PowerCheck2021AltMatchesBefore) {
+  for(wand::BARGRAPH_TYPES type : BARGRAPH_TYPES_ALL) {
+    useBargraph(type);
+
+    for(wand::WAND_ACTION_STATE action : {wand::ACTION_IDLE, wand::ACTION_FIRING, wand::ACTION_SETTINGS, wand::ACTION_OVERHEATING}) {
+      wand::WAND_ACTION_STATUS = action;
+
+      for(uint8_t level = 1; level <= 5; level++) {
+        for(uint8_t previous = 1; previous <= 5; previous++) {
+          for(bool b_override : {false, true}) {
+            wand::gpstarWand.level = (wand::POWER_LEVELS)level;
+            wand::gpstarWand.previous = (wand::POWER_LEVELS)previous;
+            SideBySide run{WandState()};
+
+            // The wand keeps its own direction and guard; the wait before the first step comes from the sweep table.
+            bool b_starts = (action == wand::ACTION_IDLE || b_override) && (level != previous || b_override);
+            ASSERT_TRUE(run.step([=]() { before::bargraphPowerCheck2021Alt(b_override); },
+                                 [=]() {
+                                   if(b_starts) {
+                                     wand::b_bargraph_up = level > previous;
+                                     wand::ms_bargraph_alt.start(bargraphPowerSweepStartTime(level, wand::i_bargraph_wait));
+                                   }
+                                 }, true))
+                << "type " << (int)type << ", action " << action << ", level " << (int)level << ", previous " << (int)previous
+                << ", override " << b_override;
+          }
+        }
+      }
+    }
+  }
+}
+
+/*
+ * Mode Original firing on all three bargraphs, starting from the power level display, draws the same
+ * random numbers and lights the same elements at every power level and cyclotron multiplier.
+ */
+TEST(BargraphPorts, ModeOriginalMatchesBefore) {
+  for(wand::BARGRAPH_TYPES type : BARGRAPH_TYPES_ALL) {
+    useBargraph(type);
+
+    for(uint8_t level = 1; level <= 5; level++) {
+      wand::gpstarWand.level = (wand::POWER_LEVELS)level;
+
+      for(uint8_t multiplier = 0; multiplier <= 6; multiplier++) {
+        SCOPED_TRACE(testing::Message() << "type " << (int)type << ", level " << (int)level << ", multiplier " << (int)multiplier);
+        WandState start;
+        start.multiplier = multiplier;
+        start.seed = 12345 + level * 100 + multiplier;
+
+        if(type == wand::SEGMENTS_5) {
+          for(uint8_t i = 0; i < level; i++) {
+            start.pins[i] = wand::LOW;
+          }
+        }
+        else {
+          uint8_t i_top = (type == wand::SEGMENTS_30) ? wand::i_bargraph_power_table_wamco[level] : wand::i_bargraph_power_table_28[level];
+          start.mask = ((uint32_t)1 << (i_top + 1)) - 1;
+        }
+
+        SideBySide run(start);
+
+        for(uint16_t i = 0; i < 2000; i++) {
+          ASSERT_TRUE(run.step(before::bargraphModeOriginalRampFiringAnimation, after::modeOriginalStep, true))
+              << "step " << i;
+        }
+      }
+    }
+  }
+}
+
+// The Super Hero frame tables light the same elements and tip light as the old set/clear steps.
+TEST(BargraphPorts, SuperHeroMatchesBefore) {
+  for(wand::BARGRAPH_TYPES type : BARGRAPH_TYPES_ALL) {
+    useBargraph(type);
+    wand::bargraph_player.stop();
+
+    // modeFireStart() restarts the 5 LED animation at 1 and the others at 0, falling.
+    WandState start;
+    start.status = 1;
+    SideBySide run(start);
+
+    for(uint16_t i = 0; i < 200; i++) {
+      ASSERT_TRUE(run.step(before::bargraphSuperHeroRampFiringAnimation, after::superHeroStep, false))
+          << "type " << (int)type << ", step " << i;
+    }
+  }
+}
+
+/*
+ * Firing steps come at the same times, and speed up the cyclotron in the same way, for each bargraph,
+ * animation and power level as an overheat approaches.
+ */
+TEST(BargraphPorts, RampFiringMatchesBefore) {
+  for(wand::BARGRAPH_TYPES type : BARGRAPH_TYPES_ALL) {
+    useBargraph(type);
+
+    for(wand::BARGRAPH_FIRING_ANIMATIONS animation : {wand::BARGRAPH_ANIMATION_SUPER_HERO, wand::BARGRAPH_ANIMATION_ORIGINAL}) {
+      wand::BARGRAPH_FIRING_ANIMATION = animation;
+
+      for(uint8_t level = 1; level <= 5; level++) {
+        wand::gpstarWand.level = (wand::POWER_LEVELS)level;
+        uint32_t i_overheat = wand::i_ms_overheat_initiate[level - 1];
+        const uint32_t i_remaining[] = {i_overheat, i_overheat / 2, i_overheat / 2 - 1, i_overheat / 3 - 1, i_overheat / 4 - 1,
+                                        i_overheat / 5 - 1, i_overheat / 6 - 1, 0};
+
+        for(int8_t r = -1; r < (int8_t)(sizeof(i_remaining) / sizeof(i_remaining[0])); r++) {
+          SCOPED_TRACE(testing::Message() << "type " << (int)type << ", animation " << animation << ", level " << (int)level
+                                          << ", remaining " << (r < 0 ? -1 : (long)i_remaining[r]));
+          wand::ms_overheat_initiate.stop();
+
+          if(r >= 0) {
+            wand::ms_overheat_initiate.start(i_remaining[r]);
+          }
+
+          wand::bargraph_player.stop();
+          WandState start;
+          start.status = 1;
+          SideBySide run(start);
+
+          for(uint16_t i = 0; i < 50; i++) {
+            wand::i_barrel_light = i;
+            ASSERT_TRUE(run.step(before::bargraphRampFiring, after::rampFiringStep, false)) << "step " << i;
+          }
+        }
+      }
+    }
+  }
+
+  wand::ms_overheat_initiate.stop();
+}
+
+// Best time per call over a few runs, as a busy machine only ever adds time.
+template<typename F>
+static double bestNsPerCall(F run, uint32_t calls) {
+  double best = 1e30;
+
+  for(uint8_t r = 0; r < 7; r++) {
+    auto start = std::chrono::steady_clock::now();
+    for(uint32_t i = 0; i < calls; i++) {
+      run();
+    }
+    double ns = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count() / calls;
+
+    if(ns < best) {
+      best = ns;
+    }
+  }
+
+  return best;
+}
+
+// Cost of one firing step on the 30 segment bargraph: the old set/clear switch against the frame table.
+TEST(BargraphPortsBenchmark, SuperHeroStep) {
+  useBargraph(wand::SEGMENTS_30);
+  loadState(WandState());
+  double before_ns = bestNsPerCall(before::bargraphSuperHeroRampFiringAnimation, 1000000);
+
+  wand::bargraph_player.stop();
+  double after_ns = bestNsPerCall(after::superHeroStep, 1000000);
+
+  printf("[          ] super hero step: set/clear %.1f ns, frame table %.1f ns; table %u bytes\n", before_ns, after_ns,
+         (unsigned)(BARGRAPH_SEQ_SUPER_HERO_30.count * sizeof(BargraphFrame)));
+  EXPECT_GT(elementMask(wand::ht_bargraph), 0u);
+}
+
+// Cost of one power level sweep step: the old switch against the sweep table.
+TEST(BargraphPortsBenchmark, PowerCheckStep) {
+  useBargraph(wand::SEGMENTS_28);
+  wand::BARGRAPH_MODE = wand::BARGRAPH_SUPER_HERO;
+  wand::gpstarWand.level = wand::LEVEL_3;
+  loadState(WandState());
+  double before_ns = bestNsPerCall([]() { wand::ms_bargraph_alt.running = true; before::bargraphPowerCheck(); }, 1000000);
+
+  loadState(WandState());
+  double after_ns = bestNsPerCall([]() { wand::ms_bargraph_alt.running = true; after::powerSweep(); }, 1000000);
+
+  printf("[          ] power level sweep step: switch %.1f ns, sweep table %.1f ns; table %u bytes\n", before_ns, after_ns,
+         (unsigned)sizeof(BARGRAPH_SWEEP_28));
+  EXPECT_TRUE(wand::ms_bargraph_alt.isRunning());
+}
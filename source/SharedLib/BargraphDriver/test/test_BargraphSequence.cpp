@@ -0,0 +1,81 @@
+#include <gtest/gtest.h>
+#include <stdio.h>
+#include "BargraphSequence.h"
+
+TEST(BargraphSequencePlayer, OnceStopsOnTheLastFrame) {
+  static const BargraphFrame frames[] = {{0x1, 1, 0}, {0x2, 2, 0}, {0x4, 1, 0}};
+  const BargraphSequence sequence = {frames, 3, BARGRAPH_PLAY_ONCE};
+  BargraphSequencePlayer player;
+
+  player.start(&sequence);
+  EXPECT_TRUE(player.isRunning());
+  EXPECT_EQ(player.getMask(), 0x1u);
+
+  EXPECT_TRUE(player.tick());
+  EXPECT_EQ(player.getMask(), 0x2u);
+  EXPECT_FALSE(player.tick()); // Second tick of the same frame.
+  EXPECT_TRUE(player.tick());
+  EXPECT_EQ(player.getMask(), 0x4u);
+  EXPECT_FALSE(player.tick());
+  EXPECT_FALSE(player.isRunning());
+  EXPECT_EQ(player.getMask(), 0x4u);
+}
+
+TEST(BargraphSequencePlayer, LoopAndBounceOrders) {
+  static const BargraphFrame frames[] = {{0x1, 1, 0}, {0x2, 1, 0}, {0x4, 1, 0}};
+  const BargraphSequence loop = {frames, 3, BARGRAPH_PLAY_LOOP};
+  const BargraphSequence bounce = {frames, 3, BARGRAPH_PLAY_BOUNCE};
+  BargraphSequencePlayer player;
+
+  const uint8_t loop_order[] = {0, 1, 2, 0, 1, 2, 0};
+  player.start(&loop);
+  for(uint8_t i = 0; i < sizeof(loop_order); i++) {
+    EXPECT_EQ(player.getPosition(), loop_order[i]);
+    player.tick();
+  }
+
+  const uint8_t bounce_order[] = {0, 1, 2, 1, 0, 1, 2, 1};
+  player.start(&bounce);
+  for(uint8_t i = 0; i < sizeof(bounce_order); i++) {
+    EXPECT_EQ(player.getPosition(), bounce_order[i]);
+    player.tick();
+  }
+}
+
+TEST(BargraphSequencePlayer, TickTimeScalesSpeed) {
+  static const BargraphFrame frames[] = {{0x1, 1, 0}, {0x2, 3, 0}};
+  const BargraphSequence sequence = {frames, 2, BARGRAPH_PLAY_LOOP};
+  BargraphSequencePlayer player;
+
+  player.setTickTime(10);
+  player.start(&sequence, 1000);
+
+  EXPECT_FALSE(player.update(1009));
+  EXPECT_TRUE(player.update(1010));
+  EXPECT_EQ(player.getPosition(), 1);
+
+  // The second frame lasts three ticks; at double speed that is 15ms.
+  player.setTickTime(5);
+  EXPECT_FALSE(player.update(1015));
+  EXPECT_FALSE(player.update(1020));
+  EXPECT_TRUE(player.update(1025));
+  EXPECT_EQ(player.getPosition(), 0);
+}
+
+// Firing step times by power level and stage, with anything out of range held at the ends.
+TEST(BargraphSequenceTiming, FiringStepTimeByStage) {
+  EXPECT_EQ(bargraphFiringStepTime(&BARGRAPH_FIRING_TIMING_SEGMENTS, 1, 0), 32);
+  EXPECT_EQ(bargraphFiringStepTime(&BARGRAPH_FIRING_TIMING_SEGMENTS, 5, 0), 13);
+  EXPECT_EQ(bargraphFiringStepTime(&BARGRAPH_FIRING_TIMING_SEGMENTS, 1, 1), 35);
+  EXPECT_EQ(bargraphFiringStepTime(&BARGRAPH_FIRING_TIMING_SEGMENTS, 3, 2), 15);
+  EXPECT_EQ(bargraphFiringStepTime(&BARGRAPH_FIRING_TIMING_SEGMENTS, 3, 6), 7);
+  EXPECT_EQ(bargraphFiringStepTime(&BARGRAPH_FIRING_TIMING_SEGMENTS, 3, 9), 7);
+  EXPECT_EQ(bargraphFiringStepTime(&BARGRAPH_FIRING_TIMING_5_LED_ORIGINAL, 0, 0), 60);
+  EXPECT_EQ(bargraphFiringStepTime(&BARGRAPH_FIRING_TIMING_5_LED_ORIGINAL, 9, 1), 60);
+}
+
+// The sweep to a lower power level starts sooner.
+TEST(BargraphSequenceTiming, SweepStartTime) {
+  EXPECT_EQ(bargraphSweepStartTime(&BARGRAPH_SWEEP_28[0], 180), 180 / 7);
+  EXPECT_EQ(bargraphSweepStartTime(&BARGRAPH_SWEEP_30[4], 180), 180 / 3);
+}
@@ -0,0 +1,172 @@
+/**
+ *   BarrelEffects - Barrel LED firing effects for GPStar devices.
+ *   Draws stream and pulse effects from parameter sets, with colours from a cached palette.
+ *   Copyright (C) 2023-2026 Michael Rajotte, Dustin Grau, Nomake Wan
+ *
+ *   This program is free software; you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation; either version 3 of the License, or
+ *   (at your option) any later version.
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License
+ *   along with this program; if not, see <https://www.gnu.org/licenses/>.
+ *
+ */
+
+#pragma once
+
+// Standard library includes for integer type definitions
+#include <stdint.h>  // Provides uint8_t, uint16_t, etc.
+#include <stdbool.h> // Provides bool type definition.
+
+// Pixels are stored as 3 bytes in R, G, B order which matches the memory layout
+// of a FastLED CRGB object, so an existing CRGB array may be drawn into directly.
+#define BARREL_BYTES_PER_PIXEL 3
+
+// Colour ids 0-31 may be kept in a BarrelPalette.
+#define BARREL_PALETTE_SIZE 32
+
+// Parameter sets are indexed by power level 1-5.
+#define BARREL_POWER_LEVELS 5
+
+// Restart time of a stream which waits to be restarted by the device after each pass.
+#define BARREL_STREAM_WAIT 0
+
+// Pulses move through 5 zones of the barrel, showing 6 shades in each.
+#define BARREL_PULSE_ZONES 5
+#define BARREL_PULSE_SHADES 6
+
+struct BarrelColour {
+  uint8_t r;
+  uint8_t g;
+  uint8_t b;
+};
+
+// Converts a device colour id to RGB, eg. through HSV.
+typedef BarrelColour (*BarrelColourSource)(uint8_t colour);
+
+// Random number in [low, high), the same as Arduino random(low, high).
+typedef long (*BarrelRandom)(long low, long high);
+
+/**
+ * Class: BarrelPalette
+ * Purpose: Keeps the RGB value of each colour id once converted, so an effect may ask for the
+ * same colour on every pixel and every frame for the cost of a table read.
+ *
+ * Colours which change on each use (eg. colour cycles) are listed as uncached and converted every
+ * time. Call invalidate() when anything behind the conversion changes (LED type, custom colour).
+ */
+class BarrelPalette {
+public:
+  BarrelPalette(BarrelColourSource source, uint32_t uncached = 0);
+
+  const BarrelColour& get(uint8_t colour);
+  void invalidate();
+
+  // Number of conversions made through the source, for profiling.
+  uint16_t getConversions() const;
+
+private:
+  BarrelColourSource source;
+  uint32_t uncached; // One bit per colour id.
+  uint32_t valid;    // One bit per colour id.
+  uint16_t conversions;
+  BarrelColour entries[BARREL_PALETTE_SIZE];
+  BarrelColour scratch; // Holds the last uncached colour.
+};
+
+/**
+ * Class: BarrelStrip
+ * Purpose: The barrel LEDs in firing order, from the base (position 0) to the tip.
+ *
+ * An optional map in PROGMEM gives the LED for each position, for barrels which are not wired
+ * in firing order. Mapped barrels are split into 5 zones of 12, 8, 8, 8 and 12 positions; on
+ * other barrels each zone is a single LED.
+ */
+class BarrelStrip {
+public:
+  BarrelStrip(uint8_t* pixels, uint8_t count, const uint8_t* map = nullptr, uint8_t mapSize = 0);
+
+  uint8_t getCount() const;
+
+  void set(uint8_t position, const BarrelColour& colour);
+  void fill(uint8_t first, uint8_t end, const BarrelColour& colour); // Positions [first, end).
+  void fillZone(uint8_t zone, const BarrelColour& colour);
+
+private:
+  uint8_t* pixels;
+  const uint8_t* map;
+  uint8_t count;
+};
+
+/*
+ * A stream: a head which moves one position along the barrel each step, lighting a burst of
+ * positions in front of it and leaving the trail colour behind it. After the last position the
+ * stream waits for the restart time, then starts again from the base.
+ */
+struct BarrelStreamParams {
+  uint8_t stepTime[BARREL_POWER_LEVELS];    // Milliseconds between steps, by power level.
+  uint8_t restartTime[BARREL_POWER_LEVELS]; // Milliseconds before the next pass, or BARREL_STREAM_WAIT.
+  uint8_t burst[BARREL_POWER_LEVELS];       // Positions lit from the head forwards, by power level.
+  uint8_t burstDivisor;                     // Adds random(0, count / burstDivisor) to the burst, or 0 for none.
+};
+
+// Moves a stream in PROGMEM one step. Returns the milliseconds until the next step, or BARREL_STREAM_WAIT.
+uint8_t barrelStreamStep(BarrelStrip& strip, const BarrelStreamParams* params, uint8_t level, uint8_t& position,
+                         const BarrelColour& head, const BarrelColour& trail, BarrelRandom random);
+
+/*
+ * A pulse: a bolt which moves from zone to zone, each zone showing the shades in turn as it
+ * passes and keeping the last shade afterwards.
+ */
+struct BarrelPulseParams {
+  uint8_t stepTime;  // Milliseconds between steps.
+  uint8_t zoneDelay; // Steps for the pulse to move on by one zone.
+};
+
+class BarrelPulse {
+public:
+  BarrelPulse();
+
+  // Begins a pulse in PROGMEM, with one colour for each of the BARREL_PULSE_SHADES.
+  void start(const BarrelPulseParams* params, const BarrelColour* shades);
+  void stop();
+  bool isRunning() const;
+
+  // Draws the next step. Returns true when another step follows.
+  bool step(BarrelStrip& strip);
+
+  // True after the step which first lights the last zone.
+  bool atTip() const;
+  uint8_t getStepTime() const;
+
+private:
+  BarrelPulseParams params;
+  BarrelColour shades[BARREL_PULSE_SHADES];
+  uint8_t position; // Next step to draw.
+  bool running;
+};
+
+/*
+ * Effects of the Neutrona Wand.
+ */
+
+// Streams for the GPStar and Frutto barrels (48 positions).
+extern const BarrelStreamParams BARREL_STREAM_PROTON;
+extern const BarrelStreamParams BARREL_STREAM_MESON;
+extern const BarrelStreamParams BARREL_STREAM_DEFAULT; // All other stream modes.
+extern const BarrelStreamParams BARREL_STREAM_TETHER;  // Slime Tether, when not firing.
+
+// Streams for the Hasbro (5) and GPStar Mini (2) barrels.
+extern const BarrelStreamParams BARREL_STREAM_HASBRO;
+extern const BarrelStreamParams BARREL_STREAM_HASBRO_MESON;
+
+// Pulses (semi-automatic firing).
+extern const BarrelPulseParams BARREL_PULSE_BOSON_DART;
+extern const BarrelPulseParams BARREL_PULSE_SHOCK_BLAST;
+extern const BarrelPulseParams BARREL_PULSE_MESON_COLLIDER;
@@ -0,0 +1,237 @@
+/**
+ *   BarrelEffects - Barrel LED firing effects for GPStar devices.
+ *   Draws stream and pulse effects from parameter sets, with colours from a cached palette.
+ *   Copyright (C) 2023-2026 Michael Rajotte, Dustin Grau, Nomake Wan
+ *
+ *   This program is free software; you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation; either version 3 of the License, or
+ *   (at your option) any later version.
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License
+ *   along with this program; if not, see <https://www.gnu.org/licenses/>.
+ *
+ */
+
+// Library Header
+#include "BarrelEffects.h"
+
+#include <string.h>
+
+#if defined(ARDUINO)
+  #include <Arduino.h>
+#else
+  #define PROGMEM
+  #define pgm_read_byte(address) (*(const uint8_t*)(address))
+  #define memcpy_P memcpy
+#endif
+
+/*
+ * Stream parameter sets. Step times at power level 1-5.
+ */
+const BarrelStreamParams BARREL_STREAM_PROTON PROGMEM = {
+  {8, 7, 6, 5, 4}, {5, 4, 3, 2, 1}, {2, 3, 6, 8, 10}, 3
+};
+
+const BarrelStreamParams BARREL_STREAM_MESON PROGMEM = {
+  {4, 3, 3, 3, 2}, {BARREL_STREAM_WAIT, BARREL_STREAM_WAIT, BARREL_STREAM_WAIT, BARREL_STREAM_WAIT, BARREL_STREAM_WAIT}, {4, 4, 4, 4, 4}, 0
+};
+
+const BarrelStreamParams BARREL_STREAM_DEFAULT PROGMEM = {
+  {6, 5, 4, 3, 2}, {5, 4, 3, 2, 1}, {0, 0, 0, 0, 0}, 4
+};
+
+const BarrelStreamParams BARREL_STREAM_TETHER PROGMEM = {
+  {1, 1, 1, 1, 1}, {5, 4, 3, 2, 1}, {0, 0, 0, 0, 0}, 4
+};
+
+const BarrelStreamParams BARREL_STREAM_HASBRO PROGMEM = {
+  {30, 28, 26, 25, 24}, {100, 85, 70, 55, 40}, {1, 1, 1, 1, 1}, 0
+};
+
+const BarrelStreamParams BARREL_STREAM_HASBRO_MESON PROGMEM = {
+  {30, 28, 26, 25, 24}, {BARREL_STREAM_WAIT, BARREL_STREAM_WAIT, BARREL_STREAM_WAIT, BARREL_STREAM_WAIT, BARREL_STREAM_WAIT}, {1, 1, 1, 1, 1}, 0
+};
+
+/*
+ * Pulse parameter sets. The Boson Dart is twice as slow, but crosses a zone on every step.
+ */
+const BarrelPulseParams BARREL_PULSE_BOSON_DART PROGMEM = {36, 1};
+const BarrelPulseParams BARREL_PULSE_SHOCK_BLAST PROGMEM = {18, 2};
+const BarrelPulseParams BARREL_PULSE_MESON_COLLIDER PROGMEM = {18, 2};
+
+// First position of each zone on a mapped barrel, followed by the end of the last zone.
+static const uint8_t ZONE_START[BARREL_PULSE_ZONES + 1] PROGMEM = {0, 12, 20, 28, 36, 48};
+
+BarrelPalette::BarrelPalette(BarrelColourSource source, uint32_t uncached)
+  : source(source), uncached(uncached), valid(0), conversions(0) {
+  memset(entries, 0, sizeof(entries));
+  memset(&scratch, 0, sizeof(scratch));
+}
+
+const BarrelColour& BarrelPalette::get(uint8_t colour) {
+  if(colour >= BARREL_PALETTE_SIZE || (uncached & ((uint32_t)1 << colour))) {
+    scratch = source(colour);
+    conversions++;
+    return scratch;
+  }
+
+  uint32_t i_bit = (uint32_t)1 << colour;
+
+  if(!(valid & i_bit)) {
+    entries[colour] = source(colour);
+    valid |= i_bit;
+    conversions++;
+  }
+
+  return entries[colour];
+}
+
+void BarrelPalette::invalidate() {
+  valid = 0;
+}
+
+uint16_t BarrelPalette::getConversions() const {
+  return conversions;
+}
+
+BarrelStrip::BarrelStrip(uint8_t* pixels, uint8_t count, const uint8_t* map, uint8_t mapSize)
+  : pixels(pixels), map(map), count(count) {
+  // A mapped barrel has no more positions than its map.
+  if(map != nullptr && this->count > mapSize) {
+    this->count = mapSize;
+  }
+}
+
+uint8_t BarrelStrip::getCount() const {
+  return count;
+}
+
+void BarrelStrip::set(uint8_t position, const BarrelColour& colour) {
+  if(position >= count) {
+    return;
+  }
+
+  uint8_t i_led = map != nullptr ? pgm_read_byte(&map[position]) : position;
+  uint8_t* pixel = &pixels[i_led * BARREL_BYTES_PER_PIXEL];
+
+  pixel[0] = colour.r;
+  pixel[1] = colour.g;
+  pixel[2] = colour.b;
+}
+
+void BarrelStrip::fill(uint8_t first, uint8_t end, const BarrelColour& colour) {
+  if(end > count) {
+    end = count;
+  }
+
+  for(uint8_t i = first; i < end; i++) {
+    set(i, colour);
+  }
+}
+
+void BarrelStrip::fillZone(uint8_t zone, const BarrelColour& colour) {
+  if(zone >= BARREL_PULSE_ZONES) {
+    return;
+  }
+
+  if(map != nullptr) {
+    fill(pgm_read_byte(&ZONE_START[zone]), pgm_read_byte(&ZONE_START[zone + 1]), colour);
+  }
+  else {
+    set(zone, colour);
+  }
+}
+
+uint8_t barrelStreamStep(BarrelStrip& strip, const BarrelStreamParams* params, uint8_t level, uint8_t& position,
+                         const BarrelColour& head, const BarrelColour& trail, BarrelRandom random) {
+  BarrelStreamParams stream;
+  memcpy_P(&stream, params, sizeof(BarrelStreamParams));
+
+  uint8_t i_level = (level >= 1 && level <= BARREL_POWER_LEVELS) ? level - 1 : BARREL_POWER_LEVELS - 1;
+  uint8_t i_count = strip.getCount();
+
+  // The position behind the head returns to the trail colour.
+  if(position > 0 && position <= i_count) {
+    strip.set(position - 1, trail);
+  }
+
+  if(position >= i_count) {
+    position = 0;
+    return stream.restartTime[i_level];
+  }
+
+  uint8_t i_burst = stream.burst[i_level];
+
+  if(stream.burstDivisor > 0) {
+    i_burst += random(0, i_count / stream.burstDivisor);
+  }
+
+  if(i_burst < 1) {
+    i_burst = 1;
+  }
+
+  strip.fill(position, (position + i_burst > i_count) ? i_count : position + i_burst, head);
+  position++;
+
+  return stream.stepTime[i_level];
+}
+
+BarrelPulse::BarrelPulse() : position(0), running(false) {
+  memset(&params, 0, sizeof(params));
+  memset(shades, 0, sizeof(shades));
+}
+
+void BarrelPulse::start(const BarrelPulseParams* params, const BarrelColour* shades) {
+  memcpy_P(&this->params, params, sizeof(BarrelPulseParams));
+  memcpy(this->shades, shades, sizeof(this->shades));
+
+  if(this->params.zoneDelay < 1) {
+    this->params.zoneDelay = 1;
+  }
+
+  position = 0;
+  running = true;
+}
+
+void BarrelPulse::stop() {
+  running = false;
+}
+
+bool BarrelPulse::isRunning() const {
+  return running;
+}
+
+bool BarrelPulse::step(BarrelStrip& strip) {
+  if(!running) {
+    return false;
+  }
+
+  // Each zone shows the shades in turn, starting zoneDelay steps after the zone before it.
+  for(uint8_t i = 0; i < BARREL_PULSE_ZONES; i++) {
+    uint8_t i_start = i * params.zoneDelay;
+
+    if(position >= i_start && position - i_start < BARREL_PULSE_SHADES) {
+      strip.fillZone(i, shades[position - i_start]);
+    }
+  }
+
+  position++;
+
+  // The last zone shows its final shade on the last step.
+  running = position < (BARREL_PULSE_ZONES - 1) * params.zoneDelay + BARREL_PULSE_SHADES;
+  return running;
+}
+
+bool BarrelPulse::atTip() const {
+  return position == (BARREL_PULSE_ZONES - 1) * params.zoneDelay + 1;
+}
+
+uint8_t BarrelPulse::getStepTime() const {
+  return params.stepTime;
+}
@@ -0,0 +1,450 @@
+#include <gtest/gtest.h>
+#include <stdio.h>
+#include <string.h>
+#include <chrono>
+#include "BarrelEffects.h"
+
+// Barrel map of the GPStar Neutrona Barrel, as in the Neutrona Wand.
+static const uint8_t GPSTAR_BARREL[48] = {0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15, 16, 17, 18, 19, 20, 21, 22, 23, 24, 25, 26, 27, 28, 29, 30, 31, 32, 33, 34, 35, 49, 48, 47, 46, 45, 44, 43, 42, 41, 40, 39, 38};
+
+// Repeatable stand-in for Arduino random(low, high).
+static uint32_t g_seed = 1;
+
+static long testRandom(long low, long high) {
+  g_seed = g_seed * 1103515245u + 12345u;
+
+  if(high <= low) {
+    return low;
+  }
+
+  return low + (long)((g_seed >> 16) % (uint32_t)(high - low));
+}
+
+/*
+ * Integer HSV to RGB conversion with the same shape of work as the FastLED conversion used by the
+ * devices (six hue sections, saturation and value scaling), standing in for it on the host.
+ */
+static uint32_t g_conversions = 0;
+
+static BarrelColour hsvToRgb(uint8_t h, uint8_t s, uint8_t v) {
+  g_conversions++;
+
+  uint8_t i_region = h / 43;
+  uint8_t i_remainder = (h - (i_region * 43)) * 6;
+  uint8_t p = (v * (255 - s)) >> 8;
+  uint8_t q = (v * (255 - ((s * i_remainder) >> 8))) >> 8;
+  uint8_t t = (v * (255 - ((s * (255 - i_remainder)) >> 8))) >> 8;
+
+  switch(i_region) {
+    case 0: return {v, t, p};
+    case 1: return {q, v, p};
+    case 2: return {p, v, t};
+    case 3: return {p, q, v};
+    case 4: return {t, p, v};
+    default: return {v, p, q};
+  }
+}
+
+// Colour ids: hue for ids 1-30 and black for 0, with id 31 changing on every use like a colour cycle.
+static uint8_t g_cycle = 0;
+
+static BarrelColour testColour(uint8_t colour) {
+  if(colour == 0) {
+    return {0, 0, 0};
+  }
+
+  if(colour == 31) {
+    g_cycle += 5;
+    return hsvToRgb(g_cycle, 255, 255);
+  }
+
+  return hsvToRgb(colour * 8, 255, 255);
+}
+
+static bool sameColour(const uint8_t* pixel, const BarrelColour& colour) {
+  return pixel[0] == colour.r && pixel[1] == colour.g && pixel[2] == colour.b;
+}
+
+TEST(BarrelPalette, ConvertsEachColourOnce) {
+  BarrelPalette palette(testColour);
+  g_conversions = 0;
+
+  BarrelColour red = palette.get(5);
+  for(uint8_t i = 0; i < 100; i++) {
+    palette.get(5);
+  }
+
+  EXPECT_EQ(palette.getConversions(), 1);
+  EXPECT_EQ(g_conversions, 1u);
+  EXPECT_EQ(memcmp(&red, &palette.get(5), sizeof(red)), 0);
+
+  palette.invalidate();
+  palette.get(5);
+  EXPECT_EQ(palette.getConversions(), 2);
+}
+
+TEST(BarrelPalette, UncachedColoursConvertOnEveryUse) {
+  BarrelPalette palette(testColour, (uint32_t)1 << 31);
+
+  BarrelColour first = palette.get(31);
+  BarrelColour second = palette.get(31);
+
+  EXPECT_EQ(palette.getConversions(), 2);
+  EXPECT_NE(memcmp(&first, &second, sizeof(first)), 0);
+}
+
+TEST(BarrelStrip, MapsPositionsAndZones) {
+  uint8_t pixels[50 * BARREL_BYTES_PER_PIXEL] = {};
+  BarrelStrip strip(pixels, 50, GPSTAR_BARREL, 48);
+  const BarrelColour white = {255, 255, 255};
+
+  EXPECT_EQ(strip.getCount(), 48); // Limited to the map.
+
+  strip.set(36, white);
+  EXPECT_TRUE(sameColour(&pixels[49 * 3], white));
+
+  strip.fillZone(4, white);
+  for(uint8_t i = 36; i < 48; i++) {
+    EXPECT_TRUE(sameColour(&pixels[GPSTAR_BARREL[i] * 3], white));
+  }
+  EXPECT_TRUE(sameColour(&pixels[35 * 3], {0, 0, 0}));
+
+  uint8_t hasbro[5 * BARREL_BYTES_PER_PIXEL] = {};
+  BarrelStrip stock(hasbro, 5);
+  stock.fillZone(2, white);
+  EXPECT_TRUE(sameColour(&hasbro[2 * 3], white));
+  EXPECT_TRUE(sameColour(&hasbro[3 * 3], {0, 0, 0}));
+}
+
+/*
+ * Reference: the stream effect of the Neutrona Wand on the GPStar barrel as written before the
+ * port, with the trail colour, the burst for each stream mode and the timer intervals.
+ */
+enum TestStream { TEST_PROTON, TEST_MESON, TEST_DEFAULT };
+
+static uint8_t originalStreamStep(uint8_t* leds, uint8_t i_num_barrel_leds, TestStream mode, uint8_t level, uint8_t& i_barrel_light,
+                                  const BarrelColour& c_colour, const BarrelColour& c_trail) {
+  uint8_t i_next = BARREL_STREAM_WAIT;
+
+  if(i_barrel_light - 1 >= 0 && i_barrel_light - 1 < i_num_barrel_leds) {
+    memcpy(&leds[GPSTAR_BARREL[i_barrel_light - 1] * 3], &c_trail, 3);
+  }
+
+  if(i_barrel_light == i_num_barrel_leds) {
+    i_barrel_light = 0;
+
+    if(mode != TEST_MESON) {
+      i_next = 10 - (4 + level); // i_firing_stream / 10 - i_s_speed
+    }
+  }
+  else if(i_barrel_light < i_num_barrel_leds) {
+    memcpy(&leds[GPSTAR_BARREL[i_barrel_light] * 3], &c_colour, 3);
+
+    switch(mode) {
+      case TEST_MESON:
+        for(uint8_t i = 1; i <= 3; i++) {
+          if(i_barrel_light + i < i_num_barrel_leds) {
+            memcpy(&leds[GPSTAR_BARREL[i_barrel_light + i] * 3], &c_colour, 3);
+          }
+        }
+      break;
+
+      case TEST_PROTON:
+      {
+        static const uint8_t i_level_add[5] = {2, 3, 6, 8, 10};
+        uint8_t i_t_rand = testRandom(0, i_num_barrel_leds / 3) + i_level_add[level - 1];
+
+        for(uint8_t i = i_barrel_light + 1; i < i_barrel_light + i_t_rand; i++) {
+          if(i < i_num_barrel_leds) {
+            memcpy(&leds[GPSTAR_BARREL[i] * 3], &c_colour, 3);
+          }
+        }
+      }
+      break;
+
+      default:
+      {
+        uint8_t i_t_rand_def = testRandom(0, i_num_barrel_leds / 4);
+
+        for(uint8_t i = i_barrel_light + 1; i < i_barrel_light + i_t_rand_def; i++) {
+          if(i < i_num_barrel_leds) {
+            memcpy(&leds[GPSTAR_BARREL[i] * 3], &c_colour, 3);
+          }
+        }
+      }
+      break;
+    }
+
+    static const uint8_t i_meson[5] = {4, 3, 3, 3, 2};
+    static const uint8_t i_proton[5] = {8, 7, 6, 5, 4};
+    static const uint8_t i_default[5] = {6, 5, 4, 3, 2};
+
+    switch(mode) {
+      case TEST_MESON: i_next = i_meson[level - 1]; break;
+      case TEST_PROTON: i_next = i_proton[level - 1]; break;
+      default: i_next = i_default[level - 1]; break;
+    }
+
+    i_barrel_light++;
+  }
+
+  return i_next;
+}
+
+static void compareStream(TestStream mode, const BarrelStreamParams* params, uint8_t level) {
+  uint8_t original[50 * 3] = {};
+  uint8_t ported[50 * 3] = {};
+  BarrelStrip strip(ported, 48, GPSTAR_BARREL, 48);
+  const BarrelColour head = {255, 255, 255};
+  const BarrelColour trail = {200, 0, 0};
+  uint8_t i_original_light = 0;
+  uint8_t i_ported_light = 0;
+  uint32_t i_seed = 99 + level;
+
+  for(uint16_t step = 0; step < 500; step++) {
+    g_seed = i_seed;
+    uint8_t i_original = originalStreamStep(original, 48, mode, level, i_original_light, head, trail);
+    uint32_t i_original_seed = g_seed;
+
+    g_seed = i_seed;
+    uint8_t i_ported = barrelStreamStep(strip, params, level, i_ported_light, head, trail, testRandom);
+    i_seed = g_seed;
+
+    ASSERT_EQ(i_seed, i_original_seed) << "step " << step;
+    ASSERT_EQ(i_ported, i_original) << "step " << step;
+    ASSERT_EQ(i_ported_light, i_original_light) << "step " << step;
+    ASSERT_EQ(memcmp(ported, original, sizeof(original)), 0) << "step " << step;
+  }
+}
+
+TEST(BarrelStream, MatchesOriginalStreams) {
+  for(uint8_t level = 1; level <= 5; level++) {
+    SCOPED_TRACE(testing::Message() << "level " << (int)level);
+    compareStream(TEST_PROTON, &BARREL_STREAM_PROTON, level);
+    compareStream(TEST_MESON, &BARREL_STREAM_MESON, level);
+    compareStream(TEST_DEFAULT, &BARREL_STREAM_DEFAULT, level);
+  }
+}
+
+TEST(BarrelStream, HasbroBarrelLightsOneLedPerStep) {
+  uint8_t pixels[5 * 3] = {};
+  BarrelStrip strip(pixels, 5);
+  const BarrelColour head = {255, 255, 255};
+  const BarrelColour trail = {0, 0, 0};
+  uint8_t i_position = 0;
+
+  EXPECT_EQ(barrelStreamStep(strip, &BARREL_STREAM_HASBRO, 1, i_position, head, trail, testRandom), 30);
+  EXPECT_TRUE(sameColour(&pixels[0], head));
+  EXPECT_TRUE(sameColour(&pixels[3], trail));
+
+  for(uint8_t i = 1; i < 5; i++) {
+    EXPECT_EQ(barrelStreamStep(strip, &BARREL_STREAM_HASBRO, 1, i_position, head, trail, testRandom), 30);
+  }
+
+  EXPECT_EQ(barrelStreamStep(strip, &BARREL_STREAM_HASBRO, 1, i_position, head, trail, testRandom), 100);
+  EXPECT_EQ(i_position, 0);
+  EXPECT_EQ(barrelStreamStep(strip, &BARREL_STREAM_HASBRO_MESON, 5, i_position, head, trail, testRandom), 24);
+}
+
+/*
+ * Reference: the zones written on each step of the pulse effects before the port, as
+ * {zone, shade} pairs, with the step on which the tip light came on.
+ */
+struct PulseWrite {
+  int8_t zone;
+  uint8_t shade;
+};
+
+static const PulseWrite BOSON_DART_STEPS[10][6] = {
+  {{0, 0}, {-1, 0}},
+  {{0, 1}, {1, 0}, {-1, 0}},
+  {{0, 2}, {1, 1}, {2, 0}, {-1, 0}},
+  {{0, 3}, {1, 2}, {2, 1}, {3, 0}, {-1, 0}},
+  {{0, 4}, {1, 3}, {2, 2}, {3, 1}, {4, 0}, {-1, 0}},
+  {{0, 5}, {1, 4}, {2, 3}, {3, 2}, {4, 1}, {-1, 0}},
+  {{1, 5}, {2, 4}, {3, 3}, {4, 2}, {-1, 0}},
+  {{2, 5}, {3, 4}, {4, 3}, {-1, 0}},
+  {{3, 5}, {4, 4}, {-1, 0}},
+  {{4, 5}, {-1, 0}}
+};
+
+static const PulseWrite SHOCK_BLAST_STEPS[14][4] = {
+  {{0, 0}, {-1, 0}},
+  {{0, 1}, {-1, 0}},
+  {{0, 2}, {1, 0}, {-1, 0}},
+  {{0, 3}, {1, 1}, {-1, 0}},
+  {{0, 4}, {1, 2}, {2, 0}, {-1, 0}},
+  {{0, 5}, {1, 3}, {2, 1}, {-1, 0}},
+  {{1, 4}, {2, 2}, {3, 0}, {-1, 0}},
+  {{1, 5}, {2, 3}, {3, 1}, {-1, 0}},
+  {{2, 4}, {3, 2}, {4, 0}, {-1, 0}},
+  {{2, 5}, {3, 3}, {4, 1}, {-1, 0}},
+  {{3, 4}, {4, 2}, {-1, 0}},
+  {{3, 5}, {4, 3}, {-1, 0}},
+  {{4, 4}, {-1, 0}},
+  {{4, 5}, {-1, 0}}
+};
+
+template<size_t STEPS, size_t WRITES>
+static void comparePulse(const BarrelPulseParams* params, const PulseWrite (&steps)[STEPS][WRITES], uint8_t tip) {
+  uint8_t original[50 * 3] = {};
+  uint8_t ported[50 * 3] = {};
+  BarrelStrip original_strip(original, 48, GPSTAR_BARREL, 48);
+  BarrelStrip ported_strip(ported, 48, GPSTAR_BARREL, 48);
+  BarrelColour shades[BARREL_PULSE_SHADES];
+
+  for(uint8_t i = 0; i < BARREL_PULSE_SHADES; i++) {
+    shades[i] = hsvToRgb(i * 40, 255, i == BARREL_PULSE_SHADES - 1 ? 0 : 255);
+  }
+
+  BarrelPulse pulse;
+  pulse.start(params, shades);
+
+  for(uint8_t step = 0; step < STEPS; step++) {
+    for(uint8_t i = 0; i < WRITES && steps[step][i].zone >= 0; i++) {
+      original_strip.fillZone(steps[step][i].zone, shades[steps[step][i].shade]);
+    }
+
+    bool b_more = pulse.step(ported_strip);
+
+    ASSERT_EQ(memcmp(ported, original, sizeof(original)), 0) << "step " << (int)step;
+    ASSERT_EQ(pulse.atTip(), step == tip) << "step " << (int)step;
+    ASSERT_EQ(b_more, (size_t)(step + 1) < STEPS) << "step " << (int)step;
+  }
+
+  EXPECT_FALSE(pulse.isRunning());
+}
+
+TEST(BarrelPulse, MatchesOriginalBosonDart) {
+  comparePulse(&BARREL_PULSE_BOSON_DART, BOSON_DART_STEPS, 4);
+}
+
+TEST(BarrelPulse, MatchesOriginalShockBlastAndMesonCollider) {
+  comparePulse(&BARREL_PULSE_SHOCK_BLAST, SHOCK_BLAST_STEPS, 8);
+  comparePulse(&BARREL_PULSE_MESON_COLLIDER, SHOCK_BLAST_STEPS, 8);
+}
+
+/*
+ * Benchmarks: the cost of one main loop pass while firing on the GPStar barrel, before (two colour
+ * conversions each pass plus one for the trail on each step) and after (palette reads).
+ */
+static double nanosPerPass(void (*pass)(uint32_t), uint32_t passes) {
+  auto start = std::chrono::steady_clock::now();
+
+  for(uint32_t i = 0; i < passes; i++) {
+    pass(i);
+  }
+
+  return std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count() / passes;
+}
+
+static uint8_t g_pixels[50 * 3];
+static uint8_t g_light = 0;
+static TestStream g_mode = TEST_PROTON;
+static const BarrelStreamParams* g_params = &BARREL_STREAM_PROTON;
+static BarrelPalette g_palette(testColour);
+
+// A step is due on one pass in four, about the rate of the stream timers against the main loop.
+static void originalPass(uint32_t i) {
+  BarrelColour c_start = testColour(5);
+  BarrelColour c_effect = testColour(20);
+  (void)c_start;
+
+  if((i & 0x03) == 0) {
+    originalStreamStep(g_pixels, 48, g_mode, 5, g_light, c_effect, testColour(5));
+  }
+}
+
+static void portedPass(uint32_t i) {
+  static BarrelStrip strip(g_pixels, 48, GPSTAR_BARREL, 48);
+  const BarrelColour& c_start = g_palette.get(5);
+  const BarrelColour& c_effect = g_palette.get(20);
+
+  if((i & 0x03) == 0) {
+    barrelStreamStep(strip, g_params, 5, g_light, c_effect, c_start, testRandom);
+  }
+}
+
+TEST(BarrelEffectsBenchmark, StreamPassPerMode) {
+  struct { const char* name; TestStream mode; const BarrelStreamParams* params; } modes[] = {
+    {"proton", TEST_PROTON, &BARREL_STREAM_PROTON},
+    {"meson", TEST_MESON, &BARREL_STREAM_MESON},
+    {"default", TEST_DEFAULT, &BARREL_STREAM_DEFAULT}
+  };
+
+  for(auto& mode : modes) {
+    g_mode = mode.mode;
+    g_params = mode.params;
+
+    g_light = 0;
+    g_conversions = 0;
+    double before = nanosPerPass(originalPass, 1000000);
+    uint32_t i_before = g_conversions;
+
+    g_light = 0;
+    g_conversions = 0;
+    g_palette.invalidate();
+    double after = nanosPerPass(portedPass, 1000000);
+    uint32_t i_after = g_conversions;
+
+    printf("[          ] stream %-7s: %.1f ns/pass -> %.1f ns/pass, colour conversions %u -> %u\n", mode.name, before, after,
+           (unsigned)i_before, (unsigned)i_after);
+    EXPECT_LE(i_after, 2u);
+  }
+}
+
+TEST(BarrelEffectsBenchmark, PulsePerMode) {
+  struct { const char* name; const BarrelPulseParams* params; uint8_t steps; } modes[] = {
+    {"boson dart", &BARREL_PULSE_BOSON_DART, 10},
+    {"shock blast", &BARREL_PULSE_SHOCK_BLAST, 14},
+    {"meson collider", &BARREL_PULSE_MESON_COLLIDER, 14}
+  };
+
+  uint8_t pixels[50 * 3] = {};
+  BarrelStrip strip(pixels, 48, GPSTAR_BARREL, 48);
+  const uint32_t i_pulses = 20000;
+
+  for(auto& mode : modes) {
+    const PulseWrite* steps = (mode.steps == 10) ? &BOSON_DART_STEPS[0][0] : &SHOCK_BLAST_STEPS[0][0];
+    uint8_t i_writes = (mode.steps == 10) ? 6 : 4;
+
+    // Before: every LED of a zone converted its colour on its own.
+    g_conversions = 0;
+    auto start = std::chrono::steady_clock::now();
+    for(uint32_t n = 0; n < i_pulses; n++) {
+      for(uint8_t s = 0; s < mode.steps; s++) {
+        for(uint8_t w = 0; w < i_writes && steps[s * i_writes + w].zone >= 0; w++) {
+          uint8_t i_zone = steps[s * i_writes + w].zone;
+          static const uint8_t i_zone_start[6] = {0, 12, 20, 28, 36, 48};
+
+          for(uint8_t i = i_zone_start[i_zone]; i < i_zone_start[i_zone + 1]; i++) {
+            BarrelColour c = testColour(steps[s * i_writes + w].shade + 1);
+            memcpy(&pixels[GPSTAR_BARREL[i] * 3], &c, 3);
+          }
+        }
+      }
+    }
+    double before = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count() / (i_pulses * mode.steps);
+    uint32_t i_before = g_conversions / i_pulses;
+
+    // After: the shades are taken from the palette once per pulse.
+    g_conversions = 0;
+    g_palette.invalidate();
+    BarrelPulse pulse;
+    start = std::chrono::steady_clock::now();
+    for(uint32_t n = 0; n < i_pulses; n++) {
+      BarrelColour shades[BARREL_PULSE_SHADES];
+      for(uint8_t i = 0; i < BARREL_PULSE_SHADES; i++) {
+        shades[i] = g_palette.get(i + 1);
+      }
+
+      pulse.start(mode.params, shades);
+      while(pulse.step(strip)) {
+      }
+    }
+    double after = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count() / (i_pulses * mode.steps);
+
+    printf("[          ] pulse %-14s: %.1f ns/step -> %.1f ns/step, colour conversions per pulse %u -> %u\n", mode.name, before,
+           after, (unsigned)i_before, (unsigned)(g_conversions / i_pulses));
+  }
+}
@@ -200,6 +200,7 @@ enum PACK_MESSAGE : uint8_t {
   P_POST_FINISH,
   P_SYSTEM_LOCKOUT,
   P_CANCEL_LOCKOUT,
+  P_IDLE_SLEEP,
   P_NO_OP
 };
 
@@ -439,6 +440,7 @@ enum WAND_MESSAGE : uint8_t {
   W_SET_FIRING_MODE,
   W_VENT_LIGHT_COLOURS_DISABLED,
   W_VENT_LIGHT_COLOURS_ENABLED, // 230
+  W_IDLE_SLEEP,
   W_NO_OP
 };
 
@@ -0,0 +1,177 @@
+/**
+ *   CpuGovernor - Load-aware CPU frequency scaling for GPStar devices.
+ *   Measures how busy each core is and steps the clock between a set of frequencies with hysteresis.
+ *   Copyright (C) 2023-2026 Michael Rajotte, Dustin Grau, Nomake Wan
+ *
+ *   This program is free software; you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation; either version 3 of the License, or
+ *   (at your option) any later version.
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License
+ *   along with this program; if not, see <https://www.gnu.org/licenses/>.
+ *
+ */
+
+#pragma once
+
+// Standard library includes for integer type definitions
+#include <stdint.h>  // Provides uint8_t, uint32_t, etc.
+#include <stdbool.h> // Provides bool type definition.
+
+#if defined(ESP32)
+  #include <freertos/FreeRTOS.h>
+  #include <freertos/task.h>
+#endif
+
+// Maximum number of frequencies a governor may step between.
+#define CPU_GOVERNOR_MAX_LEVELS 4
+
+// Number of cores tracked by a CpuLoadMeter.
+#define CPU_LOAD_METER_CORES 2
+
+// Load is given in parts per thousand of the measurement window.
+#define CPU_LOAD_FULL 1000
+
+/*
+ * Defaults shared by the GPStar ESP32 devices, which step between 80, 160 and 240 MHz.
+ * None of these frequencies change the 80 MHz APB clock, so the UARTs, i2c, LEDC, PCNT and RMT
+ * (FastLED) keep their timing, as do millis() and micros(). Nothing runs below 80 MHz, as the
+ * WiFi needs at least that.
+ */
+#define CPU_GOVERNOR_WINDOW_MS 250     // Measurement window (ms).
+#define CPU_GOVERNOR_UP_LOAD 750       // Load (per thousand) which goes straight to the highest frequency.
+#define CPU_GOVERNOR_DOWN_LOAD 550     // Load needed at the next lower frequency to step down.
+#define CPU_GOVERNOR_DOWN_WINDOWS 8    // Quiet windows (2 seconds) needed to step down.
+
+// Returns the current time in microseconds, eg. micros().
+typedef uint32_t (*CpuClock)();
+
+/**
+ * Class: CpuLoadMeter
+ * Purpose: Measures the fraction of time each core spends doing work.
+ *
+ * Each task marks the start and end of its work with enter() and leave() around the code which
+ * runs between its delays. Spans on the same core are merged, so a task which preempts another
+ * in the middle of its work is not counted twice. Time spent blocked inside a span (eg. waiting
+ * on the bus) is counted as busy, so spans should not include the task's delay.
+ *
+ * sample() closes the current window and returns the load of the busiest core, since the clock
+ * is shared between cores and must suit whichever needs it most.
+ *
+ * Example usage:
+ *   CpuLoadMeter cpuLoad(micros);
+ *   cpuLoad.enter(xPortGetCoreID());
+ *   doWork();
+ *   cpuLoad.leave(xPortGetCoreID());
+ *   vTaskDelay(1);
+ */
+class CpuLoadMeter {
+public:
+  CpuLoadMeter(CpuClock clock);
+
+  // Starts a new measurement window.
+  void begin();
+
+  // Marks the start and end of work on a core. Calls may be nested.
+  void enter(uint8_t core);
+  void leave(uint8_t core);
+
+  // Removes time from the current span on a core, eg. time spent in light sleep.
+  void excuse(uint8_t core, uint32_t micros);
+
+  // Ends the window and starts the next. Returns the load of the busiest core.
+  uint16_t sample();
+
+  // Load of one core over the last window.
+  uint16_t getCoreLoad(uint8_t core) const;
+
+private:
+  void lock() const;
+  void unlock() const;
+
+  CpuClock clock;
+  uint32_t windowStart;
+  uint8_t depth[CPU_LOAD_METER_CORES];
+  uint32_t spanStart[CPU_LOAD_METER_CORES];
+  uint32_t busy[CPU_LOAD_METER_CORES];
+  uint16_t load[CPU_LOAD_METER_CORES];
+
+#if defined(ESP32)
+  mutable portMUX_TYPE mux;
+#endif
+};
+
+/**
+ * Class: CpuGovernor
+ * Purpose: Chooses the CPU frequency from the measured load, and records the time spent at each.
+ *
+ * The policy is the same as the Linux "ondemand" governor:
+ *  - When the load reaches the up threshold the clock goes straight to the highest frequency, as
+ *    a saturated core gives no indication of how much more it needs.
+ *  - When the load scaled to the next lower frequency would stay under the down threshold for
+ *    the given number of windows, the clock steps down one frequency.
+ * Keeping the down threshold below the up threshold means a step down never lands on a load which
+ * would immediately step back up.
+ *
+ * Frequencies are in MHz and must be given in ascending order. The caller applies the frequency
+ * returned by update(), eg. with setCpuFrequencyMhz().
+ *
+ * Example usage:
+ *   const uint16_t levels[] = {80, 160, 240};
+ *   governor.setLevels(levels, 3);
+ *   governor.begin(millis(), getCpuFrequencyMhz());
+ *   uint16_t mhz = governor.update(millis(), cpuLoad.sample()); // Every window.
+ */
+class CpuGovernor {
+public:
+  CpuGovernor();
+
+  // Sets the available frequencies, in ascending order. Returns false if they are unusable.
+  bool setLevels(const uint16_t* frequencies, uint8_t count);
+
+  // Sets the up and down thresholds (parts per thousand) and the windows needed to step down.
+  void setThresholds(uint16_t upLoad, uint16_t downLoad, uint8_t downWindows);
+
+  // Sets the shared GPStar frequencies and thresholds (the CPU_GOVERNOR_ defaults above).
+  void useDefaults();
+
+  // Starts at the given frequency (or the nearest level below it) and clears the residency.
+  void begin(uint32_t now, uint16_t frequency);
+
+  // Processes the load for one window. Returns the frequency the CPU should run at.
+  uint16_t update(uint32_t now, uint16_t load);
+
+  uint16_t getFrequency() const;
+  uint16_t getLoad() const; // Load from the last update.
+  uint8_t getLevelCount() const;
+  uint16_t getLevelFrequency(uint8_t level) const;
+
+  // Time (ms) spent at a level, including the current stretch.
+  uint32_t getResidency(uint8_t level, uint32_t now) const;
+
+  uint32_t getSwitchCount() const; // Number of frequency changes since begin().
+
+  // Clears the residency and switch count, keeping the current frequency.
+  void resetResidency(uint32_t now);
+
+private:
+  void enterLevel(uint8_t next, uint32_t now);
+
+  uint16_t levels[CPU_GOVERNOR_MAX_LEVELS];
+  uint8_t levelCount;
+  uint8_t level;
+  uint16_t upLoad;
+  uint16_t downLoad;
+  uint8_t downWindows;
+  uint8_t quietWindows; // Consecutive windows which would allow a step down.
+  uint16_t lastLoad;
+  uint32_t enteredAt;
+  uint32_t residency[CPU_GOVERNOR_MAX_LEVELS];
+  uint32_t switches;
+};
@@ -0,0 +1,50 @@
+/**
+ *   CpuGovernor - Load-aware CPU frequency scaling for GPStar devices.
+ *   Measures how busy each core is and steps the clock between a set of frequencies with hysteresis.
+ *   Copyright (C) 2023-2026 Michael Rajotte, Dustin Grau, Nomake Wan
+ *
+ *   This program is free software; you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation; either version 3 of the License, or
+ *   (at your option) any later version.
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License
+ *   along with this program; if not, see <https://www.gnu.org/licenses/>.
+ *
+ */
+
+#pragma once
+
+#include "CpuGovernor.h"
+
+#if defined(ESP32) && defined(ARDUINO)
+#include <Arduino.h>
+
+/*
+ * Glue for the devices which run the governor from a FreeRTOS task (Attenuator, Belt Gizmo and
+ * Stream Effects). Each device owns its CpuLoadMeter and CpuGovernor, marks the work in its looping
+ * tasks with enter() and leave(), and starts a task which calls runCpuGovernorTask().
+ *
+ * Example usage:
+ *   CpuLoadMeter cpuLoad(cpuGovernorMicros);
+ *   CpuGovernor cpuGovernor;
+ *
+ *   void CpuGovernorTask(void *parameter) {
+ *     runCpuGovernorTask(cpuGovernor, cpuLoad);
+ *   }
+ */
+
+// Clock for a CpuLoadMeter, as micros() does not match the CpuClock signature on every core.
+uint32_t cpuGovernorMicros();
+
+// Applies the defaults and changes the clock at the end of each window. Never returns.
+void runCpuGovernorTask(CpuGovernor& governor, CpuLoadMeter& meter);
+
+// Prints the load of each core and the time spent at each frequency.
+void printCpuResidency(Print& out, const CpuGovernor& governor, const CpuLoadMeter& meter);
+#endif
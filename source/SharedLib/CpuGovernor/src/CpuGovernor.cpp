@@ -0,0 +1,296 @@
+/**
+ *   CpuGovernor - Load-aware CPU frequency scaling for GPStar devices.
+ *   Measures how busy each core is and steps the clock between a set of frequencies with hysteresis.
+ *   Copyright (C) 2023-2026 Michael Rajotte, Dustin Grau, Nomake Wan
+ *
+ *   This program is free software; you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation; either version 3 of the License, or
+ *   (at your option) any later version.
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License
+ *   along with this program; if not, see <https://www.gnu.org/licenses/>.
+ *
+ */
+
+// Library Header
+#include "CpuGovernor.h"
+
+CpuLoadMeter::CpuLoadMeter(CpuClock clock) : clock(clock), windowStart(0) {
+#if defined(ESP32)
+  portMUX_INITIALIZE(&mux);
+#endif
+
+  for(uint8_t i = 0; i < CPU_LOAD_METER_CORES; i++) {
+    depth[i] = 0;
+    spanStart[i] = 0;
+    busy[i] = 0;
+    load[i] = 0;
+  }
+}
+
+// Spans are marked from tasks on both cores on the ESP32. Elsewhere everything runs in the main loop.
+void CpuLoadMeter::lock() const {
+#if defined(ESP32)
+  portENTER_CRITICAL(&mux);
+#endif
+}
+
+void CpuLoadMeter::unlock() const {
+#if defined(ESP32)
+  portEXIT_CRITICAL(&mux);
+#endif
+}
+
+void CpuLoadMeter::begin() {
+  lock();
+
+  windowStart = clock();
+
+  for(uint8_t i = 0; i < CPU_LOAD_METER_CORES; i++) {
+    spanStart[i] = windowStart;
+    busy[i] = 0;
+  }
+
+  unlock();
+}
+
+void CpuLoadMeter::enter(uint8_t core) {
+  if(core >= CPU_LOAD_METER_CORES) {
+    return;
+  }
+
+  uint32_t now = clock();
+
+  lock();
+
+  if(depth[core]++ == 0) {
+    spanStart[core] = now;
+  }
+
+  unlock();
+}
+
+void CpuLoadMeter::leave(uint8_t core) {
+  if(core >= CPU_LOAD_METER_CORES) {
+    return;
+  }
+
+  uint32_t now = clock();
+
+  lock();
+
+  if(depth[core] > 0 && --depth[core] == 0 && (int32_t)(now - spanStart[core]) > 0) {
+    busy[core] += now - spanStart[core];
+  }
+
+  unlock();
+}
+
+void CpuLoadMeter::excuse(uint8_t core, uint32_t micros) {
+  if(core >= CPU_LOAD_METER_CORES) {
+    return;
+  }
+
+  lock();
+
+  // Moving the start of the open span forward removes the time from it.
+  if(depth[core] > 0) {
+    spanStart[core] += micros;
+  }
+
+  unlock();
+}
+
+uint16_t CpuLoadMeter::sample() {
+  uint16_t busiest = 0;
+
+  lock();
+
+  uint32_t now = clock();
+  uint32_t window = now - windowStart;
+
+  for(uint8_t i = 0; i < CPU_LOAD_METER_CORES; i++) {
+    // Split any open span at the end of the window.
+    if(depth[i] > 0) {
+      if((int32_t)(now - spanStart[i]) > 0) {
+        busy[i] += now - spanStart[i];
+      }
+
+      spanStart[i] = now;
+    }
+
+    if(window == 0 || busy[i] >= window) {
+      load[i] = window == 0 ? 0 : CPU_LOAD_FULL;
+    }
+    else {
+      load[i] = (uint16_t)((uint64_t)busy[i] * CPU_LOAD_FULL / window);
+    }
+
+    if(load[i] > busiest) {
+      busiest = load[i];
+    }
+
+    busy[i] = 0;
+  }
+
+  windowStart = now;
+
+  unlock();
+
+  return busiest;
+}
+
+uint16_t CpuLoadMeter::getCoreLoad(uint8_t core) const {
+  if(core >= CPU_LOAD_METER_CORES) {
+    return 0;
+  }
+
+  lock();
+  uint16_t coreLoad = load[core];
+  unlock();
+
+  return coreLoad;
+}
+
+CpuGovernor::CpuGovernor()
+  : levelCount(0), level(0), upLoad(800), downLoad(600), downWindows(4), quietWindows(0), lastLoad(0), enteredAt(0), switches(0) {
+  for(uint8_t i = 0; i < CPU_GOVERNOR_MAX_LEVELS; i++) {
+    levels[i] = 0;
+    residency[i] = 0;
+  }
+}
+
+bool CpuGovernor::setLevels(const uint16_t* frequencies, uint8_t count) {
+  if(frequencies == nullptr || count == 0 || count > CPU_GOVERNOR_MAX_LEVELS) {
+    return false;
+  }
+
+  for(uint8_t i = 0; i < count; i++) {
+    if(frequencies[i] == 0 || (i > 0 && frequencies[i] <= frequencies[i - 1])) {
+      return false;
+    }
+  }
+
+  for(uint8_t i = 0; i < count; i++) {
+    levels[i] = frequencies[i];
+  }
+
+  levelCount = count;
+  level = 0;
+
+  return true;
+}
+
+void CpuGovernor::setThresholds(uint16_t up, uint16_t down, uint8_t windows) {
+  upLoad = up;
+  downLoad = down < up ? down : up;
+  downWindows = windows > 0 ? windows : 1;
+}
+
+void CpuGovernor::useDefaults() {
+  static const uint16_t defaultLevels[] = {80, 160, 240};
+
+  setLevels(defaultLevels, sizeof(defaultLevels) / sizeof(defaultLevels[0]));
+  setThresholds(CPU_GOVERNOR_UP_LOAD, CPU_GOVERNOR_DOWN_LOAD, CPU_GOVERNOR_DOWN_WINDOWS);
+}
+
+void CpuGovernor::begin(uint32_t now, uint16_t frequency) {
+  level = 0;
+
+  for(uint8_t i = 0; i < levelCount; i++) {
+    if(levels[i] <= frequency) {
+      level = i;
+    }
+  }
+
+  quietWindows = 0;
+  lastLoad = 0;
+  resetResidency(now);
+}
+
+void CpuGovernor::enterLevel(uint8_t next, uint32_t now) {
+  residency[level] += now - enteredAt;
+  enteredAt = now;
+  level = next;
+  quietWindows = 0;
+  switches++;
+}
+
+uint16_t CpuGovernor::update(uint32_t now, uint16_t load) {
+  if(levelCount == 0) {
+    return 0;
+  }
+
+  lastLoad = load;
+
+  if(load >= upLoad) {
+    quietWindows = 0;
+
+    if(level < levelCount - 1) {
+      enterLevel(levelCount - 1, now);
+    }
+
+    return levels[level];
+  }
+
+  if(level == 0) {
+    return levels[level];
+  }
+
+  // The same work takes proportionally longer at a lower clock.
+  uint32_t projected = (uint32_t)load * levels[level] / levels[level - 1];
+
+  if(projected < downLoad) {
+    if(++quietWindows >= downWindows) {
+      enterLevel(level - 1, now);
+    }
+  }
+  else {
+    quietWindows = 0;
+  }
+
+  return levels[level];
+}
+
+uint16_t CpuGovernor::getFrequency() const {
+  return levelCount > 0 ? levels[level] : 0;
+}
+
+uint16_t CpuGovernor::getLoad() const {
+  return lastLoad;
+}
+
+uint8_t CpuGovernor::getLevelCount() const {
+  return levelCount;
+}
+
+uint16_t CpuGovernor::getLevelFrequency(uint8_t i) const {
+  return i < levelCount ? levels[i] : 0;
+}
+
+uint32_t CpuGovernor::getResidency(uint8_t i, uint32_t now) const {
+  if(i >= levelCount) {
+    return 0;
+  }
+
+  return i == level ? residency[i] + (now - enteredAt) : residency[i];
+}
+
+uint32_t CpuGovernor::getSwitchCount() const {
+  return switches;
+}
+
+void CpuGovernor::resetResidency(uint32_t now) {
+  for(uint8_t i = 0; i < CPU_GOVERNOR_MAX_LEVELS; i++) {
+    residency[i] = 0;
+  }
+
+  enteredAt = now;
+  switches = 0;
+}
@@ -0,0 +1,65 @@
+/**
+ *   CpuGovernor - Load-aware CPU frequency scaling for GPStar devices.
+ *   Measures how busy each core is and steps the clock between a set of frequencies with hysteresis.
+ *   Copyright (C) 2023-2026 Michael Rajotte, Dustin Grau, Nomake Wan
+ *
+ *   This program is free software; you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation; either version 3 of the License, or
+ *   (at your option) any later version.
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License
+ *   along with this program; if not, see <https://www.gnu.org/licenses/>.
+ *
+ */
+
+// Library Header
+#include "CpuGovernorTask.h"
+
+#if defined(ESP32) && defined(ARDUINO)
+uint32_t cpuGovernorMicros() {
+  return micros();
+}
+
+void runCpuGovernorTask(CpuGovernor& governor, CpuLoadMeter& meter) {
+  governor.useDefaults();
+  governor.begin(millis(), getCpuFrequencyMhz());
+  meter.begin();
+
+  while(true) {
+    vTaskDelay(CPU_GOVERNOR_WINDOW_MS / portTICK_PERIOD_MS);
+
+    uint16_t mhz = governor.update(millis(), meter.sample());
+
+    if(mhz != getCpuFrequencyMhz()) {
+      setCpuFrequencyMhz(mhz);
+    }
+  }
+}
+
+void printCpuResidency(Print& out, const CpuGovernor& governor, const CpuLoadMeter& meter) {
+  uint32_t now = millis();
+
+  out.print(F("CPU Busy Core0/Core1: "));
+  out.print(meter.getCoreLoad(0) / 10.0);
+  out.print(F("% / "));
+  out.print(meter.getCoreLoad(1) / 10.0);
+  out.println(F("%"));
+
+  for(uint8_t i = 0; i < governor.getLevelCount(); i++) {
+    out.print(F("|-"));
+    out.print(governor.getLevelFrequency(i));
+    out.print(F(" MHz: "));
+    out.print(governor.getResidency(i, now) / 1000);
+    out.println(F("s"));
+  }
+
+  out.print(F("|-Frequency Changes: "));
+  out.println(governor.getSwitchCount());
+}
+#endif
@@ -0,0 +1,245 @@
+/**
+ * Test suite for the CPU load meter and frequency governor.
+ */
+
+#include <gtest/gtest.h>
+#include "CpuGovernor.h"
+
+// Simulated time in microseconds.
+static uint32_t fake_micros = 0;
+
+static uint32_t fakeClock() {
+    return fake_micros;
+}
+
+static const uint16_t test_levels[] = {80, 160, 240};
+
+// Test fixture with the usual ESP32 frequencies, starting at 160 MHz.
+class CpuGovernorFixture : public ::testing::Test {
+protected:
+    CpuGovernor governor;
+
+    void SetUp() override {
+        ASSERT_TRUE(governor.setLevels(test_levels, 3));
+        governor.setThresholds(800, 600, 4);
+        governor.begin(0, 160);
+    }
+};
+
+TEST(CpuLoadMeterTest, MeasuresBusyFractionPerCore) {
+    fake_micros = 1000;
+    CpuLoadMeter meter(fakeClock);
+    meter.begin();
+
+    // Core 1 busy for 250us of each 1000us, core 0 for 100us.
+    for(int i = 0; i < 10; i++) {
+        meter.enter(1);
+        fake_micros += 250;
+        meter.leave(1);
+        meter.enter(0);
+        fake_micros += 100;
+        meter.leave(0);
+        fake_micros += 650;
+    }
+
+    EXPECT_EQ(meter.sample(), 250);
+    EXPECT_EQ(meter.getCoreLoad(0), 100);
+    EXPECT_EQ(meter.getCoreLoad(1), 250);
+}
+
+TEST(CpuLoadMeterTest, MergesNestedSpans) {
+    fake_micros = 0;
+    CpuLoadMeter meter(fakeClock);
+    meter.begin();
+
+    // A second task preempts the first part-way through its work.
+    meter.enter(1);
+    fake_micros += 100;
+    meter.enter(1);
+    fake_micros += 200;
+    meter.leave(1);
+    fake_micros += 100;
+    meter.leave(1);
+    fake_micros += 600;
+
+    EXPECT_EQ(meter.sample(), 400);
+}
+
+TEST(CpuLoadMeterTest, SplitsOpenSpanAcrossWindows) {
+    fake_micros = 0;
+    CpuLoadMeter meter(fakeClock);
+    meter.begin();
+
+    fake_micros += 500;
+    meter.enter(0);
+    fake_micros += 500;
+
+    EXPECT_EQ(meter.sample(), 500);
+
+    fake_micros += 1000;
+
+    EXPECT_EQ(meter.sample(), CPU_LOAD_FULL);
+
+    fake_micros += 300;
+    meter.leave(0);
+    fake_micros += 700;
+
+    EXPECT_EQ(meter.sample(), 300);
+}
+
+TEST(CpuLoadMeterTest, ExcusedTimeIsNotBusy) {
+    fake_micros = 0;
+    CpuLoadMeter meter(fakeClock);
+    meter.begin();
+
+    // 800us of light sleep inside a span leaves 200us of work.
+    meter.enter(1);
+    fake_micros += 1000;
+    meter.excuse(1, 800);
+    meter.leave(1);
+
+    EXPECT_EQ(meter.sample(), 200);
+}
+
+TEST(CpuLoadMeterTest, IgnoresUnknownCoreAndUnbalancedLeave) {
+    fake_micros = 0;
+    CpuLoadMeter meter(fakeClock);
+    meter.begin();
+
+    meter.enter(CPU_LOAD_METER_CORES);
+    meter.leave(0);
+    fake_micros += 1000;
+
+    EXPECT_EQ(meter.sample(), 0);
+    EXPECT_EQ(meter.getCoreLoad(CPU_LOAD_METER_CORES), 0);
+}
+
+TEST(CpuGovernorTest, RejectsUnusableLevels) {
+    CpuGovernor governor;
+    const uint16_t descending[] = {240, 160};
+    const uint16_t too_many[] = {40, 80, 120, 160, 240};
+
+    EXPECT_FALSE(governor.setLevels(descending, 2));
+    EXPECT_FALSE(governor.setLevels(too_many, 5));
+    EXPECT_FALSE(governor.setLevels(nullptr, 1));
+    EXPECT_EQ(governor.getLevelCount(), 0);
+    EXPECT_EQ(governor.update(0, 500), 0);
+}
+
+TEST_F(CpuGovernorFixture, StartsAtNearestLevelAtOrBelow) {
+    EXPECT_EQ(governor.getFrequency(), 160);
+
+    governor.begin(0, 200);
+    EXPECT_EQ(governor.getFrequency(), 160);
+
+    governor.begin(0, 40);
+    EXPECT_EQ(governor.getFrequency(), 80);
+}
+
+TEST_F(CpuGovernorFixture, JumpsToHighestLevelWhenBusy) {
+    governor.begin(0, 80);
+
+    EXPECT_EQ(governor.update(250, 850), 240);
+    EXPECT_EQ(governor.getSwitchCount(), 1);
+}
+
+TEST_F(CpuGovernorFixture, StepsDownOneLevelAfterQuietWindows) {
+    governor.begin(0, 240);
+
+    // 300 at 240 MHz projects to 450 at 160 MHz, which is under the down threshold.
+    for(int i = 1; i < 4; i++) {
+        EXPECT_EQ(governor.update(i * 250, 300), 240);
+    }
+
+    EXPECT_EQ(governor.update(1000, 300), 160);
+
+    // The same work is now 450, which projects to 900 at 80 MHz.
+    for(int i = 5; i < 20; i++) {
+        EXPECT_EQ(governor.update(i * 250, 450), 160);
+    }
+}
+
+TEST_F(CpuGovernorFixture, BusyWindowRestartsQuietCount) {
+    governor.begin(0, 240);
+
+    governor.update(250, 100);
+    governor.update(500, 100);
+    governor.update(750, 100);
+    governor.update(1000, 500); // Projects to 750, which is too busy to step down.
+    governor.update(1250, 100);
+    governor.update(1500, 100);
+    governor.update(1750, 100);
+
+    EXPECT_EQ(governor.getFrequency(), 240);
+    EXPECT_EQ(governor.update(2000, 100), 160);
+}
+
+// Runs a fixed demand (in MHz worth of work) through the governor, as the device would see it.
+static uint16_t loadAt(uint16_t demand, uint16_t frequency) {
+    uint32_t load = (uint32_t)demand * CPU_LOAD_FULL / frequency;
+    return load > CPU_LOAD_FULL ? CPU_LOAD_FULL : load;
+}
+
+TEST_F(CpuGovernorFixture, SettlesWithoutOscillating) {
+    const uint16_t demands[] = {20, 60, 100, 150, 180};
+    const uint16_t settled[] = {80, 160, 240, 240, 240};
+
+    for(int d = 0; d < 5; d++) {
+        governor.begin(0, 240);
+        uint32_t now = 0;
+
+        for(int i = 0; i < 40; i++) {
+            now += 250;
+            governor.update(now, loadAt(demands[d], governor.getFrequency()));
+        }
+
+        uint32_t switches = governor.getSwitchCount();
+        uint16_t frequency = governor.getFrequency();
+
+        for(int i = 0; i < 200; i++) {
+            now += 250;
+            governor.update(now, loadAt(demands[d], governor.getFrequency()));
+        }
+
+        EXPECT_EQ(governor.getFrequency(), frequency) << "demand " << demands[d];
+        EXPECT_EQ(governor.getSwitchCount(), switches) << "demand " << demands[d];
+        EXPECT_EQ(frequency, settled[d]) << "demand " << demands[d];
+        EXPECT_LT(loadAt(demands[d], frequency), 800) << "demand " << demands[d];
+    }
+}
+
+TEST_F(CpuGovernorFixture, RecordsResidencyPerLevel) {
+    governor.begin(1000, 160);
+
+    governor.update(1500, 900); // 500ms at 160, then 240.
+    governor.update(1750, 100);
+    governor.update(2000, 100);
+    governor.update(2250, 100);
+    governor.update(2500, 100); // 1000ms at 240, then 160.
+
+    EXPECT_EQ(governor.getResidency(0, 3000), 0u);
+    EXPECT_EQ(governor.getResidency(1, 3000), 1000u);
+    EXPECT_EQ(governor.getResidency(2, 3000), 1000u);
+    EXPECT_EQ(governor.getResidency(3, 3000), 0u);
+    EXPECT_EQ(governor.getSwitchCount(), 2u);
+
+    governor.resetResidency(3000);
+    EXPECT_EQ(governor.getResidency(1, 3100), 100u);
+    EXPECT_EQ(governor.getResidency(2, 3100), 0u);
+    EXPECT_EQ(governor.getSwitchCount(), 0u);
+    EXPECT_EQ(governor.getFrequency(), 160);
+}
+
+TEST(CpuGovernorTest, DefaultsUseSharedLevelsAndThresholds) {
+    CpuGovernor governor;
+    governor.useDefaults();
+    governor.begin(0, 160);
+
+    ASSERT_EQ(governor.getLevelCount(), 3);
+    EXPECT_EQ(governor.getLevelFrequency(0), 80);
+    EXPECT_EQ(governor.getLevelFrequency(2), 240);
+
+    // Just under the up threshold holds, and reaching it goes straight to the top.
+    EXPECT_EQ(governor.update(250, CPU_GOVERNOR_UP_LOAD - 1), 160);
+    EXPECT_EQ(governor.update(500, CPU_GOVERNOR_UP_LOAD), 240);
+}
@@ -0,0 +1,239 @@
+/**
+ *   I2CScheduler - Queued, non-blocking I2C transactions with completion callbacks for GPStar devices.
+ *   Serializes access to one or more I2C buses and accounts for the bus time used by each device.
+ *   Copyright (C) 2023-2026 Michael Rajotte, Dustin Grau, Nomake Wan
+ *
+ *   This program is free software; you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation; either version 3 of the License, or
+ *   (at your option) any later version.
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License
+ *   along with this program; if not, see <https://www.gnu.org/licenses/>.
+ *
+ */
+
+#pragma once
+
+// Standard library includes for integer type definitions
+#include <stdint.h>  // Provides uint8_t, uint32_t, etc.
+#include <stdbool.h> // Provides bool type definition.
+
+#if defined(ARDUINO)
+  #include <Arduino.h>
+  #include <Wire.h>
+#endif
+
+#if defined(ESP32)
+  #include <freertos/FreeRTOS.h>
+  #include <freertos/task.h>
+#endif
+
+// Maximum number of devices which may be registered with one scheduler.
+#define I2C_SCHEDULER_MAX_DEVICES 6
+
+// Maximum number of bytes written or read by a single queued transfer.
+#define I2C_SCHEDULER_MAX_DATA 8
+
+// Transaction status codes, matching those returned by TwoWire::endTransmission().
+#define I2C_STATUS_OK           0
+#define I2C_STATUS_TOO_LONG     1 // Data did not fit in the transmit buffer.
+#define I2C_STATUS_ADDRESS_NACK 2 // No device acknowledged the address.
+#define I2C_STATUS_DATA_NACK    3 // The device did not acknowledge a data byte.
+#define I2C_STATUS_OTHER        4
+#define I2C_STATUS_TIMEOUT      5
+#define I2C_STATUS_SHORT_READ   6 // The device returned fewer bytes than requested.
+
+struct I2CTransaction;
+
+// Returns the current time in microseconds, eg. micros().
+typedef uint32_t (*I2CClock)();
+
+// Called from dispatch() once a transaction has finished, successfully or not.
+typedef void (*I2CCallback)(const I2CTransaction& transaction);
+
+// Runs with exclusive use of the bus, for device libraries which drive the bus themselves.
+// Returns one of the I2C_STATUS codes.
+typedef uint8_t (*I2CJob)(void* context);
+
+/**
+ * Class: I2CBus
+ * Purpose: Performs a single blocking transfer on one physical bus.
+ *
+ * Implemented by WireBus on Arduino targets, or by a mock for native tests.
+ */
+class I2CBus {
+public:
+  // Writes txLength bytes then reads rxLength bytes, using a repeated start when both are given.
+  // Either length may be 0. Returns one of the I2C_STATUS codes.
+  virtual uint8_t transfer(uint8_t address, const uint8_t* tx, uint8_t txLength, uint8_t* rx, uint8_t rxLength) = 0;
+};
+
+#if defined(ARDUINO)
+/**
+ * Class: WireBus
+ * Purpose: An I2CBus on a TwoWire interface (Wire, Wire1).
+ */
+class WireBus : public I2CBus {
+public:
+  WireBus(TwoWire& wire) : wire(wire) {}
+
+  uint8_t transfer(uint8_t address, const uint8_t* tx, uint8_t txLength, uint8_t* rx, uint8_t rxLength) override;
+
+private:
+  TwoWire& wire;
+};
+#endif
+
+/**
+ * Struct: I2CTransaction
+ * Purpose: Storage for a single queued transaction, owned by an I2CScheduler.
+ *
+ * The same buffer holds the bytes to write and then the bytes read back.
+ */
+struct I2CTransaction {
+  I2CCallback callback = nullptr;
+  I2CJob job = nullptr;   // Runs in place of a transfer when set.
+  void* context = nullptr;
+  uint32_t queuedAt = 0;  // Time of submission, for measuring the wait for the bus.
+  uint8_t device = 0;
+  uint8_t status = I2C_STATUS_OK;
+  uint8_t txLength = 0;
+  uint8_t rxLength = 0;
+  uint8_t data[I2C_SCHEDULER_MAX_DATA] = {};
+};
+
+/**
+ * Struct: I2CDeviceStats
+ * Purpose: Bus-time accounting for one device. All times are in microseconds.
+ */
+struct I2CDeviceStats {
+  uint32_t transactions = 0;
+  uint32_t errors = 0;        // Transactions which finished with a non-zero status.
+  uint64_t busMicros = 0;     // Total time the device held the bus.
+  uint32_t maxBusMicros = 0;  // Longest single transaction.
+  uint32_t maxWaitMicros = 0; // Longest wait from submission until the bus was free.
+};
+
+/**
+ * Class: I2CScheduler
+ * Purpose: Queues I2C transactions from the main loop and runs them one at a time.
+ *
+ * Transactions are run in the order they were submitted by runNext(), which on the ESP32 is
+ * called by a background task (see startTask()) so the main loop never waits on the bus. Other
+ * targets call service() from the main loop to run transactions within a time budget. Either way
+ * callbacks are only ever made from dispatch(), so results are handled in the main loop without
+ * any locking by the caller.
+ *
+ * Device libraries which talk to the bus themselves can be scheduled as a job, which is run with
+ * the bus to itself. Once the scheduler is running, all bus traffic should go through it.
+ *
+ * Storage is supplied by the caller; use I2CSchedulerBuffer<N> for a self-contained scheduler.
+ * Device IDs are the device index + 1, so 0 always indicates failure.
+ *
+ * Example usage:
+ *   WireBus mainBus(Wire);
+ *   I2CSchedulerBuffer<8> i2c(micros);
+ *   uint8_t i_sensor = i2c.addDevice(&mainBus, 0x40, "sensor");
+ *   i2c.readRegister(i_sensor, 0x00, 2, onSensorRead);
+ *   i2c.dispatch(); // In the main loop.
+ */
+class I2CScheduler {
+public:
+  // Constructor, using caller-provided transaction storage of the given capacity.
+  I2CScheduler(I2CTransaction* slots, uint8_t capacity, I2CClock clock);
+
+  // Registers a device at the given address on a bus. Returns the device ID, or 0 if full.
+  // All devices should be added before the scheduler starts running transactions.
+  uint8_t addDevice(I2CBus* bus, uint8_t address, const char* name);
+
+  // Queues a write of txLength bytes followed by a read of rxLength bytes.
+  // Returns false if the queue is full, the device is unknown or the data is too long.
+  bool transfer(uint8_t device, const uint8_t* tx, uint8_t txLength, uint8_t rxLength, I2CCallback callback, void* context = nullptr);
+  bool write(uint8_t device, const uint8_t* data, uint8_t length, I2CCallback callback = nullptr, void* context = nullptr);
+  bool read(uint8_t device, uint8_t length, I2CCallback callback, void* context = nullptr);
+  bool readRegister(uint8_t device, uint8_t reg, uint8_t length, I2CCallback callback, void* context = nullptr);
+
+  // Queues a job which is given the bus to itself, accounted against the device.
+  bool submitJob(uint8_t device, I2CJob job, I2CCallback callback = nullptr, void* context = nullptr);
+
+  // Runs the oldest queued transaction. Returns false if nothing was waiting.
+  bool runNext();
+
+  // Runs queued transactions until the budget (in microseconds) is spent, always running at least
+  // one if any are waiting. Returns the number of transactions run.
+  uint8_t service(uint32_t budgetMicros);
+
+  // Makes the callbacks for all finished transactions, in order. Returns the number completed.
+  uint8_t dispatch();
+
+  // Whether the device has a transaction which has not yet been dispatched.
+  bool isPending(uint8_t device) const;
+
+  uint8_t getQueuedCount() const; // Transactions not yet dispatched, including those finished.
+  uint8_t getCapacity() const;
+  uint8_t getDeviceCount() const;
+  const char* getDeviceName(uint8_t device) const;
+  uint32_t getRejectedCount() const; // Submissions refused because the queue was full.
+
+  // Copies the accounting for one device. Returns false if the device is unknown.
+  bool getDeviceStats(uint8_t device, I2CDeviceStats& stats) const;
+  void resetStats();
+
+#if defined(ESP32)
+  // Runs transactions from a task on the given core, which sleeps whenever the queue is empty.
+  bool startTask(uint8_t core, uint8_t priority, uint16_t stackSize = 3072);
+#endif
+
+private:
+  struct Device {
+    I2CBus* bus;
+    const char* name;
+    uint8_t address;
+    uint8_t pending;
+    I2CDeviceStats stats;
+  };
+
+  I2CTransaction* queue(uint8_t device, I2CCallback callback, void* context);
+  void commit();
+  void lock() const;
+  void unlock() const;
+
+  I2CTransaction* slots;
+  uint8_t capacity;
+  I2CClock clock;
+
+  // Slots from head hold finished transactions (finished of them), then those waiting to run.
+  uint8_t head;
+  uint8_t count;
+  uint8_t finished;
+  uint32_t rejected;
+
+  Device devices[I2C_SCHEDULER_MAX_DEVICES];
+  uint8_t deviceCount;
+
+#if defined(ESP32)
+  static void taskEntry(void* parameter);
+
+  mutable portMUX_TYPE mux;
+  TaskHandle_t task;
+#endif
+};
+
+/**
+ * Class: I2CSchedulerBuffer
+ * Purpose: An I2CScheduler which carries its own storage for N queued transactions.
+ */
+template <uint8_t N>
+class I2CSchedulerBuffer : public I2CScheduler {
+public:
+  I2CSchedulerBuffer(I2CClock clock) : I2CScheduler(slotStore, N, clock) {}
+
+private:
+  I2CTransaction slotStore[N];
+};
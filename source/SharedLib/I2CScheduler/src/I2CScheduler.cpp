@@ -0,0 +1,355 @@
+/**
+ *   I2CScheduler - Queued, non-blocking I2C transactions with completion callbacks for GPStar devices.
+ *   Serializes access to one or more I2C buses and accounts for the bus time used by each device.
+ *   Copyright (C) 2023-2026 Michael Rajotte, Dustin Grau, Nomake Wan
+ *
+ *   This program is free software; you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation; either version 3 of the License, or
+ *   (at your option) any later version.
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License
+ *   along with this program; if not, see <https://www.gnu.org/licenses/>.
+ *
+ */
+
+// Library Header
+#include "I2CScheduler.h"
+
+#if defined(ARDUINO)
+uint8_t WireBus::transfer(uint8_t address, const uint8_t* tx, uint8_t txLength, uint8_t* rx, uint8_t rxLength) {
+  if(txLength > 0) {
+    wire.beginTransmission(address);
+    wire.write(tx, txLength);
+
+    // Keep hold of the bus with a repeated start when a read follows.
+    uint8_t status = wire.endTransmission(rxLength == 0);
+
+    if(status != I2C_STATUS_OK) {
+      return status;
+    }
+  }
+
+  if(rxLength > 0) {
+    if(wire.requestFrom(address, rxLength) != rxLength) {
+      return I2C_STATUS_SHORT_READ;
+    }
+
+    for(uint8_t i = 0; i < rxLength; i++) {
+      rx[i] = wire.read();
+    }
+  }
+
+  return I2C_STATUS_OK;
+}
+#endif
+
+I2CScheduler::I2CScheduler(I2CTransaction* slots, uint8_t capacity, I2CClock clock)
+  : slots(slots), capacity(capacity), clock(clock), head(0), count(0), finished(0), rejected(0), deviceCount(0) {
+#if defined(ESP32)
+  portMUX_INITIALIZE(&mux);
+  task = nullptr;
+#endif
+}
+
+// The queue is shared with the background task on the ESP32. Elsewhere everything runs in the main loop.
+void I2CScheduler::lock() const {
+#if defined(ESP32)
+  portENTER_CRITICAL(&mux);
+#endif
+}
+
+void I2CScheduler::unlock() const {
+#if defined(ESP32)
+  portEXIT_CRITICAL(&mux);
+#endif
+}
+
+uint8_t I2CScheduler::addDevice(I2CBus* bus, uint8_t address, const char* name) {
+  if(bus == nullptr || deviceCount >= I2C_SCHEDULER_MAX_DEVICES) {
+    return 0;
+  }
+
+  Device& device = devices[deviceCount];
+  device.bus = bus;
+  device.name = name;
+  device.address = address;
+  device.pending = 0;
+  device.stats = I2CDeviceStats();
+
+  return ++deviceCount;
+}
+
+// Claims the next free slot, leaving the lock held for the caller to fill it in and commit().
+I2CTransaction* I2CScheduler::queue(uint8_t device, I2CCallback callback, void* context) {
+  if(device == 0 || device > deviceCount) {
+    return nullptr;
+  }
+
+  uint32_t now = clock();
+
+  lock();
+
+  if(count >= capacity) {
+    rejected++;
+    unlock();
+    return nullptr;
+  }
+
+  I2CTransaction* transaction = &slots[(head + count) % capacity];
+  transaction->callback = callback;
+  transaction->job = nullptr;
+  transaction->context = context;
+  transaction->queuedAt = now;
+  transaction->device = device;
+  transaction->status = I2C_STATUS_OK;
+  transaction->txLength = 0;
+  transaction->rxLength = 0;
+
+  return transaction;
+}
+
+// Makes the slot claimed by queue() visible to runNext() and releases the lock.
+void I2CScheduler::commit() {
+  devices[slots[(head + count) % capacity].device - 1].pending++;
+  count++;
+
+  unlock();
+
+#if defined(ESP32)
+  if(task != nullptr) {
+    xTaskNotifyGive(task);
+  }
+#endif
+}
+
+bool I2CScheduler::transfer(uint8_t device, const uint8_t* tx, uint8_t txLength, uint8_t rxLength, I2CCallback callback, void* context) {
+  if(txLength > I2C_SCHEDULER_MAX_DATA || rxLength > I2C_SCHEDULER_MAX_DATA || (txLength > 0 && tx == nullptr)) {
+    return false;
+  }
+
+  I2CTransaction* transaction = queue(device, callback, context);
+
+  if(transaction == nullptr) {
+    return false;
+  }
+
+  for(uint8_t i = 0; i < txLength; i++) {
+    transaction->data[i] = tx[i];
+  }
+
+  transaction->txLength = txLength;
+  transaction->rxLength = rxLength;
+  commit();
+
+  return true;
+}
+
+bool I2CScheduler::write(uint8_t device, const uint8_t* data, uint8_t length, I2CCallback callback, void* context) {
+  return transfer(device, data, length, 0, callback, context);
+}
+
+bool I2CScheduler::read(uint8_t device, uint8_t length, I2CCallback callback, void* context) {
+  return transfer(device, nullptr, 0, length, callback, context);
+}
+
+bool I2CScheduler::readRegister(uint8_t device, uint8_t reg, uint8_t length, I2CCallback callback, void* context) {
+  return transfer(device, &reg, 1, length, callback, context);
+}
+
+bool I2CScheduler::submitJob(uint8_t device, I2CJob job, I2CCallback callback, void* context) {
+  if(job == nullptr) {
+    return false;
+  }
+
+  I2CTransaction* transaction = queue(device, callback, context);
+
+  if(transaction == nullptr) {
+    return false;
+  }
+
+  transaction->job = job;
+  commit();
+
+  return true;
+}
+
+bool I2CScheduler::runNext() {
+  lock();
+
+  if(finished >= count) {
+    unlock();
+    return false;
+  }
+
+  // Slots waiting to run are only touched here until they are marked as finished.
+  I2CTransaction& transaction = slots[(head + finished) % capacity];
+  unlock();
+
+  Device& device = devices[transaction.device - 1];
+  uint32_t start = clock();
+
+  if(transaction.job != nullptr) {
+    transaction.status = transaction.job(transaction.context);
+  }
+  else {
+    transaction.status = device.bus->transfer(device.address, transaction.data, transaction.txLength,
+                                              transaction.data, transaction.rxLength);
+  }
+
+  uint32_t elapsed = clock() - start;
+  uint32_t wait = start - transaction.queuedAt;
+
+  lock();
+
+  I2CDeviceStats& stats = device.stats;
+  stats.transactions++;
+  stats.busMicros += elapsed;
+
+  if(transaction.status != I2C_STATUS_OK) {
+    stats.errors++;
+  }
+
+  if(elapsed > stats.maxBusMicros) {
+    stats.maxBusMicros = elapsed;
+  }
+
+  if(wait > stats.maxWaitMicros) {
+    stats.maxWaitMicros = wait;
+  }
+
+  finished++;
+
+  unlock();
+
+  return true;
+}
+
+uint8_t I2CScheduler::service(uint32_t budgetMicros) {
+  uint32_t start = clock();
+  uint8_t ran = 0;
+
+  while(runNext()) {
+    ran++;
+
+    if(clock() - start >= budgetMicros) {
+      break;
+    }
+  }
+
+  return ran;
+}
+
+uint8_t I2CScheduler::dispatch() {
+  lock();
+  uint8_t completed = finished;
+  unlock();
+
+  // Only complete what had finished on entry, as callbacks may queue follow-on transactions.
+  for(uint8_t i = 0; i < completed; i++) {
+    I2CTransaction& transaction = slots[head];
+
+    if(transaction.callback != nullptr) {
+      transaction.callback(transaction);
+    }
+
+    lock();
+    devices[transaction.device - 1].pending--;
+    head = (head + 1) % capacity;
+    count--;
+    finished--;
+    unlock();
+  }
+
+  return completed;
+}
+
+bool I2CScheduler::isPending(uint8_t device) const {
+  if(device == 0 || device > deviceCount) {
+    return false;
+  }
+
+  lock();
+  bool pending = devices[device - 1].pending > 0;
+  unlock();
+
+  return pending;
+}
+
+uint8_t I2CScheduler::getQueuedCount() const {
+  lock();
+  uint8_t queued = count;
+  unlock();
+
+  return queued;
+}
+
+uint8_t I2CScheduler::getCapacity() const {
+  return capacity;
+}
+
+uint8_t I2CScheduler::getDeviceCount() const {
+  return deviceCount;
+}
+
+const char* I2CScheduler::getDeviceName(uint8_t device) const {
+  if(device == 0 || device > deviceCount) {
+    return nullptr;
+  }
+
+  return devices[device - 1].name;
+}
+
+uint32_t I2CScheduler::getRejectedCount() const {
+  return rejected;
+}
+
+bool I2CScheduler::getDeviceStats(uint8_t device, I2CDeviceStats& stats) const {
+  if(device == 0 || device > deviceCount) {
+    return false;
+  }
+
+  lock();
+  stats = devices[device - 1].stats;
+  unlock();
+
+  return true;
+}
+
+void I2CScheduler::resetStats() {
+  lock();
+
+  for(uint8_t i = 0; i < deviceCount; i++) {
+    devices[i].stats = I2CDeviceStats();
+  }
+
+  rejected = 0;
+
+  unlock();
+}
+
+#if defined(ESP32)
+void I2CScheduler::taskEntry(void* parameter) {
+  I2CScheduler* scheduler = static_cast<I2CScheduler*>(parameter);
+
+  for(;;) {
+    // A submission made between the failed runNext() and the wait leaves a notification pending.
+    if(!scheduler->runNext()) {
+      ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+    }
+  }
+}
+
+bool I2CScheduler::startTask(uint8_t core, uint8_t priority, uint16_t stackSize) {
+  if(task != nullptr) {
+    return true;
+  }
+
+  return xTaskCreatePinnedToCore(taskEntry, "I2CScheduler", stackSize, this, priority, &task, core) == pdPASS;
+}
+#endif
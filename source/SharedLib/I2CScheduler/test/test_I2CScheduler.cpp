@@ -0,0 +1,284 @@
+/**
+ * Test suite for the I2C transaction scheduler.
+ */
+
+#include <gtest/gtest.h>
+#include "I2CScheduler.h"
+#include <vector>
+
+// Simulated time in microseconds, advanced by the mock bus as transfers take place.
+static uint32_t fake_micros = 0;
+
+static uint32_t fakeClock() {
+    return fake_micros;
+}
+
+// Mock bus which records each transfer and answers reads from a per-address register file.
+struct MockBus : public I2CBus {
+    struct Record {
+        uint8_t address;
+        std::vector<uint8_t> tx;
+        uint8_t rxLength;
+    };
+
+    std::vector<Record> log;
+    uint8_t registers[128][4] = {};
+    uint8_t failAddress = 0xFF;
+    uint32_t microsPerByte = 25; // About 400kHz with addressing overhead.
+
+    uint8_t transfer(uint8_t address, const uint8_t* tx, uint8_t txLength, uint8_t* rx, uint8_t rxLength) override {
+        log.push_back(Record{address, std::vector<uint8_t>(tx, tx + txLength), rxLength});
+        fake_micros += (1 + txLength + rxLength) * microsPerByte;
+
+        if(address == failAddress) {
+            return I2C_STATUS_ADDRESS_NACK;
+        }
+
+        for(uint8_t i = 0; i < rxLength; i++) {
+            rx[i] = registers[address][i % 4];
+        }
+
+        return I2C_STATUS_OK;
+    }
+};
+
+// Record of completed transactions, in callback order.
+struct Completion {
+    uint8_t device;
+    uint8_t status;
+    std::vector<uint8_t> data;
+};
+
+static std::vector<Completion> completions;
+
+static void recordCompletion(const I2CTransaction& transaction) {
+    completions.push_back(Completion{transaction.device, transaction.status,
+                                     std::vector<uint8_t>(transaction.data, transaction.data + transaction.rxLength)});
+}
+
+// Test fixture with two devices on one bus and a third on a second bus.
+class I2CSchedulerFixture : public ::testing::Test {
+protected:
+    MockBus bus;
+    MockBus bus1;
+    I2CSchedulerBuffer<4> scheduler{fakeClock};
+    uint8_t meter = 0;
+    uint8_t sensor = 0;
+    uint8_t temp = 0;
+
+    // SetUp() is called before each test.
+    void SetUp() override {
+        fake_micros = 1000;
+        completions.clear();
+        meter = scheduler.addDevice(&bus, 0x40, "meter");
+        sensor = scheduler.addDevice(&bus, 0x6A, "sensor");
+        temp = scheduler.addDevice(&bus1, 0x40, "temp");
+    }
+};
+
+TEST_F(I2CSchedulerFixture, CanInstantiate) {
+    EXPECT_EQ(scheduler.getCapacity(), 4);
+    EXPECT_EQ(scheduler.getQueuedCount(), 0);
+    EXPECT_EQ(scheduler.getDeviceCount(), 3);
+    EXPECT_STREQ(scheduler.getDeviceName(sensor), "sensor");
+    EXPECT_EQ(scheduler.getDeviceName(0), nullptr);
+    EXPECT_FALSE(scheduler.runNext());
+    EXPECT_EQ(scheduler.dispatch(), 0);
+}
+
+// Device IDs start at 1 and run out at the device limit.
+TEST_F(I2CSchedulerFixture, AddDeviceLimits) {
+    EXPECT_EQ(meter, 1);
+    EXPECT_EQ(temp, 3);
+
+    for(uint8_t i = scheduler.getDeviceCount(); i < I2C_SCHEDULER_MAX_DEVICES; i++) {
+        EXPECT_NE(scheduler.addDevice(&bus, 0x10 + i, "extra"), 0);
+    }
+    EXPECT_EQ(scheduler.addDevice(&bus, 0x20, "full"), 0);
+    EXPECT_EQ(scheduler.addDevice(nullptr, 0x21, "none"), 0);
+}
+
+// Transactions run in submission order, and callbacks are only made by dispatch().
+TEST_F(I2CSchedulerFixture, RunsInOrderAndDispatchesResults) {
+    const uint8_t config[3] = {0x00, 0x12, 0x34};
+    bus.registers[0x6A][0] = 0xAB;
+    bus.registers[0x6A][1] = 0xCD;
+
+    EXPECT_TRUE(scheduler.write(meter, config, 3, recordCompletion));
+    EXPECT_TRUE(scheduler.readRegister(sensor, 0x28, 2, recordCompletion));
+    EXPECT_TRUE(scheduler.read(temp, 2, recordCompletion));
+    EXPECT_TRUE(scheduler.isPending(sensor));
+
+    EXPECT_TRUE(scheduler.runNext());
+    EXPECT_TRUE(scheduler.runNext());
+    EXPECT_TRUE(completions.empty());
+
+    // Only the finished transactions complete, leaving the third queued.
+    EXPECT_EQ(scheduler.dispatch(), 2);
+    ASSERT_EQ(completions.size(), 2u);
+    EXPECT_EQ(completions[0].device, meter);
+    EXPECT_EQ(completions[1].data, (std::vector<uint8_t>{0xAB, 0xCD}));
+    EXPECT_FALSE(scheduler.isPending(sensor));
+    EXPECT_TRUE(scheduler.isPending(temp));
+    EXPECT_EQ(scheduler.getQueuedCount(), 1);
+
+    EXPECT_TRUE(scheduler.runNext());
+    EXPECT_FALSE(scheduler.runNext());
+    EXPECT_EQ(scheduler.dispatch(), 1);
+
+    ASSERT_EQ(bus.log.size(), 2u);
+    EXPECT_EQ(bus.log[0].tx, (std::vector<uint8_t>{0x00, 0x12, 0x34}));
+    EXPECT_EQ(bus.log[1].tx, (std::vector<uint8_t>{0x28}));
+    EXPECT_EQ(bus.log[1].rxLength, 2);
+    ASSERT_EQ(bus1.log.size(), 1u);
+    EXPECT_TRUE(bus1.log[0].tx.empty());
+}
+
+// Submissions are refused when the queue is full, for unknown devices, or for oversized data.
+TEST_F(I2CSchedulerFixture, RejectsInvalidSubmissions) {
+    uint8_t data[I2C_SCHEDULER_MAX_DATA + 1] = {};
+
+    EXPECT_FALSE(scheduler.write(0, data, 1));
+    EXPECT_FALSE(scheduler.write(9, data, 1));
+    EXPECT_FALSE(scheduler.write(meter, data, I2C_SCHEDULER_MAX_DATA + 1));
+    EXPECT_FALSE(scheduler.read(meter, I2C_SCHEDULER_MAX_DATA + 1, recordCompletion));
+    EXPECT_FALSE(scheduler.submitJob(meter, nullptr));
+    EXPECT_EQ(scheduler.getRejectedCount(), 0u);
+
+    for(uint8_t i = 0; i < 4; i++) {
+        EXPECT_TRUE(scheduler.write(meter, data, 1));
+    }
+    EXPECT_FALSE(scheduler.write(meter, data, 1));
+    EXPECT_EQ(scheduler.getRejectedCount(), 1u);
+
+    // A slot is only released once its transaction has been dispatched.
+    EXPECT_TRUE(scheduler.runNext());
+    EXPECT_FALSE(scheduler.write(meter, data, 1));
+    scheduler.dispatch();
+    EXPECT_TRUE(scheduler.write(meter, data, 1));
+}
+
+// The ring wraps around many times without losing or reordering transactions.
+TEST_F(I2CSchedulerFixture, QueueWrapsAround) {
+    for(uint8_t i = 0; i < 100; i++) {
+        bus.registers[0x6A][0] = i;
+        ASSERT_TRUE(scheduler.readRegister(sensor, i, 1, recordCompletion));
+        scheduler.runNext();
+
+        if(i % 3 == 0) {
+            scheduler.dispatch();
+        }
+    }
+    scheduler.dispatch();
+
+    ASSERT_EQ(completions.size(), 100u);
+    for(uint8_t i = 0; i < 100; i++) {
+        EXPECT_EQ(completions[i].data[0], i);
+        EXPECT_EQ(bus.log[i].tx[0], i);
+    }
+    EXPECT_EQ(scheduler.getQueuedCount(), 0);
+}
+
+// Jobs run with the bus to themselves, and their status is reported like any transfer.
+static uint8_t job_runs = 0;
+
+static uint8_t failingJob(void* context) {
+    job_runs++;
+    fake_micros += *static_cast<uint32_t*>(context);
+    return I2C_STATUS_DATA_NACK;
+}
+
+TEST_F(I2CSchedulerFixture, RunsJobs) {
+    uint32_t duration = 1500;
+    job_runs = 0;
+
+    EXPECT_TRUE(scheduler.submitJob(meter, failingJob, recordCompletion, &duration));
+    EXPECT_EQ(job_runs, 0);
+    scheduler.runNext();
+    EXPECT_EQ(job_runs, 1);
+    scheduler.dispatch();
+
+    ASSERT_EQ(completions.size(), 1u);
+    EXPECT_EQ(completions[0].status, I2C_STATUS_DATA_NACK);
+    EXPECT_TRUE(bus.log.empty());
+
+    I2CDeviceStats stats;
+    ASSERT_TRUE(scheduler.getDeviceStats(meter, stats));
+    EXPECT_EQ(stats.transactions, 1u);
+    EXPECT_EQ(stats.errors, 1u);
+    EXPECT_EQ(stats.busMicros, 1500u);
+}
+
+// Bus time, the longest transaction and the longest wait for the bus are kept for each device.
+TEST_F(I2CSchedulerFixture, AccountsBusTimePerDevice) {
+    bus.failAddress = 0x6A;
+
+    scheduler.readRegister(meter, 0x01, 2, recordCompletion);  // (1 + 1 + 2) * 25 = 100us
+    scheduler.readRegister(sensor, 0x22, 6, recordCompletion); // (1 + 1 + 6) * 25 = 200us
+    scheduler.readRegister(meter, 0x02, 2, recordCompletion);  // 100us
+    fake_micros += 50;
+    while(scheduler.runNext()) {}
+    scheduler.dispatch();
+
+    I2CDeviceStats stats;
+    scheduler.getDeviceStats(meter, stats);
+    EXPECT_EQ(stats.transactions, 2u);
+    EXPECT_EQ(stats.errors, 0u);
+    EXPECT_EQ(stats.busMicros, 200u);
+    EXPECT_EQ(stats.maxBusMicros, 100u);
+    EXPECT_EQ(stats.maxWaitMicros, 350u); // Waited for the 50us delay plus both earlier transfers.
+
+    scheduler.getDeviceStats(sensor, stats);
+    EXPECT_EQ(stats.transactions, 1u);
+    EXPECT_EQ(stats.errors, 1u);
+    EXPECT_EQ(stats.busMicros, 200u);
+    EXPECT_EQ(completions[1].status, I2C_STATUS_ADDRESS_NACK);
+
+    scheduler.getDeviceStats(temp, stats);
+    EXPECT_EQ(stats.transactions, 0u);
+    EXPECT_FALSE(scheduler.getDeviceStats(0, stats));
+
+    scheduler.resetStats();
+    scheduler.getDeviceStats(meter, stats);
+    EXPECT_EQ(stats.busMicros, 0u);
+    EXPECT_EQ(stats.maxWaitMicros, 0u);
+}
+
+// service() stops once its budget is spent, but always makes progress.
+TEST_F(I2CSchedulerFixture, ServiceHonoursBudget) {
+    for(uint8_t i = 0; i < 4; i++) {
+        scheduler.readRegister(meter, i, 2, recordCompletion); // 100us each
+    }
+
+    EXPECT_EQ(scheduler.service(10), 1);
+    EXPECT_EQ(scheduler.service(150), 2);
+    EXPECT_EQ(scheduler.service(1000), 1);
+    EXPECT_EQ(scheduler.service(1000), 0);
+    EXPECT_EQ(scheduler.dispatch(), 4);
+}
+
+// A callback may queue a follow-on transaction, which completes on a later dispatch().
+static I2CScheduler* chain_scheduler = nullptr;
+
+static void startConversionDone(const I2CTransaction& transaction) {
+    recordCompletion(transaction);
+    chain_scheduler->read(transaction.device, 2, recordCompletion);
+}
+
+TEST_F(I2CSchedulerFixture, CallbacksCanChain) {
+    const uint8_t trigger = 0x00;
+    chain_scheduler = &scheduler;
+    bus1.registers[0x40][0] = 0x66;
+    bus1.registers[0x40][1] = 0x60;
+
+    scheduler.write(temp, &trigger, 1, startConversionDone);
+    scheduler.runNext();
+    EXPECT_EQ(scheduler.dispatch(), 1);
+    EXPECT_TRUE(scheduler.isPending(temp));
+    EXPECT_EQ(completions.size(), 1u);
+
+    scheduler.runNext();
+    EXPECT_EQ(scheduler.dispatch(), 1);
+    ASSERT_EQ(completions.size(), 2u);
+    EXPECT_EQ(completions[1].data, (std::vector<uint8_t>{0x66, 0x60}));
+}
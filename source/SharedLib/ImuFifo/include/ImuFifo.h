@@ -0,0 +1,134 @@
+/**
+ *   ImuFifo - Timestamped sample batches from the LSM6DS3TR-C FIFO for GPStar devices.
+ *   Copyright (C) 2023-2026 Michael Rajotte, Dustin Grau, Nomake Wan
+ *
+ *   This program is free software; you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation; either version 3 of the License, or
+ *   (at your option) any later version.
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License
+ *   along with this program; if not, see <https://www.gnu.org/licenses/>.
+ *
+ */
+
+#pragma once
+
+// Standard library includes for integer type definitions
+#include <stdint.h>  // Provides uint8_t, uint16_t, etc.
+#include <stdbool.h> // Provides bool type definition.
+
+/**
+ * LSM6DS3TR-C FIFO Registers
+ *
+ * FIFO_CTRL1-5 are written in one go (register auto-increment is on by default).
+ * FIFO_STATUS1-4 hold the unread word count, the flags and the pattern of the next word.
+ * Reading on from FIFO_DATA_OUT_L rolls back to it, so a whole batch is one burst.
+ */
+#define IMU_FIFO_CTRL1       0x06
+#define IMU_FIFO_STATUS1     0x3A
+#define IMU_FIFO_DATA_OUT_L  0x3E
+#define IMU_FIFO_CTRL_BYTES  5
+#define IMU_FIFO_STATUS_BYTES 4
+
+#define IMU_FIFO_MODE_BYPASS     0x00 // FIFO off, and emptied.
+#define IMU_FIFO_MODE_CONTINUOUS 0x06 // Newest samples overwrite the oldest once full.
+#define IMU_FIFO_NO_DECIMATION   0x01 // DEC_FIFO_GYRO/DEC_FIFO_XL value for every sample.
+
+#define IMU_FIFO_STATUS_WATERMARK 0x80 // FIFO_STATUS2 flags.
+#define IMU_FIFO_STATUS_OVERRUN   0x40
+#define IMU_FIFO_STATUS_EMPTY     0x10
+
+#define IMU_FIFO_CAPACITY_WORDS 2048 // 16-bit words the FIFO holds.
+#define IMU_FIFO_SAMPLE_WORDS   6    // Gyro X/Y/Z then accel X/Y/Z.
+#define IMU_FIFO_SAMPLE_BYTES   (IMU_FIFO_SAMPLE_WORDS * 2)
+#define IMU_FIFO_MAX_SAMPLES    16   // Most samples taken per batch, the rest wait for the next.
+#define IMU_FIFO_MAX_WORDS      (IMU_FIFO_MAX_SAMPLES * IMU_FIFO_SAMPLE_WORDS + IMU_FIFO_SAMPLE_WORDS - 1) // Plus realignment.
+
+// What FIFO_STATUS1-4 report.
+struct ImuFifoStatus {
+  uint16_t unread;  // Words waiting.
+  uint16_t pattern; // Position of the next word within a sample (0 = gyro X).
+  bool watermark;
+  bool overrun;
+  bool empty;
+};
+
+// One gyro and accelerometer sample in raw counts, with the time it was taken.
+struct ImuFifoSample {
+  int16_t gyro[3];
+  int16_t accel[3];
+  uint32_t timestampUs;
+};
+
+// Decodes the four FIFO_STATUS registers.
+ImuFifoStatus imuFifoParseStatus(const uint8_t* status);
+
+// ODR_FIFO bits for a rate in Hz, rounded down to a supported rate (0 for none).
+uint8_t imuFifoOdrBits(uint16_t odrHz);
+
+/**
+ * Fills FIFO_CTRL1-5 for gyro and accelerometer samples, undecimated, in continuous mode at the given rate.
+ * The watermark is counted in whole samples. A rate of 0 puts the FIFO in bypass, which empties it.
+ */
+void imuFifoControl(uint16_t odrHz, uint16_t watermarkSamples, uint8_t* ctrl);
+
+/**
+ * Words to read for a batch: any words left of a partial sample, so reading realigns on gyro X,
+ * then up to maxSamples whole samples. A sample still being written is left for the next batch.
+ */
+uint16_t imuFifoWordsToRead(const ImuFifoStatus& status, uint8_t maxSamples);
+
+/**
+ * Decodes words read from FIFO_DATA_OUT (little-endian), the first having the given pattern.
+ * Words ahead of the first gyro X are skipped, as are any after the last whole sample.
+ * @return Samples written. Their timestamps are left for ImuSampleClock.
+ */
+uint8_t imuFifoDecode(const uint8_t* data, uint16_t words, uint16_t pattern, ImuFifoSample* samples, uint8_t maxSamples);
+
+/**
+ * Gives each sample of a batch the time it was taken.
+ *
+ * The sensor fills the FIFO at its own clock, which may be a few percent off the nominal rate,
+ * and the host only knows when it read a batch, which jitters with everything else it is doing.
+ * Each read still bounds the newest sample it finds: taken no later than the read, and less than
+ * one period before it (or the next sample would have been there too). The newest sample is placed
+ * one period on from the last for every new sample and only moved when that falls outside the window;
+ * how far it had to move, over the samples since the last move, trims the period. Samples are spaced
+ * evenly back from the newest, so their spacing follows the sensor and not the reads.
+ * Times are in microseconds with 1/256us kept between batches.
+ */
+class ImuSampleClock {
+public:
+  ImuSampleClock();
+
+  // Starts over at a nominal period (1000000 / ODR).
+  void begin(uint32_t periodUs);
+
+  // Drops the phase, so the next batch starts over from its read time (after an overrun or a gap).
+  void resync();
+
+  // Stamps count samples, oldest first, read at readUs with pending more samples left in the FIFO.
+  void stamp(uint32_t readUs, ImuFifoSample* samples, uint8_t count, uint16_t pending = 0);
+
+  // Estimated sensor period in microseconds, and in 1/256us.
+  uint32_t getPeriodUs() const;
+  uint32_t getPeriodQ8() const;
+
+  uint32_t getNominalUs() const;
+  uint16_t getResyncs() const; // Times the clock started over, including the first batch.
+
+private:
+  uint32_t m_nominalQ8;
+  uint32_t m_periodQ8;
+  uint32_t m_newestUs;  // Time of the newest sample stamped, whole microseconds.
+  uint8_t m_newestFrac; // Plus this many 1/256us.
+  uint32_t m_sinceCorrection; // Samples since the placement last had to move.
+  bool m_synced;
+  uint16_t m_resyncs;
+};
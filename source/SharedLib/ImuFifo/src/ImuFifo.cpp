@@ -0,0 +1,210 @@
+/**
+ *   ImuFifo - Timestamped sample batches from the LSM6DS3TR-C FIFO for GPStar devices.
+ *   Copyright (C) 2023-2026 Michael Rajotte, Dustin Grau, Nomake Wan
+ *
+ *   This program is free software; you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation; either version 3 of the License, or
+ *   (at your option) any later version.
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License
+ *   along with this program; if not, see <https://www.gnu.org/licenses/>.
+ *
+ */
+
+// Library Header
+#include "ImuFifo.h"
+
+// Supported FIFO rates (12 for 12.5Hz); ODR_FIFO is the index plus one.
+static const uint16_t imuFifoRates[] = {12, 26, 52, 104, 208, 416, 833, 1660, 3330, 6660};
+
+// Period corrections take 1/2^TRIM of the error per sample since the last correction.
+static const uint8_t IMU_CLOCK_TRIM_SHIFT = 2;
+static const uint8_t IMU_CLOCK_MAX_TRIM_SHIFT = 6; // But never more than 1/64 of the period at once.
+
+// Errors beyond this many periods mean samples were lost, so the clock starts again from the read.
+static const int32_t IMU_CLOCK_RESYNC_PERIODS = 8;
+
+ImuFifoStatus imuFifoParseStatus(const uint8_t* status) {
+  ImuFifoStatus result;
+
+  result.unread = status[0] | ((uint16_t)(status[1] & 0x07) << 8);
+  result.watermark = (status[1] & IMU_FIFO_STATUS_WATERMARK) != 0;
+  result.overrun = (status[1] & IMU_FIFO_STATUS_OVERRUN) != 0;
+  result.empty = (status[1] & IMU_FIFO_STATUS_EMPTY) != 0;
+  result.pattern = status[2] | ((uint16_t)(status[3] & 0x03) << 8);
+
+  // A full FIFO reports its whole capacity with the overrun flag.
+  if(result.overrun && result.unread == 0) {
+    result.unread = IMU_FIFO_CAPACITY_WORDS;
+  }
+
+  return result;
+}
+
+uint8_t imuFifoOdrBits(uint16_t odrHz) {
+  uint8_t bits = 0;
+
+  for(uint8_t i = 0; i < sizeof(imuFifoRates) / sizeof(imuFifoRates[0]); i++) {
+    if(odrHz >= imuFifoRates[i]) {
+      bits = i + 1;
+    }
+  }
+
+  return bits;
+}
+
+void imuFifoControl(uint16_t odrHz, uint16_t watermarkSamples, uint8_t* ctrl) {
+  uint16_t threshold = watermarkSamples * IMU_FIFO_SAMPLE_WORDS;
+  uint8_t odrBits = imuFifoOdrBits(odrHz);
+
+  if(threshold >= IMU_FIFO_CAPACITY_WORDS) {
+    threshold = IMU_FIFO_CAPACITY_WORDS - IMU_FIFO_SAMPLE_WORDS;
+  }
+
+  ctrl[0] = threshold & 0xFF;          // FIFO_CTRL1: FTH[7:0]
+  ctrl[1] = (threshold >> 8) & 0x07;   // FIFO_CTRL2: FTH[10:8], no step counter or temperature.
+  ctrl[2] = (IMU_FIFO_NO_DECIMATION << 3) | IMU_FIFO_NO_DECIMATION; // FIFO_CTRL3: gyro and accel.
+  ctrl[3] = 0x00;                      // FIFO_CTRL4: no third or fourth data set.
+  ctrl[4] = odrBits == 0 ? IMU_FIFO_MODE_BYPASS : (uint8_t)((odrBits << 3) | IMU_FIFO_MODE_CONTINUOUS);
+}
+
+uint16_t imuFifoWordsToRead(const ImuFifoStatus& status, uint8_t maxSamples) {
+  if(status.empty) {
+    return 0;
+  }
+
+  uint16_t skip = (IMU_FIFO_SAMPLE_WORDS - (status.pattern % IMU_FIFO_SAMPLE_WORDS)) % IMU_FIFO_SAMPLE_WORDS;
+
+  if(status.unread <= skip) {
+    return status.unread;
+  }
+
+  uint16_t samples = (status.unread - skip) / IMU_FIFO_SAMPLE_WORDS;
+
+  if(samples > maxSamples) {
+    samples = maxSamples;
+  }
+
+  return skip + samples * IMU_FIFO_SAMPLE_WORDS;
+}
+
+uint8_t imuFifoDecode(const uint8_t* data, uint16_t words, uint16_t pattern, ImuFifoSample* samples, uint8_t maxSamples) {
+  uint16_t word = (IMU_FIFO_SAMPLE_WORDS - (pattern % IMU_FIFO_SAMPLE_WORDS)) % IMU_FIFO_SAMPLE_WORDS;
+  uint8_t count = 0;
+
+  while(count < maxSamples && word + IMU_FIFO_SAMPLE_WORDS <= words) {
+    const uint8_t* bytes = data + word * 2;
+
+    for(uint8_t axis = 0; axis < 3; axis++) {
+      samples[count].gyro[axis] = (int16_t)(bytes[axis * 2] | ((uint16_t)bytes[axis * 2 + 1] << 8));
+      samples[count].accel[axis] = (int16_t)(bytes[6 + axis * 2] | ((uint16_t)bytes[6 + axis * 2 + 1] << 8));
+    }
+
+    samples[count].timestampUs = 0;
+    word += IMU_FIFO_SAMPLE_WORDS;
+    count++;
+  }
+
+  return count;
+}
+
+ImuSampleClock::ImuSampleClock()
+  : m_nominalQ8(0), m_periodQ8(0), m_newestUs(0), m_newestFrac(0), m_sinceCorrection(0), m_synced(false), m_resyncs(0) {
+}
+
+void ImuSampleClock::begin(uint32_t periodUs) {
+  m_nominalQ8 = periodUs << 8;
+  m_periodQ8 = m_nominalQ8;
+  m_synced = false;
+}
+
+void ImuSampleClock::resync() {
+  m_synced = false;
+}
+
+void ImuSampleClock::stamp(uint32_t readUs, ImuFifoSample* samples, uint8_t count, uint16_t pending) {
+  if(count == 0) {
+    return;
+  }
+
+  int32_t errorQ8 = 0;
+  int32_t limitQ8 = (int32_t)m_periodQ8 * IMU_CLOCK_RESYNC_PERIODS;
+  uint32_t newestUs = readUs;
+  int32_t newestQ8 = 0;
+
+  if(m_synced) {
+    // Where the newest sample taken should be, one period on from the last stamped for each sample since.
+    uint32_t advanceQ8 = (count + pending) * m_periodQ8 + m_newestFrac;
+    newestUs = m_newestUs + (advanceQ8 >> 8);
+    newestQ8 = advanceQ8 & 0xFF;
+    errorQ8 = (int32_t)(readUs - newestUs) * 256 - newestQ8;
+  }
+
+  if(!m_synced || errorQ8 > limitQ8 || errorQ8 < -limitQ8) {
+    // Halfway through the only window the newest sample can be in.
+    newestUs = readUs;
+    newestQ8 = -(int32_t)(m_periodQ8 >> 1);
+    m_sinceCorrection = 0;
+    m_synced = true;
+    m_resyncs++;
+  }
+  else {
+    // The newest sample came before the read, and the one after it did not: move only when outside that window.
+    int32_t correctionQ8 = 0;
+
+    if(errorQ8 < 0) {
+      correctionQ8 = errorQ8;
+    }
+    else if(errorQ8 >= (int32_t)m_periodQ8) {
+      correctionQ8 = errorQ8 - (int32_t)m_periodQ8 + 1;
+    }
+
+    newestQ8 += correctionQ8;
+    m_sinceCorrection += count;
+
+    if(correctionQ8 != 0) {
+      // Spread over the samples since the last correction, it is how far off the period is.
+      int32_t minQ8 = m_nominalQ8 - (m_nominalQ8 >> 3);
+      int32_t maxQ8 = m_nominalQ8 + (m_nominalQ8 >> 3);
+      int32_t trimQ8 = (correctionQ8 / (int32_t)m_sinceCorrection) >> IMU_CLOCK_TRIM_SHIFT;
+      int32_t maxTrimQ8 = m_periodQ8 >> IMU_CLOCK_MAX_TRIM_SHIFT;
+      int32_t periodQ8 = (int32_t)m_periodQ8 + (trimQ8 < -maxTrimQ8 ? -maxTrimQ8 : (trimQ8 > maxTrimQ8 ? maxTrimQ8 : trimQ8));
+
+      m_periodQ8 = periodQ8 < minQ8 ? minQ8 : (periodQ8 > maxQ8 ? maxQ8 : periodQ8);
+      m_sinceCorrection = 0;
+    }
+  }
+
+  // Samples still waiting in the FIFO were taken after the last one stamped here.
+  newestQ8 -= (int32_t)(pending * m_periodQ8);
+  m_newestUs = newestUs + (newestQ8 >> 8);
+  m_newestFrac = newestQ8 & 0xFF;
+
+  // Oldest first, evenly spaced back from the newest.
+  for(uint8_t i = 0; i < count; i++) {
+    int32_t backQ8 = (int32_t)m_newestFrac - (int32_t)((count - 1 - i) * m_periodQ8);
+    samples[i].timestampUs = m_newestUs + (backQ8 >> 8);
+  }
+}
+
+uint32_t ImuSampleClock::getPeriodUs() const {
+  return (m_periodQ8 + 0x80) >> 8;
+}
+
+uint32_t ImuSampleClock::getPeriodQ8() const {
+  return m_periodQ8;
+}
+
+uint32_t ImuSampleClock::getNominalUs() const {
+  return m_nominalQ8 >> 8;
+}
+
+uint16_t ImuSampleClock::getResyncs() const {
+  return m_resyncs;
+}
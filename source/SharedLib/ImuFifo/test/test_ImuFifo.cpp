@@ -0,0 +1,286 @@
+#include <gtest/gtest.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include "ImuFifo.h"
+
+// Writes a sample into FIFO words as the sensor does: gyro X/Y/Z then accel X/Y/Z, little-endian.
+static void putSample(uint8_t* data, uint16_t word, int16_t base) {
+  for(uint8_t i = 0; i < IMU_FIFO_SAMPLE_WORDS; i++) {
+    uint16_t value = (uint16_t)(base + i);
+    data[(word + i) * 2] = value & 0xFF;
+    data[(word + i) * 2 + 1] = value >> 8;
+  }
+}
+
+// Simulates the FIFO filling at a drifting sensor rate, read at jittery host times.
+// Time runs on unwrapped from the start; the clock sees it as micros() would, wrapping at 32 bits.
+class SampleClockSim {
+public:
+  SampleClockSim(double periodUs) : m_periodUs(periodUs), m_next(0) {}
+
+  // Samples taken by elapsedUs and not read yet, stamped by the clock; their true times go to trueUs.
+  uint8_t read(ImuSampleClock& clock, uint32_t startUs, double elapsedUs, ImuFifoSample* samples, double* trueUs) {
+    uint8_t count = 0;
+
+    while(count < IMU_FIFO_MAX_SAMPLES && (m_next + 1) * m_periodUs <= elapsedUs) {
+      trueUs[count++] = (m_next + 1) * m_periodUs;
+      m_next++;
+    }
+
+    clock.stamp(startUs + (uint32_t)elapsedUs, samples, count);
+    return count;
+  }
+
+private:
+  double m_periodUs;
+  uint32_t m_next;
+};
+
+TEST(ImuFifoTest, ParsesStatus) {
+  const uint8_t status[] = {0x34, 0x82, 0x05, 0x01};
+  ImuFifoStatus parsed = imuFifoParseStatus(status);
+
+  EXPECT_EQ(0x234, parsed.unread);
+  EXPECT_EQ(0x105, parsed.pattern);
+  EXPECT_TRUE(parsed.watermark);
+  EXPECT_FALSE(parsed.overrun);
+  EXPECT_FALSE(parsed.empty);
+
+  const uint8_t empty[] = {0x00, 0x10, 0x00, 0x00};
+  EXPECT_TRUE(imuFifoParseStatus(empty).empty);
+
+  // Full to the brim: the count wraps to zero but the overrun flag gives it away.
+  const uint8_t full[] = {0x00, 0x40, 0x00, 0x00};
+  EXPECT_TRUE(imuFifoParseStatus(full).overrun);
+  EXPECT_EQ(IMU_FIFO_CAPACITY_WORDS, imuFifoParseStatus(full).unread);
+}
+
+TEST(ImuFifoTest, ControlRegisters) {
+  uint8_t ctrl[IMU_FIFO_CTRL_BYTES];
+
+  // 104Hz, continuous, watermark at 2 samples (12 words).
+  imuFifoControl(104, 2, ctrl);
+  EXPECT_EQ(12, ctrl[0]);
+  EXPECT_EQ(0, ctrl[1]);
+  EXPECT_EQ(0x09, ctrl[2]);
+  EXPECT_EQ(0, ctrl[3]);
+  EXPECT_EQ(0x26, ctrl[4]);
+
+  // 208Hz with a watermark needing the high threshold bits.
+  imuFifoControl(208, 100, ctrl);
+  EXPECT_EQ(600 & 0xFF, ctrl[0]);
+  EXPECT_EQ(600 >> 8, ctrl[1]);
+  EXPECT_EQ(0x2E, ctrl[4]);
+
+  // No rate turns the FIFO off.
+  imuFifoControl(0, 2, ctrl);
+  EXPECT_EQ(IMU_FIFO_MODE_BYPASS, ctrl[4]);
+
+  EXPECT_EQ(1, imuFifoOdrBits(12));
+  EXPECT_EQ(4, imuFifoOdrBits(104));
+  EXPECT_EQ(4, imuFifoOdrBits(200));
+  EXPECT_EQ(10, imuFifoOdrBits(6660));
+}
+
+TEST(ImuFifoTest, WordsToRead) {
+  ImuFifoStatus status = {};
+
+  // Aligned: whole samples only, a partial one waits.
+  status.unread = 3 * IMU_FIFO_SAMPLE_WORDS + 4;
+  status.pattern = 0;
+  EXPECT_EQ(3 * IMU_FIFO_SAMPLE_WORDS, imuFifoWordsToRead(status, IMU_FIFO_MAX_SAMPLES));
+  EXPECT_EQ(2 * IMU_FIFO_SAMPLE_WORDS, imuFifoWordsToRead(status, 2));
+
+  // Mid-sample: the rest of it is read to realign.
+  status.pattern = 4;
+  EXPECT_EQ(2 + 3 * IMU_FIFO_SAMPLE_WORDS, imuFifoWordsToRead(status, IMU_FIFO_MAX_SAMPLES));
+
+  status.unread = 1;
+  EXPECT_EQ(1, imuFifoWordsToRead(status, IMU_FIFO_MAX_SAMPLES));
+
+  status.empty = true;
+  EXPECT_EQ(0, imuFifoWordsToRead(status, IMU_FIFO_MAX_SAMPLES));
+
+  // The largest batch fits the read buffer.
+  status = {};
+  status.unread = IMU_FIFO_CAPACITY_WORDS;
+  status.pattern = 1;
+  EXPECT_EQ(IMU_FIFO_MAX_WORDS, imuFifoWordsToRead(status, IMU_FIFO_MAX_SAMPLES));
+}
+
+TEST(ImuFifoTest, DecodesAlignedSamples) {
+  uint8_t data[IMU_FIFO_MAX_WORDS * 2];
+  ImuFifoSample samples[IMU_FIFO_MAX_SAMPLES];
+
+  putSample(data, 0, 100);
+  putSample(data, 6, -300);
+
+  ASSERT_EQ(2, imuFifoDecode(data, 12, 0, samples, IMU_FIFO_MAX_SAMPLES));
+  EXPECT_EQ(100, samples[0].gyro[0]);
+  EXPECT_EQ(102, samples[0].gyro[2]);
+  EXPECT_EQ(103, samples[0].accel[0]);
+  EXPECT_EQ(105, samples[0].accel[2]);
+  EXPECT_EQ(-300, samples[1].gyro[0]);
+  EXPECT_EQ(-295, samples[1].accel[2]);
+
+  // Room for only one.
+  EXPECT_EQ(1, imuFifoDecode(data, 12, 0, samples, 1));
+}
+
+TEST(ImuFifoTest, DecodesAfterRealigning) {
+  uint8_t data[IMU_FIFO_MAX_WORDS * 2];
+  ImuFifoSample samples[IMU_FIFO_MAX_SAMPLES];
+
+  // The first two words are the accel Y/Z of a sample already gone, then two whole samples and a partial one.
+  putSample(data, 0, 7000);
+  putSample(data, 2, 10);
+  putSample(data, 8, 20);
+  putSample(data, 14, 30);
+
+  ASSERT_EQ(2, imuFifoDecode(data, 17, 4, samples, IMU_FIFO_MAX_SAMPLES));
+  EXPECT_EQ(10, samples[0].gyro[0]);
+  EXPECT_EQ(15, samples[0].accel[2]);
+  EXPECT_EQ(20, samples[1].gyro[0]);
+
+  // Nothing whole in a short read.
+  EXPECT_EQ(0, imuFifoDecode(data, 5, 4, samples, IMU_FIFO_MAX_SAMPLES));
+}
+
+TEST(ImuFifoTest, ClockTracksDriftingSensorThroughJitter) {
+  const uint32_t nominalUs = 1000000 / 104;
+  const double truePeriodUs = nominalUs * 1.04; // Sensor running 4% slow.
+  const uint32_t startUs = 0xFFF00000;          // Crosses the micros() rollover.
+
+  ImuSampleClock clock;
+  clock.begin(nominalUs);
+  SampleClockSim sim(truePeriodUs);
+  srand(47);
+
+  ImuFifoSample samples[IMU_FIFO_MAX_SAMPLES];
+  double trueUs[IMU_FIFO_MAX_SAMPLES];
+  uint32_t lastStamp = 0;
+  double lastTrue = 0;
+  double maxSpacingError = 0;
+  double minOffset = 1e9, maxOffset = -1e9;
+  double elapsedUs = 0;
+  uint32_t checked = 0;
+
+  // Reads every 20ms give or take 4ms.
+  for(uint16_t batch = 0; batch < 1000; batch++) {
+    elapsedUs += 16000 + (rand() % 8000);
+    uint8_t count = sim.read(clock, startUs, elapsedUs, samples, trueUs);
+
+    for(uint8_t i = 0; i < count; i++) {
+      if(batch >= 300) {
+        double spacing = (double)(uint32_t)(samples[i].timestampUs - lastStamp);
+        double spacingError = spacing - (trueUs[i] - lastTrue);
+        double offset = (double)(int32_t)(samples[i].timestampUs - startUs) - trueUs[i];
+
+        maxSpacingError = std::max(maxSpacingError, spacingError < 0 ? -spacingError : spacingError);
+        minOffset = std::min(minOffset, offset);
+        maxOffset = std::max(maxOffset, offset);
+        checked++;
+      }
+
+      lastStamp = samples[i].timestampUs;
+      lastTrue = trueUs[i];
+    }
+  }
+
+  ASSERT_GT(checked, 1000u);
+
+  // The period follows the sensor, not the nominal rate or the reads.
+  EXPECT_NEAR(truePeriodUs, clock.getPeriodQ8() / 256.0, truePeriodUs * 0.002);
+
+  // Samples stay evenly spaced, where the reads alone would be off by milliseconds.
+  EXPECT_LT(maxSpacingError, truePeriodUs * 0.2);
+
+  // And a steady distance from when they were really taken.
+  EXPECT_LT(maxOffset - minOffset, (double)truePeriodUs);
+  EXPECT_EQ(1, clock.getResyncs());
+}
+
+TEST(ImuFifoTest, ClockResyncsAfterLostSamples) {
+  const uint32_t nominalUs = 1000000 / 208;
+  ImuSampleClock clock;
+  ImuFifoSample samples[IMU_FIFO_MAX_SAMPLES];
+
+  // With nothing to go on, the newest sample is half a period before the read.
+  clock.begin(nominalUs);
+  clock.stamp(1000000, samples, 4);
+  const uint32_t newest = 1000000 - nominalUs / 2;
+  EXPECT_NEAR(newest, samples[3].timestampUs, 1);
+  EXPECT_NEAR(newest - 3 * nominalUs, samples[0].timestampUs, 1);
+  EXPECT_EQ(1, clock.getResyncs());
+
+  // A batch read within the window the samples allow leaves them where they fall.
+  clock.stamp(1000000 + 4 * nominalUs + nominalUs / 4, samples, 4);
+  EXPECT_EQ(1, clock.getResyncs());
+  EXPECT_NEAR(newest + 4 * nominalUs, samples[3].timestampUs, 1);
+  EXPECT_EQ(nominalUs, clock.getPeriodUs());
+
+  // A read before the newest sample could have been taken pulls it back to the read.
+  const uint32_t early = 1000000 + 8 * nominalUs - nominalUs;
+  clock.stamp(early, samples, 4);
+  EXPECT_NEAR(early, samples[3].timestampUs, 1);
+  EXPECT_LT(clock.getPeriodQ8(), nominalUs << 8);
+
+  // The FIFO overran while the host was away: far more time than the samples explain.
+  clock.stamp(1500000, samples, IMU_FIFO_MAX_SAMPLES);
+  EXPECT_EQ(2, clock.getResyncs());
+  EXPECT_NEAR(1500000 - clock.getPeriodUs() / 2, samples[IMU_FIFO_MAX_SAMPLES - 1].timestampUs, 1);
+
+  // An explicit resync starts the next batch over from its read time.
+  clock.resync();
+  clock.stamp(1600000, samples, 2);
+  EXPECT_EQ(3, clock.getResyncs());
+  EXPECT_NEAR(1600000 - clock.getPeriodUs() / 2, samples[1].timestampUs, 1);
+}
+
+TEST(ImuFifoTest, ClockPeriodStaysNearNominal) {
+  const uint32_t nominalUs = 1000000 / 104;
+  ImuSampleClock clock;
+  ImuFifoSample samples[IMU_FIFO_MAX_SAMPLES];
+  uint32_t readUs = 0;
+
+  // Reads keep finding half the samples they should, as if the sensor ran at half rate.
+  clock.begin(nominalUs);
+  for(uint16_t batch = 0; batch < 500; batch++) {
+    readUs += 4 * nominalUs;
+    clock.stamp(readUs, samples, 2);
+  }
+
+  // The period grows towards it but no further than 1/8 over nominal.
+  EXPECT_EQ((nominalUs << 8) + ((nominalUs << 8) >> 3), clock.getPeriodQ8());
+}
+
+TEST(ImuFifoTest, ClockAllowsForSamplesLeftWaiting) {
+  const uint32_t nominalUs = 1000000 / 104;
+  ImuSampleClock clock;
+  ImuFifoSample samples[IMU_FIFO_MAX_SAMPLES];
+  uint32_t readUs = 500000;
+
+  clock.begin(nominalUs);
+  clock.stamp(readUs, samples, 2);
+  uint32_t lastStamp = samples[1].timestampUs;
+
+  // The host was held up for 40 samples: the first reads take what they can and leave the rest.
+  readUs += 40 * nominalUs;
+  const uint32_t newestTaken = readUs - nominalUs / 2;
+  for(uint16_t pending = 40 - IMU_FIFO_MAX_SAMPLES; ; pending -= IMU_FIFO_MAX_SAMPLES) {
+    clock.stamp(readUs, samples, IMU_FIFO_MAX_SAMPLES, pending);
+
+    // Carrying on from the last batch, one period apart, with no fresh start.
+    EXPECT_NEAR(lastStamp + nominalUs, samples[0].timestampUs, 1);
+    EXPECT_NEAR(newestTaken - pending * nominalUs, samples[IMU_FIFO_MAX_SAMPLES - 1].timestampUs, 2);
+    lastStamp = samples[IMU_FIFO_MAX_SAMPLES - 1].timestampUs;
+    readUs += 100;
+
+    if(pending < IMU_FIFO_MAX_SAMPLES) {
+      break;
+    }
+  }
+
+  EXPECT_EQ(1, clock.getResyncs());
+  EXPECT_EQ(nominalUs, clock.getPeriodUs());
+}
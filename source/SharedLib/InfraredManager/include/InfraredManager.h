@@ -28,6 +28,7 @@
 #include <ArduinoJson.h>
 #endif
 #include <millisDelay.h>
+#include "InfraredQueue.h"
 
 // Disables static receiver code like receive timer ISR handler and static IRReceiver and irparams data.
 // Saves 450 bytes program memory and 269 bytes RAM if receiving functions are not required.
@@ -143,6 +144,30 @@ public:
    * @return True if conversion successful, false if unknown command string
    */
   static bool stringToCommandType(const String& commandStr, IR_COMMAND_TYPE& commandType);
+
+  /**
+   * Hand the next queued frame to the RMT transmitter once it is idle.
+   * Call from the main loop; sending a command also starts an idle transmitter.
+   */
+  void update();
+
+  /**
+   * Get the number of frames waiting for the transmitter
+   * @return Frames queued (0-IR_TX_QUEUE_SIZE)
+   */
+  uint8_t getTXQueueDepth() const;
+
+  /**
+   * Get the number of times the RMT refused a frame, which is then retried
+   * @return Failed writes since startup
+   */
+  uint16_t getTXFailures() const;
+
+  /**
+   * Get the share of time the transmitter spent sending over the last second
+   * @return Duty cycle as a percentage (0-100)
+   */
+  uint8_t getTXDutyCycle();
 #endif
 
   /**
@@ -267,6 +292,27 @@ private:
    * @return 16-bit NEC address
    */
   uint16_t buildIRAddress(uint8_t deviceType, uint16_t deviceId);
+
+#ifdef ESP32
+  IRTransmitQueue m_txQueue;                  // Frames waiting for the RMT transmitter
+  IRSymbol m_txBuffer[IR_FRAME_MAX_SYMBOLS];  // Frame being sent, kept until the RMT is done with it
+  bool m_rmtReady;                            // RMT channel is set up; otherwise send through IRremote
+  bool m_txBusy;                              // RMT is sending m_txBuffer
+
+  /**
+   * Queue an NEC frame for the RMT, or send it at once through IRremote when the RMT is unavailable
+   * @param rawData The 32-bit NEC data
+   * @param kind IR_FRAME_FIRING for repeating firing codes, which replace one still waiting
+   */
+  void sendNEC(uint32_t rawData, uint8_t kind);
+
+  /**
+   * Queue raw mark/space timings for the RMT, or send them at once through IRremote when the RMT is unavailable
+   * @param durations Mark/space durations in microseconds, starting with a mark
+   * @param count Number of durations
+   */
+  void sendRawTimings(const uint16_t* durations, uint8_t count);
+#endif
 };
 
 #endif // (defined(ESP32) || defined(__AVR_ATtiny1616__))
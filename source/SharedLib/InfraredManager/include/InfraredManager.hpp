@@ -48,7 +48,20 @@ InfraredManager::InfraredManager(uint8_t deviceType, uint16_t deviceID)
   // Initialize IR LED pin
   pinMode(IR_LED_PIN, OUTPUT);
   digitalWrite(IR_LED_PIN, LOW);
+
+  #ifdef ESP32
+  // Send through the RMT peripheral at 1 tick per microsecond, modulated onto the carrier.
+  // Frames are queued and sent in the background rather than bit-banged for ~70ms each.
+  m_txBusy = false;
+  m_rmtReady = rmtInit(IR_LED_PIN, RMT_TX_MODE, RMT_MEM_NUM_BLOCKS_1, 1000000) &&
+               rmtSetCarrier(IR_LED_PIN, true, true, CARRIER_KHZ * 1000, 0.33);
+
+  if(!m_rmtReady) {
+    IrSender.begin(IR_LED_PIN);
+  }
+  #else
   IrSender.begin(IR_LED_PIN);
+  #endif
 
   #ifndef GPSTAR_IR_TX_ONLY
   // If not in TX-only mode, also set up the receiver pin and timer.
@@ -151,6 +164,76 @@ uint16_t InfraredManager::buildIRAddress(uint8_t deviceType, uint16_t deviceId)
 }
 
 #ifdef ESP32
+static_assert(sizeof(IRSymbol) == sizeof(rmt_data_t), "IRSymbol must match the RMT symbol layout");
+
+void InfraredManager::update() {
+  if(!m_rmtReady) {
+    return;
+  }
+
+  if(m_txBusy) {
+    if(!rmtTransmitCompleted(IR_LED_PIN)) {
+      return;
+    }
+
+    m_txBusy = false;
+  }
+
+  const IRFrame* frame = m_txQueue.front();
+  if(frame == nullptr) {
+    return;
+  }
+
+  // The RMT reads the symbols while sending, so they need to outlive the queue slot.
+  memcpy(m_txBuffer, frame->symbols, frame->count * sizeof(IRSymbol));
+  m_txBusy = rmtWriteAsync(IR_LED_PIN, reinterpret_cast<rmt_data_t*>(m_txBuffer), frame->count);
+
+  if(!m_txBusy) {
+    // Keep the frame and try again on the next update.
+    m_txQueue.failed();
+    return;
+  }
+
+  m_txQueue.pop(micros());
+}
+
+uint8_t InfraredManager::getTXQueueDepth() const {
+  return m_txQueue.depth();
+}
+
+uint16_t InfraredManager::getTXFailures() const {
+  return m_txQueue.failures();
+}
+
+uint8_t InfraredManager::getTXDutyCycle() {
+  return m_txQueue.dutyCycle(micros());
+}
+
+void InfraredManager::sendNEC(uint32_t rawData, uint8_t kind) {
+  if(!m_rmtReady) {
+    IrSender.sendNECRaw(rawData, 0);
+    return;
+  }
+
+  IRFrame frame;
+  irFrameNEC(frame, rawData, kind);
+  m_txQueue.push(frame);
+  update();
+}
+
+void InfraredManager::sendRawTimings(const uint16_t* durations, uint8_t count) {
+  if(!m_rmtReady) {
+    IrSender.sendRaw(durations, count, CARRIER_KHZ);
+    return;
+  }
+
+  IRFrame frame;
+  if(irFrameRaw(frame, durations, count, IR_FRAME_SINGLE)) {
+    m_txQueue.push(frame);
+    update();
+  }
+}
+
 // Send an infrared command using the device's configured type and ID.
 // Returns a JSON document with details about the command sent and its status.
 JsonDocument InfraredManager::sendCommand(IR_COMMAND_TYPE commandType, uint8_t streamMode, uint8_t powerLevel, uint8_t streamInfo) {
@@ -161,7 +244,7 @@ JsonDocument InfraredManager::sendCommand(IR_COMMAND_TYPE commandType, uint8_t s
     jsonResult["command"] = "ghostintrap";
     jsonResult["description"] = "Ghost Trap raw IR signal (PKE format)";
     jsonResult["status"] = "success";
-    IrSender.sendRaw(ir_GhostInTrap, sizeof(ir_GhostInTrap) / sizeof(ir_GhostInTrap[0]), CARRIER_KHZ);
+    sendRawTimings(ir_GhostInTrap, sizeof(ir_GhostInTrap) / sizeof(ir_GhostInTrap[0]));
   }
   else if(commandType == IR_CMD_TEST) {
     // Send a special command to test the NEC-based IR signal.
@@ -182,7 +265,7 @@ JsonDocument InfraredManager::sendCommand(IR_COMMAND_TYPE commandType, uint8_t s
     jsonResult["expectedNEC"] = String(addrLSB, HEX) + " " + String(addrMSB, HEX) + " " + String(command, HEX) + " " + String((uint8_t)~command, HEX);
 
     // Compute what raw data the library will generate.
-    uint32_t rawData = IrSender.computeNECRawDataAndChecksum(myAddress, command);
+    uint32_t rawData = irNECRawData(myAddress, command);
     jsonResult["rawData"] = "0x" + String(rawData, HEX);
 
     // Break down the raw data into bytes.
@@ -197,7 +280,7 @@ JsonDocument InfraredManager::sendCommand(IR_COMMAND_TYPE commandType, uint8_t s
     jsonResult["status"] = "success";
 
     // Send as raw NEC data (without repeats) as we constructed the data exactly as we want it.
-    IrSender.sendNECRaw(rawData, 0);
+    sendNEC(rawData, IR_FRAME_SINGLE);
   }
   else if(commandType == IR_CMD_FIRING) {
     // Send firing command with both stream type and power level embedded
@@ -262,7 +345,7 @@ JsonDocument InfraredManager::sendCommand(IR_COMMAND_TYPE commandType, uint8_t s
     jsonResult["expectedNEC"] = String(addrLSB, HEX) + " " + String(addrMSB, HEX) + " " + String(command, HEX) + " " + String((uint8_t)~command, HEX);
 
     // Compute what raw data the library will generate.
-    uint32_t rawData = IrSender.computeNECRawDataAndChecksum(myAddress, command);
+    uint32_t rawData = irNECRawData(myAddress, command);
     jsonResult["rawData"] = "0x" + String(rawData, HEX);
 
     // Break down the raw data into bytes.
@@ -276,8 +359,8 @@ JsonDocument InfraredManager::sendCommand(IR_COMMAND_TYPE commandType, uint8_t s
                            + String(byte3, HEX);
     jsonResult["status"] = "success";
 
-    // Send as raw NEC data (without repeats) as we constructed the data exactly as we want it.
-    IrSender.sendNECRaw(rawData, 0);
+    // Send as raw NEC data (without repeats); a firing code still waiting to be sent is replaced.
+    sendNEC(rawData, IR_FRAME_FIRING);
   }
   else {
     jsonResult["command"] = "unknown";
@@ -0,0 +1,149 @@
+/**
+ *   Infrared - IR communication methods for GPStar devices.
+ *   Encodes infrared frames as transmitter symbols and queues them for sending.
+ *   Copyright (C) 2023-2026 Michael Rajotte, Dustin Grau, Nomake Wan
+ *
+ *   This program is free software; you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation; either version 3 of the License, or
+ *   (at your option) any later version.
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License
+ *   along with this program; if not, see <https://www.gnu.org/licenses/>.
+ *
+ */
+
+#pragma once
+
+// Standard library includes for integer type definitions
+#include <stdint.h>  // Provides uint8_t, uint16_t, etc.
+#include <stdbool.h> // Provides bool type definition.
+
+/**
+ * NEC Protocol Timings (microseconds)
+ *
+ * A frame is a header mark and space, 32 bits sent LSB first and a stop mark.
+ * Every bit is a mark followed by a short space for a 0 or a long space for a 1.
+ */
+#define IR_NEC_HEADER_MARK  9000
+#define IR_NEC_HEADER_SPACE 4500
+#define IR_NEC_BIT_MARK     562
+#define IR_NEC_ZERO_SPACE   562
+#define IR_NEC_ONE_SPACE    1687
+#define IR_NEC_BITS         32
+#define IR_NEC_SYMBOLS      (IR_NEC_BITS + 2) // Header + 32 bits + stop mark.
+
+#define IR_FRAME_MAX_SYMBOLS IR_NEC_SYMBOLS // Longest frame we send.
+#define IR_TX_QUEUE_SIZE 4                  // Frames waiting for the transmitter.
+#define IR_TX_DUTY_WINDOW_US 1000000        // Window over which the TX duty cycle is measured.
+
+/**
+ * A mark (carrier on) followed by a space (carrier off), with durations in microseconds.
+ * Uses the same layout as the ESP32 rmt_data_t: duration0:15, level0:1, duration1:15, level1:1.
+ * With the transmitter ticking at 1 MHz a buffer of symbols is sent as-is.
+ */
+typedef uint32_t IRSymbol;
+
+inline IRSymbol irSymbol(uint16_t markUs, uint16_t spaceUs) {
+  return (uint32_t)(markUs & 0x7FFF) | (1UL << 15) | ((uint32_t)(spaceUs & 0x7FFF) << 16);
+}
+
+inline uint16_t irSymbolMark(IRSymbol symbol) {
+  return symbol & 0x7FFF;
+}
+
+inline uint16_t irSymbolSpace(IRSymbol symbol) {
+  return (symbol >> 16) & 0x7FFF;
+}
+
+// Kinds of frames. Firing frames repeat while firing, so a newer one replaces one still waiting.
+enum IR_FRAME_KIND : uint8_t {
+  IR_FRAME_SINGLE,
+  IR_FRAME_FIRING
+};
+
+// A frame ready for the transmitter.
+struct IRFrame {
+  IRSymbol symbols[IR_FRAME_MAX_SYMBOLS];
+  uint8_t count;       // Symbols used.
+  uint8_t kind;        // IR_FRAME_KIND
+  uint32_t durationUs; // Time on air.
+};
+
+/**
+ * Builds the 32-bit NEC data for an address and command, as IRremote does:
+ * an 8-bit address is followed by its inverse while a 16-bit address is sent whole,
+ * then the command and its inverse. Byte 0 is sent first.
+ */
+uint32_t irNECRawData(uint16_t address, uint8_t command);
+
+/**
+ * Encodes 32 bits of NEC data as symbols, LSB first.
+ * @return Symbols written (IR_NEC_SYMBOLS), or 0 when they do not fit.
+ */
+uint8_t irEncodeNEC(uint32_t rawData, IRSymbol* symbols, uint8_t maxSymbols);
+
+/**
+ * Encodes raw mark/space durations (starting with a mark) as symbols.
+ * An odd count leaves the final mark with no space.
+ * @return Symbols written, or 0 when they do not fit.
+ */
+uint8_t irEncodeRaw(const uint16_t* durations, uint8_t count, IRSymbol* symbols, uint8_t maxSymbols);
+
+// Total time on air of a run of symbols, in microseconds.
+uint32_t irSymbolsDuration(const IRSymbol* symbols, uint8_t count);
+
+// Fills a frame with NEC data or raw durations. Returns false when the frame cannot hold it.
+bool irFrameNEC(IRFrame& frame, uint32_t rawData, uint8_t kind);
+bool irFrameRaw(IRFrame& frame, const uint16_t* durations, uint8_t count, uint8_t kind);
+
+/**
+ * Frames waiting for the transmitter, oldest first.
+ *
+ * A firing frame pushed while the newest waiting frame is also a firing frame replaces it,
+ * so holding the trigger never builds a backlog of stale codes. Frames taken by the transmitter
+ * count their time on air towards the duty cycle of the window they were sent in.
+ */
+class IRTransmitQueue {
+public:
+  IRTransmitQueue();
+
+  // Adds a frame. Returns false (and counts a drop) when the queue is full.
+  bool push(const IRFrame& frame);
+
+  // The oldest waiting frame, or nullptr when there is none.
+  const IRFrame* front() const;
+
+  // Removes the oldest frame once handed to the transmitter at the given time.
+  void pop(uint32_t nowUs);
+
+  // Records that the transmitter refused the oldest frame, which stays queued to be retried.
+  void failed();
+
+  uint8_t depth() const;
+  uint16_t coalesced() const;
+  uint16_t dropped() const;
+  uint16_t failures() const;
+
+  // Percentage of the last complete window spent transmitting (0-100).
+  uint8_t dutyCycle(uint32_t nowUs);
+
+private:
+  IRFrame m_frames[IR_TX_QUEUE_SIZE];
+  uint8_t m_head;
+  uint8_t m_count;
+  uint16_t m_coalesced;
+  uint16_t m_dropped;
+  uint16_t m_failures;
+  uint32_t m_windowStartUs;
+  uint32_t m_windowBusyUs;
+  uint8_t m_dutyCycle;
+  bool m_windowStarted;
+
+  void rollWindow(uint32_t nowUs);
+};
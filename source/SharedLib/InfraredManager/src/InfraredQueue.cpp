@@ -0,0 +1,185 @@
+/**
+ *   Infrared - IR communication methods for GPStar devices.
+ *   Encodes infrared frames as transmitter symbols and queues them for sending.
+ *   Copyright (C) 2023-2026 Michael Rajotte, Dustin Grau, Nomake Wan
+ *
+ *   This program is free software; you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation; either version 3 of the License, or
+ *   (at your option) any later version.
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License
+ *   along with this program; if not, see <https://www.gnu.org/licenses/>.
+ *
+ */
+
+// Library Header
+#include "InfraredQueue.h"
+
+uint32_t irNECRawData(uint16_t address, uint8_t command) {
+  uint32_t rawData;
+
+  if(address > 0xFF) {
+    rawData = address; // Extended address, sent whole.
+  }
+  else {
+    rawData = address | ((uint32_t)(uint8_t)~address << 8);
+  }
+
+  return rawData | ((uint32_t)command << 16) | ((uint32_t)(uint8_t)~command << 24);
+}
+
+uint8_t irEncodeNEC(uint32_t rawData, IRSymbol* symbols, uint8_t maxSymbols) {
+  if(maxSymbols < IR_NEC_SYMBOLS) {
+    return 0;
+  }
+
+  uint8_t count = 0;
+  symbols[count++] = irSymbol(IR_NEC_HEADER_MARK, IR_NEC_HEADER_SPACE);
+
+  for(uint8_t i = 0; i < IR_NEC_BITS; i++) {
+    symbols[count++] = irSymbol(IR_NEC_BIT_MARK, (rawData & 0x01) ? IR_NEC_ONE_SPACE : IR_NEC_ZERO_SPACE);
+    rawData >>= 1;
+  }
+
+  // The stop mark ends the frame; a zero space tells the transmitter it is done.
+  symbols[count++] = irSymbol(IR_NEC_BIT_MARK, 0);
+
+  return count;
+}
+
+uint8_t irEncodeRaw(const uint16_t* durations, uint8_t count, IRSymbol* symbols, uint8_t maxSymbols) {
+  uint8_t needed = (count + 1) / 2;
+
+  if(count == 0 || needed > maxSymbols) {
+    return 0;
+  }
+
+  for(uint8_t i = 0; i < needed; i++) {
+    uint8_t mark = i * 2;
+    symbols[i] = irSymbol(durations[mark], (mark + 1 < count) ? durations[mark + 1] : 0);
+  }
+
+  return needed;
+}
+
+uint32_t irSymbolsDuration(const IRSymbol* symbols, uint8_t count) {
+  uint32_t total = 0;
+
+  for(uint8_t i = 0; i < count; i++) {
+    total += irSymbolMark(symbols[i]) + irSymbolSpace(symbols[i]);
+  }
+
+  return total;
+}
+
+bool irFrameNEC(IRFrame& frame, uint32_t rawData, uint8_t kind) {
+  frame.count = irEncodeNEC(rawData, frame.symbols, IR_FRAME_MAX_SYMBOLS);
+  frame.kind = kind;
+  frame.durationUs = irSymbolsDuration(frame.symbols, frame.count);
+
+  return frame.count > 0;
+}
+
+bool irFrameRaw(IRFrame& frame, const uint16_t* durations, uint8_t count, uint8_t kind) {
+  frame.count = irEncodeRaw(durations, count, frame.symbols, IR_FRAME_MAX_SYMBOLS);
+  frame.kind = kind;
+  frame.durationUs = irSymbolsDuration(frame.symbols, frame.count);
+
+  return frame.count > 0;
+}
+
+IRTransmitQueue::IRTransmitQueue()
+  : m_head(0), m_count(0), m_coalesced(0), m_dropped(0), m_failures(0),
+    m_windowStartUs(0), m_windowBusyUs(0), m_dutyCycle(0), m_windowStarted(false) {
+}
+
+bool IRTransmitQueue::push(const IRFrame& frame) {
+  if(m_count > 0 && frame.kind == IR_FRAME_FIRING) {
+    IRFrame& newest = m_frames[(m_head + m_count - 1) % IR_TX_QUEUE_SIZE];
+
+    if(newest.kind == IR_FRAME_FIRING) {
+      // Still waiting to be sent, so the newer firing state replaces it.
+      newest = frame;
+      m_coalesced++;
+      return true;
+    }
+  }
+
+  if(m_count >= IR_TX_QUEUE_SIZE) {
+    m_dropped++;
+    return false;
+  }
+
+  m_frames[(m_head + m_count) % IR_TX_QUEUE_SIZE] = frame;
+  m_count++;
+
+  return true;
+}
+
+const IRFrame* IRTransmitQueue::front() const {
+  return m_count > 0 ? &m_frames[m_head] : nullptr;
+}
+
+void IRTransmitQueue::pop(uint32_t nowUs) {
+  if(m_count == 0) {
+    return;
+  }
+
+  rollWindow(nowUs);
+  m_windowBusyUs += m_frames[m_head].durationUs;
+
+  m_head = (m_head + 1) % IR_TX_QUEUE_SIZE;
+  m_count--;
+}
+
+void IRTransmitQueue::failed() {
+  m_failures++;
+}
+
+uint8_t IRTransmitQueue::depth() const {
+  return m_count;
+}
+
+uint16_t IRTransmitQueue::coalesced() const {
+  return m_coalesced;
+}
+
+uint16_t IRTransmitQueue::dropped() const {
+  return m_dropped;
+}
+
+uint16_t IRTransmitQueue::failures() const {
+  return m_failures;
+}
+
+uint8_t IRTransmitQueue::dutyCycle(uint32_t nowUs) {
+  rollWindow(nowUs);
+
+  return m_dutyCycle;
+}
+
+// Closes the current window once it has run its length, keeping its duty cycle.
+void IRTransmitQueue::rollWindow(uint32_t nowUs) {
+  if(!m_windowStarted) {
+    m_windowStartUs = nowUs;
+    m_windowStarted = true;
+    return;
+  }
+
+  uint32_t elapsed = nowUs - m_windowStartUs;
+
+  if(elapsed < IR_TX_DUTY_WINDOW_US) {
+    return;
+  }
+
+  uint32_t percent = (uint32_t)(((uint64_t)m_windowBusyUs * 100) / elapsed);
+  m_dutyCycle = percent > 100 ? 100 : percent;
+  m_windowBusyUs = 0;
+  m_windowStartUs = nowUs;
+}
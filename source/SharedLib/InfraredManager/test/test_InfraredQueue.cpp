@@ -0,0 +1,268 @@
+#include <gtest/gtest.h>
+#include <stdint.h>
+#include "InfraredQueue.h"
+
+// NEC protocol timings as specified, in microseconds (the unit is 562.5us).
+static const double NEC_UNIT = 562.5;
+static const double NEC_HEADER_MARK = 16 * NEC_UNIT;
+static const double NEC_HEADER_SPACE = 8 * NEC_UNIT;
+static const double NEC_ONE_SPACE = 3 * NEC_UNIT;
+
+// Layout of the ESP32 rmt_data_t, to read back the symbols as the RMT peripheral sees them.
+union RmtItem {
+  struct {
+    uint32_t duration0 : 15;
+    uint32_t level0 : 1;
+    uint32_t duration1 : 15;
+    uint32_t level1 : 1;
+  };
+  uint32_t val;
+};
+
+static RmtItem rmtItem(IRSymbol symbol) {
+  RmtItem item;
+  item.val = symbol;
+  return item;
+}
+
+// IRremote computeNECRawDataAndChecksum(), as used before the RMT transmitter.
+static uint32_t refNECRawData(uint16_t aAddress, uint16_t aCommand) {
+  union {
+    uint32_t ULong;
+    struct {
+      uint16_t LowWord;
+      uint16_t HighWord;
+    } UWord;
+    struct {
+      uint8_t LowByte;
+      uint8_t MidLowByte;
+      uint8_t MidHighByte;
+      uint8_t HighByte;
+    } UByte;
+  } tRawData;
+
+  tRawData.UWord.LowWord = aAddress;
+  if(aAddress < 0x100) {
+    tRawData.UByte.MidLowByte = ~tRawData.UByte.LowByte;
+  }
+  tRawData.UByte.MidHighByte = aCommand;
+  tRawData.UByte.HighByte = ~aCommand;
+
+  return tRawData.ULong;
+}
+
+static IRFrame makeFrame(uint32_t rawData, uint8_t kind) {
+  IRFrame frame;
+  irFrameNEC(frame, rawData, kind);
+  return frame;
+}
+
+TEST(InfraredQueueTest, NECRawDataMatchesIRremote) {
+  // GPStar addresses: preamble 0b11, every device type and a spread of device IDs.
+  for(uint16_t type = 0; type < 4; type++) {
+    for(uint16_t id = 0; id < 0x1000; id += 37) {
+      uint16_t address = (0b11 << 14) | (type << 12) | id;
+
+      for(uint16_t command = 0; command < 0x100; command += 5) {
+        ASSERT_EQ(refNECRawData(address, command), irNECRawData(address, command)) << std::hex << address << " " << command;
+      }
+    }
+  }
+
+  // Plain 8-bit addresses carry their inverse.
+  for(uint16_t address = 0; address < 0x100; address++) {
+    ASSERT_EQ(refNECRawData(address, 0x20), irNECRawData(address, 0x20)) << address;
+  }
+}
+
+TEST(InfraredQueueTest, NECFrameMatchesSpecification) {
+  const uint32_t rawData = irNECRawData(0xC123, 0x24);
+  IRSymbol symbols[IR_NEC_SYMBOLS];
+
+  ASSERT_EQ(IR_NEC_SYMBOLS, irEncodeNEC(rawData, symbols, IR_NEC_SYMBOLS));
+  EXPECT_EQ(34, IR_NEC_SYMBOLS);
+
+  // Marks drive the carrier (level 1) and spaces leave it off (level 0), all within 1us of the specification.
+  for(uint8_t i = 0; i < IR_NEC_SYMBOLS; i++) {
+    RmtItem item = rmtItem(symbols[i]);
+    EXPECT_EQ(1u, item.level0) << (int)i;
+    EXPECT_EQ(0u, item.level1) << (int)i;
+  }
+
+  RmtItem header = rmtItem(symbols[0]);
+  EXPECT_NEAR(NEC_HEADER_MARK, header.duration0, 1.0);
+  EXPECT_NEAR(NEC_HEADER_SPACE, header.duration1, 1.0);
+
+  // Data bits are sent LSB first: address low byte, address high byte, command, inverted command.
+  uint32_t decoded = 0;
+  for(uint8_t bit = 0; bit < IR_NEC_BITS; bit++) {
+    RmtItem item = rmtItem(symbols[1 + bit]);
+    EXPECT_NEAR(NEC_UNIT, item.duration0, 1.0) << (int)bit;
+
+    if(item.duration1 > 2 * NEC_UNIT) {
+      EXPECT_NEAR(NEC_ONE_SPACE, item.duration1, 1.0) << (int)bit;
+      decoded |= (1UL << bit);
+    }
+    else {
+      EXPECT_NEAR(NEC_UNIT, item.duration1, 1.0) << (int)bit;
+    }
+  }
+  EXPECT_EQ(rawData, decoded);
+
+  // The stop mark ends with a zero duration, which the RMT takes as the end of the transmission.
+  RmtItem stop = rmtItem(symbols[IR_NEC_SYMBOLS - 1]);
+  EXPECT_NEAR(NEC_UNIT, stop.duration0, 1.0);
+  EXPECT_EQ(0u, stop.duration1);
+}
+
+TEST(InfraredQueueTest, NECFrameDuration) {
+  // Any address followed by a command and its inverse: 16 of the data bits depend on the address.
+  for(uint32_t address = 0xC000; address < 0x10000; address += 97) {
+    IRFrame frame = makeFrame(irNECRawData(address, 0x42), IR_FRAME_SINGLE);
+
+    uint8_t ones = 0;
+    for(uint8_t bit = 0; bit < IR_NEC_BITS; bit++) {
+      ones += (irNECRawData(address, 0x42) >> bit) & 0x01;
+    }
+
+    double expected = NEC_HEADER_MARK + NEC_HEADER_SPACE + IR_NEC_BITS * NEC_UNIT
+                    + ones * NEC_ONE_SPACE + (IR_NEC_BITS - ones) * NEC_UNIT + NEC_UNIT;
+    EXPECT_NEAR(expected, frame.durationUs, 0.001 * expected) << std::hex << address;
+  }
+
+  // With 16 ones the frame is the 67.5ms of the specification plus the stop mark.
+  IRFrame balanced = makeFrame(0x00FF00FF, IR_FRAME_SINGLE);
+  EXPECT_NEAR(67500.0 + NEC_UNIT, balanced.durationUs, 60.0);
+}
+
+TEST(InfraredQueueTest, RawTimings) {
+  // Ghost Trap (PKE) raw timings, an odd count ending with a mark.
+  static const uint16_t ghostInTrap[] = {
+    1770, 1200, 600, 600, 600, 600, 580, 1200, 600, 600,
+    580, 1200, 600, 1200, 580, 600, 580, 1200, 600
+  };
+  const uint8_t count = sizeof(ghostInTrap) / sizeof(ghostInTrap[0]);
+
+  IRFrame frame;
+  ASSERT_TRUE(irFrameRaw(frame, ghostInTrap, count, IR_FRAME_SINGLE));
+  ASSERT_EQ(10, frame.count);
+
+  uint32_t total = 0;
+  for(uint8_t i = 0; i < count; i++) {
+    RmtItem item = rmtItem(frame.symbols[i / 2]);
+    EXPECT_EQ(ghostInTrap[i], (i % 2 == 0) ? item.duration0 : item.duration1) << (int)i;
+    total += ghostInTrap[i];
+  }
+
+  EXPECT_EQ(0u, rmtItem(frame.symbols[9]).duration1);
+  EXPECT_EQ(total, frame.durationUs);
+}
+
+TEST(InfraredQueueTest, EncodingNeedsRoom) {
+  static const uint16_t timings[] = {100, 200, 300};
+  IRSymbol symbols[IR_NEC_SYMBOLS];
+
+  EXPECT_EQ(0, irEncodeNEC(0x12345678, symbols, IR_NEC_SYMBOLS - 1));
+  EXPECT_EQ(0, irEncodeRaw(timings, 3, symbols, 1));
+  EXPECT_EQ(0, irEncodeRaw(timings, 0, symbols, IR_NEC_SYMBOLS));
+  EXPECT_EQ(2, irEncodeRaw(timings, 3, symbols, 2));
+}
+
+TEST(InfraredQueueTest, FiringFramesCoalesce) {
+  IRTransmitQueue queue;
+
+  // Holding the trigger keeps sending the newest firing code; only one waits at a time.
+  for(uint8_t level = 0; level < 5; level++) {
+    EXPECT_TRUE(queue.push(makeFrame(irNECRawData(0xC123, 0x20 + level), IR_FRAME_FIRING)));
+  }
+
+  EXPECT_EQ(1, queue.depth());
+  EXPECT_EQ(4, queue.coalesced());
+  EXPECT_EQ(makeFrame(irNECRawData(0xC123, 0x24), IR_FRAME_FIRING).symbols[17], queue.front()->symbols[17]);
+  EXPECT_EQ(makeFrame(irNECRawData(0xC123, 0x24), IR_FRAME_FIRING).durationUs, queue.front()->durationUs);
+
+  // Once taken by the transmitter, the next firing code waits behind it.
+  queue.pop(0);
+  EXPECT_EQ(0, queue.depth());
+  EXPECT_TRUE(queue.push(makeFrame(irNECRawData(0xC123, 0x20), IR_FRAME_FIRING)));
+  EXPECT_EQ(1, queue.depth());
+  EXPECT_EQ(4, queue.coalesced());
+}
+
+TEST(InfraredQueueTest, SingleFramesKeepOrder) {
+  IRTransmitQueue queue;
+
+  // A firing code following a single frame waits behind it, and a single frame is never replaced.
+  EXPECT_TRUE(queue.push(makeFrame(irNECRawData(0xC123, 0xFF), IR_FRAME_SINGLE)));
+  EXPECT_TRUE(queue.push(makeFrame(irNECRawData(0xC123, 0x20), IR_FRAME_FIRING)));
+  EXPECT_TRUE(queue.push(makeFrame(irNECRawData(0xC123, 0xFF), IR_FRAME_SINGLE)));
+  EXPECT_TRUE(queue.push(makeFrame(irNECRawData(0xC123, 0x21), IR_FRAME_FIRING)));
+  EXPECT_EQ(4, queue.depth());
+  EXPECT_EQ(0, queue.coalesced());
+
+  // Full: a single frame is dropped while a firing frame still replaces the newest one.
+  EXPECT_FALSE(queue.push(makeFrame(irNECRawData(0xC123, 0xFF), IR_FRAME_SINGLE)));
+  EXPECT_EQ(1, queue.dropped());
+  EXPECT_TRUE(queue.push(makeFrame(irNECRawData(0xC123, 0x22), IR_FRAME_FIRING)));
+  EXPECT_EQ(1, queue.coalesced());
+
+  const uint8_t expected[] = {IR_FRAME_SINGLE, IR_FRAME_FIRING, IR_FRAME_SINGLE, IR_FRAME_FIRING};
+  for(uint8_t i = 0; i < 4; i++) {
+    ASSERT_NE(nullptr, queue.front());
+    EXPECT_EQ(expected[i], queue.front()->kind) << (int)i;
+    queue.pop(0);
+  }
+
+  EXPECT_EQ(nullptr, queue.front());
+  queue.pop(0); // Nothing left to take.
+  EXPECT_EQ(0, queue.depth());
+}
+
+TEST(InfraredQueueTest, FailedWriteKeepsFrame) {
+  IRTransmitQueue queue;
+  IRFrame frame = makeFrame(0x00FF00FF, IR_FRAME_SINGLE);
+
+  // A refused frame stays at the front without counting towards the duty cycle.
+  EXPECT_TRUE(queue.push(frame));
+  queue.failed();
+  EXPECT_EQ(1, queue.failures());
+  EXPECT_EQ(1, queue.depth());
+  ASSERT_NE(nullptr, queue.front());
+  EXPECT_EQ(frame.durationUs, queue.front()->durationUs);
+
+  queue.pop(0);
+  EXPECT_EQ(0, queue.depth());
+  EXPECT_EQ(1, queue.failures());
+}
+
+TEST(InfraredQueueTest, DutyCycle) {
+  IRTransmitQueue queue;
+  IRFrame frame = makeFrame(0x00FF00FF, IR_FRAME_FIRING);
+  uint32_t now = 0xFFF00000; // Crosses the micros() rollover.
+
+  EXPECT_EQ(0, queue.dutyCycle(now));
+
+  // The wand repeats the firing code every 250ms, with the transmitter busy ~68ms each time.
+  for(uint8_t i = 0; i < 4; i++) {
+    queue.push(frame);
+    queue.pop(now);
+    now += 250000;
+  }
+
+  EXPECT_EQ((frame.durationUs * 4 * 100) / IR_TX_DUTY_WINDOW_US, queue.dutyCycle(now));
+
+  // Back to back frames keep the transmitter busy through the whole window, the last running past its end.
+  const uint32_t windowStart = now;
+  for(uint32_t i = 0; i <= IR_TX_DUTY_WINDOW_US / frame.durationUs; i++) {
+    queue.push(frame);
+    queue.pop(now);
+    now += frame.durationUs;
+  }
+
+  now = windowStart + IR_TX_DUTY_WINDOW_US;
+  EXPECT_EQ(100, queue.dutyCycle(now));
+
+  // An idle window brings it back to zero.
+  now += IR_TX_DUTY_WINDOW_US;
+  EXPECT_EQ(0, queue.dutyCycle(now));
+}
@@ -0,0 +1,197 @@
+/**
+ *   LEDCompositor - Layered LED effect compositing for GPStar devices.
+ *   Combines ordered effect layers into an LED buffer, recomputing only changed spans.
+ *   Copyright (C) 2023-2026 Michael Rajotte, Dustin Grau, Nomake Wan
+ *
+ *   This program is free software; you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation; either version 3 of the License, or
+ *   (at your option) any later version.
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License
+ *   along with this program; if not, see <https://www.gnu.org/licenses/>.
+ *
+ */
+
+#pragma once
+
+// Standard library includes for integer type definitions
+#include <stdint.h>  // Provides uint8_t, uint16_t, etc.
+#include <stdbool.h> // Provides bool type definition.
+
+// Maximum number of layers which may be attached to a single compositor.
+#define LED_COMPOSITOR_MAX_LAYERS 8
+
+// Pixels are stored as 3 bytes in R, G, B order which matches the memory layout
+// of a FastLED CRGB object, so an existing CRGB array may be used as the output.
+#define LED_COMPOSITOR_BYTES_PER_PIXEL 3
+
+// LayerBlendMode: How the covered pixels of a layer combine with everything beneath them.
+enum LayerBlendMode : uint8_t {
+  LAYER_BLEND_PRIORITY = 0, // Covered pixels replace anything beneath them.
+  LAYER_BLEND_ALPHA = 1,    // Covered pixels are mixed with what is beneath them by the layer alpha.
+  LAYER_BLEND_ADD = 2       // Covered pixels are added to what is beneath them (saturating).
+};
+
+/**
+ * Struct: LEDSpan
+ * Purpose: A half-open range [start, end) of pixel positions in output space.
+ * An empty span has start >= end.
+ */
+struct LEDSpan {
+  uint16_t start = 0;
+  uint16_t end = 0;
+
+  bool isEmpty() const { return start >= end; }
+  void reset() { start = 0; end = 0; }
+
+  // Grows the span to cover the range [first, last).
+  void include(uint16_t first, uint16_t last) {
+    if(first >= last) {
+      return;
+    }
+
+    if(isEmpty()) {
+      start = first;
+      end = last;
+    }
+    else {
+      if(first < start) start = first;
+      if(last > end) end = last;
+    }
+  }
+};
+
+/**
+ * Class: LEDLayer
+ * Purpose: A single effect layer which owns a contiguous range of the output buffer.
+ *
+ * Each pixel of a layer is either covered (it has a colour to contribute) or transparent.
+ * Writes only mark the layer dirty when a pixel actually changes, so an effect may redraw
+ * its whole range every frame without forcing the compositor to recompute anything.
+ * Storage is supplied by the caller; use LEDLayerBuffer<N> for a self-contained layer.
+ *
+ * Example usage:
+ *   LEDLayerBuffer<7> ventLayer;
+ *   ventLayer.setOffset(55);
+ *   ventLayer.fill(0, 7, 255, 255, 255);
+ */
+class LEDLayer {
+public:
+  // Constructor, using caller-provided pixel (length * 3 bytes) and coverage ((length + 7) / 8 bytes) storage.
+  LEDLayer(uint8_t* pixels, uint8_t* coverage, uint16_t length);
+
+  // Placement of the layer within the output buffer.
+  void setOffset(uint16_t offset);
+  uint16_t getOffset() const;
+  uint16_t getLength() const;
+
+  // Blending controls for the whole layer. Alpha mixes LAYER_BLEND_ALPHA layers, and an alpha of 0 hides any layer.
+  void setBlendMode(LayerBlendMode mode);
+  LayerBlendMode getBlendMode() const;
+  void setAlpha(uint8_t alpha);
+  uint8_t getAlpha() const;
+  void setEnabled(bool enabled);
+  bool isEnabled() const;
+
+  // Pixel access, where the index is local to the layer.
+  void setPixel(uint16_t index, uint8_t r, uint8_t g, uint8_t b);
+  void fill(uint16_t index, uint16_t count, uint8_t r, uint8_t g, uint8_t b);
+  void clearPixel(uint16_t index);
+  void clear();
+  bool isCovered(uint16_t index) const;
+  const uint8_t* getPixel(uint16_t index) const;
+
+  // Dirty tracking, reported in output space (after the offset is applied).
+  LEDSpan getDirtySpan() const;
+  void markDirty(uint16_t index, uint16_t count);
+  void markAllDirty();
+  void clearDirty();
+
+protected:
+  // Clears coverage and pixel storage without marking anything dirty.
+  void reset();
+
+private:
+  uint8_t* pixels;
+  uint8_t* coverage;
+  uint16_t length;
+  uint16_t offset = 0;
+  LayerBlendMode blendMode = LAYER_BLEND_PRIORITY;
+  uint8_t alpha = 255;
+  bool enabled = true;
+  LEDSpan dirty;
+};
+
+/**
+ * Class: LEDLayerBuffer
+ * Purpose: An LEDLayer which carries its own storage for N pixels.
+ */
+template <uint16_t N>
+class LEDLayerBuffer : public LEDLayer {
+public:
+  LEDLayerBuffer() : LEDLayer(pixelStore, coverageStore, N) {
+    reset();
+  }
+
+private:
+  uint8_t pixelStore[N * LED_COMPOSITOR_BYTES_PER_PIXEL];
+  uint8_t coverageStore[(N + 7) / 8];
+};
+
+/**
+ * Class: LEDCompositor
+ * Purpose: Combines ordered layers (bottom to top) into an output LED buffer.
+ *
+ * Ownership rules:
+ * - Pixels within the range of at least one attached layer are owned by the compositor.
+ *   They are recomputed from the layers (over the background colour) whenever a layer
+ *   covering them reports a change.
+ * - Pixels outside the range of every layer are never touched, so existing code may keep
+ *   writing those directly into the output buffer.
+ *
+ * Only the dirty spans reported by the layers are recomputed on each call to compose().
+ *
+ * Example usage:
+ *   LEDCompositor compositor(pack_leds[0].raw, 62);
+ *   compositor.addLayer(&ventLayer);
+ *   if(compositor.compose()) { FastLED.show(); }
+ */
+class LEDCompositor {
+public:
+  // Constructor, using an output buffer of length * 3 bytes.
+  LEDCompositor(uint8_t* output, uint16_t length);
+
+  // Adds a layer on top of all existing layers. Returns false if no slots remain.
+  bool addLayer(LEDLayer* layer);
+  uint8_t getLayerCount() const;
+
+  // Colour used beneath all layers for owned pixels (default is black).
+  void setBackground(uint8_t r, uint8_t g, uint8_t b);
+
+  // Forces every owned pixel to be recomputed on the next call to compose().
+  void invalidate();
+
+  // Recomputes all dirty spans into the output buffer.
+  // Returns true if any output pixel changed value.
+  bool compose();
+
+  // Number of pixels recomputed by the last call to compose().
+  uint16_t getLastComposedCount() const;
+
+private:
+  void composeSpan(uint16_t start, uint16_t end, bool& changed);
+
+  uint8_t* output;
+  uint16_t length;
+  LEDLayer* layers[LED_COMPOSITOR_MAX_LAYERS] = {};
+  uint8_t layerCount = 0;
+  uint8_t background[LED_COMPOSITOR_BYTES_PER_PIXEL] = {0, 0, 0};
+  bool fullRecompose = true;
+  uint16_t lastComposedCount = 0;
+};
@@ -0,0 +1,329 @@
+/**
+ *   LEDCompositor - Layered LED effect compositing for GPStar devices.
+ *   Combines ordered effect layers into an LED buffer, recomputing only changed spans.
+ *   Copyright (C) 2023-2026 Michael Rajotte, Dustin Grau, Nomake Wan
+ *
+ *   This program is free software; you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation; either version 3 of the License, or
+ *   (at your option) any later version.
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License
+ *   along with this program; if not, see <https://www.gnu.org/licenses/>.
+ *
+ */
+
+// Standard library includes for memory functions
+#include <string.h>
+
+// Library Header
+#include "LEDCompositor.h"
+
+/**
+ * LEDLayer
+ */
+
+LEDLayer::LEDLayer(uint8_t* pixels, uint8_t* coverage, uint16_t length)
+  : pixels(pixels), coverage(coverage), length(length) {
+}
+
+void LEDLayer::reset() {
+  memset(pixels, 0, length * LED_COMPOSITOR_BYTES_PER_PIXEL);
+  memset(coverage, 0, (length + 7) / 8);
+  dirty.reset();
+}
+
+void LEDLayer::setOffset(uint16_t newOffset) {
+  if(newOffset != offset) {
+    markAllDirty(); // Pixels left behind may still be owned by a lower layer.
+    offset = newOffset;
+    markAllDirty();
+  }
+}
+
+uint16_t LEDLayer::getOffset() const {
+  return offset;
+}
+
+uint16_t LEDLayer::getLength() const {
+  return length;
+}
+
+void LEDLayer::setBlendMode(LayerBlendMode mode) {
+  if(mode != blendMode) {
+    blendMode = mode;
+    markAllDirty();
+  }
+}
+
+LayerBlendMode LEDLayer::getBlendMode() const {
+  return blendMode;
+}
+
+void LEDLayer::setAlpha(uint8_t newAlpha) {
+  if(newAlpha != alpha) {
+    alpha = newAlpha;
+    markAllDirty();
+  }
+}
+
+uint8_t LEDLayer::getAlpha() const {
+  return alpha;
+}
+
+void LEDLayer::setEnabled(bool newEnabled) {
+  if(newEnabled != enabled) {
+    enabled = newEnabled;
+    markAllDirty();
+  }
+}
+
+bool LEDLayer::isEnabled() const {
+  return enabled;
+}
+
+void LEDLayer::setPixel(uint16_t index, uint8_t r, uint8_t g, uint8_t b) {
+  if(index >= length) {
+    return;
+  }
+
+  uint8_t* px = &pixels[index * LED_COMPOSITOR_BYTES_PER_PIXEL];
+  uint8_t mask = 1 << (index & 7);
+
+  // Only a real change in colour or coverage requires the pixel to be recomposed.
+  if((coverage[index >> 3] & mask) && px[0] == r && px[1] == g && px[2] == b) {
+    return;
+  }
+
+  px[0] = r;
+  px[1] = g;
+  px[2] = b;
+  coverage[index >> 3] |= mask;
+  markDirty(index, 1);
+}
+
+void LEDLayer::fill(uint16_t index, uint16_t count, uint8_t r, uint8_t g, uint8_t b) {
+  for(uint16_t i = index; i < index + count && i < length; i++) {
+    setPixel(i, r, g, b);
+  }
+}
+
+void LEDLayer::clearPixel(uint16_t index) {
+  if(index >= length) {
+    return;
+  }
+
+  uint8_t mask = 1 << (index & 7);
+
+  if(coverage[index >> 3] & mask) {
+    coverage[index >> 3] &= ~mask;
+    markDirty(index, 1);
+  }
+}
+
+void LEDLayer::clear() {
+  for(uint16_t i = 0; i < length; i++) {
+    clearPixel(i);
+  }
+}
+
+bool LEDLayer::isCovered(uint16_t index) const {
+  if(index >= length) {
+    return false;
+  }
+
+  return (coverage[index >> 3] & (1 << (index & 7))) != 0;
+}
+
+const uint8_t* LEDLayer::getPixel(uint16_t index) const {
+  return &pixels[index * LED_COMPOSITOR_BYTES_PER_PIXEL];
+}
+
+LEDSpan LEDLayer::getDirtySpan() const {
+  return dirty;
+}
+
+void LEDLayer::markDirty(uint16_t index, uint16_t count) {
+  if(index >= length) {
+    return;
+  }
+
+  if(index + count > length) {
+    count = length - index;
+  }
+
+  dirty.include(offset + index, offset + index + count);
+}
+
+void LEDLayer::markAllDirty() {
+  markDirty(0, length);
+}
+
+void LEDLayer::clearDirty() {
+  dirty.reset();
+}
+
+/**
+ * LEDCompositor
+ */
+
+LEDCompositor::LEDCompositor(uint8_t* output, uint16_t length)
+  : output(output), length(length) {
+}
+
+bool LEDCompositor::addLayer(LEDLayer* layer) {
+  if(layer == nullptr || layerCount >= LED_COMPOSITOR_MAX_LAYERS) {
+    return false;
+  }
+
+  layers[layerCount++] = layer;
+  layer->markAllDirty();
+  return true;
+}
+
+uint8_t LEDCompositor::getLayerCount() const {
+  return layerCount;
+}
+
+void LEDCompositor::setBackground(uint8_t r, uint8_t g, uint8_t b) {
+  if(background[0] != r || background[1] != g || background[2] != b) {
+    background[0] = r;
+    background[1] = g;
+    background[2] = b;
+    invalidate();
+  }
+}
+
+void LEDCompositor::invalidate() {
+  fullRecompose = true;
+}
+
+bool LEDCompositor::compose() {
+  LEDSpan spans[LED_COMPOSITOR_MAX_LAYERS];
+  uint8_t spanCount = 0;
+  bool changed = false;
+
+  lastComposedCount = 0;
+
+  // Gather the dirty span of every layer, kept sorted by starting position.
+  for(uint8_t i = 0; i < layerCount; i++) {
+    LEDSpan span = layers[i]->getDirtySpan();
+
+    if(fullRecompose) {
+      span.reset();
+      span.include(layers[i]->getOffset(), layers[i]->getOffset() + layers[i]->getLength());
+    }
+
+    if(span.end > length) {
+      span.end = length;
+    }
+
+    if(span.isEmpty()) {
+      continue;
+    }
+
+    uint8_t j = spanCount++;
+    while(j > 0 && spans[j - 1].start > span.start) {
+      spans[j] = spans[j - 1];
+      j--;
+    }
+    spans[j] = span;
+  }
+
+  // Merge overlapping or adjacent spans so no pixel is composed twice.
+  uint8_t merged = 0;
+  for(uint8_t i = 0; i < spanCount; i++) {
+    if(merged > 0 && spans[i].start <= spans[merged - 1].end) {
+      if(spans[i].end > spans[merged - 1].end) {
+        spans[merged - 1].end = spans[i].end;
+      }
+    }
+    else {
+      spans[merged++] = spans[i];
+    }
+  }
+
+  for(uint8_t i = 0; i < merged; i++) {
+    composeSpan(spans[i].start, spans[i].end, changed);
+  }
+
+  for(uint8_t i = 0; i < layerCount; i++) {
+    layers[i]->clearDirty();
+  }
+
+  fullRecompose = false;
+
+  return changed;
+}
+
+uint16_t LEDCompositor::getLastComposedCount() const {
+  return lastComposedCount;
+}
+
+void LEDCompositor::composeSpan(uint16_t start, uint16_t end, bool& changed) {
+  for(uint16_t p = start; p < end; p++) {
+    uint8_t px[LED_COMPOSITOR_BYTES_PER_PIXEL] = { background[0], background[1], background[2] };
+    bool owned = false;
+
+    for(uint8_t l = 0; l < layerCount; l++) {
+      LEDLayer* layer = layers[l];
+
+      if(p < layer->getOffset() || p >= layer->getOffset() + layer->getLength()) {
+        continue;
+      }
+
+      owned = true; // Layer range includes this pixel, even if it contributes nothing.
+
+      uint16_t index = p - layer->getOffset();
+
+      if(!layer->isEnabled() || layer->getAlpha() == 0 || !layer->isCovered(index)) {
+        continue;
+      }
+
+      const uint8_t* src = layer->getPixel(index);
+
+      switch(layer->getBlendMode()) {
+        case LAYER_BLEND_PRIORITY:
+        default:
+          px[0] = src[0];
+          px[1] = src[1];
+          px[2] = src[2];
+        break;
+
+        case LAYER_BLEND_ALPHA:
+          // Linear mix where an alpha of 255 yields exactly the layer colour.
+          for(uint8_t c = 0; c < LED_COMPOSITOR_BYTES_PER_PIXEL; c++) {
+            px[c] = px[c] + (((int16_t)src[c] - px[c]) * (layer->getAlpha() + 1) >> 8);
+          }
+        break;
+
+        case LAYER_BLEND_ADD:
+          for(uint8_t c = 0; c < LED_COMPOSITOR_BYTES_PER_PIXEL; c++) {
+            uint16_t sum = px[c] + src[c];
+            px[c] = sum > 255 ? 255 : sum;
+          }
+        break;
+      }
+    }
+
+    if(!owned) {
+      continue; // Pixel belongs to direct writes outside of the compositor.
+    }
+
+    lastComposedCount++;
+
+    uint8_t* dst = &output[p * LED_COMPOSITOR_BYTES_PER_PIXEL];
+
+    if(dst[0] != px[0] || dst[1] != px[1] || dst[2] != px[2]) {
+      dst[0] = px[0];
+      dst[1] = px[1];
+      dst[2] = px[2];
+      changed = true;
+    }
+  }
+}
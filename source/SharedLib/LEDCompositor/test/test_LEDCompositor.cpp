@@ -0,0 +1,189 @@
+/**
+ * Test suite for the layered LED compositor.
+ */
+
+#include <gtest/gtest.h>
+#include "LEDCompositor.h"
+#include <string.h>
+
+#define OUTPUT_PIXELS 16
+
+// Test fixture with an output buffer and two layers stacked over part of it.
+class LEDCompositorFixture : public ::testing::Test {
+protected:
+    uint8_t output[OUTPUT_PIXELS * LED_COMPOSITOR_BYTES_PER_PIXEL];
+    LEDCompositor compositor{output, OUTPUT_PIXELS};
+    LEDLayerBuffer<8> baseLayer;
+    LEDLayerBuffer<4> overlayLayer;
+
+    // SetUp() is called before each test.
+    // Fills the output with a marker value so untouched pixels can be detected.
+    void SetUp() override {
+        memset(output, 7, sizeof(output));
+        baseLayer.setOffset(4);    // Owns pixels 4-11.
+        overlayLayer.setOffset(6); // Owns pixels 6-9.
+        compositor.addLayer(&baseLayer);
+        compositor.addLayer(&overlayLayer);
+    }
+
+    const uint8_t* pixel(uint16_t i) {
+        return &output[i * LED_COMPOSITOR_BYTES_PER_PIXEL];
+    }
+};
+
+TEST_F(LEDCompositorFixture, CanInstantiate) {
+    EXPECT_EQ(compositor.getLayerCount(), 2);
+}
+
+// Pixels outside of every layer range belong to direct writes and are never touched.
+TEST_F(LEDCompositorFixture, LeavesUnownedPixelsAlone) {
+    compositor.compose();
+    EXPECT_EQ(pixel(0)[0], 7);
+    EXPECT_EQ(pixel(3)[2], 7);
+    EXPECT_EQ(pixel(12)[1], 7);
+    EXPECT_EQ(pixel(15)[0], 7);
+
+    // Owned pixels without coverage fall back to the background.
+    EXPECT_EQ(pixel(4)[0], 0);
+    EXPECT_EQ(pixel(11)[2], 0);
+}
+
+// Higher layers replace lower layers where they are covered.
+TEST_F(LEDCompositorFixture, PriorityBlendUsesTopLayer) {
+    baseLayer.fill(0, 8, 10, 20, 30);
+    overlayLayer.setPixel(1, 200, 100, 50);
+    EXPECT_TRUE(compositor.compose());
+
+    EXPECT_EQ(pixel(4)[0], 10);
+    EXPECT_EQ(pixel(7)[0], 200);
+    EXPECT_EQ(pixel(7)[1], 100);
+    EXPECT_EQ(pixel(7)[2], 50);
+    EXPECT_EQ(pixel(8)[0], 10); // Overlay pixel not covered, so base shows through.
+}
+
+// Clearing an overlay pixel restores what lies beneath it without stale values.
+TEST_F(LEDCompositorFixture, ClearingOverlayRevealsBase) {
+    baseLayer.fill(0, 8, 10, 20, 30);
+    overlayLayer.fill(0, 4, 255, 0, 0);
+    compositor.compose();
+    EXPECT_EQ(pixel(6)[0], 255);
+
+    overlayLayer.clear();
+    EXPECT_TRUE(compositor.compose());
+    EXPECT_EQ(pixel(6)[0], 10);
+    EXPECT_EQ(pixel(9)[2], 30);
+}
+
+// Disabling a layer is equivalent to clearing all of its coverage.
+TEST_F(LEDCompositorFixture, DisabledLayerIsSkipped) {
+    baseLayer.fill(0, 8, 10, 20, 30);
+    overlayLayer.fill(0, 4, 255, 0, 0);
+    compositor.compose();
+
+    overlayLayer.setEnabled(false);
+    compositor.compose();
+    EXPECT_EQ(pixel(7)[0], 10);
+
+    overlayLayer.setEnabled(true);
+    compositor.compose();
+    EXPECT_EQ(pixel(7)[0], 255);
+}
+
+// Alpha of 255 is exact, 0 hides the layer, and values between mix linearly.
+TEST_F(LEDCompositorFixture, AlphaBlendMixesColours) {
+    baseLayer.fill(0, 8, 0, 0, 200);
+    overlayLayer.setBlendMode(LAYER_BLEND_ALPHA);
+    overlayLayer.fill(0, 4, 200, 0, 0);
+
+    compositor.compose();
+    EXPECT_EQ(pixel(6)[0], 200);
+    EXPECT_EQ(pixel(6)[2], 0);
+
+    overlayLayer.setAlpha(0);
+    compositor.compose();
+    EXPECT_EQ(pixel(6)[0], 0);
+    EXPECT_EQ(pixel(6)[2], 200);
+
+    overlayLayer.setAlpha(127);
+    compositor.compose();
+    EXPECT_NEAR(pixel(6)[0], 100, 1);
+    EXPECT_NEAR(pixel(6)[2], 100, 1);
+}
+
+// Additive layers saturate instead of wrapping.
+TEST_F(LEDCompositorFixture, AddBlendSaturates) {
+    baseLayer.fill(0, 8, 200, 10, 0);
+    overlayLayer.setBlendMode(LAYER_BLEND_ADD);
+    overlayLayer.fill(0, 4, 100, 10, 0);
+    compositor.compose();
+
+    EXPECT_EQ(pixel(6)[0], 255);
+    EXPECT_EQ(pixel(6)[1], 20);
+    EXPECT_EQ(pixel(4)[0], 200);
+}
+
+// Rewriting identical values must not cause any pixels to be recomposed.
+TEST_F(LEDCompositorFixture, UnchangedWritesAreNotDirty) {
+    baseLayer.fill(0, 8, 10, 20, 30);
+    compositor.compose();
+
+    baseLayer.fill(0, 8, 10, 20, 30);
+    EXPECT_TRUE(baseLayer.getDirtySpan().isEmpty());
+    EXPECT_FALSE(compositor.compose());
+    EXPECT_EQ(compositor.getLastComposedCount(), 0);
+}
+
+// Only the span of pixels which actually changed is recomposed.
+TEST_F(LEDCompositorFixture, RecomposesOnlyDirtySpan) {
+    baseLayer.fill(0, 8, 10, 20, 30);
+    compositor.compose();
+    EXPECT_EQ(compositor.getLastComposedCount(), 8);
+
+    baseLayer.setPixel(2, 1, 2, 3);
+    baseLayer.setPixel(3, 1, 2, 3);
+    LEDSpan span = baseLayer.getDirtySpan();
+    EXPECT_EQ(span.start, 6);
+    EXPECT_EQ(span.end, 8);
+
+    EXPECT_TRUE(compositor.compose());
+    EXPECT_EQ(compositor.getLastComposedCount(), 2);
+    EXPECT_EQ(pixel(6)[0], 1);
+    EXPECT_EQ(pixel(5)[0], 10);
+}
+
+// Overlapping spans from several layers are merged so no pixel is composed twice.
+TEST_F(LEDCompositorFixture, OverlappingSpansAreMerged) {
+    compositor.compose();
+
+    baseLayer.fill(0, 4, 1, 1, 1);    // Pixels 4-7.
+    overlayLayer.fill(0, 4, 2, 2, 2); // Pixels 6-9.
+    compositor.compose();
+    EXPECT_EQ(compositor.getLastComposedCount(), 6);
+}
+
+// Moving a layer recomposes both its old and new ranges so no stale pixels remain.
+TEST_F(LEDCompositorFixture, OffsetChangeMovesOwnership) {
+    overlayLayer.fill(0, 4, 9, 9, 9);
+    compositor.compose();
+    EXPECT_EQ(pixel(9)[0], 9);
+
+    overlayLayer.setOffset(12);
+    compositor.compose();
+    EXPECT_EQ(pixel(12)[0], 9);
+    EXPECT_EQ(pixel(15)[0], 9);
+    EXPECT_EQ(pixel(9)[0], 0); // Still owned by the base layer, which is uncovered there.
+}
+
+// Layers are limited to the configured maximum.
+TEST(LEDCompositorLimits, RejectsTooManyLayers) {
+    uint8_t output[3];
+    LEDCompositor compositor(output, 1);
+    LEDLayerBuffer<1> layers[LED_COMPOSITOR_MAX_LAYERS + 1];
+
+    for(uint8_t i = 0; i < LED_COMPOSITOR_MAX_LAYERS; i++) {
+        EXPECT_TRUE(compositor.addLayer(&layers[i]));
+    }
+
+    EXPECT_FALSE(compositor.addLayer(&layers[LED_COMPOSITOR_MAX_LAYERS]));
+    EXPECT_FALSE(compositor.addLayer(nullptr));
+}
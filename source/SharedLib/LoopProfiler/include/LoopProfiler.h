@@ -0,0 +1,114 @@
+/**
+ *   LoopProfiler - Per-section loop timing with latency histograms for GPStar devices.
+ *   Accumulates min, average, maximum and percentile timings for sections of the main loop.
+ *   Copyright (C) 2023-2026 Michael Rajotte, Dustin Grau, Nomake Wan
+ *
+ *   This program is free software; you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation; either version 3 of the License, or
+ *   (at your option) any later version.
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License
+ *   along with this program; if not, see <https://www.gnu.org/licenses/>.
+ *
+ */
+
+#pragma once
+
+// Standard library includes for integer type definitions
+#include <stdint.h>  // Provides uint8_t, uint32_t, etc.
+#include <stdbool.h> // Provides bool type definition.
+
+// Each power of two is split into this many histogram buckets (25% resolution).
+#define PROFILER_SUB_BUCKETS 4
+
+// Number of buckets needed to hold durations below 2^bits ticks without clamping.
+#define PROFILER_BUCKETS_FOR_BITS(bits) ((bits) * PROFILER_SUB_BUCKETS - PROFILER_SUB_BUCKETS)
+
+/**
+ * Struct: SectionSummary
+ * Purpose: Timings of a section converted to the caller's units (usually microseconds).
+ */
+struct SectionSummary {
+  uint32_t count = 0; // Number of samples recorded.
+  uint32_t min = 0;
+  uint32_t avg = 0;
+  uint32_t max = 0;
+  uint32_t p99 = 0;   // Upper bound of the histogram bucket holding the 99th percentile.
+};
+
+/**
+ * Class: SectionStats
+ * Purpose: Records the duration of each run of a code section.
+ *
+ * Durations are recorded as raw ticks (CPU cycles or microseconds), so recording costs a few
+ * comparisons and one bucket increment with no division. The histogram is log-linear: small
+ * values each get their own bucket, then every power of two is split into PROFILER_SUB_BUCKETS,
+ * so percentiles are accurate to within 25% at any scale. Durations beyond the last bucket are
+ * counted in the last bucket, while min, max and the average are always exact.
+ *
+ * When a bucket would overflow, every bucket is halved so the histogram keeps its shape and
+ * favours recent samples. Storage is supplied by the caller; use SectionStatsBuffer<N> for a
+ * self-contained instance.
+ *
+ * Example usage:
+ *   SectionStatsBuffer<PROFILER_BUCKETS_FOR_BITS(16)> stats;
+ *   uint32_t i_start = micros();
+ *   checkSwitches();
+ *   stats.record(micros() - i_start);
+ */
+class SectionStats {
+public:
+  // Constructor, using caller-provided histogram storage with the given number of buckets.
+  SectionStats(uint16_t* buckets, uint8_t bucketCount);
+
+  // Adds one duration in ticks.
+  void record(uint32_t ticks);
+
+  // Clears all samples.
+  void reset();
+
+  uint32_t getCount() const;
+  uint32_t getMin() const;
+  uint32_t getMax() const;
+  uint32_t getAverage() const;
+
+  // Upper bound in ticks of the bucket which holds the given percentile (1-100), capped at the maximum.
+  uint32_t getPercentile(uint8_t percent) const;
+
+  // Returns every statistic divided by ticksPerUnit (e.g. the CPU frequency in MHz for microseconds).
+  SectionSummary summarise(uint32_t ticksPerUnit) const;
+
+  uint8_t getBucketCount() const;
+  uint16_t getBucket(uint8_t index) const;
+
+  // Mapping between durations and histogram buckets.
+  static uint8_t bucketFor(uint32_t ticks);
+  static uint32_t bucketUpperBound(uint8_t index);
+
+private:
+  uint16_t* buckets;
+  uint8_t bucketCount;
+  uint32_t count;
+  uint32_t min;
+  uint32_t max;
+  uint64_t total;
+};
+
+/**
+ * Class: SectionStatsBuffer
+ * Purpose: A SectionStats which carries its own histogram of N buckets.
+ */
+template <uint8_t N>
+class SectionStatsBuffer : public SectionStats {
+public:
+  SectionStatsBuffer() : SectionStats(bucketStore, N) {}
+
+private:
+  uint16_t bucketStore[N];
+};
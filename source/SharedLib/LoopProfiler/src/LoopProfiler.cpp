@@ -0,0 +1,180 @@
+/**
+ *   LoopProfiler - Per-section loop timing with latency histograms for GPStar devices.
+ *   Accumulates min, average, maximum and percentile timings for sections of the main loop.
+ *   Copyright (C) 2023-2026 Michael Rajotte, Dustin Grau, Nomake Wan
+ *
+ *   This program is free software; you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation; either version 3 of the License, or
+ *   (at your option) any later version.
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License
+ *   along with this program; if not, see <https://www.gnu.org/licenses/>.
+ *
+ */
+
+// Library Header
+#include "LoopProfiler.h"
+
+// Standard library includes
+#include <limits.h> // Provides UINT_MAX.
+
+// Values below this each have their own bucket (two sub-bucket octaves' worth).
+#define PROFILER_LINEAR_LIMIT (PROFILER_SUB_BUCKETS * 2)
+
+// Position of the highest set bit of a non-zero value.
+static uint8_t highestBit(uint32_t value) {
+#if UINT_MAX == 0xFFFFFFFFUL
+  return 31 - __builtin_clz(value);
+#else
+  return 31 - __builtin_clzl(value); // AVR, where int is 16 bits.
+#endif
+}
+
+SectionStats::SectionStats(uint16_t* buckets, uint8_t bucketCount)
+  : buckets(buckets), bucketCount(bucketCount) {
+  reset();
+}
+
+uint8_t SectionStats::bucketFor(uint32_t ticks) {
+  if(ticks < PROFILER_LINEAR_LIMIT) {
+    return ticks;
+  }
+
+  // Two bits below the leading bit select one of the four sub-buckets of that power of two.
+  uint8_t msb = highestBit(ticks);
+
+  return (msb - 1) * PROFILER_SUB_BUCKETS + ((ticks >> (msb - 2)) & (PROFILER_SUB_BUCKETS - 1));
+}
+
+uint32_t SectionStats::bucketUpperBound(uint8_t index) {
+  if(index < PROFILER_LINEAR_LIMIT) {
+    return index;
+  }
+
+  uint8_t msb = index / PROFILER_SUB_BUCKETS + 1;
+  uint8_t sub = index % PROFILER_SUB_BUCKETS;
+
+  if(msb >= 32) {
+    return 0xFFFFFFFFUL;
+  }
+
+  uint32_t width = 1UL << (msb - 2);
+
+  return (1UL << msb) + (sub + 1) * width - 1;
+}
+
+void SectionStats::record(uint32_t ticks) {
+  uint8_t index = bucketFor(ticks);
+
+  if(index >= bucketCount) {
+    index = bucketCount - 1;
+  }
+
+  if(buckets[index] == 0xFFFF) {
+    // Halve the whole histogram rather than saturating, which keeps the percentiles meaningful.
+    for(uint8_t i = 0; i < bucketCount; i++) {
+      buckets[i] >>= 1;
+    }
+  }
+
+  buckets[index]++;
+
+  if(count == 0 || ticks < min) {
+    min = ticks;
+  }
+
+  if(ticks > max) {
+    max = ticks;
+  }
+
+  if(count < 0xFFFFFFFFUL) {
+    count++;
+    total += ticks;
+  }
+}
+
+void SectionStats::reset() {
+  for(uint8_t i = 0; i < bucketCount; i++) {
+    buckets[i] = 0;
+  }
+
+  count = 0;
+  min = 0;
+  max = 0;
+  total = 0;
+}
+
+uint32_t SectionStats::getCount() const {
+  return count;
+}
+
+uint32_t SectionStats::getMin() const {
+  return min;
+}
+
+uint32_t SectionStats::getMax() const {
+  return max;
+}
+
+uint32_t SectionStats::getAverage() const {
+  return count > 0 ? (uint32_t)(total / count) : 0;
+}
+
+uint32_t SectionStats::getPercentile(uint8_t percent) const {
+  uint32_t histogramTotal = 0;
+
+  for(uint8_t i = 0; i < bucketCount; i++) {
+    histogramTotal += buckets[i];
+  }
+
+  if(histogramTotal == 0) {
+    return 0;
+  }
+
+  // Smallest number of samples which must fall at or below the percentile, rounded up.
+  uint32_t target = (histogramTotal * percent + 99) / 100;
+  uint32_t cumulative = 0;
+
+  for(uint8_t i = 0; i < bucketCount; i++) {
+    cumulative += buckets[i];
+
+    if(cumulative >= target) {
+      // The last bucket also holds anything beyond its range, so the maximum is the better bound.
+      uint32_t bound = (i == bucketCount - 1) ? max : bucketUpperBound(i);
+
+      return bound < max ? bound : max;
+    }
+  }
+
+  return max;
+}
+
+SectionSummary SectionStats::summarise(uint32_t ticksPerUnit) const {
+  SectionSummary summary;
+
+  if(ticksPerUnit == 0) {
+    ticksPerUnit = 1;
+  }
+
+  summary.count = count;
+  summary.min = min / ticksPerUnit;
+  summary.avg = getAverage() / ticksPerUnit;
+  summary.max = max / ticksPerUnit;
+  summary.p99 = getPercentile(99) / ticksPerUnit;
+
+  return summary;
+}
+
+uint8_t SectionStats::getBucketCount() const {
+  return bucketCount;
+}
+
+uint16_t SectionStats::getBucket(uint8_t index) const {
+  return index < bucketCount ? buckets[index] : 0;
+}
@@ -0,0 +1,132 @@
+/**
+ * Test suite for the per-section loop profiler.
+ */
+
+#include <gtest/gtest.h>
+#include "LoopProfiler.h"
+#include <chrono>
+#include <stdio.h>
+
+// Test fixture with a histogram covering durations up to 2^16 ticks.
+class LoopProfilerFixture : public ::testing::Test {
+protected:
+    SectionStatsBuffer<PROFILER_BUCKETS_FOR_BITS(16)> stats;
+};
+
+TEST_F(LoopProfilerFixture, CanInstantiate) {
+    EXPECT_EQ(stats.getBucketCount(), 60);
+    EXPECT_EQ(stats.getCount(), 0u);
+    EXPECT_EQ(stats.getAverage(), 0u);
+    EXPECT_EQ(stats.getPercentile(99), 0u);
+}
+
+// Every duration lands in a bucket whose bounds contain it, and buckets never go backwards.
+TEST(LoopProfilerBuckets, BoundsContainValues) {
+    uint8_t last = 0;
+
+    for(uint32_t ticks = 0; ticks < 100000; ticks++) {
+        uint8_t index = SectionStats::bucketFor(ticks);
+        EXPECT_GE(index, last);
+        EXPECT_LE(ticks, SectionStats::bucketUpperBound(index));
+        if(index > 0) {
+            EXPECT_GT(ticks, SectionStats::bucketUpperBound(index - 1));
+        }
+        last = index;
+    }
+
+    EXPECT_EQ(SectionStats::bucketFor(0xFFFFFFFFUL), PROFILER_BUCKETS_FOR_BITS(32) - 1);
+    EXPECT_EQ(SectionStats::bucketUpperBound(PROFILER_BUCKETS_FOR_BITS(32) - 1), 0xFFFFFFFFUL);
+}
+
+// Small values are exact and larger values are resolved to within a quarter of their size.
+TEST(LoopProfilerBuckets, ResolutionIsLogLinear) {
+    EXPECT_EQ(SectionStats::bucketUpperBound(SectionStats::bucketFor(5)), 5u);
+    EXPECT_EQ(SectionStats::bucketUpperBound(SectionStats::bucketFor(1000)), 1023u);
+    EXPECT_EQ(SectionStats::bucketUpperBound(SectionStats::bucketFor(1024)), 1279u);
+}
+
+// Minimum, maximum and average are exact.
+TEST_F(LoopProfilerFixture, TracksExactExtremes) {
+    stats.record(120);
+    stats.record(80);
+    stats.record(400);
+    stats.record(200);
+
+    EXPECT_EQ(stats.getCount(), 4u);
+    EXPECT_EQ(stats.getMin(), 80u);
+    EXPECT_EQ(stats.getMax(), 400u);
+    EXPECT_EQ(stats.getAverage(), 200u);
+}
+
+// A rare slow run shows in the tail percentile but not the median.
+TEST_F(LoopProfilerFixture, PercentileFindsTail) {
+    for(uint16_t i = 0; i < 980; i++) {
+        stats.record(100);
+    }
+    for(uint16_t i = 0; i < 20; i++) {
+        stats.record(5000);
+    }
+
+    EXPECT_EQ(stats.getPercentile(50), 111u); // Upper bound of the 96-111 bucket.
+    EXPECT_EQ(stats.getPercentile(98), 111u);
+    EXPECT_EQ(stats.getPercentile(99), 5000u); // Bucket bound of 5119, capped at the maximum.
+}
+
+// Durations past the last bucket are clamped, with the maximum used as their bound.
+TEST(LoopProfilerLimits, ClampsLongDurations) {
+    SectionStatsBuffer<PROFILER_BUCKETS_FOR_BITS(8)> stats;
+
+    stats.record(10);
+    stats.record(100000);
+
+    EXPECT_EQ(stats.getBucket(stats.getBucketCount() - 1), 1);
+    EXPECT_EQ(stats.getPercentile(99), 100000u);
+    EXPECT_EQ(stats.getMax(), 100000u);
+}
+
+// A full bucket halves the histogram instead of wrapping, keeping the distribution's shape.
+TEST_F(LoopProfilerFixture, HalvesOnOverflow) {
+    for(uint32_t i = 0; i < 70000; i++) {
+        stats.record(i % 10 == 0 ? 1000 : 10);
+    }
+
+    EXPECT_EQ(stats.getCount(), 70000u);
+    EXPECT_GT(stats.getBucket(SectionStats::bucketFor(10)), stats.getBucket(SectionStats::bucketFor(1000)));
+    EXPECT_EQ(stats.getPercentile(50), SectionStats::bucketUpperBound(SectionStats::bucketFor(10)));
+    EXPECT_EQ(stats.getPercentile(99), 1000u);
+}
+
+// Summaries convert ticks to the caller's units.
+TEST_F(LoopProfilerFixture, SummaryScalesTicks) {
+    stats.record(2400);
+    stats.record(4800);
+
+    SectionSummary summary = stats.summarise(240);
+    EXPECT_EQ(summary.count, 2u);
+    EXPECT_EQ(summary.min, 10u);
+    EXPECT_EQ(summary.avg, 15u);
+    EXPECT_EQ(summary.max, 20u);
+    EXPECT_EQ(summary.p99, 20u);
+
+    stats.reset();
+    EXPECT_EQ(stats.getCount(), 0u);
+    EXPECT_EQ(stats.summarise(0).max, 0u);
+}
+
+// Measures the cost of a single record() call. Printed for reference only, as it depends on the host.
+TEST(LoopProfilerBenchmark, RecordCost) {
+    SectionStatsBuffer<PROFILER_BUCKETS_FOR_BITS(24)> stats;
+    const uint32_t samples = 1000000;
+    uint32_t seed = 12345;
+
+    auto begin = std::chrono::steady_clock::now();
+    for(uint32_t i = 0; i < samples; i++) {
+        seed = seed * 1103515245UL + 12345UL;
+        stats.record((seed >> 12) & 0xFFFFF);
+    }
+    auto elapsed = std::chrono::steady_clock::now() - begin;
+
+    printf("[          ] record(): %.1f ns/sample\n", std::chrono::duration<double, std::nano>(elapsed).count() / samples);
+
+    EXPECT_EQ(stats.getCount(), samples);
+}
@@ -0,0 +1,120 @@
+/**
+ *   MenuTree - Menu trees for GPStar devices.
+ *   Walks menus defined as node tables in PROGMEM with a single interpreter.
+ *   Copyright (C) 2023-2026 Michael Rajotte, Dustin Grau, Nomake Wan
+ *
+ *   This program is free software; you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation; either version 3 of the License, or
+ *   (at your option) any later version.
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License
+ *   along with this program; if not, see <https://www.gnu.org/licenses/>.
+ *
+ */
+
+#pragma once
+
+// Standard library includes for integer type definitions
+#include <stdint.h>  // Provides uint8_t, uint16_t, etc.
+#include <stdbool.h> // Provides bool type definition.
+
+// Each menu has up to 5 levels (0-4) of 5 items (1-5), shown on the bargraph from the bottom up.
+#define MENU_TREE_LEVELS 5
+#define MENU_TREE_ITEMS 5
+
+/*
+ * Guard conditions, one bit each. The device passes the conditions which currently hold,
+ * and a node is only used when all of the conditions in its guard hold.
+ */
+#define MENU_GUARD_NONE            0x0000
+#define MENU_GUARD_INTENSIFY_ON    0x0001
+#define MENU_GUARD_INTENSIFY_OFF   0x0002
+#define MENU_GUARD_INTENSIFY_LONG  0x0004
+#define MENU_GUARD_MODE_ON         0x0008
+#define MENU_GUARD_MODE_OFF        0x0010
+#define MENU_GUARD_MODE_LONG       0x0020
+#define MENU_GUARD_MUSIC_PLAYING   0x0040 // Music is playing and not paused.
+#define MENU_GUARD_WAND_VOLUME     0x0080 // Startup volume is adjusted on the Neutrona Wand.
+#define MENU_GUARD_PACK_VOLUME     0x0100 // Startup volume is adjusted on the Proton Pack.
+#define MENU_GUARD_LEVELS_UNLOCKED 0x0200 // The Proton Pack is off, so menu levels may change.
+
+/*
+ * Indicator lights for the menu level, one bit each.
+ */
+#define MENU_LIGHT_SLO_BLO  0x01 // Level 2
+#define MENU_LIGHT_VENT     0x02 // Level 3
+#define MENU_LIGHT_TOP      0x04 // Level 4
+#define MENU_LIGHT_CLIPPARD 0x08 // Level 5
+
+enum MENU_TREE_INPUTS : uint8_t {
+  MENU_INPUT_DIAL_CCW,
+  MENU_INPUT_DIAL_CW
+};
+
+// Actions are carried out by the device. The value of a node is the command to send afterwards, or a power level.
+enum MENU_TREE_ACTIONS : uint8_t {
+  MENU_ACTION_NONE,
+  MENU_ACTION_SEND,
+  MENU_ACTION_VOLUME_EFFECTS_DOWN,
+  MENU_ACTION_VOLUME_EFFECTS_UP,
+  MENU_ACTION_VOLUME_MUSIC_DOWN,
+  MENU_ACTION_VOLUME_MUSIC_UP,
+  MENU_ACTION_VOLUME_EEPROM_DOWN,
+  MENU_ACTION_VOLUME_EEPROM_UP,
+  MENU_ACTION_OVERHEAT_TIMER_DOWN,
+  MENU_ACTION_OVERHEAT_TIMER_UP,
+  MENU_ACTION_SPECTRAL_WAND_DOWN,
+  MENU_ACTION_SPECTRAL_WAND_UP
+};
+
+// An input on one item of one menu level.
+struct MenuTreeNode {
+  uint8_t level;  // 0-4
+  uint8_t item;   // 1-5
+  uint8_t input;  // MENU_TREE_INPUTS
+  uint8_t action; // MENU_TREE_ACTIONS
+  uint16_t guard; // MENU_GUARD_* conditions which must all hold.
+  uint8_t value;  // Command to send, or power level.
+};
+
+// A menu: its nodes, how deep it goes and the lights shown on each level.
+struct MenuTreeMenu {
+  const MenuTreeNode* nodes;
+  uint8_t count;
+  uint8_t deepest;                      // Deepest level, 0-4.
+  uint16_t levelGuard;                  // Conditions for changing level.
+  uint8_t lights[MENU_TREE_LEVELS];     // MENU_LIGHT_* lit on each level.
+  bool writeAllLights;                  // Write every light on a level change, rather than only those which change.
+};
+
+// Result of an input.
+struct MenuTreeStep {
+  uint8_t action;     // MENU_TREE_ACTIONS, or MENU_ACTION_NONE when the input moved through the menu.
+  uint8_t value;
+  bool levelChanged;
+  uint8_t lights;     // MENU_LIGHT_* lit on the new level.
+  uint8_t lightsMask; // MENU_LIGHT_* to write.
+};
+
+/**
+ * Applies a dial input to a menu in PROGMEM. The first node for the current level, item and input
+ * whose guard holds gives the action. Without one, the dial moves through the items: past item 1
+ * to the next level down at item 5, and past item 5 to the next level up at item 1.
+ */
+MenuTreeStep menuTreeDial(const MenuTreeMenu* menu, uint8_t input, uint16_t state, uint8_t& level, uint8_t& item);
+
+// Bargraph segments lit to show a menu item (1-5), on the 28 or 30 segment bargraph.
+uint32_t menuTreeBargraphItem(uint8_t item, uint8_t segments);
+
+/*
+ * Menus of the Neutrona Wand.
+ */
+extern const MenuTreeMenu WAND_MENU_SETTINGS;
+extern const MenuTreeMenu WAND_MENU_CONFIG_EEPROM;
+extern const MenuTreeMenu WAND_MENU_LED_EEPROM;
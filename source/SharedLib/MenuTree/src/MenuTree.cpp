@@ -0,0 +1,217 @@
+/**
+ *   MenuTree - Menu trees for GPStar devices.
+ *   Walks menus defined as node tables in PROGMEM with a single interpreter.
+ *   Copyright (C) 2023-2026 Michael Rajotte, Dustin Grau, Nomake Wan
+ *
+ *   This program is free software; you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation; either version 3 of the License, or
+ *   (at your option) any later version.
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License
+ *   along with this program; if not, see <https://www.gnu.org/licenses/>.
+ *
+ */
+
+// Library Header
+#include "MenuTree.h"
+
+// Serial commands sent by the menus.
+#include <Communication.h>
+
+#include <string.h>
+
+#if defined(ARDUINO)
+  #include <Arduino.h>
+#else
+  #define PROGMEM
+  #define pgm_read_dword(address) (*(const uint32_t*)(address))
+  #define memcpy_P memcpy
+#endif
+
+#define MENU_GUARD_DIAL_INTENSIFY (MENU_GUARD_INTENSIFY_ON | MENU_GUARD_MODE_OFF)
+#define MENU_GUARD_DIAL_MODE (MENU_GUARD_INTENSIFY_OFF | MENU_GUARD_MODE_ON)
+
+/*
+ * Settings menu.
+ * Level 1 Item 4: Intensify + dial: Dim the selected Proton Pack lighting.
+ * Level 1 Item 3: Intensify + dial: Sound effects volume. Barrel Wing Button + dial: Music volume while playing.
+ */
+static const MenuTreeNode WAND_MENU_SETTINGS_NODES[] PROGMEM = {
+  {0, 4, MENU_INPUT_DIAL_CCW, MENU_ACTION_SEND, MENU_GUARD_DIAL_INTENSIFY, W_DIMMING_DECREASE},
+  {0, 3, MENU_INPUT_DIAL_CCW, MENU_ACTION_VOLUME_EFFECTS_DOWN, MENU_GUARD_DIAL_INTENSIFY, W_VOLUME_SOUND_EFFECTS_DECREASE},
+  {0, 3, MENU_INPUT_DIAL_CCW, MENU_ACTION_VOLUME_MUSIC_DOWN, MENU_GUARD_DIAL_MODE | MENU_GUARD_MUSIC_PLAYING, W_VOLUME_MUSIC_DECREASE},
+
+  {0, 4, MENU_INPUT_DIAL_CW, MENU_ACTION_SEND, MENU_GUARD_DIAL_INTENSIFY, W_DIMMING_INCREASE},
+  {0, 3, MENU_INPUT_DIAL_CW, MENU_ACTION_VOLUME_EFFECTS_UP, MENU_GUARD_DIAL_INTENSIFY, W_VOLUME_SOUND_EFFECTS_INCREASE},
+  {0, 3, MENU_INPUT_DIAL_CW, MENU_ACTION_VOLUME_MUSIC_UP, MENU_GUARD_DIAL_MODE | MENU_GUARD_MUSIC_PLAYING, W_VOLUME_MUSIC_INCREASE}
+};
+
+/*
+ * Neutrona Wand configuration EEPROM menu.
+ * Level 3 Item 5: Intensify held + dial: Default startup volume of the Neutrona Wand or Proton Pack.
+ * Level 4 Items 1-5: Intensify + dial: Overheat smoke duration for power levels 1-5 (Proton Pack).
+ * Level 4 Items 1-5: Barrel Wing Button + dial: Overheat start timer for power levels 1-5.
+ */
+static const MenuTreeNode WAND_MENU_CONFIG_EEPROM_NODES[] PROGMEM = {
+  {2, 5, MENU_INPUT_DIAL_CCW, MENU_ACTION_VOLUME_EEPROM_DOWN, MENU_GUARD_INTENSIFY_LONG | MENU_GUARD_MODE_OFF | MENU_GUARD_WAND_VOLUME, 0},
+  {2, 5, MENU_INPUT_DIAL_CCW, MENU_ACTION_SEND, MENU_GUARD_INTENSIFY_LONG | MENU_GUARD_MODE_OFF | MENU_GUARD_PACK_VOLUME, W_VOLUME_DECREASE_EEPROM},
+  {3, 5, MENU_INPUT_DIAL_CCW, MENU_ACTION_SEND, MENU_GUARD_DIAL_INTENSIFY, W_OVERHEAT_DECREASE_LEVEL_5},
+  {3, 4, MENU_INPUT_DIAL_CCW, MENU_ACTION_SEND, MENU_GUARD_DIAL_INTENSIFY, W_OVERHEAT_DECREASE_LEVEL_4},
+  {3, 3, MENU_INPUT_DIAL_CCW, MENU_ACTION_SEND, MENU_GUARD_DIAL_INTENSIFY, W_OVERHEAT_DECREASE_LEVEL_3},
+  {3, 2, MENU_INPUT_DIAL_CCW, MENU_ACTION_SEND, MENU_GUARD_DIAL_INTENSIFY, W_OVERHEAT_DECREASE_LEVEL_2},
+  {3, 1, MENU_INPUT_DIAL_CCW, MENU_ACTION_SEND, MENU_GUARD_DIAL_INTENSIFY, W_OVERHEAT_DECREASE_LEVEL_1},
+  {3, 5, MENU_INPUT_DIAL_CCW, MENU_ACTION_OVERHEAT_TIMER_DOWN, MENU_GUARD_DIAL_MODE, 5},
+  {3, 4, MENU_INPUT_DIAL_CCW, MENU_ACTION_OVERHEAT_TIMER_DOWN, MENU_GUARD_DIAL_MODE, 4},
+  {3, 3, MENU_INPUT_DIAL_CCW, MENU_ACTION_OVERHEAT_TIMER_DOWN, MENU_GUARD_DIAL_MODE, 3},
+  {3, 2, MENU_INPUT_DIAL_CCW, MENU_ACTION_OVERHEAT_TIMER_DOWN, MENU_GUARD_DIAL_MODE, 2},
+  {3, 1, MENU_INPUT_DIAL_CCW, MENU_ACTION_OVERHEAT_TIMER_DOWN, MENU_GUARD_DIAL_MODE, 1},
+
+  {2, 5, MENU_INPUT_DIAL_CW, MENU_ACTION_VOLUME_EEPROM_UP, MENU_GUARD_INTENSIFY_LONG | MENU_GUARD_MODE_OFF | MENU_GUARD_WAND_VOLUME, 0},
+  {2, 5, MENU_INPUT_DIAL_CW, MENU_ACTION_SEND, MENU_GUARD_INTENSIFY_LONG | MENU_GUARD_MODE_OFF | MENU_GUARD_PACK_VOLUME, W_VOLUME_INCREASE_EEPROM},
+  {3, 5, MENU_INPUT_DIAL_CW, MENU_ACTION_SEND, MENU_GUARD_DIAL_INTENSIFY, W_OVERHEAT_INCREASE_LEVEL_5},
+  {3, 4, MENU_INPUT_DIAL_CW, MENU_ACTION_SEND, MENU_GUARD_DIAL_INTENSIFY, W_OVERHEAT_INCREASE_LEVEL_4},
+  {3, 3, MENU_INPUT_DIAL_CW, MENU_ACTION_SEND, MENU_GUARD_DIAL_INTENSIFY, W_OVERHEAT_INCREASE_LEVEL_3},
+  {3, 2, MENU_INPUT_DIAL_CW, MENU_ACTION_SEND, MENU_GUARD_DIAL_INTENSIFY, W_OVERHEAT_INCREASE_LEVEL_2},
+  {3, 1, MENU_INPUT_DIAL_CW, MENU_ACTION_SEND, MENU_GUARD_DIAL_INTENSIFY, W_OVERHEAT_INCREASE_LEVEL_1},
+  {3, 5, MENU_INPUT_DIAL_CW, MENU_ACTION_OVERHEAT_TIMER_UP, MENU_GUARD_DIAL_MODE, 5},
+  {3, 4, MENU_INPUT_DIAL_CW, MENU_ACTION_OVERHEAT_TIMER_UP, MENU_GUARD_DIAL_MODE, 4},
+  {3, 3, MENU_INPUT_DIAL_CW, MENU_ACTION_OVERHEAT_TIMER_UP, MENU_GUARD_DIAL_MODE, 3},
+  {3, 2, MENU_INPUT_DIAL_CW, MENU_ACTION_OVERHEAT_TIMER_UP, MENU_GUARD_DIAL_MODE, 2},
+  {3, 1, MENU_INPUT_DIAL_CW, MENU_ACTION_OVERHEAT_TIMER_UP, MENU_GUARD_DIAL_MODE, 1}
+};
+
+/*
+ * LED configuration EEPROM menu.
+ * Level 1 Items 1-4: Barrel Wing Button + dial: Spectral custom colour of the Inner Cyclotron, Cyclotron, Power Cell and wand barrel.
+ * Level 2 Item 5: Barrel Wing Button held + dial: Default LED dimming for the whole system.
+ */
+static const MenuTreeNode WAND_MENU_LED_EEPROM_NODES[] PROGMEM = {
+  {0, 4, MENU_INPUT_DIAL_CCW, MENU_ACTION_SPECTRAL_WAND_DOWN, MENU_GUARD_DIAL_MODE, 0},
+  {0, 3, MENU_INPUT_DIAL_CCW, MENU_ACTION_SEND, MENU_GUARD_DIAL_MODE, W_SPECTRAL_POWERCELL_CUSTOM_DECREASE},
+  {0, 2, MENU_INPUT_DIAL_CCW, MENU_ACTION_SEND, MENU_GUARD_DIAL_MODE, W_SPECTRAL_CYCLOTRON_CUSTOM_DECREASE},
+  {0, 1, MENU_INPUT_DIAL_CCW, MENU_ACTION_SEND, MENU_GUARD_DIAL_MODE, W_SPECTRAL_INNER_CYCLOTRON_CUSTOM_DECREASE},
+  {1, 5, MENU_INPUT_DIAL_CCW, MENU_ACTION_SEND, MENU_GUARD_INTENSIFY_OFF | MENU_GUARD_MODE_LONG, W_DIMMING_DECREASE},
+
+  {0, 4, MENU_INPUT_DIAL_CW, MENU_ACTION_SPECTRAL_WAND_UP, MENU_GUARD_DIAL_MODE, 0},
+  {0, 3, MENU_INPUT_DIAL_CW, MENU_ACTION_SEND, MENU_GUARD_DIAL_MODE, W_SPECTRAL_POWERCELL_CUSTOM_INCREASE},
+  {0, 2, MENU_INPUT_DIAL_CW, MENU_ACTION_SEND, MENU_GUARD_DIAL_MODE, W_SPECTRAL_CYCLOTRON_CUSTOM_INCREASE},
+  {0, 1, MENU_INPUT_DIAL_CW, MENU_ACTION_SEND, MENU_GUARD_DIAL_MODE, W_SPECTRAL_INNER_CYCLOTRON_CUSTOM_INCREASE},
+  {1, 5, MENU_INPUT_DIAL_CW, MENU_ACTION_SEND, MENU_GUARD_INTENSIFY_OFF | MENU_GUARD_MODE_LONG, W_DIMMING_INCREASE}
+};
+
+#define MENU_TREE_NODES(nodes) nodes, sizeof(nodes) / sizeof(MenuTreeNode)
+
+// Levels of the settings menu only change while the Proton Pack is off. Level 3 is only available on the GPStar II controller.
+const MenuTreeMenu WAND_MENU_SETTINGS PROGMEM = {
+  MENU_TREE_NODES(WAND_MENU_SETTINGS_NODES),
+#if defined(ESP32)
+  2,
+#else
+  1,
+#endif
+  MENU_GUARD_LEVELS_UNLOCKED,
+  {0, MENU_LIGHT_SLO_BLO, MENU_LIGHT_SLO_BLO | MENU_LIGHT_VENT, 0, 0},
+  false
+};
+
+const MenuTreeMenu WAND_MENU_CONFIG_EEPROM PROGMEM = {
+  MENU_TREE_NODES(WAND_MENU_CONFIG_EEPROM_NODES),
+  4,
+  MENU_GUARD_NONE,
+  {0, MENU_LIGHT_SLO_BLO, MENU_LIGHT_SLO_BLO | MENU_LIGHT_VENT, MENU_LIGHT_SLO_BLO | MENU_LIGHT_VENT | MENU_LIGHT_TOP,
+   MENU_LIGHT_SLO_BLO | MENU_LIGHT_VENT | MENU_LIGHT_TOP | MENU_LIGHT_CLIPPARD},
+  true
+};
+
+const MenuTreeMenu WAND_MENU_LED_EEPROM PROGMEM = {
+  MENU_TREE_NODES(WAND_MENU_LED_EEPROM_NODES),
+  2,
+  MENU_GUARD_NONE,
+  {0, MENU_LIGHT_SLO_BLO, MENU_LIGHT_SLO_BLO | MENU_LIGHT_VENT, 0, 0},
+  true
+};
+
+/*
+ * Bargraph segments for menu items 1-5. Each item adds a group of segments, with a gap between groups.
+ */
+static const uint32_t MENU_BARGRAPH_ITEMS_28[MENU_TREE_ITEMS] PROGMEM = {
+  0x0000000E, 0x0000038E, 0x0000E38E, 0x0038E38E, 0x0E38E38E
+};
+
+static const uint32_t MENU_BARGRAPH_ITEMS_30[MENU_TREE_ITEMS] PROGMEM = {
+  0x0000001E, 0x0000079E, 0x0001E79E, 0x0079E79E, 0x1E79E79E
+};
+
+MenuTreeStep menuTreeDial(const MenuTreeMenu* menu, uint8_t input, uint16_t state, uint8_t& level, uint8_t& item) {
+  MenuTreeMenu tree;
+  memcpy_P(&tree, menu, sizeof(MenuTreeMenu));
+
+  MenuTreeStep step = {MENU_ACTION_NONE, 0, false, 0, 0};
+
+  for(uint8_t i = 0; i < tree.count; i++) {
+    MenuTreeNode node;
+    memcpy_P(&node, &tree.nodes[i], sizeof(MenuTreeNode));
+
+    if(node.level == level && node.item == item && node.input == input && (node.guard & ~state) == 0) {
+      step.action = node.action;
+      step.value = node.value;
+      return step;
+    }
+  }
+
+  bool b_unlocked = (tree.levelGuard & ~state) == 0;
+  uint8_t i_level = level;
+
+  if(input == MENU_INPUT_DIAL_CCW) {
+    if(item > 1) {
+      item--;
+    }
+    else if(b_unlocked && level < tree.deepest) {
+      // Go down a level.
+      level++;
+      item = MENU_TREE_ITEMS;
+    }
+    else {
+      // Nothing deeper.
+      item = 1;
+    }
+  }
+  else {
+    if(item < MENU_TREE_ITEMS) {
+      item++;
+    }
+    else if(b_unlocked && level > 0) {
+      // Go up a level.
+      level--;
+      item = 1;
+    }
+    else {
+      // Nothing above level 1.
+      item = MENU_TREE_ITEMS;
+    }
+  }
+
+  if(level != i_level) {
+    uint8_t i_lights_old = i_level < MENU_TREE_LEVELS ? tree.lights[i_level] : 0;
+
+    step.levelChanged = true;
+    step.lights = tree.lights[level];
+    step.lightsMask = tree.writeAllLights ? (MENU_LIGHT_SLO_BLO | MENU_LIGHT_VENT | MENU_LIGHT_TOP | MENU_LIGHT_CLIPPARD) : (step.lights ^ i_lights_old);
+  }
+
+  return step;
+}
+
+uint32_t menuTreeBargraphItem(uint8_t item, uint8_t segments) {
+  if(item < 1 || item > MENU_TREE_ITEMS) {
+    return 0;
+  }
+
+  return pgm_read_dword(segments == 30 ? &MENU_BARGRAPH_ITEMS_30[item - 1] : &MENU_BARGRAPH_ITEMS_28[item - 1]);
+}
@@ -0,0 +1,774 @@
+#include <gtest/gtest.h>
+#include <stdio.h>
+#include <string>
+#include <vector>
+#include <chrono>
+#include <Communication.h>
+#include "MenuTree.h"
+
+enum REF_MENU_LEVELS { MENU_LEVEL_1, MENU_LEVEL_2, MENU_LEVEL_3, MENU_LEVEL_4, MENU_LEVEL_5 };
+
+// Switch and system state seen by the Neutrona Wand dial handler.
+struct DialInputs {
+  bool intensify_on;
+  bool intensify_long;
+  bool mode_on;
+  bool mode_long;
+  bool playing_music;
+  bool music_paused;
+  bool wand_standalone;
+  bool volume_wand; // VOLUME_ADJUST_DEVICE == VOLUME_NEUTRONA_WAND
+  bool pack_on;
+  bool pack_shutting_down;
+  bool wand_off;    // WAND_STATUS == MODE_OFF
+};
+
+#define DIAL_INPUT_COUNT 11
+
+static DialInputs inputsFor(uint16_t bits) {
+  DialInputs in;
+  bool* b_fields[DIAL_INPUT_COUNT] = {&in.intensify_on, &in.intensify_long, &in.mode_on, &in.mode_long, &in.playing_music,
+                                      &in.music_paused, &in.wand_standalone, &in.volume_wand, &in.pack_on, &in.pack_shutting_down, &in.wand_off};
+
+  for(uint8_t i = 0; i < DIAL_INPUT_COUNT; i++) {
+    *b_fields[i] = (bits >> i) & 0x01;
+  }
+
+  return in;
+}
+
+// Everything the handler does: commands and local actions in order, the indicator lights written and where the menu ends up.
+struct DialLog {
+  std::vector<std::string> events;
+  int lights[4] = {-1, -1, -1, -1}; // Slo-blo, vent, top, clippard: -1 when not written.
+  uint8_t level = 0;
+  uint8_t item = 5;
+
+  void send(uint8_t command) { events.push_back("send " + std::to_string(command)); }
+  void call(const char* name) { events.push_back(name); }
+  void call(const char* name, int value) { events.push_back(std::string(name) + " " + std::to_string(value)); }
+};
+
+/*
+ * Reference: the dial handling of checkRotaryEncoder() for the three wand menus, as it was written
+ * before the menu tree. The beeps, level voices and W_MENU_LEVEL_* command on a level change are
+ * the same block everywhere and are logged as a single "level" event.
+ */
+static void refLevelChange(DialLog& log, uint8_t level) {
+  log.call("level", level + 1);
+}
+
+static void refLights(DialLog& log, int slo, int vent, int top, int clippard) {
+  if(slo >= 0) log.lights[0] = slo;
+  if(vent >= 0) log.lights[1] = vent;
+  if(top >= 0) log.lights[2] = top;
+  if(clippard >= 0) log.lights[3] = clippard;
+}
+
+static void refConfigEEPROM(uint8_t prev_next_code, const DialInputs& in, DialLog& log) {
+  uint8_t& i_wand_menu = log.item;
+  uint8_t& WAND_MENU_LEVEL = log.level;
+
+  // Counter clockwise.
+  if(prev_next_code == 0x0b) {
+    if(WAND_MENU_LEVEL == MENU_LEVEL_3 && i_wand_menu == 5 && in.intensify_long && !in.mode_on) {
+      if(in.wand_standalone || in.volume_wand) {
+        log.call("decreaseVolumeEEPROM");
+      }
+      else {
+        log.send(W_VOLUME_DECREASE_EEPROM);
+      }
+    }
+    else if(WAND_MENU_LEVEL == MENU_LEVEL_4 && i_wand_menu == 5 && in.intensify_on && !in.mode_on) {
+      log.send(W_OVERHEAT_DECREASE_LEVEL_5);
+    }
+    else if(WAND_MENU_LEVEL == MENU_LEVEL_4 && i_wand_menu == 4 && in.intensify_on && !in.mode_on) {
+      log.send(W_OVERHEAT_DECREASE_LEVEL_4);
+    }
+    else if(WAND_MENU_LEVEL == MENU_LEVEL_4 && i_wand_menu == 3 && in.intensify_on && !in.mode_on) {
+      log.send(W_OVERHEAT_DECREASE_LEVEL_3);
+    }
+    else if(WAND_MENU_LEVEL == MENU_LEVEL_4 && i_wand_menu == 2 && in.intensify_on && !in.mode_on) {
+      log.send(W_OVERHEAT_DECREASE_LEVEL_2);
+    }
+    else if(WAND_MENU_LEVEL == MENU_LEVEL_4 && i_wand_menu == 1 && in.intensify_on && !in.mode_on) {
+      log.send(W_OVERHEAT_DECREASE_LEVEL_1);
+    }
+    else if(WAND_MENU_LEVEL == MENU_LEVEL_4 && i_wand_menu == 5 && !in.intensify_on && in.mode_on) {
+      log.call("overheatTimerDecrement", 5);
+    }
+    else if(WAND_MENU_LEVEL == MENU_LEVEL_4 && i_wand_menu == 4 && !in.intensify_on && in.mode_on) {
+      log.call("overheatTimerDecrement", 4);
+    }
+    else if(WAND_MENU_LEVEL == MENU_LEVEL_4 && i_wand_menu == 3 && !in.intensify_on && in.mode_on) {
+      log.call("overheatTimerDecrement", 3);
+    }
+    else if(WAND_MENU_LEVEL == MENU_LEVEL_4 && i_wand_menu == 2 && !in.intensify_on && in.mode_on) {
+      log.call("overheatTimerDecrement", 2);
+    }
+    else if(WAND_MENU_LEVEL == MENU_LEVEL_4 && i_wand_menu == 1 && !in.intensify_on && in.mode_on) {
+      log.call("overheatTimerDecrement", 1);
+    }
+    else if(i_wand_menu - 1 < 1) {
+      switch(WAND_MENU_LEVEL) {
+        case MENU_LEVEL_1:
+          WAND_MENU_LEVEL = MENU_LEVEL_2;
+          i_wand_menu = 5;
+          refLights(log, 1, 0, 0, 0);
+          refLevelChange(log, WAND_MENU_LEVEL);
+        break;
+
+        case MENU_LEVEL_2:
+          WAND_MENU_LEVEL = MENU_LEVEL_3;
+          i_wand_menu = 5;
+          refLights(log, 1, 1, 0, 0);
+          refLevelChange(log, WAND_MENU_LEVEL);
+        break;
+
+        case MENU_LEVEL_3:
+          WAND_MENU_LEVEL = MENU_LEVEL_4;
+          i_wand_menu = 5;
+          refLights(log, 1, 1, 1, 0);
+          refLevelChange(log, WAND_MENU_LEVEL);
+        break;
+
+        case MENU_LEVEL_4:
+          WAND_MENU_LEVEL = MENU_LEVEL_5;
+          i_wand_menu = 5;
+          refLights(log, 1, 1, 1, 1);
+          refLevelChange(log, WAND_MENU_LEVEL);
+        break;
+
+        case MENU_LEVEL_5:
+        default:
+          i_wand_menu = 1;
+        break;
+      }
+    }
+    else {
+      i_wand_menu--;
+    }
+  }
+
+  // Clockwise.
+  if(prev_next_code == 0x07) {
+    if(WAND_MENU_LEVEL == MENU_LEVEL_3 && i_wand_menu == 5 && in.intensify_long && !in.mode_on) {
+      if(in.wand_standalone || in.volume_wand) {
+        log.call("increaseVolumeEEPROM");
+      }
+      else {
+        log.send(W_VOLUME_INCREASE_EEPROM);
+      }
+    }
+    else if(WAND_MENU_LEVEL == MENU_LEVEL_4 && i_wand_menu == 5 && in.intensify_on && !in.mode_on) {
+      log.send(W_OVERHEAT_INCREASE_LEVEL_5);
+    }
+    else if(WAND_MENU_LEVEL == MENU_LEVEL_4 && i_wand_menu == 4 && in.intensify_on && !in.mode_on) {
+      log.send(W_OVERHEAT_INCREASE_LEVEL_4);
+    }
+    else if(WAND_MENU_LEVEL == MENU_LEVEL_4 && i_wand_menu == 3 && in.intensify_on && !in.mode_on) {
+      log.send(W_OVERHEAT_INCREASE_LEVEL_3);
+    }
+    else if(WAND_MENU_LEVEL == MENU_LEVEL_4 && i_wand_menu == 2 && in.intensify_on && !in.mode_on) {
+      log.send(W_OVERHEAT_INCREASE_LEVEL_2);
+    }
+    else if(WAND_MENU_LEVEL == MENU_LEVEL_4 && i_wand_menu == 1 && in.intensify_on && !in.mode_on) {
+      log.send(W_OVERHEAT_INCREASE_LEVEL_1);
+    }
+    else if(WAND_MENU_LEVEL == MENU_LEVEL_4 && i_wand_menu == 5 && !in.intensify_on && in.mode_on) {
+      log.call("overheatTimerIncrement", 5);
+    }
+    else if(WAND_MENU_LEVEL == MENU_LEVEL_4 && i_wand_menu == 4 && !in.intensify_on && in.mode_on) {
+      log.call("overheatTimerIncrement", 4);
+    }
+    else if(WAND_MENU_LEVEL == MENU_LEVEL_4 && i_wand_menu == 3 && !in.intensify_on && in.mode_on) {
+      log.call("overheatTimerIncrement", 3);
+    }
+    else if(WAND_MENU_LEVEL == MENU_LEVEL_4 && i_wand_menu == 2 && !in.intensify_on && in.mode_on) {
+      log.call("overheatTimerIncrement", 2);
+    }
+    else if(WAND_MENU_LEVEL == MENU_LEVEL_4 && i_wand_menu == 1 && !in.intensify_on && in.mode_on) {
+      log.call("overheatTimerIncrement", 1);
+    }
+    else if(i_wand_menu + 1 > 5) {
+      switch(WAND_MENU_LEVEL) {
+        case MENU_LEVEL_5:
+          WAND_MENU_LEVEL = MENU_LEVEL_4;
+          i_wand_menu = 1;
+          refLights(log, 1, 1, 1, 0);
+          refLevelChange(log, WAND_MENU_LEVEL);
+        break;
+
+        case MENU_LEVEL_4:
+          WAND_MENU_LEVEL = MENU_LEVEL_3;
+          i_wand_menu = 1;
+          refLights(log, 1, 1, 0, 0);
+          refLevelChange(log, WAND_MENU_LEVEL);
+        break;
+
+        case MENU_LEVEL_3:
+          WAND_MENU_LEVEL = MENU_LEVEL_2;
+          i_wand_menu = 1;
+          refLights(log, 1, 0, 0, 0);
+          refLevelChange(log, WAND_MENU_LEVEL);
+        break;
+
+        case MENU_LEVEL_2:
+          WAND_MENU_LEVEL = MENU_LEVEL_1;
+          i_wand_menu = 1;
+          refLights(log, 0, 0, 0, 0);
+          refLevelChange(log, WAND_MENU_LEVEL);
+        break;
+
+        case MENU_LEVEL_1:
+        default:
+          i_wand_menu = 5;
+        break;
+      }
+    }
+    else {
+      i_wand_menu++;
+    }
+  }
+}
+
+static void refLEDEEPROM(uint8_t prev_next_code, const DialInputs& in, DialLog& log) {
+  uint8_t& i_wand_menu = log.item;
+  uint8_t& WAND_MENU_LEVEL = log.level;
+
+  // Counter clockwise.
+  if(prev_next_code == 0x0b) {
+    if(WAND_MENU_LEVEL == MENU_LEVEL_1 && i_wand_menu == 4 && !in.intensify_on && in.mode_on) {
+      log.call("spectralWandDecrease");
+    }
+    else if(WAND_MENU_LEVEL == MENU_LEVEL_1 && i_wand_menu == 3 && !in.intensify_on && in.mode_on) {
+      log.send(W_SPECTRAL_POWERCELL_CUSTOM_DECREASE);
+    }
+    else if(WAND_MENU_LEVEL == MENU_LEVEL_1 && i_wand_menu == 2 && !in.intensify_on && in.mode_on) {
+      log.send(W_SPECTRAL_CYCLOTRON_CUSTOM_DECREASE);
+    }
+    else if(WAND_MENU_LEVEL == MENU_LEVEL_1 && i_wand_menu == 1 && !in.intensify_on && in.mode_on) {
+      log.send(W_SPECTRAL_INNER_CYCLOTRON_CUSTOM_DECREASE);
+    }
+    else if(WAND_MENU_LEVEL == MENU_LEVEL_2 && i_wand_menu == 5 && !in.intensify_on && in.mode_long) {
+      log.send(W_DIMMING_DECREASE);
+    }
+    else if(i_wand_menu - 1 < 1) {
+      switch(WAND_MENU_LEVEL) {
+        case MENU_LEVEL_1:
+          WAND_MENU_LEVEL = MENU_LEVEL_2;
+          i_wand_menu = 5;
+          refLights(log, 1, 0, 0, 0);
+          refLevelChange(log, WAND_MENU_LEVEL);
+        break;
+
+        case MENU_LEVEL_2:
+          WAND_MENU_LEVEL = MENU_LEVEL_3;
+          i_wand_menu = 5;
+          refLights(log, 1, 1, 0, 0);
+          refLevelChange(log, WAND_MENU_LEVEL);
+        break;
+
+        case MENU_LEVEL_3:
+        default:
+          i_wand_menu = 1;
+        break;
+      }
+    }
+    else {
+      i_wand_menu--;
+    }
+  }
+
+  // Clockwise.
+  if(prev_next_code == 0x07) {
+    if(WAND_MENU_LEVEL == MENU_LEVEL_1 && i_wand_menu == 4 && !in.intensify_on && in.mode_on) {
+      log.call("spectralWandIncrease");
+    }
+    else if(WAND_MENU_LEVEL == MENU_LEVEL_1 && i_wand_menu == 3 && !in.intensify_on && in.mode_on) {
+      log.send(W_SPECTRAL_POWERCELL_CUSTOM_INCREASE);
+    }
+    else if(WAND_MENU_LEVEL == MENU_LEVEL_1 && i_wand_menu == 2 && !in.intensify_on && in.mode_on) {
+      log.send(W_SPECTRAL_CYCLOTRON_CUSTOM_INCREASE);
+    }
+    else if(WAND_MENU_LEVEL == MENU_LEVEL_1 && i_wand_menu == 1 && !in.intensify_on && in.mode_on) {
+      log.send(W_SPECTRAL_INNER_CYCLOTRON_CUSTOM_INCREASE);
+    }
+    else if(WAND_MENU_LEVEL == MENU_LEVEL_2 && i_wand_menu == 5 && !in.intensify_on && in.mode_long) {
+      log.send(W_DIMMING_INCREASE);
+    }
+    else if(i_wand_menu + 1 > 5) {
+      switch(WAND_MENU_LEVEL) {
+        case MENU_LEVEL_3:
+          WAND_MENU_LEVEL = MENU_LEVEL_2;
+          i_wand_menu = 1;
+          refLights(log, 1, 0, 0, 0);
+          refLevelChange(log, WAND_MENU_LEVEL);
+        break;
+
+        case MENU_LEVEL_2:
+          WAND_MENU_LEVEL = MENU_LEVEL_1;
+          i_wand_menu = 1;
+          refLights(log, 0, 0, 0, 0);
+          refLevelChange(log, WAND_MENU_LEVEL);
+        break;
+
+        case MENU_LEVEL_1:
+        default:
+          i_wand_menu = 5;
+        break;
+      }
+    }
+    else {
+      i_wand_menu++;
+    }
+  }
+}
+
+// The settings menu as built for the GPStar I controller (menu level 3 is ESP32 only).
+static void refSettings(uint8_t prev_next_code, const DialInputs& in, DialLog& log) {
+  uint8_t& i_wand_menu = log.item;
+  uint8_t& WAND_MENU_LEVEL = log.level;
+
+  // Counter clockwise.
+  if(prev_next_code == 0x0b) {
+    if(i_wand_menu == 4 && WAND_MENU_LEVEL == MENU_LEVEL_1 && in.intensify_on && !in.mode_on) {
+      log.send(W_DIMMING_DECREASE);
+    }
+    else if(i_wand_menu == 3 && WAND_MENU_LEVEL == MENU_LEVEL_1 && in.intensify_on && !in.mode_on) {
+      log.call("decreaseVolumeEffects");
+      log.send(W_VOLUME_SOUND_EFFECTS_DECREASE);
+    }
+    else if(i_wand_menu == 3 && WAND_MENU_LEVEL == MENU_LEVEL_1 && !in.intensify_on && in.mode_on && in.playing_music && !in.music_paused) {
+      log.call("decreaseVolumeMusic");
+      log.send(W_VOLUME_MUSIC_DECREASE);
+    }
+    else if(i_wand_menu - 1 < 1) {
+      if((!in.pack_on && !in.pack_shutting_down) || (in.wand_standalone && in.wand_off)) {
+        switch(WAND_MENU_LEVEL) {
+          case MENU_LEVEL_1:
+            WAND_MENU_LEVEL = MENU_LEVEL_2;
+            i_wand_menu = 5;
+            refLights(log, 1, -1, -1, -1);
+            refLevelChange(log, WAND_MENU_LEVEL);
+          break;
+
+          default:
+            i_wand_menu = 1;
+          break;
+        }
+      }
+      else {
+        i_wand_menu = 1;
+      }
+    }
+    else {
+      i_wand_menu--;
+    }
+  }
+
+  // Clockwise.
+  if(prev_next_code == 0x07) {
+    if(i_wand_menu == 4 && WAND_MENU_LEVEL == MENU_LEVEL_1 && in.intensify_on && !in.mode_on) {
+      log.send(W_DIMMING_INCREASE);
+    }
+    else if(i_wand_menu == 3 && WAND_MENU_LEVEL == MENU_LEVEL_1 && in.intensify_on && !in.mode_on) {
+      log.call("increaseVolumeEffects");
+      log.send(W_VOLUME_SOUND_EFFECTS_INCREASE);
+    }
+    else if(i_wand_menu == 3 && WAND_MENU_LEVEL == MENU_LEVEL_1 && !in.intensify_on && in.mode_on && in.playing_music && !in.music_paused) {
+      log.call("increaseVolumeMusic");
+      log.send(W_VOLUME_MUSIC_INCREASE);
+    }
+    else if(i_wand_menu + 1 > 5) {
+      if((!in.pack_on && !in.pack_shutting_down) || (in.wand_standalone && in.wand_off)) {
+        switch(WAND_MENU_LEVEL) {
+          case MENU_LEVEL_3:
+            WAND_MENU_LEVEL = MENU_LEVEL_2;
+            i_wand_menu = 1;
+            refLights(log, -1, 0, -1, -1);
+            refLevelChange(log, WAND_MENU_LEVEL);
+          break;
+
+          case MENU_LEVEL_2:
+            WAND_MENU_LEVEL = MENU_LEVEL_1;
+            i_wand_menu = 1;
+            refLights(log, 0, -1, -1, -1);
+            refLevelChange(log, WAND_MENU_LEVEL);
+          break;
+
+          case MENU_LEVEL_1:
+          default:
+            i_wand_menu = 5;
+          break;
+        }
+      }
+      else {
+        i_wand_menu = 5;
+      }
+    }
+    else {
+      i_wand_menu++;
+    }
+  }
+}
+
+/*
+ * Port: the menu tree, with the guard conditions and action dispatch of the Neutrona Wand.
+ */
+static uint16_t stateFor(const DialInputs& in) {
+  uint16_t i_state = 0;
+
+  i_state |= in.intensify_on ? MENU_GUARD_INTENSIFY_ON : MENU_GUARD_INTENSIFY_OFF;
+  i_state |= in.intensify_long ? MENU_GUARD_INTENSIFY_LONG : 0;
+  i_state |= in.mode_on ? MENU_GUARD_MODE_ON : MENU_GUARD_MODE_OFF;
+  i_state |= in.mode_long ? MENU_GUARD_MODE_LONG : 0;
+  i_state |= (in.playing_music && !in.music_paused) ? MENU_GUARD_MUSIC_PLAYING : 0;
+  i_state |= (in.wand_standalone || in.volume_wand) ? MENU_GUARD_WAND_VOLUME : MENU_GUARD_PACK_VOLUME;
+  i_state |= ((!in.pack_on && !in.pack_shutting_down) || (in.wand_standalone && in.wand_off)) ? MENU_GUARD_LEVELS_UNLOCKED : 0;
+
+  return i_state;
+}
+
+static void portDial(const MenuTreeMenu* menu, uint8_t prev_next_code, const DialInputs& in, DialLog& log) {
+  uint8_t i_input;
+
+  if(prev_next_code == 0x0b) {
+    i_input = MENU_INPUT_DIAL_CCW;
+  }
+  else if(prev_next_code == 0x07) {
+    i_input = MENU_INPUT_DIAL_CW;
+  }
+  else {
+    return;
+  }
+
+  MenuTreeStep step = menuTreeDial(menu, i_input, stateFor(in), log.level, log.item);
+
+  if(step.levelChanged) {
+    const uint8_t i_lights[4] = {MENU_LIGHT_SLO_BLO, MENU_LIGHT_VENT, MENU_LIGHT_TOP, MENU_LIGHT_CLIPPARD};
+
+    for(uint8_t i = 0; i < 4; i++) {
+      if(step.lightsMask & i_lights[i]) {
+        log.lights[i] = (step.lights & i_lights[i]) ? 1 : 0;
+      }
+    }
+
+    refLevelChange(log, log.level);
+  }
+
+  switch(step.action) {
+    case MENU_ACTION_SEND:
+      log.send(step.value);
+    break;
+
+    case MENU_ACTION_VOLUME_EFFECTS_DOWN:
+      log.call("decreaseVolumeEffects");
+      log.send(step.value);
+    break;
+
+    case MENU_ACTION_VOLUME_EFFECTS_UP:
+      log.call("increaseVolumeEffects");
+      log.send(step.value);
+    break;
+
+    case MENU_ACTION_VOLUME_MUSIC_DOWN:
+      log.call("decreaseVolumeMusic");
+      log.send(step.value);
+    break;
+
+    case MENU_ACTION_VOLUME_MUSIC_UP:
+      log.call("increaseVolumeMusic");
+      log.send(step.value);
+    break;
+
+    case MENU_ACTION_VOLUME_EEPROM_DOWN:
+      log.call("decreaseVolumeEEPROM");
+    break;
+
+    case MENU_ACTION_VOLUME_EEPROM_UP:
+      log.call("increaseVolumeEEPROM");
+    break;
+
+    case MENU_ACTION_OVERHEAT_TIMER_DOWN:
+      log.call("overheatTimerDecrement", step.value);
+    break;
+
+    case MENU_ACTION_OVERHEAT_TIMER_UP:
+      log.call("overheatTimerIncrement", step.value);
+    break;
+
+    case MENU_ACTION_SPECTRAL_WAND_DOWN:
+      log.call("spectralWandDecrease");
+    break;
+
+    case MENU_ACTION_SPECTRAL_WAND_UP:
+      log.call("spectralWandIncrease");
+    break;
+
+    case MENU_ACTION_NONE:
+    default:
+    break;
+  }
+}
+
+typedef void (*RefDial)(uint8_t prev_next_code, const DialInputs& in, DialLog& log);
+
+struct WandMenu {
+  const char* name;
+  const MenuTreeMenu* menu;
+  RefDial reference;
+  uint8_t levels;
+};
+
+static const WandMenu WAND_MENUS[] = {
+  {"settings", &WAND_MENU_SETTINGS, refSettings, 2},
+  {"config eeprom", &WAND_MENU_CONFIG_EEPROM, refConfigEEPROM, 5},
+  {"led eeprom", &WAND_MENU_LED_EEPROM, refLEDEEPROM, 3}
+};
+
+static bool sameLog(const DialLog& expected, const DialLog& actual) {
+  if(expected.events != actual.events || expected.level != actual.level || expected.item != actual.item) {
+    return false;
+  }
+
+  for(uint8_t i = 0; i < 4; i++) {
+    if(expected.lights[i] != actual.lights[i]) {
+      return false;
+    }
+  }
+
+  return true;
+}
+
+static std::string describe(const DialLog& log) {
+  std::string s = "level " + std::to_string(log.level + 1) + " item " + std::to_string(log.item) + " lights";
+
+  for(uint8_t i = 0; i < 4; i++) {
+    s += " " + std::to_string(log.lights[i]);
+  }
+
+  for(const std::string& event : log.events) {
+    s += ", " + event;
+  }
+
+  return s;
+}
+
+/*
+ * Every item of every level of every menu, turned either way with every combination of switches and
+ * system state, gives the same commands, lights and menu position as before.
+ */
+TEST(MenuTreeTest, EveryDialInputMatchesReference) {
+  const uint8_t i_codes[2] = {0x0b, 0x07};
+  uint32_t i_cases = 0;
+
+  for(const WandMenu& menu : WAND_MENUS) {
+    for(uint8_t i_level = 0; i_level < menu.levels; i_level++) {
+      for(uint8_t i_item = 1; i_item <= MENU_TREE_ITEMS; i_item++) {
+        for(uint8_t i_code : i_codes) {
+          for(uint16_t i_bits = 0; i_bits < (1 << DIAL_INPUT_COUNT); i_bits++) {
+            DialInputs in = inputsFor(i_bits);
+            DialLog expected, actual;
+
+            expected.level = actual.level = i_level;
+            expected.item = actual.item = i_item;
+
+            menu.reference(i_code, in, expected);
+            portDial(menu.menu, i_code, in, actual);
+
+            ASSERT_TRUE(sameLog(expected, actual)) << menu.name << " level " << (i_level + 1) << " item " << (int)i_item
+                                                   << " code " << (int)i_code << " inputs " << i_bits << ": expected "
+                                                   << describe(expected) << ", got " << describe(actual);
+            i_cases++;
+          }
+        }
+      }
+    }
+  }
+
+  EXPECT_EQ(i_cases, (uint32_t)(2 + 5 + 3) * MENU_TREE_ITEMS * 2 * (1 << DIAL_INPUT_COUNT));
+}
+
+// Other rotary codes do nothing.
+TEST(MenuTreeTest, OtherCodesIgnored) {
+  for(const WandMenu& menu : WAND_MENUS) {
+    DialLog expected, actual;
+
+    menu.reference(0x01, inputsFor(0), expected);
+    portDial(menu.menu, 0x01, inputsFor(0), actual);
+
+    EXPECT_TRUE(sameLog(expected, actual)) << menu.name;
+    EXPECT_TRUE(actual.events.empty());
+  }
+}
+
+/*
+ * Long random walks through each menu from the top, as a user turning the dial while pressing the
+ * buttons, stay in step with the reference.
+ */
+TEST(MenuTreeTest, RandomWalksMatchReference) {
+  uint32_t i_seed = 7;
+
+  for(const WandMenu& menu : WAND_MENUS) {
+    DialLog expected, actual;
+    uint8_t i_deepest = 0;
+
+    for(uint32_t i = 0; i < 200000; i++) {
+      i_seed = i_seed * 1103515245u + 12345u;
+
+      uint8_t i_code = (i_seed >> 8) & 0x01 ? 0x07 : 0x0b;
+      DialInputs in = inputsFor((i_seed >> 16) & ((1 << DIAL_INPUT_COUNT) - 1));
+
+      menu.reference(i_code, in, expected);
+      portDial(menu.menu, i_code, in, actual);
+
+      ASSERT_TRUE(sameLog(expected, actual)) << menu.name << " step " << i << ": expected " << describe(expected)
+                                             << ", got " << describe(actual);
+
+      expected.events.clear();
+      actual.events.clear();
+
+      if(actual.level > i_deepest) {
+        i_deepest = actual.level;
+      }
+    }
+
+    // Every level was reached.
+    EXPECT_EQ(i_deepest, menu.levels - 1) << menu.name;
+  }
+}
+
+// Every node sits on a level and item of its menu.
+TEST(MenuTreeTest, NodesWithinMenu) {
+  for(const WandMenu& menu : WAND_MENUS) {
+    for(uint8_t i = 0; i < menu.menu->count; i++) {
+      const MenuTreeNode& node = menu.menu->nodes[i];
+
+      EXPECT_LE(node.level, menu.menu->deepest) << menu.name << " node " << (int)i;
+      EXPECT_GE(node.item, 1) << menu.name << " node " << (int)i;
+      EXPECT_LE(node.item, MENU_TREE_ITEMS) << menu.name << " node " << (int)i;
+      EXPECT_NE(node.action, MENU_ACTION_NONE) << menu.name << " node " << (int)i;
+    }
+  }
+}
+
+/*
+ * Reference: the menu item indicator of settingsBlinkingLights(), where i_bargraph_segments is 30.
+ */
+static uint32_t refBargraphItem(uint8_t item, uint8_t segments) {
+  const uint8_t i_bargraph_segments = 30;
+  uint8_t i_segment_adjust = segments == 30 ? 0 : 2;
+  uint32_t i_mask = 0;
+
+  switch(item) {
+    case 5:
+      for(uint8_t i = 1; i < i_bargraph_segments - i_segment_adjust; i++) {
+        if(segments == 30) {
+          if(i == 5 || i == 6 || i == 11 || i == 12 || i == 17 || i == 18 || i == 23 || i == 24 || i == 29) continue;
+        }
+        else {
+          if(i == 4 || i == 5 || i == 6 || i == 10 || i == 11 || i == 12 || i == 16 || i == 17 || i == 18 || i == 22 || i == 23 || i == 24) continue;
+        }
+
+        i_mask |= (uint32_t)1 << i;
+      }
+    break;
+
+    case 4:
+      for(uint8_t i = 1; i < (segments == 30 ? 23 : 22); i++) {
+        if(segments == 30) {
+          if(i == 5 || i == 6 || i == 11 || i == 12 || i == 17 || i == 18) continue;
+        }
+        else {
+          if(i == 4 || i == 5 || i == 6 || i == 10 || i == 11 || i == 12 || i == 16 || i == 17 || i == 18) continue;
+        }
+
+        i_mask |= (uint32_t)1 << i;
+      }
+    break;
+
+    case 3:
+      for(uint8_t i = 1; i < (segments == 30 ? 17 : 16); i++) {
+        if(segments == 30) {
+          if(i == 5 || i == 6 || i == 11 || i == 12) continue;
+        }
+        else {
+          if(i == 4 || i == 5 || i == 6 || i == 10 || i == 11 || i == 12) continue;
+        }
+
+        i_mask |= (uint32_t)1 << i;
+      }
+    break;
+
+    case 2:
+      for(uint8_t i = 1; i < (segments == 30 ? 11 : 10); i++) {
+        if(segments == 30) {
+          if(i == 5 || i == 6) continue;
+        }
+        else {
+          if(i == 4 || i == 5 || i == 6) continue;
+        }
+
+        i_mask |= (uint32_t)1 << i;
+      }
+    break;
+
+    case 1:
+      for(uint8_t i = 1; i < (segments == 30 ? 5 : 4); i++) {
+        i_mask |= (uint32_t)1 << i;
+      }
+    break;
+  }
+
+  return i_mask;
+}
+
+TEST(MenuTreeTest, BargraphItemsMatchReference) {
+  EXPECT_EQ(menuTreeBargraphItem(1, 28), 0x0000000Eu); // Segments 1-3.
+  EXPECT_EQ(menuTreeBargraphItem(1, 30), 0x0000001Eu); // Segments 1-4.
+
+  for(uint8_t i_item = 1; i_item <= MENU_TREE_ITEMS; i_item++) {
+    EXPECT_EQ(menuTreeBargraphItem(i_item, 28), refBargraphItem(i_item, 28)) << "item " << (int)i_item;
+    EXPECT_EQ(menuTreeBargraphItem(i_item, 30), refBargraphItem(i_item, 30)) << "item " << (int)i_item;
+  }
+
+  EXPECT_EQ(menuTreeBargraphItem(0, 28), 0u);
+  EXPECT_EQ(menuTreeBargraphItem(6, 30), 0u);
+}
+
+/*
+ * Benchmark: one dial event in the deepest part of the EEPROM menu, the worst case for the
+ * reference chain of conditions and for the table scan.
+ */
+TEST(MenuTreeBenchmark, DialEvent) {
+  const uint32_t i_events = 2000000;
+  DialInputs in = inputsFor(0);
+  volatile uint32_t i_sink = 0;
+
+  auto start = std::chrono::steady_clock::now();
+
+  for(uint32_t i = 0; i < i_events; i++) {
+    DialLog log;
+    log.level = MENU_LEVEL_5;
+    log.item = 3;
+    refConfigEEPROM(i & 0x01 ? 0x07 : 0x0b, in, log);
+    i_sink += log.item;
+  }
+
+  double before = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count() / i_events;
+
+  start = std::chrono::steady_clock::now();
+
+  for(uint32_t i = 0; i < i_events; i++) {
+    uint8_t i_level = MENU_LEVEL_5;
+    uint8_t i_item = 3;
+    MenuTreeStep step = menuTreeDial(&WAND_MENU_CONFIG_EEPROM, i & 0x01 ? MENU_INPUT_DIAL_CW : MENU_INPUT_DIAL_CCW, stateFor(in), i_level, i_item);
+    i_sink += i_item + step.action;
+  }
+
+  double after = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count() / i_events;
+
+  printf("[          ] dial event: reference %.1f ns, menu tree %.1f ns\n", before, after);
+  EXPECT_GT(i_sink, 0u);
+}
@@ -0,0 +1,287 @@
+/**
+ *   MotionFilter - Per-axis low-pass and adaptive filters for motion sensor data in GPStar devices.
+ *   Copyright (C) 2023-2026 Michael Rajotte, Dustin Grau, Nomake Wan
+ *
+ *   This program is free software; you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation; either version 3 of the License, or
+ *   (at your option) any later version.
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License
+ *   along with this program; if not, see <https://www.gnu.org/licenses/>.
+ *
+ */
+
+#pragma once
+
+// Standard library includes for integer type definitions
+#include <stdint.h>  // Provides uint8_t, uint16_t, etc.
+#include <stdbool.h> // Provides bool type definition.
+
+// Low-pass cutoffs are kept below this fraction of the sample rate, short of the Nyquist frequency.
+#define MOTION_FILTER_MAX_CUTOFF 0.45f
+
+// Fixed-point coefficients are Q2.14, which holds the -2 to 2 range of the feedback terms.
+#define MOTION_FILTER_Q14_SHIFT 14
+
+enum MotionFilterType : uint8_t {
+  MOTION_FILTER_NONE,     // Passes samples through unchanged.
+  MOTION_FILTER_LOW_PASS, // Second-order (biquad) low-pass at a fixed cutoff.
+  MOTION_FILTER_ONE_EURO  // First-order low-pass whose cutoff rises with the speed of change.
+};
+
+/**
+ * Struct: MotionFilterParams
+ * Purpose: How one sensor's axes are filtered.
+ *
+ * For the one-euro filter the cutoff is the minimum, used while the signal holds still, and beta is
+ * how far it rises (in Hz) per unit/s of change, so beta depends on the units of the sensor.
+ */
+struct MotionFilterParams {
+  uint8_t type;
+  float cutoffHz;           // Low-pass corner frequency, or the one-euro minimum cutoff.
+  float q;                  // Low-pass quality factor (0.7071 for a flat Butterworth passband).
+  float beta;               // One-euro cutoff increase per unit/s.
+  float derivativeCutoffHz; // One-euro cutoff for the speed estimate.
+};
+
+/**
+ * Struct: MotionFilterSet
+ * Purpose: Filters for each sensor for one use of the motion data.
+ */
+struct MotionFilterSet {
+  MotionFilterParams accel; // m/s^2
+  MotionFilterParams gyro;  // deg/s
+  MotionFilterParams mag;   // uT
+};
+
+// Smooth values for display, which still follow a fast swing.
+extern const MotionFilterSet MOTION_FILTERS_DISPLAY;
+
+// Short-lag low-pass for the shake thresholds, removing sensor noise but not the shake itself.
+extern const MotionFilterSet MOTION_FILTERS_SHAKE;
+
+// Anti-aliasing for the fusion filter's inputs, above the fastest motion of the device.
+extern const MotionFilterSet MOTION_FILTERS_AHRS;
+
+/**
+ * Struct: BiquadCoefficients
+ * Purpose: Normalised coefficients (a0 = 1) of H(z) = (b0 + b1 z^-1 + b2 z^-2) / (1 + a1 z^-1 + a2 z^-2).
+ */
+struct BiquadCoefficients {
+  float b0 = 1.0f;
+  float b1 = 0.0f;
+  float b2 = 0.0f;
+  float a1 = 0.0f;
+  float a2 = 0.0f;
+};
+
+/**
+ * Struct: BiquadCoefficientsQ14
+ * Purpose: The same coefficients in Q2.14, rounded so the gain at DC is still exactly 1.
+ */
+struct BiquadCoefficientsQ14 {
+  int16_t b0 = 1 << MOTION_FILTER_Q14_SHIFT;
+  int16_t b1 = 0;
+  int16_t b2 = 0;
+  int16_t a1 = 0;
+  int16_t a2 = 0;
+};
+
+/**
+ * Designs a low-pass biquad (bilinear transform, with the cutoff prewarped so it falls exactly at cutoffHz).
+ * Cutoffs beyond MOTION_FILTER_MAX_CUTOFF of the sample rate are reduced to it.
+ * @return False, leaving a pass-through, if either frequency is not positive.
+ */
+bool biquadLowPass(float cutoffHz, float sampleHz, float q, BiquadCoefficients& coefficients);
+
+// Rounds coefficients to Q2.14. Returns false if any is out of range.
+bool biquadToQ14(const BiquadCoefficients& coefficients, BiquadCoefficientsQ14& fixed);
+
+// Gain of the filter at a frequency, as a fraction of the sample rate (0 to 0.5).
+float biquadGain(const BiquadCoefficients& coefficients, float frequency);
+
+/**
+ * Class: BiquadFilter
+ * Purpose: One biquad section in transposed direct form II, the usual choice for floating point.
+ */
+class BiquadFilter {
+public:
+  BiquadFilter();
+
+  void setCoefficients(const BiquadCoefficients& coefficients);
+
+  // Settles the filter as if it had always been given value.
+  void reset(float value);
+
+  float update(float x);
+
+private:
+  BiquadCoefficients c;
+  float z1;
+  float z2;
+};
+
+/**
+ * Class: BiquadFilterQ15
+ * Purpose: One biquad section on 16-bit samples (eg. raw sensor counts) using only integer arithmetic.
+ *
+ * Direct form I keeps every state value within the sample range. The part of each result below the
+ * output step is carried into the next one (first-order error feedback), so a low cutoff does not
+ * leave the output stuck short of a steady input. The sum is taken modulo 2^32, which gives the right
+ * answer however large the partial sums get as long as the result itself fits, and is then saturated.
+ */
+class BiquadFilterQ15 {
+public:
+  BiquadFilterQ15();
+
+  void setCoefficients(const BiquadCoefficientsQ14& coefficients);
+  void reset(int16_t value);
+  int16_t update(int16_t x);
+
+private:
+  BiquadCoefficientsQ14 c;
+  int16_t x1, x2;
+  int16_t y1, y2;
+  uint16_t error;
+};
+
+/**
+ * Class: OneEuroFilter
+ * Purpose: The 1€ filter (Casiez, Roussel and Vogel, 2012): a first-order low-pass whose cutoff rises with
+ *          the filtered speed of the signal, so it smooths hard while still and lags little while moving.
+ */
+class OneEuroFilter {
+public:
+  OneEuroFilter();
+
+  void setParams(float minCutoffHz, float beta, float derivativeCutoffHz);
+
+  // Forgets the signal, so the next sample is passed through and starts it again.
+  void reset();
+
+  // Filters a sample taken dt seconds after the last.
+  float update(float x, float dt);
+
+private:
+  float minCutoffHz;
+  float beta;
+  float derivativeCutoffHz;
+  float value;
+  float speed;
+  bool primed;
+};
+
+/**
+ * Class: OneEuroFilterQ15
+ * Purpose: The 1€ filter on 16-bit samples using only integer arithmetic.
+ *
+ * The smoothing factors are Q15, the speed is in counts/s and the filtered value keeps 16 bits below the
+ * count between samples. Beta is given per count/s (see MotionFilterBankQ15 for converting it from units).
+ */
+class OneEuroFilterQ15 {
+public:
+  OneEuroFilterQ15();
+
+  void setParams(float minCutoffHz, float beta, float derivativeCutoffHz);
+  void reset();
+
+  // Filters a sample taken dtUs microseconds after the last.
+  int16_t update(int16_t x, uint32_t dtUs);
+
+private:
+  uint32_t minCutoffQ8;        // Hz in Q8.
+  uint32_t derivativeCutoffQ8; // Hz in Q8.
+  uint32_t betaQ24;            // Hz per count/s in Q24.
+  int32_t value;               // Counts in Q16.
+  int32_t speed;               // Counts/s.
+  bool primed;
+};
+
+// Smoothing factor in Q15 for a first-order low-pass at cutoffQ8 (Hz in Q8) over dtUs.
+uint16_t oneEuroAlphaQ15(uint32_t cutoffQ8, uint32_t dtUs);
+
+/**
+ * Class: AxisFilter
+ * Purpose: Filters one axis with whichever filter its parameters choose.
+ */
+class AxisFilter {
+public:
+  AxisFilter();
+
+  // Sets the filter and the rate at which a low-pass is given samples, and resets it.
+  void configure(const MotionFilterParams& params, float sampleHz);
+  void reset();
+  float update(float x, float dt);
+
+private:
+  uint8_t type;
+  bool primed;
+  BiquadFilter lowPass;
+  OneEuroFilter oneEuro;
+};
+
+/**
+ * Class: AxisFilterQ15
+ * Purpose: An AxisFilter on 16-bit counts, with one-euro beta scaled from units to counts.
+ */
+class AxisFilterQ15 {
+public:
+  AxisFilterQ15();
+
+  void configure(const MotionFilterParams& params, float sampleHz, float unitsPerCount);
+  void reset();
+  int16_t update(int16_t x, uint32_t dtUs);
+
+private:
+  uint8_t type;
+  bool primed;
+  BiquadFilterQ15 lowPass;
+  OneEuroFilterQ15 oneEuro;
+};
+
+// Axes of a MotionFilterBank, 3 for each sensor.
+enum MotionFilterAxis : uint8_t {
+  MOTION_AXIS_ACCEL_X, MOTION_AXIS_ACCEL_Y, MOTION_AXIS_ACCEL_Z,
+  MOTION_AXIS_GYRO_X, MOTION_AXIS_GYRO_Y, MOTION_AXIS_GYRO_Z,
+  MOTION_AXIS_MAG_X, MOTION_AXIS_MAG_Y, MOTION_AXIS_MAG_Z,
+  MOTION_AXIS_COUNT
+};
+
+/**
+ * Class: MotionFilterBank
+ * Purpose: Filters each axis of the accelerometer, gyroscope and magnetometer for one use.
+ *
+ * Example usage:
+ *   MotionFilterBank displayFilters;
+ *   displayFilters.configure(MOTION_FILTERS_DISPLAY, 104.0f);
+ *   filtered.accelX = displayFilters.update(MOTION_AXIS_ACCEL_X, raw.accelX, f_interval);
+ */
+class MotionFilterBank {
+public:
+  void configure(const MotionFilterSet& set, float sampleHz);
+  void reset();
+  float update(uint8_t axis, float x, float dt);
+
+private:
+  AxisFilter axes[MOTION_AXIS_COUNT];
+};
+
+/**
+ * Class: MotionFilterBankQ15
+ * Purpose: A MotionFilterBank on raw 16-bit counts, given the units per count of each sensor.
+ */
+class MotionFilterBankQ15 {
+public:
+  void configure(const MotionFilterSet& set, float sampleHz, float accelPerCount, float gyroPerCount, float magPerCount);
+  void reset();
+  int16_t update(uint8_t axis, int16_t x, uint32_t dtUs);
+
+private:
+  AxisFilterQ15 axes[MOTION_AXIS_COUNT];
+};
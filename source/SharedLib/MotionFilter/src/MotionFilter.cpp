@@ -0,0 +1,417 @@
+/**
+ *   MotionFilter - Per-axis low-pass and adaptive filters for motion sensor data in GPStar devices.
+ *   Copyright (C) 2023-2026 Michael Rajotte, Dustin Grau, Nomake Wan
+ *
+ *   This program is free software; you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation; either version 3 of the License, or
+ *   (at your option) any later version.
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License
+ *   along with this program; if not, see <https://www.gnu.org/licenses/>.
+ *
+ */
+
+// Library Header
+#include "MotionFilter.h"
+
+#include <math.h>
+
+static const float MOTION_FILTER_TWO_PI = 6.28318531f;
+static const float MOTION_FILTER_BUTTERWORTH_Q = 0.70710678f;
+static const int32_t Q14_ONE = 1 << MOTION_FILTER_Q14_SHIFT;
+
+// 2 * pi / 1000000 scaled from Q8 Hz to a Q16 result (x 256), in Q28: radians per Q8 Hz per microsecond.
+static const uint64_t ONE_EURO_RADIANS_Q28 = 431777;
+
+// Longest interval (us) used by the fixed-point one-euro filter, keeping its products within 64 bits.
+static const uint32_t ONE_EURO_MAX_INTERVAL_US = 1000000;
+
+// Highest cutoff of a fixed-point one-euro filter, in Q8 Hz (well above any sample rate used).
+static const uint32_t ONE_EURO_MAX_CUTOFF_Q8 = 10000UL << 8;
+
+// Display: hold steady when still, but let the cutoff rise quickly during a swing.
+const MotionFilterSet MOTION_FILTERS_DISPLAY = {
+  {MOTION_FILTER_ONE_EURO, 1.0f, 0.0f, 0.05f, 1.0f},  // +1Hz per 20 m/s^3
+  {MOTION_FILTER_ONE_EURO, 1.0f, 0.0f, 0.005f, 1.0f}, // +1Hz per 200 deg/s^2
+  {MOTION_FILTER_ONE_EURO, 0.5f, 0.0f, 0.01f, 1.0f}   // +1Hz per 100 uT/s
+};
+
+// Shake: removes noise above a hand's movement while keeping the peaks of a shake.
+const MotionFilterSet MOTION_FILTERS_SHAKE = {
+  {MOTION_FILTER_LOW_PASS, 10.0f, MOTION_FILTER_BUTTERWORTH_Q, 0.0f, 0.0f},
+  {MOTION_FILTER_LOW_PASS, 10.0f, MOTION_FILTER_BUTTERWORTH_Q, 0.0f, 0.0f},
+  {MOTION_FILTER_NONE, 0.0f, 0.0f, 0.0f, 0.0f}
+};
+
+// Fusion: only vibration is removed, keeping the lag on the orientation small.
+const MotionFilterSet MOTION_FILTERS_AHRS = {
+  {MOTION_FILTER_LOW_PASS, 20.0f, MOTION_FILTER_BUTTERWORTH_Q, 0.0f, 0.0f},
+  {MOTION_FILTER_LOW_PASS, 40.0f, MOTION_FILTER_BUTTERWORTH_Q, 0.0f, 0.0f},
+  {MOTION_FILTER_NONE, 0.0f, 0.0f, 0.0f, 0.0f}
+};
+
+bool biquadLowPass(float cutoffHz, float sampleHz, float q, BiquadCoefficients& coefficients) {
+  coefficients = BiquadCoefficients();
+
+  if(cutoffHz <= 0.0f || sampleHz <= 0.0f) {
+    return false;
+  }
+
+  if(cutoffHz > sampleHz * MOTION_FILTER_MAX_CUTOFF) {
+    cutoffHz = sampleHz * MOTION_FILTER_MAX_CUTOFF;
+  }
+
+  if(q <= 0.0f) {
+    q = MOTION_FILTER_BUTTERWORTH_Q;
+  }
+
+  float w0 = MOTION_FILTER_TWO_PI * cutoffHz / sampleHz;
+  float cosW0 = cosf(w0);
+  float alpha = sinf(w0) / (2.0f * q);
+  float a0 = 1.0f + alpha;
+
+  coefficients.b0 = (1.0f - cosW0) / (2.0f * a0);
+  coefficients.b1 = (1.0f - cosW0) / a0;
+  coefficients.b2 = coefficients.b0;
+  coefficients.a1 = (-2.0f * cosW0) / a0;
+  coefficients.a2 = (1.0f - alpha) / a0;
+
+  return true;
+}
+
+// Rounds to Q2.14, returning false when out of range.
+static bool toQ14(float value, int32_t& fixed) {
+  fixed = (int32_t)lroundf(value * Q14_ONE);
+  return fixed >= INT16_MIN && fixed <= INT16_MAX;
+}
+
+bool biquadToQ14(const BiquadCoefficients& coefficients, BiquadCoefficientsQ14& fixed) {
+  int32_t b0, b2, a1, a2;
+
+  if(!toQ14(coefficients.b0, b0) || !toQ14(coefficients.b2, b2) || !toQ14(coefficients.a1, a1) || !toQ14(coefficients.a2, a2)) {
+    return false;
+  }
+
+  // The middle tap takes up the rounding of the others, so the numerator still sums to the denominator.
+  int32_t b1 = Q14_ONE + a1 + a2 - b0 - b2;
+
+  if(b1 < INT16_MIN || b1 > INT16_MAX) {
+    return false;
+  }
+
+  fixed.b0 = b0;
+  fixed.b1 = b1;
+  fixed.b2 = b2;
+  fixed.a1 = a1;
+  fixed.a2 = a2;
+
+  return true;
+}
+
+float biquadGain(const BiquadCoefficients& coefficients, float frequency) {
+  float w = MOTION_FILTER_TWO_PI * frequency;
+  float numRe = coefficients.b0 + coefficients.b1 * cosf(w) + coefficients.b2 * cosf(2.0f * w);
+  float numIm = -(coefficients.b1 * sinf(w) + coefficients.b2 * sinf(2.0f * w));
+  float denRe = 1.0f + coefficients.a1 * cosf(w) + coefficients.a2 * cosf(2.0f * w);
+  float denIm = -(coefficients.a1 * sinf(w) + coefficients.a2 * sinf(2.0f * w));
+
+  return sqrtf((numRe * numRe + numIm * numIm) / (denRe * denRe + denIm * denIm));
+}
+
+BiquadFilter::BiquadFilter() : z1(0.0f), z2(0.0f) {
+}
+
+void BiquadFilter::setCoefficients(const BiquadCoefficients& coefficients) {
+  c = coefficients;
+}
+
+void BiquadFilter::reset(float value) {
+  z1 = value - c.b0 * value;
+  z2 = (c.b2 - c.a2) * value;
+}
+
+float BiquadFilter::update(float x) {
+  float y = c.b0 * x + z1;
+
+  z1 = c.b1 * x - c.a1 * y + z2;
+  z2 = c.b2 * x - c.a2 * y;
+
+  return y;
+}
+
+BiquadFilterQ15::BiquadFilterQ15() : x1(0), x2(0), y1(0), y2(0), error(0) {
+}
+
+void BiquadFilterQ15::setCoefficients(const BiquadCoefficientsQ14& coefficients) {
+  c = coefficients;
+}
+
+void BiquadFilterQ15::reset(int16_t value) {
+  x1 = x2 = y1 = y2 = value;
+  error = 0;
+}
+
+int16_t BiquadFilterQ15::update(int16_t x) {
+  uint32_t acc = (uint32_t)(c.b0 * x) + (uint32_t)(c.b1 * x1) + (uint32_t)(c.b2 * x2)
+               - (uint32_t)(c.a1 * y1) - (uint32_t)(c.a2 * y2) + error;
+  int32_t sum = (int32_t)acc;
+  int32_t y = sum >> MOTION_FILTER_Q14_SHIFT;
+
+  error = sum & (Q14_ONE - 1);
+
+  if(y > INT16_MAX) {
+    y = INT16_MAX;
+    error = 0;
+  }
+  else if(y < INT16_MIN) {
+    y = INT16_MIN;
+    error = 0;
+  }
+
+  x2 = x1;
+  x1 = x;
+  y2 = y1;
+  y1 = y;
+
+  return y;
+}
+
+// Smoothing factor of a first-order low-pass at cutoffHz over dt seconds.
+static float oneEuroAlpha(float cutoffHz, float dt) {
+  float r = MOTION_FILTER_TWO_PI * cutoffHz * dt;
+  return r / (r + 1.0f);
+}
+
+OneEuroFilter::OneEuroFilter()
+  : minCutoffHz(1.0f), beta(0.0f), derivativeCutoffHz(1.0f), value(0.0f), speed(0.0f), primed(false) {
+}
+
+void OneEuroFilter::setParams(float minCutoffHz, float beta, float derivativeCutoffHz) {
+  this->minCutoffHz = minCutoffHz;
+  this->beta = beta;
+  this->derivativeCutoffHz = derivativeCutoffHz;
+}
+
+void OneEuroFilter::reset() {
+  primed = false;
+}
+
+float OneEuroFilter::update(float x, float dt) {
+  if(!primed) {
+    value = x;
+    speed = 0.0f;
+    primed = true;
+    return x;
+  }
+
+  if(dt <= 0.0f) {
+    return value;
+  }
+
+  // The speed is filtered first, then sets the cutoff for the value.
+  speed += oneEuroAlpha(derivativeCutoffHz, dt) * ((x - value) / dt - speed);
+  value += oneEuroAlpha(minCutoffHz + beta * fabsf(speed), dt) * (x - value);
+
+  return value;
+}
+
+uint16_t oneEuroAlphaQ15(uint32_t cutoffQ8, uint32_t dtUs) {
+  // w = 2 * pi * cutoff * dt in Q16, then alpha = w / (w + 1).
+  if(dtUs > ONE_EURO_MAX_INTERVAL_US) {
+    dtUs = ONE_EURO_MAX_INTERVAL_US;
+  }
+
+  uint64_t w = ((uint64_t)cutoffQ8 * dtUs * ONE_EURO_RADIANS_Q28) >> 28;
+
+  if(w > 0xFFFFFFFFULL) {
+    w = 0xFFFFFFFFULL;
+  }
+
+  return (uint16_t)((w << 15) / (w + 65536));
+}
+
+OneEuroFilterQ15::OneEuroFilterQ15()
+  : minCutoffQ8(256), derivativeCutoffQ8(256), betaQ24(0), value(0), speed(0), primed(false) {
+}
+
+void OneEuroFilterQ15::setParams(float minCutoffHz, float beta, float derivativeCutoffHz) {
+  minCutoffQ8 = (uint32_t)lroundf(minCutoffHz * 256.0f);
+  derivativeCutoffQ8 = (uint32_t)lroundf(derivativeCutoffHz * 256.0f);
+  betaQ24 = (uint32_t)lroundf(beta * 16777216.0f);
+}
+
+void OneEuroFilterQ15::reset() {
+  primed = false;
+}
+
+int16_t OneEuroFilterQ15::update(int16_t x, uint32_t dtUs) {
+  if(!primed) {
+    value = (int32_t)x * 65536;
+    speed = 0;
+    primed = true;
+    return x;
+  }
+
+  int64_t difference = (int64_t)x * 65536 - value; // Counts in Q16.
+
+  if(dtUs > 0) {
+    // Counts/s, limited to what 16-bit samples a microsecond apart could give.
+    int64_t rate = (difference * 1000000 / (int64_t)dtUs) / 65536;
+    speed += (int32_t)(((rate - speed) * oneEuroAlphaQ15(derivativeCutoffQ8, dtUs)) / 32768);
+
+    uint64_t cutoffQ8 = minCutoffQ8 + (((uint64_t)betaQ24 * (uint32_t)(speed < 0 ? -speed : speed)) >> 16);
+    if(cutoffQ8 > ONE_EURO_MAX_CUTOFF_Q8) {
+      cutoffQ8 = ONE_EURO_MAX_CUTOFF_Q8;
+    }
+
+    value += (int32_t)((difference * oneEuroAlphaQ15((uint32_t)cutoffQ8, dtUs)) / 32768);
+  }
+
+  int32_t y = (value + 32768) >> 16;
+  return y > INT16_MAX ? INT16_MAX : (y < INT16_MIN ? INT16_MIN : y);
+}
+
+AxisFilter::AxisFilter() : type(MOTION_FILTER_NONE), primed(false) {
+}
+
+void AxisFilter::configure(const MotionFilterParams& params, float sampleHz) {
+  type = params.type;
+
+  if(type == MOTION_FILTER_LOW_PASS) {
+    BiquadCoefficients coefficients;
+
+    if(!biquadLowPass(params.cutoffHz, sampleHz, params.q, coefficients)) {
+      type = MOTION_FILTER_NONE;
+    }
+
+    lowPass.setCoefficients(coefficients);
+  }
+  else if(type == MOTION_FILTER_ONE_EURO) {
+    oneEuro.setParams(params.cutoffHz, params.beta, params.derivativeCutoffHz);
+  }
+
+  reset();
+}
+
+void AxisFilter::reset() {
+  primed = false;
+  oneEuro.reset();
+}
+
+float AxisFilter::update(float x, float dt) {
+  switch(type) {
+    case MOTION_FILTER_LOW_PASS:
+      if(!primed) {
+        // Start settled on the first sample rather than rising from zero.
+        lowPass.reset(x);
+        primed = true;
+        return x;
+      }
+
+      return lowPass.update(x);
+
+    case MOTION_FILTER_ONE_EURO:
+      return oneEuro.update(x, dt);
+
+    case MOTION_FILTER_NONE:
+    default:
+      return x;
+  }
+}
+
+AxisFilterQ15::AxisFilterQ15() : type(MOTION_FILTER_NONE), primed(false) {
+}
+
+void AxisFilterQ15::configure(const MotionFilterParams& params, float sampleHz, float unitsPerCount) {
+  type = params.type;
+
+  if(type == MOTION_FILTER_LOW_PASS) {
+    BiquadCoefficients coefficients;
+    BiquadCoefficientsQ14 fixed;
+
+    if(!biquadLowPass(params.cutoffHz, sampleHz, params.q, coefficients) || !biquadToQ14(coefficients, fixed)) {
+      type = MOTION_FILTER_NONE;
+    }
+
+    lowPass.setCoefficients(fixed);
+  }
+  else if(type == MOTION_FILTER_ONE_EURO) {
+    // The cutoff rises by beta per unit/s, which is beta * unitsPerCount per count/s.
+    oneEuro.setParams(params.cutoffHz, params.beta * unitsPerCount, params.derivativeCutoffHz);
+  }
+
+  reset();
+}
+
+void AxisFilterQ15::reset() {
+  primed = false;
+  oneEuro.reset();
+}
+
+int16_t AxisFilterQ15::update(int16_t x, uint32_t dtUs) {
+  switch(type) {
+    case MOTION_FILTER_LOW_PASS:
+      if(!primed) {
+        lowPass.reset(x);
+        primed = true;
+        return x;
+      }
+
+      return lowPass.update(x);
+
+    case MOTION_FILTER_ONE_EURO:
+      return oneEuro.update(x, dtUs);
+
+    case MOTION_FILTER_NONE:
+    default:
+      return x;
+  }
+}
+
+// Parameters of the sensor an axis belongs to.
+static const MotionFilterParams& motionFilterParams(const MotionFilterSet& set, uint8_t axis) {
+  if(axis < MOTION_AXIS_GYRO_X) {
+    return set.accel;
+  }
+
+  return axis < MOTION_AXIS_MAG_X ? set.gyro : set.mag;
+}
+
+void MotionFilterBank::configure(const MotionFilterSet& set, float sampleHz) {
+  for(uint8_t axis = 0; axis < MOTION_AXIS_COUNT; axis++) {
+    axes[axis].configure(motionFilterParams(set, axis), sampleHz);
+  }
+}
+
+void MotionFilterBank::reset() {
+  for(uint8_t axis = 0; axis < MOTION_AXIS_COUNT; axis++) {
+    axes[axis].reset();
+  }
+}
+
+float MotionFilterBank::update(uint8_t axis, float x, float dt) {
+  return axis < MOTION_AXIS_COUNT ? axes[axis].update(x, dt) : x;
+}
+
+void MotionFilterBankQ15::configure(const MotionFilterSet& set, float sampleHz, float accelPerCount, float gyroPerCount, float magPerCount) {
+  for(uint8_t axis = 0; axis < MOTION_AXIS_COUNT; axis++) {
+    float unitsPerCount = axis < MOTION_AXIS_GYRO_X ? accelPerCount : (axis < MOTION_AXIS_MAG_X ? gyroPerCount : magPerCount);
+    axes[axis].configure(motionFilterParams(set, axis), sampleHz, unitsPerCount);
+  }
+}
+
+void MotionFilterBankQ15::reset() {
+  for(uint8_t axis = 0; axis < MOTION_AXIS_COUNT; axis++) {
+    axes[axis].reset();
+  }
+}
+
+int16_t MotionFilterBankQ15::update(uint8_t axis, int16_t x, uint32_t dtUs) {
+  return axis < MOTION_AXIS_COUNT ? axes[axis].update(x, dtUs) : x;
+}
@@ -0,0 +1,387 @@
+#include <gtest/gtest.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <math.h>
+#include <chrono>
+#include "MotionFilter.h"
+
+#if defined(__x86_64__) || defined(__i386__)
+  #include <x86intrin.h>
+  #define HAS_CYCLE_COUNTER 1
+#endif
+
+static const double PI = 3.14159265358979;
+
+// Gain of a filter at frequencyHz, from the RMS of its output against that of a sine over whole periods.
+template <typename Step>
+static double measureGain(Step step, double frequencyHz, double sampleHz, double amplitude) {
+  const uint32_t settle = (uint32_t)(sampleHz * 2.0); // 2s, far longer than any filter here takes.
+  const uint32_t periods = 20;
+  const uint32_t measure = (uint32_t)lround(periods * sampleHz / frequencyHz);
+  double inSquares = 0.0, outSquares = 0.0;
+
+  for(uint32_t n = 0; n < settle + measure; n++) {
+    double x = amplitude * sin(2.0 * PI * frequencyHz * n / sampleHz);
+    double y = step(x);
+
+    if(n >= settle) {
+      inSquares += x * x;
+      outSquares += y * y;
+    }
+  }
+
+  return sqrt(outSquares / inSquares);
+}
+
+// Gain of a first-order low-pass with smoothing factor alpha at a frequency (fraction of the sample rate).
+static double firstOrderGain(double alpha, double frequency) {
+  double w = 2.0 * PI * frequency;
+  double re = 1.0 - (1.0 - alpha) * cos(w);
+  double im = (1.0 - alpha) * sin(w);
+  return alpha / sqrt(re * re + im * im);
+}
+
+// Uniform noise in [-1, 1].
+static double noise() {
+  return 2.0 * rand() / (double)RAND_MAX - 1.0;
+}
+
+TEST(MotionFilterTest, LowPassDesignIsButterworth) {
+  BiquadCoefficients c;
+  ASSERT_TRUE(biquadLowPass(20.0f, 208.0f, 0.7071f, c));
+
+  // Unity at DC, -3dB at the cutoff, flat below it and falling at 12dB/octave above.
+  EXPECT_NEAR(1.0, biquadGain(c, 0.0f), 1e-5);
+  EXPECT_NEAR(0.7071, biquadGain(c, 20.0f / 208.0f), 0.002);
+  EXPECT_GT(biquadGain(c, 5.0f / 208.0f), 0.99);
+  EXPECT_LT(biquadGain(c, 80.0f / 208.0f), 1.0 / 16.0);
+}
+
+TEST(MotionFilterTest, LowPassCutoffLimits) {
+  BiquadCoefficients c;
+
+  // Past the limit the cutoff is held short of Nyquist.
+  ASSERT_TRUE(biquadLowPass(200.0f, 208.0f, 0.7071f, c));
+  EXPECT_NEAR(0.7071, biquadGain(c, MOTION_FILTER_MAX_CUTOFF), 0.002);
+
+  // Nothing to design leaves a pass-through.
+  EXPECT_FALSE(biquadLowPass(0.0f, 208.0f, 0.7071f, c));
+  EXPECT_FALSE(biquadLowPass(10.0f, 0.0f, 0.7071f, c));
+  EXPECT_FLOAT_EQ(1.0f, biquadGain(c, 0.3f));
+}
+
+TEST(MotionFilterTest, LowPassFrequencyResponse) {
+  const float sampleHz = 208.0f;
+  const double frequencies[] = {1.0, 5.0, 10.0, 20.0, 30.0, 50.0, 80.0};
+  BiquadCoefficients c;
+  ASSERT_TRUE(biquadLowPass(20.0f, sampleHz, 0.7071f, c));
+
+  for(double f : frequencies) {
+    BiquadFilter filter;
+    filter.setCoefficients(c);
+
+    double gain = measureGain([&](double x) { return (double)filter.update((float)x); }, f, sampleHz, 1.0);
+    EXPECT_NEAR(biquadGain(c, f / sampleHz), gain, 0.01) << f << "Hz";
+  }
+}
+
+TEST(MotionFilterTest, LowPassQ15FrequencyResponse) {
+  // The shake and fusion filters at each sensor rate, and a low cutoff which is hardest in fixed point.
+  struct { float cutoffHz; float sampleHz; } designs[] = {{10.0f, 104.0f}, {20.0f, 208.0f}, {40.0f, 104.0f}, {2.0f, 208.0f}};
+
+  for(auto& design : designs) {
+    BiquadCoefficients c;
+    BiquadCoefficientsQ14 fixed;
+    ASSERT_TRUE(biquadLowPass(design.cutoffHz, design.sampleHz, 0.7071f, c));
+    ASSERT_TRUE(biquadToQ14(c, fixed));
+
+    for(double ratio : {0.25, 0.5, 1.0, 2.0, 4.0}) {
+      double f = design.cutoffHz * ratio;
+      if(f >= design.sampleHz / 2.0) {
+        continue;
+      }
+
+      BiquadFilterQ15 filter;
+      filter.setCoefficients(fixed);
+
+      double gain = measureGain([&](double x) { return (double)filter.update((int16_t)lround(x)); }, f, design.sampleHz, 16000.0);
+      EXPECT_NEAR(biquadGain(c, f / design.sampleHz), gain, 0.02) << design.cutoffHz << "Hz cutoff at " << f << "Hz";
+    }
+  }
+}
+
+TEST(MotionFilterTest, LowPassQ15SettlesExactly) {
+  BiquadCoefficients c;
+  BiquadCoefficientsQ14 fixed;
+  ASSERT_TRUE(biquadLowPass(1.0f, 208.0f, 0.7071f, c));
+  ASSERT_TRUE(biquadToQ14(c, fixed));
+
+  // Rounding the coefficients keeps the gain at DC exactly 1.
+  EXPECT_EQ(1 << MOTION_FILTER_Q14_SHIFT, fixed.b0 + fixed.b1 + fixed.b2 - fixed.a1 - fixed.a2);
+
+  // With the error carried over, a steady input is reached exactly rather than stopping short.
+  for(int16_t target : {12345, -20000, 7, -1}) {
+    BiquadFilterQ15 filter;
+    filter.setCoefficients(fixed);
+
+    int16_t y = 0;
+    for(uint16_t n = 0; n < 3000; n++) {
+      y = filter.update(target);
+    }
+
+    EXPECT_EQ(target, y);
+  }
+}
+
+TEST(MotionFilterTest, LowPassQ15SaturatesAtFullScale) {
+  BiquadCoefficients c;
+  BiquadCoefficientsQ14 fixed;
+  ASSERT_TRUE(biquadLowPass(40.0f, 104.0f, 0.7071f, c));
+  ASSERT_TRUE(biquadToQ14(c, fixed));
+
+  BiquadFilterQ15 filter;
+  filter.setCoefficients(fixed);
+
+  // Full-scale steps overshoot the 16-bit range, which must clip rather than wrap to the other sign.
+  for(uint8_t step = 0; step < 4; step++) {
+    int16_t x = (step % 2 == 0) ? INT16_MAX : INT16_MIN;
+
+    for(uint8_t n = 0; n < 50; n++) {
+      int16_t y = filter.update(x);
+
+      if(n >= 5) {
+        EXPECT_EQ(x > 0, y > 0) << (int)step << ":" << (int)n << " " << y;
+      }
+    }
+
+    EXPECT_NEAR(x, filter.update(x), 1);
+  }
+}
+
+TEST(MotionFilterTest, LowPassResetSettles) {
+  BiquadCoefficients c;
+  ASSERT_TRUE(biquadLowPass(10.0f, 104.0f, 0.7071f, c));
+
+  BiquadFilter filter;
+  filter.setCoefficients(c);
+  filter.reset(9.81f);
+
+  for(uint8_t n = 0; n < 20; n++) {
+    EXPECT_NEAR(9.81f, filter.update(9.81f), 1e-4);
+  }
+}
+
+TEST(MotionFilterTest, OneEuroIsFirstOrderLowPassWhenStill) {
+  // With no beta the cutoff never moves, leaving a first-order low-pass at the minimum cutoff.
+  const double sampleHz = 208.0;
+  const double dt = 1.0 / sampleHz;
+  const double cutoffHz = 5.0;
+  const double r = 2.0 * PI * cutoffHz * dt;
+  const double alpha = r / (r + 1.0);
+
+  for(double f : {1.0, 5.0, 20.0}) {
+    OneEuroFilter filter;
+    filter.setParams(cutoffHz, 0.0f, 1.0f);
+
+    double gain = measureGain([&](double x) { return (double)filter.update((float)x, (float)dt); }, f, sampleHz, 1.0);
+    EXPECT_NEAR(firstOrderGain(alpha, f / sampleHz), gain, 0.01) << f << "Hz";
+  }
+}
+
+TEST(MotionFilterTest, OneEuroSmoothsStillAndFollowsSwings) {
+  const MotionFilterParams& params = MOTION_FILTERS_DISPLAY.accel;
+  const float dt = 1.0f / 104.0f;
+  OneEuroFilter adaptive, fixed;
+
+  adaptive.setParams(params.cutoffHz, params.beta, params.derivativeCutoffHz);
+  fixed.setParams(params.cutoffHz, 0.0f, params.derivativeCutoffHz);
+  srand(49);
+
+  // Held still: sensor noise around 1g is mostly removed.
+  double inSquares = 0.0, outSquares = 0.0;
+  for(uint16_t n = 0; n < 2000; n++) {
+    float x = 9.81f + 0.1f * noise();
+    float y = adaptive.update(x, dt);
+    fixed.update(x, dt);
+
+    if(n >= 500) {
+      inSquares += (x - 9.81) * (x - 9.81);
+      outSquares += (y - 9.81) * (y - 9.81);
+    }
+  }
+
+  EXPECT_LT(sqrt(outSquares / inSquares), 0.2);
+
+  // Swung: a ramp of 50 m/s^3, where the adaptive filter lags far less than the fixed cutoff.
+  float x = 9.81f, lagAdaptive = 0.0f, lagFixed = 0.0f;
+  for(uint16_t n = 0; n < 50; n++) {
+    x += 50.0f * dt;
+    lagAdaptive = x - adaptive.update(x, dt);
+    lagFixed = x - fixed.update(x, dt);
+  }
+
+  EXPECT_LT(lagAdaptive * 3.0f, lagFixed);
+}
+
+TEST(MotionFilterTest, OneEuroAlphaQ15) {
+  for(float cutoffHz : {0.5f, 1.0f, 10.0f, 100.0f}) {
+    for(uint32_t dtUs : {1000u, 4808u, 9615u, 20000u, 100000u}) {
+      double r = 2.0 * PI * cutoffHz * dtUs / 1e6;
+      uint16_t alpha = oneEuroAlphaQ15((uint32_t)lroundf(cutoffHz * 256.0f), dtUs);
+      EXPECT_NEAR(32768.0 * r / (r + 1.0), alpha, 2.0) << cutoffHz << "Hz over " << dtUs << "us";
+    }
+  }
+
+  EXPECT_EQ(0, oneEuroAlphaQ15(256, 0));
+  EXPECT_LT(oneEuroAlphaQ15(10000UL << 8, 0xFFFFFFFF), 32768);
+}
+
+TEST(MotionFilterTest, OneEuroQ15MatchesFloat) {
+  // Accelerometer counts at 2g (0.061mg/count): a still start, a swing and noise on top, with jittered intervals.
+  const float unitsPerCount = 0.061f * 9.80665f / 1000.0f;
+  const MotionFilterParams& params = MOTION_FILTERS_DISPLAY.accel;
+  OneEuroFilter reference;
+  OneEuroFilterQ15 fixed;
+
+  reference.setParams(params.cutoffHz, params.beta * unitsPerCount, params.derivativeCutoffHz);
+  fixed.setParams(params.cutoffHz, params.beta * unitsPerCount, params.derivativeCutoffHz);
+  srand(490);
+
+  double totalDifference = 0.0;
+  int32_t maxDifference = 0;
+  for(uint16_t n = 0; n < 4000; n++) {
+    double t = n / 104.0;
+    double signal = 16393.0 + (n > 1000 && n < 2000 ? 12000.0 * sin(2.0 * PI * 2.0 * t) : 0.0);
+    int16_t x = (int16_t)lround(signal + 150.0 * noise());
+    uint32_t dtUs = 9615 + (rand() % 200) - 100;
+
+    int32_t expected = lroundf(reference.update(x, dtUs / 1e6f));
+    int32_t difference = abs(expected - fixed.update(x, dtUs));
+
+    totalDifference += difference;
+    if(difference > maxDifference) {
+      maxDifference = difference;
+    }
+  }
+
+  EXPECT_LE(maxDifference, 4);
+  EXPECT_LT(totalDifference / 4000.0, 1.0);
+}
+
+TEST(MotionFilterTest, BankFiltersEachSensorForItsUse) {
+  MotionFilterBank bank;
+  bank.configure(MOTION_FILTERS_SHAKE, 104.0f);
+
+  // The shake filters leave the magnetometer alone.
+  for(uint8_t axis = MOTION_AXIS_MAG_X; axis <= MOTION_AXIS_MAG_Z; axis++) {
+    EXPECT_FLOAT_EQ(42.0f, bank.update(axis, 42.0f, 0.01f));
+    EXPECT_FLOAT_EQ(-7.0f, bank.update(axis, -7.0f, 0.01f));
+  }
+
+  // Each axis has its own state: a step on X does not reach Y.
+  EXPECT_FLOAT_EQ(9.81f, bank.update(MOTION_AXIS_ACCEL_Y, 9.81f, 0.01f));
+  EXPECT_FLOAT_EQ(0.0f, bank.update(MOTION_AXIS_ACCEL_X, 0.0f, 0.01f));
+
+  float x = 0.0f;
+  for(uint8_t n = 0; n < 3; n++) {
+    x = bank.update(MOTION_AXIS_ACCEL_X, 20.0f, 0.01f);
+    EXPECT_NEAR(9.81f, bank.update(MOTION_AXIS_ACCEL_Y, 9.81f, 0.01f), 1e-4);
+  }
+
+  EXPECT_GT(x, 0.0f);
+  EXPECT_LT(x, 20.0f);
+
+  // Axes beyond the bank pass through.
+  EXPECT_FLOAT_EQ(3.0f, bank.update(MOTION_AXIS_COUNT, 3.0f, 0.01f));
+
+  // Starting over settles on the next sample.
+  bank.reset();
+  EXPECT_FLOAT_EQ(-5.0f, bank.update(MOTION_AXIS_GYRO_Z, -5.0f, 0.01f));
+}
+
+TEST(MotionFilterTest, BankQ15FollowsFloatBank) {
+  // The display filters on raw counts against the same filters in units (2g, 250dps, 4 gauss scales).
+  const float scales[3] = {0.061f * 9.80665f / 1000.0f, 8.75f / 1000.0f, 100.0f / 6842.0f};
+  MotionFilterBank bank;
+  MotionFilterBankQ15 bankQ15;
+
+  bank.configure(MOTION_FILTERS_DISPLAY, 104.0f);
+  bankQ15.configure(MOTION_FILTERS_DISPLAY, 104.0f, scales[0], scales[1], scales[2]);
+  srand(4900);
+
+  for(uint8_t axis = 0; axis < MOTION_AXIS_COUNT; axis++) {
+    float scale = scales[axis / 3];
+    int32_t maxDifference = 0;
+
+    for(uint16_t n = 0; n < 2000; n++) {
+      int16_t x = (int16_t)lround(4000.0 * sin(2.0 * PI * 1.5 * n / 104.0) * (n > 500) + 100.0 * noise());
+      int32_t expected = lroundf(bank.update(axis, x * scale, 1.0f / 104.0f) / scale);
+      int32_t difference = abs(expected - bankQ15.update(axis, x, 9615));
+
+      if(difference > maxDifference) {
+        maxDifference = difference;
+      }
+    }
+
+    EXPECT_LE(maxDifference, 4) << (int)axis;
+  }
+}
+
+/**
+ * Benchmarks: the cost of filtering one sample, against the exponential moving average the wand has used.
+ * The ESP32 figures come from the wand itself, which reports the cycles spent filtering each sample.
+ */
+template <typename Step>
+static void benchmark(const char* name, Step step) {
+  const uint32_t samples = 2000000;
+  volatile float sink = 0.0f;
+  int16_t input[256];
+
+  for(uint16_t i = 0; i < 256; i++) {
+    input[i] = (int16_t)(8000.0 * sin(i * 0.1) + 300.0 * noise());
+  }
+
+  auto start = std::chrono::steady_clock::now();
+#if defined(HAS_CYCLE_COUNTER)
+  uint64_t cycles = __rdtsc();
+#endif
+
+  for(uint32_t n = 0; n < samples; n++) {
+    sink = sink + step(input[n & 0xFF]);
+  }
+
+#if defined(HAS_CYCLE_COUNTER)
+  cycles = __rdtsc() - cycles;
+  printf("[          ] %-20s: %5.1f ns/sample, %5.1f cycles/sample\n", name,
+         std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count() / samples,
+         (double)cycles / samples);
+#else
+  printf("[          ] %-20s: %5.1f ns/sample\n", name,
+         std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count() / samples);
+#endif
+}
+
+TEST(MotionFilterBenchmark, CyclesPerSample) {
+  BiquadCoefficients c;
+  BiquadCoefficientsQ14 fixed;
+  biquadLowPass(10.0f, 104.0f, 0.7071f, c);
+  biquadToQ14(c, fixed);
+
+  float ema = 0.0f;
+  BiquadFilter lowPass;
+  BiquadFilterQ15 lowPassQ15;
+  OneEuroFilter oneEuro;
+  OneEuroFilterQ15 oneEuroQ15;
+
+  lowPass.setCoefficients(c);
+  lowPassQ15.setCoefficients(fixed);
+  oneEuro.setParams(1.0f, 0.05f, 1.0f);
+  oneEuroQ15.setParams(1.0f, 0.05f * 0.0006f, 1.0f);
+  srand(4901);
+
+  benchmark("EMA (FILTER_ALPHA)", [&](int16_t x) { ema = 0.4f * x + 0.6f * ema; return ema; });
+  benchmark("biquad float", [&](int16_t x) { return lowPass.update(x); });
+  benchmark("biquad Q15", [&](int16_t x) { return (float)lowPassQ15.update(x); });
+  benchmark("one-euro float", [&](int16_t x) { return oneEuro.update(x, 0.009615f); });
+  benchmark("one-euro Q15", [&](int16_t x) { return (float)oneEuroQ15.update(x, 9615); });
+}
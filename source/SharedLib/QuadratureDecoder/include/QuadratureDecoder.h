@@ -0,0 +1,77 @@
+/**
+ *   QuadratureDecoder - Rotary encoder quadrature decoding for GPStar devices.
+ *   Turns A/B pin transitions or hardware counts into whole detents without losing steps.
+ *   Copyright (C) 2023-2026 Michael Rajotte, Dustin Grau, Nomake Wan
+ *
+ *   This program is free software; you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation; either version 3 of the License, or
+ *   (at your option) any later version.
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License
+ *   along with this program; if not, see <https://www.gnu.org/licenses/>.
+ *
+ */
+
+#pragma once
+
+// Standard library includes for integer type definitions
+#include <stdint.h>  // Provides uint8_t, int16_t, etc.
+#include <stdbool.h> // Provides bool type definition.
+
+// Quadrature counts for one detent of a typical mechanical encoder.
+#define QUADRATURE_COUNTS_PER_DETENT 4
+
+/**
+ * Class: QuadratureDecoder
+ * Purpose: Accumulates quadrature counts and hands them out as whole detents.
+ *
+ * Counts come either from pin transitions passed to update(), which is cheap enough to call from
+ * a pin interrupt, or from a hardware counter via addCounts(). The main loop then consumes whole
+ * detents with takeDetents(), and any partial detent is carried over so no steps are lost.
+ * Contact bounce produces matching forward and backward counts, which cancel out.
+ *
+ * Clockwise rotation is positive, where B leads A (BA: 00 -> 10 -> 11 -> 01 -> 00).
+ *
+ * When update() is called from an interrupt the caller must disable interrupts around
+ * takeDetents(), as the count is read and written as a pair of bytes on 8-bit devices.
+ *
+ * Example usage:
+ *   QuadratureDecoder volumeKnob;
+ *   void onEncoderChange() { volumeKnob.update(digitalRead(PIN_A), digitalRead(PIN_B)); }
+ *   noInterrupts(); int16_t i_steps = volumeKnob.takeDetents(); interrupts();
+ */
+class QuadratureDecoder {
+public:
+  QuadratureDecoder(uint8_t countsPerDetent = QUADRATURE_COUNTS_PER_DETENT);
+
+  // Sets the current pin levels without counting, eg. after configuring the pins.
+  void begin(uint8_t a, uint8_t b);
+
+  // Processes the current pin levels. Returns the counts added (-2 to 2).
+  int8_t update(uint8_t a, uint8_t b);
+
+  // Adds counts read from a hardware counter.
+  void addCounts(int16_t counts);
+
+  // Returns the whole detents turned since the last call (positive is clockwise).
+  int16_t takeDetents();
+
+  // Counts which do not yet make up a whole detent.
+  int16_t getPendingCounts() const;
+
+  // Number of transitions where both pins changed at once, meaning one state was missed.
+  uint16_t getSkippedCount() const;
+
+private:
+  uint8_t countsPerDetent;
+  uint8_t state;      // Last pin levels as (B << 1) | A.
+  int8_t direction;   // Direction of the last valid transition, used to recover a missed state.
+  int16_t counts;
+  uint16_t skipped;
+};
@@ -0,0 +1,82 @@
+/**
+ *   QuadratureDecoder - Rotary encoder quadrature decoding for GPStar devices.
+ *   Turns A/B pin transitions or hardware counts into whole detents without losing steps.
+ *   Copyright (C) 2023-2026 Michael Rajotte, Dustin Grau, Nomake Wan
+ *
+ *   This program is free software; you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation; either version 3 of the License, or
+ *   (at your option) any later version.
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License
+ *   along with this program; if not, see <https://www.gnu.org/licenses/>.
+ *
+ */
+
+// Library Header
+#include "QuadratureDecoder.h"
+
+// Marks a transition where both pins changed.
+#define QUADRATURE_SKIP 2
+
+// Counts for each transition, indexed by (previous state << 2) | new state.
+static const int8_t quadrature_table[16] = {
+   0, -1,  1,  QUADRATURE_SKIP, // From 00
+   1,  0,  QUADRATURE_SKIP, -1, // From 01
+  -1,  QUADRATURE_SKIP,  0,  1, // From 10
+   QUADRATURE_SKIP,  1, -1,  0  // From 11
+};
+
+QuadratureDecoder::QuadratureDecoder(uint8_t countsPerDetent)
+  : countsPerDetent(countsPerDetent > 0 ? countsPerDetent : 1), state(0), direction(0), counts(0), skipped(0) {
+}
+
+void QuadratureDecoder::begin(uint8_t a, uint8_t b) {
+  state = ((b ? 1 : 0) << 1) | (a ? 1 : 0);
+}
+
+int8_t QuadratureDecoder::update(uint8_t a, uint8_t b) {
+  uint8_t next = ((b ? 1 : 0) << 1) | (a ? 1 : 0);
+  int8_t delta = quadrature_table[(state << 2) | next];
+
+  state = next;
+
+  if(delta == QUADRATURE_SKIP) {
+    // One state was missed, so assume the knob kept turning the same way.
+    skipped++;
+    delta = direction * 2;
+  }
+  else if(delta != 0) {
+    direction = delta;
+  }
+
+  counts += delta;
+
+  return delta;
+}
+
+void QuadratureDecoder::addCounts(int16_t added) {
+  counts += added;
+}
+
+int16_t QuadratureDecoder::takeDetents() {
+  // Division truncates towards zero, so a partial detent in either direction is kept.
+  int16_t detents = counts / countsPerDetent;
+
+  counts -= detents * countsPerDetent;
+
+  return detents;
+}
+
+int16_t QuadratureDecoder::getPendingCounts() const {
+  return counts;
+}
+
+uint16_t QuadratureDecoder::getSkippedCount() const {
+  return skipped;
+}
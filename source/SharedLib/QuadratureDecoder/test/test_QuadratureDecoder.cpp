@@ -0,0 +1,190 @@
+/**
+ * Test suite for the rotary encoder quadrature decoder.
+ */
+
+#include <gtest/gtest.h>
+#include "QuadratureDecoder.h"
+#include <stdio.h>
+
+// Pin states (B << 1 | A) in clockwise order. A detent rests with both pins high (index 2).
+static const uint8_t cw_states[4] = {0, 2, 3, 1};
+
+// Simulated encoder with a physical position measured in quadrature counts.
+struct SimulatedEncoder {
+    int32_t position = 2; // Resting on a detent.
+
+    uint8_t state() const { return cw_states[((position % 4) + 4) % 4]; }
+    uint8_t a() const { return state() & 0x01; }
+    uint8_t b() const { return (state() >> 1) & 0x01; }
+};
+
+// The original polled decoder from the Proton Pack, kept as a reference.
+struct LegacyDecoder {
+    uint8_t prev_next_code = 0;
+    uint16_t store = 0;
+
+    int8_t read(uint8_t a, uint8_t b) {
+        static const int8_t rot_enc_table[] = {0,1,1,0,1,0,0,1,1,0,0,1,0,1,1,0};
+
+        prev_next_code <<= 2;
+        if(b) { prev_next_code |= 0x02; }
+        if(a) { prev_next_code |= 0x01; }
+        prev_next_code &= 0x0f;
+
+        if(rot_enc_table[prev_next_code]) {
+            store <<= 4;
+            store |= prev_next_code;
+            if((store & 0xff) == 0x2b) { return 1; }  // Clockwise, which increased the volume.
+            if((store & 0xff) == 0x17) { return -1; } // Counter-clockwise.
+        }
+        return 0;
+    }
+};
+
+// Test fixture with an encoder resting on a detent.
+class QuadratureDecoderFixture : public ::testing::Test {
+protected:
+    SimulatedEncoder encoder;
+    QuadratureDecoder decoder;
+
+    // SetUp() is called before each test.
+    void SetUp() override {
+        decoder.begin(encoder.a(), encoder.b());
+    }
+
+    // Moves the encoder one count and reports every edge, as a pin interrupt would.
+    void step(int8_t direction) {
+        encoder.position += direction;
+        decoder.update(encoder.a(), encoder.b());
+    }
+};
+
+TEST_F(QuadratureDecoderFixture, CanInstantiate) {
+    EXPECT_EQ(decoder.takeDetents(), 0);
+    EXPECT_EQ(decoder.getPendingCounts(), 0);
+    EXPECT_EQ(decoder.getSkippedCount(), 0);
+}
+
+// One full quadrature cycle is one detent, with clockwise as positive.
+TEST_F(QuadratureDecoderFixture, FullCycleIsOneDetent) {
+    for(uint8_t i = 0; i < 3; i++) {
+        step(1);
+    }
+    EXPECT_EQ(decoder.takeDetents(), 0);
+    step(1);
+    EXPECT_EQ(decoder.takeDetents(), 1);
+
+    for(uint8_t i = 0; i < 8; i++) {
+        step(-1);
+    }
+    EXPECT_EQ(decoder.takeDetents(), -2);
+    EXPECT_EQ(decoder.getPendingCounts(), 0);
+}
+
+// Contact bounce on an edge cancels itself out.
+TEST_F(QuadratureDecoderFixture, BounceCancels) {
+    step(1);
+    for(uint8_t i = 0; i < 5; i++) {
+        step(1);
+        step(-1);
+    }
+    step(1);
+    step(1);
+    step(1);
+
+    EXPECT_EQ(decoder.takeDetents(), 1);
+    EXPECT_EQ(decoder.getSkippedCount(), 0);
+}
+
+// Partial detents are carried into the next call rather than dropped.
+TEST_F(QuadratureDecoderFixture, PartialDetentsCarryOver) {
+    decoder.addCounts(6);
+    EXPECT_EQ(decoder.takeDetents(), 1);
+    EXPECT_EQ(decoder.getPendingCounts(), 2);
+    decoder.addCounts(-11);
+    EXPECT_EQ(decoder.takeDetents(), -2);
+    EXPECT_EQ(decoder.getPendingCounts(), -1);
+    decoder.addCounts(5);
+    EXPECT_EQ(decoder.takeDetents(), 1);
+}
+
+// A missed state is recovered by assuming the knob kept turning the same way.
+TEST_F(QuadratureDecoderFixture, RecoversSingleMissedState) {
+    step(1);
+    encoder.position += 2; // Both pins change between samples.
+    decoder.update(encoder.a(), encoder.b());
+    step(1);
+
+    EXPECT_EQ(decoder.getSkippedCount(), 1);
+    EXPECT_EQ(decoder.takeDetents(), 1);
+}
+
+// Spins at speeds from 1 to 40 detents per second with every edge reported (pin interrupt or
+// hardware counter), while the main loop only reads detents every 25ms. No steps may be lost.
+TEST_F(QuadratureDecoderFixture, InterruptDrivenLosesNoSteps) {
+    int32_t total = 0;
+    int32_t expected = 0;
+    uint32_t seed = 4321;
+
+    for(uint8_t speed = 1; speed <= 40; speed++) {
+        int8_t direction = (speed & 1) ? 1 : -1;
+        uint32_t edgeInterval = 1000000UL / (speed * 4); // Microseconds between edges.
+        uint32_t now = 0;
+        uint32_t nextEdge = 0;
+        int32_t edges = speed * 4 * 2; // Two seconds of turning.
+
+        while(edges > 0) {
+            if(now >= nextEdge) {
+                step(direction);
+                expected += direction;
+                edges--;
+
+                // Vary each edge by up to +/-25% as a hand would.
+                seed = seed * 1103515245UL + 12345UL;
+                nextEdge += edgeInterval - edgeInterval / 4 + ((seed >> 16) % (edgeInterval / 2 + 1));
+            }
+            if(now % 25000 == 0) {
+                total += decoder.takeDetents();
+            }
+            now += 100;
+        }
+    }
+    total += decoder.takeDetents();
+
+    EXPECT_EQ(total * 4, expected);
+    EXPECT_EQ(decoder.getSkippedCount(), 0);
+}
+
+// Compares reading the pins once per loop with the new and legacy decoders, as the main loop
+// slows from 2ms to 24ms per pass while the knob turns at 20 detents per second (12.5ms per edge).
+// Once a pass takes longer than an edge a state is sometimes missed, which the legacy decoder
+// drops while the new decoder recovers it. Counts are printed for reference.
+TEST_F(QuadratureDecoderFixture, PolledComparedToLegacy) {
+    const uint32_t edgeInterval = 12500; // Microseconds.
+
+    for(uint32_t loopTime = 2000; loopTime <= 24000; loopTime += 2000) {
+        SimulatedEncoder knob;
+        QuadratureDecoder polled;
+        LegacyDecoder legacy;
+        int32_t polledDetents = 0;
+        int32_t legacyDetents = 0;
+
+        polled.begin(knob.a(), knob.b());
+        legacy.read(knob.a(), knob.b());
+        legacy.read(knob.a(), knob.b());
+
+        for(uint32_t now = 0; now < 4000000UL; now += loopTime) {
+            knob.position = 2 + now / edgeInterval;
+            polled.update(knob.a(), knob.b());
+            polledDetents += polled.takeDetents();
+            legacyDetents += legacy.read(knob.a(), knob.b());
+        }
+
+        int32_t turned = (knob.position - 2) / 4;
+        printf("[          ] %2lums loop: turned %ld, polled %ld, legacy %ld\n", (unsigned long)(loopTime / 1000),
+               (long)turned, (long)polledDetents, (long)legacyDetents);
+
+        EXPECT_NEAR(polledDetents, turned, 1) << "loop time " << loopTime;
+        EXPECT_LE(legacyDetents, turned);
+    }
+}
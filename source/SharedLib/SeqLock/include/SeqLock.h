@@ -0,0 +1,125 @@
+/**
+ *   SeqLock - Lock-free hand-off of the latest value from one task to another for GPStar devices.
+ *   Copyright (C) 2023-2026 Michael Rajotte, Dustin Grau, Nomake Wan
+ *
+ *   This program is free software; you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation; either version 3 of the License, or
+ *   (at your option) any later version.
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License
+ *   along with this program; if not, see <https://www.gnu.org/licenses/>.
+ *
+ */
+
+#pragma once
+
+// Standard library includes for integer type definitions
+#include <stdint.h>  // Provides uint8_t, uint32_t, etc.
+#include <stdbool.h> // Provides bool type definition.
+#include <string.h>  // Provides memcpy.
+#include <atomic>
+#include <type_traits>
+
+// Times read() goes over the value again when the writer was part way through publishing it.
+#define SEQLOCK_READ_ATTEMPTS 4
+
+/**
+ * Class: SeqLock
+ * Purpose: Passes the latest value of T from a single writer to any number of readers, neither ever waiting.
+ *
+ * The writer bumps the sequence to an odd number, stores the value and bumps it to even again. A reader
+ * copies the value between two loads of the sequence and keeps the copy only if both were the same even
+ * number, so a torn copy is never returned. Only the newest value is kept: readers which fall behind skip
+ * to it, so anything which must not be missed (eg. a count of events) belongs in the value itself.
+ *
+ * The value is held as 32-bit words which are each loaded and stored atomically, so T must be trivially
+ * copyable. Writing takes the same time whatever the readers do, which suits a sensor task with a fixed
+ * period; a reader gives up after SEQLOCK_READ_ATTEMPTS and keeps what it already had.
+ *
+ * Example usage:
+ *   SeqLock<MotionResults> motionExchange;
+ *   motionExchange.publish(results); // In the writing task.
+ *   if(motionExchange.read(latest)) { ... } // Anywhere else.
+ */
+template <typename T>
+class SeqLock {
+  static_assert(std::is_trivially_copyable<T>::value, "SeqLock values are copied word by word");
+
+public:
+  SeqLock() : sequence(0), retries(0) {
+    for(uint8_t i = 0; i < WORDS; i++) {
+      words[i].store(0, std::memory_order_relaxed);
+    }
+  }
+
+  // Stores a new value. Must only ever be called from one task.
+  void publish(const T& value) {
+    uint32_t buffer[WORDS] = {};
+    uint32_t current = sequence.load(std::memory_order_relaxed);
+
+    memcpy(buffer, &value, sizeof(T));
+
+    sequence.store(current + 1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+
+    for(uint8_t i = 0; i < WORDS; i++) {
+      words[i].store(buffer[i], std::memory_order_relaxed);
+    }
+
+    sequence.store(current + 2, std::memory_order_release);
+  }
+
+  // Copies the latest value. Returns false, leaving value alone, if nothing has been published
+  // or every attempt overlapped a publish.
+  bool read(T& value) const {
+    uint32_t buffer[WORDS];
+
+    for(uint8_t attempt = 0; attempt < SEQLOCK_READ_ATTEMPTS; attempt++) {
+      uint32_t before = sequence.load(std::memory_order_acquire);
+
+      if(before == 0) {
+        return false;
+      }
+
+      if((before & 0x01) == 0) {
+        for(uint8_t i = 0; i < WORDS; i++) {
+          buffer[i] = words[i].load(std::memory_order_relaxed);
+        }
+
+        std::atomic_thread_fence(std::memory_order_acquire);
+
+        if(sequence.load(std::memory_order_relaxed) == before) {
+          memcpy(&value, buffer, sizeof(T));
+          return true;
+        }
+      }
+
+      retries.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    return false;
+  }
+
+  // Values published so far, so a reader can tell whether anything is new.
+  uint32_t getVersion() const {
+    return sequence.load(std::memory_order_acquire) >> 1;
+  }
+
+  // Read attempts which overlapped a publish and had to start again.
+  uint32_t getRetries() const {
+    return retries.load(std::memory_order_relaxed);
+  }
+
+private:
+  static const uint8_t WORDS = (sizeof(T) + sizeof(uint32_t) - 1) / sizeof(uint32_t);
+
+  std::atomic<uint32_t> sequence;
+  std::atomic<uint32_t> words[WORDS];
+  mutable std::atomic<uint32_t> retries;
+};
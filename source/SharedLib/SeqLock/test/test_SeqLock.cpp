@@ -0,0 +1,113 @@
+#include <gtest/gtest.h>
+#include <stdint.h>
+#include <atomic>
+#include <thread>
+#include "SeqLock.h"
+
+// Shaped like the wand's motion results: floats, a counter and a flag, not a multiple of 4 bytes.
+struct Reading {
+  float values[12];
+  uint32_t count;
+  bool flag;
+};
+
+static Reading makeReading(uint32_t count) {
+  Reading reading = {};
+
+  for(uint8_t i = 0; i < 12; i++) {
+    reading.values[i] = (float)(count * 12 + i);
+  }
+
+  reading.count = count;
+  reading.flag = (count % 2) == 1;
+  return reading;
+}
+
+// Every field is derived from the count, so a copy torn between two publishes fails this.
+static bool isWhole(const Reading& reading) {
+  for(uint8_t i = 0; i < 12; i++) {
+    if(reading.values[i] != (float)(reading.count * 12 + i)) {
+      return false;
+    }
+  }
+
+  return reading.flag == ((reading.count % 2) == 1);
+}
+
+TEST(SeqLockTest, NothingBeforeFirstPublish) {
+  SeqLock<Reading> lock;
+  Reading reading = makeReading(7);
+
+  EXPECT_FALSE(lock.read(reading));
+  EXPECT_EQ(7u, reading.count); // Left alone.
+  EXPECT_EQ(0u, lock.getVersion());
+}
+
+TEST(SeqLockTest, ReadsLatestValue) {
+  SeqLock<Reading> lock;
+  Reading reading;
+
+  lock.publish(makeReading(1));
+  lock.publish(makeReading(2));
+  lock.publish(makeReading(3));
+
+  EXPECT_EQ(3u, lock.getVersion());
+  ASSERT_TRUE(lock.read(reading));
+  EXPECT_EQ(3u, reading.count);
+  EXPECT_TRUE(isWhole(reading));
+
+  // Reading does not consume the value.
+  ASSERT_TRUE(lock.read(reading));
+  EXPECT_EQ(3u, reading.count);
+  EXPECT_EQ(0u, lock.getRetries());
+}
+
+TEST(SeqLockTest, SmallValues) {
+  SeqLock<uint8_t> byteLock;
+  uint8_t value = 0;
+
+  byteLock.publish(0xA5);
+  ASSERT_TRUE(byteLock.read(value));
+  EXPECT_EQ(0xA5, value);
+}
+
+TEST(SeqLockTest, ConcurrentReadsAreNeverTorn) {
+  SeqLock<Reading> lock;
+  std::atomic<bool> done(false);
+  const uint32_t publishes = 200000;
+
+  std::thread writer([&]() {
+    for(uint32_t count = 1; count <= publishes; count++) {
+      lock.publish(makeReading(count));
+    }
+
+    done = true;
+  });
+
+  uint32_t reads = 0;
+  uint32_t last = 0;
+  bool whole = true;
+  bool ordered = true;
+
+  while(!done || reads == 0) {
+    Reading reading;
+
+    if(lock.read(reading)) {
+      whole = whole && isWhole(reading);
+      ordered = ordered && reading.count >= last;
+      last = reading.count;
+      reads++;
+    }
+  }
+
+  writer.join();
+
+  EXPECT_TRUE(whole);
+  EXPECT_TRUE(ordered);
+  EXPECT_GT(reads, 0u);
+
+  Reading reading;
+  ASSERT_TRUE(lock.read(reading));
+  EXPECT_EQ(publishes, reading.count);
+  EXPECT_EQ(publishes, lock.getVersion());
+}
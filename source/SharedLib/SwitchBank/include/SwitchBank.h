@@ -0,0 +1,151 @@
+/**
+ *   SwitchBank - Debounces a bank of switches together using vertical counters for GPStar devices.
+ *   Samples every switch at once and reports debounced states and edges as bitmasks.
+ *   Copyright (C) 2023-2026 Michael Rajotte, Dustin Grau, Nomake Wan
+ *
+ *   This program is free software; you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation; either version 3 of the License, or
+ *   (at your option) any later version.
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License
+ *   along with this program; if not, see <https://www.gnu.org/licenses/>.
+ *
+ */
+
+#pragma once
+
+// Standard library includes for integer type definitions
+#include <stdint.h>  // Provides uint8_t, uint16_t, etc.
+#include <stdbool.h> // Provides bool type definition.
+
+#if defined(ARDUINO)
+  #include <Arduino.h>
+#endif
+
+// Maximum number of switches in one bank (one bit each).
+#define SWITCH_BANK_MAX_SWITCHES 16
+
+// Maximum number of distinct input port registers read by one bank.
+#define SWITCH_BANK_MAX_PORTS 6
+
+// Consecutive matching samples needed to accept a change (fixed by the 2-bit vertical counter).
+#define SWITCH_BANK_SAMPLES 4
+
+// One bit per switch, where bit n is the switch attached as n.
+typedef uint16_t SwitchMask;
+
+#if defined(ESP32)
+  typedef uint32_t SwitchPortValue; // GPIO input registers are 32 bits wide.
+#else
+  typedef uint8_t SwitchPortValue;  // AVR PINx registers are 8 bits wide.
+#endif
+
+/**
+ * Class: SwitchBank
+ * Purpose: Debounces up to 16 switches with one set of bitwise operations per sample.
+ *
+ * Each switch has a 2-bit counter stored "vertically" across two masks, so all switches are
+ * counted at once. A switch changes state only after SWITCH_BANK_SAMPLES consecutive samples
+ * differ from its debounced state, and any sample which matches resets its counter. With the
+ * default debounce time of 50ms a sample is taken every 12ms.
+ *
+ * States are "active" bits, where 1 means the switch is closed (the pin is pulled LOW). Edges are
+ * reported for one update() only, the same as isPressed()/isReleased() of a polled button.
+ *
+ * On Arduino targets pins can be attached directly, and readPins() reads each distinct port
+ * register once (PINx on the ATMega, GPIO_IN/GPIO_IN1 on the ESP32) rather than calling
+ * digitalRead() for each switch. Otherwise the raw states can be passed to update() directly.
+ *
+ * Example usage:
+ *   SwitchBank switches;
+ *   switches.attachPin(0, POWER_SWITCH_PIN);
+ *   switches.begin();
+ *   switches.update(millis()); // In the main loop.
+ *   if(switches.getPressed() & 0x01) { powerOn(); }
+ */
+class SwitchBank {
+public:
+  SwitchBank();
+
+  // Sets the time a change must be stable for before it is accepted (default 50ms).
+  void setDebounceTime(uint16_t debounceTime);
+  uint16_t getSampleInterval() const;
+
+  // Accepts the given raw states as already debounced, without reporting any edges.
+  void begin(SwitchMask raw);
+
+  // Samples the raw states when the interval has elapsed, and clears edges from the previous update.
+  // Returns true if any switch changed state.
+  bool update(uint32_t now, SwitchMask raw);
+
+  // Processes one raw sample immediately. Returns true if any switch changed state.
+  bool sample(SwitchMask raw);
+
+  SwitchMask getState() const;    // Debounced states, 1 = active.
+  SwitchMask getPressed() const;  // Switches which became active on the last update.
+  SwitchMask getReleased() const; // Switches which became inactive on the last update.
+
+  bool isActive(uint8_t index) const;
+  bool isPressed(uint8_t index) const;
+  bool isReleased(uint8_t index) const;
+
+#if defined(ARDUINO)
+  // Configures a pin as INPUT_PULLUP and assigns it to the given switch index (active LOW).
+  // Returns false if the index or the number of distinct ports is out of range.
+  bool attachPin(uint8_t index, uint8_t pin);
+
+  // Accepts the current pin states as already debounced.
+  void begin();
+
+  // As update() above, reading the attached pins only when a sample is due.
+  bool update(uint32_t now);
+
+  // Reads all attached pins with one read per port register.
+  SwitchMask readPins() const;
+#endif
+
+private:
+  bool due(uint32_t now);
+
+  SwitchMask state;
+  SwitchMask count0;  // Low bit of each switch's counter.
+  SwitchMask count1;  // High bit of each switch's counter.
+  SwitchMask pressed;
+  SwitchMask released;
+  uint16_t sampleInterval;
+  uint32_t lastSample;
+  bool sampled;       // Whether lastSample holds a valid time.
+
+#if defined(ARDUINO)
+  volatile SwitchPortValue* ports[SWITCH_BANK_MAX_PORTS];
+  SwitchPortValue pinMasks[SWITCH_BANK_MAX_SWITCHES];
+  uint8_t pinPorts[SWITCH_BANK_MAX_SWITCHES];
+  SwitchMask attached;
+  uint8_t portCount;
+#endif
+};
+
+/**
+ * Class: SwitchBankButton
+ * Purpose: A view of one switch in a bank, with the same calls as a single polled button.
+ *
+ * getState() returns the pin level, which is 0 (LOW) while the switch is active.
+ */
+class SwitchBankButton {
+public:
+  SwitchBankButton(const SwitchBank& bank, uint8_t index) : bank(bank), bit((SwitchMask)1 << index) {}
+
+  uint8_t getState() const { return (bank.getState() & bit) ? 0 : 1; }
+  bool isPressed() const { return bank.getPressed() & bit; }
+  bool isReleased() const { return bank.getReleased() & bit; }
+
+private:
+  const SwitchBank& bank;
+  SwitchMask bit;
+};
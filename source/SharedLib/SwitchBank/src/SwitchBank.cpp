@@ -0,0 +1,166 @@
+/**
+ *   SwitchBank - Debounces a bank of switches together using vertical counters for GPStar devices.
+ *   Samples every switch at once and reports debounced states and edges as bitmasks.
+ *   Copyright (C) 2023-2026 Michael Rajotte, Dustin Grau, Nomake Wan
+ *
+ *   This program is free software; you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation; either version 3 of the License, or
+ *   (at your option) any later version.
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License
+ *   along with this program; if not, see <https://www.gnu.org/licenses/>.
+ *
+ */
+
+// Library Header
+#include "SwitchBank.h"
+
+SwitchBank::SwitchBank()
+  : state(0), count0(0), count1(0), pressed(0), released(0), lastSample(0), sampled(false) {
+  setDebounceTime(50);
+
+#if defined(ARDUINO)
+  attached = 0;
+  portCount = 0;
+#endif
+}
+
+void SwitchBank::setDebounceTime(uint16_t debounceTime) {
+  sampleInterval = debounceTime / SWITCH_BANK_SAMPLES;
+}
+
+uint16_t SwitchBank::getSampleInterval() const {
+  return sampleInterval;
+}
+
+void SwitchBank::begin(SwitchMask raw) {
+  state = raw;
+  count0 = 0;
+  count1 = 0;
+  pressed = 0;
+  released = 0;
+}
+
+bool SwitchBank::due(uint32_t now) {
+  pressed = 0;
+  released = 0;
+
+  if(sampled && now - lastSample < sampleInterval) {
+    return false;
+  }
+
+  lastSample = now;
+  sampled = true;
+
+  return true;
+}
+
+bool SwitchBank::update(uint32_t now, SwitchMask raw) {
+  return due(now) && sample(raw);
+}
+
+bool SwitchBank::sample(SwitchMask raw) {
+  // Switches which differ from their debounced state count up, while any which match are reset.
+  // The counter runs 0 -> 1 -> 2 -> 3 -> 0, and the state toggles when it wraps back to 0.
+  SwitchMask delta = raw ^ state;
+
+  count1 = (count1 ^ count0) & delta;
+  count0 = ~count0 & delta;
+
+  SwitchMask toggle = delta & ~(count0 | count1);
+
+  state ^= toggle;
+  pressed = toggle & state;
+  released = toggle & ~state;
+
+  return toggle != 0;
+}
+
+SwitchMask SwitchBank::getState() const {
+  return state;
+}
+
+SwitchMask SwitchBank::getPressed() const {
+  return pressed;
+}
+
+SwitchMask SwitchBank::getReleased() const {
+  return released;
+}
+
+bool SwitchBank::isActive(uint8_t index) const {
+  return (state >> index) & 1;
+}
+
+bool SwitchBank::isPressed(uint8_t index) const {
+  return (pressed >> index) & 1;
+}
+
+bool SwitchBank::isReleased(uint8_t index) const {
+  return (released >> index) & 1;
+}
+
+#if defined(ARDUINO)
+bool SwitchBank::attachPin(uint8_t index, uint8_t pin) {
+  if(index >= SWITCH_BANK_MAX_SWITCHES) {
+    return false;
+  }
+
+  volatile SwitchPortValue* port = (volatile SwitchPortValue*)portInputRegister(digitalPinToPort(pin));
+  uint8_t portIndex = 0;
+
+  // Share the read of any port which is already used by another switch.
+  while(portIndex < portCount && ports[portIndex] != port) {
+    portIndex++;
+  }
+
+  if(portIndex == portCount) {
+    if(portCount >= SWITCH_BANK_MAX_PORTS) {
+      return false;
+    }
+
+    ports[portCount++] = port;
+  }
+
+  pinMode(pin, INPUT_PULLUP);
+
+  pinPorts[index] = portIndex;
+  pinMasks[index] = (SwitchPortValue)digitalPinToBitMask(pin);
+  attached |= (SwitchMask)1 << index;
+
+  return true;
+}
+
+bool SwitchBank::update(uint32_t now) {
+  // Only read the pins when a sample is due.
+  return due(now) && sample(readPins());
+}
+
+void SwitchBank::begin() {
+  begin(readPins());
+}
+
+SwitchMask SwitchBank::readPins() const {
+  SwitchPortValue values[SWITCH_BANK_MAX_PORTS];
+  SwitchMask raw = 0;
+
+  for(uint8_t i = 0; i < portCount; i++) {
+    values[i] = *ports[i];
+  }
+
+  for(uint8_t i = 0; i < SWITCH_BANK_MAX_SWITCHES; i++) {
+    // Pins use pull-ups, so a LOW reading is an active switch.
+    if(((attached >> i) & 1) && !(values[pinPorts[i]] & pinMasks[i])) {
+      raw |= (SwitchMask)1 << i;
+    }
+  }
+
+  return raw;
+}
+#endif
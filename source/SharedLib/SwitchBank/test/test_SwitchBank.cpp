@@ -0,0 +1,263 @@
+/**
+ * Test suite for the vertical-counter switch bank.
+ */
+
+#include <gtest/gtest.h>
+#include "SwitchBank.h"
+#include <chrono>
+#include <stdio.h>
+#include <vector>
+
+// Test fixture with every switch starting inactive.
+class SwitchBankFixture : public ::testing::Test {
+protected:
+    SwitchBank bank;
+
+    // SetUp() is called before each test.
+    void SetUp() override {
+        bank.begin(0);
+    }
+
+    // Feeds the same raw sample several times, returning the number of samples which changed state.
+    uint8_t feed(SwitchMask raw, uint8_t samples) {
+        uint8_t changes = 0;
+        for(uint8_t i = 0; i < samples; i++) {
+            changes += bank.sample(raw) ? 1 : 0;
+        }
+        return changes;
+    }
+};
+
+TEST_F(SwitchBankFixture, CanInstantiate) {
+    EXPECT_EQ(bank.getState(), 0);
+    EXPECT_EQ(bank.getPressed(), 0);
+    EXPECT_EQ(bank.getReleased(), 0);
+    EXPECT_EQ(bank.getSampleInterval(), 12);
+}
+
+// A change is accepted on the fourth consecutive sample and reported as one edge.
+TEST_F(SwitchBankFixture, AcceptsAfterFourSamples) {
+    EXPECT_EQ(feed(0x0001, 3), 0);
+    EXPECT_FALSE(bank.isActive(0));
+
+    EXPECT_TRUE(bank.sample(0x0001));
+    EXPECT_TRUE(bank.isActive(0));
+    EXPECT_TRUE(bank.isPressed(0));
+    EXPECT_FALSE(bank.isReleased(0));
+
+    // The edge is only reported once.
+    EXPECT_FALSE(bank.sample(0x0001));
+    EXPECT_FALSE(bank.isPressed(0));
+
+    EXPECT_EQ(feed(0x0000, 4), 1);
+    EXPECT_FALSE(bank.isActive(0));
+}
+
+// Releases are reported the same way as presses.
+TEST_F(SwitchBankFixture, ReportsReleases) {
+    bank.begin(0x0004);
+    EXPECT_EQ(feed(0x0000, 3), 0);
+    EXPECT_TRUE(bank.sample(0x0000));
+    EXPECT_TRUE(bank.isReleased(2));
+    EXPECT_EQ(bank.getReleased(), 0x0004);
+}
+
+// Bounce shorter than four samples never changes the state, however long it continues.
+TEST_F(SwitchBankFixture, IgnoresBounce) {
+    for(uint8_t i = 0; i < 50; i++) {
+        EXPECT_EQ(feed(0x0001, 3), 0);
+        EXPECT_EQ(feed(0x0000, 1), 0);
+    }
+    EXPECT_EQ(bank.getState(), 0);
+
+    // Bounce then a stable press: accepted four samples after the last bounce.
+    feed(0x0001, 2);
+    feed(0x0000, 1);
+    EXPECT_EQ(feed(0x0001, 3), 0);
+    EXPECT_TRUE(bank.sample(0x0001));
+}
+
+// Each switch keeps its own counter, so different switches settle independently.
+TEST_F(SwitchBankFixture, SwitchesAreIndependent) {
+    bank.sample(0x0001);
+    bank.sample(0x0001);
+    bank.sample(0x0003); // Switch 1 starts two samples after switch 0.
+    EXPECT_TRUE(bank.sample(0x0003));
+    EXPECT_EQ(bank.getPressed(), 0x0001);
+    EXPECT_FALSE(bank.sample(0x0003));
+    EXPECT_TRUE(bank.sample(0x8003));
+    EXPECT_EQ(bank.getPressed(), 0x0002);
+
+    // Simultaneous changes on many switches are reported in one edge mask.
+    bank.begin(0x0000);
+    EXPECT_EQ(feed(0xA5A5, 4), 1);
+    EXPECT_EQ(bank.getPressed(), 0xA5A5);
+    EXPECT_EQ(bank.getState(), 0xA5A5);
+}
+
+// update() samples only once per interval and clears edges on every call.
+TEST_F(SwitchBankFixture, UpdateSamplesAtInterval) {
+    bank.setDebounceTime(40); // Sample every 10ms.
+    uint32_t now = 1000;
+    uint32_t pressedAt = 0;
+
+    // The switch closes at 1000ms and stays closed, with the loop running every 1ms.
+    for(; now < 1100; now++) {
+        if(bank.update(now, 0x0001)) {
+            pressedAt = now;
+            EXPECT_TRUE(bank.isPressed(0));
+        }
+        else {
+            EXPECT_FALSE(bank.isPressed(0));
+        }
+    }
+
+    // Samples at 1000, 1010, 1020 and 1030, so the press is accepted 30ms after the first sample.
+    EXPECT_EQ(pressedAt, 1030u);
+
+    // Handles the rollover of millis().
+    bank.begin(0);
+    pressedAt = 0;
+    for(now = 0xFFFFFFF0UL; now != 0x40; now++) {
+        if(bank.update(now, 0x0001)) {
+            pressedAt = now;
+        }
+    }
+    EXPECT_EQ(pressedAt, 0x0EUL);
+}
+
+// The per-switch view matches the calls made on a single polled button.
+TEST_F(SwitchBankFixture, ButtonViewMatchesPinLevels) {
+    SwitchBankButton power(bank, 3);
+
+    EXPECT_EQ(power.getState(), 1); // HIGH while open (pulled up).
+    feed(0x0008, 4);
+    EXPECT_EQ(power.getState(), 0); // LOW while closed.
+    EXPECT_TRUE(power.isPressed());
+    bank.sample(0x0000);
+    EXPECT_FALSE(power.isPressed());
+    EXPECT_FALSE(power.isReleased());
+}
+
+// Reference model of a per-switch polled button (as ezButton), which reads its own pin and
+// the clock on every loop. Pin reads go through lookup tables as with the Arduino core.
+static volatile uint8_t port_values[4] = {0xFF, 0xFF, 0xFF, 0xFF};
+static const uint8_t pin_to_port[16] = {0, 0, 0, 0, 1, 1, 1, 1, 2, 2, 2, 2, 3, 3, 3, 3};
+static const uint8_t pin_to_mask[16] = {1, 2, 4, 8, 1, 2, 4, 8, 1, 2, 4, 8, 1, 2, 4, 8};
+static uint32_t fake_millis = 0;
+
+__attribute__((noinline)) static int fakeDigitalRead(uint8_t pin) {
+    return (port_values[pin_to_port[pin]] & pin_to_mask[pin]) ? 1 : 0;
+}
+
+__attribute__((noinline)) static uint32_t fakeMillis() {
+    return fake_millis;
+}
+
+struct PolledButton {
+    uint8_t pin;
+    uint16_t debounceTime = 50;
+    int lastFlickerableState = 1;
+    int lastSteadyState = 1;
+    int previousSteadyState = 1;
+    uint32_t lastDebounceTime = 0;
+
+    void loop() {
+        int currentState = fakeDigitalRead(pin);
+        uint32_t currentTime = fakeMillis();
+
+        if(currentState != lastFlickerableState) {
+            lastDebounceTime = currentTime;
+            lastFlickerableState = currentState;
+        }
+
+        if(currentTime - lastDebounceTime >= debounceTime) {
+            previousSteadyState = lastSteadyState;
+            lastSteadyState = currentState;
+        }
+    }
+
+    bool isPressed() const { return previousSteadyState == 1 && lastSteadyState == 0; }
+};
+
+// Reads the fake ports once each and builds the raw mask, as readPins() does on hardware.
+__attribute__((noinline)) static SwitchMask fakeReadPins(const uint8_t* pins, uint8_t count) {
+    uint8_t values[4];
+    SwitchMask raw = 0;
+
+    for(uint8_t i = 0; i < 4; i++) {
+        values[i] = port_values[i];
+    }
+    for(uint8_t i = 0; i < count; i++) {
+        if(!(values[pin_to_port[pins[i]]] & pin_to_mask[pins[i]])) {
+            raw |= (SwitchMask)1 << i;
+        }
+    }
+    return raw;
+}
+
+// Compares seven polled buttons (as on the Proton Pack) with one bank over the same input, with
+// a loop every 100us. Both must report the same presses. Timings are printed for reference only.
+TEST(SwitchBankBenchmark, PolledButtonsVersusBank) {
+    const uint8_t pins[7] = {0, 3, 5, 6, 9, 12, 15};
+    const uint32_t loops = 1000000;
+    PolledButton buttons[7];
+    SwitchBank bank;
+    uint32_t polledPresses = 0;
+    uint32_t bankPresses = 0;
+
+    for(uint8_t i = 0; i < 7; i++) {
+        buttons[i].pin = pins[i];
+    }
+    bank.begin(0);
+
+    // Switch i toggles every (i + 1) * 700ms, with 5ms of bounce after each change.
+    std::vector<uint32_t> ports(loops);
+    for(uint32_t t = 0; t < loops; t++) {
+        uint32_t ms = t / 10;
+        uint8_t values[4] = {0xFF, 0xFF, 0xFF, 0xFF};
+        for(uint8_t i = 0; i < 7; i++) {
+            uint32_t period = (i + 1) * 700;
+            bool closed = (ms / period) & 1;
+            bool bouncing = (ms % period) < 5 && (t & 1);
+            if(closed != bouncing) {
+                values[pin_to_port[pins[i]]] &= ~pin_to_mask[pins[i]];
+            }
+        }
+        ports[t] = values[0] | (values[1] << 8) | (values[2] << 16) | ((uint32_t)values[3] << 24);
+    }
+
+    auto setInputs = [&](uint32_t t) {
+        for(uint8_t i = 0; i < 4; i++) {
+            port_values[i] = ports[t] >> (i * 8);
+        }
+        fake_millis = t / 10;
+    };
+
+    auto begin = std::chrono::steady_clock::now();
+    for(uint32_t t = 0; t < loops; t++) {
+        setInputs(t);
+        for(uint8_t i = 0; i < 7; i++) {
+            buttons[i].loop();
+            polledPresses += buttons[i].isPressed() ? 1 : 0;
+        }
+    }
+    auto polledTime = std::chrono::steady_clock::now() - begin;
+
+    begin = std::chrono::steady_clock::now();
+    for(uint32_t t = 0; t < loops; t++) {
+        setInputs(t);
+        if(bank.update(fakeMillis(), fakeReadPins(pins, 7))) {
+            bankPresses += __builtin_popcount(bank.getPressed());
+        }
+    }
+    auto bankTime = std::chrono::steady_clock::now() - begin;
+
+    printf("[          ] 7 switches: polled %.1f ns/loop, bank %.1f ns/loop (%u vs %u presses)\n",
+           std::chrono::duration<double, std::nano>(polledTime).count() / loops,
+           std::chrono::duration<double, std::nano>(bankTime).count() / loops,
+           (unsigned)polledPresses, (unsigned)bankPresses);
+
+    EXPECT_EQ(polledPresses, bankPresses);
+    EXPECT_GT(bankPresses, 0u);
+}
@@ -0,0 +1,195 @@
+/**
+ *   Timeline - Keyframe animation tracks evaluated against a single clock for GPStar devices.
+ *   Replaces per-effect step timers with compact keyframe tracks which are updated in one pass.
+ *   Copyright (C) 2023-2026 Michael Rajotte, Dustin Grau, Nomake Wan
+ *
+ *   This program is free software; you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation; either version 3 of the License, or
+ *   (at your option) any later version.
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License
+ *   along with this program; if not, see <https://www.gnu.org/licenses/>.
+ *
+ */
+
+#pragma once
+
+// Standard library includes for integer type definitions
+#include <stdint.h>  // Provides uint8_t, uint16_t, etc.
+#include <stdbool.h> // Provides bool type definition.
+
+// Maximum number of tracks which may be attached to a single timeline.
+#define TIMELINE_MAX_TRACKS 8
+
+// Playback rate which runs a track at its authored speed (8.8 fixed point).
+#define TIMELINE_RATE_NORMAL 256
+
+// TimelineEasing: How values move from one keyframe towards the next.
+enum TimelineEasing : uint8_t {
+  EASE_STEP = 0,    // Hold the keyframe value until the next keyframe is reached.
+  EASE_LINEAR = 1,  // Constant speed between keyframes.
+  EASE_IN = 2,      // Start slowly and accelerate (quadratic).
+  EASE_OUT = 3,     // Start quickly and decelerate (quadratic).
+  EASE_IN_OUT = 4   // Accelerate then decelerate (quadratic).
+};
+
+/**
+ * Struct: Keyframe
+ * Purpose: A single point on a track, 8 bytes with padding.
+ * The easing applies to the segment which starts at this keyframe.
+ */
+struct Keyframe {
+  uint16_t time;     // Milliseconds from the start of the track.
+  uint8_t position;  // LED index, lit count, or any other scalar.
+  uint8_t r;
+  uint8_t g;
+  uint8_t b;
+  uint8_t easing;    // TimelineEasing
+};
+
+/**
+ * Struct: TrackOutput
+ * Purpose: The evaluated values of a track at the current time.
+ */
+struct TrackOutput {
+  uint8_t position = 0;
+  uint8_t r = 0;
+  uint8_t g = 0;
+  uint8_t b = 0;
+  bool changed = false;  // Any value differs from the previous update (only valid when Timeline::update() returns true).
+  bool finished = false; // A one-shot track has reached its last keyframe.
+};
+
+/**
+ * Class: TimelineTrack
+ * Purpose: Plays back an array of keyframes, either once or looping.
+ *
+ * Keyframes must be ordered by time and are not copied, so their storage must outlive the track.
+ * For a looping track the last keyframe marks the length of the loop, and its values should
+ * match the first keyframe so the wrap is seamless.
+ *
+ * Example usage:
+ *   Keyframe sweep[17];
+ *   TimelineTrack powercell;
+ *   powercell.setKeyframes(sweep, buildSweep(sweep, 17, 15, 75, 333, 0, 0, 255), true);
+ */
+class Timeline;
+
+class TimelineTrack {
+public:
+  TimelineTrack();
+
+  // Assigns the keyframes to play and rewinds the track.
+  void setKeyframes(const Keyframe* frames, uint8_t count, bool loop);
+
+  // Playback controls. The rate is 8.8 fixed point, so 512 plays twice as fast.
+  void play();
+  void stop();
+  void rewind();
+  bool isPlaying() const;
+  void setRate(uint16_t rate);
+  uint16_t getRate() const;
+
+  // Total length of the track in milliseconds at the normal rate.
+  uint16_t getDuration() const;
+
+  // Position within the track in milliseconds (track time, not wall time).
+  uint32_t getElapsed() const;
+
+  // Moves the track to the start of a keyframe without changing whether it is playing.
+  void seek(uint8_t keyframe);
+
+  // Result of the last update.
+  const TrackOutput& getOutput() const;
+
+  // Advances the track by the elapsed wall time and evaluates its output.
+  void advance(uint16_t delta);
+
+  // Wall time in milliseconds before the output can next change (0xFFFF if never).
+  uint16_t getTimeUntilChange() const;
+
+private:
+  friend class Timeline;
+
+  void evaluate();
+  void modified();
+
+  Timeline* owner;    // Timeline which schedules this track, if any.
+
+  const Keyframe* frames;
+  uint8_t count;
+  uint8_t index;      // Keyframe which begins the current segment.
+  bool loop;
+  bool playing;
+  uint16_t rate;
+  uint16_t remainder; // Fractional milliseconds carried between updates when the rate is not 1x.
+  uint32_t elapsed;
+  TrackOutput output;
+};
+
+/**
+ * Class: Timeline
+ * Purpose: Updates every playing track against a single clock in one pass.
+ *
+ * The clock is read once per update, which keeps all tracks in step with each other and
+ * replaces the individual timer checks which each effect would otherwise perform. The timeline
+ * also knows the earliest time at which any track can change, so until then an update is a
+ * single comparison no matter how many tracks are attached.
+ *
+ * Example usage:
+ *   Timeline timeline;
+ *   timeline.addTrack(&powercell);
+ *   powercell.play();
+ *   if(timeline.update(millis())) { drawPowercell(powercell.getOutput().position); }
+ */
+class Timeline {
+public:
+  Timeline();
+
+  // Adds a track to the timeline. Returns false if no slots remain.
+  bool addTrack(TimelineTrack* track);
+  uint8_t getTrackCount() const;
+
+  // Advances all playing tracks to the given time (milliseconds).
+  // Returns true if the output of any track changed.
+  bool update(uint32_t now);
+
+  // Forces every track to be advanced on the next update. Called by tracks when their playback changes.
+  void invalidate();
+
+private:
+  TimelineTrack* tracks[TIMELINE_MAX_TRACKS];
+  uint8_t trackCount;
+  uint32_t lastUpdate;
+  uint16_t nextChange; // Wall time after lastUpdate at which any track output can next change.
+  bool started;
+};
+
+/**
+ * Track builders which compile common animations into keyframes.
+ * Each returns the number of keyframes written, or 0 if the buffer is too small.
+ */
+
+// Lit-count sweep as used by the Power Cell: one more LED every step until all are lit, then
+// hold all LEDs lit before going dark for one step. Requires ledCount + 2 keyframes.
+uint8_t buildSweep(Keyframe* out, uint8_t maxFrames, uint8_t ledCount, uint16_t stepDelay, uint16_t holdDelay, uint8_t r, uint8_t g, uint8_t b);
+
+// Keyframe of a sweep from buildSweep() which shows the given lit count. A count of 0, or more
+// than ledCount, is the dark step.
+uint8_t sweepKeyframe(uint8_t ledCount, uint8_t lit);
+
+// Stepped rotation through a number of positions, each shown for stepDelay.
+// Requires positions + 1 keyframes.
+uint8_t buildRotation(Keyframe* out, uint8_t maxFrames, uint8_t positions, uint16_t stepDelay, uint8_t r, uint8_t g, uint8_t b);
+
+// Single fade between two colours over a duration. Requires 2 keyframes.
+uint8_t buildFade(Keyframe* out, uint8_t maxFrames, uint16_t duration, uint8_t position, uint8_t r1, uint8_t g1, uint8_t b1, uint8_t r2, uint8_t g2, uint8_t b2, TimelineEasing easing);
+
+// Applies an easing curve to a fraction in the range 0-255.
+uint8_t applyEasing(uint8_t fraction, TimelineEasing easing);
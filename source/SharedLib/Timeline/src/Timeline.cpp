@@ -0,0 +1,346 @@
+/**
+ *   Timeline - Keyframe animation tracks evaluated against a single clock for GPStar devices.
+ *   Replaces per-effect step timers with compact keyframe tracks which are updated in one pass.
+ *   Copyright (C) 2023-2026 Michael Rajotte, Dustin Grau, Nomake Wan
+ *
+ *   This program is free software; you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation; either version 3 of the License, or
+ *   (at your option) any later version.
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License
+ *   along with this program; if not, see <https://www.gnu.org/licenses/>.
+ *
+ */
+
+// Library Header
+#include "Timeline.h"
+
+/**
+ * Easing
+ */
+
+uint8_t applyEasing(uint8_t fraction, TimelineEasing easing) {
+  uint16_t f = fraction;
+  uint16_t inv = 255 - fraction;
+
+  switch(easing) {
+    case EASE_STEP:
+      return 0;
+
+    // Quadratic curves are divided by 255 so that both end points are exact.
+    case EASE_IN:
+      return (f * f) / 255;
+
+    case EASE_OUT:
+      return 255 - (inv * inv) / 255;
+
+    case EASE_IN_OUT:
+      if(f < 128) {
+        return (f * f * 2) / 255;
+      }
+      return 255 - (inv * inv * 2) / 255;
+
+    case EASE_LINEAR:
+    default:
+      return fraction;
+  }
+}
+
+// Moves from a towards b by a fraction in the range 0-255.
+static uint8_t lerp8(uint8_t a, uint8_t b, uint8_t fraction) {
+  return a + (((int16_t)b - a) * fraction >> 8);
+}
+
+/**
+ * TimelineTrack
+ */
+
+TimelineTrack::TimelineTrack()
+  : owner(nullptr), frames(nullptr), count(0), index(0), loop(false), playing(false),
+    rate(TIMELINE_RATE_NORMAL), remainder(0), elapsed(0) {
+}
+
+void TimelineTrack::setKeyframes(const Keyframe* newFrames, uint8_t newCount, bool newLoop) {
+  frames = newFrames;
+  count = newFrames != nullptr ? newCount : 0;
+  loop = newLoop;
+  rewind();
+}
+
+void TimelineTrack::play() {
+  playing = count > 0;
+  output.finished = false;
+  modified();
+}
+
+void TimelineTrack::stop() {
+  playing = false;
+  modified();
+}
+
+void TimelineTrack::rewind() {
+  index = 0;
+  remainder = 0;
+  elapsed = 0;
+  output.finished = false;
+  evaluate();
+  modified();
+}
+
+bool TimelineTrack::isPlaying() const {
+  return playing;
+}
+
+void TimelineTrack::setRate(uint16_t newRate) {
+  if(newRate != rate) {
+    rate = newRate;
+    modified();
+  }
+}
+
+uint16_t TimelineTrack::getRate() const {
+  return rate;
+}
+
+uint16_t TimelineTrack::getDuration() const {
+  return count > 0 ? frames[count - 1].time : 0;
+}
+
+uint32_t TimelineTrack::getElapsed() const {
+  return elapsed;
+}
+
+void TimelineTrack::seek(uint8_t keyframe) {
+  if(keyframe >= count) {
+    return;
+  }
+
+  index = keyframe;
+  remainder = 0;
+  elapsed = frames[keyframe].time;
+  output.finished = false;
+  evaluate();
+  modified();
+}
+
+const TrackOutput& TimelineTrack::getOutput() const {
+  return output;
+}
+
+void TimelineTrack::advance(uint16_t delta) {
+  output.changed = false;
+
+  if(!playing) {
+    return;
+  }
+
+  // Scale wall time by the playback rate, carrying any fraction of a millisecond forward.
+  uint32_t scaled = (uint32_t)delta * rate + remainder;
+  elapsed += scaled >> 8;
+  remainder = scaled & 0xFF;
+
+  uint16_t duration = getDuration();
+
+  // Stepped segments cannot change value until the next keyframe, so skip evaluating them.
+  if(elapsed < duration && frames[index].easing == EASE_STEP && frames[index + 1].time > elapsed) {
+    return;
+  }
+
+  if(elapsed >= duration) {
+    if(loop && duration > 0) {
+      elapsed %= duration;
+      index = 0;
+    }
+    else {
+      elapsed = duration;
+      playing = false;
+      output.finished = true;
+    }
+  }
+
+  evaluate();
+}
+
+uint16_t TimelineTrack::getTimeUntilChange() const {
+  if(!playing || rate == 0) {
+    return 0xFFFF;
+  }
+
+  if(frames[index].easing != EASE_STEP || index + 1 >= count) {
+    return 1; // Interpolating segments may change on every update.
+  }
+
+  // Smallest wall time which moves the track onto the next keyframe, allowing for the carried fraction.
+  uint32_t remaining = ((uint32_t)(frames[index + 1].time - elapsed) << 8) - remainder;
+  uint32_t wait = (remaining + rate - 1) / rate;
+
+  return wait > 0xFFFF ? 0xFFFF : wait;
+}
+
+void TimelineTrack::modified() {
+  if(owner != nullptr) {
+    owner->invalidate();
+  }
+}
+
+void TimelineTrack::evaluate() {
+  if(count == 0) {
+    return;
+  }
+
+  // Segments are only ever walked forwards, so this is usually a single comparison.
+  while(index + 1 < count && frames[index + 1].time <= elapsed) {
+    index++;
+  }
+
+  const Keyframe& a = frames[index];
+  uint8_t position = a.position;
+  uint8_t r = a.r;
+  uint8_t g = a.g;
+  uint8_t b = a.b;
+
+  if(index + 1 < count && a.easing != EASE_STEP) {
+    const Keyframe& next = frames[index + 1];
+    uint16_t span = next.time - a.time;
+    uint8_t fraction = applyEasing(((elapsed - a.time) << 8) / span, (TimelineEasing)a.easing);
+
+    position = lerp8(a.position, next.position, fraction);
+    r = lerp8(a.r, next.r, fraction);
+    g = lerp8(a.g, next.g, fraction);
+    b = lerp8(a.b, next.b, fraction);
+  }
+
+  if(position != output.position || r != output.r || g != output.g || b != output.b) {
+    output.position = position;
+    output.r = r;
+    output.g = g;
+    output.b = b;
+    output.changed = true;
+  }
+}
+
+/**
+ * Timeline
+ */
+
+Timeline::Timeline()
+  : tracks{}, trackCount(0), lastUpdate(0), nextChange(0), started(false) {
+}
+
+bool Timeline::addTrack(TimelineTrack* track) {
+  if(track == nullptr || trackCount >= TIMELINE_MAX_TRACKS) {
+    return false;
+  }
+
+  tracks[trackCount++] = track;
+  track->owner = this;
+  invalidate();
+  return true;
+}
+
+uint8_t Timeline::getTrackCount() const {
+  return trackCount;
+}
+
+void Timeline::invalidate() {
+  nextChange = 0;
+}
+
+bool Timeline::update(uint32_t now) {
+  uint32_t delta = started ? now - lastUpdate : 0;
+  bool changed = false;
+
+  // Nothing can change yet, so leave the time to accumulate until the next keyframe is due.
+  if(started && delta < nextChange) {
+    return false;
+  }
+
+  started = true;
+  lastUpdate = now;
+  nextChange = 0xFFFF;
+
+  if(delta > 0xFFFF) {
+    delta = 0xFFFF;
+  }
+
+  for(uint8_t i = 0; i < trackCount; i++) {
+    tracks[i]->advance(delta);
+    changed |= tracks[i]->getOutput().changed;
+
+    uint16_t wait = tracks[i]->getTimeUntilChange();
+    if(wait < nextChange) {
+      nextChange = wait;
+    }
+  }
+
+  return changed;
+}
+
+/**
+ * Track builders
+ */
+
+uint8_t buildSweep(Keyframe* out, uint8_t maxFrames, uint8_t ledCount, uint16_t stepDelay, uint16_t holdDelay, uint8_t r, uint8_t g, uint8_t b) {
+  if(ledCount == 0 || ledCount + 2 > maxFrames) {
+    return 0;
+  }
+
+  uint8_t n = 0;
+  uint16_t t = 0;
+
+  // Light one more LED on each step.
+  for(uint8_t i = 0; i < ledCount; i++) {
+    out[n++] = {t, (uint8_t)(i + 1), r, g, b, EASE_STEP};
+    t += stepDelay;
+  }
+
+  // All LEDs remain lit for the hold time, then go dark for a single step.
+  t += holdDelay - stepDelay;
+  out[n++] = {t, 0, r, g, b, EASE_STEP};
+  t += stepDelay;
+
+  // Loop marker, matching the first keyframe.
+  out[n++] = {t, 1, r, g, b, EASE_STEP};
+
+  return n;
+}
+
+uint8_t sweepKeyframe(uint8_t ledCount, uint8_t lit) {
+  if(lit == 0 || lit > ledCount) {
+    return ledCount;
+  }
+
+  return lit - 1;
+}
+
+uint8_t buildRotation(Keyframe* out, uint8_t maxFrames, uint8_t positions, uint16_t stepDelay, uint8_t r, uint8_t g, uint8_t b) {
+  if(positions == 0 || positions + 1 > maxFrames) {
+    return 0;
+  }
+
+  for(uint8_t i = 0; i < positions; i++) {
+    out[i] = {(uint16_t)(i * stepDelay), i, r, g, b, EASE_STEP};
+  }
+
+  // Loop marker, matching the first keyframe.
+  out[positions] = {(uint16_t)(positions * stepDelay), 0, r, g, b, EASE_STEP};
+
+  return positions + 1;
+}
+
+uint8_t buildFade(Keyframe* out, uint8_t maxFrames, uint16_t duration, uint8_t position, uint8_t r1, uint8_t g1, uint8_t b1, uint8_t r2, uint8_t g2, uint8_t b2, TimelineEasing easing) {
+  if(maxFrames < 2) {
+    return 0;
+  }
+
+  out[0] = {0, position, r1, g1, b1, easing};
+  out[1] = {duration, position, r2, g2, b2, EASE_STEP};
+
+  return 2;
+}
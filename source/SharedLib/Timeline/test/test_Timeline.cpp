@@ -0,0 +1,184 @@
+/**
+ * Test suite for the keyframe timeline engine.
+ */
+
+#include <gtest/gtest.h>
+#include "Timeline.h"
+
+// Test fixture with a timeline and a single track.
+class TimelineFixture : public ::testing::Test {
+protected:
+    Keyframe frames[8];
+    TimelineTrack track;
+    Timeline timeline;
+
+    // SetUp() is called before each test.
+    void SetUp() override {
+        timeline.addTrack(&track);
+    }
+};
+
+TEST_F(TimelineFixture, CanInstantiate) {
+    EXPECT_EQ(timeline.getTrackCount(), 1);
+    EXPECT_FALSE(track.isPlaying());
+}
+
+// A stopped track never advances, however much time passes.
+TEST_F(TimelineFixture, StoppedTrackHolds) {
+    track.setKeyframes(frames, buildRotation(frames, 8, 4, 100, 255, 0, 0), true);
+    timeline.update(0);
+    timeline.update(250);
+    EXPECT_EQ(track.getElapsed(), 0u);
+    EXPECT_EQ(track.getOutput().position, 0);
+}
+
+// Stepped keyframes hold their value until the next keyframe time is reached.
+TEST_F(TimelineFixture, StepEasingHoldsValue) {
+    track.setKeyframes(frames, buildRotation(frames, 8, 4, 100, 255, 0, 0), true);
+    track.play();
+    timeline.update(1000);
+
+    timeline.update(1099);
+    EXPECT_EQ(track.getOutput().position, 0);
+    timeline.update(1100);
+    EXPECT_EQ(track.getOutput().position, 1);
+    EXPECT_TRUE(track.getOutput().changed);
+    EXPECT_FALSE(timeline.update(1101));
+    timeline.update(1399);
+    EXPECT_EQ(track.getOutput().position, 3);
+}
+
+// Looping tracks wrap back to the start, including when a large gap skips past the end.
+TEST_F(TimelineFixture, LoopingTrackWraps) {
+    track.setKeyframes(frames, buildRotation(frames, 8, 4, 100, 255, 0, 0), true);
+    track.play();
+    timeline.update(0);
+
+    timeline.update(400);
+    EXPECT_EQ(track.getOutput().position, 0);
+    timeline.update(650);
+    EXPECT_EQ(track.getOutput().position, 2);
+    timeline.update(1950); // Several loops at once.
+    EXPECT_EQ(track.getOutput().position, 3);
+    EXPECT_TRUE(track.isPlaying());
+}
+
+// One-shot tracks stop on their last keyframe and report completion.
+TEST_F(TimelineFixture, OneShotTrackFinishes) {
+    track.setKeyframes(frames, buildFade(frames, 8, 200, 5, 0, 0, 0, 200, 100, 0, EASE_LINEAR), false);
+    track.play();
+    timeline.update(0);
+
+    timeline.update(100);
+    EXPECT_NEAR(track.getOutput().r, 100, 1);
+    EXPECT_NEAR(track.getOutput().g, 50, 1);
+    EXPECT_EQ(track.getOutput().position, 5);
+    EXPECT_FALSE(track.getOutput().finished);
+
+    timeline.update(500);
+    EXPECT_EQ(track.getOutput().r, 200);
+    EXPECT_EQ(track.getOutput().g, 100);
+    EXPECT_TRUE(track.getOutput().finished);
+    EXPECT_FALSE(track.isPlaying());
+}
+
+// Easing curves keep their end points and bend the middle in the expected direction.
+TEST(TimelineEasing, CurvesKeepEndPoints) {
+    EXPECT_EQ(applyEasing(0, EASE_IN), 0);
+    EXPECT_EQ(applyEasing(0, EASE_OUT), 0);
+    EXPECT_EQ(applyEasing(0, EASE_IN_OUT), 0);
+    EXPECT_EQ(applyEasing(255, EASE_IN), 255);
+    EXPECT_EQ(applyEasing(255, EASE_OUT), 255);
+    EXPECT_EQ(applyEasing(255, EASE_IN_OUT), 255);
+
+    EXPECT_LT(applyEasing(128, EASE_IN), 128);
+    EXPECT_GT(applyEasing(128, EASE_OUT), 128);
+    EXPECT_LT(applyEasing(64, EASE_IN_OUT), 64);
+    EXPECT_GT(applyEasing(192, EASE_IN_OUT), 192);
+    EXPECT_EQ(applyEasing(77, EASE_LINEAR), 77);
+}
+
+// A faster rate shortens every step, and fractional rates carry their remainder forward.
+TEST_F(TimelineFixture, RateScalesPlayback) {
+    track.setKeyframes(frames, buildRotation(frames, 8, 4, 100, 255, 0, 0), true);
+    track.setRate(TIMELINE_RATE_NORMAL * 2);
+    track.play();
+    timeline.update(0);
+
+    timeline.update(50);
+    EXPECT_EQ(track.getOutput().position, 1);
+
+    // At 85/256 of normal speed the next 100ms step needs 302ms of wall time.
+    track.setRate(TIMELINE_RATE_NORMAL / 3);
+    for(uint32_t t = 51; t <= 351; t++) {
+        timeline.update(t);
+    }
+    EXPECT_EQ(track.getOutput().position, 1);
+    timeline.update(352);
+    EXPECT_EQ(track.getOutput().position, 2);
+    EXPECT_EQ(track.getElapsed(), 200u);
+}
+
+// The timeline reports a change only when some track output actually changed.
+TEST_F(TimelineFixture, UpdateReportsChanges) {
+    TimelineTrack second;
+    Keyframe secondFrames[4];
+    timeline.addTrack(&second);
+
+    track.setKeyframes(frames, buildRotation(frames, 8, 4, 100, 255, 0, 0), true);
+    second.setKeyframes(secondFrames, buildRotation(secondFrames, 4, 2, 30, 0, 255, 0), true);
+    track.play();
+    second.play();
+    timeline.update(0);
+
+    EXPECT_FALSE(timeline.update(10));
+    EXPECT_TRUE(timeline.update(30));  // Second track steps.
+    EXPECT_FALSE(timeline.update(40));
+    EXPECT_TRUE(timeline.update(100)); // Both tracks step.
+}
+
+// Seeking restarts the wait from the start of a keyframe, and the sweep keyframe lookup finds each lit count.
+TEST_F(TimelineFixture, SeekRestartsKeyframe) {
+    track.setKeyframes(frames, buildSweep(frames, 8, 4, 100, 300, 0, 0, 255), true);
+    track.play();
+    timeline.update(0);
+    timeline.update(150);
+    EXPECT_EQ(track.getOutput().position, 2);
+
+    track.seek(sweepKeyframe(4, 4));
+    EXPECT_FALSE(timeline.update(150));
+    EXPECT_EQ(track.getOutput().position, 4);
+    EXPECT_FALSE(timeline.update(449));
+    EXPECT_TRUE(timeline.update(450));
+    EXPECT_EQ(track.getOutput().position, 0);
+
+    track.seek(sweepKeyframe(4, 0));
+    EXPECT_EQ(track.getOutput().position, 0);
+    track.seek(sweepKeyframe(4, 5));
+    EXPECT_EQ(track.getOutput().position, 0);
+    track.seek(8); // Past the last keyframe, so ignored.
+    EXPECT_EQ(track.getOutput().position, 0);
+    EXPECT_TRUE(track.isPlaying());
+}
+
+// Builders refuse buffers which are too small.
+TEST(TimelineBuilders, RejectSmallBuffers) {
+    Keyframe frames[4];
+    EXPECT_EQ(buildSweep(frames, 4, 3, 10, 10, 0, 0, 0), 0);
+    EXPECT_EQ(buildSweep(frames, 4, 2, 10, 10, 0, 0, 0), 4);
+    EXPECT_EQ(buildRotation(frames, 4, 4, 10, 0, 0, 0), 0);
+    EXPECT_EQ(buildFade(frames, 1, 10, 0, 0, 0, 0, 0, 0, 0, EASE_LINEAR), 0);
+}
+
+// Tracks are limited to the configured maximum.
+TEST(TimelineLimits, RejectsTooManyTracks) {
+    Timeline timeline;
+    TimelineTrack tracks[TIMELINE_MAX_TRACKS + 1];
+
+    for(uint8_t i = 0; i < TIMELINE_MAX_TRACKS; i++) {
+        EXPECT_TRUE(timeline.addTrack(&tracks[i]));
+    }
+
+    EXPECT_FALSE(timeline.addTrack(&tracks[TIMELINE_MAX_TRACKS]));
+    EXPECT_FALSE(timeline.addTrack(nullptr));
+}
@@ -0,0 +1,260 @@
+/**
+ * Test rig comparing timeline tracks against the timer-driven animations of the Proton Pack.
+ *
+ * The reference models below mirror the steady-state stepping of powercellLoop() and
+ * cyclotron1984() in ProtonPack/include/System.h, including the millisDelay semantics
+ * (a timer restarted from the current time whenever justFinished() is seen).
+ */
+
+#include <gtest/gtest.h>
+#include "Timeline.h"
+#include <chrono>
+#include <stdio.h>
+
+// Minimal stand-in for millisDelay, as polled by the Proton Pack.
+struct ReferenceDelay {
+    uint32_t start = 0;
+    uint32_t wait = 0;
+    bool running = false;
+
+    void begin(uint32_t now, uint32_t delay) { start = now; wait = delay; running = true; }
+    bool justFinished(uint32_t now) {
+        if(running && now - start >= wait) {
+            running = false;
+            return true;
+        }
+        return false;
+    }
+};
+
+// Mirrors powercellLoop(): one more LED per step, a pause when full in modern themes, then dark.
+struct ReferencePowercell {
+    uint8_t numLeds;
+    uint16_t delay;
+    bool modern;
+    uint8_t led = 0;
+    uint8_t lit = 0;
+    ReferenceDelay timer;
+
+    ReferencePowercell(uint8_t numLeds, uint16_t delay, bool modern) : numLeds(numLeds), delay(delay), modern(modern) {}
+
+    void tick(uint32_t now) {
+        if(timer.justFinished(now)) {
+            uint16_t extra = 0;
+
+            if(led >= numLeds) {
+                lit = 0;
+                led = 0;
+            }
+            else {
+                led++;
+                lit = led;
+
+                if(modern && led >= numLeds) {
+                    extra = 333 - delay;
+                }
+            }
+
+            timer.begin(now, delay + extra);
+        }
+    }
+};
+
+// Mirrors cyclotron1984(): the active lamp advances every delay / multiplier.
+struct ReferenceCyclotron1984 {
+    uint16_t delay;
+    uint8_t multiplier;
+    uint8_t counter = 3;
+    ReferenceDelay timer;
+
+    ReferenceCyclotron1984(uint16_t delay, uint8_t multiplier) : delay(delay), multiplier(multiplier) {}
+
+    void tick(uint32_t now) {
+        if(timer.justFinished(now)) {
+            timer.begin(now, delay / multiplier);
+
+            counter++;
+            if(counter > 3) {
+                counter = 0;
+            }
+        }
+    }
+};
+
+// The sweep track reproduces the Power Cell lit count on every millisecond.
+TEST(TimelineReference, SweepMatchesPowercell) {
+    const bool themes[] = {false, true};
+
+    for(bool modern : themes) {
+        ReferencePowercell reference(15, 75, modern);
+        Keyframe frames[17];
+        TimelineTrack track;
+        Timeline timeline;
+
+        track.setKeyframes(frames, buildSweep(frames, 17, 15, 75, modern ? 333 : 75, 0, 0, 255), true);
+        timeline.addTrack(&track);
+        track.play();
+        reference.timer.begin(0, 0);
+
+        for(uint32_t t = 0; t < 10000; t++) {
+            reference.tick(t);
+            timeline.update(t);
+            ASSERT_EQ(track.getOutput().position, reference.lit) << "at " << t << " ms, modern " << modern;
+        }
+    }
+}
+
+/*
+ * The Power Cell as ported in powercellLoop(): the step body runs when the sweep reaches a keyframe, and
+ * the sweep is rebuilt whenever the step or hold time changes (as during a cyclotron ramp) and sought back
+ * to the lit count whenever something else sets it. The reference restarts its timer after every step
+ * with the same times, so both must light the same LEDs on every millisecond.
+ */
+TEST(TimelineReference, RebuiltSweepMatchesRampingPowercell) {
+    const uint8_t numLeds = 15;
+
+    for(bool modern : {false, true}) {
+        Keyframe frames[numLeds + 2];
+        TimelineTrack track;
+        Timeline timeline;
+        timeline.addTrack(&track);
+
+        uint8_t led = 0;       // Lit count of the timeline side, as i_powercell_led.
+        uint8_t refLed = 0;    // Lit count of the reference.
+        uint16_t builtStep = 0;
+        uint16_t builtHold = 0;
+        ReferenceDelay timer;
+        uint32_t steps = 0;
+        uint32_t refSteps = 0;
+
+        // Step and hold times for a step, slowing down and speeding up again over steps 40 to 80 as a ramp would.
+        auto stepTime = [](uint32_t n) -> uint16_t { return n < 40 || n > 80 ? 75 : 75 + (n < 60 ? n - 40 : 80 - n) * 6; };
+        auto holdTime = [&](uint32_t n) -> uint16_t { return modern ? stepTime(n) + 333 - 75 : stepTime(n); };
+
+        auto sweep = [&](uint16_t step, uint16_t hold) {
+            bool rebuild = step != builtStep || hold != builtHold;
+
+            if(rebuild) {
+                builtStep = step;
+                builtHold = hold;
+                track.setKeyframes(frames, buildSweep(frames, numLeds + 2, numLeds, step, hold, 0, 0, 0), true);
+                track.play();
+            }
+
+            if(rebuild || track.getOutput().position != led) {
+                track.seek(sweepKeyframe(numLeds, led));
+            }
+        };
+
+        sweep(75, holdTime(0));
+        timeline.update(0);
+        timer.begin(0, 75);
+
+        for(uint32_t t = 0; t < 20000; t++) {
+            // A wand mash lockout forces the next step to switch the Power Cell off.
+            if(t == 15001) {
+                led = numLeds + 1;
+                refLed = numLeds + 1;
+            }
+
+            if(timeline.update(t) && track.getOutput().changed) {
+                led = led >= numLeds ? 0 : led + 1;
+                steps++;
+                sweep(stepTime(steps), holdTime(steps));
+            }
+
+            if(timer.justFinished(t)) {
+                refLed = refLed >= numLeds ? 0 : refLed + 1;
+                refSteps++;
+                timer.begin(t, refLed == numLeds ? holdTime(refSteps) : stepTime(refSteps));
+            }
+
+            ASSERT_EQ(led, refLed) << "at " << t << " ms, modern " << modern;
+        }
+
+        EXPECT_GT(steps, 150u);
+    }
+}
+
+// The rotation track reproduces the 1984 lamp order, with multipliers expressed as a rate.
+TEST(TimelineReference, RotationMatchesCyclotron1984) {
+    for(uint8_t multiplier = 1; multiplier <= 4; multiplier *= 2) {
+        ReferenceCyclotron1984 reference(1000, multiplier);
+        Keyframe frames[5];
+        TimelineTrack track;
+        Timeline timeline;
+
+        track.setKeyframes(frames, buildRotation(frames, 5, 4, 1000, 255, 0, 0), true);
+        track.setRate(TIMELINE_RATE_NORMAL * multiplier);
+        timeline.addTrack(&track);
+        track.play();
+        reference.timer.begin(0, 0);
+
+        for(uint32_t t = 0; t < 20000; t++) {
+            reference.tick(t);
+            timeline.update(t);
+            ASSERT_EQ(track.getOutput().position, reference.counter) << "at " << t << " ms, multiplier " << (int)multiplier;
+        }
+    }
+}
+
+// Compares the per-frame cost of polling every timer against one timeline pass.
+// Timings are printed for reference only, as they depend on the host.
+TEST(TimelineReference, PerFrameCost) {
+    const uint32_t frames = 200000;
+    const uint8_t animations = TIMELINE_MAX_TRACKS;
+
+    ReferencePowercell* powercells[animations / 2];
+    ReferenceCyclotron1984* cyclotrons[animations / 2];
+    Keyframe sweepFrames[animations / 2][17];
+    Keyframe rotationFrames[animations / 2][5];
+    TimelineTrack tracks[animations];
+    Timeline timeline;
+
+    for(uint8_t i = 0; i < animations / 2; i++) {
+        powercells[i] = new ReferencePowercell(15, 75 + i, true);
+        cyclotrons[i] = new ReferenceCyclotron1984(1000 + i, 1);
+        powercells[i]->timer.begin(0, 0);
+        cyclotrons[i]->timer.begin(0, 0);
+
+        tracks[i * 2].setKeyframes(sweepFrames[i], buildSweep(sweepFrames[i], 17, 15, 75 + i, 333, 0, 0, 255), true);
+        tracks[i * 2 + 1].setKeyframes(rotationFrames[i], buildRotation(rotationFrames[i], 5, 4, 1000 + i, 255, 0, 0), true);
+        timeline.addTrack(&tracks[i * 2]);
+        timeline.addTrack(&tracks[i * 2 + 1]);
+        tracks[i * 2].play();
+        tracks[i * 2 + 1].play();
+    }
+
+    volatile uint32_t sink = 0;
+
+    auto start = std::chrono::steady_clock::now();
+    for(uint32_t t = 0; t < frames; t++) {
+        for(uint8_t i = 0; i < animations / 2; i++) {
+            powercells[i]->tick(t);
+            cyclotrons[i]->tick(t);
+            sink += powercells[i]->lit + cyclotrons[i]->counter;
+        }
+    }
+    auto polled = std::chrono::steady_clock::now() - start;
+
+    start = std::chrono::steady_clock::now();
+    for(uint32_t t = 0; t < frames; t++) {
+        if(timeline.update(t)) {
+            for(uint8_t i = 0; i < animations; i++) {
+                sink += tracks[i].getOutput().position;
+            }
+        }
+    }
+    auto timed = std::chrono::steady_clock::now() - start;
+
+    printf("[          ] %u animations: timers %.1f ns/frame, timeline %.1f ns/frame\n", animations,
+           std::chrono::duration<double, std::nano>(polled).count() / frames,
+           std::chrono::duration<double, std::nano>(timed).count() / frames);
+
+    for(uint8_t i = 0; i < animations / 2; i++) {
+        delete powercells[i];
+        delete cyclotrons[i];
+    }
+
+    EXPECT_GT(sink, 0u);
+}
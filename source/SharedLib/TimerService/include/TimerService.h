@@ -0,0 +1,117 @@
+/**
+ *   TimerService - Deadline-ordered software timers with callbacks for GPStar devices.
+ *   Keeps timers in a min-heap so only expired timers are visited on each dispatch.
+ *   Copyright (C) 2023-2026 Michael Rajotte, Dustin Grau, Nomake Wan
+ *
+ *   This program is free software; you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation; either version 3 of the License, or
+ *   (at your option) any later version.
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License
+ *   along with this program; if not, see <https://www.gnu.org/licenses/>.
+ *
+ */
+
+#pragma once
+
+// Standard library includes for integer type definitions
+#include <stdint.h>  // Provides uint8_t, uint32_t, etc.
+#include <stdbool.h> // Provides bool type definition.
+
+// Returned by getTimeUntilNext() when no timers are active.
+#define TIMER_SERVICE_NONE 0xFFFFFFFFUL
+
+// Function pointer type for timer callbacks (no parameters, no return value).
+typedef void (*TimerCallback)();
+
+/**
+ * Struct: TimerSlot
+ * Purpose: Storage for a single timer, owned by a TimerService.
+ */
+struct TimerSlot {
+  TimerCallback callback = nullptr;
+  uint32_t deadline = 0; // Time at which the timer next expires.
+  uint32_t period = 0;   // Interval for periodic timers, or 0 for a one-shot timer.
+  uint8_t heapIndex = 0; // Position of this slot within the heap while active.
+  bool active = false;
+};
+
+/**
+ * Class: TimerService
+ * Purpose: Runs callbacks when one-shot or periodic timers expire.
+ *
+ * Active timers are kept in a min-heap ordered by deadline, so dispatch() only looks at the
+ * earliest deadline until it finds one which has not yet expired, and getTimeUntilNext() tells
+ * the caller how long it may sleep. Times are in milliseconds and handle the rollover of millis().
+ * Storage is supplied by the caller; use TimerServiceBuffer<N> for a self-contained service.
+ *
+ * Timer IDs are the slot index + 1, so 0 always indicates failure.
+ *
+ * Example usage:
+ *   TimerServiceBuffer<8> timers;
+ *   uint8_t i_blink = timers.start(toggleLED, millis(), 500, 500);
+ *   timers.dispatch(millis()); // In the main loop.
+ */
+class TimerService {
+public:
+  // Constructor, using caller-provided slot and heap storage of the given capacity.
+  TimerService(TimerSlot* slots, uint8_t* heap, uint8_t capacity);
+
+  // Starts a timer which first expires after delay, then every period (0 for a one-shot timer).
+  // Returns the timer ID, or 0 if no slots remain or the callback is missing.
+  uint8_t start(TimerCallback callback, uint32_t now, uint32_t delay, uint32_t period = 0);
+
+  // Restarts an active timer with a new delay, keeping its callback and period.
+  bool restart(uint8_t id, uint32_t now, uint32_t delay);
+
+  // Stops a timer by ID. Returns false if the ID was not active.
+  bool stop(uint8_t id);
+  void stopAll();
+
+  bool isActive(uint8_t id) const;
+  uint8_t getActiveCount() const;
+  uint8_t getCapacity() const;
+
+  // Time remaining before the given timer expires (0 if due now, TIMER_SERVICE_NONE if inactive).
+  uint32_t getRemaining(uint8_t id, uint32_t now) const;
+
+  // Time remaining before the earliest timer expires (0 if due now, TIMER_SERVICE_NONE if none).
+  uint32_t getTimeUntilNext(uint32_t now) const;
+
+  // Runs the callback of every expired timer in deadline order. Returns the number run.
+  uint8_t dispatch(uint32_t now);
+
+private:
+  static bool before(uint32_t a, uint32_t b);
+
+  void push(uint8_t slot);
+  void remove(uint8_t slot);
+  void siftUp(uint8_t index);
+  void siftDown(uint8_t index);
+  void place(uint8_t index, uint8_t slot);
+
+  TimerSlot* slots;
+  uint8_t* heap;
+  uint8_t capacity;
+  uint8_t count = 0;
+};
+
+/**
+ * Class: TimerServiceBuffer
+ * Purpose: A TimerService which carries its own storage for N timers.
+ */
+template <uint8_t N>
+class TimerServiceBuffer : public TimerService {
+public:
+  TimerServiceBuffer() : TimerService(slotStore, heapStore, N) {}
+
+private:
+  TimerSlot slotStore[N];
+  uint8_t heapStore[N];
+};
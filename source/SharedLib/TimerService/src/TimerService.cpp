@@ -0,0 +1,210 @@
+/**
+ *   TimerService - Deadline-ordered software timers with callbacks for GPStar devices.
+ *   Keeps timers in a min-heap so only expired timers are visited on each dispatch.
+ *   Copyright (C) 2023-2026 Michael Rajotte, Dustin Grau, Nomake Wan
+ *
+ *   This program is free software; you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation; either version 3 of the License, or
+ *   (at your option) any later version.
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License
+ *   along with this program; if not, see <https://www.gnu.org/licenses/>.
+ *
+ */
+
+// Library Header
+#include "TimerService.h"
+
+TimerService::TimerService(TimerSlot* slots, uint8_t* heap, uint8_t capacity)
+  : slots(slots), heap(heap), capacity(capacity) {
+}
+
+// Compares two times allowing for rollover, as long as they are less than ~24 days apart.
+bool TimerService::before(uint32_t a, uint32_t b) {
+  return (int32_t)(a - b) < 0;
+}
+
+uint8_t TimerService::start(TimerCallback callback, uint32_t now, uint32_t delay, uint32_t period) {
+  if(callback == nullptr) {
+    return 0;
+  }
+
+  for(uint8_t i = 0; i < capacity; i++) {
+    if(!slots[i].active) {
+      slots[i].callback = callback;
+      slots[i].deadline = now + delay;
+      slots[i].period = period;
+      slots[i].active = true;
+      push(i);
+
+      return i + 1;
+    }
+  }
+
+  return 0; // No available slots.
+}
+
+bool TimerService::restart(uint8_t id, uint32_t now, uint32_t delay) {
+  if(!isActive(id)) {
+    return false;
+  }
+
+  uint8_t slot = id - 1;
+  remove(slot);
+  slots[slot].deadline = now + delay;
+  push(slot);
+
+  return true;
+}
+
+bool TimerService::stop(uint8_t id) {
+  if(!isActive(id)) {
+    return false;
+  }
+
+  remove(id - 1);
+  slots[id - 1].active = false;
+
+  return true;
+}
+
+void TimerService::stopAll() {
+  for(uint8_t i = 0; i < capacity; i++) {
+    slots[i].active = false;
+  }
+
+  count = 0;
+}
+
+bool TimerService::isActive(uint8_t id) const {
+  return id > 0 && id <= capacity && slots[id - 1].active;
+}
+
+uint8_t TimerService::getActiveCount() const {
+  return count;
+}
+
+uint8_t TimerService::getCapacity() const {
+  return capacity;
+}
+
+uint32_t TimerService::getRemaining(uint8_t id, uint32_t now) const {
+  if(!isActive(id)) {
+    return TIMER_SERVICE_NONE;
+  }
+
+  uint32_t deadline = slots[id - 1].deadline;
+
+  return before(now, deadline) ? deadline - now : 0;
+}
+
+uint32_t TimerService::getTimeUntilNext(uint32_t now) const {
+  if(count == 0) {
+    return TIMER_SERVICE_NONE;
+  }
+
+  uint32_t deadline = slots[heap[0]].deadline;
+
+  return before(now, deadline) ? deadline - now : 0;
+}
+
+uint8_t TimerService::dispatch(uint32_t now) {
+  uint8_t fired = 0;
+
+  // Callbacks may start new timers which are already due, so cap the work done in one call.
+  while(count > 0 && fired < capacity && !before(now, slots[heap[0]].deadline)) {
+    uint8_t slot = heap[0];
+    TimerCallback callback = slots[slot].callback;
+
+    remove(slot);
+
+    if(slots[slot].period > 0) {
+      // Keep periodic timers on their original schedule, unless they have fallen a full period behind.
+      slots[slot].deadline += slots[slot].period;
+
+      if(!before(now, slots[slot].deadline)) {
+        slots[slot].deadline = now + slots[slot].period;
+      }
+
+      push(slot);
+    }
+    else {
+      slots[slot].active = false;
+    }
+
+    callback();
+    fired++;
+  }
+
+  return fired;
+}
+
+void TimerService::push(uint8_t slot) {
+  place(count, slot);
+  siftUp(count++);
+}
+
+void TimerService::remove(uint8_t slot) {
+  uint8_t index = slots[slot].heapIndex;
+
+  count--;
+
+  if(index != count) {
+    // Move the last entry into the gap, then restore the heap order in whichever direction is needed.
+    uint8_t moved = heap[count];
+    place(index, moved);
+    siftUp(index);
+    siftDown(slots[moved].heapIndex);
+  }
+}
+
+void TimerService::siftUp(uint8_t index) {
+  while(index > 0) {
+    uint8_t parent = (index - 1) / 2;
+
+    if(!before(slots[heap[index]].deadline, slots[heap[parent]].deadline)) {
+      break;
+    }
+
+    uint8_t moved = heap[parent];
+    place(parent, heap[index]);
+    place(index, moved);
+    index = parent;
+  }
+}
+
+void TimerService::siftDown(uint8_t index) {
+  for(;;) {
+    uint8_t smallest = index;
+    uint8_t left = index * 2 + 1;
+    uint8_t right = left + 1;
+
+    if(left < count && before(slots[heap[left]].deadline, slots[heap[smallest]].deadline)) {
+      smallest = left;
+    }
+
+    if(right < count && before(slots[heap[right]].deadline, slots[heap[smallest]].deadline)) {
+      smallest = right;
+    }
+
+    if(smallest == index) {
+      break;
+    }
+
+    uint8_t moved = heap[smallest];
+    place(smallest, heap[index]);
+    place(index, moved);
+    index = smallest;
+  }
+}
+
+void TimerService::place(uint8_t index, uint8_t slot) {
+  heap[index] = slot;
+  slots[slot].heapIndex = index;
+}
@@ -0,0 +1,215 @@
+/**
+ * Test suite for the deadline-ordered timer service.
+ */
+
+#include <gtest/gtest.h>
+#include "TimerService.h"
+#include <chrono>
+#include <stdio.h>
+
+// Callbacks record the order in which they ran.
+static char order[32];
+static uint8_t orderLength = 0;
+
+static void callbackA() { order[orderLength++] = 'A'; }
+static void callbackB() { order[orderLength++] = 'B'; }
+static void callbackC() { order[orderLength++] = 'C'; }
+
+// Test fixture with a small timer service.
+class TimerServiceFixture : public ::testing::Test {
+protected:
+    TimerServiceBuffer<4> timers;
+
+    // SetUp() is called before each test.
+    void SetUp() override {
+        orderLength = 0;
+        order[0] = '\0';
+    }
+
+    const char* ran() {
+        order[orderLength] = '\0';
+        return order;
+    }
+};
+
+TEST_F(TimerServiceFixture, CanInstantiate) {
+    EXPECT_EQ(timers.getCapacity(), 4);
+    EXPECT_EQ(timers.getActiveCount(), 0);
+    EXPECT_EQ(timers.getTimeUntilNext(0), TIMER_SERVICE_NONE);
+}
+
+// One-shot timers run once, in deadline order regardless of the order they were started.
+TEST_F(TimerServiceFixture, OneShotRunsInDeadlineOrder) {
+    timers.start(callbackC, 0, 30);
+    timers.start(callbackA, 0, 10);
+    timers.start(callbackB, 0, 20);
+
+    EXPECT_EQ(timers.getTimeUntilNext(0), 10u);
+    EXPECT_EQ(timers.dispatch(9), 0);
+    EXPECT_EQ(timers.dispatch(25), 2);
+    EXPECT_STREQ(ran(), "AB");
+    EXPECT_EQ(timers.getTimeUntilNext(25), 5u);
+
+    EXPECT_EQ(timers.dispatch(100), 1);
+    EXPECT_EQ(timers.dispatch(200), 0);
+    EXPECT_STREQ(ran(), "ABC");
+    EXPECT_EQ(timers.getActiveCount(), 0);
+}
+
+// Periodic timers stay on their schedule even when dispatched late.
+TEST_F(TimerServiceFixture, PeriodicKeepsSchedule) {
+    uint8_t id = timers.start(callbackA, 0, 100, 100);
+
+    timers.dispatch(105);
+    EXPECT_EQ(timers.getRemaining(id, 105), 95u);
+    timers.dispatch(200);
+    EXPECT_STREQ(ran(), "AA");
+
+    // After falling more than a full period behind, the schedule restarts from now.
+    timers.dispatch(650);
+    EXPECT_STREQ(ran(), "AAA");
+    EXPECT_EQ(timers.getRemaining(id, 650), 100u);
+}
+
+// Stopping a timer removes it from the schedule without disturbing the others.
+TEST_F(TimerServiceFixture, StopRemovesTimer) {
+    timers.start(callbackA, 0, 10);
+    uint8_t id = timers.start(callbackB, 0, 20);
+    timers.start(callbackC, 0, 30);
+
+    EXPECT_TRUE(timers.stop(id));
+    EXPECT_FALSE(timers.stop(id));
+    EXPECT_FALSE(timers.isActive(id));
+
+    timers.dispatch(100);
+    EXPECT_STREQ(ran(), "AC");
+}
+
+// Restarting a timer moves its deadline in either direction.
+TEST_F(TimerServiceFixture, RestartMovesDeadline) {
+    uint8_t idA = timers.start(callbackA, 0, 10);
+    timers.start(callbackB, 0, 20);
+
+    EXPECT_TRUE(timers.restart(idA, 0, 30));
+    timers.dispatch(25);
+    EXPECT_STREQ(ran(), "B");
+    timers.dispatch(30);
+    EXPECT_STREQ(ran(), "BA");
+}
+
+// Slots are reused once timers finish, and IDs of 0 indicate failure.
+TEST_F(TimerServiceFixture, SlotsAreLimitedAndReused) {
+    for(uint8_t i = 0; i < 4; i++) {
+        EXPECT_NE(timers.start(callbackA, 0, 10), 0);
+    }
+
+    EXPECT_EQ(timers.start(callbackB, 0, 10), 0);
+    EXPECT_EQ(timers.start(nullptr, 0, 10), 0);
+
+    timers.dispatch(10);
+    EXPECT_NE(timers.start(callbackB, 10, 10), 0);
+}
+
+// Deadlines are compared safely across the rollover of millis().
+TEST_F(TimerServiceFixture, HandlesRollover) {
+    uint32_t now = 0xFFFFFFF0UL;
+    timers.start(callbackB, now, 0x20);
+    timers.start(callbackA, now, 0x08);
+
+    EXPECT_EQ(timers.dispatch(0xFFFFFFFFUL), 1);
+    EXPECT_EQ(timers.getTimeUntilNext(0xFFFFFFFFUL), 0x11u);
+    EXPECT_EQ(timers.dispatch(0x10), 1);
+    EXPECT_STREQ(ran(), "AB");
+}
+
+// Heap order holds through many interleaved starts and stops.
+TEST(TimerServiceOrder, RandomisedDeadlines) {
+    TimerServiceBuffer<32> timers;
+    uint32_t seed = 12345;
+    uint32_t last = 0;
+
+    for(uint8_t i = 0; i < 32; i++) {
+        seed = seed * 1103515245UL + 12345UL;
+        timers.start(callbackA, 0, (seed >> 16) % 1000);
+    }
+
+    for(uint8_t id = 1; id <= 32; id += 3) {
+        timers.stop(id);
+    }
+
+    while(timers.getActiveCount() > 0) {
+        uint32_t next = timers.getTimeUntilNext(0);
+        EXPECT_GE(next, last);
+        last = next;
+        timers.dispatch(next);
+    }
+}
+
+// Compares polling every timer on each loop against dispatching from the heap.
+// Timings are printed for reference only, as they depend on the host.
+struct PolledTimer {
+    uint32_t start = 0;
+    uint32_t wait = 0;
+    bool running = false;
+
+    bool justFinished(uint32_t now) {
+        if(running && now - start >= wait) {
+            running = false;
+            return true;
+        }
+        return false;
+    }
+};
+
+static volatile uint32_t fired = 0;
+static void countFired() { fired++; }
+
+TEST(TimerServiceBenchmark, PollingVersusHeap) {
+    const uint8_t sizes[] = {8, 28, 64};
+    const uint32_t loops = 100000;
+
+    for(uint8_t n : sizes) {
+        PolledTimer* polled = new PolledTimer[n];
+        TimerService* heap = new TimerServiceBuffer<64>();
+
+        // Mostly idle timers, as with the Proton Pack, with a few short periodic ones.
+        for(uint8_t i = 0; i < n; i++) {
+            uint32_t period = i < 4 ? 5 + i : 60000;
+            polled[i].start = 0;
+            polled[i].wait = period;
+            polled[i].running = true;
+            heap->start(countFired, 0, period, period);
+        }
+
+        fired = 0;
+        auto begin = std::chrono::steady_clock::now();
+        for(uint32_t t = 0; t < loops; t++) {
+            for(uint8_t i = 0; i < n; i++) {
+                if(polled[i].justFinished(t)) {
+                    countFired();
+                    polled[i].start = t;
+                    polled[i].running = true;
+                }
+            }
+        }
+        auto polledTime = std::chrono::steady_clock::now() - begin;
+        uint32_t polledFired = fired;
+
+        fired = 0;
+        begin = std::chrono::steady_clock::now();
+        for(uint32_t t = 0; t < loops; t++) {
+            heap->dispatch(t);
+        }
+        auto heapTime = std::chrono::steady_clock::now() - begin;
+
+        printf("[          ] %u timers: polling %.1f ns/loop, heap %.1f ns/loop (%u vs %u callbacks)\n", n,
+               std::chrono::duration<double, std::nano>(polledTime).count() / loops,
+               std::chrono::duration<double, std::nano>(heapTime).count() / loops,
+               (unsigned)polledFired, (unsigned)fired);
+
+        EXPECT_EQ(polledFired, fired);
+
+        delete[] polled;
+        delete heap;
+    }
+}
@@ -92,6 +92,7 @@ const uint16_t HTTP_STATUS_503 = 503; // Service Unavailable
 // HTTP Headers
 const char* HEADER_CACHE_CONTROL = "Cache-Control";
 const char* HEADER_CONTENT_ENCODING = "Content-Encoding";
+const char* HEADER_CONTENT_DISPOSITION = "Content-Disposition";
 
 // HTTP Header Values
 const char* CACHE_NO_CACHE = "no-cache, must-revalidate";
@@ -106,6 +107,7 @@ const char* MIME_JSON = "application/json";
 const char* MIME_STL = "model/stl";
 const char* MIME_SVG = "image/svg+xml";
 const char* MIME_ICON = "image/x-icon";
+const char* MIME_BINARY = "application/octet-stream";
 
 /*
  * OpenAPI Tag Definitions - Organizes endpoints into logical categories
@@ -134,6 +136,7 @@ const char* RESP_CSS_FILE = "CSS file";
 const char* RESP_STL_FILE = "STL file";
 const char* RESP_SVG_FILE = "SVG file";
 const char* RESP_ICON_FILE = "Icon file";
+const char* RESP_BINARY_FILE = "Binary file";
 const char* RESP_SETTINGS_SAVED = "Settings saved successfully";
 const char* RESP_SETTINGS_UPDATED = "Settings updated successfully";
 const char* RESP_JSON_OBJECT = "JSON object";
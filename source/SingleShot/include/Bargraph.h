@@ -69,8 +69,6 @@ struct Bargraph {
   const static uint8_t UpdateDelay = 8; // Base delay (ms) for bargraph refresh (this should be a value evenly divisible by 2, 3, or 4).
 
   private:
-    const uint8_t OrientationNormal[Bargraph::Elements] = {0, 16, 32, 48, 1, 17, 33, 49, 2, 18, 34, 50, 3, 19, 35, 51, 4, 20, 36, 52, 5, 21, 37, 53, 6, 22, 38, 54};
-    const uint8_t OrientationInvert[Bargraph::Elements] = {54, 38, 22, 6, 53, 37, 21, 5, 52, 36, 20, 4, 51, 35, 19, 3, 50, 34, 18, 2, 49, 33, 17, 1, 48, 32, 16, 0};
     const uint8_t Bar_1[Bargraph::Elements] = {1, 1, 1, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0};
     const uint8_t Bar_2[Bargraph::Elements] = {1, 1, 1, 0, 0, 0, 1, 1, 1, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0};
     const uint8_t Bar_3[Bargraph::Elements] = {1, 1, 1, 0, 0, 0, 1, 1, 1, 0, 0, 0, 1, 1, 1, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0};
@@ -78,7 +76,8 @@ struct Bargraph {
     const uint8_t Bar_5[Bargraph::Elements] = {1, 1, 1, 0, 0, 0, 1, 1, 1, 0, 0, 0, 1, 1, 1, 0, 0, 0, 1, 1, 1, 0, 0, 0, 1, 1, 1, 0};
 
   public:
-    HT16K33 device; // Singular bargraph object instance using the HT16K33 matrix driver.
+    BargraphWireBus bus{WIRE}; // i2c bus used by the device.
+    BargraphDriver device{bus}; // Singular bargraph object instance using the HT16K33 matrix driver.
     uint8_t simulate = Bargraph::Elements; // Simulated maximum for patterns which may be dependent on other factors.
     uint8_t steps = Bargraph::Elements / 2; // Steps for patterns (1/2 max) which are bilateral/mirrored.
     uint8_t step = 0; // Indicates current step for bilateral/mirrored patterns.
@@ -92,29 +91,10 @@ struct Bargraph {
 
     void initialize(bool b_invert = false) {
       // Scan i2c for 28/30 segment bargraph.
-      Wire.beginTransmission(0x70);
-      if(Wire.endTransmission() == 0) {
-        present = true;
-      }
-      else {
-        present = false;
-      }
-
-      if(present) {
-        device.begin(0x00);
-      }
+      present = device.begin();
 
       inverted = b_invert;
-    }
-
-    uint8_t mapElement() {
-      // Returns the true element on the device, as based on the mapped orientation.
-      if(inverted) {
-        return OrientationInvert[element];
-      }
-      else {
-        return OrientationNormal[element];
-      }
+      device.setLayout(BARGRAPH_LAYOUT_28, inverted); // Accounts for installation orientation.
     }
 
     void showBars(uint8_t i_count) {
@@ -168,26 +148,21 @@ struct Bargraph {
       if(present) {
         // This simplifies the process of turning individual elements on or off.
         // Uses mapping information which accounts for installation orientation.
-        if(b_power) {
-          device.setLed(mapElement()); // Turn the mapped element on.
-        }
-        else {
-          device.clearLed(mapElement()); // Turn the mapped element off.
-        }
+        device.setElement(element, b_power);
       }
     }
 
     void commit() {
       // This commits any changes created by bargraph.setElement to the bargraph.
-      if(present) {
-        device.sendLed();
-      }
+      // Only the bytes which changed since the last commit are sent.
+      device.commit();
     }
 
     void clear() {
       // Clears all elements from the bargraph, marks state as empty.
       if(present) {
         device.clearAll();
+        device.commit();
       }
       element = 0;
       STATE = BG_EMPTY; // Mark last known state.
@@ -56,6 +56,15 @@
  * Only available on the ESP32 builds.
  */
 #define MOTION_OFFSETS
+
+/*
+ * Read the gyroscope and accelerometer through the IMU's FIFO rather than one value at a time.
+ * Every sample the IMU takes is read in one burst and run through the orientation filter with
+ * the time it was taken, so the fusion sees evenly spaced samples whatever else the blaster is doing.
+ * Uncomment to enable, otherwise only the latest values are read on each motion task interval.
+ * Only available on the ESP32 builds.
+ */
+//#define MOTION_FIFO
 #endif
 
 /*
@@ -251,6 +251,27 @@ struct SpatialData {
 // Global object to hold the fused sensor readings.
 SpatialData spatialData;
 
+#if defined(MOTION_FIFO)
+/**
+ * IMU FIFO
+ * The LSM6DS3TR-C queues every gyroscope and accelerometer sample it takes. On each read interval
+ * the queue is read in one burst and each sample is given the time it was taken (see ImuSampleClock),
+ * so the fusion filter steps through evenly spaced samples rather than whatever the read timing was.
+ * The magnetometer has no FIFO, so its latest reading is taken once per batch and used for all of it.
+ */
+ImuSampleClock imuClock;
+ImuFifoSample imuSamples[IMU_FIFO_MAX_SAMPLES];
+uint8_t imuFifoBuffer[IMU_FIFO_MAX_WORDS * 2];
+uint8_t i_imu_samples = 0; // Samples in the last batch read.
+uint16_t i_imu_fifo_overruns = 0; // Times the FIFO filled before it was read.
+uint32_t i_imu_last_sample = 0; // Time of the last sample run through the fusion filter (us).
+bool b_imu_last_sample = false; // Whether i_imu_last_sample belongs to the current run of samples.
+float f_imu_accel_scale = 0.0f; // Accelerometer m/s^2 per count at the configured range.
+float f_imu_gyro_scale = 0.0f; // Gyroscope rad/s per count at the configured range.
+const uint8_t i_imu_read_chunk = 120; // Most bytes read in one i2c transaction (the Wire buffer holds 128).
+const float f_filter_alpha_interval = 0.05f; // Sample interval (s) at which FILTER_ALPHA applies as-is.
+#endif
+
 // Forward function declarations.
 float calculateAngularVelocity(const MotionData& data);
 float calculateGForce(const MotionData& data);
@@ -260,6 +281,9 @@ void readRawSensorData();
 void averageCalibrationData();
 void reportCalibrationData();
 void resetAllMotionData(bool b_calibrate);
+#if defined(MOTION_FIFO)
+void configureImuFifo();
+#endif
 void notifyWSClients(); // From Webhandler.h
 void sendGyroCalData(); // From Webhandler.h
 void sendMagCalData(bool b_update_points); // From Webhandler.h
@@ -759,6 +783,11 @@ void configureSensors() {
      */
     imuSensor.configInt2(false, true, false);
 
+  #if defined(MOTION_FIFO)
+    // Queue the gyroscope and accelerometer samples for reading in batches.
+    configureImuFifo();
+  #endif
+
     // Set the sample frequency for the Madgwick filter (converting our sensor delay interval from milliseconds to Hz).
     float f_sample_freq = (1000.0f / motionTask.getInterval());
     ahrs_filter.begin(f_sample_freq);
@@ -946,6 +975,228 @@ OrientedSensorData applySensorOrientation(const sensors_event_t& mag_event,
   return oriented;
 }
 
+#if defined(MOTION_FIFO)
+/**
+ * Function: writeImuRegisters
+ * Purpose: Writes consecutive IMU registers in a single i2c transaction.
+ */
+bool writeImuRegisters(uint8_t reg, const uint8_t* values, uint8_t length) {
+  Wire1.beginTransmission(LSM6DS_I2CADDR_DEFAULT);
+  Wire1.write(reg);
+  Wire1.write(values, length);
+
+  return Wire1.endTransmission() == 0;
+}
+
+/**
+ * Function: readImuRegisters
+ * Purpose: Reads consecutive IMU registers, in as few i2c transactions as the Wire buffer allows.
+ *          The FIFO output register rolls back on itself, so a long read simply continues from it.
+ */
+bool readImuRegisters(uint8_t reg, uint8_t* buffer, uint16_t length) {
+  while(length > 0) {
+    uint8_t i_chunk = length > i_imu_read_chunk ? i_imu_read_chunk : length;
+
+    Wire1.beginTransmission(LSM6DS_I2CADDR_DEFAULT);
+    Wire1.write(reg);
+
+    if(Wire1.endTransmission(false) != 0 || Wire1.requestFrom(LSM6DS_I2CADDR_DEFAULT, i_chunk) != i_chunk) {
+      return false;
+    }
+
+    for(uint8_t i = 0; i < i_chunk; i++) {
+      *buffer++ = Wire1.read();
+    }
+
+    length -= i_chunk;
+  }
+
+  return true;
+}
+
+/**
+ * Function: getImuRateHz
+ * Purpose: Converts an LSM6DS3TR-C data rate to Hz (12 for 12.5 Hz, 0 when shut down).
+ */
+uint16_t getImuRateHz(lsm6ds_data_rate_t rate) {
+  switch(rate) {
+    case LSM6DS_RATE_12_5_HZ: return 12;
+    case LSM6DS_RATE_26_HZ: return 26;
+    case LSM6DS_RATE_52_HZ: return 52;
+    case LSM6DS_RATE_104_HZ: return 104;
+    case LSM6DS_RATE_208_HZ: return 208;
+    case LSM6DS_RATE_416_HZ: return 416;
+    case LSM6DS_RATE_833_HZ: return 833;
+    case LSM6DS_RATE_1_66K_HZ: return 1660;
+    case LSM6DS_RATE_3_33K_HZ: return 3330;
+    case LSM6DS_RATE_6_66K_HZ: return 6660;
+    case LSM6DS_RATE_SHUTDOWN:
+    default:
+      return 0;
+  }
+}
+
+/**
+ * Function: configureImuFifo
+ * Purpose: Restarts the IMU FIFO to queue gyroscope and accelerometer samples at the current data rate,
+ *          with the watermark at the samples expected per read interval. Shut down, the FIFO is bypassed.
+ *          Also sets the scale of the raw counts from the configured ranges, as used by the Adafruit library.
+ */
+void configureImuFifo() {
+  uint16_t i_rate_hz = getImuRateHz(imuSensor.getGyroDataRate());
+  uint16_t i_watermark = (uint32_t)i_rate_hz * motionTask.getInterval() / 1000;
+  uint8_t ctrl[IMU_FIFO_CTRL_BYTES];
+
+  switch(imuSensor.getAccelRange()) {
+    case LSM6DS_ACCEL_RANGE_2_G: f_imu_accel_scale = 0.061f; break;
+    case LSM6DS_ACCEL_RANGE_4_G: f_imu_accel_scale = 0.122f; break;
+    case LSM6DS_ACCEL_RANGE_8_G: f_imu_accel_scale = 0.244f; break;
+    case LSM6DS_ACCEL_RANGE_16_G:
+    default: f_imu_accel_scale = 0.488f; break;
+  }
+  f_imu_accel_scale = f_imu_accel_scale * f_gravity / 1000.0f; // mg to m/s^2
+
+  switch(imuSensor.getGyroRange()) {
+    case LSM6DS_GYRO_RANGE_125_DPS: f_imu_gyro_scale = 4.375f; break;
+    case LSM6DS_GYRO_RANGE_250_DPS: f_imu_gyro_scale = 8.75f; break;
+    case LSM6DS_GYRO_RANGE_500_DPS: f_imu_gyro_scale = 17.5f; break;
+    case LSM6DS_GYRO_RANGE_1000_DPS: f_imu_gyro_scale = 35.0f; break;
+    case LSM6DS_GYRO_RANGE_2000_DPS:
+    default: f_imu_gyro_scale = 70.0f; break;
+  }
+  f_imu_gyro_scale = f_imu_gyro_scale * SENSORS_DPS_TO_RADS / 1000.0f; // mdps to rad/s
+
+  // Bypass empties the FIFO, so it starts again with nothing from the old rate.
+  imuFifoControl(0, 0, ctrl);
+  writeImuRegisters(IMU_FIFO_CTRL1, ctrl, IMU_FIFO_CTRL_BYTES);
+
+  if(i_rate_hz > 0) {
+    imuFifoControl(i_rate_hz, i_watermark > 0 ? i_watermark : 1, ctrl);
+    writeImuRegisters(IMU_FIFO_CTRL1, ctrl, IMU_FIFO_CTRL_BYTES);
+    imuClock.begin(1000000UL / i_rate_hz);
+  }
+
+  i_imu_samples = 0;
+  b_imu_last_sample = false;
+}
+
+/**
+ * Function: readImuFifo
+ * Purpose: Reads the samples queued in the IMU FIFO (up to IMU_FIFO_MAX_SAMPLES) into imuSamples, oldest first,
+ *          and stamps them with the time they were taken.
+ * Outputs:
+ *   - uint8_t: Samples read.
+ */
+uint8_t readImuFifo() {
+  uint8_t status[IMU_FIFO_STATUS_BYTES];
+  uint16_t i_words = 0;
+
+  bool b_read = readImuRegisters(IMU_FIFO_STATUS1, status, IMU_FIFO_STATUS_BYTES);
+  uint32_t i_read_time = micros(); // Every sample found was taken before now.
+  ImuFifoStatus fifo = imuFifoParseStatus(status);
+
+  if(b_read) {
+    i_words = imuFifoWordsToRead(fifo, IMU_FIFO_MAX_SAMPLES);
+
+    if(i_words > 0) {
+      b_read = readImuRegisters(IMU_FIFO_DATA_OUT_L, imuFifoBuffer, i_words * 2);
+    }
+  }
+
+  if(!b_read) {
+    i_imu_samples = 0;
+    return 0;
+  }
+
+  if(fifo.overrun) {
+    // Samples were lost, so the timing starts over.
+    i_imu_fifo_overruns++;
+    imuClock.resync();
+    b_imu_last_sample = false;
+  }
+
+  i_imu_samples = imuFifoDecode(imuFifoBuffer, i_words, fifo.pattern, imuSamples, IMU_FIFO_MAX_SAMPLES);
+  imuClock.stamp(i_read_time, imuSamples, i_imu_samples, (fifo.unread - i_words) / IMU_FIFO_SAMPLE_WORDS);
+
+  return i_imu_samples;
+}
+
+/**
+ * Function: loadImuSample
+ * Purpose: Converts a FIFO sample into the gyroscope and accelerometer events, as getEvent() would have filled them.
+ */
+void loadImuSample(const ImuFifoSample& sample) {
+  gyro_event.gyro.x = sample.gyro[0] * f_imu_gyro_scale;
+  gyro_event.gyro.y = sample.gyro[1] * f_imu_gyro_scale;
+  gyro_event.gyro.z = sample.gyro[2] * f_imu_gyro_scale;
+  gyro_event.timestamp = sample.timestampUs / 1000;
+
+  accel_event.acceleration.x = sample.accel[0] * f_imu_accel_scale;
+  accel_event.acceleration.y = sample.accel[1] * f_imu_accel_scale;
+  accel_event.acceleration.z = sample.accel[2] * f_imu_accel_scale;
+  accel_event.timestamp = sample.timestampUs / 1000;
+}
+
+/**
+ * Function: getImuSampleInterval
+ * Purpose: Returns the time (s) from the previous sample to this one. The first sample of a run,
+ *          or one after a gap the clock started over from, is taken as one sample period.
+ */
+float getImuSampleInterval(uint32_t i_timestamp) {
+  uint32_t i_interval = i_timestamp - i_imu_last_sample;
+  uint32_t i_period = imuClock.getPeriodUs();
+
+  if(!b_imu_last_sample || i_interval == 0 || i_interval > i_period * 4) {
+    i_interval = i_period;
+  }
+
+  i_imu_last_sample = i_timestamp;
+  b_imu_last_sample = true;
+
+  return i_interval / 1000000.0f;
+}
+
+/**
+ * Function: getFilterAlpha
+ * Purpose: Scales FILTER_ALPHA to a sample interval, keeping the smoothing time constant it gives at f_filter_alpha_interval.
+ */
+float getFilterAlpha(float f_interval) {
+  return 1.0f - powf(1.0f - FILTER_ALPHA, f_interval / f_filter_alpha_interval);
+}
+#endif
+
+/**
+ * Function: applyRawSensorData
+ * Purpose: Applies orientation mapping and magnetic calibration to the latest sensor events, storing the results in motionData.
+ * Inputs: None (uses global mag_event, gyro_event and accel_event)
+ * Outputs: None (updates global motionData)
+ */
+void applyRawSensorData() {
+#ifdef MOTION_SENSORS
+  // Apply orientation mapping to all sensor data
+  OrientedSensorData oriented = applySensorOrientation(mag_event, accel_event, gyro_event);
+
+  // Apply hard iron corrections to magnetic readings (post-orientation).
+  float mx = oriented.magX - magCalData.mag_hardiron[0];
+  float my = oriented.magY - magCalData.mag_hardiron[1];
+  float mz = oriented.magZ - magCalData.mag_hardiron[2];
+
+  // Apply soft iron corrections to magnetic readings (post-orientation).
+  motionData.magX = mx * magCalData.mag_softiron[0] + my * magCalData.mag_softiron[1] + mz * magCalData.mag_softiron[2];
+  motionData.magY = mx * magCalData.mag_softiron[3] + my * magCalData.mag_softiron[4] + mz * magCalData.mag_softiron[5];
+  motionData.magZ = mx * magCalData.mag_softiron[6] + my * magCalData.mag_softiron[7] + mz * magCalData.mag_softiron[8];
+
+  // Store the oriented values in global motionData struct for access.
+  // Converts gyroscope from rad/s to deg/s as expected by AHRS library.
+  motionData.accelX = oriented.accelX;
+  motionData.accelY = oriented.accelY;
+  motionData.accelZ = oriented.accelZ;
+  motionData.gyroX = oriented.gyroX * SENSORS_RADS_TO_DPS;
+  motionData.gyroY = oriented.gyroY * SENSORS_RADS_TO_DPS;
+  motionData.gyroZ = oriented.gyroZ * SENSORS_RADS_TO_DPS;
+#endif
+}
+
 /**
  * Function: readRawSensorData
  * Purpose: Reads all sensor data directly from the magnetometer and IMU, applies calibration corrections and orientation mapping.
@@ -956,32 +1207,24 @@ OrientedSensorData applySensorOrientation(const sensors_event_t& mag_event,
 void readRawSensorData() {
 #ifdef MOTION_SENSORS
   if(b_imu_found && b_mag_found) {
+  #if defined(MOTION_FIFO)
+    // Use the newest sample the IMU has queued, or its output registers when nothing is queued yet.
+    if(readImuFifo() > 0) {
+      loadImuSample(imuSamples[i_imu_samples - 1]);
+
+      magnetometer->getEvent(&mag_event);
+
+      applyRawSensorData();
+      return;
+    }
+  #endif
+
     // Poll the sensors for raw data
     magnetometer->getEvent(&mag_event);
     gyroscope->getEvent(&gyro_event);
     accelerometer->getEvent(&accel_event);
 
-    // Apply orientation mapping to all sensor data
-    OrientedSensorData oriented = applySensorOrientation(mag_event, accel_event, gyro_event);
-
-    // Apply hard iron corrections to magnetic readings (post-orientation).
-    float mx = oriented.magX - magCalData.mag_hardiron[0];
-    float my = oriented.magY - magCalData.mag_hardiron[1];
-    float mz = oriented.magZ - magCalData.mag_hardiron[2];
-
-    // Apply soft iron corrections to magnetic readings (post-orientation).
-    motionData.magX = mx * magCalData.mag_softiron[0] + my * magCalData.mag_softiron[1] + mz * magCalData.mag_softiron[2];
-    motionData.magY = mx * magCalData.mag_softiron[3] + my * magCalData.mag_softiron[4] + mz * magCalData.mag_softiron[5];
-    motionData.magZ = mx * magCalData.mag_softiron[6] + my * magCalData.mag_softiron[7] + mz * magCalData.mag_softiron[8];
-
-    // Store the oriented values in global motionData struct for access.
-    // Converts gyroscope from rad/s to deg/s as expected by AHRS library.
-    motionData.accelX = oriented.accelX;
-    motionData.accelY = oriented.accelY;
-    motionData.accelZ = oriented.accelZ;
-    motionData.gyroX = oriented.gyroX * SENSORS_RADS_TO_DPS;
-    motionData.gyroY = oriented.gyroY * SENSORS_RADS_TO_DPS;
-    motionData.gyroZ = oriented.gyroZ * SENSORS_RADS_TO_DPS;
+    applyRawSensorData();
   }
 #endif
 }
@@ -1052,39 +1295,42 @@ float calculateGForce(const MotionData& data) {
 /**
  * Function: updateFilteredMotionData
  * Purpose: Applies exponential moving average filtering to raw motionData and updates filteredMotionData.
- * Inputs: None (uses global motionData and filteredMotionData)
+ * Inputs:
+ *   - float f_alpha: Smoothing factor for this sample (FILTER_ALPHA, or as scaled to the sample interval).
  * Outputs: None (updates filteredMotionData)
  */
-void updateFilteredMotionData() {
-  filteredMotionData.magX   = FILTER_ALPHA * motionData.magX   + (1.0f - FILTER_ALPHA) * filteredMotionData.magX;
-  filteredMotionData.magY   = FILTER_ALPHA * motionData.magY   + (1.0f - FILTER_ALPHA) * filteredMotionData.magY;
-  filteredMotionData.magZ   = FILTER_ALPHA * motionData.magZ   + (1.0f - FILTER_ALPHA) * filteredMotionData.magZ;
-  filteredMotionData.accelX = FILTER_ALPHA * motionData.accelX + (1.0f - FILTER_ALPHA) * filteredMotionData.accelX;
-  filteredMotionData.accelY = FILTER_ALPHA * motionData.accelY + (1.0f - FILTER_ALPHA) * filteredMotionData.accelY;
-  filteredMotionData.accelZ = FILTER_ALPHA * motionData.accelZ + (1.0f - FILTER_ALPHA) * filteredMotionData.accelZ;
-  filteredMotionData.gyroX  = FILTER_ALPHA * motionData.gyroX  + (1.0f - FILTER_ALPHA) * filteredMotionData.gyroX;
-  filteredMotionData.gyroY  = FILTER_ALPHA * motionData.gyroY  + (1.0f - FILTER_ALPHA) * filteredMotionData.gyroY;
-  filteredMotionData.gyroZ  = FILTER_ALPHA * motionData.gyroZ  + (1.0f - FILTER_ALPHA) * filteredMotionData.gyroZ;
+void updateFilteredMotionData(float f_alpha) {
+  filteredMotionData.magX   = f_alpha * motionData.magX   + (1.0f - f_alpha) * filteredMotionData.magX;
+  filteredMotionData.magY   = f_alpha * motionData.magY   + (1.0f - f_alpha) * filteredMotionData.magY;
+  filteredMotionData.magZ   = f_alpha * motionData.magZ   + (1.0f - f_alpha) * filteredMotionData.magZ;
+  filteredMotionData.accelX = f_alpha * motionData.accelX + (1.0f - f_alpha) * filteredMotionData.accelX;
+  filteredMotionData.accelY = f_alpha * motionData.accelY + (1.0f - f_alpha) * filteredMotionData.accelY;
+  filteredMotionData.accelZ = f_alpha * motionData.accelZ + (1.0f - f_alpha) * filteredMotionData.accelZ;
+  filteredMotionData.gyroX  = f_alpha * motionData.gyroX  + (1.0f - f_alpha) * filteredMotionData.gyroX;
+  filteredMotionData.gyroY  = f_alpha * motionData.gyroY  + (1.0f - f_alpha) * filteredMotionData.gyroY;
+  filteredMotionData.gyroZ  = f_alpha * motionData.gyroZ  + (1.0f - f_alpha) * filteredMotionData.gyroZ;
 }
 
 /**
  * Function: updateOrientation
  * Purpose: Updates the orientation using sensor fusion (AHRS).
- * Inputs: None (uses filteredMotionData)
+ * Inputs:
+ *   - float f_interval: Time since the previous sample, in seconds.
  * Outputs: None (updates global orientation variables)
  */
-void updateOrientation() {
+void updateOrientation(float f_interval) {
 #ifdef MOTION_SENSORS
   /**
    * Fusion expects gyroscope in deg/s, accelerometer in m/s^2, magnetometer in uT.
    * It assumes a gravity-positive z-axis and NED aerospace framing.
    * All 9 DoF values will calculate roll (X), pitch (Y), and yaw (Z).
-   * The sample frequency is in Hz and already calculated from the update time in ms.
+   * The gyroscope is integrated over the interval since the previous sample.
    */
   ahrs_filter.update(
     motionData.gyroX, motionData.gyroY, motionData.gyroZ,
     motionData.accelX, motionData.accelY, motionData.accelZ,
-    motionData.magX, motionData.magY, motionData.magZ
+    motionData.magX, motionData.magY, motionData.magZ,
+    f_interval
   );
 
   // Get position in Euler angles (degrees) for orientation in NED space.
@@ -1239,6 +1485,60 @@ inline bool isMotionOffsetsDefault(const MotionOffsets &m) {
          (m.gyroX  == 0.0f) && (m.gyroY  == 0.0f) && (m.gyroZ  == 0.0f);
 }
 
+/**
+ * Function: processTelemetrySample
+ * Purpose: Applies offsets, sensor fusion and filtering to the sample in motionData, then checks for a shake.
+ * Inputs:
+ *   - float f_interval: Time since the previous sample, in seconds.
+ *   - float f_alpha: Smoothing factor for the filtered values.
+ * Outputs: None, operates on global motionData, filteredMotionData and spatialData.
+ */
+void processTelemetrySample(float f_interval, float f_alpha) {
+#ifdef MOTION_SENSORS
+  // Calculate the magnitude of the raw angular velocity vector (deg/s).
+  motionData.angVel = calculateAngularVelocity(motionData);
+
+  // Calculate the magnitude of the raw acceleration vector (g-force).
+  motionData.gForce = calculateGForce(motionData);
+
+  // Apply offsets to IMU readings only after we know the installation orientation.
+  if(INSTALL_ORIENTATION != COMPONENTS_FACTORY_DEFAULT) {
+    // Choose Offsets: Prefer calibratedOffsets, but use quickOffsets when calibrated offsets are default/empty.
+    const MotionOffsets *usedOffsets = &calibratedOffsets;
+    if(isMotionOffsetsDefault(calibratedOffsets)) {
+      usedOffsets = &quickOffsets;
+
+      #if defined(DEBUG_TELEMETRY_DATA)
+        debugln(F("No calibrated offsets present; using quickOffsets for runtime corrections."));
+      #endif
+    }
+
+    // Apply chosen offsets
+    motionData.accelX -= usedOffsets->accelX;
+    motionData.accelY -= usedOffsets->accelY;
+    motionData.accelZ -= usedOffsets->accelZ;
+    motionData.gyroX  -= usedOffsets->gyroX;
+    motionData.gyroY  -= usedOffsets->gyroY;
+    motionData.gyroZ  -= usedOffsets->gyroZ;
+  }
+
+  // Update the orientation via sensor fusion.
+  updateOrientation(f_interval);
+
+  // Apply exponential moving average (EMA) smoothing filter to sensor data.
+  updateFilteredMotionData(f_alpha);
+
+  // Calculate the magnitude of the raw angular velocity vector (deg/s).
+  filteredMotionData.angVel = calculateAngularVelocity(filteredMotionData);
+
+  // Calculate the magnitude of the filtered acceleration vector (g-force).
+  filteredMotionData.gForce = calculateGForce(filteredMotionData);
+
+  // Check for shake events which use our calculated values.
+  filteredMotionData.shaken = detectShakeEvent();
+#endif
+}
+
 /**
  * Function: processMotionData
  * Purpose: Reads the motion sensors and prints the data to the debug console (if enabled).
@@ -1266,50 +1566,30 @@ void processMotionData() {
 
     case TELEMETRY:
     default:
-      // Read the raw sensor data with orientation corrections and update the motionData object.
-      readRawSensorData();
-
-      // Calculate the magnitude of the raw angular velocity vector (deg/s).
-      motionData.angVel = calculateAngularVelocity(motionData);
+    #if defined(MOTION_FIFO)
+      // Run every sample queued since the last read through the telemetry, each with its own interval.
+      if(readImuFifo() > 0) {
+        bool b_shaken = false;
 
-      // Calculate the magnitude of the raw acceleration vector (g-force).
-      motionData.gForce = calculateGForce(motionData);
+        magnetometer->getEvent(&mag_event);
 
-      // Apply offsets to IMU readings only after we know the installation orientation.
-      if(INSTALL_ORIENTATION != COMPONENTS_FACTORY_DEFAULT) {
-        // Choose Offsets: Prefer calibratedOffsets, but use quickOffsets when calibrated offsets are default/empty.
-        const MotionOffsets *usedOffsets = &calibratedOffsets;
-        if(isMotionOffsetsDefault(calibratedOffsets)) {
-          usedOffsets = &quickOffsets;
+        for(uint8_t i = 0; i < i_imu_samples; i++) {
+          loadImuSample(imuSamples[i]);
+          applyRawSensorData();
 
-          #if defined(DEBUG_TELEMETRY_DATA)
-            debugln(F("No calibrated offsets present; using quickOffsets for runtime corrections."));
-          #endif
+          float f_interval = getImuSampleInterval(imuSamples[i].timestampUs);
+          processTelemetrySample(f_interval, getFilterAlpha(f_interval));
+          b_shaken = b_shaken || filteredMotionData.shaken;
         }
 
-        // Apply chosen offsets
-        motionData.accelX -= usedOffsets->accelX;
-        motionData.accelY -= usedOffsets->accelY;
-        motionData.accelZ -= usedOffsets->accelZ;
-        motionData.gyroX  -= usedOffsets->gyroX;
-        motionData.gyroY  -= usedOffsets->gyroY;
-        motionData.gyroZ  -= usedOffsets->gyroZ;
+        // A shake anywhere in the batch counts.
+        filteredMotionData.shaken = b_shaken;
       }
-
-      // Update the orientation via sensor fusion.
-      updateOrientation();
-
-      // Apply exponential moving average (EMA) smoothing filter to sensor data.
-      updateFilteredMotionData();
-
-      // Calculate the magnitude of the raw angular velocity vector (deg/s).
-      filteredMotionData.angVel = calculateAngularVelocity(filteredMotionData);
-
-      // Calculate the magnitude of the filtered acceleration vector (g-force).
-      filteredMotionData.gForce = calculateGForce(filteredMotionData);
-
-      // Check for shake events which use our calculated values.
-      filteredMotionData.shaken = detectShakeEvent();
+    #else
+      // Read the raw sensor data with orientation corrections and update the motionData object.
+      readRawSensorData();
+      processTelemetrySample(motionTask.getInterval() / 1000.0f, FILTER_ALPHA);
+    #endif
     break;
   }
 #endif
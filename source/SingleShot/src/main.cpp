@@ -58,7 +58,6 @@
 #include <millisDelay.h>
 #include <FastLED.h>
 #include <avdweb_Switch.h>
-#include <ht16k33.h>
 #include <Wire.h>
 #ifdef ESP32
   #include <HardwareSerial.h>
@@ -82,10 +81,14 @@ Scheduler schedule;
 
 // Shared Libraries
 #include <DeviceState.h>
+#include <TimerService.h>
+#include <BargraphDriver.h>
 #ifdef ESP32
   #include <MagCalibration.h>
   MagCalibration magCal;
 
+  #include <ImuFifo.h>
+
   #include <WirelessManager.h>
   #include <WebRouter.h>
 
@@ -365,6 +368,10 @@ void animateTaskCallback() {
 void inputTaskCallback() {
 #ifdef ESP32
   webLoops(); // Handle web server loops, including WebSocket events and OTA updates.
+
+  if(irManager != nullptr) {
+    irManager->update(); // Start sending the next queued infrared frame once the transmitter is free.
+  }
 #endif
 
   updateAudio(); // Update the state of the available sound board.